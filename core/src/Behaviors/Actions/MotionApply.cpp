@@ -9,6 +9,15 @@ using namespace crimild::behaviors;
 using namespace crimild::behaviors::actions;
 using namespace crimild::navigation;
 
+// Ids are hashed at compile time, since values are accessed every frame
+static constexpr StringId MOTION_VELOCITY( "motion.velocity" );
+static constexpr StringId MOTION_STEERING( "motion.steering" );
+static constexpr StringId MOTION_POSITION( "motion.position" );
+static constexpr StringId MOTION_MAX_FORCE( "motion.max_force" );
+static constexpr StringId MOTION_MASS( "motion.mass" );
+static constexpr StringId MOTION_MAX_VELOCITY( "motion.max_velocity" );
+static constexpr StringId MOTION_VELOCITY_MAGNITUDE( "motion.velocity.magnitude" );
+
 Vector3f truncate( Vector3f v, float max )
 {
 	auto i = max / ( Numericf::ZERO_TOLERANCE + v.getMagnitude() );
@@ -28,17 +37,17 @@ MotionApply::~MotionApply( void )
 
 Behavior::State MotionApply::step( BehaviorContext *context )
 {
-	auto velocity = context->getValue< Vector3f >( "motion.velocity" );
-	auto steering = context->getValue< Vector3f >( "motion.steering" );
-	auto position = context->getValue< Vector3f >( "motion.position" );
+	auto velocity = context->getValue< Vector3f >( MOTION_VELOCITY );
+	auto steering = context->getValue< Vector3f >( MOTION_STEERING );
+	auto position = context->getValue< Vector3f >( MOTION_POSITION );
 
-	auto maxForce = context->getValue< crimild::Real32 >( "motion.max_force" );
+	auto maxForce = context->getValue< crimild::Real32 >( MOTION_MAX_FORCE );
 	steering = steering.getTruncated( maxForce );
 
-	auto mass = context->getValue< crimild::Real32 >( "motion.mass" );
+	auto mass = context->getValue< crimild::Real32 >( MOTION_MASS );
 	steering /= mass;
 
-	auto maxVelocity = context->getValue< crimild::Real32 >( "motion.max_velocity" );
+	auto maxVelocity = context->getValue< crimild::Real32 >( MOTION_MAX_VELOCITY );
 	velocity = truncate( velocity + steering, maxVelocity );
 
 	position += context->getClock().getDeltaTime() * velocity;
@@ -63,9 +72,9 @@ Behavior::State MotionApply::step( BehaviorContext *context )
 		agent->local().setRotate( Quaternion4f::createFromDirection( dir ) );
 	}
 	
-	context->setValue( "motion.position", position );
-	context->setValue( "motion.velocity", velocity );
-	context->setValue( "motion.velocity.magnitude", velocityMagnitude );
+	context->setValue( MOTION_POSITION, position );
+	context->setValue( MOTION_VELOCITY, velocity );
+	context->setValue( MOTION_VELOCITY_MAGNITUDE, velocityMagnitude );
 	
 	return Behavior::State::SUCCESS;
 }
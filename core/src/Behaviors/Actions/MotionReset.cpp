@@ -6,6 +6,10 @@ using namespace crimild;
 using namespace crimild::behaviors;
 using namespace crimild::behaviors::actions;
 
+static constexpr StringId MOTION_POSITION( "motion.position" );
+static constexpr StringId MOTION_STEERING( "motion.steering" );
+static constexpr StringId MOTION_TARGET( "motion.target" );
+
 MotionReset::MotionReset( void )
 {
 
@@ -40,16 +44,16 @@ Behavior::State MotionReset::step( BehaviorContext *context )
 {
 	auto agent = context->getAgent();
 
-	context->setValue( "motion.position", agent->getLocal().getTranslate() );
-	context->setValue( "motion.steering", Vector3f::ZERO );
+	context->setValue( MOTION_POSITION, agent->getLocal().getTranslate() );
+	context->setValue( MOTION_STEERING, Vector3f::ZERO );
 
 	if ( context->hasTargets() ) {
 		auto target = context->getTargetAt( 0 );
-		context->setValue( "motion.target", target->getLocal().getTranslate() );
+		context->setValue( MOTION_TARGET, target->getLocal().getTranslate() );
 	}
 	else {
 		// set target to self so no motion will be applied
-		context->setValue( "motion.target", agent->getLocal().getTranslate() );
+		context->setValue( MOTION_TARGET, agent->getLocal().getTranslate() );
 	}
 
 	return Behavior::State::SUCCESS;
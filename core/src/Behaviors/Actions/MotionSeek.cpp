@@ -6,6 +6,13 @@ using namespace crimild;
 using namespace crimild::behaviors;
 using namespace crimild::behaviors::actions;
 
+static constexpr StringId MOTION_VELOCITY( "motion.velocity" );
+static constexpr StringId MOTION_TARGET( "motion.target" );
+static constexpr StringId MOTION_POSITION( "motion.position" );
+static constexpr StringId MOTION_STEERING( "motion.steering" );
+static constexpr StringId MOTION_MAX_VELOCITY( "motion.max_velocity" );
+static constexpr StringId MOTION_SLOWING_RADIUS( "motion.slowing_radius" );
+
 MotionSeek::MotionSeek( void )
 {
 
@@ -18,13 +25,13 @@ MotionSeek::~MotionSeek( void )
 
 Behavior::State MotionSeek::step( BehaviorContext *context )
 {
-	auto velocity = context->getValue< Vector3f >( "motion.velocity" );
-	auto targetPosition = context->getValue< Vector3f >( "motion.target" );
-	auto position = context->getValue< Vector3f >( "motion.position" );
-	auto steering = context->getValue< Vector3f >( "motion.steering" );
+	auto velocity = context->getValue< Vector3f >( MOTION_VELOCITY );
+	auto targetPosition = context->getValue< Vector3f >( MOTION_TARGET );
+	auto position = context->getValue< Vector3f >( MOTION_POSITION );
+	auto steering = context->getValue< Vector3f >( MOTION_STEERING );
 
-	auto maxVelocity = context->getValue< crimild::Real32 >( "motion.max_velocity" );
-	auto slowingRadius = context->getValue< crimild::Real32 >( "motion.slowing_radius" );
+	auto maxVelocity = context->getValue< crimild::Real32 >( MOTION_MAX_VELOCITY );
+	auto slowingRadius = context->getValue< crimild::Real32 >( MOTION_SLOWING_RADIUS );
 
 	auto desiredVelocity = targetPosition - position;
 	auto distance = desiredVelocity.getMagnitude();
@@ -47,7 +54,7 @@ Behavior::State MotionSeek::step( BehaviorContext *context )
 	
     steering += desiredVelocity - velocity;
 
-	context->setValue( "motion.steering", steering );
+	context->setValue( MOTION_STEERING, steering );
 	
 	return Behavior::State::SUCCESS;
 }
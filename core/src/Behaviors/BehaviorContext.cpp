@@ -123,14 +123,50 @@ void BehaviorContext::foreachTarget( BehaviorContext::TargetCallback const &call
 	}
 }
 
+Variant &BehaviorContext::getOrCreateValue( StringId key, const char *suffix )
+{
+	auto id = suffix != nullptr ? key.append( suffix ) : key;
+	auto &value = _values[ id.getHash() ];
+	if ( value.key.empty() ) {
+		// only new values need a name
+		value.key = key.getName();
+		if ( suffix != nullptr ) {
+			value.key += suffix;
+		}
+	}
+	return value.value;
+}
+
+const Variant *BehaviorContext::findValue( StringId key ) const
+{
+	auto it = _values.find( key.getHash() );
+	return it != _values.end() ? &it->second.value : nullptr;
+}
+
+void BehaviorContext::setComponent( StringId key, const char *suffix, crimild::Real32 value )
+{
+	getOrCreateValue( key, suffix ).set( value );
+}
+
+crimild::Real32 BehaviorContext::getComponent( StringId key, const char *suffix ) const
+{
+	auto value = findValue( key.append( suffix ) );
+	if ( value == nullptr ) {
+		crimild::Log::warning( CRIMILD_CURRENT_CLASS_NAME, "No context value set for key ", key.getName(), suffix );
+		return 0.0f;
+	}
+
+	return value->get< crimild::Real32 >();
+}
+
 void BehaviorContext::encode( coding::Encoder &encoder )
 {
 	Codable::encode( encoder );
 
 	crimild::containers::Array< SharedPointer< BehaviorContextValue >> values;
-	_values.each( [ &values ]( std::string key, SharedPointer< BehaviorContextValue > &value ) {
-		values.add( value );
-	});
+	for ( const auto &it : _values ) {
+		values.add( crimild::alloc< BehaviorContextValue >( it.second.key, it.second.value.getString() ) );
+	}
 	encoder.encode( "values", values );
 }
 
@@ -142,7 +178,7 @@ void BehaviorContext::decode( coding::Decoder &decoder )
 	decoder.decode( "values", values );
 	_values.clear();
 	values.each( [ this ]( SharedPointer< BehaviorContextValue > &value, crimild::Size ) {
-		_values[ value->getKey() ] = value;
+		setValue( value->getKey(), value->getValue() );
 	});
 }
 
@@ -150,10 +186,9 @@ void BehaviorContext::dump( void ) const
 {
 	std::stringstream ss;
     
-    _values.each( [ &ss ]( std::string, const SharedPointer< BehaviorContextValue > &value ) {
-        ss << "\n\t\"" << value->getKey() << "\" = \"" << value->getValue() << "\"";
-    });
+	for ( const auto &it : _values ) {
+        ss << "\n\t\"" << it.second.key << "\" = \"" << it.second.value.getString() << "\"";
+	}
 
 	Log::debug( CRIMILD_CURRENT_CLASS_NAME, "Behavior context dump: ", ss.str() );
 }
-
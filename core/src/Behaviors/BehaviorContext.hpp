@@ -31,7 +31,9 @@
 #include "Foundation/Types.hpp"
 #include "Foundation/Log.hpp"
 #include "Foundation/RTTI.hpp"
-#include "Foundation/Containers/Map.hpp"
+#include "Foundation/StringId.hpp"
+#include "Foundation/Variant.hpp"
+#include "Foundation/Containers/Array.hpp"
 #include "Coding/Codable.hpp"
 #include "Mathematics/Clock.hpp"
 #include "Mathematics/Vector.hpp"
@@ -39,6 +41,7 @@
 #include <functional>
 #include <vector>
 #include <string>
+#include <unordered_map>
 
 namespace crimild {
 
@@ -118,37 +121,64 @@ namespace crimild {
 		private:
 			crimild::Clock _clock;
 
+			/**
+				\name Values
+
+				Values are stored in typed slots indexed by hashed keys, so 
+				behaviors can read and write them every frame without any
+				string comparisons or parsing. Keys used in hot paths should 
+				be declared as compile-time ids:
+
+				\code
+				static constexpr StringId MOTION_MASS( "motion.mass" );
+				auto mass = context->getValue< crimild::Real32 >( MOTION_MASS );
+				\endcode
+
+				Vectors are stored as one value per component, using the
+				".x", ".y", ".z" and ".w" suffixes.
+			*/
+			//@{
+
 		public:
-			bool hasValue( std::string key )
+			bool hasValue( StringId key ) const
 			{
-				return _values.contains( key );
+				return findValue( key ) != nullptr;
 			}
 			
 			template< typename T >
-			void setValue( std::string key, T value )
+			void setValue( StringId key, T value )
 			{
-				std::stringstream ss;
-				ss << value;
-				_values[ key ] = crimild::alloc< BehaviorContextValue >( key, ss.str() );
+				getOrCreateValue( key ).set( value );
 			}
 			
 			template< typename T >
-			T getValue( std::string key )
+			T getValue( StringId key ) const
 			{
-				if ( !hasValue( key ) ) {
-					crimild::Log::warning( CRIMILD_CURRENT_CLASS_NAME, "No context value set for key ", key );
+				auto value = findValue( key );
+				if ( value == nullptr ) {
+					crimild::Log::warning( CRIMILD_CURRENT_CLASS_NAME, "No context value set for key ", key.getName() );
                     return T();
 				}
 
-                T value;
-				std::stringstream ss;
-				ss << _values[ key ]->getValue();
-				ss >> value;
-				return value;
+				return value->get< T >();
 			}
 			
 		private:
-			containers::Map< std::string, SharedPointer< BehaviorContextValue >> _values;
+			Variant &getOrCreateValue( StringId key, const char *suffix = nullptr );
+			const Variant *findValue( StringId key ) const;
+
+			void setComponent( StringId key, const char *suffix, crimild::Real32 value );
+			crimild::Real32 getComponent( StringId key, const char *suffix ) const;
+
+		private:
+			struct ContextValue {
+				std::string key;
+				Variant value;
+			};
+
+			std::unordered_map< StringId::Hash, ContextValue > _values;
+
+			//@}
 
 			/**
 			   \name Coding support
@@ -166,32 +196,41 @@ namespace crimild {
 		};
 
 		template<>
-		inline void BehaviorContext::setValue< Vector3f >( std::string key, Vector3f value )
+		inline void BehaviorContext::setValue< Vector3f >( StringId key, Vector3f value )
 		{
-			setValue< crimild::Real32 >( key + ".x", value.x() );
-			setValue< crimild::Real32 >( key + ".y", value.y() );
-			setValue< crimild::Real32 >( key + ".z", value.z() );
+			setComponent( key, ".x", value.x() );
+			setComponent( key, ".y", value.y() );
+			setComponent( key, ".z", value.z() );
 		}
 
 		template<>
-		inline crimild::Vector3f BehaviorContext::getValue( std::string key )
+		inline crimild::Vector3f BehaviorContext::getValue( StringId key ) const
 		{
 			return Vector3f(
-				getValue< crimild::Real32 >( key + ".x" ),
-				getValue< crimild::Real32 >( key + ".y" ),
-				getValue< crimild::Real32 >( key + ".z" )
+				getComponent( key, ".x" ),
+				getComponent( key, ".y" ),
+				getComponent( key, ".z" )
 			);
 		}
 		
 		template<>
-		inline crimild::Vector4f BehaviorContext::getValue( std::string key )
+		inline void BehaviorContext::setValue< Vector4f >( StringId key, Vector4f value )
 		{
-			std::stringstream ss;
-			ss << _values[ key ];
+			setComponent( key, ".x", value.x() );
+			setComponent( key, ".y", value.y() );
+			setComponent( key, ".z", value.z() );
+			setComponent( key, ".w", value.w() );
+		}
 
-			float x, y, z, w;
-			ss >> x >> y >> z >> w;
-			return crimild::Vector4f( x, y, z, w );
+		template<>
+		inline crimild::Vector4f BehaviorContext::getValue( StringId key ) const
+		{
+			return Vector4f(
+				getComponent( key, ".x" ),
+				getComponent( key, ".y" ),
+				getComponent( key, ".z" ),
+				getComponent( key, ".w" )
+			);
 		}
 
 	}
@@ -0,0 +1,402 @@
+/*
+ * Copyright (c) 2013, Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "BinaryDecoder.hpp"
+
+#include "Foundation/Log.hpp"
+#include "Foundation/ObjectFactory.hpp"
+
+using namespace crimild;
+using namespace crimild::coding;
+
+BinaryDecoder::BinaryDecoder( void )
+{
+
+}
+
+BinaryDecoder::~BinaryDecoder( void )
+{
+
+}
+
+crimild::Bool BinaryDecoder::decode( std::string key, SharedPointer< coding::Codable > &codable )
+{
+	codable = nullptr;
+
+	auto payload = findField( key, FieldType::OBJECT );
+	if ( payload == nullptr ) {
+		return false;
+	}
+
+	crimild::UInt64 ref;
+	if ( BinaryFormat::readVarUInt( payload, _end, ref ) == nullptr || ref == 0 || ref > _objects.size() ) {
+		return false;
+	}
+
+	codable = getObject( ref - 1 );
+	return codable != nullptr;
+}
+
+crimild::Bool BinaryDecoder::decode( std::string key, std::string &value )
+{
+	auto payload = findField( key, FieldType::STRING );
+	if ( payload == nullptr ) {
+		return false;
+	}
+
+	return BinaryFormat::readString( payload, _end, value ) != nullptr;
+}
+
+crimild::Size BinaryDecoder::beginDecodingArray( std::string key )
+{
+	ArrayContext array;
+	array.keyIndex = 0;
+	array.remaining = 0;
+	array.cursor = nullptr;
+	array.pending = false;
+
+	// Always push a context, even if the array is missing, so
+	// endDecodingArray() pops the right one
+	auto payload = findField( key, FieldType::ARRAY );
+	if ( payload != nullptr ) {
+		crimild::UInt64 count;
+		payload = BinaryFormat::readVarUInt( payload, _end, count );
+		if ( payload != nullptr ) {
+			array.keyIndex = _keyIndices[ key ];
+			array.remaining = count;
+			array.cursor = payload;
+		}
+	}
+
+	_frames.back().arrays.push_back( array );
+
+	return array.remaining;
+}
+
+std::string BinaryDecoder::beginDecodingArrayElement( std::string key, crimild::Size index )
+{
+	auto &arrays = _frames.back().arrays;
+	if ( !arrays.empty() && arrays.back().remaining > 0 ) {
+		arrays.back().pending = true;
+	}
+
+	return key;
+}
+
+void BinaryDecoder::endDecodingArrayElement( std::string key, crimild::Size index )
+{
+	auto &arrays = _frames.back().arrays;
+	if ( arrays.empty() ) {
+		return;
+	}
+
+	auto &array = arrays.back();
+	if ( array.pending ) {
+		// element was not decoded. Skip it
+		crimild::UInt64 keyIndex;
+		FieldType type;
+		auto payload = readFieldHeader( array.cursor, _end, keyIndex, type );
+		auto next = payload != nullptr ? BinaryFormat::skipPayload( payload, _end, type ) : nullptr;
+		array.cursor = next;
+		array.remaining = next != nullptr ? array.remaining - 1 : 0;
+		array.pending = false;
+	}
+}
+
+void BinaryDecoder::endDecodingArray( std::string key )
+{
+	auto &arrays = _frames.back().arrays;
+	if ( !arrays.empty() ) {
+		arrays.pop_back();
+	}
+}
+
+const crimild::Byte *BinaryDecoder::readFieldHeader( const crimild::Byte *it, const crimild::Byte *end, crimild::UInt64 &keyIndex, FieldType &type )
+{
+	it = BinaryFormat::readVarUInt( it, end, keyIndex );
+	if ( it == nullptr || it >= end ) {
+		return nullptr;
+	}
+
+	type = static_cast< FieldType >( *it++ );
+	return it;
+}
+
+const crimild::Byte *BinaryDecoder::findField( const std::string &key, FieldType type )
+{
+	if ( _frames.empty() ) {
+		return nullptr;
+	}
+
+	auto keyIt = _keyIndices.find( key );
+	if ( keyIt == _keyIndices.end() ) {
+		return nullptr;
+	}
+	const auto keyIndex = keyIt->second;
+
+	auto &frame = _frames.back();
+
+	if ( !frame.arrays.empty() && frame.arrays.back().pending && frame.arrays.back().keyIndex == keyIndex ) {
+		// consume the next array element
+		auto &array = frame.arrays.back();
+		array.pending = false;
+
+		crimild::UInt64 elementKey;
+		FieldType elementType;
+		auto payload = readFieldHeader( array.cursor, _end, elementKey, elementType );
+		auto next = payload != nullptr ? BinaryFormat::skipPayload( payload, _end, elementType ) : nullptr;
+		if ( next == nullptr ) {
+			array.remaining = 0;
+			return nullptr;
+		}
+
+		array.cursor = next;
+		array.remaining--;
+		return elementKey == keyIndex && elementType == type ? payload : nullptr;
+	}
+
+	const auto &info = _objects[ frame.objectIndex ];
+
+	// Fields are usually decoded in the same order they were encoded, so
+	// start searching right after the last field found and wrap around
+	auto start = frame.hint;
+	auto it = start;
+	auto end = info.end;
+	auto wrapped = false;
+	while ( true ) {
+		if ( it >= end ) {
+			if ( wrapped || start == info.begin ) {
+				return nullptr;
+			}
+			wrapped = true;
+			it = info.begin;
+			end = start;
+			continue;
+		}
+
+		crimild::UInt64 fieldKey;
+		FieldType fieldType;
+		auto payload = readFieldHeader( it, info.end, fieldKey, fieldType );
+		auto next = payload != nullptr ? BinaryFormat::skipPayload( payload, info.end, fieldType ) : nullptr;
+		if ( next == nullptr ) {
+			Log::error( CRIMILD_CURRENT_CLASS_NAME, "Invalid field data for key ", key );
+			return nullptr;
+		}
+
+		if ( fieldKey == keyIndex ) {
+			if ( fieldType != type ) {
+				Log::warning( CRIMILD_CURRENT_CLASS_NAME, "Type mismatch for key ", key );
+				return nullptr;
+			}
+			frame.hint = next;
+			return payload;
+		}
+
+		it = next;
+	}
+}
+
+SharedPointer< Codable > BinaryDecoder::getObject( crimild::UInt64 index )
+{
+	auto &info = _objects[ index ];
+	if ( info.object != nullptr ) {
+		return info.object;
+	}
+
+	const auto &className = _classNames[ info.classIndex ];
+	auto obj = crimild::dynamic_cast_ptr< Codable >( ObjectFactory::getInstance()->build( className ) );
+	if ( obj == nullptr ) {
+		Log::error( CRIMILD_CURRENT_CLASS_NAME, "Cannot build object of type ", className );
+		return nullptr;
+	}
+
+	// Store the object before decoding it to handle circular references
+	info.object = obj;
+
+	Frame frame;
+	frame.objectIndex = static_cast< crimild::UInt32 >( index );
+	frame.hint = info.begin;
+	_frames.push_back( frame );
+
+	obj->decode( *this );
+
+	_frames.pop_back();
+
+	return obj;
+}
+
+crimild::Bool BinaryDecoder::fromBytes( const containers::ByteArray &bytes )
+{
+	return fromBytes( bytes.getData(), bytes.size() );
+}
+
+crimild::Bool BinaryDecoder::fromBytes( const crimild::Byte *data, crimild::Size size )
+{
+	return parse( data, size ) && decodeRoots();
+}
+
+SharedPointer< Codable > BinaryDecoder::decodeRootAt( crimild::Size index )
+{
+	if ( index >= _rootIndices.size() ) {
+		return nullptr;
+	}
+
+	return getObject( _rootIndices[ index ] );
+}
+
+crimild::Bool BinaryDecoder::decodeRoots( void )
+{
+	for ( crimild::Size i = 0; i < _rootIndices.size(); i++ ) {
+		auto obj = decodeRootAt( i );
+		if ( obj == nullptr ) {
+			return false;
+		}
+		addRootObject( crimild::dynamic_cast_ptr< SharedObject >( obj ) );
+	}
+
+	return true;
+}
+
+crimild::Bool BinaryDecoder::parse( const crimild::Byte *data, crimild::Size size )
+{
+	const auto end = data + size;
+	auto it = data;
+
+	crimild::UInt32 magic = 0;
+	crimild::UInt32 formatVersion = 0;
+	if ( size < 2 * sizeof( crimild::UInt32 ) ) {
+		Log::error( CRIMILD_CURRENT_CLASS_NAME, "Invalid data format" );
+		return false;
+	}
+	memcpy( &magic, it, sizeof( crimild::UInt32 ) );
+	it += sizeof( crimild::UInt32 );
+	memcpy( &formatVersion, it, sizeof( crimild::UInt32 ) );
+	it += sizeof( crimild::UInt32 );
+
+	if ( magic != BinaryFormat::MAGIC ) {
+		Log::error( CRIMILD_CURRENT_CLASS_NAME, "Invalid data format" );
+		return false;
+	}
+
+	if ( formatVersion != BinaryFormat::FORMAT_VERSION ) {
+		Log::error( CRIMILD_CURRENT_CLASS_NAME, "Unsupported format version ", formatVersion );
+		return false;
+	}
+
+	std::string versionStr;
+	it = BinaryFormat::readString( it, end, versionStr );
+	if ( it == nullptr ) {
+		Log::error( CRIMILD_CURRENT_CLASS_NAME, "Invalid data format. Cannot read version" );
+		return false;
+	}
+	setVersion( Version( versionStr ) );
+
+	auto readStrings = [ &it, end ]( std::vector< std::string > &out ) -> crimild::Bool {
+		crimild::UInt64 count;
+		it = BinaryFormat::readVarUInt( it, end, count );
+		if ( it == nullptr || count > crimild::UInt64( end - it ) ) {
+			return false;
+		}
+		out.resize( count );
+		for ( auto &str : out ) {
+			it = BinaryFormat::readString( it, end, str );
+			if ( it == nullptr ) {
+				return false;
+			}
+		}
+		return true;
+	};
+
+	if ( !readStrings( _keys ) || !readStrings( _classNames ) ) {
+		Log::error( CRIMILD_CURRENT_CLASS_NAME, "Invalid data format. Cannot read key or class tables" );
+		return false;
+	}
+
+	for ( crimild::Size i = 0; i < _keys.size(); i++ ) {
+		_keyIndices[ _keys[ i ] ] = static_cast< crimild::UInt32 >( i );
+	}
+
+	crimild::UInt64 objectCount;
+	it = BinaryFormat::readVarUInt( it, end, objectCount );
+	if ( it == nullptr || objectCount > crimild::UInt64( end - it ) ) {
+		Log::error( CRIMILD_CURRENT_CLASS_NAME, "Invalid data format. Cannot read object table" );
+		return false;
+	}
+
+	std::vector< crimild::UInt64 > recordSizes( objectCount );
+	_objects.resize( objectCount );
+	for ( crimild::Size i = 0; i < objectCount; i++ ) {
+		crimild::UInt64 classIndex = 0;
+		it = BinaryFormat::readVarUInt( it, end, classIndex );
+		if ( it != nullptr ) {
+			it = BinaryFormat::readVarUInt( it, end, recordSizes[ i ] );
+		}
+		if ( it == nullptr || classIndex >= _classNames.size() ) {
+			Log::error( CRIMILD_CURRENT_CLASS_NAME, "Invalid data format. Cannot read object table" );
+			return false;
+		}
+		_objects[ i ].classIndex = static_cast< crimild::UInt32 >( classIndex );
+	}
+
+	crimild::UInt64 rootCount;
+	it = BinaryFormat::readVarUInt( it, end, rootCount );
+	if ( it == nullptr || rootCount > crimild::UInt64( end - it ) ) {
+		Log::error( CRIMILD_CURRENT_CLASS_NAME, "Invalid data format. Cannot read roots" );
+		return false;
+	}
+
+	_rootIndices.resize( rootCount );
+	for ( auto &root : _rootIndices ) {
+		crimild::UInt64 index;
+		it = BinaryFormat::readVarUInt( it, end, index );
+		if ( it == nullptr || index >= objectCount ) {
+			Log::error( CRIMILD_CURRENT_CLASS_NAME, "Invalid data format. Cannot read roots" );
+			_rootIndices.clear();
+			return false;
+		}
+		root = static_cast< crimild::UInt32 >( index );
+	}
+
+	// Records are stored contiguously after the header, so offsets
+	// are computed from their sizes. Records are not read until needed
+	for ( crimild::Size i = 0; i < objectCount; i++ ) {
+		if ( recordSizes[ i ] > crimild::UInt64( end - it ) ) {
+			Log::error( CRIMILD_CURRENT_CLASS_NAME, "Invalid data format. Object record out of bounds" );
+			_rootIndices.clear();
+			return false;
+		}
+		_objects[ i ].begin = it;
+		_objects[ i ].end = it + recordSizes[ i ];
+		it += recordSizes[ i ];
+	}
+
+	_end = end;
+
+	return true;
+}
+
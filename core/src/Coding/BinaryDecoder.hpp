@@ -0,0 +1,231 @@
+/*
+ * Copyright (c) 2013, Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef CRIMILD_CORE_CODING_BINARY_DECODER_
+#define CRIMILD_CORE_CODING_BINARY_DECODER_
+
+#include "Decoder.hpp"
+#include "BinaryFormat.hpp"
+
+#include <cstring>
+#include <unordered_map>
+#include <vector>
+
+namespace crimild {
+
+	namespace coding {
+
+		/**
+		   \brief Decodes data created by BinaryEncoder
+
+		   Objects are created the first time they are referenced and 
+		   decoded only once, so shared objects (i.e. materials) are 
+		   preserved as such. Fields are looked up in the order they
+		   were encoded, so decoding in the same order as encoding
+		   requires no searching at all.
+
+		   fromBytes() decodes all root objects at once. Alternatively,
+		   parse() only reads the header and object table, and each root
+		   is decoded on demand by decodeRootAt() along with the objects
+		   it references. Nothing else is touched.
+
+		   \see BinaryFormat
+		   \see BinaryEncoder
+		 */
+        class BinaryDecoder : public Decoder {
+        private:
+			using FieldType = BinaryFormat::FieldType;
+
+        public:
+            BinaryDecoder( void );
+            virtual ~BinaryDecoder( void );
+
+		public:
+            virtual crimild::Bool decode( std::string key, SharedPointer< coding::Codable > &codable ) override;
+
+            virtual crimild::Bool decode( std::string key, std::string &value ) override;
+            
+            virtual crimild::Bool decode( std::string key, crimild::Size &value ) override { return decodeValue( key, FieldType::SIZE, value ); }
+            virtual crimild::Bool decode( std::string key, crimild::UInt8 &value ) override { return decodeValue( key, FieldType::UINT8, value ); }
+            virtual crimild::Bool decode( std::string key, crimild::UInt16 &value ) override { return decodeValue( key, FieldType::UINT16, value ); }
+            virtual crimild::Bool decode( std::string key, crimild::Int16 &value ) override { return decodeValue( key, FieldType::INT16, value ); }
+            virtual crimild::Bool decode( std::string key, crimild::Int32 &value ) override { return decodeValue( key, FieldType::INT32, value ); }
+            virtual crimild::Bool decode( std::string key, crimild::UInt32 &value ) override { return decodeValue( key, FieldType::UINT32, value ); }
+            virtual crimild::Bool decode( std::string key, crimild::Bool &value ) override { return decodeValue( key, FieldType::BOOL, value ); }
+			virtual crimild::Bool decode( std::string key, crimild::Real32 &value ) override { return decodeValue( key, FieldType::REAL32, value ); }
+			virtual crimild::Bool decode( std::string key, crimild::Real64 &value ) override { return decodeValue( key, FieldType::REAL64, value ); }
+			virtual crimild::Bool decode( std::string key, crimild::Vector2f &value ) override { return decodeValue( key, FieldType::VECTOR2F, value ); }
+			virtual crimild::Bool decode( std::string key, crimild::Vector3f &value ) override { return decodeValue( key, FieldType::VECTOR3F, value ); }
+            virtual crimild::Bool decode( std::string key, crimild::Vector4f &value ) override { return decodeValue( key, FieldType::VECTOR4F, value ); }
+            virtual crimild::Bool decode( std::string key, crimild::Matrix3f &value ) override { return decodeValue( key, FieldType::MATRIX3F, value ); }
+            virtual crimild::Bool decode( std::string key, crimild::Matrix4f &value ) override { return decodeValue( key, FieldType::MATRIX4F, value ); }
+            virtual crimild::Bool decode( std::string key, crimild::Quaternion4f &value ) override { return decodeValue( key, FieldType::QUATERNION4F, value ); }
+            virtual crimild::Bool decode( std::string key, Transformation &value ) override { return decodeValue( key, FieldType::TRANSFORMATION, value ); }
+            virtual crimild::Bool decode( std::string key, VertexFormat &value ) override { return decodeValue( key, FieldType::VERTEX_FORMAT, value ); }
+            
+            virtual crimild::Bool decode( std::string key, containers::ByteArray &value ) override { return decodeBlob( key, value ); }
+            virtual crimild::Bool decode( std::string key, containers::Array< crimild::Real32 > &value ) override { return decodeBlob( key, value ); }
+            virtual crimild::Bool decode( std::string key, containers::Array< Vector3f > &value ) override { return decodeBlob( key, value ); }
+            virtual crimild::Bool decode( std::string key, containers::Array< Vector4f > &value ) override { return decodeBlob( key, value ); }
+            virtual crimild::Bool decode( std::string key, containers::Array< Matrix3f > &value ) override { return decodeBlob( key, value ); }
+            virtual crimild::Bool decode( std::string key, containers::Array< Matrix4f > &value ) override { return decodeBlob( key, value ); }
+            virtual crimild::Bool decode( std::string key, containers::Array< Quaternion4f > &value ) override { return decodeBlob( key, value ); }
+            
+            crimild::Bool fromBytes( const containers::ByteArray &bytes );
+            crimild::Bool fromBytes( const crimild::Byte *data, crimild::Size size );
+
+			/**
+			   \brief Reads the header and object table without decoding any object
+
+			   \remarks Data must remain valid while decoding roots
+			 */
+			crimild::Bool parse( const crimild::Byte *data, crimild::Size size );
+
+			inline crimild::Size getRootCount( void ) const { return _rootIndices.size(); }
+
+			/**
+			   \brief Decodes a root object and everything it references
+
+			   Objects already decoded by other roots are shared.
+			 */
+			SharedPointer< Codable > decodeRootAt( crimild::Size index );
+
+			template< class T >
+			SharedPointer< T > decodeRootAt( crimild::Size index )
+			{
+				return crimild::dynamic_cast_ptr< T >( decodeRootAt( index ) );
+			}
+
+		protected:
+			/**
+			   \brief Decodes all roots and makes them available with getObjectAt()
+			 */
+			crimild::Bool decodeRoots( void );
+
+        private:
+			/**
+			   \brief Finds a field in the object being decoded
+
+			   If there's an array element pending, the field is taken 
+			   from the current array instead.
+
+			   \returns A pointer to the field's payload or nullptr if not found
+			 */
+			const crimild::Byte *findField( const std::string &key, FieldType type );
+
+            template< typename T >
+            crimild::Bool decodeValue( std::string key, FieldType type, T &value )
+            {
+				auto payload = findField( key, type );
+				if ( payload == nullptr ) {
+                    value = T();
+                    return false;
+                }
+
+				memcpy( &value, payload, sizeof( T ) );
+				return true;
+            }
+
+			template< typename T >
+			crimild::Bool decodeBlob( std::string key, containers::Array< T > &value )
+			{
+				auto payload = findField( key, FieldType::BLOB );
+				if ( payload == nullptr ) {
+					return false;
+				}
+
+				crimild::UInt64 size;
+				payload = BinaryFormat::readVarUInt( payload, _end, size );
+
+				const auto N = size / sizeof( T );
+				value.resize( N );
+				if ( N > 0 ) {
+					memcpy( &value[ 0 ], payload, N * sizeof( T ) );
+				}
+
+				return true;
+			}
+
+			/**
+			   \brief Gets an object from the object table, decoding it if needed
+			 */
+			SharedPointer< Codable > getObject( crimild::UInt64 index );
+
+			/**
+			   \brief Reads a field's key and type
+
+			   \returns A pointer to the field's payload or nullptr if data is invalid
+			 */
+			const crimild::Byte *readFieldHeader( const crimild::Byte *it, const crimild::Byte *end, crimild::UInt64 &keyIndex, FieldType &type );
+
+		protected:
+			virtual crimild::Size beginDecodingArray( std::string key ) override;
+			virtual std::string beginDecodingArrayElement( std::string key, crimild::Size index ) override;
+			virtual void endDecodingArrayElement( std::string key, crimild::Size index ) override;
+			virtual void endDecodingArray( std::string key ) override;
+
+		private:
+			struct ObjectInfo {
+				crimild::UInt32 classIndex = 0;
+				const crimild::Byte *begin = nullptr;
+				const crimild::Byte *end = nullptr;
+				SharedPointer< Codable > object;
+			};
+
+			struct ArrayContext {
+				crimild::UInt32 keyIndex;
+				crimild::UInt64 remaining;
+				const crimild::Byte *cursor;
+				crimild::Bool pending;
+			};
+
+			/**
+			   \brief Decoding state for each object in progress
+			 */
+			struct Frame {
+				crimild::UInt32 objectIndex;
+				const crimild::Byte *hint;
+				std::vector< ArrayContext > arrays;
+			};
+
+			const crimild::Byte *_end = nullptr;
+
+			std::vector< std::string > _keys;
+			std::unordered_map< std::string, crimild::UInt32 > _keyIndices;
+			std::vector< std::string > _classNames;
+			std::vector< ObjectInfo > _objects;
+			std::vector< crimild::UInt32 > _rootIndices;
+			std::vector< Frame > _frames;
+        };
+        
+	}
+    
+}
+
+#endif
+
@@ -0,0 +1,268 @@
+/*
+ * Copyright (c) 2013, Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "BinaryEncoder.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <sstream>
+
+using namespace crimild;
+using namespace crimild::coding;
+
+const crimild::UInt32 BinaryEncoder::NO_OBJECT = ~crimild::UInt32( 0 );
+
+BinaryEncoder::BinaryEncoder( void )
+	: _current( NO_OBJECT )
+{
+
+}
+
+BinaryEncoder::~BinaryEncoder( void )
+{
+
+}
+
+crimild::Bool BinaryEncoder::encode( SharedPointer< Codable > const &obj )
+{
+	if ( obj == nullptr ) {
+		return false;
+	}
+
+	const auto isRoot = _current == NO_OBJECT;
+	
+	auto index = registerObject( obj );
+
+	if ( isRoot && std::find( _roots.begin(), _roots.end(), index ) == _roots.end() ) {
+		_roots.push_back( index );
+	}
+
+	return true;
+}
+
+crimild::Bool BinaryEncoder::encode( std::string key, SharedPointer< Codable > const &obj )
+{
+	if ( _current == NO_OBJECT ) {
+		return false;
+	}
+
+	// Null references are written too, so array elements keep their positions
+	crimild::UInt32 ref = 0;
+	if ( obj != nullptr ) {
+		// must be done before writing the field since the current
+		// record might be reallocated while encoding the new object
+		ref = registerObject( obj ) + 1;
+	}
+
+	auto &out = beginField( key, FieldType::OBJECT );
+	BinaryFormat::writeVarUInt( out, ref );
+
+	return obj != nullptr;
+}
+
+crimild::Bool BinaryEncoder::encode( std::string key, std::string value )
+{
+	if ( _current == NO_OBJECT ) {
+		return false;
+	}
+
+	auto &out = beginField( key, FieldType::STRING );
+	BinaryFormat::writeString( out, value );
+	return true;
+}
+
+void BinaryEncoder::encodeArrayBegin( std::string key, crimild::Size count )
+{
+	if ( _current == NO_OBJECT ) {
+		return;
+	}
+
+	auto &out = beginField( key, FieldType::ARRAY );
+	BinaryFormat::writeVarUInt( out, count );
+}
+
+std::string BinaryEncoder::beginEncodingArrayElement( std::string key, crimild::Size index )
+{
+	// elements are identified by their position, so there's no need
+	// for generating a new key for each of them
+	return key;
+}
+
+void BinaryEncoder::endEncodingArrayElement( std::string key, crimild::Size index )
+{
+	// no-op
+}
+
+void BinaryEncoder::encodeArrayEnd( std::string key )
+{
+	// no-op
+}
+
+crimild::UInt32 BinaryEncoder::registerObject( SharedPointer< Codable > const &obj )
+{
+	auto it = _objectIndices.find( crimild::get_ptr( obj ) );
+	if ( it != _objectIndices.end() ) {
+		return it->second;
+	}
+
+	const auto index = static_cast< crimild::UInt32 >( _objects.size() );
+	_objectIndices[ crimild::get_ptr( obj ) ] = index;
+
+	ObjectInfo info;
+	info.object = obj;
+	info.classIndex = getClassIndex( obj->getClassName() );
+	_objects.push_back( info );
+
+	// Objects are indexed by position, since the array may be
+	// reallocated while encoding
+	auto temp = _current;
+	_current = index;
+	obj->encode( *this );
+	_current = temp;
+
+	return index;
+}
+
+crimild::UInt32 BinaryEncoder::getKeyIndex( const std::string &key )
+{
+	auto it = _keyIndices.find( key );
+	if ( it != _keyIndices.end() ) {
+		return it->second;
+	}
+
+	const auto index = static_cast< crimild::UInt32 >( _keys.size() );
+	_keys.push_back( key );
+	_keyIndices[ key ] = index;
+	return index;
+}
+
+crimild::UInt32 BinaryEncoder::getClassIndex( const std::string &className )
+{
+	auto it = _classIndices.find( className );
+	if ( it != _classIndices.end() ) {
+		return it->second;
+	}
+
+	const auto index = static_cast< crimild::UInt32 >( _classNames.size() );
+	_classNames.push_back( className );
+	_classIndices[ className ] = index;
+	return index;
+}
+
+std::vector< crimild::Byte > &BinaryEncoder::beginField( const std::string &key, FieldType type )
+{
+	const auto keyIndex = getKeyIndex( key );
+	auto &out = _objects[ _current ].record;
+	BinaryFormat::writeVarUInt( out, keyIndex );
+	out.push_back( static_cast< crimild::Byte >( type ) );
+	return out;
+}
+
+std::vector< crimild::Byte > BinaryEncoder::encodeHeader( void ) const
+{
+	std::vector< crimild::Byte > header;
+
+	auto appendUInt32 = [ &header ]( crimild::UInt32 value ) {
+		auto data = reinterpret_cast< const crimild::Byte * >( &value );
+		header.insert( header.end(), data, data + sizeof( crimild::UInt32 ) );
+	};
+
+	appendUInt32( BinaryFormat::MAGIC );
+	appendUInt32( BinaryFormat::FORMAT_VERSION );
+
+	BinaryFormat::writeString( header, getVersion().getDescription() );
+
+	BinaryFormat::writeVarUInt( header, _keys.size() );
+	for ( const auto &key : _keys ) {
+		BinaryFormat::writeString( header, key );
+	}
+
+	BinaryFormat::writeVarUInt( header, _classNames.size() );
+	for ( const auto &className : _classNames ) {
+		BinaryFormat::writeString( header, className );
+	}
+
+	BinaryFormat::writeVarUInt( header, _objects.size() );
+	for ( const auto &info : _objects ) {
+		BinaryFormat::writeVarUInt( header, info.classIndex );
+		BinaryFormat::writeVarUInt( header, info.record.size() );
+	}
+
+	BinaryFormat::writeVarUInt( header, _roots.size() );
+	for ( auto root : _roots ) {
+		BinaryFormat::writeVarUInt( header, root );
+	}
+
+	return header;
+}
+
+containers::ByteArray BinaryEncoder::getBytes( void ) const
+{
+	auto header = encodeHeader();
+
+	crimild::Size size = header.size();
+	for ( const auto &info : _objects ) {
+		size += info.record.size();
+	}
+
+	containers::ByteArray result( size );
+	auto out = result.getData();
+	memcpy( out, header.data(), header.size() );
+	out += header.size();
+	for ( const auto &info : _objects ) {
+		if ( !info.record.empty() ) {
+			memcpy( out, info.record.data(), info.record.size() );
+			out += info.record.size();
+		}
+	}
+
+	return result;
+}
+
+std::string BinaryEncoder::dump( void )
+{
+	std::stringstream ss;
+
+	ss << "Objects:\n";
+	for ( crimild::Size i = 0; i < _objects.size(); i++ ) {
+		ss << "\t" << i << " " << _classNames[ _objects[ i ].classIndex ] << " " << _objects[ i ].record.size() << " bytes\n";
+	}
+
+	ss << "Keys:\n";
+	for ( crimild::Size i = 0; i < _keys.size(); i++ ) {
+		ss << "\t" << i << " " << _keys[ i ] << "\n";
+	}
+
+	ss << "Roots:\n";
+	for ( auto root : _roots ) {
+		ss << "\t" << root << "\n";
+	}
+
+	return ss.str();
+}
+
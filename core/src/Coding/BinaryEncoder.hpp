@@ -0,0 +1,198 @@
+/*
+ * Copyright (c) 2013, Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef CRIMILD_CORE_CODING_BINARY_ENCODER_
+#define CRIMILD_CORE_CODING_BINARY_ENCODER_
+
+#include "Codable.hpp"
+#include "Encoder.hpp"
+#include "BinaryFormat.hpp"
+
+#include <cstring>
+#include <new>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+namespace crimild {
+
+	namespace coding {
+
+		/**
+		   \brief Compact binary encoder
+
+		   Unlike MemoryEncoder, values are not turned into separate
+		   objects. Each Codable is written as a single record with
+		   all of its fields inline and keys are stored only once.
+		   Bulk arrays are written as raw bytes.
+
+		   \see BinaryFormat
+		   \see BinaryDecoder
+		 */
+        class BinaryEncoder : public Encoder {
+        private:
+			using FieldType = BinaryFormat::FieldType;
+
+        public:
+            BinaryEncoder( void );
+            virtual ~BinaryEncoder( void );
+
+		public:
+            virtual crimild::Bool encode( SharedPointer< Codable > const &obj ) override;
+            virtual crimild::Bool encode( std::string key, SharedPointer< Codable > const &obj ) override;
+
+            virtual crimild::Bool encode( std::string key, std::string value ) override;
+
+            virtual crimild::Bool encode( std::string key, const Transformation &value ) override { return encodeValue( key, FieldType::TRANSFORMATION, value ); }
+            virtual crimild::Bool encode( std::string key, crimild::Size value ) override { return encodeValue( key, FieldType::SIZE, value ); }
+            virtual crimild::Bool encode( std::string key, crimild::UInt8 value ) override { return encodeValue( key, FieldType::UINT8, value ); }
+            virtual crimild::Bool encode( std::string key, crimild::UInt16 value ) override { return encodeValue( key, FieldType::UINT16, value ); }
+            virtual crimild::Bool encode( std::string key, crimild::Int16 value ) override { return encodeValue( key, FieldType::INT16, value ); }
+            virtual crimild::Bool encode( std::string key, crimild::Int32 value ) override { return encodeValue( key, FieldType::INT32, value ); }
+            virtual crimild::Bool encode( std::string key, crimild::UInt32 value ) override { return encodeValue( key, FieldType::UINT32, value ); }
+            virtual crimild::Bool encode( std::string key, crimild::Real32 value ) override { return encodeValue( key, FieldType::REAL32, value ); }
+            virtual crimild::Bool encode( std::string key, crimild::Real64 value ) override { return encodeValue( key, FieldType::REAL64, value ); }
+            virtual crimild::Bool encode( std::string key, const Vector2f &value ) override { return encodeValue( key, FieldType::VECTOR2F, value ); }
+            virtual crimild::Bool encode( std::string key, const Vector3f &value ) override { return encodeValue( key, FieldType::VECTOR3F, value ); }
+            virtual crimild::Bool encode( std::string key, const Vector4f &value ) override { return encodeValue( key, FieldType::VECTOR4F, value ); }
+            virtual crimild::Bool encode( std::string key, const Matrix3f &value ) override { return encodeValue( key, FieldType::MATRIX3F, value ); }
+            virtual crimild::Bool encode( std::string key, const Matrix4f &value ) override { return encodeValue( key, FieldType::MATRIX4F, value ); }
+            virtual crimild::Bool encode( std::string key, const Quaternion4f &value ) override { return encodeValue( key, FieldType::QUATERNION4F, value ); }
+            virtual crimild::Bool encode( std::string key, crimild::Bool value ) override { return encodeValue( key, FieldType::BOOL, value ); }
+            virtual crimild::Bool encode( std::string key, const crimild::VertexFormat &value ) override { return encodeValue( key, FieldType::VERTEX_FORMAT, value ); }
+
+			virtual crimild::Bool encode( std::string key, containers::ByteArray &value ) override { return encodeBlob( key, value ); }
+			virtual crimild::Bool encode( std::string key, containers::Array< crimild::Real32 > &value ) override { return encodeBlob( key, value ); }
+			virtual crimild::Bool encode( std::string key, containers::Array< Vector3f > &value ) override { return encodeBlob( key, value ); }
+			virtual crimild::Bool encode( std::string key, containers::Array< Vector4f > &value ) override { return encodeBlob( key, value ); }
+			virtual crimild::Bool encode( std::string key, containers::Array< Matrix3f > &value ) override { return encodeBlob( key, value ); }
+			virtual crimild::Bool encode( std::string key, containers::Array< Matrix4f > &value ) override { return encodeBlob( key, value ); }
+			virtual crimild::Bool encode( std::string key, containers::Array< Quaternion4f > &value ) override { return encodeBlob( key, value ); }
+
+            containers::ByteArray getBytes( void ) const;
+
+        protected:
+			/**
+			   \brief Everything that goes before object records
+			 */
+			std::vector< crimild::Byte > encodeHeader( void ) const;
+
+			inline crimild::Size getRecordCount( void ) const { return _objects.size(); }
+			inline const std::vector< crimild::Byte > &getRecordAt( crimild::Size index ) const { return _objects[ index ].record; }
+
+        protected:
+			virtual void encodeArrayBegin( std::string key, crimild::Size count ) override;
+			virtual std::string beginEncodingArrayElement( std::string key, crimild::Size index ) override;
+			virtual void endEncodingArrayElement( std::string key, crimild::Size index ) override;
+			virtual void encodeArrayEnd( std::string key ) override;
+
+        private:
+			/**
+			   \brief Adds an object to the object table, encoding it if needed
+
+			   \returns The object's position in the table
+			 */
+			crimild::UInt32 registerObject( SharedPointer< Codable > const &obj );
+
+			crimild::UInt32 getKeyIndex( const std::string &key );
+			crimild::UInt32 getClassIndex( const std::string &className );
+
+			/**
+			   \brief Writes a field's key and type to the current record
+
+			   \returns The record to write the payload to
+			 */
+			std::vector< crimild::Byte > &beginField( const std::string &key, FieldType type );
+
+			template< typename T >
+			crimild::Bool encodeValue( std::string key, FieldType type, const T &value )
+			{
+				if ( _current == NO_OBJECT ) {
+					return false;
+				}
+
+				// Copy into zeroed storage, so padding bytes (i.e. in 
+				// transformations) are always written as zeros and 
+				// encoding the same values produces the same data
+				typename std::aligned_storage< sizeof( T ), alignof( T ) >::type storage;
+				memset( &storage, 0, sizeof( T ) );
+				new ( &storage ) T( value );
+
+				auto &out = beginField( key, type );
+				auto data = reinterpret_cast< const crimild::Byte * >( &storage );
+				out.insert( out.end(), data, data + sizeof( T ) );
+				return true;
+			}
+
+			template< typename T >
+			crimild::Bool encodeBlob( std::string key, const containers::Array< T > &value )
+			{
+				if ( _current == NO_OBJECT ) {
+					return false;
+				}
+
+				auto &out = beginField( key, FieldType::BLOB );
+				const auto size = value.size() * sizeof( T );
+				BinaryFormat::writeVarUInt( out, size );
+				if ( size > 0 ) {
+					auto data = reinterpret_cast< const crimild::Byte * >( value.getData() );
+					out.insert( out.end(), data, data + size );
+				}
+				return true;
+			}
+
+        private:
+			static const crimild::UInt32 NO_OBJECT;
+
+			struct ObjectInfo {
+				SharedPointer< Codable > object;
+				crimild::UInt32 classIndex;
+				std::vector< crimild::Byte > record;
+			};
+
+			std::vector< ObjectInfo > _objects;
+			std::unordered_map< Codable *, crimild::UInt32 > _objectIndices;
+			std::vector< crimild::UInt32 > _roots;
+			crimild::UInt32 _current;
+
+			std::vector< std::string > _keys;
+			std::unordered_map< std::string, crimild::UInt32 > _keyIndices;
+
+			std::vector< std::string > _classNames;
+			std::unordered_map< std::string, crimild::UInt32 > _classIndices;
+
+        public:
+            virtual std::string dump( void ) override;
+        };
+
+	}
+
+}
+
+#endif
+
@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) 2013, Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef CRIMILD_CORE_CODING_BINARY_FILE_DECODER_
+#define CRIMILD_CORE_CODING_BINARY_FILE_DECODER_
+
+#include "BinaryDecoder.hpp"
+
+#include "Foundation/MappedFile.hpp"
+
+#include <memory>
+
+namespace crimild {
+
+	namespace coding {
+
+		/**
+		   \brief Decodes objects directly from a memory mapped file
+
+		   Only the header and the object table are read when opening
+		   a file. Object records are accessed in place as roots are 
+		   decoded, so only the pages containing the requested objects
+		   are ever loaded.
+
+		   \see BinaryFileEncoder
+		 */
+		class BinaryFileDecoder : public BinaryDecoder {
+		public:
+			BinaryFileDecoder( void );
+			virtual ~BinaryFileDecoder( void );
+
+			/**
+			   \brief Maps a file without decoding any object
+
+			   Use decodeRootAt() to decode roots on demand.
+			 */
+			crimild::Bool open( std::string filePath );
+
+			/**
+			   \brief Maps a file and decodes all of its roots
+			 */
+			crimild::Bool read( std::string filePath );
+
+		private:
+			std::unique_ptr< MappedFile > _file;
+		};
+        
+	}
+    
+}
+
+#endif
+
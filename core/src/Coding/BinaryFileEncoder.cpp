@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) 2013, Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "BinaryFileEncoder.hpp"
+#include "Foundation/Log.hpp"
+
+#include <cstdio>
+
+using namespace crimild;
+using namespace crimild::coding;
+
+BinaryFileEncoder::BinaryFileEncoder( void )
+{
+
+}
+
+BinaryFileEncoder::~BinaryFileEncoder( void )
+{
+
+}
+
+crimild::Bool BinaryFileEncoder::write( std::string filePath )
+{
+	if ( getRecordCount() == 0 ) {
+		Log::error( CRIMILD_CURRENT_CLASS_NAME, "Not enough data to write" );
+		return false;
+	}
+
+	FILE *file = fopen( filePath.c_str(), "wb" );
+	if ( file == nullptr ) {
+		Log::error( CRIMILD_CURRENT_CLASS_NAME, "Cannot open file ", filePath );
+		return false;
+	}
+
+	auto header = encodeHeader();
+	auto success = fwrite( header.data(), 1, header.size(), file ) == header.size();
+
+	for ( crimild::Size i = 0; success && i < getRecordCount(); i++ ) {
+		const auto &record = getRecordAt( i );
+		success = fwrite( record.data(), 1, record.size(), file ) == record.size();
+	}
+
+	if ( fclose( file ) != 0 ) {
+		success = false;
+	}
+
+	if ( !success ) {
+		Log::error( CRIMILD_CURRENT_CLASS_NAME, "Cannot write file ", filePath );
+		std::remove( filePath.c_str() );
+	}
+	
+	return success;
+}
+
@@ -0,0 +1,146 @@
+/*
+ * Copyright (c) 2013, Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "BinaryFormat.hpp"
+
+#include "Mathematics/Transformation.hpp"
+#include "Rendering/VertexFormat.hpp"
+
+using namespace crimild;
+using namespace crimild::coding;
+
+// "CRMB" when read as little endian
+const crimild::UInt32 BinaryFormat::MAGIC = 0x424d5243;
+const crimild::UInt32 BinaryFormat::FORMAT_VERSION = 1;
+
+crimild::Size BinaryFormat::getFixedSize( FieldType type )
+{
+	switch ( type ) {
+		case FieldType::SIZE: return sizeof( crimild::Size );
+		case FieldType::UINT8: return sizeof( crimild::UInt8 );
+		case FieldType::UINT16: return sizeof( crimild::UInt16 );
+		case FieldType::INT16: return sizeof( crimild::Int16 );
+		case FieldType::INT32: return sizeof( crimild::Int32 );
+		case FieldType::UINT32: return sizeof( crimild::UInt32 );
+		case FieldType::BOOL: return sizeof( crimild::Bool );
+		case FieldType::REAL32: return sizeof( crimild::Real32 );
+		case FieldType::REAL64: return sizeof( crimild::Real64 );
+		case FieldType::VECTOR2F: return sizeof( Vector2f );
+		case FieldType::VECTOR3F: return sizeof( Vector3f );
+		case FieldType::VECTOR4F: return sizeof( Vector4f );
+		case FieldType::MATRIX3F: return sizeof( Matrix3f );
+		case FieldType::MATRIX4F: return sizeof( Matrix4f );
+		case FieldType::QUATERNION4F: return sizeof( Quaternion4f );
+		case FieldType::TRANSFORMATION: return sizeof( Transformation );
+		case FieldType::VERTEX_FORMAT: return sizeof( VertexFormat );
+		default: return 0;
+	}
+}
+
+void BinaryFormat::writeVarUInt( std::vector< crimild::Byte > &out, crimild::UInt64 value )
+{
+	while ( value >= 0x80 ) {
+		out.push_back( static_cast< crimild::Byte >( value | 0x80 ) );
+		value >>= 7;
+	}
+	out.push_back( static_cast< crimild::Byte >( value ) );
+}
+
+void BinaryFormat::writeString( std::vector< crimild::Byte > &out, const std::string &value )
+{
+	writeVarUInt( out, value.length() );
+	out.insert( out.end(), value.begin(), value.end() );
+}
+
+const crimild::Byte *BinaryFormat::readVarUInt( const crimild::Byte *it, const crimild::Byte *end, crimild::UInt64 &value )
+{
+	value = 0;
+	for ( crimild::UInt32 shift = 0; it < end && shift < 64; shift += 7 ) {
+		const auto b = *it++;
+		value |= crimild::UInt64( b & 0x7f ) << shift;
+		if ( ( b & 0x80 ) == 0 ) {
+			return it;
+		}
+	}
+	return nullptr;
+}
+
+const crimild::Byte *BinaryFormat::readString( const crimild::Byte *it, const crimild::Byte *end, std::string &value )
+{
+	crimild::UInt64 length;
+	it = readVarUInt( it, end, length );
+	if ( it == nullptr || length > crimild::UInt64( end - it ) ) {
+		return nullptr;
+	}
+	value.assign( reinterpret_cast< const char * >( it ), length );
+	return it + length;
+}
+
+const crimild::Byte *BinaryFormat::skipPayload( const crimild::Byte *it, const crimild::Byte *end, FieldType type )
+{
+	switch ( type ) {
+		case FieldType::OBJECT: {
+			crimild::UInt64 index;
+			return readVarUInt( it, end, index );
+		}
+
+		case FieldType::STRING:
+		case FieldType::BLOB: {
+			crimild::UInt64 length;
+			it = readVarUInt( it, end, length );
+			if ( it == nullptr || length > crimild::UInt64( end - it ) ) {
+				return nullptr;
+			}
+			return it + length;
+		}
+
+		case FieldType::ARRAY: {
+			crimild::UInt64 count;
+			it = readVarUInt( it, end, count );
+			for ( crimild::UInt64 i = 0; it != nullptr && i < count; i++ ) {
+				crimild::UInt64 key;
+				it = readVarUInt( it, end, key );
+				if ( it == nullptr || it >= end ) {
+					return nullptr;
+				}
+				auto elementType = static_cast< FieldType >( *it++ );
+				it = skipPayload( it, end, elementType );
+			}
+			return it;
+		}
+
+		default: {
+			auto size = getFixedSize( type );
+			if ( size == 0 || size > crimild::Size( end - it ) ) {
+				return nullptr;
+			}
+			return it + size;
+		}
+	}
+}
+
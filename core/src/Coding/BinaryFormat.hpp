@@ -0,0 +1,124 @@
+/*
+ * Copyright (c) 2013, Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef CRIMILD_CORE_CODING_BINARY_FORMAT_
+#define CRIMILD_CORE_CODING_BINARY_FORMAT_
+
+#include "Foundation/Types.hpp"
+
+#include <string>
+#include <vector>
+
+namespace crimild {
+
+	namespace coding {
+
+		/**
+		   \brief Layout shared by BinaryEncoder and BinaryDecoder
+
+		   Data is organized as follows:
+
+		   - Magic number and format version (two UInt32)
+		   - Data version string
+		   - Key table: every field name used, stored once
+		   - Class table: every class name used, stored once
+		   - Object table: class index and record size for each object
+		   - Root object indices
+		   - Object records, in the same order as the object table
+
+		   Each record is a contiguous list of fields. A field is made of
+		   a key index, a type tag and its payload. Values like numbers,
+		   vectors or transformations are stored inline as they are in
+		   memory, while strings and bulk arrays are stored as a length
+		   followed by raw bytes. References to other objects are stored
+		   as indices in the object table (zero meaning null).
+
+		   Strings, counts and indices use a variable-length encoding
+		   (LEB128), so small values take a single byte.
+		 */
+		class BinaryFormat {
+		public:
+			static const crimild::UInt32 MAGIC;
+			static const crimild::UInt32 FORMAT_VERSION;
+
+			enum class FieldType : crimild::UInt8 {
+				OBJECT,
+				STRING,
+				SIZE,
+				UINT8,
+				UINT16,
+				INT16,
+				INT32,
+				UINT32,
+				BOOL,
+				REAL32,
+				REAL64,
+				VECTOR2F,
+				VECTOR3F,
+				VECTOR4F,
+				MATRIX3F,
+				MATRIX4F,
+				QUATERNION4F,
+				TRANSFORMATION,
+				VERTEX_FORMAT,
+				BLOB,
+				ARRAY,
+			};
+
+			/**
+			   \brief Payload size for fields with fixed size
+
+			   \returns 0 for variable sized fields
+			 */
+			static crimild::Size getFixedSize( FieldType type );
+
+			static void writeVarUInt( std::vector< crimild::Byte > &out, crimild::UInt64 value );
+			static void writeString( std::vector< crimild::Byte > &out, const std::string &value );
+
+			/**
+			   \brief Reads a variable-length integer
+
+			   \returns nullptr if there's not enough data
+			 */
+			static const crimild::Byte *readVarUInt( const crimild::Byte *it, const crimild::Byte *end, crimild::UInt64 &value );
+			static const crimild::Byte *readString( const crimild::Byte *it, const crimild::Byte *end, std::string &value );
+
+			/**
+			   \brief Skips a field's payload, including nested array elements
+
+			   \returns nullptr if data is invalid
+			 */
+			static const crimild::Byte *skipPayload( const crimild::Byte *it, const crimild::Byte *end, FieldType type );
+		};
+
+	}
+
+}
+
+#endif
+
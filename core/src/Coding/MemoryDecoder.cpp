@@ -29,10 +29,15 @@
 #include "EncodedData.hpp"
 #include "Tags.hpp"
 
+#include "Concurrency/Async.hpp"
+#include "Concurrency/JobScheduler.hpp"
 #include "Foundation/Log.hpp"
 #include "Foundation/ObjectFactory.hpp"
 
+#include <algorithm>
 #include <sstream>
+#include <unordered_map>
+#include <vector>
 
 using namespace crimild;
 using namespace crimild::containers;
@@ -43,17 +48,41 @@ MemoryDecoder::MemoryDecoder( void )
 
 }
 
+MemoryDecoder::MemoryDecoder( const MemoryDecoder *owner )
+	: _owner( owner )
+{
+	setVersion( owner->getVersion() );
+}
+
 MemoryDecoder::~MemoryDecoder( void )
 {
 
 }
 
+SharedPointer< Codable > MemoryDecoder::getLink( const std::string &key ) const
+{
+	// Lookups must not modify links, since they might be shared by other decoders
+	const auto &links = _owner != nullptr ? _owner->_links : _links;
+	const auto id = _currentObj->getUniqueID();
+	if ( !links.contains( id ) ) {
+		return nullptr;
+	}
+
+	const auto &objLinks = links[ id ];
+	return objLinks.contains( key ) ? objLinks[ key ] : nullptr;
+}
+
 crimild::Bool MemoryDecoder::decode( std::string key, SharedPointer< coding::Codable > &codable )
 {
-	codable = _links[ _currentObj->getUniqueID() ][ key ];
+	codable = getLink( key );
     if ( codable == nullptr ) {
         return false;
     }
+
+	if ( _owner != nullptr ) {
+		// decoding in parallel. The object has been decoded already
+		return true;
+	}
 	
 	auto temp = _currentObj;
 	_currentObj = codable;
@@ -74,7 +103,7 @@ crimild::Bool MemoryDecoder::decode( std::string key, std::string &value )
 	}
     
     if ( l > 0 ) {
-        auto obj = crimild::cast_ptr< EncodedData >( _links[ _currentObj->getUniqueID() ][ key ] );
+        auto obj = crimild::cast_ptr< EncodedData >( getLink( key ) );
 
         containers::ByteArray data( l + 1 );
         memcpy( &data[ 0 ], obj->getBytes().getData(), l );
@@ -216,6 +245,10 @@ crimild::Bool MemoryDecoder::fromBytes( const containers::ByteArray &bytes )
 		}
 	}
     
+	if ( _parallelDecodingEnabled && decodeInParallel() ) {
+		return true;
+	}
+
 	auto rootCount = getObjectCount();
     for ( crimild::Size i = 0; i < rootCount; i++ ) {
         auto obj = crimild::dynamic_cast_ptr< Codable >( getObjectAt< SharedObject >( i ) );
@@ -227,6 +260,121 @@ crimild::Bool MemoryDecoder::fromBytes( const containers::ByteArray &bytes )
 	return true;
 }
 
+crimild::Bool MemoryDecoder::decodeInParallel( void )
+{
+	if ( !concurrency::JobScheduler::hasInstance() || !concurrency::JobScheduler::getInstance()->isRunning() ) {
+		return false;
+	}
+
+	// Collect all objects reachable from roots. Encoded values are not 
+	// decoded by themselves, so they're not part of the graph
+	std::vector< SharedPointer< Codable >> nodes;
+	std::vector< std::vector< crimild::Size >> children;
+	std::unordered_map< Codable::UniqueID, crimild::Size > indices;
+
+	auto visit = [ &nodes, &children, &indices ]( SharedPointer< Codable > const &obj ) -> crimild::Size {
+		auto it = indices.find( obj->getUniqueID() );
+		if ( it != indices.end() ) {
+			return it->second;
+		}
+		auto index = nodes.size();
+		indices[ obj->getUniqueID() ] = index;
+		nodes.push_back( obj );
+		children.push_back( std::vector< crimild::Size >() );
+		return index;
+	};
+
+	auto rootCount = getObjectCount();
+	for ( crimild::Size i = 0; i < rootCount; i++ ) {
+		visit( crimild::dynamic_cast_ptr< Codable >( getObjectAt< SharedObject >( i ) ) );
+	}
+
+	const auto &links = _links;
+	for ( crimild::Size i = 0; i < nodes.size(); i++ ) {
+		auto id = nodes[ i ]->getUniqueID();
+		if ( !links.contains( id ) ) {
+			continue;
+		}
+
+		links[ id ].each( [ &nodes, &children, &visit, i ]( const std::string &, const SharedPointer< Codable > &obj ) {
+			if ( obj == nullptr || crimild::dynamic_cast_ptr< EncodedData >( obj ) != nullptr ) {
+				return;
+			}
+			auto child = visit( obj );
+			if ( std::find( children[ i ].begin(), children[ i ].end(), child ) == children[ i ].end() ) {
+				children[ i ].push_back( child );
+			}
+		});
+	}
+
+	// Compute heights, so each object is decoded in a later pass
+	// than every object it references
+	const crimild::Size UNVISITED = ~crimild::Size( 0 );
+	const crimild::Size IN_PROGRESS = UNVISITED - 1;
+	std::vector< crimild::Size > heights( nodes.size(), UNVISITED );
+	crimild::Size maxHeight = 0;
+
+	for ( crimild::Size i = 0; i < nodes.size(); i++ ) {
+		if ( heights[ i ] != UNVISITED ) {
+			continue;
+		}
+
+		// iterative DFS (scenes can be very deep)
+		std::vector< std::pair< crimild::Size, crimild::Size >> stack;
+		stack.push_back( std::make_pair( i, 0 ) );
+		heights[ i ] = IN_PROGRESS;
+		while ( !stack.empty() ) {
+			auto &top = stack.back();
+			auto node = top.first;
+			if ( top.second < children[ node ].size() ) {
+				auto child = children[ node ][ top.second++ ];
+				if ( heights[ child ] == IN_PROGRESS ) {
+					Log::warning( CRIMILD_CURRENT_CLASS_NAME, "Circular references found. Decoding serially" );
+					return false;
+				}
+				if ( heights[ child ] == UNVISITED ) {
+					heights[ child ] = IN_PROGRESS;
+					stack.push_back( std::make_pair( child, 0 ) );
+				}
+				continue;
+			}
+
+			crimild::Size height = 0;
+			for ( auto child : children[ node ] ) {
+				height = std::max( height, heights[ child ] + 1 );
+			}
+			heights[ node ] = height;
+			maxHeight = std::max( maxHeight, height );
+			stack.pop_back();
+		}
+	}
+
+	std::vector< std::vector< crimild::Size >> passes( maxHeight + 1 );
+	for ( crimild::Size i = 0; i < nodes.size(); i++ ) {
+		passes[ heights[ i ] ].push_back( i );
+	}
+
+	// A few chunks per worker help balancing the load
+	const crimild::Size maxChunks = 4 * ( concurrency::JobScheduler::getInstance()->getNumWorkers() + 1 );
+
+	for ( const auto &pass : passes ) {
+		const auto chunkCount = std::min( pass.size(), maxChunks );
+		concurrency::parallel_for( chunkCount, [ this, &pass, &nodes, chunkCount ]( crimild::Size chunk ) {
+			MemoryDecoder decoder( this );
+			const auto begin = chunk * pass.size() / chunkCount;
+			const auto end = ( chunk + 1 ) * pass.size() / chunkCount;
+			for ( auto i = begin; i < end; i++ ) {
+				auto &obj = nodes[ pass[ i ] ];
+				decoder._currentObj = obj;
+				obj->decode( decoder );
+			}
+			decoder._currentObj = nullptr;
+		});
+	}
+
+	return true;
+}
+
 crimild::Size MemoryDecoder::read( const containers::ByteArray &bytes, Codable::UniqueID &value, crimild::Size offset )
 {
     return readRawBytes( bytes, &value, sizeof( Codable::UniqueID ), offset );
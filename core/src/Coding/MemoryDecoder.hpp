@@ -74,12 +74,45 @@ namespace crimild {
             virtual crimild::Bool decode( std::string key, containers::Array< Quaternion4f > &value ) override { return decodeDataArray( key, value ); }
             
             crimild::Bool fromBytes( const containers::ByteArray &bytes );
+
+			/**
+			   \brief Decode objects concurrently using the JobScheduler
+
+			   Objects are arranged by their links, so every object is decoded
+			   after all of the objects it references. Objects that don't depend
+			   on each other (i.e. separated meshes or textures) are decoded in
+			   parallel. When decoding a parent, referenced objects are ready and
+			   they're just linked to it instead of being decoded again. 
+
+			   Decoding is serial if the scheduler is not running or if there are
+			   circular references.
+
+			   Disabled by default
+			 */
+			void setParallelDecodingEnabled( crimild::Bool enabled ) { _parallelDecodingEnabled = enabled; }
+			crimild::Bool isParallelDecodingEnabled( void ) const { return _parallelDecodingEnabled; }
+
+		private:
+			crimild::Bool _parallelDecodingEnabled = false;
+
+			/**
+			   \brief Decoder used by jobs when decoding in parallel
+
+			   Shares links with the owner, but keeps track of its own current object.
+			 */
+			explicit MemoryDecoder( const MemoryDecoder *owner );
+
+			crimild::Bool decodeInParallel( void );
+
+			const MemoryDecoder *_owner = nullptr;
             
         private:
+			SharedPointer< Codable > getLink( const std::string &key ) const;
+
             template< typename T >
             crimild::Bool decodeData( std::string key, T &value )
             {
-                auto obj = crimild::cast_ptr< EncodedData >( _links[ _currentObj->getUniqueID() ][ key ] );
+                auto obj = crimild::cast_ptr< EncodedData >( getLink( key ) );
                 if ( obj == nullptr ) {
                     value = T();
                     return false;
@@ -93,7 +126,7 @@ namespace crimild {
 			template< typename T >
 			crimild::Bool decodeDataArray( std::string key, containers::Array< T > &value )
 			{
-                auto obj = crimild::cast_ptr< EncodedData >( _links[ _currentObj->getUniqueID() ][ key ] );
+                auto obj = crimild::cast_ptr< EncodedData >( getLink( key ) );
 				if ( obj == nullptr ) {
 					return false;
 				}
@@ -75,3 +75,22 @@ void crimild::concurrency::wait( JobPtr const &job )
 	JobScheduler::getInstance()->wait( job );
 }
 
+void crimild::concurrency::parallel_for( crimild::Size count, std::function< void( crimild::Size ) > const &fn )
+{
+	// Jobs cannot be scheduled from threads that are not workers
+	if ( count <= 1 || !JobScheduler::hasInstance() || !JobScheduler::getInstance()->isRunning() || !JobScheduler::getInstance()->isWorkerThread() ) {
+		for ( crimild::Size i = 0; i < count; i++ ) {
+			fn( i );
+		}
+		return;
+	}
+
+	auto job = async();
+	for ( crimild::Size i = 0; i < count; i++ ) {
+		async( job, [ &fn, i ] {
+			fn( i );
+		});
+	}
+	wait( job );
+}
+
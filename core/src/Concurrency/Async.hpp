@@ -30,6 +30,8 @@
 
 #include "Job.hpp"
 
+#include "Foundation/Types.hpp"
+
 namespace crimild {
 
 	namespace concurrency {
@@ -87,6 +89,19 @@ namespace crimild {
          */
 		void wait( JobPtr const &job );
 
+        /**
+            \brief Executes fn( 0 ) ... fn( count - 1 ) and waits for all of them
+
+            Each call is dispatched as a separate job. If the scheduler is
+            not running or the current thread is not one of its workers, 
+            calls are executed in order in the current thread.
+
+            \remarks Running serially on other threads (like AssetManager I/O
+            threads) is intended. Those threads cannot push jobs to worker
+            queues, and the I/O threads already load several assets at once.
+         */
+		void parallel_for( crimild::Size count, std::function< void( crimild::Size ) > const &fn );
+
 	}
 
 }
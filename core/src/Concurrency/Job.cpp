@@ -30,10 +30,13 @@
 using namespace crimild;
 using namespace crimild::concurrency;
 
+static std::atomic< crimild::UInt64 > JOB_NEXT_ID( 1 );
+
 Job::Job( void )
 	: _callback( nullptr ),
       _parent( nullptr ),
-	  _childCount( 0 )
+	  _childCount( 0 ),
+	  _id( JOB_NEXT_ID++ )
 {
 
 }
@@ -30,6 +30,7 @@
 
 #include "Foundation/NamedObject.hpp"
 #include "Foundation/SharedObject.hpp"
+#include "Foundation/Types.hpp"
 
 #include <atomic>
 #include <functional>
@@ -110,6 +111,31 @@ namespace crimild {
 			std::vector< JobContinuationCallback > _continuations;
 
 			//@}
+
+			/**
+			   \name Tracing
+			*/
+			//@{
+
+		public:
+			/**
+			   \brief Unique identifier, used to link job records with their parents
+			*/
+			crimild::UInt64 getId( void ) const { return _id; }
+
+			/**
+			   \brief Time at which the job was scheduled, in nanoseconds
+
+			   Only set by the scheduler when tracing is enabled
+			*/
+			crimild::Int64 getScheduledTime( void ) const { return _scheduledTime; }
+			void setScheduledTime( crimild::Int64 time ) { _scheduledTime = time; }
+
+		private:
+			crimild::UInt64 _id;
+			crimild::Int64 _scheduledTime = 0;
+
+			//@}
 		};
 
 	}
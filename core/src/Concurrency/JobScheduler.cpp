@@ -28,12 +28,98 @@
 #include "JobScheduler.hpp"
 
 #include "Foundation/Log.hpp"
+#include "Foundation/Profiler.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <unordered_map>
 
 using namespace crimild;
 using namespace crimild::concurrency;
 
+static crimild::Int64 getTraceTimestamp( void )
+{
+	return std::chrono::duration_cast< std::chrono::nanoseconds >( std::chrono::steady_clock::now().time_since_epoch() ).count();
+}
+
+/**
+	\brief Job records and busy time for a single worker
+
+	Records are pushed by the worker thread and drained by the thread
+	invoking JobScheduler::step(), so the buffer requires no locks.
+*/
+class JobScheduler::WorkerTrace {
+public:
+	static const crimild::Size CAPACITY = 4096;
+
+	WorkerTrace( crimild::UInt32 index, std::string name )
+		: index( index ),
+		  name( name ),
+		  _records( CAPACITY ),
+		  _head( 0 ),
+		  _tail( 0 ),
+		  _dropped( 0 ),
+		  _busyTime( 0 )
+	{
+
+	}
+
+	void push( JobRecord &&record )
+	{
+		const auto head = _head.load( std::memory_order_relaxed );
+		if ( head - _tail.load( std::memory_order_acquire ) >= CAPACITY ) {
+			_dropped.fetch_add( 1, std::memory_order_relaxed );
+			return;
+		}
+
+		_records[ head % CAPACITY ] = std::move( record );
+		_head.store( head + 1, std::memory_order_release );
+	}
+
+	template< typename Fn >
+	void drain( Fn fn )
+	{
+		const auto head = _head.load( std::memory_order_acquire );
+		auto tail = _tail.load( std::memory_order_relaxed );
+		while ( tail != head ) {
+			fn( _records[ tail % CAPACITY ] );
+			tail++;
+		}
+		_tail.store( tail, std::memory_order_release );
+	}
+
+	inline void addBusyTime( crimild::Int64 time ) { _busyTime.fetch_add( time, std::memory_order_relaxed ); }
+	inline crimild::Int64 takeBusyTime( void ) { return _busyTime.exchange( 0 ); }
+
+	inline crimild::Size takeDroppedCount( void ) { return _dropped.exchange( 0 ); }
+
+public:
+	const crimild::UInt32 index;
+	const std::string name;
+
+	/**
+		\brief Number of jobs being executed. Only used by the owner thread
+
+		Jobs may execute other jobs while waiting, so only the outermost 
+		ones contribute to the busy time.
+	*/
+	crimild::UInt32 depth = 0;
+
+private:
+	std::vector< JobRecord > _records;
+	std::atomic< crimild::Size > _head;
+	std::atomic< crimild::Size > _tail;
+	std::atomic< crimild::Size > _dropped;
+	std::atomic< crimild::Int64 > _busyTime;
+};
+
+static std::atomic< crimild::UInt64 > nextTraceSession( 1 );
+
+thread_local JobScheduler::WorkerTraceCache JobScheduler::_workerTraceCache;
+
 JobScheduler::JobScheduler( void )
-	: _numWorkers( std::thread::hardware_concurrency() )
+	: _numWorkers( std::thread::hardware_concurrency() ),
+	  _tracingEnabled( false )
 {
 
 }
@@ -55,6 +141,9 @@ bool JobScheduler::start( void )
 {
 	_state = JobScheduler::State::INITIALIZING;
 
+	// must be set before any worker is initialized
+	_traceSession = nextTraceSession++;
+
 	// initialize the main thread as another worker
     initWorker( true );
 
@@ -81,6 +170,10 @@ void JobScheduler::stop( void )
 
 	_workers.clear();
     _workerJobQueues.clear();
+    _workerTraces.clear();
+
+	// invalidates any cached trace
+	_traceSession = 0;
 
 	_state = JobScheduler::State::STOPPED;
 }
@@ -103,11 +196,19 @@ void JobScheduler::initWorker( bool mainWorker )
 {
     std::lock_guard< std::mutex > lock( _mutex );
     
+    auto name = StringUtils::toString( "Worker ", _workerJobQueues.size() );
     if ( mainWorker ) {
         _mainWorkerId = getWorkerId();
+        name = "Main";
     }
 
+    Profiler::setThreadName( name );
+
     _workerStats[ getWorkerId() ].jobCount = 0;
+    auto trace = crimild::alloc< WorkerTrace >( _workerJobQueues.size(), name );
+    _workerTraces[ getWorkerId() ] = trace;
+    _workerTraceCache.session = _traceSession;
+    _workerTraceCache.trace = crimild::get_ptr( trace );
 	_workerJobQueues[ getWorkerId() ] = crimild::alloc< WorkerJobQueue >();
 }	
 
@@ -116,6 +217,12 @@ JobScheduler::WorkerId JobScheduler::getWorkerId( void ) const
 	return std::this_thread::get_id();
 }
 
+bool JobScheduler::isWorkerThread( void )
+{
+	std::lock_guard< std::mutex > lock( _mutex );
+	return _workerJobQueues.find( getWorkerId() ) != _workerJobQueues.end();
+}
+
 JobScheduler::WorkerJobQueue *JobScheduler::getWorkerJobQueue( void )
 {
 	return crimild::get_ptr( _workerJobQueues[ getWorkerId() ] );
@@ -148,12 +255,18 @@ void JobScheduler::schedule( JobPtr const &job )
         return;
     }
     
+	if ( isTracingEnabled() ) {
+		job->setScheduledTime( getTraceTimestamp() );
+	}
+
 	auto queue = getWorkerJobQueue();
 	queue->push( job );
 }
 
-JobPtr JobScheduler::getJob( void )
+JobPtr JobScheduler::getJob( crimild::Bool &stolen )
 {
+	stolen = false;
+
 	auto queue = getWorkerJobQueue();
 
 	if ( queue != nullptr && !queue->empty() ) {
@@ -170,6 +283,7 @@ JobPtr JobScheduler::getJob( void )
 	}
 
 	if ( !stealQueue->empty() ) {
+		stolen = true;
 		return stealQueue->steal();
 	}
 
@@ -178,9 +292,10 @@ JobPtr JobScheduler::getJob( void )
 
 bool JobScheduler::executeNextJob( void )
 {
-	auto job = getJob();
+	crimild::Bool stolen = false;
+	auto job = getJob( stolen );
 	if ( job != nullptr ) {
-		execute( job );
+		execute( job, stolen );
 		_workerStats[ getWorkerId() ].jobCount++;
 		return true;
 	}
@@ -189,9 +304,37 @@ bool JobScheduler::executeNextJob( void )
 	return false;
 }
 
-void JobScheduler::execute( JobPtr const &job )
+void JobScheduler::execute( JobPtr const &job, crimild::Bool stolen )
 {
+	CRIMILD_PROFILE( "Job" )
+
+	auto trace = isTracingEnabled() ? getWorkerTrace() : nullptr;
+	if ( trace == nullptr ) {
+		job->execute();
+		return;
+	}
+
+	JobRecord record;
+	record.name = job->getName();
+	record.jobId = job->getId();
+	record.parentId = job->getParent() != nullptr ? job->getParent()->getId() : 0;
+	record.workerIndex = trace->index;
+	record.stolen = stolen;
+
+	trace->depth++;
+	record.startTime = getTraceTimestamp();
 	job->execute();
+	record.endTime = getTraceTimestamp();
+	trace->depth--;
+
+	// jobs executed before tracing was enabled have no schedule time
+	record.scheduledTime = job->getScheduledTime() > 0 ? job->getScheduledTime() : record.startTime;
+
+	if ( trace->depth == 0 ) {
+		trace->addBusyTime( record.endTime - record.startTime );
+	}
+
+	trace->push( std::move( record ) );
 }
 
 void JobScheduler::wait( JobPtr const &job )
@@ -213,11 +356,19 @@ void JobScheduler::yield( void )
 
 void JobScheduler::delaySync( JobPtr const &job )
 {
+    if ( isTracingEnabled() ) {
+        job->setScheduledTime( getTraceTimestamp() );
+    }
+
     _delayedSyncJobs.push_back( job );
 }
 
 void JobScheduler::delayAsync( JobPtr const &job )
 {
+    if ( isTracingEnabled() ) {
+        job->setScheduledTime( getTraceTimestamp() );
+    }
+
     _delayedAsyncJobs.push_back( job );
 }
 
@@ -251,3 +402,116 @@ void JobScheduler::clearWorkerStats( void )
 	}
 }
 
+JobScheduler::WorkerTrace *JobScheduler::getWorkerTrace( void )
+{
+	// the session only changes while no worker is running
+	if ( _workerTraceCache.session == 0 || _workerTraceCache.session != _traceSession ) {
+		return nullptr;
+	}
+
+	return _workerTraceCache.trace;
+}
+
+void JobScheduler::setTracingEnabled( crimild::Bool enabled )
+{
+	std::lock_guard< std::mutex > lock( _mutex );
+
+	if ( enabled && !_tracingEnabled ) {
+		// discard records left from a previous session
+		for ( auto &it : _workerTraces ) {
+			it.second->drain( []( JobRecord & ) { } );
+			it.second->takeBusyTime();
+			it.second->takeDroppedCount();
+		}
+		_frameBegin = getTraceTimestamp();
+	}
+
+	_lastFrameTrace = FrameTrace();
+	_tracingEnabled = enabled;
+}
+
+/**
+	\brief Computes the longest chain of jobs linked by parent/child relationships
+
+	The critical path of a job is its own duration plus the longest critical
+	path among its children. Parents created with async() are never executed,
+	so their trees are measured from their children.
+*/
+static crimild::Real64 computeCriticalPath( std::vector< JobScheduler::JobRecord > const &jobs )
+{
+	std::unordered_map< crimild::UInt64, std::vector< crimild::Size >> children;
+	for ( crimild::Size i = 0; i < jobs.size(); i++ ) {
+		if ( jobs[ i ].parentId != 0 ) {
+			children[ jobs[ i ].parentId ].push_back( i );
+		}
+	}
+
+	std::vector< crimild::Int64 > paths( jobs.size(), -1 );
+	std::function< crimild::Int64( crimild::Size ) > computePath = [ & ]( crimild::Size idx ) {
+		if ( paths[ idx ] < 0 ) {
+			crimild::Int64 longest = 0;
+			auto it = children.find( jobs[ idx ].jobId );
+			if ( it != children.end() ) {
+				for ( auto child : it->second ) {
+					longest = std::max( longest, computePath( child ) );
+				}
+			}
+			paths[ idx ] = ( jobs[ idx ].endTime - jobs[ idx ].startTime ) + longest;
+		}
+		return paths[ idx ];
+	};
+
+	crimild::Int64 result = 0;
+	for ( crimild::Size i = 0; i < jobs.size(); i++ ) {
+		result = std::max( result, computePath( i ) );
+	}
+
+	return 1.0e-9 * result;
+}
+
+void JobScheduler::step( void )
+{
+	if ( !isTracingEnabled() ) {
+		return;
+	}
+
+	std::lock_guard< std::mutex > lock( _mutex );
+
+	const auto now = getTraceTimestamp();
+
+	FrameTrace frame;
+	frame.frameTime = 1.0e-9 * ( now - _frameBegin );
+	_frameBegin = now;
+
+	for ( auto &it : _workerTraces ) {
+		auto trace = crimild::get_ptr( it.second );
+
+		WorkerUtilization worker;
+		worker.workerIndex = trace->index;
+		worker.name = trace->name;
+		worker.busyTime = 1.0e-9 * trace->takeBusyTime();
+		worker.utilization = frame.frameTime > 0 ? std::min( 1.0, worker.busyTime / frame.frameTime ) : 0.0;
+
+		trace->drain( [ &frame, &worker ]( JobRecord &record ) {
+			worker.jobCount++;
+			if ( record.stolen ) {
+				worker.stolenCount++;
+			}
+			frame.jobs.push_back( std::move( record ) );
+		});
+
+		frame.totalWork += worker.busyTime;
+		frame.droppedCount += trace->takeDroppedCount();
+		frame.workers.push_back( worker );
+	}
+
+	std::sort( frame.workers.begin(), frame.workers.end(), []( WorkerUtilization const &a, WorkerUtilization const &b ) {
+		return a.workerIndex < b.workerIndex;
+	});
+
+	frame.jobCount = frame.jobs.size();
+	frame.criticalPath = computeCriticalPath( frame.jobs );
+
+	_lastFrameTrace = std::move( frame );
+}
+
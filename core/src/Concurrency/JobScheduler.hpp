@@ -34,6 +34,8 @@
 #include "Foundation/Singleton.hpp"
 #include "Foundation/ConcurrentList.hpp"
 
+#include <atomic>
+#include <string>
 #include <vector>
 #include <thread>
 #include <mutex>
@@ -104,6 +106,14 @@ namespace crimild {
             
             bool isMainWorker( void ) const { return getWorkerId() == _mainWorkerId; }
 
+			/**
+				\brief Checks if the calling thread is one of the workers, including the main one
+
+				\remarks Jobs can only be scheduled from worker threads. Other 
+				threads (i.e. asset loaders) must run their work serially
+			*/
+			bool isWorkerThread( void );
+
 		private:
             int _numWorkers;
 			std::vector< std::thread > _workers;
@@ -128,10 +138,10 @@ namespace crimild {
 			void yield( void );
 
 		private:
-			JobPtr getJob( void );
+			JobPtr getJob( crimild::Bool &stolen );
 			
 			bool executeNextJob( void );
-			void execute( JobPtr const &job );
+			void execute( JobPtr const &job, crimild::Bool stolen = false );
 
 		public:
 			struct WorkerStat {
@@ -157,6 +167,121 @@ namespace crimild {
         private:
             ConcurrentList< JobPtr > _delayedSyncJobs;
             ConcurrentList< JobPtr > _delayedAsyncJobs;
+
+			/**
+			   \name Tracing
+
+			   When tracing is enabled, each worker records every job it executes 
+			   into its own lock-free buffer. Records are collected at frame 
+			   boundaries by step(), which also computes worker utilization and 
+			   the critical path of job trees.
+			*/
+			//@{
+
+		public:
+			struct JobRecord {
+				std::string name;
+				crimild::UInt64 jobId;
+
+				/**
+				   \brief Id of the parent job, or zero if there is none
+				*/
+				crimild::UInt64 parentId;
+				crimild::UInt32 workerIndex;
+
+				/**
+				   \brief Timestamps in nanoseconds
+				*/
+				crimild::Int64 scheduledTime;
+				crimild::Int64 startTime;
+				crimild::Int64 endTime;
+
+				/**
+				   \brief Whether the job was stolen from another worker's queue
+				*/
+				crimild::Bool stolen;
+			};
+
+			struct WorkerUtilization {
+				crimild::UInt32 workerIndex = 0;
+				std::string name;
+				crimild::Size jobCount = 0;
+				crimild::Size stolenCount = 0;
+
+				/**
+				   \brief Time spent executing jobs, in seconds
+				*/
+				crimild::Real64 busyTime = 0;
+
+				/**
+				   \brief Busy time relative to the frame time, in [0, 1]
+				*/
+				crimild::Real64 utilization = 0;
+
+				inline crimild::Real64 getIdle( void ) const { return 1.0 - utilization; }
+			};
+
+			struct FrameTrace {
+				/**
+				   \brief Times in seconds
+				*/
+				crimild::Real64 frameTime = 0;
+				crimild::Real64 totalWork = 0;
+
+				/**
+				   \brief Longest chain of dependent jobs in a single job tree
+				*/
+				crimild::Real64 criticalPath = 0;
+
+				crimild::Size jobCount = 0;
+				crimild::Size droppedCount = 0;
+
+				std::vector< WorkerUtilization > workers;
+				std::vector< JobRecord > jobs;
+			};
+
+			void setTracingEnabled( crimild::Bool enabled );
+			inline crimild::Bool isTracingEnabled( void ) const { return _tracingEnabled; }
+
+			/**
+			   \brief Collects job records for the frame that just ended
+
+			   \remarks Invoke this method from the main thread, once per frame
+			*/
+			void step( void );
+
+			/**
+			   \brief Records and metrics collected by the last call to step()
+			*/
+			inline FrameTrace const &getLastFrameTrace( void ) const { return _lastFrameTrace; }
+
+		private:
+			class WorkerTrace;
+
+			/**
+				\brief Cached trace for the calling worker
+
+				Set when the worker is initialized so traced jobs don't need
+				to lock the scheduler. The session identifies the scheduler 
+				run that owns the trace, since schedulers might be stopped or 
+				destroyed while their threads are still alive.
+			*/
+			struct WorkerTraceCache {
+				crimild::UInt64 session = 0;
+				WorkerTrace *trace = nullptr;
+			};
+
+			WorkerTrace *getWorkerTrace( void );
+
+			static thread_local WorkerTraceCache _workerTraceCache;
+			crimild::UInt64 _traceSession = 0;
+
+			std::atomic< crimild::Bool > _tracingEnabled;
+			std::map< WorkerId, SharedPointer< WorkerTrace >> _workerTraces;
+			crimild::Int64 _frameBegin = 0;
+			FrameTrace _lastFrameTrace;
+
+			//@}
 		};
 
 	}
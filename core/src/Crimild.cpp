@@ -42,6 +42,9 @@ void crimild::init( void )
 	
 	CRIMILD_REGISTER_OBJECT_BUILDER( crimild::Image );
 	CRIMILD_REGISTER_OBJECT_BUILDER( crimild::ImageTGA );
+	CRIMILD_REGISTER_OBJECT_BUILDER( crimild::ImagePNG );
+	CRIMILD_REGISTER_OBJECT_BUILDER( crimild::ImageKTX );
+	CRIMILD_REGISTER_OBJECT_BUILDER( crimild::ImageDDS );
     CRIMILD_REGISTER_OBJECT_BUILDER( crimild::Material );
     CRIMILD_REGISTER_OBJECT_BUILDER( crimild::IndexBufferObject );
 	CRIMILD_REGISTER_OBJECT_BUILDER( crimild::SkinnedMeshJoint );
@@ -134,6 +137,7 @@ void crimild::init( void )
 	CRIMILD_REGISTER_OBJECT_BUILDER( crimild::ColorParticleUpdater );
 	CRIMILD_REGISTER_OBJECT_BUILDER( crimild::PointSpriteParticleRenderer );
 	CRIMILD_REGISTER_OBJECT_BUILDER( crimild::OrientedQuadParticleRenderer );
+	CRIMILD_REGISTER_OBJECT_BUILDER( crimild::InstancedQuadParticleRenderer );
 	CRIMILD_REGISTER_OBJECT_BUILDER( crimild::NodeParticleRenderer );
 	CRIMILD_REGISTER_OBJECT_BUILDER( crimild::AnimatedSpriteParticleRenderer );
 
@@ -72,6 +72,11 @@
 #include "Coding/MemoryDecoder.hpp"
 #include "Coding/FileEncoder.hpp"
 #include "Coding/FileDecoder.hpp"
+#include "Coding/BinaryFormat.hpp"
+#include "Coding/BinaryEncoder.hpp"
+#include "Coding/BinaryDecoder.hpp"
+#include "Coding/BinaryFileEncoder.hpp"
+#include "Coding/BinaryFileDecoder.hpp"
 #include "Coding/Tags.hpp"
 
 #include "Audio/AudioListener.hpp"
@@ -180,6 +185,7 @@
 
 #include "ParticleSystem/ParticleData.hpp"
 #include "ParticleSystem/ParticleSystemComponent.hpp"
+#include "ParticleSystem/ParticleBudgetManager.hpp"
 #include "ParticleSystem/Generators/BoxPositionParticleGenerator.hpp"
 #include "ParticleSystem/Generators/GridPositionParticleGenerator.hpp"
 #include "ParticleSystem/Generators/VelocityParticleGenerator.hpp"
@@ -204,6 +210,7 @@
 #include "ParticleSystem/Updaters/ColorParticleUpdater.hpp"
 #include "ParticleSystem/Renderers/PointSpriteParticleRenderer.hpp"
 #include "ParticleSystem/Renderers/OrientedQuadParticleRenderer.hpp"
+#include "ParticleSystem/Renderers/InstancedQuadParticleRenderer.hpp"
 #include "ParticleSystem/Renderers/NodeParticleRenderer.hpp"
 #include "ParticleSystem/Renderers/AnimatedSpriteParticleRenderer.hpp"
 
@@ -230,6 +237,12 @@
 #include "Rendering/RenderTarget.hpp"
 #include "Rendering/Image.hpp"
 #include "Rendering/ImageTGA.hpp"
+#include "Rendering/ImagePNG.hpp"
+#include "Rendering/ImageKTX.hpp"
+#include "Rendering/ImageDDS.hpp"
+#include "Rendering/ImageCompressor.hpp"
+#include "Rendering/ImageUtils.hpp"
+#include "Rendering/ImageLoader.hpp"
 #include "Rendering/IndexBufferObject.hpp"
 #include "Rendering/Material.hpp"
 #include "Rendering/RenderState.hpp"
@@ -271,6 +284,8 @@
 #include "Simulation/Input.hpp"
 #include "Simulation/Simulation.hpp"
 #include "Simulation/FileSystem.hpp"
+#include "Simulation/AssetManager.hpp"
+#include "Simulation/AssetRequest.hpp"
 
 #include "Simulation/Systems/DebugSystem.hpp"
 #include "Simulation/Systems/UpdateSystem.hpp"
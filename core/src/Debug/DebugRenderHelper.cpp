@@ -99,7 +99,7 @@ void DebugRenderHelper::renderLines( Renderer *renderer, Camera *camera, const V
 void DebugRenderHelper::renderLines( const Vector3f *data, unsigned int count, const RGBAColorf &color )
 {
 	auto vbo = crimild::alloc< VertexBufferObject >( VertexFormat::VF_P3, count );
-	auto ibo = crimild::alloc< IndexBufferObject >( count );
+	auto ibo = crimild::alloc< IndexBufferObject >( count, IndexBufferObject::getIndexTypeForVertexCount( count ) );
 	for ( int i = 0; i < count; i++ ) {
 		vbo->setPositionAt( i, data[ i ] );
 		ibo->setIndexAt( i, i );
@@ -0,0 +1,190 @@
+/*
+ * Copyright (c) 2013, Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef CRIMILD_FOUNDATION_CONTAINERS_MPSC_RING_BUFFER_
+#define CRIMILD_FOUNDATION_CONTAINERS_MPSC_RING_BUFFER_
+
+#include "Foundation/Types.hpp"
+
+#include <atomic>
+#include <vector>
+
+namespace crimild {
+
+	namespace containers {
+
+		/**
+		   \brief A bounded lock-free queue for multiple producers and a single consumer
+
+		   Any thread can push values, but only one thread at a time may pop 
+		   them. Each slot has a sequence number that tells whether it is 
+		   ready to be written or read. That way producers only contend on a
+		   single atomic counter and never wait for each other.
+
+		   Capacity is rounded up to a power of two and never changes.
+
+		   \remarks T must be default constructible and move assignable
+		 */
+		template< typename T >
+		class MPSCRingBuffer {
+		public:
+			explicit MPSCRingBuffer( crimild::Size capacity = 1024 )
+				: _slots( computeCapacity( capacity ) ),
+				  _mask( _slots.size() - 1 ),
+				  _head( 0 ),
+				  _tail( 0 )
+			{
+				for ( crimild::Size i = 0; i < _slots.size(); i++ ) {
+					_slots[ i ].sequence.store( i, std::memory_order_relaxed );
+				}
+			}
+
+			MPSCRingBuffer( const MPSCRingBuffer & ) = delete;
+			MPSCRingBuffer &operator=( const MPSCRingBuffer & ) = delete;
+
+			inline crimild::Size getCapacity( void ) const { return _slots.size(); }
+
+			/**
+			   \brief Approximate number of values in the buffer
+
+			   Includes values that are still being written by producers
+			 */
+			inline crimild::Size getSize( void ) const
+			{
+				return _head.load( std::memory_order_acquire ) - _tail.load( std::memory_order_acquire );
+			}
+
+			inline bool isEmpty( void ) const { return getSize() == 0; }
+
+			/**
+			   \brief Pushes a value at the end of the buffer
+
+			   \returns false if the buffer is full
+			 */
+			bool tryPush( T const &value )
+			{
+				auto pos = _head.load( std::memory_order_relaxed );
+				Slot *slot = nullptr;
+				while ( true ) {
+					slot = &_slots[ pos & _mask ];
+					const auto sequence = slot->sequence.load( std::memory_order_acquire );
+					const auto diff = ( crimild::Int64 ) sequence - ( crimild::Int64 ) pos;
+					if ( diff == 0 ) {
+						if ( _head.compare_exchange_weak( pos, pos + 1, std::memory_order_relaxed ) ) {
+							break;
+						}
+					}
+					else if ( diff < 0 ) {
+						// the slot still holds a value from the previous lap
+						return false;
+					}
+					else {
+						pos = _head.load( std::memory_order_relaxed );
+					}
+				}
+
+				slot->value = value;
+				slot->sequence.store( pos + 1, std::memory_order_release );
+				return true;
+			}
+
+			/**
+			   \brief Pops the first value in the buffer
+
+			   \returns false if the buffer is empty or the first value
+			   is not completely written yet
+
+			   \remarks Must be called from the consumer thread only
+			 */
+			bool tryPop( T &result )
+			{
+				const auto pos = _tail.load( std::memory_order_relaxed );
+				auto &slot = _slots[ pos & _mask ];
+				const auto sequence = slot.sequence.load( std::memory_order_acquire );
+				if ( ( crimild::Int64 ) sequence - ( crimild::Int64 ) ( pos + 1 ) < 0 ) {
+					return false;
+				}
+
+				result = std::move( slot.value );
+				slot.value = T();
+				slot.sequence.store( pos + _mask + 1, std::memory_order_release );
+				_tail.store( pos + 1, std::memory_order_release );
+				return true;
+			}
+
+			/**
+			   \brief Pops up to maxCount values, invoking fn for each of them
+
+			   \returns The number of values popped
+
+			   \remarks Must be called from the consumer thread only
+			 */
+			template< typename Fn >
+			crimild::Size drain( Fn fn, crimild::Size maxCount )
+			{
+				crimild::Size count = 0;
+				T value;
+				while ( count < maxCount && tryPop( value ) ) {
+					fn( value );
+					count++;
+				}
+				return count;
+			}
+
+		private:
+			static crimild::Size computeCapacity( crimild::Size capacity )
+			{
+				crimild::Size result = 2;
+				while ( result < capacity ) {
+					result <<= 1;
+				}
+				return result;
+			}
+
+			struct Slot {
+				std::atomic< crimild::Size > sequence;
+				T value;
+
+				Slot( void ) : sequence( 0 ) { }
+			};
+
+			std::vector< Slot > _slots;
+			const crimild::Size _mask;
+
+			// Keep producer and consumer counters in different cache lines
+			std::atomic< crimild::Size > _head;
+			char _padding[ 64 ];
+			std::atomic< crimild::Size > _tail;
+		};
+
+	}
+
+}
+
+#endif
+
@@ -26,9 +26,293 @@
  */
 
 #include "Log.hpp"
+#include "Types.hpp"
+
+#include <atomic>
+#include <vector>
 
 using namespace crimild;
 
 std::unique_ptr< Log::OutputHandler > Log::_outputHandler = std::unique_ptr< Log::ConsoleOutputHandler >( new Log::ConsoleOutputHandler() );
+
+// matches the default for CRIMILD_LOG_LEVEL, so release builds don't
+// format debug messages at runtime either
+#ifdef NDEBUG
+int Log::_level = Log::Level::LOG_LEVEL_INFO;
+#else
 int Log::_level = Log::Level::LOG_LEVEL_DEBUG;
+#endif
+
+/**
+	\brief A message waiting to be written
+*/
+struct LogRecord {
+	crimild::Int64 timestamp;
+	std::thread::id threadId;
+	const char *level;
+	std::string message;
+};
+
+static std::string formatLogRecord( LogRecord const &record )
+{
+	return StringUtils::toString( record.timestamp, " ", record.threadId, " ", record.level, "/", record.message );
+}
+
+/**
+	\brief Single-producer/single-consumer ring buffer
+
+	Each thread pushes records into its own buffer, which are then
+	consumed by the writer thread, so no locks are needed. Counters
+	only grow and are kept in different cache lines to avoid false 
+	sharing between producer and consumer.
+*/
+class LogRingBuffer {
+public:
+	static const crimild::Size CAPACITY = 1024;
+
+	LogRingBuffer( void )
+		: _records( CAPACITY )
+	{
+		_head = 0;
+		_tail = 0;
+	}
+
+	/**
+		\returns false if the buffer is full. The record is not modified in that case
+	*/
+	bool push( LogRecord &record )
+	{
+		auto head = _head.load( std::memory_order_relaxed );
+		if ( head - _tail.load( std::memory_order_acquire ) >= CAPACITY ) {
+			return false;
+		}
+
+		_records[ head & ( CAPACITY - 1 ) ] = std::move( record );
+		_head.store( head + 1, std::memory_order_release );
+		return true;
+	}
+
+	/**
+		\brief Writes all pending records
+
+		The tail is updated after writing, so an empty buffer means all 
+		of its records are already written.
+	*/
+	crimild::Size drain( Log::OutputHandler *handler )
+	{
+		auto tail = _tail.load( std::memory_order_relaxed );
+		auto head = _head.load( std::memory_order_acquire );
+		for ( auto i = tail; i < head; i++ ) {
+			auto &record = _records[ i & ( CAPACITY - 1 ) ];
+			if ( handler != nullptr ) {
+				handler->printLine( formatLogRecord( record ) );
+			}
+			record.message.clear();
+		}
+		_tail.store( head, std::memory_order_release );
+		return head - tail;
+	}
+
+	bool isEmpty( void ) const
+	{
+		return _head.load( std::memory_order_acquire ) == _tail.load( std::memory_order_acquire );
+	}
+
+private:
+	std::vector< LogRecord > _records;
+	char _padding0[ 64 ];
+	std::atomic< crimild::Size > _head;
+	char _padding1[ 64 ];
+	std::atomic< crimild::Size > _tail;
+};
+
+/**
+	\brief Owns the ring buffers and the background thread that writes them
+*/
+class LogWriter {
+public:
+	/**
+		The instance is never destroyed, since messages can be logged 
+		from static destructors. LogWriterShutdown stops the thread
+	*/
+	static LogWriter &getInstance( void )
+	{
+		static LogWriter *instance = new LogWriter();
+		return *instance;
+	}
+
+	bool isRunning( void ) const { return _running; }
+
+	void start( Log::OutputHandler *handler )
+	{
+		std::lock_guard< std::mutex > lock( _stateMutex );
+		if ( _running ) {
+			return;
+		}
+
+		_handler = handler;
+		_running = true;
+		_thread = std::thread( [ this ] { run(); } );
+	}
+
+	void stop( void )
+	{
+		std::lock_guard< std::mutex > lock( _stateMutex );
+		if ( !_running ) {
+			return;
+		}
+
+		_running = false;
+		_thread.join();
+
+		// write anything that was pushed while stopping
+		drainAll();
+	}
+
+	void push( LogRecord &record )
+	{
+		auto buffer = getThreadBuffer();
+		while ( !buffer->push( record ) ) {
+			if ( !_running ) {
+				// nobody will empty the buffer
+				drainAll();
+			}
+			else {
+				std::this_thread::yield();
+			}
+		}
+
+		if ( !_running ) {
+			drainAll();
+		}
+	}
+
+	void flush( void )
+	{
+		while ( !isEmpty() ) {
+			if ( !_running ) {
+				drainAll();
+			}
+			else {
+				std::this_thread::yield();
+			}
+		}
+	}
+
+private:
+	LogRingBuffer *getThreadBuffer( void )
+	{
+		// The writer keeps a reference to the buffer, which is released only
+		// after all of its records are written, even if the thread is gone
+		static thread_local std::shared_ptr< LogRingBuffer > buffer;
+		if ( buffer == nullptr ) {
+			buffer = std::make_shared< LogRingBuffer >();
+			std::lock_guard< std::mutex > lock( _buffersMutex );
+			_buffers.push_back( buffer );
+		}
+		return buffer.get();
+	}
+
+	void run( void )
+	{
+		while ( _running ) {
+			if ( drainAll() == 0 ) {
+				std::this_thread::sleep_for( std::chrono::milliseconds( 1 ) );
+			}
+		}
+	}
+
+	crimild::Size drainAll( void )
+	{
+		std::lock_guard< std::mutex > lock( _buffersMutex );
+
+		crimild::Size count = 0;
+		auto it = _buffers.begin();
+		while ( it != _buffers.end() ) {
+			count += ( *it )->drain( _handler );
+			if ( it->use_count() == 1 && ( *it )->isEmpty() ) {
+				// owner thread has finished
+				it = _buffers.erase( it );
+			}
+			else {
+				++it;
+			}
+		}
+		return count;
+	}
+
+	bool isEmpty( void )
+	{
+		std::lock_guard< std::mutex > lock( _buffersMutex );
+		for ( const auto &buffer : _buffers ) {
+			if ( !buffer->isEmpty() ) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+private:
+	std::mutex _stateMutex;
+	std::atomic< bool > _running { false };
+	std::thread _thread;
+	Log::OutputHandler *_handler = nullptr;
+
+	std::mutex _buffersMutex;
+	std::vector< std::shared_ptr< LogRingBuffer >> _buffers;
+};
+
+/**
+	\brief Writes pending messages at exit, before the output handler is destroyed
+*/
+static struct LogWriterShutdown {
+	~LogWriterShutdown( void )
+	{
+		LogWriter::getInstance().stop();
+	}
+} logWriterShutdown;
+
+void Log::write( int level, const char *levelStr, std::string &&message )
+{
+	auto tp = std::chrono::system_clock::now();
+	auto s = std::chrono::duration_cast< std::chrono::microseconds >( tp.time_since_epoch() );
+
+	LogRecord record;
+	record.timestamp = ( crimild::Int64 ) s.count();
+	record.threadId = std::this_thread::get_id();
+	record.level = levelStr;
+	record.message = std::move( message );
+
+	auto &writer = LogWriter::getInstance();
+	if ( !writer.isRunning() ) {
+		_outputHandler->printLine( formatLogRecord( record ) );
+		return;
+	}
+
+	writer.push( record );
+
+	if ( level <= LOG_LEVEL_ERROR ) {
+		writer.flush();
+	}
+}
+
+void Log::setAsyncEnabled( bool enabled )
+{
+	if ( enabled ) {
+		LogWriter::getInstance().start( _outputHandler.get() );
+	}
+	else {
+		LogWriter::getInstance().stop();
+	}
+}
+
+bool Log::isAsyncEnabled( void )
+{
+	return LogWriter::getInstance().isRunning();
+}
+
+void Log::flush( void )
+{
+	LogWriter::getInstance().flush();
+}
 
@@ -36,6 +36,36 @@
 #include <iostream>
 #include <sstream>
 #include <fstream>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+/**
+	Log levels are also defined as macros so they can be used by the preprocessor
+*/
+#define CRIMILD_LOG_LEVEL_NONE -1
+#define CRIMILD_LOG_LEVEL_FATAL 100
+#define CRIMILD_LOG_LEVEL_ERROR 200
+#define CRIMILD_LOG_LEVEL_WARNING 300
+#define CRIMILD_LOG_LEVEL_INFO 400
+#define CRIMILD_LOG_LEVEL_DEBUG 500
+#define CRIMILD_LOG_LEVEL_TRACE 600
+#define CRIMILD_LOG_LEVEL_ALL 9999
+
+/**
+	\brief Maximum log level compiled in when using the CRIMILD_LOG_* macros
+
+	Calls with higher levels are removed at compile time, including the 
+	evaluation of their arguments. Defaults to INFO for release builds.
+*/
+#ifndef CRIMILD_LOG_LEVEL
+	#ifdef NDEBUG
+		#define CRIMILD_LOG_LEVEL CRIMILD_LOG_LEVEL_INFO
+	#else
+		#define CRIMILD_LOG_LEVEL CRIMILD_LOG_LEVEL_ALL
+	#endif
+#endif
 
 namespace crimild {
     
@@ -46,18 +76,25 @@ namespace crimild {
         
     public:
         enum Level {
-            LOG_LEVEL_NONE = -1,
-            LOG_LEVEL_FATAL = 100,
-            LOG_LEVEL_ERROR = 200,
-            LOG_LEVEL_WARNING = 300,
-            LOG_LEVEL_INFO = 400,
-            LOG_LEVEL_DEBUG = 500,
-            LOG_LEVEL_TRACE = 600,
-            LOG_LEVEL_ALL = 9999
+            LOG_LEVEL_NONE = CRIMILD_LOG_LEVEL_NONE,
+            LOG_LEVEL_FATAL = CRIMILD_LOG_LEVEL_FATAL,
+            LOG_LEVEL_ERROR = CRIMILD_LOG_LEVEL_ERROR,
+            LOG_LEVEL_WARNING = CRIMILD_LOG_LEVEL_WARNING,
+            LOG_LEVEL_INFO = CRIMILD_LOG_LEVEL_INFO,
+            LOG_LEVEL_DEBUG = CRIMILD_LOG_LEVEL_DEBUG,
+            LOG_LEVEL_TRACE = CRIMILD_LOG_LEVEL_TRACE,
+            LOG_LEVEL_ALL = CRIMILD_LOG_LEVEL_ALL
         };
         
+        /**
+            \brief Maximum level written at runtime
+
+            Defaults to INFO for release builds and DEBUG otherwise
+        */
         static void setLevel( int level ) { _level = level; };
         static int getLevel( void ) { return _level; }
+
+        static bool isEnabled( int level ) { return _level >= level; }
         
     private:
         static int _level;
@@ -100,21 +137,48 @@ namespace crimild {
         }
         
         template< typename ... Args >
-        static void print( int level, std::string const &levelStr, std::string const &TAG, Args &&... args )
+        static void print( int level, const char *levelStr, std::string const &TAG, Args &&... args )
         {
             if ( getLevel() >= level && _outputHandler != nullptr ) {
-                auto tp = std::chrono::system_clock::now();
-                auto s = std::chrono::duration_cast< std::chrono::microseconds >( tp.time_since_epoch() );
-                auto t = ( time_t )( s.count() );
-                
-                auto str = StringUtils::toString( t, " ",
-                    std::this_thread::get_id(), " ",
-                    levelStr, "/", TAG, " - ",
-                    std::forward< Args >( args )... );
-                
-                _outputHandler->printLine( str );
+                write( level, levelStr, StringUtils::toString( TAG, " - ", std::forward< Args >( args )... ) );
             }
         }
+
+    private:
+        /**
+            \brief Outputs a message, adding a prefix with the time, thread and level
+
+            In async mode, the message is only queued and the prefix is
+            formatted by the writer thread
+        */
+        static void write( int level, const char *levelStr, std::string &&message );
+
+    public:
+        /**
+            \name Asynchronous output
+
+            When enabled, messages are pushed into a lock-free ring buffer 
+            owned by the calling thread and a background thread writes them 
+            to the output handler, so logging never blocks on I/O. A thread 
+            only waits if its own buffer is full.
+
+            Lines are ordered per thread, but lines from different threads
+            might be written out of order (use timestamps to sort them).
+            Errors and fatal messages flush all pending lines before 
+            returning, so they are visible even if the program crashes 
+            right after.
+        */
+        //@{
+
+        static void setAsyncEnabled( bool enabled );
+        static bool isAsyncEnabled( void );
+
+        /**
+            \brief Waits until all queued messages have been written
+        */
+        static void flush( void );
+
+        //@}
         
     public:
         class OutputHandler {
@@ -179,7 +243,11 @@ namespace crimild {
         template< class T, typename ... Args >
         static void setOutputHandler( Args &&... args )
         {
+            // the writer thread must not use the old handler
+            auto async = isAsyncEnabled();
+            setAsyncEnabled( false );
             _outputHandler = std::move( std::unique_ptr< T >( new T( std::forward< Args >( args )... ) ) );
+            setAsyncEnabled( async );
         }
         
     private:
@@ -189,12 +257,21 @@ namespace crimild {
 
 }
 
-#define CRIMILD_LOG_FATAL( ... ) ( crimild::Log::fatal( CRIMILD_CURRENT_CLASS_NAME, __VA_ARGS__ ) )
-#define CRIMILD_LOG_ERROR( ... ) ( crimild::Log::error( CRIMILD_CURRENT_CLASS_NAME, __VA_ARGS__ ) )
-#define CRIMILD_LOG_WARNING( ... ) ( crimild::Log::warning( CRIMILD_CURRENT_CLASS_NAME, __VA_ARGS__ ) )
-#define CRIMILD_LOG_INFO( ... ) ( crimild::Log::info( CRIMILD_CURRENT_CLASS_NAME, __VA_ARGS__ ) )
-#define CRIMILD_LOG_DEBUG( ... ) ( crimild::Log::debug( CRIMILD_CURRENT_CLASS_NAME, __VA_ARGS__ ) )
-#define CRIMILD_LOG_TRACE( ... ) ( crimild::Log::trace( CRIMILD_CURRENT_CLASS_NAME, __VA_ARGS__ ) )
+/**
+	\brief Logs only if the level is enabled
+
+	The level is checked both against CRIMILD_LOG_LEVEL, which is a constant 
+	expression and lets the compiler remove the call entirely, and against 
+	the current runtime level. Arguments are not evaluated in either case.
+*/
+#define CRIMILD_LOG_IF( LEVEL, CALL ) ( ( ( LEVEL ) <= CRIMILD_LOG_LEVEL && crimild::Log::isEnabled( LEVEL ) ) ? ( CALL ) : ( void ) 0 )
+
+#define CRIMILD_LOG_FATAL( ... ) CRIMILD_LOG_IF( CRIMILD_LOG_LEVEL_FATAL, crimild::Log::fatal( CRIMILD_CURRENT_CLASS_NAME, __VA_ARGS__ ) )
+#define CRIMILD_LOG_ERROR( ... ) CRIMILD_LOG_IF( CRIMILD_LOG_LEVEL_ERROR, crimild::Log::error( CRIMILD_CURRENT_CLASS_NAME, __VA_ARGS__ ) )
+#define CRIMILD_LOG_WARNING( ... ) CRIMILD_LOG_IF( CRIMILD_LOG_LEVEL_WARNING, crimild::Log::warning( CRIMILD_CURRENT_CLASS_NAME, __VA_ARGS__ ) )
+#define CRIMILD_LOG_INFO( ... ) CRIMILD_LOG_IF( CRIMILD_LOG_LEVEL_INFO, crimild::Log::info( CRIMILD_CURRENT_CLASS_NAME, __VA_ARGS__ ) )
+#define CRIMILD_LOG_DEBUG( ... ) CRIMILD_LOG_IF( CRIMILD_LOG_LEVEL_DEBUG, crimild::Log::debug( CRIMILD_CURRENT_CLASS_NAME, __VA_ARGS__ ) )
+#define CRIMILD_LOG_TRACE( ... ) CRIMILD_LOG_IF( CRIMILD_LOG_LEVEL_TRACE, crimild::Log::trace( CRIMILD_CURRENT_CLASS_NAME, __VA_ARGS__ ) )
 
 #endif
 
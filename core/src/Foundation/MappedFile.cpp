@@ -0,0 +1,107 @@
+/*
+ * Copyright (c) 2013, Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "MappedFile.hpp"
+#include "Macros.hpp"
+#include "Log.hpp"
+
+#include <fstream>
+
+#if !defined( CRIMILD_PLATFORM_WIN32 )
+	#define CRIMILD_MAPPED_FILE_USE_MMAP 1
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif
+
+using namespace crimild;
+
+MappedFile::MappedFile( std::string fileName )
+{
+#ifdef CRIMILD_MAPPED_FILE_USE_MMAP
+	int fd = open( fileName.c_str(), O_RDONLY );
+	if ( fd < 0 ) {
+		Log::error( CRIMILD_CURRENT_CLASS_NAME, "Cannot open file ", fileName );
+		return;
+	}
+
+	struct stat st;
+	if ( fstat( fd, &st ) != 0 ) {
+		Log::error( CRIMILD_CURRENT_CLASS_NAME, "Cannot read file size for ", fileName );
+		close( fd );
+		return;
+	}
+
+	_size = st.st_size;
+	_opened = true;
+
+	if ( _size > 0 ) {
+		void *data = mmap( nullptr, _size, PROT_READ, MAP_PRIVATE, fd, 0 );
+		if ( data != MAP_FAILED ) {
+			// files are usually traversed from beginning to end
+			madvise( data, _size, MADV_SEQUENTIAL );
+			_data = static_cast< const crimild::Byte * >( data );
+			_mapped = true;
+		}
+	}
+
+	close( fd );
+
+	if ( _mapped || _size == 0 ) {
+		return;
+	}
+
+	// mapping failed. Fallback to reading the whole file
+	_opened = false;
+#endif
+
+	std::ifstream input( fileName.c_str(), std::ios::in | std::ios::binary | std::ios::ate );
+	if ( !input.is_open() ) {
+		Log::error( CRIMILD_CURRENT_CLASS_NAME, "Cannot open file ", fileName );
+		return;
+	}
+
+	_size = input.tellg();
+	input.seekg( 0, std::ios::beg );
+	_buffer.resize( _size );
+	if ( _size > 0 ) {
+		input.read( reinterpret_cast< char * >( &_buffer[ 0 ] ), _size );
+		_data = &_buffer[ 0 ];
+	}
+	_opened = true;
+}
+
+MappedFile::~MappedFile( void )
+{
+#ifdef CRIMILD_MAPPED_FILE_USE_MMAP
+	if ( _mapped ) {
+		munmap( const_cast< crimild::Byte * >( _data ), _size );
+	}
+#endif
+}
+
@@ -0,0 +1,70 @@
+/*
+ * Copyright (c) 2013, Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef CRIMILD_FOUNDATION_MAPPED_FILE_
+#define CRIMILD_FOUNDATION_MAPPED_FILE_
+
+#include "NonCopyable.hpp"
+#include "Types.hpp"
+
+#include <string>
+#include <vector>
+
+namespace crimild {
+
+	/**
+		\brief Read-only view of a whole file in memory
+
+		The file is mapped into the address space when the platform
+		supports it, so pages are only loaded once they're accessed.
+		Otherwise, contents are read into memory at once.
+
+		\remarks Data is not null-terminated
+	*/
+	class MappedFile : public NonCopyable {
+	public:
+		explicit MappedFile( std::string fileName );
+		virtual ~MappedFile( void );
+
+		inline bool isOpen( void ) const { return _opened; }
+
+		inline const crimild::Byte *getData( void ) const { return _data; }
+		inline crimild::Size getSize( void ) const { return _size; }
+
+	private:
+		const crimild::Byte *_data = nullptr;
+		crimild::Size _size = 0;
+		bool _opened = false;
+		bool _mapped = false;
+
+		std::vector< crimild::Byte > _buffer;
+	};
+
+}
+
+#endif
+
@@ -39,9 +39,14 @@
 
 #include "Concurrency/JobScheduler.hpp"
 
+#include <atomic>
 #include <chrono>
+#include <fstream>
 #include <iostream>
 #include <iomanip>
+#include <list>
+#include <mutex>
+#include <unordered_map>
 
 using namespace crimild;
 using namespace crimild::concurrency;
@@ -159,15 +164,228 @@ void ProfilerScreenOutputHandler::endOutput( void )
     DebugRenderHelper::renderText( getOutput(), Vector3f( -0.9f, 0.9f, 0.0f ), RGBAColorf( 1.0f, 1.0f, 0.0f, 1.0f ) );
 }
 
-ProfilerSample::ProfilerSample( std::string name )
+/**
+	\brief A completed sample, as recorded by the owner thread
+*/
+struct ProfilerThreadSample {
+	crimild::UInt32 zoneId;
+	crimild::UInt32 depth;
+	crimild::Int64 begin;
+	crimild::Int64 end;
+};
+
+/**
+	\brief Single-producer/single-consumer ring buffer for samples
+
+	Only the owner thread pushes samples, and only the thread calling
+	Profiler::step() drains them, so no locks are needed.
+*/
+class ProfilerThreadBuffer {
+public:
+	static const crimild::Size CAPACITY = 16384;
+
+	ProfilerThreadBuffer( crimild::UInt32 index )
+		: index( index ),
+		  name( StringUtils::toString( "Thread ", index ) ),
+		  _samples( CAPACITY ),
+		  _head( 0 ),
+		  _tail( 0 ),
+		  _dropped( 0 )
+	{
+
+	}
+
+	inline void push( ProfilerThreadSample const &sample )
+	{
+		const auto head = _head.load( std::memory_order_relaxed );
+		if ( head - _tail.load( std::memory_order_acquire ) >= CAPACITY ) {
+			_dropped.fetch_add( 1, std::memory_order_relaxed );
+			return;
+		}
+
+		_samples[ head % CAPACITY ] = sample;
+		_head.store( head + 1, std::memory_order_release );
+	}
+
+	template< typename Fn >
+	void drain( Fn fn )
+	{
+		const auto head = _head.load( std::memory_order_acquire );
+		auto tail = _tail.load( std::memory_order_relaxed );
+		while ( tail != head ) {
+			fn( _samples[ tail % CAPACITY ] );
+			tail++;
+		}
+		_tail.store( tail, std::memory_order_release );
+	}
+
+	inline crimild::Size getDroppedCount( void ) const { return _dropped.load( std::memory_order_relaxed ); }
+
+public:
+	const crimild::UInt32 index;
+
+	/**
+		\brief Guarded by the registry's mutex, since it's read when exporting traces
+	*/
+	std::string name;
+
+	/**
+		\brief Nesting level of open samples. Only used by the owner thread
+	*/
+	crimild::UInt32 depth = 0;
+
+private:
+	std::vector< ProfilerThreadSample > _samples;
+	std::atomic< crimild::Size > _head;
+	std::atomic< crimild::Size > _tail;
+	std::atomic< crimild::Size > _dropped;
+};
+
+/**
+	\brief Keeps zones and thread buffers alive for the whole program
+
+	Samples can be recorded before a Profiler instance is created (or 
+	after it's destroyed), so this state cannot belong to the singleton.
+*/
+class ProfilerRegistry {
+public:
+	static ProfilerRegistry *getInstance( void )
+	{
+		// Never destroyed, since threads may record samples during shutdown
+		static ProfilerRegistry *instance = new ProfilerRegistry();
+		return instance;
+	}
+
+	ProfilerZone const *registerZone( std::string const &name )
+	{
+		std::lock_guard< std::mutex > lock( _mutex );
+
+		auto it = _zonesByName.find( name );
+		if ( it != _zonesByName.end() ) {
+			return it->second;
+		}
+
+		auto zone = new ProfilerZone { name, ( crimild::UInt32 ) _zones.size() };
+		_zones.push_back( std::unique_ptr< ProfilerZone >( zone ) );
+		_zonesByName[ name ] = zone;
+		return zone;
+	}
+
+	ProfilerZone const *getZone( crimild::UInt32 id )
+	{
+		std::lock_guard< std::mutex > lock( _mutex );
+		return id < _zones.size() ? _zones[ id ].get() : nullptr;
+	}
+
+	crimild::Size getZoneCount( void )
+	{
+		std::lock_guard< std::mutex > lock( _mutex );
+		return _zones.size();
+	}
+
+	ProfilerThreadBuffer *getThreadBuffer( void )
+	{
+		static thread_local std::shared_ptr< ProfilerThreadBuffer > buffer;
+		if ( buffer == nullptr ) {
+			std::lock_guard< std::mutex > lock( _mutex );
+			buffer = std::make_shared< ProfilerThreadBuffer >( _nextThreadIndex++ );
+			_buffers.push_back( buffer );
+		}
+		return buffer.get();
+	}
+
+	void setThreadName( std::string const &name )
+	{
+		auto buffer = getThreadBuffer();
+
+		std::lock_guard< std::mutex > lock( _mutex );
+		buffer->name = name;
+	}
+
+	/**
+		\brief Drains all thread buffers, releasing the ones whose thread has finished
+	*/
+	template< typename Fn >
+	void drain( Fn fn )
+	{
+		std::lock_guard< std::mutex > lock( _mutex );
+
+		auto it = _buffers.begin();
+		while ( it != _buffers.end() ) {
+			auto buffer = *it;
+			buffer->drain( [ &fn, &buffer ]( ProfilerThreadSample const &sample ) {
+				fn( buffer.get(), sample );
+			});
+			if ( it->use_count() == 2 ) {
+				// only this copy and the registry remain, so the thread has finished
+				_droppedByFinishedThreads += buffer->getDroppedCount();
+				it = _buffers.erase( it );
+			}
+			else {
+				it++;
+			}
+		}
+	}
+
+	template< typename Fn >
+	void eachThreadBuffer( Fn fn )
+	{
+		std::lock_guard< std::mutex > lock( _mutex );
+		for ( auto &buffer : _buffers ) {
+			fn( buffer.get() );
+		}
+	}
+
+	crimild::Size getDroppedCount( void )
+	{
+		std::lock_guard< std::mutex > lock( _mutex );
+		auto count = _droppedByFinishedThreads;
+		for ( auto &buffer : _buffers ) {
+			count += buffer->getDroppedCount();
+		}
+		return count;
+	}
+
+private:
+	std::mutex _mutex;
+	std::vector< std::unique_ptr< ProfilerZone >> _zones;
+	std::unordered_map< std::string, ProfilerZone * > _zonesByName;
+	std::list< std::shared_ptr< ProfilerThreadBuffer >> _buffers;
+	crimild::UInt32 _nextThreadIndex = 0;
+	crimild::Size _droppedByFinishedThreads = 0;
+};
+
+static std::string escapeTraceString( std::string const &str )
 {
-    assert( Profiler::getInstance() != nullptr && "Profiler not initialized" );
-    _sampleIndex = Profiler::getInstance()->onSampleCreated( name );
+	std::string result;
+	for ( auto c : str ) {
+		if ( c == '"' || c == '\\' ) {
+			result += '\\';
+		}
+		result += c;
+	}
+	return result;
+}
+
+static crimild::Int64 getProfilerTimestamp( void )
+{
+	return std::chrono::duration_cast< std::chrono::nanoseconds >( std::chrono::steady_clock::now().time_since_epoch() ).count();
+}
+
+ProfilerSample::ProfilerSample( ProfilerZone const *zone )
+	: _zone( zone )
+{
+	auto buffer = ProfilerRegistry::getInstance()->getThreadBuffer();
+	_depth = buffer->depth++;
+	_begin = getProfilerTimestamp();
 }
 
 ProfilerSample::~ProfilerSample( void )
 {
-    Profiler::getInstance()->onSampleDestroyed( _sampleIndex );
+	const auto end = getProfilerTimestamp();
+	auto buffer = ProfilerRegistry::getInstance()->getThreadBuffer();
+	buffer->depth--;
+	buffer->push( ProfilerThreadSample { _zone->id, _depth, _begin, end } );
 }
 
 Profiler::Profiler( void )
@@ -186,97 +404,111 @@ crimild::Real64 Profiler::getTime( void )
     return 0.001 * std::chrono::duration_cast< std::chrono::microseconds >( now ).count();
 }
 
-int Profiler::onSampleCreated( std::string name )
+ProfilerZone const *Profiler::registerZone( std::string const &name )
 {
-    int firstInvalidIndex = -1;
-    for ( int i = 0; i < Profiler::MAX_SAMPLES; i++ ) {
-        auto &sample = _samples[ i ];
-
-        if ( !sample.isValid ) {
-            if ( firstInvalidIndex < 0 ) {
-                firstInvalidIndex = i;
-            }
-        }
-        else if ( sample.name == name ) {
-            assert( !sample.isOpened && "Tried to profile a sample that is already being profiled" );
-
-            sample.parentIndex = _lastOpenedSample;
-            _lastOpenedSample = i;
-
-            sample.parentCount = _openSampleCount;
+	return ProfilerRegistry::getInstance()->registerZone( name );
+}
 
-            _openSampleCount++;
+void Profiler::setThreadName( std::string const &name )
+{
+	ProfilerRegistry::getInstance()->setThreadName( name );
+}
 
-            sample.isOpened = true;
+crimild::Size Profiler::getDroppedSampleCount( void )
+{
+	return ProfilerRegistry::getInstance()->getDroppedCount();
+}
 
-            sample.callCount++;
-            sample.startTime = getTime();
+void Profiler::collect( void )
+{
+	_samples.resize( ProfilerRegistry::getInstance()->getZoneCount() );
 
-            if ( sample.parentIndex < 0 ) {
-                _rootBegin = sample.startTime;
-            }
+	ProfilerRegistry::getInstance()->drain( [ this ]( ProfilerThreadBuffer *buffer, ProfilerThreadSample const &s ) {
+		if ( s.zoneId >= _samples.size() ) {
+			// the zone was registered by another thread after resizing
+			_samples.resize( s.zoneId + 1 );
+		}
 
-            return i;
-        }
-    }
+		auto &sample = _samples[ s.zoneId ];
+		sample.isValid = true;
+		sample.callCount++;
+		sample.totalTime += 1.0e-6 * ( s.end - s.begin );
+		sample.parentCount = s.depth;
 
-    assert( firstInvalidIndex >= 0 && "Profiler run out of sample slots" );
+		if ( _capturing ) {
+			_capturedSamples.push_back( CapturedSample { s.zoneId, buffer->index, s.begin, s.end } );
+		}
+	});
+}
 
-    auto &sample = _samples[ firstInvalidIndex ];
+void Profiler::beginCapture( void )
+{
+	// discard anything recorded before the capture started
+	collect();
 
-    sample.isValid = true;
-    sample.name = name;
-    sample.parentIndex = _lastOpenedSample;
-    _lastOpenedSample = firstInvalidIndex;
-    sample.parentCount = _openSampleCount;
-    _openSampleCount++;
-    sample.isOpened = true;
-    sample.callCount = 1;
-    sample.totalTime = 0.0f;
-    sample.childTime = 0.0f;
-    sample.startTime = getTime();
+	_capturedSamples.clear();
+	_capturedFrames.clear();
+	_captureBegin = getProfilerTimestamp();
+	_capturing = true;
+}
 
-    if ( sample.parentIndex < 0 ) {
-        _rootBegin = sample.startTime;
-    }
+void Profiler::endCapture( void )
+{
+	collect();
 
-    return firstInvalidIndex;
+	_capturing = false;
 }
 
-void Profiler::onSampleDestroyed( int sampleIndex )
+void Profiler::exportChromeTrace( std::ostream &out )
 {
-    if ( sampleIndex < 0 ) {
-        Log::error( CRIMILD_CURRENT_CLASS_NAME, "Invalid sample index ", sampleIndex );
-        return;
-    }
+	auto registry = ProfilerRegistry::getInstance();
 
+	auto toMicroseconds = [ this ]( crimild::Int64 t ) {
+		return 0.001 * ( t - _captureBegin );
+	};
 
-    auto endTime = getTime();
+	out << std::setiosflags( std::ios::fixed ) << std::setprecision( 3 );
+	out << "{\"traceEvents\":[\n";
 
-    auto &sample = _samples[ sampleIndex ];
+	// thread names are only available for running threads
+	out << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":0,\"args\":{\"name\":\"crimild\"}}";
+	registry->eachThreadBuffer( [ &out ]( ProfilerThreadBuffer *buffer ) {
+		out << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":" << buffer->index
+			<< ",\"args\":{\"name\":\"" << escapeTraceString( buffer->name ) << "\"}}";
+	});
 
-    sample.isOpened = false;
+	for ( const auto &frame : _capturedFrames ) {
+		out << ",\n{\"name\":\"Frame\",\"ph\":\"i\",\"s\":\"g\",\"pid\":0,\"tid\":0,\"ts\":" << toMicroseconds( frame ) << "}";
+	}
 
-    unsigned long deltaTime = endTime - sample.startTime;
+	for ( const auto &sample : _capturedSamples ) {
+		auto zone = registry->getZone( sample.zoneId );
+		out << ",\n{\"name\":\"" << ( zone != nullptr ? escapeTraceString( zone->name ) : "" )
+			<< "\",\"ph\":\"X\",\"pid\":0,\"tid\":" << sample.threadIndex
+			<< ",\"ts\":" << toMicroseconds( sample.begin )
+			<< ",\"dur\":" << 0.001 * ( sample.end - sample.begin ) << "}";
+	}
 
-    if ( sample.parentIndex >= 0 ) {
-        _samples[ sample.parentIndex ].childTime += deltaTime;
-    }
-    else {
-        _rootEnd = endTime;
-    }
+	out << "\n]}\n";
+}
 
-    sample.totalTime += deltaTime;
+bool Profiler::exportChromeTrace( std::string const &fileName )
+{
+	std::ofstream out( fileName );
+	if ( !out.is_open() ) {
+		Log::error( CRIMILD_CURRENT_CLASS_NAME, "Cannot open file ", fileName );
+		return false;
+	}
 
-    _lastOpenedSample = sample.parentIndex;
+	exportChromeTrace( out );
 
-    _openSampleCount--;
+	Log::info( CRIMILD_CURRENT_CLASS_NAME, "Exported ", _capturedSamples.size(), " samples to ", fileName );
+	return true;
 }
 
 void Profiler::resetAll( void )
 {
-	for ( int i = 0; i < MAX_SAMPLES; i++ ) {
-		auto &sample = _samples[ i ];
+	for ( auto &sample : _samples ) {
 		sample.avgTime = 0.0f;
 		sample.minTime = -1.0f;
 		sample.maxTime = -1.0f;
@@ -298,6 +530,12 @@ void Profiler::resetAll( void )
 
 void Profiler::step( void )
 {
+	collect();
+
+	if ( _capturing ) {
+		_capturedFrames.push_back( getProfilerTimestamp() );
+	}
+
 	_frameCount++;
 	
 	const auto currentFrameTime = getTime();
@@ -324,7 +562,7 @@ void Profiler::dump( void )
 
     getOutputHandler()->beginOutput( _fps, _avgFrameTime, _minFrameTime, _maxFrameTime );
 
-	for ( int i = 0; i < MAX_SAMPLES; i++ ) {
+	for ( crimild::Size i = 0; i < _samples.size(); i++ ) {
 		auto &sample = _samples[ i ];
 		
 		if ( sample.isValid ) {
@@ -334,11 +572,10 @@ void Profiler::dump( void )
 			sample.minTime = sample.minTime < 0 ? sample.totalTime : Numericf::min( sample.minTime, sample.totalTime );
 			sample.maxTime = sample.maxTime < 0 ? sample.totalTime : Numericf::max( sample.maxTime, sample.totalTime );
 			
-			getOutputHandler()->sample( sample.minTime, sample.avgTime, sample.maxTime, sample.totalTime, sample.callCount, sample.name, sample.parentCount );
+			getOutputHandler()->sample( sample.minTime, sample.avgTime, sample.maxTime, sample.totalTime, sample.callCount, ProfilerRegistry::getInstance()->getZone( i )->name, sample.parentCount );
 			
 			sample.callCount = 0;
 			sample.totalTime = 0;
-			sample.childTime = 0;
 		}
 	}
 
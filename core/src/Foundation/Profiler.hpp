@@ -39,6 +39,8 @@
 #include <thread>
 #include <map>
 #include <deque>
+#include <ostream>
+#include <vector>
 
 #ifndef CRIMILD_PROFILER_ENABLED
 #define CRIMILD_PROFILER_ENABLED 1
@@ -46,13 +48,33 @@
 
 namespace crimild {
 
+    /**
+        \brief Static description of a profiled code block
+
+        Zones are registered once per name and never destroyed. Use the
+        CRIMILD_PROFILE macro, which keeps a static pointer to the zone
+        so the registry is only accessed the first time.
+     */
+    struct ProfilerZone {
+        std::string name;
+        crimild::UInt32 id;
+    };
+
+    /**
+        \brief Measures the scope of a zone in the current thread
+
+        Each thread writes completed samples into its own ring buffer,
+        so samples can be created from worker jobs too.
+     */
     class ProfilerSample {
     public:
-        explicit ProfilerSample( std::string name );
+        explicit ProfilerSample( ProfilerZone const *zone );
         ~ProfilerSample( void );
 
     private:
-        int _sampleIndex;
+        ProfilerZone const *_zone;
+        crimild::UInt32 _depth;
+        crimild::Int64 _begin;
     };
 
     class ProfilerOutputHandler : public SharedObject {
@@ -89,13 +111,16 @@ namespace crimild {
     };
 
     class Profiler : public DynamicSingleton< Profiler > {
-    private:
-        static constexpr int MAX_SAMPLES = 50;
-
     public:
         Profiler( void );
         ~Profiler( void );
 
+        /**
+            \brief Marks a frame boundary
+
+            Samples recorded by all threads since the last call are
+            collected here.
+         */
 		void step( void );
 		
         void dump( void );
@@ -106,26 +131,77 @@ namespace crimild {
         void setOutputHandler( ProfilerOutputHandlerPtr const &handler ) { _outputHandler = handler; }
         ProfilerOutputHandlerPtr &getOutputHandler( void ) { return _outputHandler; }
 
-    // internal use only
-    public: 
-        int onSampleCreated( std::string name );
-        void onSampleDestroyed( int index );
+        /**
+            \name Zones and threads
+         */
+        //@{
+
+    public:
+        /**
+            \brief Gets the zone for the given name, creating it if needed
+
+            \remarks This method is thread-safe but it requires a lock.
+         */
+        static ProfilerZone const *registerZone( std::string const &name );
+
+        /**
+            \brief Name used for the current thread in exported traces
+         */
+        static void setThreadName( std::string const &name );
+
+        /**
+            \brief Number of samples discarded because a thread buffer was full
+         */
+        static crimild::Size getDroppedSampleCount( void );
+
+        //@}
+
+        /**
+            \name Trace capture
+
+            While capturing, every sample collected by step() is kept so it can 
+            be exported in the Chrome trace event format (chrome://tracing)
+         */
+        //@{
+
+    public:
+        void beginCapture( void );
+        void endCapture( void );
+        inline bool isCapturing( void ) const { return _capturing; }
+
+        inline crimild::Size getCapturedSampleCount( void ) const { return _capturedSamples.size(); }
+
+        void exportChromeTrace( std::ostream &out );
+        bool exportChromeTrace( std::string const &fileName );
 
     private:
+        struct CapturedSample {
+            crimild::UInt32 zoneId;
+            crimild::UInt32 threadIndex;
+            crimild::Int64 begin;
+            crimild::Int64 end;
+        };
+
+        crimild::Bool _capturing = false;
+        crimild::Int64 _captureBegin = 0;
+        std::vector< CapturedSample > _capturedSamples;
+        std::vector< crimild::Int64 > _capturedFrames;
+
+        //@}
+
+    private:
+        void collect( void );
+
 		crimild::Real64 getTime( void );
 
     private:
 
         struct ProfilerSampleInfo {
             bool isValid = false;
-            bool isOpened = false;
 
-            std::string name;
             unsigned int callCount = 0;
 
-			crimild::Real64 startTime = 0;
 			crimild::Real64 totalTime = 0;
-			crimild::Real64 childTime = 0;
 
 			crimild::Real64 avgTime = 0.0f;
 			crimild::Real64 minTime = 0.0f;
@@ -134,15 +210,12 @@ namespace crimild {
             unsigned int dataCount = 0;
 
             int parentCount = 0;
-            int parentIndex = -1;
         };
 
-        ProfilerSampleInfo _samples[ MAX_SAMPLES ];
-
-        int _lastOpenedSample = -1;
-        int _openSampleCount = 0;
-        float _rootBegin = 0.0f;
-        float _rootEnd = 0.0f;
+        /**
+            \brief Stats for each zone, indexed by zone id
+         */
+        std::vector< ProfilerSampleInfo > _samples;
 
         ProfilerOutputHandlerPtr _outputHandler;
 
@@ -159,10 +232,24 @@ namespace crimild {
 
 }
 
+#define CRIMILD_PROFILER_CONCAT_IMPL( A, B ) A##B
+#define CRIMILD_PROFILER_CONCAT( A, B ) CRIMILD_PROFILER_CONCAT_IMPL( A, B )
+
 #if CRIMILD_PROFILER_ENABLED
-    #define CRIMILD_PROFILE( X ) crimild::ProfilerSample __crimild__profile__sample__instance__( X );
+    /**
+        \brief Profiles the current scope using a static zone
+
+        The name is only evaluated once, so use CRIMILD_PROFILE_DYNAMIC if
+        it may change between calls (i.e. getName())
+     */
+    #define CRIMILD_PROFILE( X ) \
+        static crimild::ProfilerZone const *CRIMILD_PROFILER_CONCAT( __crimild__profile__zone__, __LINE__ ) = crimild::Profiler::registerZone( X ); \
+        crimild::ProfilerSample CRIMILD_PROFILER_CONCAT( __crimild__profile__sample__instance__, __LINE__ )( CRIMILD_PROFILER_CONCAT( __crimild__profile__zone__, __LINE__ ) );
+    #define CRIMILD_PROFILE_DYNAMIC( X ) \
+        crimild::ProfilerSample CRIMILD_PROFILER_CONCAT( __crimild__profile__sample__instance__, __LINE__ )( crimild::Profiler::registerZone( X ) );
 #else
     #define CRIMILD_PROFILE( X )
+    #define CRIMILD_PROFILE_DYNAMIC( X )
 #endif
 
 #endif
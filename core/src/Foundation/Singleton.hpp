@@ -63,6 +63,17 @@ namespace crimild {
 			return _instance;
 		}
 
+		/**
+			\brief Checks if an instance has been created
+
+			Useful for optional services, since getInstance() asserts
+			if there's no instance
+		*/
+		static bool hasInstance( void )
+		{
+			return _instance != nullptr;
+		}
+
 	protected:
 		SingletonHeapStoragePolicy( void )
 		{
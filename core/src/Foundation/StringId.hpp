@@ -0,0 +1,150 @@
+/*
+ * Copyright (c) 2013, Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef CRIMILD_FOUNDATION_STRING_ID_
+#define CRIMILD_FOUNDATION_STRING_ID_
+
+#include "Types.hpp"
+
+#include <string>
+
+namespace crimild {
+
+	/**
+		\brief A hashed string identifier
+
+		Ids created from string literals can be computed at compile time:
+
+		\code
+		constexpr StringId MOTION_VELOCITY( "motion.velocity" );
+		\endcode
+
+		Comparing ids or using them as keys is as cheap as using integers,
+		which makes them a good fit for lookups done every frame. 
+		
+		Ids keep a pointer to the original string for debugging and so
+		containers can store key names when inserting new entries. An id
+		must not outlive the string it was created from, so containers 
+		should copy that name instead of keeping the id itself.
+
+		Hashes are computed using 64-bit FNV-1a, which can be resumed with 
+		append() to create ids for derived keys (i.e. "motion.velocity.x")
+		without hashing the whole string again.
+	*/
+	class StringId {
+	public:
+		using Hash = crimild::UInt64;
+
+		/**
+			\brief Computes the hash for a null-terminated string
+		*/
+		static constexpr Hash computeHash( const char *str )
+		{
+			return resumeHash( str, 14695981039346656037ull );
+		}
+
+		/**
+			\brief Computes the hash for a string at runtime
+
+			Unlike the constexpr version, this one is not recursive
+		*/
+		static Hash computeHash( const std::string &str )
+		{
+			Hash hash = 14695981039346656037ull;
+			for ( auto c : str ) {
+				hash = ( hash ^ static_cast< Hash >( static_cast< crimild::UInt8 >( c ) ) ) * 1099511628211ull;
+			}
+			return hash;
+		}
+
+	private:
+		static constexpr Hash resumeHash( const char *str, Hash hash )
+		{
+			return ( str == nullptr || *str == '\0' ) ? hash : resumeHash( str + 1, ( hash ^ static_cast< Hash >( static_cast< crimild::UInt8 >( *str ) ) ) * 1099511628211ull );
+		}
+
+	public:
+		constexpr StringId( void )
+			: _hash( computeHash( "" ) ),
+			  _name( nullptr )
+		{
+
+		}
+
+		constexpr StringId( const char *name )
+			: _hash( computeHash( name ) ),
+			  _name( name )
+		{
+
+		}
+
+		StringId( const std::string &name )
+			: _hash( computeHash( name ) ),
+			  _name( name.c_str() )
+		{
+
+		}
+
+		constexpr Hash getHash( void ) const { return _hash; }
+
+		/**
+			\brief The string this id was created from
+
+			Ids created with append() have no name
+		*/
+		const char *getName( void ) const { return _name != nullptr ? _name : ""; }
+
+		constexpr bool hasName( void ) const { return _name != nullptr; }
+
+		/**
+			\brief Creates a new id as if the suffix was appended to the original string
+		*/
+		constexpr StringId append( const char *suffix ) const
+		{
+			return StringId( resumeHash( suffix, _hash ), nullptr );
+		}
+
+		constexpr bool operator==( const StringId &other ) const { return _hash == other._hash; }
+		constexpr bool operator!=( const StringId &other ) const { return _hash != other._hash; }
+
+	private:
+		constexpr StringId( Hash hash, const char *name )
+			: _hash( hash ),
+			  _name( name )
+		{
+
+		}
+
+	private:
+		Hash _hash;
+		const char *_name;
+	};
+
+}
+
+#endif
+
@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) 2013, Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "Variant.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+
+using namespace crimild;
+
+Variant::Variant( void )
+{
+
+}
+
+Variant::~Variant( void )
+{
+
+}
+
+void Variant::set( crimild::Bool value )
+{
+	_type = Type::BOOL;
+	_bool = value;
+	_integer = value ? 1 : 0;
+	_real = value ? 1.0 : 0.0;
+	_string = value ? "1" : "0";
+}
+
+void Variant::setInteger( crimild::Int64 value )
+{
+	_type = Type::INTEGER;
+	_bool = value != 0;
+	_integer = value;
+	_real = static_cast< crimild::Real64 >( value );
+
+	char buffer[ 32 ];
+	std::snprintf( buffer, sizeof( buffer ), "%lld", static_cast< long long >( value ) );
+	_string = buffer;
+}
+
+void Variant::setReal( crimild::Real64 value )
+{
+	_type = Type::REAL;
+	_bool = value != 0.0;
+	_integer = static_cast< crimild::Int64 >( value );
+	_real = value;
+
+	// same format used by stream operators
+	char buffer[ 32 ];
+	std::snprintf( buffer, sizeof( buffer ), "%g", value );
+	_string = buffer;
+}
+
+void Variant::set( const std::string &value )
+{
+	_type = Type::STRING;
+	_string = value;
+
+	// parse numbers only once
+	_integer = std::strtoll( value.c_str(), nullptr, 10 );
+	_real = std::strtod( value.c_str(), nullptr );
+	_bool = value == "true" || _real != 0.0;
+}
@@ -0,0 +1,142 @@
+/*
+ * Copyright (c) 2013, Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef CRIMILD_FOUNDATION_VARIANT_
+#define CRIMILD_FOUNDATION_VARIANT_
+
+#include "Types.hpp"
+
+#include <string>
+#include <sstream>
+
+namespace crimild {
+
+	/**
+		\brief A typed value slot
+
+		Variants store booleans, integers, reals and strings natively, so 
+		reading a value with the same (or a compatible numeric) type does
+		not require any parsing. Strings are parsed only once, when set,
+		and numbers are formatted as strings when set too, so reading
+		never modifies a variant and concurrent reads are safe.
+
+		Any other type is stored as a string using stream operators, 
+		which matches the behavior of the old string-based containers.
+	*/
+	class Variant {
+	public:
+		enum class Type {
+			EMPTY,
+			BOOL,
+			INTEGER,
+			REAL,
+			STRING,
+		};
+
+	public:
+		Variant( void );
+
+		template< typename T >
+		explicit Variant( T value )
+		{
+			set( value );
+		}
+
+		~Variant( void );
+
+		inline Type getType( void ) const { return _type; }
+		inline crimild::Bool isEmpty( void ) const { return _type == Type::EMPTY; }
+
+		void set( crimild::Bool value );
+		void set( crimild::Int8 value ) { setInteger( value ); }
+		void set( crimild::Int16 value ) { setInteger( value ); }
+		void set( crimild::Int32 value ) { setInteger( value ); }
+		void set( crimild::Int64 value ) { setInteger( value ); }
+		void set( crimild::UInt8 value ) { setInteger( value ); }
+		void set( crimild::UInt16 value ) { setInteger( value ); }
+		void set( crimild::UInt32 value ) { setInteger( value ); }
+		void set( crimild::UInt64 value ) { setInteger( value ); }
+		void set( crimild::Real32 value ) { setReal( value ); }
+		void set( crimild::Real64 value ) { setReal( value ); }
+		void set( const char *value ) { set( std::string( value != nullptr ? value : "" ) ); }
+		void set( const std::string &value );
+
+		template< typename T >
+		void set( const T &value )
+		{
+			std::stringstream ss;
+			ss << value;
+			set( ss.str() );
+		}
+
+		template< typename T >
+		T get( void ) const
+		{
+			T value;
+			read( value );
+			return value;
+		}
+
+		const std::string &getString( void ) const { return _string; }
+
+	private:
+		void setInteger( crimild::Int64 value );
+		void setReal( crimild::Real64 value );
+
+		void read( crimild::Bool &value ) const { value = _bool; }
+		void read( crimild::Int8 &value ) const { value = static_cast< crimild::Int8 >( _integer ); }
+		void read( crimild::Int16 &value ) const { value = static_cast< crimild::Int16 >( _integer ); }
+		void read( crimild::Int32 &value ) const { value = static_cast< crimild::Int32 >( _integer ); }
+		void read( crimild::Int64 &value ) const { value = _integer; }
+		void read( crimild::UInt8 &value ) const { value = static_cast< crimild::UInt8 >( _integer ); }
+		void read( crimild::UInt16 &value ) const { value = static_cast< crimild::UInt16 >( _integer ); }
+		void read( crimild::UInt32 &value ) const { value = static_cast< crimild::UInt32 >( _integer ); }
+		void read( crimild::UInt64 &value ) const { value = static_cast< crimild::UInt64 >( _integer ); }
+		void read( crimild::Real32 &value ) const { value = static_cast< crimild::Real32 >( _real ); }
+		void read( crimild::Real64 &value ) const { value = _real; }
+		void read( std::string &value ) const { value = getString(); }
+
+		template< typename T >
+		void read( T &value ) const
+		{
+			std::stringstream ss;
+			ss << getString();
+			ss >> value;
+		}
+
+	private:
+		Type _type = Type::EMPTY;
+		crimild::Bool _bool = false;
+		crimild::Int64 _integer = 0;
+		crimild::Real64 _real = 0;
+		std::string _string;
+	};
+
+}
+
+#endif
+
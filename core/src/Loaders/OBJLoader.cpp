@@ -26,94 +26,245 @@
  */
 
 #include "OBJLoader.hpp"
+#include "SceneCache.hpp"
 
 #include "SceneGraph/Group.hpp"
 #include "SceneGraph/Geometry.hpp"
-#include "Foundation/StringUtils.hpp"
 #include "Foundation/Log.hpp"
+#include "Foundation/MappedFile.hpp"
+#include "Concurrency/Async.hpp"
+#include "Concurrency/JobScheduler.hpp"
 #include "Simulation/AssetManager.hpp"
 #include "Simulation/FileSystem.hpp"
 #include "Primitives/Primitive.hpp"
+#include "Primitives/MeshOptimizer.hpp"
 #include "Rendering/Renderer.hpp"
 #include "Rendering/Material.hpp"
 #include "Rendering/ImageTGA.hpp"
 #include "Rendering/ShaderProgram.hpp"
 #include "Components/MaterialComponent.hpp"
 
-using namespace crimild;
-
-OBJLoader::FileProcessor::FileProcessor( void )
-{
-
-}
-
-OBJLoader::FileProcessor::~FileProcessor( void )
-{
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
 
-}
+using namespace crimild;
 
-void OBJLoader::FileProcessor::readFile( std::string fileName )
-{
-	std::ifstream input;
-	input.open( fileName.c_str() );
-	if ( !input.is_open() ) {
-        Log::error( CRIMILD_CURRENT_CLASS_NAME, "Cannot load file ", fileName );
-		return;
-	}
+namespace crimild {
+
+	namespace obj {
+
+		static inline bool isSpace( char c )
+		{
+			return c == ' ' || c == '\t' || c == '\r';
+		}
+
+		static inline bool isDigit( char c )
+		{
+			return c >= '0' && c <= '9';
+		}
+
+		static inline const char *skipSpaces( const char *it, const char *end )
+		{
+			while ( it < end && isSpace( *it ) ) {
+				++it;
+			}
+			return it;
+		}
+
+		static inline const char *skipToken( const char *it, const char *end )
+		{
+			while ( it < end && !isSpace( *it ) ) {
+				++it;
+			}
+			return it;
+		}
+
+		static inline char toLower( char c )
+		{
+			// Only letters are folded. Other characters, like '_', must be kept
+			return c >= 'A' && c <= 'Z' ? char( c | 0x20 ) : c;
+		}
+
+		/**
+			\brief Compares a token against a lower case keyword, ignoring case
+		*/
+		static inline bool matches( const char *token, crimild::Size length, const char *keyword )
+		{
+			crimild::Size i = 0;
+			for ( ; i < length; i++ ) {
+				if ( keyword[ i ] == '\0' || toLower( token[ i ] ) != keyword[ i ] ) {
+					return false;
+				}
+			}
+			return keyword[ i ] == '\0';
+		}
+
+		/**
+			\brief First token in the line, like reading with operator>>
+		*/
+		static std::string readToken( const char *it, const char *end )
+		{
+			it = skipSpaces( it, end );
+			return std::string( it, skipToken( it, end ) );
+		}
+
+		/**
+			\brief The rest of the line, which may include spaces
+		*/
+		static std::string readFullString( const char *it, const char *end )
+		{
+			it = skipSpaces( it, end );
+			while ( end > it && isSpace( *( end - 1 ) ) ) {
+				--end;
+			}
+			return std::string( it, end );
+		}
+
+		static bool parseInt( const char *&it, const char *end, crimild::Int32 &result )
+		{
+			bool negative = false;
+			if ( it < end && ( *it == '-' || *it == '+' ) ) {
+				negative = *it == '-';
+				++it;
+			}
+
+			if ( it == end || !isDigit( *it ) ) {
+				return false;
+			}
+
+			crimild::Int32 value = 0;
+			while ( it < end && isDigit( *it ) ) {
+				value = 10 * value + ( *it - '0' );
+				++it;
+			}
+
+			result = negative ? -value : value;
+			return true;
+		}
+
+		static bool parseFloat( const char *&it, const char *end, crimild::Real32 &result )
+		{
+			static const double POWERS_OF_TEN[] = {
+				1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10,
+				1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20,
+				1e21, 1e22,
+			};
+			static const crimild::Int32 MAX_EXACT_POWER = 22;
+			static const crimild::Int32 MAX_EXACT_DIGITS = 15;
+
+			it = skipSpaces( it, end );
+			const char *start = it;
+
+			bool negative = false;
+			if ( it < end && ( *it == '-' || *it == '+' ) ) {
+				negative = *it == '-';
+				++it;
+			}
+
+			crimild::UInt64 mantissa = 0;
+			crimild::Int32 digits = 0;
+			crimild::Int32 exponent = 0;
+			bool any = false;
+
+			while ( it < end && isDigit( *it ) ) {
+				if ( digits > 0 || *it != '0' ) {
+					if ( digits < 19 ) {
+						mantissa = 10 * mantissa + ( *it - '0' );
+					}
+					else {
+						exponent++;
+					}
+					digits++;
+				}
+				any = true;
+				++it;
+			}
+
+			if ( it < end && *it == '.' ) {
+				++it;
+				while ( it < end && isDigit( *it ) ) {
+					if ( digits > 0 || *it != '0' ) {
+						if ( digits < 19 ) {
+							mantissa = 10 * mantissa + ( *it - '0' );
+							exponent--;
+						}
+						digits++;
+					}
+					else {
+						exponent--;
+					}
+					any = true;
+					++it;
+				}
+			}
+
+			if ( !any ) {
+				it = start;
+				return false;
+			}
+
+			if ( it < end && ( *it == 'e' || *it == 'E' ) ) {
+				const char *e = it + 1;
+				crimild::Int32 value = 0;
+				if ( parseInt( e, end, value ) ) {
+					exponent += value;
+					it = e;
+				}
+			}
+
+			if ( digits > MAX_EXACT_DIGITS || exponent > MAX_EXACT_POWER || exponent < -MAX_EXACT_POWER ) {
+				// Not exact in double precision. Let the C library handle it
+				char buffer[ 64 ];
+				const crimild::Size length = Numeric< crimild::Size >::min( it - start, sizeof( buffer ) - 1 );
+				memcpy( buffer, start, length );
+				buffer[ length ] = '\0';
+				result = std::strtof( buffer, nullptr );
+				return true;
+			}
+
+			double value = ( double ) mantissa;
+			if ( exponent < 0 ) {
+				value /= POWERS_OF_TEN[ -exponent ];
+			}
+			else {
+				value *= POWERS_OF_TEN[ exponent ];
+			}
+
+			result = ( crimild::Real32 )( negative ? -value : value );
+			return true;
+		}
+
+		static bool parseCorner( const char *&it, const char *end, crimild::Int32 indices[ 3 ] )
+		{
+			indices[ 0 ] = indices[ 1 ] = indices[ 2 ] = 0;
+
+			it = skipSpaces( it, end );
+			if ( !parseInt( it, end, indices[ 0 ] ) ) {
+				return false;
+			}
+
+			for ( crimild::Size i = 1; i < 3 && it < end && *it == '/'; i++ ) {
+				++it;
+				// missing values (i.e. "1//2") are left as zero
+				parseInt( it, end, indices[ i ] );
+			}
+
+			it = skipToken( it, end );
+			return true;
+		}
 
-	while ( !input.eof() ) {
-		processLine( input );
 	}
-}
-
-void OBJLoader::FileProcessor::registerLineProcessor( std::string type, OBJLoader::FileProcessor::LineProcessor lineProcessor )
-{
-    _lineProcessors[ StringUtils::toLower( type ) ] = lineProcessor;
-}
 
-std::string OBJLoader::FileProcessor::getLine( std::ifstream &input )
-{
-	char buffer[ 1024 ];
-	input.getline( buffer, 1024 );
-	return std::string( buffer );
 }
 
-void OBJLoader::FileProcessor::processLine( std::ifstream &input )
-{
-	std::stringstream line( getLine( input ) );
-	
-	std::string what;
-	line >> what;
-
-    auto processor = _lineProcessors[ StringUtils::toLower( what ) ];
-	if ( processor != nullptr ) {
-		processor( line );
-	}
-}
+using namespace crimild::obj;
 
 OBJLoader::OBJLoader( std::string fileName )
 	: _fileName( fileName )
 {
-	getOBJProcessor().registerLineProcessor( "o", std::bind( &OBJLoader::readObject, this, std::placeholders::_1 ) );
-	getOBJProcessor().registerLineProcessor( "g", std::bind( &OBJLoader::readObject, this, std::placeholders::_1 ) );
-	getOBJProcessor().registerLineProcessor( "v", std::bind( &OBJLoader::readObjectPositions, this, std::placeholders::_1 ) );
-	getOBJProcessor().registerLineProcessor( "vn", std::bind( &OBJLoader::readObjectNormals, this, std::placeholders::_1 ) );
-	getOBJProcessor().registerLineProcessor( "vt", std::bind( &OBJLoader::readObjectTextureCoords, this, std::placeholders::_1 ) );
-	getOBJProcessor().registerLineProcessor( "f", std::bind( &OBJLoader::readObjectFaces, this, std::placeholders::_1 ) );
- 	getOBJProcessor().registerLineProcessor( "usemtl", std::bind( &OBJLoader::readObjectMaterial, this, std::placeholders::_1 ) );
-	getOBJProcessor().registerLineProcessor( "mtllib", std::bind( &OBJLoader::readMaterialFile, this, std::placeholders::_1 ) );
-
-	getMTLProcessor().registerLineProcessor( "newmtl", std::bind( &OBJLoader::readMaterialName, this, std::placeholders::_1 ) );
-	getMTLProcessor().registerLineProcessor( "Ka", std::bind( &OBJLoader::readMaterialAmbient, this, std::placeholders::_1 ) );
-	getMTLProcessor().registerLineProcessor( "Kd", std::bind( &OBJLoader::readMaterialDiffuse, this, std::placeholders::_1 ) );
-	getMTLProcessor().registerLineProcessor( "Ks", std::bind( &OBJLoader::readMaterialSpecular, this, std::placeholders::_1 ) );
-	getMTLProcessor().registerLineProcessor( "map_Kd", std::bind( &OBJLoader::readMaterialColorMap, this, std::placeholders::_1 ) );
-	getMTLProcessor().registerLineProcessor( "map_bump", std::bind( &OBJLoader::readMaterialNormalMap, this, std::placeholders::_1 ) );
-	getMTLProcessor().registerLineProcessor( "map_kS", std::bind( &OBJLoader::readMaterialSpecularMap, this, std::placeholders::_1 ) );
-	getMTLProcessor().registerLineProcessor( "map_Ke", std::bind( &OBJLoader::readMaterialEmissiveMap, this, std::placeholders::_1 ) );
-	getMTLProcessor().registerLineProcessor( "illum", std::bind( &OBJLoader::readMaterialShaderProgram, this, std::placeholders::_1 ) );
-    getMTLProcessor().registerLineProcessor( "d", std::bind( &OBJLoader::readMaterialTranslucency, this, std::placeholders::_1 ) );
-    getMTLProcessor().registerLineProcessor( "Tr", std::bind( &OBJLoader::readMaterialTranslucency, this, std::placeholders::_1 ) );
+
 }
 
 OBJLoader::~OBJLoader( void )
@@ -132,20 +283,253 @@ void OBJLoader::reset( void )
 	_positions.clear();
 	_normals.clear();
 	_textureCoords.clear();
+	_faces.clear();
+
+	_sourceFileNames.clear();
+
+	_positionCount = 0;
+	_textureCoordCount = 0;
+	_normalCount = 0;
+	_faceBegin = 0;
 }
 
 SharedPointer< Group > OBJLoader::load( void )
 {
+	const auto cacheFileName = SceneCache::getCacheFileName( getFileName() );
+	if ( _cacheEnabled ) {
+		if ( auto scene = SceneCache::read( cacheFileName ) ) {
+			return scene;
+		}
+	}
+
 	reset();
 
-	getOBJProcessor().readFile( getFileName() );
+	if ( !parse() ) {
+		return generateScene();
+	}
+
+	auto scene = generateScene();
+
+	if ( _cacheEnabled ) {
+		SceneCache::write( cacheFileName, crimild::get_ptr( scene ), _sourceFileNames );
+	}
 
-	return generateScene();
+	return scene;
 }
 
-void OBJLoader::generateGeometry( void )
+bool OBJLoader::parse( void )
 {
-	if ( _faces.size() == 0 || _positions.size() == 0 ) {
+	_sourceFileNames.push_back( getFileName() );
+
+	MappedFile file( getFileName() );
+	if ( !file.isOpen() ) {
+		Log::error( CRIMILD_CURRENT_CLASS_NAME, "Cannot load file ", getFileName() );
+		return false;
+	}
+
+	const auto begin = reinterpret_cast< const char * >( file.getData() );
+	const auto size = file.getSize();
+
+	crimild::Size chunkCount = 1;
+	if ( concurrency::JobScheduler::hasInstance() && concurrency::JobScheduler::getInstance()->isRunning() ) {
+		// a few chunks per worker help balancing the load
+		const crimild::Size maxChunks = 4 * ( concurrency::JobScheduler::getInstance()->getNumWorkers() + 1 );
+		chunkCount = Numeric< crimild::Size >::clamp( size / Numeric< crimild::Size >::max( 1, _minChunkSize ), 1, maxChunks );
+	}
+
+	// Split file into chunks at line boundaries
+	std::vector< Chunk > chunks( chunkCount );
+	const char *end = begin + size;
+	const char *chunkBegin = begin;
+	for ( crimild::Size i = 0; i < chunkCount; i++ ) {
+		const char *chunkEnd = begin + ( i + 1 ) * size / chunkCount;
+		if ( i == chunkCount - 1 ) {
+			chunkEnd = end;
+		}
+		else {
+			const char *eol = static_cast< const char * >( memchr( chunkEnd, '\n', end - chunkEnd ) );
+			chunkEnd = eol != nullptr ? eol + 1 : end;
+		}
+		chunks[ i ].begin = chunkBegin;
+		chunks[ i ].end = chunkEnd > chunkBegin ? chunkEnd : chunkBegin;
+		chunkBegin = chunks[ i ].end;
+	}
+
+	concurrency::parallel_for( chunkCount, [ &chunks ]( crimild::Size i ) {
+		parseChunk( chunks[ i ] );
+	});
+
+	mergeChunks( chunks );
+
+	return true;
+}
+
+void OBJLoader::parseChunk( Chunk &chunk )
+{
+	const char *it = chunk.begin;
+	const char *end = chunk.end;
+
+	auto addCommand = [ &chunk ]( Command::Type type, std::string argument ) {
+		Command cmd;
+		cmd.type = type;
+		cmd.argument = argument;
+		cmd.positionCount = chunk.positions.size();
+		cmd.textureCoordCount = chunk.textureCoords.size();
+		cmd.normalCount = chunk.normals.size();
+		cmd.cornerCount = chunk.corners.size();
+		chunk.commands.push_back( cmd );
+	};
+
+	while ( it < end ) {
+		it = skipSpaces( it, end );
+
+		const char *lineEnd = static_cast< const char * >( memchr( it, '\n', end - it ) );
+		if ( lineEnd == nullptr ) {
+			lineEnd = end;
+		}
+
+		const char *keyword = it;
+		it = skipToken( it, lineEnd );
+		const auto length = it - keyword;
+
+		if ( matches( keyword, length, "v" ) ) {
+			Vector3f p( 0.0f, 0.0f, 0.0f );
+			parseFloat( it, lineEnd, p[ 0 ] ) && parseFloat( it, lineEnd, p[ 1 ] ) && parseFloat( it, lineEnd, p[ 2 ] );
+			chunk.positions.push_back( p );
+		}
+		else if ( matches( keyword, length, "vt" ) ) {
+			Vector2f uv( 0.0f, 0.0f );
+			parseFloat( it, lineEnd, uv[ 0 ] ) && parseFloat( it, lineEnd, uv[ 1 ] );
+			chunk.textureCoords.push_back( uv );
+		}
+		else if ( matches( keyword, length, "vn" ) ) {
+			Vector3f n( 0.0f, 0.0f, 0.0f );
+			parseFloat( it, lineEnd, n[ 0 ] ) && parseFloat( it, lineEnd, n[ 1 ] ) && parseFloat( it, lineEnd, n[ 2 ] );
+			chunk.normals.push_back( n );
+		}
+		else if ( matches( keyword, length, "f" ) ) {
+			Corner corners[ 3 ];
+			bool valid = true;
+			for ( crimild::Size i = 0; valid && i < 3; i++ ) {
+				valid = parseCorner( it, lineEnd, corners[ i ].indices );
+			}
+
+			if ( valid ) {
+				const crimild::Int32 counts[] = {
+					( crimild::Int32 ) chunk.positions.size(),
+					( crimild::Int32 ) chunk.textureCoords.size(),
+					( crimild::Int32 ) chunk.normals.size(),
+				};
+				for ( auto &corner : corners ) {
+					corner.relative = 0;
+					for ( crimild::Size c = 0; c < 3; c++ ) {
+						if ( corner.indices[ c ] < 0 ) {
+							// relative to the data read so far. Will be offset
+							// by whatever previous chunks read when merging
+							corner.indices[ c ] += counts[ c ] + 1;
+							corner.relative |= 1 << c;
+						}
+					}
+					chunk.corners.push_back( corner );
+				}
+			}
+		}
+		else if ( matches( keyword, length, "o" ) || matches( keyword, length, "g" ) ) {
+			addCommand( Command::Type::OBJECT, readToken( it, lineEnd ) );
+		}
+		else if ( matches( keyword, length, "usemtl" ) ) {
+			addCommand( Command::Type::MATERIAL, readToken( it, lineEnd ) );
+		}
+		else if ( matches( keyword, length, "mtllib" ) ) {
+			addCommand( Command::Type::MATERIAL_LIBRARY, readFullString( it, lineEnd ) );
+		}
+
+		it = lineEnd + 1;
+	}
+}
+
+void OBJLoader::mergeChunks( std::vector< Chunk > &chunks )
+{
+	struct Offsets {
+		crimild::Size positions = 0;
+		crimild::Size textureCoords = 0;
+		crimild::Size normals = 0;
+		crimild::Size corners = 0;
+	};
+
+	std::vector< Offsets > offsets( chunks.size() + 1 );
+	for ( crimild::Size i = 0; i < chunks.size(); i++ ) {
+		offsets[ i + 1 ].positions = offsets[ i ].positions + chunks[ i ].positions.size();
+		offsets[ i + 1 ].textureCoords = offsets[ i ].textureCoords + chunks[ i ].textureCoords.size();
+		offsets[ i + 1 ].normals = offsets[ i ].normals + chunks[ i ].normals.size();
+		offsets[ i + 1 ].corners = offsets[ i ].corners + chunks[ i ].corners.size();
+	}
+
+	const auto &totals = offsets.back();
+	_positions.resize( totals.positions );
+	_textureCoords.resize( totals.textureCoords );
+	_normals.resize( totals.normals );
+	_faces.resize( totals.corners );
+
+	concurrency::parallel_for( chunks.size(), [ this, &chunks, &offsets ]( crimild::Size i ) {
+		const auto &chunk = chunks[ i ];
+		const auto &offset = offsets[ i ];
+
+		std::copy( chunk.positions.begin(), chunk.positions.end(), _positions.begin() + offset.positions );
+		std::copy( chunk.textureCoords.begin(), chunk.textureCoords.end(), _textureCoords.begin() + offset.textureCoords );
+		std::copy( chunk.normals.begin(), chunk.normals.end(), _normals.begin() + offset.normals );
+
+		const crimild::Int32 bases[] = {
+			( crimild::Int32 ) offset.positions,
+			( crimild::Int32 ) offset.textureCoords,
+			( crimild::Int32 ) offset.normals,
+		};
+		for ( crimild::Size j = 0; j < chunk.corners.size(); j++ ) {
+			auto corner = chunk.corners[ j ];
+			for ( crimild::Size c = 0; c < 3; c++ ) {
+				if ( corner.relative & ( 1 << c ) ) {
+					corner.indices[ c ] += bases[ c ];
+				}
+			}
+			_faces[ offset.corners + j ] = corner;
+		}
+	});
+
+	// Commands must be executed in the same order they appear in the file
+	for ( crimild::Size i = 0; i < chunks.size(); i++ ) {
+		const auto &offset = offsets[ i ];
+		for ( const auto &cmd : chunks[ i ].commands ) {
+			_positionCount = offset.positions + cmd.positionCount;
+			_textureCoordCount = offset.textureCoords + cmd.textureCoordCount;
+			_normalCount = offset.normals + cmd.normalCount;
+
+			switch ( cmd.type ) {
+				case Command::Type::OBJECT:
+					generateGeometry( offset.corners + cmd.cornerCount );
+					_objects.push_back( crimild::alloc< Group >( cmd.argument ) );
+					_currentObject = crimild::get_ptr( _objects.back() );
+					break;
+
+				case Command::Type::MATERIAL:
+					_currentMaterial = crimild::get_ptr( _materials[ cmd.argument ] );
+					break;
+
+				case Command::Type::MATERIAL_LIBRARY:
+					readMaterialFile( FileSystem::getInstance().extractDirectory( _fileName ) + "/" + cmd.argument );
+					_currentMaterial = nullptr;
+					break;
+			}
+		}
+	}
+
+	_positionCount = totals.positions;
+	_textureCoordCount = totals.textureCoords;
+	_normalCount = totals.normals;
+}
+
+void OBJLoader::generateGeometry( crimild::Size faceEnd )
+{
+	if ( faceEnd <= _faceBegin || _positionCount == 0 ) {
 		// no data. skip
 		return;
 	}
@@ -154,12 +538,11 @@ void OBJLoader::generateGeometry( void )
 		// anonymous object
         _objects.push_back( crimild::alloc< Group >() );
         _currentObject = crimild::get_ptr( _objects.back() );
-                           
 	}
     
-    bool useNormals = _normals.size() > 0;
+    bool useNormals = _normalCount > 0;
     bool useTangents = _currentMaterial != nullptr && _currentMaterial->getNormalMap() != nullptr;
-    bool useTextureCoords = _textureCoords.size() > 0;
+    bool useTextureCoords = _textureCoordCount > 0;
 
 	VertexFormat format( 3,
 						 0,
@@ -167,74 +550,100 @@ void OBJLoader::generateGeometry( void )
 	                     ( useTangents > 0 ? 3 : 0 ),
 						 ( useTextureCoords > 0 ? 2 : 0 ) );
 
-	std::vector< float > vertexData;
-	std::vector< unsigned short > indexData;
-    
-    Vector3f p0, p1, p2;
-    Vector3f n0, n1, n2;
-    Vector2f uv0, uv1, uv2;
-    Vector3f tangent;
-    
-    const int VERTEX_COUNT = _faces.size();
+	const Corner *faces = &_faces[ _faceBegin ];
+	const crimild::Size VERTEX_COUNT = 3 * ( ( faceEnd - _faceBegin ) / 3 );
+	_faceBegin = faceEnd;
+
+	if ( VERTEX_COUNT == 0 ) {
+		return;
+	}
+
     auto vbo = crimild::alloc< VertexBufferObject >( format, VERTEX_COUNT, nullptr );
+
+	// OBJ indices are 1-based. Invalid ones map to zero
+	auto fetch = []( const std::vector< Vector3f > &data, crimild::Int32 index ) {
+		return index > 0 && index <= data.size() ? data[ index - 1 ] : Vector3f( 0.0f, 0.0f, 0.0f );
+	};
+	auto fetchUV = []( const std::vector< Vector2f > &data, crimild::Int32 index ) {
+		return index > 0 && index <= data.size() ? data[ index - 1 ] : Vector2f( 0.0f, 0.0f );
+	};
+
+	// Triangles are independent, so they can be processed in batches
+	const crimild::Size TRIANGLES_PER_BATCH = 64 * 1024;
+	const auto triangleCount = VERTEX_COUNT / 3;
+	const auto batchCount = ( triangleCount + TRIANGLES_PER_BATCH - 1 ) / TRIANGLES_PER_BATCH;
+
+	auto vboPtr = crimild::get_ptr( vbo );
+	concurrency::parallel_for( batchCount, [ this, &format, faces, vboPtr, triangleCount, TRIANGLES_PER_BATCH, &fetch, &fetchUV ]( crimild::Size batch ) {
+		Vector3f p0, p1, p2;
+		Vector3f n0, n1, n2;
+		Vector2f uv0, uv1, uv2;
+		Vector3f tangent;
+
+		const auto first = batch * TRIANGLES_PER_BATCH;
+		const auto last = Numeric< crimild::Size >::min( first + TRIANGLES_PER_BATCH, triangleCount );
+		for ( crimild::Size t = first; t < last; t++ ) {
+			const auto i = 3 * t;
+			const auto &v0 = faces[ i + 0 ].indices;
+			const auto &v1 = faces[ i + 1 ].indices;
+			const auto &v2 = faces[ i + 2 ].indices;
+
+			if ( format.hasPositions() ) {
+				p0 = fetch( _positions, v0[ Corner::POSITION ] );
+				p1 = fetch( _positions, v1[ Corner::POSITION ] );
+				p2 = fetch( _positions, v2[ Corner::POSITION ] );
+			}
+
+			if ( format.hasNormals() ) {
+				n0 = fetch( _normals, v0[ Corner::NORMAL ] );
+				n1 = fetch( _normals, v1[ Corner::NORMAL ] );
+				n2 = fetch( _normals, v2[ Corner::NORMAL ] );
+			}
+
+			if ( format.hasTextureCoords() ) {
+				uv0 = fetchUV( _textureCoords, v0[ Corner::TEXTURE_COORD ] );
+				uv1 = fetchUV( _textureCoords, v1[ Corner::TEXTURE_COORD ] );
+				uv2 = fetchUV( _textureCoords, v2[ Corner::TEXTURE_COORD ] );
+			}
+
+			if ( format.hasTangents() ) {
+				Vector3f dP1 = p1 - p0;
+				Vector3f dP2 = p2 - p0;
+				Vector2f dUV1 = uv1 - uv0;
+				Vector2f dUV2 = uv2 - uv0;
+
+				float r = 1.0f / ( dUV1[ 0 ] * dUV2[ 1 ] - dUV1[ 1 ] * dUV2[ 0 ] );
+				tangent = ( dP1 * dUV2[ 1 ] - dP2 * dUV1[ 1 ] ) * r;
+			}
+
+			if ( format.hasPositions() ) vboPtr->setPositionAt( i + 0, p0 );
+			if ( format.hasNormals() ) vboPtr->setNormalAt( i + 0, n0 );
+			if ( format.hasTangents() ) vboPtr->setTangentAt( i + 0, tangent );
+			if ( format.hasTextureCoords() ) vboPtr->setTextureCoordAt( i + 0, uv0 );
+
+			if ( format.hasPositions() ) vboPtr->setPositionAt( i + 1, p1 );
+			if ( format.hasNormals() ) vboPtr->setNormalAt( i + 1, n1 );
+			if ( format.hasTangents() ) vboPtr->setTangentAt( i + 1, tangent );
+			if ( format.hasTextureCoords() ) vboPtr->setTextureCoordAt( i + 1, uv1 );
+
+			if ( format.hasPositions() ) vboPtr->setPositionAt( i + 2, p2 );
+			if ( format.hasNormals() ) vboPtr->setNormalAt( i + 2, n2 );
+			if ( format.hasTangents() ) vboPtr->setTangentAt( i + 2, tangent );
+			if ( format.hasTextureCoords() ) vboPtr->setTextureCoordAt( i + 2, uv2 );
+		}
+	});
     
-    for ( unsigned int i = 0; i < _faces.size(); i += 3 ) {
-        std::vector< int > v0 = StringUtils::split< int >( _faces[ i + 0 ], '/' );
-        std::vector< int > v1 = StringUtils::split< int >( _faces[ i + 1 ], '/' );
-        std::vector< int > v2 = StringUtils::split< int >( _faces[ i + 2 ], '/' );
-        
-        // this is redundant
-        if ( format.hasPositions() ) {
-            p0 = _positions[ v0[ 0 ] - 1 ];
-            p1 = _positions[ v1[ 0 ] - 1 ];
-            p2 = _positions[ v2[ 0 ] - 1 ];
-        }
-
-        if ( format.hasNormals() ) {
-            n0 = _normals[ v0[ 2 ] - 1 ];
-            n1 = _normals[ v1[ 2 ] - 1 ];
-            n2 = _normals[ v2[ 2 ] - 1 ];
-        }
-        
-        if ( format.hasTextureCoords() ) {
-            uv0 = _textureCoords[ v0[ 1 ] - 1 ];
-            uv1 = _textureCoords[ v1[ 1 ] - 1 ];
-            uv2 = _textureCoords[ v2[ 1 ] - 1 ];
-        }
-        
-        if ( format.hasTangents() ) {
-            Vector3f dP1 = p1 - p0;
-            Vector3f dP2 = p2 - p0;
-            Vector2f dUV1 = uv1 - uv0;
-            Vector2f dUV2 = uv2 - uv0;
-            
-            float r = 1.0f / ( dUV1[ 0 ] * dUV2[ 1 ] - dUV1[ 1 ] * dUV2[ 0 ] );
-            tangent = ( dP1 * dUV2[ 1 ] - dP2 * dUV1[ 1 ] ) * r;
-        }
-        
-        if ( format.hasPositions() ) vbo->setPositionAt( i + 0, p0 );
-        if ( format.hasNormals() ) vbo->setNormalAt( i + 0, n0 );
-        if ( format.hasTangents() ) vbo->setTangentAt( i + 0, tangent );
-        if ( format.hasTextureCoords() ) vbo->setTextureCoordAt( i + 0, uv0 );
-
-        if ( format.hasPositions() ) vbo->setPositionAt( i + 1, p1 );
-        if ( format.hasNormals() ) vbo->setNormalAt( i + 1, n1 );
-        if ( format.hasTangents() ) vbo->setTangentAt( i + 1, tangent );
-        if ( format.hasTextureCoords() ) vbo->setTextureCoordAt( i + 1, uv1 );
-
-        if ( format.hasPositions() ) vbo->setPositionAt( i + 2, p2 );
-        if ( format.hasNormals() ) vbo->setNormalAt( i + 2, n2 );
-        if ( format.hasTangents() ) vbo->setTangentAt( i + 2, tangent );
-        if ( format.hasTextureCoords() ) vbo->setTextureCoordAt( i + 2, uv2 );
-    }
-    
-    auto ibo = crimild::alloc< IndexBufferObject >( VERTEX_COUNT, nullptr );
+    auto ibo = crimild::alloc< IndexBufferObject >( VERTEX_COUNT, IndexBufferObject::getIndexTypeForVertexCount( VERTEX_COUNT ) );
     ibo->generateIncrementalIndices();
 
     auto primitive = crimild::alloc< Primitive >( Primitive::Type::TRIANGLES );
     primitive->setVertexBuffer( vbo );
     primitive->setIndexBuffer( ibo );
 
+    // faces are emitted with one vertex per corner, so weld them
+    // and reorder for the vertex cache before creating the geometry
+    MeshOptimizer::optimize( crimild::get_ptr( primitive ) );
+
 	auto geometry = crimild::alloc< Geometry >( "geometry" );
 	geometry->attachPrimitive( primitive );
 
@@ -243,14 +652,12 @@ void OBJLoader::generateGeometry( void )
 	}
 
 	_currentObject->attachNode( geometry );
-
-	_faces.clear();
 }
 
 SharedPointer< Group > OBJLoader::generateScene( void )
 {
 	// DON'T FORGET THE LAST OBJECT!!
-	generateGeometry();
+	generateGeometry( _faces.size() );
 
 	auto scene = crimild::alloc< Group >( getFileName() );
 	for ( auto obj : _objects ) {
@@ -260,118 +667,124 @@ SharedPointer< Group > OBJLoader::generateScene( void )
 	return scene;
 }
 
-void OBJLoader::readObject( std::stringstream &line )
-{
-	generateGeometry();
-
-	std::string name;
-	line >> name;
-
-    _objects.push_back( crimild::alloc< Group >( name ) );
-    _currentObject = crimild::get_ptr( _objects.back() );
-}
-
-void OBJLoader::readObjectPositions( std::stringstream &line )
-{
-	float x, y, z;
-	line >> x >> y >> z;
-	_positions.push_back( Vector3f( x, y, z ) );
-}
-
-void OBJLoader::readObjectTextureCoords( std::stringstream &line )
-{
-	float s, t;
-	line >> s >> t;
-	_textureCoords.push_back( Vector2f( s, t ) );
-}
-
-void OBJLoader::readObjectNormals( std::stringstream &line ) 
+void OBJLoader::readMaterialFile( std::string fileName )
 {
-	float x, y, z;
-	line >> x >> y >> z;
-	_normals.push_back( Vector3f( x, y, z ) );
-}
+	_sourceFileNames.push_back( fileName );
 
-void OBJLoader::readObjectFaces( std::stringstream &line )
-{
-	std::string f0, f1, f2;
-	line >> f0 >> f1 >> f2;
-	_faces.push_back( f0 );
-	_faces.push_back( f1 );
-	_faces.push_back( f2 );
-}
-
-void OBJLoader::readObjectMaterial( std::stringstream &line )
-{
-	std::string name;
-	line >> name;
-    _currentMaterial = crimild::get_ptr( _materials[ name ] );
-}
-
-void OBJLoader::readMaterialFile( std::stringstream &line )
-{
-    std::string mtlFileName = StringUtils::readFullString( line );
-	std::string mtlFilePath = FileSystem::getInstance().extractDirectory( _fileName ) + "/" + mtlFileName;
+	MappedFile file( fileName );
+	if ( !file.isOpen() ) {
+        Log::error( CRIMILD_CURRENT_CLASS_NAME, "Cannot load file ", fileName );
+		return;
+	}
 
-	getMTLProcessor().readFile( mtlFilePath );
-	_currentMaterial = nullptr;
+	// material libraries are small, so there's no need to split them
+	const char *it = reinterpret_cast< const char * >( file.getData() );
+	const char *end = it + file.getSize();
+	while ( it < end ) {
+		it = skipSpaces( it, end );
+
+		const char *lineEnd = static_cast< const char * >( memchr( it, '\n', end - it ) );
+		if ( lineEnd == nullptr ) {
+			lineEnd = end;
+		}
+
+		const char *keyword = it;
+		it = skipToken( it, lineEnd );
+		const auto length = it - keyword;
+
+		if ( matches( keyword, length, "newmtl" ) ) {
+			readMaterialName( it, lineEnd );
+		}
+		else if ( _currentMaterial == nullptr ) {
+			// properties without a material. ignore
+		}
+		else if ( matches( keyword, length, "ka" ) ) {
+			readMaterialAmbient( it, lineEnd );
+		}
+		else if ( matches( keyword, length, "kd" ) ) {
+			readMaterialDiffuse( it, lineEnd );
+		}
+		else if ( matches( keyword, length, "ks" ) ) {
+			readMaterialSpecular( it, lineEnd );
+		}
+		else if ( matches( keyword, length, "map_kd" ) ) {
+			readMaterialColorMap( it, lineEnd );
+		}
+		else if ( matches( keyword, length, "map_bump" ) ) {
+			readMaterialNormalMap( it, lineEnd );
+		}
+		else if ( matches( keyword, length, "map_ks" ) ) {
+			readMaterialSpecularMap( it, lineEnd );
+		}
+		else if ( matches( keyword, length, "map_ke" ) ) {
+			readMaterialEmissiveMap( it, lineEnd );
+		}
+		else if ( matches( keyword, length, "illum" ) ) {
+			readMaterialShaderProgram( it, lineEnd );
+		}
+		else if ( matches( keyword, length, "d" ) || matches( keyword, length, "tr" ) ) {
+			readMaterialTranslucency( it, lineEnd );
+		}
+
+		it = lineEnd + 1;
+	}
 }
 
-void OBJLoader::readMaterialName( std::stringstream &line )
+void OBJLoader::readMaterialName( const char *it, const char *end )
 {
-	std::string name;
-	line >> name;
+	auto name = readToken( it, end );
 
     auto tmp =  crimild::alloc< Material >() ;
     _materials[ name ] = tmp;
     _currentMaterial = crimild::get_ptr( tmp );
 }
 
-void OBJLoader::readMaterialAmbient( std::stringstream &line )
+void OBJLoader::readMaterialAmbient( const char *it, const char *end )
 {
-	float r, g, b;
-	line >> r >> g >> b;
+	float r = 0.0f, g = 0.0f, b = 0.0f;
+	parseFloat( it, end, r ) && parseFloat( it, end, g ) && parseFloat( it, end, b );
 	_currentMaterial->setAmbient( RGBAColorf( r, g, b, 1.0f ) );
 }
 
-void OBJLoader::readMaterialDiffuse( std::stringstream &line )
+void OBJLoader::readMaterialDiffuse( const char *it, const char *end )
 {
-	float r, g, b;
-	line >> r >> g >> b;
+	float r = 0.0f, g = 0.0f, b = 0.0f;
+	parseFloat( it, end, r ) && parseFloat( it, end, g ) && parseFloat( it, end, b );
 	_currentMaterial->setDiffuse( RGBAColorf( r, g, b, 1.0f ) );
 }
 
-void OBJLoader::readMaterialSpecular( std::stringstream &line )
+void OBJLoader::readMaterialSpecular( const char *it, const char *end )
 {
-	float r, g, b;
-	line >> r >> g >> b;
+	float r = 0.0f, g = 0.0f, b = 0.0f;
+	parseFloat( it, end, r ) && parseFloat( it, end, g ) && parseFloat( it, end, b );
 	_currentMaterial->setSpecular( RGBAColorf( r, g, b, 1.0f ) );
 }
 
-void OBJLoader::readMaterialColorMap( std::stringstream &line )
+void OBJLoader::readMaterialColorMap( const char *it, const char *end )
 {
-    _currentMaterial->setColorMap( loadTexture( StringUtils::readFullString( line ) ) );
+    _currentMaterial->setColorMap( loadTexture( readFullString( it, end ) ) );
 }
 
-void OBJLoader::readMaterialNormalMap( std::stringstream &line )
+void OBJLoader::readMaterialNormalMap( const char *it, const char *end )
 {
-	_currentMaterial->setNormalMap( loadTexture( StringUtils::readFullString( line ) ) );
+	_currentMaterial->setNormalMap( loadTexture( readFullString( it, end ) ) );
 }
 
-void OBJLoader::readMaterialSpecularMap( std::stringstream &line )
+void OBJLoader::readMaterialSpecularMap( const char *it, const char *end )
 {
-	_currentMaterial->setSpecularMap( loadTexture( StringUtils::readFullString( line ) ) );
+	_currentMaterial->setSpecularMap( loadTexture( readFullString( it, end ) ) );
 }
 
-void OBJLoader::readMaterialEmissiveMap( std::stringstream &line )
+void OBJLoader::readMaterialEmissiveMap( const char *it, const char *end )
 {
-    _currentMaterial->setEmissiveMap( loadTexture( StringUtils::readFullString( line ) ) );
+    _currentMaterial->setEmissiveMap( loadTexture( readFullString( it, end ) ) );
 }
 
-void OBJLoader::readMaterialShaderProgram( std::stringstream &line )
+void OBJLoader::readMaterialShaderProgram( const char *it, const char *end )
 {
-	int illumLevel;
-	line >> illumLevel;
+	crimild::Int32 illumLevel = -1;
+	it = skipSpaces( it, end );
+	parseInt( it, end, illumLevel );
 
 	switch ( illumLevel ) {
 	    case 0:
@@ -396,10 +809,10 @@ void OBJLoader::readMaterialShaderProgram( std::stringstream &line )
     };
 }
 
-void OBJLoader::readMaterialTranslucency( std::stringstream &line )
+void OBJLoader::readMaterialTranslucency( const char *it, const char *end )
 {
-    float translucency;
-    line >> translucency;
+    float translucency = 1.0f;
+    parseFloat( it, end, translucency );
     
     if ( translucency < 1.0f ) {
         _currentMaterial->getAlphaState()->setEnabled( true );
@@ -414,7 +827,9 @@ SharedPointer< Texture > OBJLoader::loadTexture( std::string textureFileName )
 	if ( textureFileName == "" ) {
 		return nullptr;
 	}
-    auto image = crimild::alloc< ImageTGA >( FileSystem::getInstance().extractDirectory( _fileName ) + "/" + textureFileName );
+	auto imageFileName = FileSystem::getInstance().extractDirectory( _fileName ) + "/" + textureFileName;
+	_sourceFileNames.push_back( imageFileName );
+    auto image = crimild::alloc< ImageTGA >( imageFileName );
     auto texture = crimild::alloc< Texture >( image );
     return texture;
 }
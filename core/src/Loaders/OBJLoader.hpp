@@ -39,75 +39,134 @@
 #include <map>
 #include <string>
 #include <vector>
-#include <fstream>
 
 namespace crimild {
 
-	class OBJLoader : public NonCopyable {
-	private:
-		class FileProcessor {
-		private:
-			using LineProcessor = std::function< void( std::stringstream &line ) >;
-
-		public:
-			FileProcessor( void );
-			~FileProcessor( void );
+	/**
+		\brief Loads Wavefront OBJ files and their MTL libraries
 
-			void readFile( std::string fileName );
+		Files are memory mapped and split into chunks at line boundaries.
+		If the JobScheduler is running, chunks are parsed in parallel and
+		merged in order afterwards, so the resulting scene is the same
+		no matter how many workers are used.
 
-			void registerLineProcessor( std::string type, LineProcessor lineProcessor );
-
-		private:
-			std::string getLine( std::ifstream &input );
-			void processLine( std::ifstream &input );
-
-		private:
-			std::map< std::string, LineProcessor > _lineProcessors;
-		};
+		If the cache is enabled, the parsed scene is stored in a SceneCache
+		next to the source file and reused on later loads as long as 
+		neither the OBJ file nor its materials and textures change.
 
+		\remarks Only the first three corners of each face are used
+	*/
+	class OBJLoader : public NonCopyable {
 	public:
 		explicit OBJLoader( std::string fileName );
 		~OBJLoader( void );
 
 		SharedPointer< Group > load( void );
 
+		/**
+			\brief Minimum number of bytes per chunk
+
+			Smaller files are parsed in a single job
+		*/
+		void setMinChunkSize( crimild::Size size ) { _minChunkSize = size; }
+		crimild::Size getMinChunkSize( void ) const { return _minChunkSize; }
+
+		/**
+			\brief Enables reading and writing a scene cache
+
+			Disabled by default, since the cache is written next to the
+			source file and asset directories may be read-only
+		*/
+		void setCacheEnabled( bool enabled ) { _cacheEnabled = enabled; }
+		bool isCacheEnabled( void ) const { return _cacheEnabled; }
+
 	private:
 		const std::string &getFileName( void ) const { return _fileName; }
 
-		FileProcessor &getOBJProcessor( void ) { return _objProcessor; }
-		FileProcessor &getMTLProcessor( void ) { return _mtlProcessor; }
-
 		void reset( void );
+		bool parse( void );
 		SharedPointer< Group > generateScene( void );
 
-		void generateGeometry( void );
-
-        void readObject( std::stringstream &line );
-		void readObjectPositions( std::stringstream &line );
-		void readObjectNormals( std::stringstream &line );
-		void readObjectTextureCoords( std::stringstream &line );
-		void readObjectFaces( std::stringstream &line );
-		void readObjectMaterial( std::stringstream &line );
-
-		void readMaterialFile( std::stringstream &line );
-		void readMaterialName( std::stringstream &line );
-		void readMaterialAmbient( std::stringstream &line );
-		void readMaterialDiffuse( std::stringstream &line );
-		void readMaterialSpecular( std::stringstream &line );
-		void readMaterialColorMap( std::stringstream &line );
-		void readMaterialNormalMap( std::stringstream &line );
-		void readMaterialSpecularMap( std::stringstream &line );
-		void readMaterialEmissiveMap( std::stringstream &line );
-		void readMaterialShaderProgram( std::stringstream &line );
-        void readMaterialTranslucency( std::stringstream &line );
+		void generateGeometry( crimild::Size faceEnd );
+
+	private:
+		/**
+			\brief Indices for a face corner, as found in the file
+
+			Negative (relative) indices are resolved while parsing against
+			the chunk's own data and flagged, so they can be offset once
+			all chunks are merged.
+		*/
+		struct Corner {
+			enum Component {
+				POSITION = 0,
+				TEXTURE_COORD,
+				NORMAL
+			};
+
+			crimild::Int32 indices[ 3 ];
+			crimild::UInt8 relative;
+		};
+
+		/**
+			\brief Any statement that changes the loader state
+
+			Counts indicate how much data was parsed in the chunk before
+			this command was found.
+		*/
+		struct Command {
+			enum class Type : uint8_t {
+				OBJECT,
+				MATERIAL,
+				MATERIAL_LIBRARY
+			};
+
+			Type type;
+			std::string argument;
+			crimild::Size positionCount;
+			crimild::Size textureCoordCount;
+			crimild::Size normalCount;
+			crimild::Size cornerCount;
+		};
+
+		struct Chunk {
+			const char *begin;
+			const char *end;
+
+			std::vector< Vector3f > positions;
+			std::vector< Vector2f > textureCoords;
+			std::vector< Vector3f > normals;
+			std::vector< Corner > corners;
+			std::vector< Command > commands;
+		};
+
+		static void parseChunk( Chunk &chunk );
+		void mergeChunks( std::vector< Chunk > &chunks );
+
+	private:
+		void readMaterialFile( std::string fileName );
+		void readMaterialName( const char *it, const char *end );
+		void readMaterialAmbient( const char *it, const char *end );
+		void readMaterialDiffuse( const char *it, const char *end );
+		void readMaterialSpecular( const char *it, const char *end );
+		void readMaterialColorMap( const char *it, const char *end );
+		void readMaterialNormalMap( const char *it, const char *end );
+		void readMaterialSpecularMap( const char *it, const char *end );
+		void readMaterialEmissiveMap( const char *it, const char *end );
+		void readMaterialShaderProgram( const char *it, const char *end );
+		void readMaterialTranslucency( const char *it, const char *end );
         
         SharedPointer< Texture > loadTexture( std::string fileName );
 
 	private:
 		std::string _fileName;
+		crimild::Size _minChunkSize = 1024 * 1024;
+		bool _cacheEnabled = false;
 
-		FileProcessor _objProcessor;
-		FileProcessor _mtlProcessor;
+		/**
+			\brief Every file read while loading, used to validate the cache
+		*/
+		std::vector< std::string > _sourceFileNames;
 
 		std::list< SharedPointer< Group > > _objects;
 		Group *_currentObject = nullptr;
@@ -118,7 +177,19 @@ namespace crimild {
 		std::vector< Vector3f > _positions;
 		std::vector< Vector2f > _textureCoords;
 		std::vector< Vector3f > _normals;
-        std::vector< std::string > _faces;
+		std::vector< Corner > _faces;
+
+		/**
+			\name Parsing state
+
+			Amount of data read up to the current command
+		*/
+		//@{
+		crimild::Size _positionCount = 0;
+		crimild::Size _textureCoordCount = 0;
+		crimild::Size _normalCount = 0;
+		crimild::Size _faceBegin = 0;
+		//@}
 	};
 
 }
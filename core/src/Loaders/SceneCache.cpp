@@ -0,0 +1,1034 @@
+/*
+ * Copyright (c) 2013, Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "SceneCache.hpp"
+
+#include "SceneGraph/Geometry.hpp"
+#include "Primitives/Primitive.hpp"
+#include "Components/MaterialComponent.hpp"
+#include "Components/RenderStateComponent.hpp"
+#include "Rendering/Material.hpp"
+#include "Rendering/Texture.hpp"
+#include "Rendering/Image.hpp"
+#include "Rendering/Renderer.hpp"
+#include "Animation/Skeleton.hpp"
+#include "Coding/MemoryEncoder.hpp"
+#include "Coding/MemoryDecoder.hpp"
+#include "Foundation/MappedFile.hpp"
+#include "Foundation/Log.hpp"
+#include "Simulation/AssetManager.hpp"
+
+#include <sys/stat.h>
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <map>
+
+using namespace crimild;
+
+namespace crimild {
+
+	namespace scene_cache {
+
+		// "CRMC" when read as little endian
+		static const crimild::UInt32 MAGIC = 0x434d5243;
+		static const crimild::UInt32 VERSION = 1;
+		static const crimild::UInt32 BYTE_ORDER_MARK = 0x01020304;
+		static const crimild::UInt32 NONE = 0xffffffff;
+		static const crimild::Size ALIGNMENT = 16;
+
+		enum Section {
+			SECTION_SOURCES = 0,
+			SECTION_STRINGS,
+			SECTION_NODES,
+			SECTION_PRIMITIVES,
+			SECTION_MATERIALS,
+			SECTION_MATERIAL_REFS,
+			SECTION_TEXTURES,
+			SECTION_IMAGES,
+			SECTION_JOINTS,
+			SECTION_SKELETONS,
+			SECTION_BLOBS,
+			SECTION_COUNT
+		};
+
+		/**
+		   \name File records
+
+		   All records have fixed size and are read in place from the
+		   mapped file. Offsets in sections are relative to the start
+		   of the file, while blob offsets are relative to the blobs
+		   section
+		 */
+		//@{
+
+		struct SectionInfo {
+			crimild::UInt64 offset;
+			crimild::UInt64 count;
+		};
+
+		struct Header {
+			crimild::UInt32 magic;
+			crimild::UInt32 version;
+			crimild::UInt32 byteOrder;
+			crimild::UInt32 reserved;
+			crimild::UInt64 fileSize;
+			SectionInfo sections[ SECTION_COUNT ];
+		};
+
+		struct StringRef {
+			crimild::UInt32 offset;
+			crimild::UInt32 length;
+		};
+
+		struct BlobRef {
+			crimild::UInt64 offset;
+			crimild::UInt64 size;
+		};
+
+		struct TransformRecord {
+			crimild::Real32 translate[ 3 ];
+			crimild::Real32 rotate[ 4 ];
+			crimild::Real32 scale;
+		};
+
+		struct SourceRecord {
+			StringRef path;
+			crimild::UInt64 size;
+			crimild::Int64 modified;
+			crimild::UInt64 hash;
+		};
+
+		struct NodeRecord {
+			enum Type : crimild::UInt32 {
+				GROUP,
+				GEOMETRY
+			};
+
+			enum Flags : crimild::UInt32 {
+				ENABLED = 1 << 0
+			};
+
+			StringRef name;
+			crimild::UInt32 parent;
+			crimild::UInt32 type;
+			crimild::UInt32 flags;
+			crimild::UInt32 joint;
+			crimild::UInt32 skeleton;
+			crimild::UInt32 reserved;
+			TransformRecord local;
+			crimild::UInt32 firstPrimitive;
+			crimild::UInt32 primitiveCount;
+			crimild::UInt32 firstMaterial;
+			crimild::UInt32 materialCount;
+		};
+
+		struct PrimitiveRecord {
+			crimild::UInt32 type;
+			crimild::UInt32 indexType;
+			crimild::UInt8 format[ 8 ];
+			crimild::UInt64 vertexCount;
+			crimild::UInt64 indexCount;
+			BlobRef vertices;
+			BlobRef indices;
+		};
+
+		struct MaterialRecord {
+			enum Flags : crimild::UInt32 {
+				CAST_SHADOWS = 1 << 0,
+				RECEIVE_SHADOWS = 1 << 1,
+				ALPHA_ENABLED = 1 << 2,
+				CULL_FACE_ENABLED = 1 << 3
+			};
+
+			crimild::Real32 ambient[ 4 ];
+			crimild::Real32 diffuse[ 4 ];
+			crimild::Real32 specular[ 4 ];
+			crimild::Real32 shininess;
+			crimild::Real32 emissive;
+			crimild::UInt32 flags;
+			crimild::UInt8 srcBlendFunc;
+			crimild::UInt8 dstBlendFunc;
+			crimild::UInt8 reserved[ 2 ];
+			StringRef program;
+			crimild::UInt32 colorMap;
+			crimild::UInt32 normalMap;
+			crimild::UInt32 specularMap;
+			crimild::UInt32 emissiveMap;
+		};
+
+		struct TextureRecord {
+			StringRef name;
+			crimild::UInt32 image;
+			crimild::UInt8 wrapMode;
+			crimild::UInt8 minFilter;
+			crimild::UInt8 magFilter;
+			crimild::UInt8 reserved;
+		};
+
+		struct ImageRecord {
+			crimild::Int32 width;
+			crimild::Int32 height;
+			crimild::Int32 bpp;
+			crimild::UInt32 pixelFormat;
+			crimild::UInt32 pixelType;
+			crimild::UInt32 reserved;
+			BlobRef data;
+		};
+
+		struct JointRecord {
+			StringRef name;
+			crimild::UInt32 id;
+			crimild::UInt32 reserved;
+			TransformRecord offset;
+		};
+
+		struct SkeletonRecord {
+			BlobRef data;
+		};
+
+		//@}
+
+		/**
+		   \brief Shader programs that can be referenced by materials
+
+		   Programs are not stored in the cache. Only their names are, so
+		   they can be retrieved from the AssetManager when reading.
+		 */
+		static const char *BUILTIN_PROGRAMS[] = {
+			Renderer::SHADER_PROGRAM_LIT_TEXTURE,
+			Renderer::SHADER_PROGRAM_LIT_DIFFUSE,
+			Renderer::SHADER_PROGRAM_UNLIT_TEXTURE,
+			Renderer::SHADER_PROGRAM_UNLIT_DIFFUSE,
+			Renderer::SHADER_PROGRAM_UNLIT_VERTEX_COLOR,
+		};
+
+		static crimild::Size align( crimild::Size value )
+		{
+			return ( value + ALIGNMENT - 1 ) & ~( ALIGNMENT - 1 );
+		}
+
+		static void encodeTransform( const Transformation &t, TransformRecord &record )
+		{
+			for ( int i = 0; i < 3; i++ ) {
+				record.translate[ i ] = t.getTranslate()[ i ];
+			}
+			for ( int i = 0; i < 4; i++ ) {
+				record.rotate[ i ] = t.getRotate().getRawData()[ i ];
+			}
+			record.scale = t.getScale();
+		}
+
+		static void decodeTransform( const TransformRecord &record, Transformation &t )
+		{
+			t.setTranslate( Vector3f( record.translate[ 0 ], record.translate[ 1 ], record.translate[ 2 ] ) );
+			t.setRotate( Quaternion4f( Vector4f( record.rotate[ 0 ], record.rotate[ 1 ], record.rotate[ 2 ], record.rotate[ 3 ] ) ) );
+			t.setScale( record.scale );
+		}
+
+		static void encodeColor( const RGBAColorf &color, crimild::Real32 *out )
+		{
+			for ( int i = 0; i < 4; i++ ) {
+				out[ i ] = color[ i ];
+			}
+		}
+
+		/**
+		   \brief Size and modification time for a file
+
+		   \returns false if the file does not exist
+		 */
+		static bool getFileStats( std::string fileName, crimild::UInt64 &size, crimild::Int64 &modified )
+		{
+			struct stat info;
+			if ( stat( fileName.c_str(), &info ) != 0 ) {
+				return false;
+			}
+
+			size = info.st_size;
+			modified = info.st_mtime;
+			return true;
+		}
+
+		static crimild::UInt64 hashFile( std::string fileName )
+		{
+			MappedFile file( fileName );
+			if ( !file.isOpen() ) {
+				return 0;
+			}
+			return SceneCache::computeHash( file.getData(), file.getSize() );
+		}
+
+		/**
+		   \brief Collects all records for a scene before writing them
+		 */
+		class Writer {
+		public:
+			bool addSources( const std::vector< std::string > &sourceFileNames )
+			{
+				for ( const auto &fileName : sourceFileNames ) {
+					SourceRecord record;
+					memset( &record, 0, sizeof( SourceRecord ) );
+					record.path = addString( fileName );
+					if ( getFileStats( fileName, record.size, record.modified ) ) {
+						record.hash = hashFile( fileName );
+					}
+					else {
+						// missing sources are valid as long as they remain missing
+						record.size = NONE;
+					}
+					_sources.push_back( record );
+				}
+				return true;
+			}
+
+			bool addNode( Node *node, crimild::UInt32 parent )
+			{
+				const auto nodeIndex = static_cast< crimild::UInt32 >( _nodes.size() );
+
+				NodeRecord record;
+				memset( &record, 0, sizeof( NodeRecord ) );
+				record.name = addString( node->getName() );
+				record.parent = parent;
+				record.flags = node->isEnabled() ? NodeRecord::ENABLED : 0;
+				record.joint = NONE;
+				record.skeleton = NONE;
+				record.firstMaterial = _materialRefs.size();
+				record.firstPrimitive = _primitives.size();
+				encodeTransform( node->getLocal(), record.local );
+
+				const std::string className = node->getClassName();
+				if ( className == Group::__CLASS_NAME ) {
+					record.type = NodeRecord::GROUP;
+				}
+				else if ( className == Geometry::__CLASS_NAME ) {
+					record.type = NodeRecord::GEOMETRY;
+				}
+				else {
+					Log::debug( CRIMILD_CURRENT_CLASS_NAME, "Cannot cache nodes of type ", className );
+					return false;
+				}
+
+				bool supported = true;
+				node->forEachComponent( [ this, &record, &supported ]( NodeComponent *component ) {
+					const std::string componentName = component->getClassName();
+					if ( componentName == MaterialComponent::__CLASS_NAME ) {
+						static_cast< MaterialComponent * >( component )->forEachMaterial( [ this, &record, &supported ]( Material *material ) {
+							auto index = addMaterial( material );
+							supported &= index != NONE;
+							_materialRefs.push_back( index );
+							record.materialCount++;
+						});
+					}
+					else if ( componentName == RenderStateComponent::__CLASS_NAME ) {
+						// computed when updating render states
+					}
+					else if ( componentName == animation::Joint::__CLASS_NAME ) {
+						record.joint = addJoint( static_cast< animation::Joint * >( component ) );
+					}
+					else if ( componentName == animation::Skeleton::__CLASS_NAME ) {
+						record.skeleton = addSkeleton( static_cast< animation::Skeleton * >( component ) );
+					}
+					else {
+						Log::debug( CRIMILD_CURRENT_CLASS_NAME, "Cannot cache components of type ", componentName );
+						supported = false;
+					}
+				});
+
+				if ( !supported ) {
+					return false;
+				}
+
+				if ( record.type == NodeRecord::GEOMETRY ) {
+					static_cast< Geometry * >( node )->forEachPrimitive( [ this, &record ]( Primitive *primitive ) {
+						addPrimitive( primitive );
+						record.primitiveCount++;
+					});
+				}
+
+				_nodes.push_back( record );
+
+				if ( record.type == NodeRecord::GROUP ) {
+					auto group = static_cast< Group * >( node );
+					for ( crimild::Size i = 0; i < group->getNodeCount(); i++ ) {
+						if ( !addNode( group->getNodeAt( i ), nodeIndex ) ) {
+							return false;
+						}
+					}
+				}
+
+				return true;
+			}
+
+			bool save( std::string fileName )
+			{
+				Header header;
+				memset( &header, 0, sizeof( Header ) );
+				header.magic = MAGIC;
+				header.version = VERSION;
+				header.byteOrder = BYTE_ORDER_MARK;
+
+				std::vector< crimild::Byte > out( align( sizeof( Header ) ) );
+				auto addSection = [ &out, &header ]( Section section, const void *data, crimild::Size count, crimild::Size recordSize ) {
+					auto offset = out.size();
+					header.sections[ section ].offset = offset;
+					header.sections[ section ].count = count;
+					out.resize( align( offset + count * recordSize ) );
+					if ( count > 0 ) {
+						memcpy( &out[ offset ], data, count * recordSize );
+					}
+				};
+
+				addSection( SECTION_SOURCES, _sources.data(), _sources.size(), sizeof( SourceRecord ) );
+				addSection( SECTION_STRINGS, _strings.data(), _strings.size(), 1 );
+				addSection( SECTION_NODES, _nodes.data(), _nodes.size(), sizeof( NodeRecord ) );
+				addSection( SECTION_PRIMITIVES, _primitives.data(), _primitives.size(), sizeof( PrimitiveRecord ) );
+				addSection( SECTION_MATERIALS, _materials.data(), _materials.size(), sizeof( MaterialRecord ) );
+				addSection( SECTION_MATERIAL_REFS, _materialRefs.data(), _materialRefs.size(), sizeof( crimild::UInt32 ) );
+				addSection( SECTION_TEXTURES, _textures.data(), _textures.size(), sizeof( TextureRecord ) );
+				addSection( SECTION_IMAGES, _images.data(), _images.size(), sizeof( ImageRecord ) );
+				addSection( SECTION_JOINTS, _joints.data(), _joints.size(), sizeof( JointRecord ) );
+				addSection( SECTION_SKELETONS, _skeletons.data(), _skeletons.size(), sizeof( SkeletonRecord ) );
+				addSection( SECTION_BLOBS, _blobs.data(), _blobs.size(), 1 );
+
+				header.fileSize = out.size();
+				memcpy( &out[ 0 ], &header, sizeof( Header ) );
+
+				// Write to a temporary file first, so no one reads an incomplete cache
+				auto tmpFileName = fileName + ".tmp";
+				{
+					std::ofstream output( tmpFileName, std::ios::binary | std::ios::trunc );
+					if ( !output.is_open() ) {
+						return false;
+					}
+					output.write( reinterpret_cast< const char * >( out.data() ), out.size() );
+					if ( !output.good() ) {
+						output.close();
+						std::remove( tmpFileName.c_str() );
+						return false;
+					}
+				}
+
+				std::remove( fileName.c_str() );
+				if ( std::rename( tmpFileName.c_str(), fileName.c_str() ) != 0 ) {
+					std::remove( tmpFileName.c_str() );
+					return false;
+				}
+
+				return true;
+			}
+
+		private:
+			StringRef addString( const std::string &str )
+			{
+				StringRef ref;
+				ref.offset = _strings.size();
+				ref.length = str.length();
+				_strings.insert( _strings.end(), str.begin(), str.end() );
+				return ref;
+			}
+
+			BlobRef addBlob( const void *data, crimild::Size size )
+			{
+				BlobRef ref;
+				ref.offset = _blobs.size();
+				ref.size = size;
+				_blobs.resize( align( ref.offset + size ) );
+				if ( size > 0 ) {
+					memcpy( &_blobs[ ref.offset ], data, size );
+				}
+				return ref;
+			}
+
+			void addPrimitive( Primitive *primitive )
+			{
+				PrimitiveRecord record;
+				memset( &record, 0, sizeof( PrimitiveRecord ) );
+				record.type = static_cast< crimild::UInt32 >( primitive->getType() );
+
+				auto vbo = primitive->getVertexBuffer();
+				if ( vbo != nullptr ) {
+					const auto &format = vbo->getVertexFormat();
+					record.format[ 0 ] = format.getPositionComponents();
+					record.format[ 1 ] = format.getColorComponents();
+					record.format[ 2 ] = format.getNormalComponents();
+					record.format[ 3 ] = format.getTangentComponents();
+					record.format[ 4 ] = format.getTextureCoordComponents();
+					record.format[ 5 ] = format.getBoneIdComponents();
+					record.format[ 6 ] = format.getBoneWeightComponents();
+					record.vertexCount = vbo->getVertexCount();
+					if ( vbo->getSizeInBytes() > 0 ) {
+						record.vertices = addBlob( vbo->getData(), vbo->getSizeInBytes() );
+					}
+				}
+
+				auto ibo = primitive->getIndexBuffer();
+				if ( ibo != nullptr ) {
+					record.indexType = static_cast< crimild::UInt32 >( ibo->getIndexType() );
+					record.indexCount = ibo->getIndexCount();
+					if ( ibo->getSizeInBytes() > 0 ) {
+						record.indices = addBlob( ibo->getData(), ibo->getSizeInBytes() );
+					}
+				}
+
+				_primitives.push_back( record );
+			}
+
+			crimild::UInt32 addMaterial( Material *material )
+			{
+				if ( _materialIndices.count( material ) ) {
+					return _materialIndices[ material ];
+				}
+
+				MaterialRecord record;
+				memset( &record, 0, sizeof( MaterialRecord ) );
+				encodeColor( material->getAmbient(), record.ambient );
+				encodeColor( material->getDiffuse(), record.diffuse );
+				encodeColor( material->getSpecular(), record.specular );
+				record.shininess = material->getShininess();
+				record.emissive = material->getEmissive();
+				record.flags |= material->castShadows() ? MaterialRecord::CAST_SHADOWS : 0;
+				record.flags |= material->receiveShadows() ? MaterialRecord::RECEIVE_SHADOWS : 0;
+				if ( auto alphaState = material->getAlphaState() ) {
+					record.flags |= alphaState->isEnabled() ? MaterialRecord::ALPHA_ENABLED : 0;
+					record.srcBlendFunc = static_cast< crimild::UInt8 >( alphaState->getSrcBlendFunc() );
+					record.dstBlendFunc = static_cast< crimild::UInt8 >( alphaState->getDstBlendFunc() );
+				}
+				if ( auto cullFaceState = material->getCullFaceState() ) {
+					record.flags |= cullFaceState->isEnabled() ? MaterialRecord::CULL_FACE_ENABLED : 0;
+				}
+
+				if ( auto program = material->getProgram() ) {
+					std::string programName;
+					if ( AssetManager::hasInstance() ) {
+						for ( auto name : BUILTIN_PROGRAMS ) {
+							if ( AssetManager::getInstance()->get< ShaderProgram >( name ) == program ) {
+								programName = name;
+								break;
+							}
+						}
+					}
+					if ( programName == "" ) {
+						Log::debug( CRIMILD_CURRENT_CLASS_NAME, "Cannot cache materials with custom shader programs" );
+						return NONE;
+					}
+					record.program = addString( programName );
+				}
+
+				record.colorMap = addTexture( material->getColorMap() );
+				record.normalMap = addTexture( material->getNormalMap() );
+				record.specularMap = addTexture( material->getSpecularMap() );
+				record.emissiveMap = addTexture( material->getEmissiveMap() );
+
+				auto index = static_cast< crimild::UInt32 >( _materials.size() );
+				_materials.push_back( record );
+				_materialIndices[ material ] = index;
+				return index;
+			}
+
+			crimild::UInt32 addTexture( Texture *texture )
+			{
+				if ( texture == nullptr ) {
+					return NONE;
+				}
+
+				if ( _textureIndices.count( texture ) ) {
+					return _textureIndices[ texture ];
+				}
+
+				TextureRecord record;
+				memset( &record, 0, sizeof( TextureRecord ) );
+				record.name = addString( texture->getName() );
+				record.image = addImage( texture->getImage() );
+				record.wrapMode = static_cast< crimild::UInt8 >( texture->getWrapMode() );
+				record.minFilter = static_cast< crimild::UInt8 >( texture->getMinFilter() );
+				record.magFilter = static_cast< crimild::UInt8 >( texture->getMagFilter() );
+
+				auto index = static_cast< crimild::UInt32 >( _textures.size() );
+				_textures.push_back( record );
+				_textureIndices[ texture ] = index;
+				return index;
+			}
+
+			crimild::UInt32 addImage( Image *image )
+			{
+				if ( image == nullptr ) {
+					return NONE;
+				}
+
+				if ( _imageIndices.count( image ) ) {
+					return _imageIndices[ image ];
+				}
+
+				// Images are stored decoded
+				if ( !image->isLoaded() ) {
+					image->load();
+				}
+
+				ImageRecord record;
+				memset( &record, 0, sizeof( ImageRecord ) );
+				record.width = image->getWidth();
+				record.height = image->getHeight();
+				record.bpp = image->getBpp();
+				record.pixelFormat = static_cast< crimild::UInt32 >( image->getPixelFormat() );
+				record.pixelType = static_cast< crimild::UInt32 >( image->getPixelType() );
+				if ( image->isLoaded() ) {
+					record.data = addBlob( image->getData(), image->getDataSize() );
+				}
+
+				auto index = static_cast< crimild::UInt32 >( _images.size() );
+				_images.push_back( record );
+				_imageIndices[ image ] = index;
+				return index;
+			}
+
+			crimild::UInt32 addJoint( animation::Joint *joint )
+			{
+				JointRecord record;
+				memset( &record, 0, sizeof( JointRecord ) );
+				record.name = addString( joint->getName() );
+				record.id = joint->getId();
+				encodeTransform( joint->getOffset(), record.offset );
+
+				auto index = static_cast< crimild::UInt32 >( _joints.size() );
+				_joints.push_back( record );
+				return index;
+			}
+
+			crimild::UInt32 addSkeleton( animation::Skeleton *skeleton )
+			{
+				// Clips are complex enough to use the regular encoder
+				coding::MemoryEncoder encoder;
+				encoder.encode( crimild::retain( skeleton ) );
+				auto bytes = encoder.getBytes();
+
+				SkeletonRecord record;
+				record.data = addBlob( bytes.getData(), bytes.size() );
+
+				auto index = static_cast< crimild::UInt32 >( _skeletons.size() );
+				_skeletons.push_back( record );
+				return index;
+			}
+
+		private:
+			std::vector< SourceRecord > _sources;
+			std::vector< char > _strings;
+			std::vector< NodeRecord > _nodes;
+			std::vector< PrimitiveRecord > _primitives;
+			std::vector< MaterialRecord > _materials;
+			std::vector< crimild::UInt32 > _materialRefs;
+			std::vector< TextureRecord > _textures;
+			std::vector< ImageRecord > _images;
+			std::vector< JointRecord > _joints;
+			std::vector< SkeletonRecord > _skeletons;
+			std::vector< crimild::Byte > _blobs;
+
+			std::map< Material *, crimild::UInt32 > _materialIndices;
+			std::map< Texture *, crimild::UInt32 > _textureIndices;
+			std::map< Image *, crimild::UInt32 > _imageIndices;
+		};
+
+		/**
+		   \brief Resolves records from a mapped cache file
+
+		   Every offset is validated before use, so a corrupted file
+		   is rejected instead of crashing
+		 */
+		class Reader {
+		public:
+			explicit Reader( const MappedFile &file )
+				: _data( file.getData() ),
+				  _size( file.getSize() )
+			{
+
+			}
+
+			bool validate( void )
+			{
+				if ( _size < sizeof( Header ) ) {
+					return false;
+				}
+
+				_header = reinterpret_cast< const Header * >( _data );
+				if ( _header->magic != MAGIC || _header->version != VERSION || _header->byteOrder != BYTE_ORDER_MARK || _header->fileSize != _size ) {
+					return false;
+				}
+
+				const crimild::Size recordSizes[ SECTION_COUNT ] = {
+					sizeof( SourceRecord ),
+					1,
+					sizeof( NodeRecord ),
+					sizeof( PrimitiveRecord ),
+					sizeof( MaterialRecord ),
+					sizeof( crimild::UInt32 ),
+					sizeof( TextureRecord ),
+					sizeof( ImageRecord ),
+					sizeof( JointRecord ),
+					sizeof( SkeletonRecord ),
+					1,
+				};
+
+				for ( int i = 0; i < SECTION_COUNT; i++ ) {
+					const auto &section = _header->sections[ i ];
+					if ( section.offset % ALIGNMENT != 0 || section.offset > _size || section.count > ( _size - section.offset ) / recordSizes[ i ] ) {
+						return false;
+					}
+				}
+
+				return true;
+			}
+
+			bool sourcesChanged( void ) const
+			{
+				auto sources = getRecords< SourceRecord >( SECTION_SOURCES );
+				for ( crimild::Size i = 0; i < getCount( SECTION_SOURCES ); i++ ) {
+					const auto &source = sources[ i ];
+					auto fileName = getString( source.path );
+
+					crimild::UInt64 size = 0;
+					crimild::Int64 modified = 0;
+					auto exists = getFileStats( fileName, size, modified );
+					if ( !exists || source.size == NONE ) {
+						if ( exists != ( source.size != NONE ) ) {
+							return true;
+						}
+						continue;
+					}
+
+					if ( size != source.size || modified != source.modified || hashFile( fileName ) != source.hash ) {
+						return true;
+					}
+				}
+
+				return false;
+			}
+
+			template< typename T >
+			const T *getRecords( Section section ) const
+			{
+				return reinterpret_cast< const T * >( _data + _header->sections[ section ].offset );
+			}
+
+			crimild::Size getCount( Section section ) const
+			{
+				return _header->sections[ section ].count;
+			}
+
+			std::string getString( const StringRef &ref ) const
+			{
+				const auto count = getCount( SECTION_STRINGS );
+				if ( ref.offset > count || ref.length > count - ref.offset ) {
+					return std::string();
+				}
+				return std::string( getRecords< char >( SECTION_STRINGS ) + ref.offset, ref.length );
+			}
+
+			const crimild::Byte *getBlob( const BlobRef &ref ) const
+			{
+				const auto count = getCount( SECTION_BLOBS );
+				if ( ref.offset > count || ref.size > count - ref.offset ) {
+					return nullptr;
+				}
+				return getRecords< crimild::Byte >( SECTION_BLOBS ) + ref.offset;
+			}
+
+		private:
+			const crimild::Byte *_data;
+			crimild::Size _size;
+			const Header *_header = nullptr;
+		};
+
+		template< typename T >
+		static SharedPointer< T > getAt( const std::vector< SharedPointer< T >> &items, crimild::UInt32 index )
+		{
+			return index < items.size() ? items[ index ] : nullptr;
+		}
+
+	}
+
+}
+
+using namespace crimild::scene_cache;
+
+std::string SceneCache::getCacheFileName( std::string sourceFileName )
+{
+	return sourceFileName + ".cache";
+}
+
+crimild::UInt64 SceneCache::computeHash( const crimild::Byte *data, crimild::Size size )
+{
+	// FNV-1a, but consuming 8 bytes at a time. High bits are folded
+	// back after each step, since the multiplication only propagates
+	// changes upwards
+	const crimild::UInt64 PRIME = 1099511628211ull;
+	crimild::UInt64 hash = 14695981039346656037ull;
+
+	crimild::Size i = 0;
+	for ( ; i + sizeof( crimild::UInt64 ) <= size; i += sizeof( crimild::UInt64 ) ) {
+		crimild::UInt64 word;
+		memcpy( &word, data + i, sizeof( crimild::UInt64 ) );
+		hash = ( hash ^ word ) * PRIME;
+		hash ^= hash >> 32;
+	}
+
+	for ( ; i < size; i++ ) {
+		hash = ( hash ^ data[ i ] ) * PRIME;
+	}
+
+	return hash ^ size;
+}
+
+bool SceneCache::write( std::string cacheFileName, Group *scene, const std::vector< std::string > &sourceFileNames )
+{
+	if ( scene == nullptr ) {
+		return false;
+	}
+
+	Writer writer;
+	if ( !writer.addNode( scene, NONE ) ) {
+		return false;
+	}
+
+	writer.addSources( sourceFileNames );
+
+	if ( !writer.save( cacheFileName ) ) {
+		Log::warning( CRIMILD_CURRENT_CLASS_NAME, "Cannot write cache file ", cacheFileName );
+		return false;
+	}
+
+	return true;
+}
+
+SharedPointer< Group > SceneCache::read( std::string cacheFileName )
+{
+	crimild::UInt64 cacheSize;
+	crimild::Int64 cacheModified;
+	if ( !getFileStats( cacheFileName, cacheSize, cacheModified ) ) {
+		// no cache yet
+		return nullptr;
+	}
+
+	MappedFile file( cacheFileName );
+	if ( !file.isOpen() ) {
+		return nullptr;
+	}
+
+	Reader reader( file );
+	if ( !reader.validate() ) {
+		Log::warning( CRIMILD_CURRENT_CLASS_NAME, "Invalid cache file ", cacheFileName );
+		return nullptr;
+	}
+
+	if ( reader.sourcesChanged() ) {
+		Log::debug( CRIMILD_CURRENT_CLASS_NAME, "Cache file is out of date ", cacheFileName );
+		return nullptr;
+	}
+
+	std::vector< SharedPointer< Image >> images( reader.getCount( SECTION_IMAGES ) );
+	auto imageRecords = reader.getRecords< ImageRecord >( SECTION_IMAGES );
+	for ( crimild::Size i = 0; i < images.size(); i++ ) {
+		const auto &record = imageRecords[ i ];
+		auto image = crimild::alloc< Image >();
+		auto data = reader.getBlob( record.data );
+		auto format = static_cast< Image::PixelFormat >( record.pixelFormat );
+		if ( data != nullptr && record.data.size > 0 && record.data.size == Image::computeDataSize( format, record.width, record.height, record.bpp ) ) {
+			if ( Image::isCompressedFormat( format ) ) {
+				image->setCompressedData( record.width, record.height, format, data );
+			}
+			else {
+				image->setData( record.width, record.height, record.bpp, data, format, static_cast< Image::PixelType >( record.pixelType ) );
+			}
+		}
+		images[ i ] = image;
+	}
+
+	std::vector< SharedPointer< Texture >> textures( reader.getCount( SECTION_TEXTURES ) );
+	auto textureRecords = reader.getRecords< TextureRecord >( SECTION_TEXTURES );
+	for ( crimild::Size i = 0; i < textures.size(); i++ ) {
+		const auto &record = textureRecords[ i ];
+		auto texture = crimild::alloc< Texture >( getAt( images, record.image ), reader.getString( record.name ) );
+		texture->setWrapMode( static_cast< Texture::WrapMode >( record.wrapMode ) );
+		texture->setMinFilter( static_cast< Texture::Filter >( record.minFilter ) );
+		texture->setMagFilter( static_cast< Texture::Filter >( record.magFilter ) );
+		textures[ i ] = texture;
+	}
+
+	std::vector< SharedPointer< Material >> materials( reader.getCount( SECTION_MATERIALS ) );
+	auto materialRecords = reader.getRecords< MaterialRecord >( SECTION_MATERIALS );
+	for ( crimild::Size i = 0; i < materials.size(); i++ ) {
+		const auto &record = materialRecords[ i ];
+		auto material = crimild::alloc< Material >();
+		material->setAmbient( RGBAColorf( record.ambient ) );
+		material->setDiffuse( RGBAColorf( record.diffuse ) );
+		material->setSpecular( RGBAColorf( record.specular ) );
+		material->setShininess( record.shininess );
+		material->setEmissive( record.emissive );
+		material->setCastShadows( ( record.flags & MaterialRecord::CAST_SHADOWS ) != 0 );
+		material->setReceiveShadows( ( record.flags & MaterialRecord::RECEIVE_SHADOWS ) != 0 );
+		material->setAlphaState( crimild::alloc< AlphaState >(
+			( record.flags & MaterialRecord::ALPHA_ENABLED ) != 0,
+			static_cast< AlphaState::SrcBlendFunc >( record.srcBlendFunc ),
+			static_cast< AlphaState::DstBlendFunc >( record.dstBlendFunc ) ) );
+		material->getCullFaceState()->setEnabled( ( record.flags & MaterialRecord::CULL_FACE_ENABLED ) != 0 );
+
+		auto programName = reader.getString( record.program );
+		if ( programName != "" && AssetManager::hasInstance() ) {
+			material->setProgram( AssetManager::getInstance()->get< ShaderProgram >( programName ) );
+		}
+
+		material->setColorMap( getAt( textures, record.colorMap ) );
+		material->setNormalMap( getAt( textures, record.normalMap ) );
+		material->setSpecularMap( getAt( textures, record.specularMap ) );
+		material->setEmissiveMap( getAt( textures, record.emissiveMap ) );
+		materials[ i ] = material;
+	}
+
+	std::vector< SharedPointer< Primitive >> primitives( reader.getCount( SECTION_PRIMITIVES ) );
+	auto primitiveRecords = reader.getRecords< PrimitiveRecord >( SECTION_PRIMITIVES );
+	for ( crimild::Size i = 0; i < primitives.size(); i++ ) {
+		const auto &record = primitiveRecords[ i ];
+		auto primitive = crimild::alloc< Primitive >( static_cast< Primitive::Type >( record.type ) );
+
+		VertexFormat format( record.format[ 0 ], record.format[ 1 ], record.format[ 2 ], record.format[ 3 ], record.format[ 4 ], record.format[ 5 ], record.format[ 6 ] );
+		auto vertices = reader.getBlob( record.vertices );
+		if ( vertices == nullptr || record.vertices.size != record.vertexCount * format.getVertexSizeInBytes() ) {
+			Log::warning( CRIMILD_CURRENT_CLASS_NAME, "Invalid vertex data in cache file ", cacheFileName );
+			return nullptr;
+		}
+		primitive->setVertexBuffer( crimild::alloc< VertexBufferObject >( format, record.vertexCount, reinterpret_cast< const VertexPrecision * >( vertices ) ) );
+
+		auto indices = reader.getBlob( record.indices );
+		const auto indexType = static_cast< IndexBufferObject::IndexType >( record.indexType );
+		const auto indexSize = indexType == IndexBufferObject::IndexType::UINT32 ? sizeof( crimild::UInt32 ) : sizeof( crimild::UInt16 );
+		if ( indices == nullptr || record.indices.size != record.indexCount * indexSize ) {
+			Log::warning( CRIMILD_CURRENT_CLASS_NAME, "Invalid index data in cache file ", cacheFileName );
+			return nullptr;
+		}
+		if ( indexType == IndexBufferObject::IndexType::UINT32 ) {
+			primitive->setIndexBuffer( crimild::alloc< IndexBufferObject >( record.indexCount, reinterpret_cast< const crimild::UInt32 * >( indices ) ) );
+		}
+		else {
+			primitive->setIndexBuffer( crimild::alloc< IndexBufferObject >( record.indexCount, reinterpret_cast< const crimild::UInt16 * >( indices ) ) );
+		}
+
+		primitives[ i ] = primitive;
+	}
+
+	std::vector< SharedPointer< animation::Skeleton >> skeletons( reader.getCount( SECTION_SKELETONS ) );
+	auto skeletonRecords = reader.getRecords< SkeletonRecord >( SECTION_SKELETONS );
+	for ( crimild::Size i = 0; i < skeletons.size(); i++ ) {
+		auto data = reader.getBlob( skeletonRecords[ i ].data );
+		if ( data == nullptr ) {
+			continue;
+		}
+		containers::ByteArray bytes( skeletonRecords[ i ].data.size );
+		memcpy( bytes.getData(), data, bytes.size() );
+		coding::MemoryDecoder decoder;
+		if ( decoder.fromBytes( bytes ) && decoder.getObjectCount() > 0 ) {
+			skeletons[ i ] = decoder.getObjectAt< animation::Skeleton >( 0 );
+		}
+	}
+
+	const auto nodeCount = reader.getCount( SECTION_NODES );
+	const auto nodeRecords = reader.getRecords< NodeRecord >( SECTION_NODES );
+	const auto jointRecords = reader.getRecords< JointRecord >( SECTION_JOINTS );
+	const auto jointCount = reader.getCount( SECTION_JOINTS );
+	const auto materialRefs = reader.getRecords< crimild::UInt32 >( SECTION_MATERIAL_REFS );
+	const auto materialRefCount = reader.getCount( SECTION_MATERIAL_REFS );
+
+	if ( nodeCount == 0 || nodeRecords[ 0 ].type != NodeRecord::GROUP ) {
+		Log::warning( CRIMILD_CURRENT_CLASS_NAME, "Invalid scene in cache file ", cacheFileName );
+		return nullptr;
+	}
+
+	std::vector< SharedPointer< Node >> nodes( nodeCount );
+	for ( crimild::Size i = 0; i < nodeCount; i++ ) {
+		const auto &record = nodeRecords[ i ];
+
+		SharedPointer< Node > node;
+		if ( record.type == NodeRecord::GEOMETRY ) {
+			auto geometry = crimild::alloc< Geometry >( reader.getString( record.name ) );
+			if ( record.firstPrimitive > primitives.size() || record.primitiveCount > primitives.size() - record.firstPrimitive ) {
+				return nullptr;
+			}
+			for ( crimild::UInt32 p = 0; p < record.primitiveCount; p++ ) {
+				geometry->attachPrimitive( primitives[ record.firstPrimitive + p ] );
+			}
+			node = geometry;
+		}
+		else {
+			node = crimild::alloc< Group >( reader.getString( record.name ) );
+		}
+
+		decodeTransform( record.local, node->local() );
+		node->setEnabled( ( record.flags & NodeRecord::ENABLED ) != 0 );
+
+		if ( record.materialCount > 0 ) {
+			if ( record.firstMaterial > materialRefCount || record.materialCount > materialRefCount - record.firstMaterial ) {
+				return nullptr;
+			}
+			auto materialComponent = node->getComponent< MaterialComponent >();
+			if ( materialComponent == nullptr ) {
+				materialComponent = node->attachComponent< MaterialComponent >();
+			}
+			for ( crimild::UInt32 m = 0; m < record.materialCount; m++ ) {
+				if ( auto material = getAt( materials, materialRefs[ record.firstMaterial + m ] ) ) {
+					materialComponent->attachMaterial( material );
+				}
+			}
+		}
+
+		if ( record.joint < jointCount ) {
+			const auto &jointRecord = jointRecords[ record.joint ];
+			auto joint = crimild::alloc< animation::Joint >( reader.getString( jointRecord.name ), jointRecord.id );
+			Transformation offset;
+			decodeTransform( jointRecord.offset, offset );
+			joint->setOffset( offset );
+			node->attachComponent( joint );
+		}
+
+		if ( auto skeleton = getAt( skeletons, record.skeleton ) ) {
+			node->attachComponent( skeleton );
+		}
+
+		if ( i > 0 ) {
+			// parents always come before their children
+			if ( record.parent >= i || nodeRecords[ record.parent ].type != NodeRecord::GROUP ) {
+				Log::warning( CRIMILD_CURRENT_CLASS_NAME, "Invalid scene in cache file ", cacheFileName );
+				return nullptr;
+			}
+			static_cast< Group * >( crimild::get_ptr( nodes[ record.parent ] ) )->attachNode( node );
+		}
+
+		nodes[ i ] = node;
+	}
+
+	return crimild::cast_ptr< Group >( nodes[ 0 ] );
+}
+
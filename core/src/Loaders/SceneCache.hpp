@@ -0,0 +1,100 @@
+/*
+ * Copyright (c) 2013, Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef CRIMILD_LOADERS_SCENE_CACHE_
+#define CRIMILD_LOADERS_SCENE_CACHE_
+
+#include "SceneGraph/Group.hpp"
+
+#include <string>
+#include <vector>
+
+namespace crimild {
+
+	/**
+	   \brief Binary cache for imported scenes
+
+	   Parsing text formats or running a full importer on every launch
+	   is slow. Once a scene has been imported, write() stores it in a
+	   compact binary file and read() can rebuild it later without
+	   touching the original sources.
+
+	   The file is memory mapped when reading. All records are fixed
+	   size and refer to each other using offsets, so they are used in
+	   place. Vertex and index data is stored exactly as expected by
+	   VertexBufferObject and IndexBufferObject and it's copied at
+	   once into each buffer.
+
+	   A cache is only valid as long as its sources remain unchanged.
+	   For each source file, the cache records its size, modification
+	   time and a hash of its contents. If any of them do not match,
+	   read() ignores the cache.
+
+	   Supported scenes are made of Group and Geometry nodes with
+	   materials, textures, joints and skeletons. Any other node or
+	   component type makes write() fail, in which case the scene should
+	   be imported again the next time.
+
+	   \remarks Cache files are not portable between platforms with
+	   different endianness. They are rejected in that case.
+	 */
+	class SceneCache {
+	public:
+		/**
+		   \brief Default cache file name for a given source file
+		 */
+		static std::string getCacheFileName( std::string sourceFileName );
+
+		/**
+		   \brief Writes a scene to a cache file
+
+		   \param sourceFileNames All files used to build the scene
+
+		   \returns false if the scene cannot be cached or if the
+		   file cannot be written
+		 */
+		static bool write( std::string cacheFileName, Group *scene, const std::vector< std::string > &sourceFileNames );
+
+		/**
+		   \brief Rebuilds a scene from a cache file
+
+		   \returns nullptr if the cache does not exist, is invalid
+		   or any of the source files changed
+		 */
+		static SharedPointer< Group > read( std::string cacheFileName );
+
+		/**
+		   \brief Hash used to validate source contents
+		 */
+		static crimild::UInt64 computeHash( const crimild::Byte *data, crimild::Size size );
+	};
+
+}
+
+#endif
+
@@ -27,23 +27,49 @@
 
 #include "Random.hpp"
 
+#include <atomic>
+
+#if defined( __SSE2__ ) || defined( _M_X64 )
+#include <emmintrin.h>
+#define CRIMILD_RANDOM_SSE2 1
+#endif
+
 using namespace crimild;
 
-Random::Generator::Generator( void )
-	: _distribution( 0, 1 )
+static crimild::UInt64 splitMix64( crimild::UInt64 &x )
 {
-	// initialize the random number generator with time-dependent seed
-	uint64_t timeSeed = std::chrono::high_resolution_clock::now().time_since_epoch().count();
-	std::seed_seq ss { uint32_t( timeSeed & 0xffffffff ), uint32_t( timeSeed >> 32 ) };
-	
-	_generator.seed( ss );	
+	x += 0x9E3779B97F4A7C15ull;
+	auto z = x;
+	z = ( z ^ ( z >> 30 ) ) * 0xBF58476D1CE4E5B9ull;
+	z = ( z ^ ( z >> 27 ) ) * 0x94D049BB133111EBull;
+	return z ^ ( z >> 31 );
 }
 
-Random::Generator::Generator( crimild::UInt32 seed )
-	: _generator( seed ),
-      _distribution( 0, 1 )
+static crimild::UInt64 computeTimeSeed( void )
 {
+	return std::chrono::high_resolution_clock::now().time_since_epoch().count();
+}
 
+static Random::Generator &getThreadDefaultGenerator( void )
+{
+	// Each thread gets its own stream, in case two of them are 
+	// created at the same time
+	static std::atomic< crimild::UInt64 > nextStream( 0 );
+	static thread_local Random::Generator generator( computeTimeSeed(), nextStream++ );
+	return generator;
+}
+
+static thread_local Random::Generator *currentGenerator = nullptr;
+
+Random::Generator::Generator( void )
+	: Generator( computeTimeSeed() )
+{
+
+}
+
+Random::Generator::Generator( crimild::UInt64 seed, crimild::UInt64 stream )
+{
+	this->seed( seed, stream );
 }
 
 Random::Generator::~Generator( void )
@@ -51,18 +77,80 @@ Random::Generator::~Generator( void )
 
 }
 
-crimild::Real64 Random::Generator::generate( void )
+void Random::Generator::seed( crimild::UInt64 seed, crimild::UInt64 stream )
+{
+	// The stream is hashed before mixing it with the seed, so
+	// consecutive streams result in unrelated states
+	auto s = seed ^ splitMix64( stream );
+	for ( auto &state : _state ) {
+		state = splitMix64( s );
+	}
+}
+
+void Random::Generator::fill( crimild::Real32 *values, crimild::Size count, crimild::Real32 min, crimild::Real32 max )
+{
+	const auto range = max - min;
+	const auto scale = 1.0f / 16777216.0f;
+
+	// Random bits are produced in small batches and then converted to 
+	// floats using the upper 24 bits, which is the precision of a float
+	const crimild::Size BATCH_SIZE = 64;
+	crimild::UInt32 bits[ BATCH_SIZE ];
+
+	crimild::Size i = 0;
+	while ( i < count ) {
+		const auto n = Numeric< crimild::Size >::min( BATCH_SIZE, count - i );
+		for ( crimild::Size j = 0; j < n; j += 2 ) {
+			const auto r = next();
+			bits[ j ] = crimild::UInt32( r >> 32 );
+			bits[ j + 1 ] = crimild::UInt32( r );
+		}
+
+		auto out = values + i;
+		crimild::Size j = 0;
+
+#ifdef CRIMILD_RANDOM_SSE2
+		const auto vScale = _mm_set1_ps( scale );
+		const auto vRange = _mm_set1_ps( range );
+		const auto vMin = _mm_set1_ps( min );
+		for ( ; j + 4 <= n; j += 4 ) {
+			const auto b = _mm_srli_epi32( _mm_loadu_si128( reinterpret_cast< const __m128i * >( bits + j ) ), 8 );
+			const auto f = _mm_mul_ps( _mm_cvtepi32_ps( b ), vScale );
+			_mm_storeu_ps( out + j, _mm_add_ps( vMin, _mm_mul_ps( f, vRange ) ) );
+		}
+#endif
+
+		for ( ; j < n; j++ ) {
+			const auto f = crimild::Real32( bits[ j ] >> 8 ) * scale;
+			out[ j ] = min + f * range;
+		}
+
+		i += n;
+	}
+}
+
+Random::ScopedGenerator::ScopedGenerator( Generator &generator )
+	: _previous( currentGenerator )
 {
-	return _distribution( _generator );
+	currentGenerator = &generator;
 }
 
-crimild::Real64 Random::Generator::generate( crimild::Real64 max )
+Random::ScopedGenerator::~ScopedGenerator( void )
 {
-	return max * generate();
+	currentGenerator = _previous;
+}
+
+Random::Generator &Random::getGenerator( void )
+{
+	if ( currentGenerator != nullptr ) {
+		return *currentGenerator;
+	}
+
+	return getThreadDefaultGenerator();
 }
 
-crimild::Real64 Random::Generator::generate( crimild::Real64 min, crimild::Real64 max )
+void Random::setSeed( crimild::UInt64 seed, crimild::UInt64 stream )
 {
-	return min + generate() * ( max - min );
+	getThreadDefaultGenerator().seed( seed, stream );
 }
 
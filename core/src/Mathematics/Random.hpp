@@ -46,23 +46,127 @@
 
 namespace crimild {
 
+	/**
+		\brief Random number generation
+
+		\remarks Static functions use a generator owned by the calling 
+		thread, so concurrent callers never share state. Use an explicitly
+		seeded Generator (with one stream per job) when results must be 
+		reproducible no matter how work is distributed between threads.
+	*/
 	class Random {
 	public:
+		/**
+			\brief A xoshiro256** generator
+
+			\remarks Generators created with the same seed and stream always 
+			produce the same sequence. Different streams for the same seed 
+			produce independent sequences, which is useful to give each job 
+			its own generator.
+
+			Satisfies the UniformRandomBitGenerator requirements, so it can
+			be used with <random> distributions.
+		*/
 		class Generator {
 		public:
+			using result_type = crimild::UInt64;
+
+		public:
+			/**
+				\brief Creates a generator with a time-dependent seed
+			*/
 			Generator( void );
-			Generator( crimild::UInt32 seed );
+			explicit Generator( crimild::UInt64 seed, crimild::UInt64 stream = 0 );
 			~Generator( void );
 
-			crimild::Real64 generate( void );
-			crimild::Real64 generate( crimild::Real64 max );
-			crimild::Real64 generate( crimild::Real64 min, crimild::Real64 max );
+			void seed( crimild::UInt64 seed, crimild::UInt64 stream = 0 );
+
+			/**
+				\brief Next 64 random bits
+			*/
+			inline crimild::UInt64 next( void )
+			{
+				const auto result = rotl( _state[ 1 ] * 5, 7 ) * 9;
+				const auto t = _state[ 1 ] << 17;
+
+				_state[ 2 ] ^= _state[ 0 ];
+				_state[ 3 ] ^= _state[ 1 ];
+				_state[ 1 ] ^= _state[ 2 ];
+				_state[ 0 ] ^= _state[ 3 ];
+				_state[ 2 ] ^= t;
+				_state[ 3 ] = rotl( _state[ 3 ], 45 );
+
+				return result;
+			}
+
+			/**
+				\brief A random number in [0, 1)
+			*/
+			inline crimild::Real64 generate( void )
+			{
+				// Uses the upper 53 bits, which is the precision of a double
+				return ( next() >> 11 ) * ( 1.0 / 9007199254740992.0 );
+			}
+
+			inline crimild::Real64 generate( crimild::Real64 max ) { return max * generate(); }
+			inline crimild::Real64 generate( crimild::Real64 min, crimild::Real64 max ) { return min + generate() * ( max - min ); }
+
+			/**
+				\brief Fills an array with random numbers in [min, max)
+
+				\remarks Each 64-bit value produces two single precision 
+				numbers, which are converted using SIMD instructions when 
+				available. The sequence is not the same as calling generate() 
+				count times, but it is still deterministic for a given seed.
+			*/
+			void fill( crimild::Real32 *values, crimild::Size count, crimild::Real32 min, crimild::Real32 max );
+
+			/**
+				\name UniformRandomBitGenerator
+			*/
+			//@{
+
+			static constexpr result_type min( void ) { return 0; }
+			static constexpr result_type max( void ) { return std::numeric_limits< result_type >::max(); }
+			inline result_type operator()( void ) { return next(); }
+
+			//@}
+
+		private:
+			static inline crimild::UInt64 rotl( crimild::UInt64 x, int k ) { return ( x << k ) | ( x >> ( 64 - k ) ); }
+
+		private:
+			crimild::UInt64 _state[ 4 ];
+		};
+
+		/**
+			\brief Replaces the calling thread's generator during a scope
+
+			\remarks Used to make code that relies on Random::generate() 
+			deterministic without modifying it.
+		*/
+		class ScopedGenerator {
+		public:
+			explicit ScopedGenerator( Generator &generator );
+			~ScopedGenerator( void );
+
+			ScopedGenerator( const ScopedGenerator & ) = delete;
+			ScopedGenerator &operator=( const ScopedGenerator & ) = delete;
 
 		private:
-			std::mt19937_64 _generator;
-			std::uniform_real_distribution< double > _distribution;
+			Generator *_previous = nullptr;
 		};
 
+		/**
+			\brief The generator used by the calling thread
+		*/
+		static Generator &getGenerator( void );
+
+		/**
+			\brief Reseeds the calling thread's default generator
+		*/
+		static void setSeed( crimild::UInt64 seed, crimild::UInt64 stream = 0 );
+
 	public:
 		template< typename PRECISION >
 		inline static PRECISION generate( void )
@@ -80,45 +184,36 @@ namespace crimild {
 		inline static T generate( const T &min, const T &max )
 		{
 			T result;
-			generateImpl( result, min, max );
+			generateImpl( getGenerator(), result, min, max );
+			return result;
+		}
+
+		template< typename T >
+		inline static T generate( Generator &generator, const T &min, const T &max )
+		{
+			T result;
+			generateImpl( generator, result, min, max );
 			return result;
 		}
 
+		inline static void fill( crimild::Real32 *values, crimild::Size count, crimild::Real32 min, crimild::Real32 max )
+		{
+			getGenerator().fill( values, count, min, max );
+		}
+
 	private:
 		template< crimild::Size SIZE, typename PRECISION >
-		inline static void generateImpl( Vector< SIZE, PRECISION > &result, const Vector< SIZE, PRECISION > &min, const Vector< SIZE, PRECISION > &max )
+		inline static void generateImpl( Generator &generator, Vector< SIZE, PRECISION > &result, const Vector< SIZE, PRECISION > &min, const Vector< SIZE, PRECISION > &max )
 		{
-			if ( SIZE == 2 ) {
-				result = Vector< SIZE, PRECISION >(
-					Random::generate< PRECISION >( min[ 0 ], max[ 0 ] ),
-					Random::generate< PRECISION >( min[ 1 ], max[ 1 ] ) );
-			}
-			else if ( SIZE == 3 ) {
-				result = Vector< SIZE, PRECISION >(
-					Random::generate< PRECISION >( min[ 0 ], max[ 0 ] ),
-					Random::generate< PRECISION >( min[ 1 ], max[ 1 ] ),
-					Random::generate< PRECISION >( min[ 2 ], max[ 2 ] ) );
-			}
-			else if ( SIZE == 4 ) {
-				result = Vector< SIZE, PRECISION >(
-					Random::generate< PRECISION >( min[ 0 ], max[ 0 ] ),
-					Random::generate< PRECISION >( min[ 1 ], max[ 1 ] ),
-					Random::generate< PRECISION >( min[ 2 ], max[ 2 ] ),
-					Random::generate< PRECISION >( min[ 3 ], max[ 3 ] ) );
-			}
-			else {
-				for ( crimild::Size i = 0; i < SIZE; i++ ) {
-					result[ i ] = Random::generate< PRECISION >( min[ i ], max[ i ] );
-				}
+			for ( crimild::Size i = 0; i < SIZE; i++ ) {
+				generateImpl( generator, result[ i ], min[ i ], max[ i ] );
 			}
 		}
 
 		template< typename PRECISION >
-		inline static void generateImpl( PRECISION &result, const PRECISION &min, const PRECISION &max )
+		inline static void generateImpl( Generator &generator, PRECISION &result, const PRECISION &min, const PRECISION &max )
 		{
-			static Random::Generator defaultGenerator;
-
-			crimild::Real64 r = defaultGenerator.generate();
+			crimild::Real64 r = generator.generate();
             result = min + r * ( max - min );
         }
 
@@ -126,8 +221,12 @@ namespace crimild {
         template< class T >
         static void shuffle( std::vector< T > &input )
         {
-            auto seed = std::chrono::system_clock::now().time_since_epoch().count();
-            std::shuffle( input.begin(), input.end(), std::default_random_engine( seed ) );
+            // Fisher-Yates, using the thread's generator so shuffles can be 
+            // reproduced by seeding it
+            auto &generator = getGenerator();
+            for ( auto i = input.size(); i > 1; i-- ) {
+                std::swap( input[ i - 1 ], input[ generator.next() % i ] );
+            }
         }
         
         template< class T >
@@ -31,11 +31,19 @@
 #include "Foundation/Macros.hpp"
 #include "Foundation/Singleton.hpp"
 #include "Foundation/Log.hpp"
+#include "Foundation/Types.hpp"
+#include "Foundation/Containers/MPSCRingBuffer.hpp"
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <functional>
 #include <map>
+#include <memory>
 #include <vector>
 #include <mutex>
+#include <thread>
+#include <unordered_map>
 
 namespace crimild {
     
@@ -44,6 +52,75 @@ namespace crimild {
     template< class MessageType >
     using MessageHandler = std::function< void( MessageType const & ) >;
     
+    /**
+        \brief What to do when a deferred message is pushed to a full queue
+     */
+    enum class DeferredMessagePolicy {
+        /**
+            \brief Store the message in an unbounded list protected by a mutex
+         
+            Messages are never lost, but producers contend for the lock
+            until the queue is dispatched. This is the default policy.
+         */
+        SPILL,
+        
+        /**
+            \brief Discard the new message
+         */
+        DROP,
+        
+        /**
+            \brief Wait until the queue is dispatched
+         
+            \remarks Never use this policy for messages pushed from the 
+            thread that dispatches them, since it will block forever
+         */
+        WAIT,
+    };
+    
+    struct DeferredMessageStats {
+        crimild::Size pushed = 0;
+        crimild::Size dispatched = 0;
+        crimild::Size dropped = 0;
+        crimild::Size spilled = 0;
+        
+        /**
+            \brief Number of dispatches that had at least one message
+         */
+        crimild::Size batchCount = 0;
+        
+        /**
+            \brief Time between pushing a message and dispatching its batch, in seconds
+         */
+        crimild::Real64 totalLatency = 0;
+        crimild::Real64 maxLatency = 0;
+        
+        /**
+            \brief Time spent invoking handlers for deferred messages, in seconds
+         */
+        crimild::Real64 dispatchTime = 0;
+        
+        inline crimild::Real64 getAverageLatency( void ) const { return dispatched > 0 ? totalLatency / dispatched : 0.0; }
+        
+        /**
+            \brief Dispatched messages per second
+         */
+        inline crimild::Real64 getThroughput( void ) const { return dispatchTime > 0 ? dispatched / dispatchTime : 0.0; }
+        
+        DeferredMessageStats &operator+=( DeferredMessageStats const &other )
+        {
+            pushed += other.pushed;
+            dispatched += other.dispatched;
+            dropped += other.dropped;
+            spilled += other.spilled;
+            batchCount += other.batchCount;
+            totalLatency += other.totalLatency;
+            maxLatency = std::max( maxLatency, other.maxLatency );
+            dispatchTime += other.dispatchTime;
+            return *this;
+        }
+    };
+    
     class MessageQueueDispatcher : public NonCopyable {
     protected:
         MessageQueueDispatcher( void )
@@ -62,6 +139,10 @@ namespace crimild {
         virtual void dispatchDeferredMessages( void ) = 0;
         
         virtual void clear( void ) = 0;
+        
+        virtual DeferredMessageStats getDeferredMessageStats( void ) const = 0;
+        
+        virtual void resetDeferredMessageStats( void ) = 0;
     };
     
     template< class MessageType >
@@ -82,73 +163,280 @@ namespace crimild {
         {
             Lock lock( _handlersMutex );
             
-            _handlers[ target ] = handler;
+            auto entry = HandlerEntry { target, std::make_shared< MessageHandler< MessageType >>( handler ) };
+            auto it = _handlerIndices.find( target );
+            if ( it != _handlerIndices.end() ) {
+                _handlers[ it->second ] = entry;
+            }
+            else {
+                _handlerIndices[ target ] = _handlers.size();
+                _handlers.push_back( entry );
+            }
+            
+            _handlersChanged = true;
         }
         
         virtual void unregisterHandler( Messenger *handler ) override
         {
             Lock lock( _handlersMutex );
             
-            auto it = _handlers.find( handler );
-            if ( it != _handlers.end() ) {
-                _handlers.erase( it );
+            auto it = _handlerIndices.find( handler );
+            if ( it == _handlerIndices.end() ) {
+                return;
+            }
+            
+            // swap with the last entry to avoid shifting the list
+            const auto idx = it->second;
+            _handlerIndices.erase( it );
+            if ( idx != _handlers.size() - 1 ) {
+                _handlers[ idx ] = _handlers.back();
+                _handlerIndices[ _handlers[ idx ].target ] = idx;
             }
+            _handlers.pop_back();
+            
+            _handlersChanged = true;
         }
         
     private:
-        std::map< Messenger *, MessageHandler< MessageType >> _handlers;
+        struct HandlerEntry {
+            Messenger *target;
+            std::shared_ptr< MessageHandler< MessageType >> handler;
+        };
+        
+        using HandlerList = std::vector< HandlerEntry >;
+        
+        /**
+            \brief Publish a new snapshot of the handler list, if needed
+         
+            Several changes to handlers (i.e. when loading a scene) result in
+            a single copy, which is performed by the next broadcast.
+         */
+        void publishHandlers( void )
+        {
+            Lock lock( _handlersMutex );
+            
+            if ( !_handlersChanged ) {
+                return;
+            }
+            
+            std::shared_ptr< const HandlerList > handlers = std::make_shared< HandlerList >( _handlers );
+            std::atomic_store( &_publishedHandlers, handlers );
+            _handlersChanged = false;
+        }
+        
+    private:
+        HandlerList _handlers;
+        std::unordered_map< Messenger *, crimild::Size > _handlerIndices;
         Mutex _handlersMutex;
         
+        /**
+            \brief Immutable copy of the handler list used by broadcasts
+         
+            Broadcasts only need to acquire a reference to the current
+            snapshot, so they neither lock the mutex above nor allocate memory.
+            A snapshot remains valid for as long as a broadcast is using it,
+            even if handlers are modified in the meantime.
+         */
+        std::shared_ptr< const HandlerList > _publishedHandlers;
+        std::atomic< bool > _handlersChanged;
+        
     public:
         void broadcastMessage( MessageType const &message )
         {
-            std::map< Messenger *, MessageHandler< MessageType >> hs;
+            if ( _handlersChanged.load( std::memory_order_acquire ) ) {
+                publishHandlers();
+            }
             
-            {
-                Lock lock( _handlersMutex );
-                hs = _handlers;
+            auto handlers = std::atomic_load( &_publishedHandlers );
+            if ( handlers == nullptr ) {
+                return;
             }
             
-            for ( auto it : hs ) {
-                if ( it.first != nullptr && it.second != nullptr ) {
-                    it.second( message );
+            for ( const auto &entry : *handlers ) {
+                if ( entry.target != nullptr && *entry.handler != nullptr ) {
+                    ( *entry.handler )( message );
                 }
             }
         }
         
     public:
+        static constexpr crimild::Size DEFAULT_DEFERRED_MESSAGE_CAPACITY = 1024;
+        
+        /**
+            \brief Changes the capacity of the deferred message queue
+         
+            \remarks The queue is replaced, so this method must not be called
+            while other threads may push messages of this type (i.e. call 
+            it during initialization). Pending messages are kept.
+         */
+        void setDeferredMessageCapacity( crimild::Size capacity )
+        {
+            Lock lock( _spilledMessagesMutex );
+            
+            auto messages = std::unique_ptr< DeferredMessageBuffer >( new DeferredMessageBuffer( capacity ) );
+            _deferredMessages->drain( [ this, &messages ]( DeferredMessage &m ) {
+                if ( !messages->tryPush( m ) ) {
+                    _spilledMessages.push_back( m );
+                    _hasSpilledMessages = true;
+                }
+            }, _deferredMessages->getCapacity() );
+            
+            std::swap( _deferredMessages, messages );
+        }
+        
+        crimild::Size getDeferredMessageCapacity( void ) const { return _deferredMessages->getCapacity(); }
+        
+        void setDeferredMessagePolicy( DeferredMessagePolicy policy ) { _deferredMessagePolicy = policy; }
+        
+        DeferredMessagePolicy getDeferredMessagePolicy( void ) const { return _deferredMessagePolicy; }
+        
+        /**
+            \brief Enqueues a message to be dispatched later
+         
+            Any thread can push messages without locking, unless the
+            queue is full (see DeferredMessagePolicy)
+         */
         void pushMessage( MessageType const &message )
         {
-            Lock lock( _deferredMessagesMutex );
+            DeferredMessage m { message, getTimestamp() };
             
-            _deferredMessages.push_back( message );
+            _pushedCount.fetch_add( 1, std::memory_order_relaxed );
+            
+            // Once messages are spilled, keep spilling until the next 
+            // dispatch so they are delivered in order
+            if ( !_hasSpilledMessages.load( std::memory_order_acquire ) && _deferredMessages->tryPush( m ) ) {
+                return;
+            }
+            
+            switch ( _deferredMessagePolicy.load( std::memory_order_relaxed ) ) {
+                case DeferredMessagePolicy::DROP:
+                    _droppedCount.fetch_add( 1, std::memory_order_relaxed );
+                    break;
+                    
+                case DeferredMessagePolicy::WAIT:
+                    while ( !_deferredMessages->tryPush( m ) ) {
+                        std::this_thread::yield();
+                    }
+                    break;
+                    
+                default: {
+                    Lock lock( _spilledMessagesMutex );
+                    _spilledMessages.push_back( m );
+                    _hasSpilledMessages = true;
+                    _spilledCount.fetch_add( 1, std::memory_order_relaxed );
+                    break;
+                }
+            }
         }
         
+        /**
+            \brief Dispatches all messages pushed so far in a single batch
+         
+            Messages pushed by handlers during the dispatch are left for 
+            the next call.
+         
+            \remarks Only one thread at a time should dispatch messages
+         */
         virtual void dispatchDeferredMessages( void ) override
         {
-            std::vector< MessageType > ms;
-            
-            {
-                Lock lock( _deferredMessagesMutex );
-                std::swap( _deferredMessages, ms );
+            const auto pending = _deferredMessages->getSize();
+            const auto hasSpilledMessages = _hasSpilledMessages.load( std::memory_order_acquire );
+            if ( pending == 0 && !hasSpilledMessages ) {
+                return;
             }
             
-            for ( auto &m : ms ) {
-                broadcastMessage( m );
+            const auto start = getTimestamp();
+            
+            auto dispatch = [ this, start ]( DeferredMessage &m ) {
+                const auto latency = 1.0e-9 * ( start - m.timestamp );
+                _stats.totalLatency += latency;
+                _stats.maxLatency = std::max( _stats.maxLatency, latency );
+                _stats.dispatched++;
+                broadcastMessage( m.message );
+            };
+            
+            _deferredMessages->drain( dispatch, pending );
+            
+            if ( hasSpilledMessages ) {
+                std::vector< DeferredMessage > ms;
+                
+                {
+                    Lock lock( _spilledMessagesMutex );
+                    std::swap( _spilledMessages, ms );
+                    _hasSpilledMessages = false;
+                }
+                
+                for ( auto &m : ms ) {
+                    dispatch( m );
+                }
             }
+            
+            _stats.batchCount++;
+            _stats.dispatchTime += 1.0e-9 * ( getTimestamp() - start );
         }
         
     public:
         virtual void clear( void ) override
         {
-            Lock lock( _deferredMessagesMutex );
+            Lock lock( _spilledMessagesMutex );
+            
+            DeferredMessage m;
+            while ( _deferredMessages->tryPop( m ) ) {
+                // discard
+            }
             
-            _deferredMessages.clear();
+            _spilledMessages.clear();
+            _hasSpilledMessages = false;
+        }
+        
+        virtual DeferredMessageStats getDeferredMessageStats( void ) const override
+        {
+            auto stats = _stats;
+            stats.pushed = _pushedCount.load( std::memory_order_relaxed );
+            stats.dropped = _droppedCount.load( std::memory_order_relaxed );
+            stats.spilled = _spilledCount.load( std::memory_order_relaxed );
+            return stats;
+        }
+        
+        virtual void resetDeferredMessageStats( void ) override
+        {
+            _stats = DeferredMessageStats();
+            _pushedCount = 0;
+            _droppedCount = 0;
+            _spilledCount = 0;
         }
         
     private:
-        std::vector< MessageType > _deferredMessages;
-        Mutex _deferredMessagesMutex;
+        struct DeferredMessage {
+            MessageType message;
+            crimild::Int64 timestamp;
+        };
+        
+        using DeferredMessageBuffer = containers::MPSCRingBuffer< DeferredMessage >;
+        
+        static crimild::Int64 getTimestamp( void )
+        {
+            return std::chrono::duration_cast< std::chrono::nanoseconds >( std::chrono::steady_clock::now().time_since_epoch() ).count();
+        }
+        
+        std::unique_ptr< DeferredMessageBuffer > _deferredMessages;
+        std::atomic< DeferredMessagePolicy > _deferredMessagePolicy;
+        
+        std::vector< DeferredMessage > _spilledMessages;
+        std::atomic< bool > _hasSpilledMessages;
+        Mutex _spilledMessagesMutex;
+        
+        /**
+            \brief Counters updated by producers
+         */
+        std::atomic< crimild::Size > _pushedCount;
+        std::atomic< crimild::Size > _droppedCount;
+        std::atomic< crimild::Size > _spilledCount;
+        
+        /**
+            \brief Stats updated by the dispatching thread only
+         */
+        DeferredMessageStats _stats;
     };
     
     class MessageQueue : public StaticSingleton< MessageQueue > {
@@ -181,17 +469,8 @@ namespace crimild {
         
         void unregisterHandler( Messenger *target )
         {
-            std::vector< MessageQueueDispatcher * > ds;
-            
-            {
-                Lock lock( _mutex );
-                ds = _dispatchers;
-            }
-            
-            for ( auto d : ds ) {
-                if ( d != nullptr ) {
-                    d->unregisterHandler( target );
-                }
+            for ( auto d : *getDispatchers() ) {
+                d->unregisterHandler( target );
             }
         }
         
@@ -207,7 +486,11 @@ namespace crimild {
         {
             Lock lock( _mutex );
             
-            _dispatchers.push_back( dispatcher );
+            // Dispatchers are only registered once per message type, so 
+            // copying the list here is cheap
+            auto ds = std::make_shared< DispatcherList >( *getDispatchers() );
+            ds->push_back( dispatcher );
+            std::atomic_store( &_dispatchers, std::shared_ptr< const DispatcherList >( ds ) );
         }
         
     public:
@@ -219,44 +502,85 @@ namespace crimild {
         
         void dispatchDeferredMessages( void )
         {
-            std::vector< MessageQueueDispatcher * > ds;
-            
-            {
-                Lock lock( _mutex );
-                ds = _dispatchers;
-            }
-            
-            for ( auto d : ds ) {
-                if ( d != nullptr ) {
-                    d->dispatchDeferredMessages();
-                }
+            for ( auto d : *getDispatchers() ) {
+                d->dispatchDeferredMessages();
             }
         }
         
     public:
         void clear( void )
         {
-            std::vector< MessageQueueDispatcher * > ds;
-            
-            {
-                Lock lock( _mutex );
-                ds = _dispatchers;
+            for ( auto d : *getDispatchers() ) {
+                d->clear();
             }
-            
-            for ( auto d : ds ) {
-                if ( d != nullptr ) {
-                    d->clear();
-                }
+        }
+        
+        /**
+            \name Deferred message configuration and stats
+         */
+        //@{
+        
+    public:
+        template< class MessageType >
+        void setDeferredMessageCapacity( crimild::Size capacity )
+        {
+            MessageQueueDispatcherImpl< MessageType >::getInstance()->setDeferredMessageCapacity( capacity );
+        }
+        
+        template< class MessageType >
+        void setDeferredMessagePolicy( DeferredMessagePolicy policy )
+        {
+            MessageQueueDispatcherImpl< MessageType >::getInstance()->setDeferredMessagePolicy( policy );
+        }
+        
+        template< class MessageType >
+        DeferredMessageStats getDeferredMessageStats( void )
+        {
+            return MessageQueueDispatcherImpl< MessageType >::getInstance()->getDeferredMessageStats();
+        }
+        
+        /**
+            \brief Stats for all message types combined
+         */
+        DeferredMessageStats getDeferredMessageStats( void )
+        {
+            DeferredMessageStats stats;
+            for ( auto d : *getDispatchers() ) {
+                stats += d->getDeferredMessageStats();
             }
+            return stats;
         }
         
+        void resetDeferredMessageStats( void )
+        {
+            for ( auto d : *getDispatchers() ) {
+                d->resetDeferredMessageStats();
+            }
+        }
+        
+        //@}
+        
     private:
-        std::vector< MessageQueueDispatcher * > _dispatchers;
+        using DispatcherList = std::vector< MessageQueueDispatcher * >;
+        
+        std::shared_ptr< const DispatcherList > getDispatchers( void ) const
+        {
+            return std::atomic_load( &_dispatchers );
+        }
+        
+        std::shared_ptr< const DispatcherList > _dispatchers = std::make_shared< DispatcherList >();
         Mutex _mutex;
     };
     
     template< class T >
     MessageQueueDispatcherImpl< T >::MessageQueueDispatcherImpl( void )
+        : _handlersChanged( false ),
+          _deferredMessages( new DeferredMessageBuffer( DEFAULT_DEFERRED_MESSAGE_CAPACITY ) ),
+          _deferredMessagePolicy( DeferredMessagePolicy::SPILL ),
+          _hasSpilledMessages( false ),
+          _pushedCount( 0 ),
+          _droppedCount( 0 ),
+          _spilledCount( 0 )
     {
         MessageQueue::getInstance()->registerMessageDispatcher( this );
     }
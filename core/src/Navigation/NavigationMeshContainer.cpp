@@ -116,7 +116,7 @@ void NavigationMeshContainer::renderDebugInfo( Renderer *renderer, Camera *camer
 		auto primitive = crimild::alloc< Primitive >();
 		primitive->setVertexBuffer( crimild::alloc< VertexBufferObject >( VertexFormat::VF_P3, cells.size(), ( float * ) &cells[ 0 ] ) );
 
-		auto ibo = crimild::alloc< IndexBufferObject >( cells.size(), nullptr );
+		auto ibo = crimild::alloc< IndexBufferObject >( cells.size(), IndexBufferObject::getIndexTypeForVertexCount( cells.size() ) );
 		for ( int i = 0; i < cells.size(); i++ ) {
 			ibo->setIndexAt( i, i );
 		}
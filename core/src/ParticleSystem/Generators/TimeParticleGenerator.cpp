@@ -33,6 +33,8 @@
 
 #include "SceneGraph/Node.hpp"
 
+#include <algorithm>
+
 using namespace crimild;
 
 TimeParticleGenerator::TimeParticleGenerator( void )
@@ -56,11 +58,8 @@ void TimeParticleGenerator::generate( Node *node, crimild::Real64 dt, ParticleDa
 	auto ts = _times->getData< crimild::Real32 >();
 	auto lts = _lifeTimes->getData< crimild::Real32 >();
 	
-    for ( ParticleId i = startId; i < endId; i++ ) {
-		auto t = Random::generate< crimild::Real32 >( _minTime, _maxTime );
-		ts[ i ] = t;
-		lts[ i ] = t;
-    }
+	Random::fill( ts + startId, endId - startId, _minTime, _maxTime );
+	std::copy( ts + startId, ts + endId, lts + startId );
 }
 
 void TimeParticleGenerator::encode( coding::Encoder &encoder ) 
@@ -54,9 +54,7 @@ void UniformScaleParticleGenerator::generate( Node *node, double dt, ParticleDat
 {
 	auto ss = _scales->getData< crimild::Real32 >();
 
-    for ( ParticleId i = startId; i < endId; i++ ) {
-		ss[ i ] = Random::generate< crimild::Real32 >( _minScale, _maxScale );
-    }
+	Random::fill( ss + startId, endId - startId, _minScale, _maxScale );
 }
 
 void UniformScaleParticleGenerator::encode( coding::Encoder &encoder ) 
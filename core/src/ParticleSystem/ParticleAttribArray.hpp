@@ -35,6 +35,9 @@
 #include "Foundation/Memory.hpp"
 #include "Mathematics/Vector.hpp"
 
+#include <algorithm>
+#include <vector>
+
 namespace crimild {
 
     using ParticleId = crimild::Size;
@@ -66,6 +69,17 @@ namespace crimild {
 
 	using ParticleAttribType = crimild::UInt16;
 
+	/**
+	   \brief A block of contiguous particles to be moved within an array
+
+	   \remarks Source and destination blocks never overlap
+	 */
+	struct ParticleMove {
+		ParticleId src;
+		ParticleId dst;
+		crimild::Size count;
+	};
+
 	/**
 	   \brief Interface for all particle attributes
 	 */
@@ -85,6 +99,22 @@ namespace crimild {
 		 */
         virtual void swap( ParticleId a, ParticleId b ) = 0;
 
+		/**
+		   \brief Moves blocks of elements towards the beginning of the array
+
+		   Invoked once per compaction with all the moves in order. 
+		   Elements left behind are not modified.
+		 */
+		virtual void move( const ParticleMove *moves, crimild::Size count ) = 0;
+
+		/**
+		   \brief Reorders the first count elements
+
+		   After this call, element i holds what was stored at indices[ i ].
+		   Indices must be a permutation of [0, count).
+		 */
+		virtual void permute( const ParticleId *indices, crimild::Size count ) = 0;
+
 		/**
 		   \brief Gets the number of elements in the array
 		 */
@@ -185,6 +215,27 @@ namespace crimild {
         	_data[ b ] = temp;
         }
 
+        virtual void move( const ParticleMove *moves, crimild::Size count ) override
+        {
+			auto data = _data.getData();
+			for ( crimild::Size i = 0; i < count; i++ ) {
+				const auto &m = moves[ i ];
+				std::copy( data + m.src, data + m.src + m.count, data + m.dst );
+			}
+        }
+
+        virtual void permute( const ParticleId *indices, crimild::Size count ) override
+        {
+			// Gather into a scratch buffer that is reused between calls
+			// and copy back, so the data pointer remains the same
+			_scratch.resize( count );
+			auto data = _data.getData();
+			for ( crimild::Size i = 0; i < count; i++ ) {
+				_scratch[ i ] = data[ indices[ i ] ];
+			}
+			std::copy( _scratch.begin(), _scratch.end(), data );
+        }
+
     private:
 		/**
 		   \brief Holds the data for the attributes
@@ -192,6 +243,8 @@ namespace crimild {
 		   \remarks This member is NOT thread safe. 
 		 */
         containers::Array< T > _data;
+
+		std::vector< T > _scratch;
     };
 
     using Vector3fParticleAttribArray = ParticleAttribArrayImpl< Vector3f >;
@@ -0,0 +1,115 @@
+/*
+ * Copyright (c) 2013, Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "ParticleBudgetManager.hpp"
+#include "ParticleSystemComponent.hpp"
+
+#include "Simulation/Systems/UpdateSystem.hpp"
+
+#include <algorithm>
+#include <limits>
+
+using namespace crimild;
+
+ParticleBudgetManager::ParticleBudgetManager( crimild::Size maxParticles )
+	: _maxParticles( maxParticles )
+{
+	registerMessageHandler< messaging::DidUpdateScene >( [ this ]( messaging::DidUpdateScene const & ) {
+		update();
+	});
+}
+
+ParticleBudgetManager::~ParticleBudgetManager( void )
+{
+	std::lock_guard< std::mutex > lock( _mutex );
+	for ( auto emitter : _emitters ) {
+		emitter->setParticleBudget( std::numeric_limits< crimild::Size >::max() );
+	}
+	_emitters.clear();
+}
+
+void ParticleBudgetManager::registerEmitter( ParticleSystemComponent *emitter )
+{
+	std::lock_guard< std::mutex > lock( _mutex );
+	if ( std::find( _emitters.begin(), _emitters.end(), emitter ) == _emitters.end() ) {
+		_emitters.push_back( emitter );
+	}
+}
+
+void ParticleBudgetManager::unregisterEmitter( ParticleSystemComponent *emitter )
+{
+	std::lock_guard< std::mutex > lock( _mutex );
+	_emitters.erase( std::remove( _emitters.begin(), _emitters.end(), emitter ), _emitters.end() );
+}
+
+crimild::Size ParticleBudgetManager::getEmitterCount( void )
+{
+	std::lock_guard< std::mutex > lock( _mutex );
+	return _emitters.size();
+}
+
+void ParticleBudgetManager::update( void )
+{
+	std::lock_guard< std::mutex > lock( _mutex );
+
+	_simulatedCount = 0;
+	_skippedCount = 0;
+	_throttledCount = 0;
+	_culledEmitterCount = 0;
+	for ( auto emitter : _emitters ) {
+		const auto &stats = emitter->getSimulationStats();
+		_simulatedCount += stats.simulated;
+		_skippedCount += stats.skipped;
+		_throttledCount += stats.throttled;
+		if ( emitter->isCulled() ) {
+			_culledEmitterCount++;
+		}
+	}
+
+	if ( _maxParticles == 0 ) {
+		for ( auto emitter : _emitters ) {
+			emitter->setParticleBudget( std::numeric_limits< crimild::Size >::max() );
+		}
+		return;
+	}
+
+	std::stable_sort( _emitters.begin(), _emitters.end(), []( ParticleSystemComponent *a, ParticleSystemComponent *b ) {
+		if ( a->getPriority() != b->getPriority() ) {
+			return a->getPriority() > b->getPriority();
+		}
+		return a->getLODScale() > b->getLODScale();
+	});
+
+	auto remaining = _maxParticles;
+	for ( auto emitter : _emitters ) {
+		const auto budget = Numeric< crimild::Size >::min( emitter->getParticleDemand(), remaining );
+		emitter->setParticleBudget( budget );
+		remaining -= budget;
+	}
+}
+
@@ -0,0 +1,112 @@
+/*
+ * Copyright (c) 2013, Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef CRIMILD_PARTICLE_SYSTEM_BUDGET_MANAGER_
+#define CRIMILD_PARTICLE_SYSTEM_BUDGET_MANAGER_
+
+#include "Foundation/Singleton.hpp"
+#include "Foundation/Types.hpp"
+#include "Messaging/MessageQueue.hpp"
+
+#include <mutex>
+#include <vector>
+
+namespace crimild {
+
+	class ParticleSystemComponent;
+
+	/**
+		\brief Limits the total number of alive particles in the scene
+
+		Particle systems register themselves when started, if there's an
+		instance of this class. Once per frame (after the scene has been
+		updated), the budget is split between all registered emitters 
+		based on what they expect to have alive in the next frame. 
+		Emitters with higher priority are served first and, for the same 
+		priority, those with a higher LOD scale (usually closer to the 
+		camera) go before the others.
+
+		Emitters running out of budget stop emitting new particles, but
+		existing ones live until they expire.
+	*/
+	class ParticleBudgetManager :
+		public DynamicSingleton< ParticleBudgetManager >,
+		public Messenger {
+	public:
+		/**
+			\brief Constructor
+
+			A budget of zero means no limit. Stats are still collected
+		*/
+		explicit ParticleBudgetManager( crimild::Size maxParticles = 0 );
+		virtual ~ParticleBudgetManager( void );
+
+		inline void setMaxParticles( crimild::Size maxParticles ) { _maxParticles = maxParticles; }
+		inline crimild::Size getMaxParticles( void ) const { return _maxParticles; }
+
+		void registerEmitter( ParticleSystemComponent *emitter );
+		void unregisterEmitter( ParticleSystemComponent *emitter );
+
+		crimild::Size getEmitterCount( void );
+
+		/**
+			\brief Collects stats and assigns budgets for the next frame
+
+			Invoked automatically when the scene is updated
+		*/
+		void update( void );
+
+		/**
+			\name Stats for the last frame
+		*/
+		//@{
+
+	public:
+		inline crimild::Size getSimulatedCount( void ) const { return _simulatedCount; }
+		inline crimild::Size getSkippedCount( void ) const { return _skippedCount; }
+		inline crimild::Size getThrottledCount( void ) const { return _throttledCount; }
+		inline crimild::Size getCulledEmitterCount( void ) const { return _culledEmitterCount; }
+
+	private:
+		crimild::Size _simulatedCount = 0;
+		crimild::Size _skippedCount = 0;
+		crimild::Size _throttledCount = 0;
+		crimild::Size _culledEmitterCount = 0;
+
+		//@}
+
+	private:
+		crimild::Size _maxParticles;
+		std::vector< ParticleSystemComponent * > _emitters;
+		std::mutex _mutex;
+	};
+
+}
+
+#endif
+
@@ -28,6 +28,11 @@
 #include "ParticleData.hpp"
 #include "Coding/Encoder.hpp"
 #include "Coding/Decoder.hpp"
+#include "Concurrency/Async.hpp"
+#include "Concurrency/JobScheduler.hpp"
+#include "Mathematics/Numeric.hpp"
+
+#include <algorithm>
 
 using namespace crimild;
 
@@ -50,6 +55,7 @@ ParticleData::~ParticleData( void )
 void ParticleData::generate( void )
 {
     _aliveCount = 0;
+	_killList.clear();
 
 	// reset all particle attributes
 	const auto count = getParticleCount();
@@ -73,15 +79,71 @@ void ParticleData::kill( ParticleId pid )
 		return;
 	}
 	
-	assert( _aliveCount > 0 );
+	assert( pid < _aliveCount );
 
 	_alive[ pid ] = false;
-	swap( pid, --_aliveCount );
+	_killList.push_back( pid );
+}
+
+void ParticleData::compact( void )
+{
+	if ( _killList.empty() ) {
+		return;
+	}
+
+	const auto aliveCount = _aliveCount;
+	const auto newAliveCount = aliveCount - _killList.size();
+
+	// Particles are usually killed while iterating in order, so this
+	// is just a linear check most of the time
+	if ( !std::is_sorted( _killList.begin(), _killList.end() ) ) {
+		std::sort( _killList.begin(), _killList.end() );
+	}
+
+	// Dead particles before the new end of the alive range (holes) are
+	// replaced by the alive ones after it, in order. There are as many
+	// of them as holes. Consecutive pairs are merged into blocks, so 
+	// most moves end up being contiguous copies
+	_moves.clear();
+	auto src = newAliveCount;
+	for ( auto hole : _killList ) {
+		if ( hole >= newAliveCount ) {
+			break;
+		}
+
+		while ( !_alive[ src ] ) {
+			src++;
+		}
+
+		if ( !_moves.empty() && _moves.back().src + _moves.back().count == src && _moves.back().dst + _moves.back().count == hole ) {
+			_moves.back().count++;
+		}
+		else {
+			_moves.push_back( ParticleMove { src, hole, 1 } );
+		}
+
+		_alive[ hole ] = true;
+		_alive[ src++ ] = false;
+	}
+
+	if ( !_moves.empty() ) {
+		const auto moves = &_moves[ 0 ];
+		const auto moveCount = _moves.size();
+		_attribs.each( [ moves, moveCount ]( const ParticleAttribType &type, ParticleAttribArrayPtr &attr ) {
+			if ( attr != nullptr ) {
+				attr->move( moves, moveCount );
+			}
+		});
+	}
+
+	_aliveCount = newAliveCount;
+	_killList.clear();
 }
 
 void ParticleData::wake( ParticleId pid )
 {
 	assert( _aliveCount < _count );
+	assert( _killList.empty() );
 	
 	_alive[ pid ] = true;
 	swap( pid, _aliveCount++ );
@@ -98,6 +160,46 @@ void ParticleData::swap( ParticleId a, ParticleId b )
     }
 }
 
+void ParticleData::permute( const ParticleId *indices )
+{
+	assert( _killList.empty() );
+
+	const auto count = _aliveCount;
+	_attribs.each( [ indices, count ]( const ParticleAttribType &type, ParticleAttribArrayPtr &attr ) {
+		if ( attr != nullptr ) {
+			attr->permute( indices, count );
+		}
+	});
+}
+
+void ParticleData::eachAliveBlock( std::function< void( crimild::Size, crimild::Size ) > const &fn )
+{
+	const auto count = getAliveCount();
+	if ( count == 0 ) {
+		return;
+	}
+
+	crimild::Size blockCount = 1;
+	if ( count >= _parallelThreshold && concurrency::JobScheduler::hasInstance() && concurrency::JobScheduler::getInstance()->isRunning() ) {
+		// Some extra blocks help balancing work when workers are busy with other jobs
+		blockCount = 2 * ( concurrency::JobScheduler::getInstance()->getNumWorkers() + 1 );
+	}
+
+	if ( blockCount == 1 ) {
+		fn( 0, count );
+		return;
+	}
+
+	const auto blockSize = ( ( count + blockCount - 1 ) / blockCount + 7 ) & ~crimild::Size( 7 );
+	concurrency::parallel_for( blockCount, [ &fn, blockSize, count ]( crimild::Size block ) {
+		const auto begin = block * blockSize;
+		const auto end = Numeric< crimild::Size >::min( count, begin + blockSize );
+		if ( begin < end ) {
+			fn( begin, end );
+		}
+	});
+}
+
 void ParticleData::encode( coding::Encoder &encoder )
 {
 	Codable::encode( encoder );
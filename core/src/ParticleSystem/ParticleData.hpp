@@ -31,6 +31,8 @@
 #include "ParticleAttribArray.hpp"
 #include "Coding/Codable.hpp"
 
+#include <functional>
+
 namespace crimild {
 
 	/**
@@ -99,13 +101,34 @@ namespace crimild {
 		   \brief Kill a particle
 		   
 		   This method set the alive flag to false for the given particle
-		   and swaps the particle so it is stored in the far end of the
-		   data array
+		   and adds it to the kill list. The particle is still part of the
+		   alive range (and indices remain valid) until compact() is called,
+		   so it's safe to kill particles while iterating over them.
 		 */
         void kill( ParticleId pid );
 
+		/**
+		   \brief Number of particles killed since the last compaction
+		 */
+		inline crimild::Size getPendingKillCount( void ) const { return _killList.size(); }
+
+		/**
+		   \brief Removes dead particles from the alive range
+
+		   Dead particles inside the new alive range are replaced by alive
+		   particles from past its end, which are copied in blocks whenever
+		   they are contiguous. Both finding and copying them is O(kills) 
+		   (plus sorting the kill list, if particles were not killed in 
+		   order). Particles that are not moved keep their relative order.
+
+		   \remarks Usually invoked once per update, after all updaters
+		 */
+		void compact( void );
+
 		/**
 		   \brief Activates a particle
+
+		   \warning Must not be called while there are pending kills
 		 */
         void wake( ParticleId pid );
 
@@ -116,9 +139,38 @@ namespace crimild {
 		 */
         void swap( ParticleId a, ParticleId b );
 
+		/**
+		   \brief Reorders alive particles
+
+		   Applies the permutation to all attribute arrays, one array at a 
+		   time. indices must contain the alive count elements.
+
+		   \warning Must not be called while there are pending kills
+		 */
+		void permute( const ParticleId *indices );
+
 		inline void setComputeInWorldSpace( crimild::Bool value ) { _computeInWorldSpace = value; }
 		inline crimild::Bool shouldComputeInWorldSpace( void ) const { return _computeInWorldSpace; }
 
+		/**
+		   \brief Minimum number of alive particles for updates to run in parallel
+		 */
+		inline void setParallelThreshold( crimild::Size value ) { _parallelThreshold = value; }
+		inline crimild::Size getParallelThreshold( void ) const { return _parallelThreshold; }
+
+		/**
+		   \brief Invokes fn( begin, end ) for contiguous blocks of alive particles
+
+		   Small systems are processed as a single block in the current thread.
+		   If there are more alive particles than the parallel threshold and the
+		   job scheduler is running, the alive range is split into blocks that
+		   are processed by workers, waiting for all of them before returning.
+
+		   Block boundaries are multiples of 8, so vectorized loops in each
+		   block start at the same alignment as the full array.
+		 */
+		void eachAliveBlock( std::function< void( crimild::Size, crimild::Size ) > const &fn );
+
     private:
         ParticleAttribs _attribs;
 		
@@ -127,8 +179,13 @@ namespace crimild {
 		
 		std::vector< crimild::Bool > _alive; // replace this for a custom array
 
+		std::vector< ParticleId > _killList;
+		std::vector< ParticleMove > _moves;
+
 		crimild::Bool _computeInWorldSpace = false;
 
+		crimild::Size _parallelThreshold = 32768;
+
 	public:
 		/**
 		   \brief Get the raw data for an attribute
@@ -0,0 +1,323 @@
+/*
+ * Copyright (c) 2013, Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "ParticleKernels.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#if defined( __SSE2__ ) || defined( _M_X64 )
+#include <emmintrin.h>
+#define CRIMILD_PARTICLE_KERNELS_SSE2 1
+#endif
+
+using namespace crimild;
+
+static_assert( sizeof( Vector3f ) == 3 * sizeof( crimild::Real32 ), "Vector3f must be tightly packed" );
+static_assert( sizeof( RGBAColorf ) == 4 * sizeof( crimild::Real32 ), "RGBAColorf must be tightly packed" );
+
+void ParticleKernels::add( Vector3f *dst, const Vector3f &value, crimild::Size count )
+{
+	auto d = reinterpret_cast< crimild::Real32 * >( dst );
+	const auto x = value[ 0 ];
+	const auto y = value[ 1 ];
+	const auto z = value[ 2 ];
+
+	crimild::Size i = 0;
+
+#ifdef CRIMILD_PARTICLE_KERNELS_SSE2
+	// Four particles are twelve floats, which means the value repeats
+	// itself every three registers
+	const auto v0 = _mm_setr_ps( x, y, z, x );
+	const auto v1 = _mm_setr_ps( y, z, x, y );
+	const auto v2 = _mm_setr_ps( z, x, y, z );
+	for ( ; i + 4 <= count; i += 4 ) {
+		auto p = d + 3 * i;
+		_mm_storeu_ps( p + 0, _mm_add_ps( _mm_loadu_ps( p + 0 ), v0 ) );
+		_mm_storeu_ps( p + 4, _mm_add_ps( _mm_loadu_ps( p + 4 ), v1 ) );
+		_mm_storeu_ps( p + 8, _mm_add_ps( _mm_loadu_ps( p + 8 ), v2 ) );
+	}
+#endif
+
+	for ( ; i < count; i++ ) {
+		auto p = d + 3 * i;
+		p[ 0 ] += x;
+		p[ 1 ] += y;
+		p[ 2 ] += z;
+	}
+}
+
+void ParticleKernels::addScaled( Vector3f *dst, const Vector3f *src, crimild::Real32 scale, crimild::Size count )
+{
+	auto d = reinterpret_cast< crimild::Real32 * >( dst );
+	auto s = reinterpret_cast< const crimild::Real32 * >( src );
+	const auto n = 3 * count;
+
+	crimild::Size i = 0;
+
+#ifdef CRIMILD_PARTICLE_KERNELS_SSE2
+	const auto k = _mm_set1_ps( scale );
+	for ( ; i + 16 <= n; i += 16 ) {
+		_mm_storeu_ps( d + i + 0, _mm_add_ps( _mm_loadu_ps( d + i + 0 ), _mm_mul_ps( k, _mm_loadu_ps( s + i + 0 ) ) ) );
+		_mm_storeu_ps( d + i + 4, _mm_add_ps( _mm_loadu_ps( d + i + 4 ), _mm_mul_ps( k, _mm_loadu_ps( s + i + 4 ) ) ) );
+		_mm_storeu_ps( d + i + 8, _mm_add_ps( _mm_loadu_ps( d + i + 8 ), _mm_mul_ps( k, _mm_loadu_ps( s + i + 8 ) ) ) );
+		_mm_storeu_ps( d + i + 12, _mm_add_ps( _mm_loadu_ps( d + i + 12 ), _mm_mul_ps( k, _mm_loadu_ps( s + i + 12 ) ) ) );
+	}
+	for ( ; i + 4 <= n; i += 4 ) {
+		_mm_storeu_ps( d + i, _mm_add_ps( _mm_loadu_ps( d + i ), _mm_mul_ps( k, _mm_loadu_ps( s + i ) ) ) );
+	}
+#endif
+
+	for ( ; i < n; i++ ) {
+		d[ i ] += scale * s[ i ];
+	}
+}
+
+void ParticleKernels::subtract( crimild::Real32 *dst, crimild::Real32 value, crimild::Size count )
+{
+	crimild::Size i = 0;
+
+#ifdef CRIMILD_PARTICLE_KERNELS_SSE2
+	const auto v = _mm_set1_ps( value );
+	for ( ; i + 8 <= count; i += 8 ) {
+		_mm_storeu_ps( dst + i + 0, _mm_sub_ps( _mm_loadu_ps( dst + i + 0 ), v ) );
+		_mm_storeu_ps( dst + i + 4, _mm_sub_ps( _mm_loadu_ps( dst + i + 4 ), v ) );
+	}
+#endif
+
+	for ( ; i < count; i++ ) {
+		dst[ i ] -= value;
+	}
+}
+
+void ParticleKernels::lerpByAge( crimild::Real32 *dst, const crimild::Real32 *start, const crimild::Real32 *end, const crimild::Real32 *times, const crimild::Real32 *lifetimes, crimild::Size count )
+{
+	crimild::Size i = 0;
+
+#ifdef CRIMILD_PARTICLE_KERNELS_SSE2
+	const auto one = _mm_set1_ps( 1.0f );
+	for ( ; i + 4 <= count; i += 4 ) {
+		const auto t = _mm_sub_ps( one, _mm_div_ps( _mm_loadu_ps( times + i ), _mm_loadu_ps( lifetimes + i ) ) );
+		const auto s0 = _mm_loadu_ps( start + i );
+		const auto s1 = _mm_loadu_ps( end + i );
+		_mm_storeu_ps( dst + i, _mm_add_ps( s0, _mm_mul_ps( t, _mm_sub_ps( s1, s0 ) ) ) );
+	}
+#endif
+
+	for ( ; i < count; i++ ) {
+		const auto t = 1.0f - ( times[ i ] / lifetimes[ i ] );
+		dst[ i ] = start[ i ] + t * ( end[ i ] - start[ i ] );
+	}
+}
+
+void ParticleKernels::lerpByAge( RGBAColorf *dst, const RGBAColorf *start, const RGBAColorf *end, const crimild::Real32 *times, const crimild::Real32 *lifetimes, crimild::Size count )
+{
+	auto d = reinterpret_cast< crimild::Real32 * >( dst );
+	auto s0 = reinterpret_cast< const crimild::Real32 * >( start );
+	auto s1 = reinterpret_cast< const crimild::Real32 * >( end );
+
+	crimild::Size i = 0;
+
+#ifdef CRIMILD_PARTICLE_KERNELS_SSE2
+	// Each color fits in a register, so compute four interpolation
+	// factors at once and broadcast them to each particle
+	const auto one = _mm_set1_ps( 1.0f );
+	for ( ; i + 4 <= count; i += 4 ) {
+		const auto t = _mm_sub_ps( one, _mm_div_ps( _mm_loadu_ps( times + i ), _mm_loadu_ps( lifetimes + i ) ) );
+		const __m128 ts[] = {
+			_mm_shuffle_ps( t, t, _MM_SHUFFLE( 0, 0, 0, 0 ) ),
+			_mm_shuffle_ps( t, t, _MM_SHUFFLE( 1, 1, 1, 1 ) ),
+			_mm_shuffle_ps( t, t, _MM_SHUFFLE( 2, 2, 2, 2 ) ),
+			_mm_shuffle_ps( t, t, _MM_SHUFFLE( 3, 3, 3, 3 ) ),
+		};
+		for ( crimild::Size j = 0; j < 4; j++ ) {
+			const auto offset = 4 * ( i + j );
+			const auto c0 = _mm_loadu_ps( s0 + offset );
+			const auto c1 = _mm_loadu_ps( s1 + offset );
+			_mm_storeu_ps( d + offset, _mm_add_ps( c0, _mm_mul_ps( ts[ j ], _mm_sub_ps( c1, c0 ) ) ) );
+		}
+	}
+#endif
+
+	for ( ; i < count; i++ ) {
+		const auto t = 1.0f - ( times[ i ] / lifetimes[ i ] );
+		for ( crimild::Size j = 0; j < 4; j++ ) {
+			const auto offset = 4 * i + j;
+			d[ offset ] = s0[ offset ] + t * ( s1[ offset ] - s0[ offset ] );
+		}
+	}
+}
+
+void ParticleKernels::attract( Vector3f *accelerations, const Vector3f *positions, const Vector3f &center, crimild::Real32 radius, crimild::Real32 strength, crimild::Size count )
+{
+	auto as = reinterpret_cast< crimild::Real32 * >( accelerations );
+	auto ps = reinterpret_cast< const crimild::Real32 * >( positions );
+	const auto invRadius = 1.0f / radius;
+
+	crimild::Size i = 0;
+
+#ifdef CRIMILD_PARTICLE_KERNELS_SSE2
+	// Positions are transposed so each register holds one coordinate
+	// for four particles. Particles outside the radius (or exactly at
+	// the center) are masked out instead of branching.
+	const auto cx = _mm_set1_ps( center[ 0 ] );
+	const auto cy = _mm_set1_ps( center[ 1 ] );
+	const auto cz = _mm_set1_ps( center[ 2 ] );
+	const auto r = _mm_set1_ps( radius );
+	const auto invR = _mm_set1_ps( invRadius );
+	const auto k = _mm_set1_ps( strength );
+	const auto zero = _mm_setzero_ps();
+	const auto one = _mm_set1_ps( 1.0f );
+	for ( ; i + 4 <= count; i += 4 ) {
+		const auto p = ps + 3 * i;
+		const auto dx = _mm_sub_ps( cx, _mm_setr_ps( p[ 0 ], p[ 3 ], p[ 6 ], p[ 9 ] ) );
+		const auto dy = _mm_sub_ps( cy, _mm_setr_ps( p[ 1 ], p[ 4 ], p[ 7 ], p[ 10 ] ) );
+		const auto dz = _mm_sub_ps( cz, _mm_setr_ps( p[ 2 ], p[ 5 ], p[ 8 ], p[ 11 ] ) );
+		const auto d = _mm_sqrt_ps( _mm_add_ps( _mm_mul_ps( dx, dx ), _mm_add_ps( _mm_mul_ps( dy, dy ), _mm_mul_ps( dz, dz ) ) ) );
+		const auto mask = _mm_and_ps( _mm_cmpgt_ps( d, zero ), _mm_cmple_ps( d, r ) );
+		if ( _mm_movemask_ps( mask ) == 0 ) {
+			continue;
+		}
+
+		// strength * ( 1 - d / r ) / d, where the last division normalizes the direction
+		const auto s = _mm_and_ps( mask, _mm_div_ps( _mm_mul_ps( k, _mm_sub_ps( one, _mm_mul_ps( d, invR ) ) ), d ) );
+
+		float x[ 4 ], y[ 4 ], z[ 4 ];
+		_mm_storeu_ps( x, _mm_mul_ps( s, dx ) );
+		_mm_storeu_ps( y, _mm_mul_ps( s, dy ) );
+		_mm_storeu_ps( z, _mm_mul_ps( s, dz ) );
+		auto a = as + 3 * i;
+		for ( crimild::Size j = 0; j < 4; j++ ) {
+			a[ 3 * j + 0 ] += x[ j ];
+			a[ 3 * j + 1 ] += y[ j ];
+			a[ 3 * j + 2 ] += z[ j ];
+		}
+	}
+#endif
+
+	for ( ; i < count; i++ ) {
+		const auto p = ps + 3 * i;
+		const auto dx = center[ 0 ] - p[ 0 ];
+		const auto dy = center[ 1 ] - p[ 1 ];
+		const auto dz = center[ 2 ] - p[ 2 ];
+		const auto d = std::sqrt( dx * dx + dy * dy + dz * dz );
+		if ( d > 0.0f && d <= radius ) {
+			const auto s = strength * ( 1.0f - d * invRadius ) / d;
+			auto a = as + 3 * i;
+			a[ 0 ] += s * dx;
+			a[ 1 ] += s * dy;
+			a[ 2 ] += s * dz;
+		}
+	}
+}
+
+void ParticleKernels::transformPoints( Vector3f *dst, const Vector3f *src, const Transformation &t, crimild::Size count )
+{
+	auto d = reinterpret_cast< crimild::Real32 * >( dst );
+	auto s = reinterpret_cast< const crimild::Real32 * >( src );
+
+	Vector3f bx, by, bz;
+	t.applyToVector( Vector3f::UNIT_X, bx );
+	t.applyToVector( Vector3f::UNIT_Y, by );
+	t.applyToVector( Vector3f::UNIT_Z, bz );
+	const auto &o = t.getTranslate();
+
+	for ( crimild::Size i = 0; i < count; i++ ) {
+		const auto p = s + 3 * i;
+		const auto x = p[ 0 ];
+		const auto y = p[ 1 ];
+		const auto z = p[ 2 ];
+		auto q = d + 3 * i;
+		q[ 0 ] = o[ 0 ] + x * bx[ 0 ] + y * by[ 0 ] + z * bz[ 0 ];
+		q[ 1 ] = o[ 1 ] + x * bx[ 1 ] + y * by[ 1 ] + z * bz[ 1 ];
+		q[ 2 ] = o[ 2 ] + x * bx[ 2 ] + y * by[ 2 ] + z * bz[ 2 ];
+	}
+}
+
+void ParticleKernels::computeBounds( const Vector3f *positions, crimild::Size count, Vector3f &min, Vector3f &max )
+{
+	auto ps = reinterpret_cast< const crimild::Real32 * >( positions );
+
+	crimild::Size i = 0;
+
+#ifdef CRIMILD_PARTICLE_KERNELS_SSE2
+	if ( count >= 4 ) {
+		// Every three registers hold four whole particles, where each
+		// lane always sees the same sequence of coordinates. Lanes are 
+		// merged at the end
+		auto min0 = _mm_loadu_ps( ps + 0 );
+		auto min1 = _mm_loadu_ps( ps + 4 );
+		auto min2 = _mm_loadu_ps( ps + 8 );
+		auto max0 = min0;
+		auto max1 = min1;
+		auto max2 = min2;
+		for ( i = 4; i + 4 <= count; i += 4 ) {
+			const auto p = ps + 3 * i;
+			const auto v0 = _mm_loadu_ps( p + 0 );
+			const auto v1 = _mm_loadu_ps( p + 4 );
+			const auto v2 = _mm_loadu_ps( p + 8 );
+			min0 = _mm_min_ps( min0, v0 );
+			min1 = _mm_min_ps( min1, v1 );
+			min2 = _mm_min_ps( min2, v2 );
+			max0 = _mm_max_ps( max0, v0 );
+			max1 = _mm_max_ps( max1, v1 );
+			max2 = _mm_max_ps( max2, v2 );
+		}
+
+		float lo[ 12 ], hi[ 12 ];
+		_mm_storeu_ps( lo + 0, min0 );
+		_mm_storeu_ps( lo + 4, min1 );
+		_mm_storeu_ps( lo + 8, min2 );
+		_mm_storeu_ps( hi + 0, max0 );
+		_mm_storeu_ps( hi + 4, max1 );
+		_mm_storeu_ps( hi + 8, max2 );
+
+		min = Vector3f( lo[ 0 ], lo[ 1 ], lo[ 2 ] );
+		max = Vector3f( hi[ 0 ], hi[ 1 ], hi[ 2 ] );
+		for ( crimild::Size j = 3; j < 12; j++ ) {
+			const auto axis = j % 3;
+			min[ axis ] = std::min( min[ axis ], lo[ j ] );
+			max[ axis ] = std::max( max[ axis ], hi[ j ] );
+		}
+	}
+	else
+#endif
+	{
+		min = positions[ 0 ];
+		max = positions[ 0 ];
+		i = 1;
+	}
+
+	for ( ; i < count; i++ ) {
+		const auto p = ps + 3 * i;
+		for ( crimild::Size axis = 0; axis < 3; axis++ ) {
+			min[ axis ] = std::min( min[ axis ], p[ axis ] );
+			max[ axis ] = std::max( max[ axis ], p[ axis ] );
+		}
+	}
+}
@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) 2013, Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef CRIMILD_PARTICLE_SYSTEM_KERNELS_
+#define CRIMILD_PARTICLE_SYSTEM_KERNELS_
+
+#include "Foundation/Types.hpp"
+#include "Mathematics/Vector.hpp"
+#include "Mathematics/Transformation.hpp"
+
+namespace crimild {
+
+	/**
+		\brief Vectorized loops shared by particle updaters
+
+		Kernels work on raw attribute data for the [0, count) range, so
+		updaters can run them on any block of particles. SSE is used when
+		available, processing four particles (or four floats) per step.
+		Vector3f and RGBAColorf arrays are treated as tightly packed floats.
+	*/
+	class ParticleKernels {
+	public:
+		/**
+			\brief dst[ i ] += value
+		*/
+		static void add( Vector3f *dst, const Vector3f &value, crimild::Size count );
+
+		/**
+			\brief dst[ i ] += scale * src[ i ]
+		*/
+		static void addScaled( Vector3f *dst, const Vector3f *src, crimild::Real32 scale, crimild::Size count );
+
+		/**
+			\brief dst[ i ] -= value
+		*/
+		static void subtract( crimild::Real32 *dst, crimild::Real32 value, crimild::Size count );
+
+		/**
+			\brief Interpolates values based on each particle's remaining time
+
+			dst[ i ] = lerp( start[ i ], end[ i ], 1 - times[ i ] / lifetimes[ i ] )
+		*/
+		static void lerpByAge( crimild::Real32 *dst, const crimild::Real32 *start, const crimild::Real32 *end, const crimild::Real32 *times, const crimild::Real32 *lifetimes, crimild::Size count );
+
+		/**
+			\brief Same as above, for colors
+		*/
+		static void lerpByAge( RGBAColorf *dst, const RGBAColorf *start, const RGBAColorf *end, const crimild::Real32 *times, const crimild::Real32 *lifetimes, crimild::Size count );
+
+		/**
+			\brief Accelerates particles towards a point
+
+			Particles within the given radius get an acceleration pointing 
+			to the center, scaled by how close they are to it.
+		*/
+		static void attract( Vector3f *accelerations, const Vector3f *positions, const Vector3f &center, crimild::Real32 radius, crimild::Real32 strength, crimild::Size count );
+
+		/**
+			\brief dst[ i ] = t( src[ i ] )
+
+			The transformation is expanded into a 3x4 matrix once, instead
+			of rotating each point with a quaternion. Renderers use it with 
+			the inverse world transform to bring particles simulated in 
+			world space back into local space.
+		*/
+		static void transformPoints( Vector3f *dst, const Vector3f *src, const Transformation &t, crimild::Size count );
+
+		/**
+			\brief Computes the axis-aligned box containing all positions
+
+			\remarks count must be greater than zero
+		*/
+		static void computeBounds( const Vector3f *positions, crimild::Size count, Vector3f &min, Vector3f &max );
+	};
+
+}
+
+#endif
+
@@ -0,0 +1,184 @@
+/*
+ * Copyright (c) 2013, Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "ParticleSorter.hpp"
+
+#include <cstring>
+
+using namespace crimild;
+
+/**
+	\brief Insertion sort gives up after this many shifts per particle
+*/
+static const crimild::Size MAX_INCREMENTAL_SHIFTS = 8;
+
+ParticleSorter::ParticleSorter( void )
+{
+
+}
+
+ParticleSorter::~ParticleSorter( void )
+{
+
+}
+
+ParticleSorter::Result ParticleSorter::sort( ParticleData *particles, const crimild::Real32 *keys, Order order )
+{
+	// Sorting requires a contiguous alive range
+	particles->compact();
+
+	const auto count = particles->getAliveCount();
+	if ( count < 2 ) {
+		return Result::UNCHANGED;
+	}
+
+	computeKeys( keys, count, order );
+
+	_indices.resize( count );
+	for ( crimild::Size i = 0; i < count; i++ ) {
+		_indices[ i ] = i;
+	}
+
+	auto result = Result::RADIX;
+	if ( _incremental && insertionSort( count ) ) {
+		result = Result::INCREMENTAL;
+
+		// Avoid touching attributes at all if nothing moved
+		crimild::Bool changed = false;
+		for ( crimild::Size i = 0; !changed && i < count; i++ ) {
+			changed = _indices[ i ] != i;
+		}
+		if ( !changed ) {
+			return Result::UNCHANGED;
+		}
+	}
+	else {
+		if ( _incremental ) {
+			// Insertion sort was aborted halfway through
+			computeKeys( keys, count, order );
+			for ( crimild::Size i = 0; i < count; i++ ) {
+				_indices[ i ] = i;
+			}
+		}
+		radixSort( count );
+	}
+
+	particles->permute( &_indices[ 0 ] );
+
+	return result;
+}
+
+void ParticleSorter::computeKeys( const crimild::Real32 *keys, crimild::Size count, Order order )
+{
+	// Maps floats to unsigned integers with the same ordering: positive
+	// values get their sign bit set, negative ones are inverted
+	const crimild::UInt32 flip = order == Order::DESCENDING ? 0xFFFFFFFF : 0;
+	_keys.resize( count );
+	for ( crimild::Size i = 0; i < count; i++ ) {
+		crimild::UInt32 k;
+		std::memcpy( &k, &keys[ i ], sizeof( k ) );
+		const crimild::UInt32 mask = ( k & 0x80000000 ) ? 0xFFFFFFFF : 0x80000000;
+		_keys[ i ] = ( k ^ mask ) ^ flip;
+	}
+}
+
+crimild::Bool ParticleSorter::insertionSort( crimild::Size count )
+{
+	const auto maxShifts = MAX_INCREMENTAL_SHIFTS * count;
+	crimild::Size shifts = 0;
+
+	for ( crimild::Size i = 1; i < count; i++ ) {
+		const auto key = _keys[ i ];
+		if ( _keys[ i - 1 ] <= key ) {
+			continue;
+		}
+
+		const auto index = _indices[ i ];
+		auto j = i;
+		while ( j > 0 && _keys[ j - 1 ] > key ) {
+			_keys[ j ] = _keys[ j - 1 ];
+			_indices[ j ] = _indices[ j - 1 ];
+			j--;
+		}
+		_keys[ j ] = key;
+		_indices[ j ] = index;
+
+		shifts += i - j;
+		if ( shifts > maxShifts ) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+void ParticleSorter::radixSort( crimild::Size count )
+{
+	// Histograms for all four 8-bit digits are computed in a single pass
+	crimild::Size histograms[ 4 ][ 256 ];
+	std::memset( histograms, 0, sizeof( histograms ) );
+	for ( crimild::Size i = 0; i < count; i++ ) {
+		const auto k = _keys[ i ];
+		histograms[ 0 ][ k & 0xFF ]++;
+		histograms[ 1 ][ ( k >> 8 ) & 0xFF ]++;
+		histograms[ 2 ][ ( k >> 16 ) & 0xFF ]++;
+		histograms[ 3 ][ k >> 24 ]++;
+	}
+
+	_keysTemp.resize( count );
+	_indicesTemp.resize( count );
+
+	for ( crimild::UInt32 pass = 0; pass < 4; pass++ ) {
+		auto histogram = histograms[ pass ];
+		const auto shift = 8 * pass;
+
+		// Skip digits that are the same for all keys (i.e. high bits of
+		// depths within a small range)
+		if ( histogram[ ( _keys[ 0 ] >> shift ) & 0xFF ] == count ) {
+			continue;
+		}
+
+		crimild::Size offset = 0;
+		for ( crimild::Size b = 0; b < 256; b++ ) {
+			const auto c = histogram[ b ];
+			histogram[ b ] = offset;
+			offset += c;
+		}
+
+		for ( crimild::Size i = 0; i < count; i++ ) {
+			const auto k = _keys[ i ];
+			const auto dst = histogram[ ( k >> shift ) & 0xFF ]++;
+			_keysTemp[ dst ] = k;
+			_indicesTemp[ dst ] = _indices[ i ];
+		}
+
+		_keys.swap( _keysTemp );
+		_indices.swap( _indicesTemp );
+	}
+}
+
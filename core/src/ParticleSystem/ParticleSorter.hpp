@@ -0,0 +1,103 @@
+/*
+ * Copyright (c) 2013, Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef CRIMILD_PARTICLE_SYSTEM_SORTER_
+#define CRIMILD_PARTICLE_SYSTEM_SORTER_
+
+#include "ParticleData.hpp"
+
+#include <vector>
+
+namespace crimild {
+
+	/**
+	   \brief Sorts alive particles by a per-particle key
+
+	   Keys are sorted along with an index permutation using a LSD radix
+	   sort, which is then applied to all attribute arrays in a single 
+	   gather pass (see ParticleData::permute()).
+
+	   In incremental mode, the current order (usually the result of 
+	   sorting in the previous frame) is refined with an insertion sort
+	   instead. This is faster when particles move little between frames.
+	   If there are too many elements out of place, it falls back to the
+	   radix sort. 
+
+	   Buffers are reused between calls, so no memory is allocated once
+	   they reach the maximum number of particles.
+	 */
+	class ParticleSorter {
+	public:
+		enum class Order {
+			ASCENDING,
+			DESCENDING,
+		};
+
+		/**
+		   \brief How the last call to sort() was resolved
+		 */
+		enum class Result {
+			UNCHANGED,	//< Particles were already sorted
+			INCREMENTAL,	//< Fixed with insertion sort
+			RADIX,		//< Sorted from scratch
+		};
+
+	public:
+		ParticleSorter( void );
+		~ParticleSorter( void );
+
+		inline void setIncremental( crimild::Bool value ) { _incremental = value; }
+		inline crimild::Bool isIncremental( void ) const { return _incremental; }
+
+		/**
+		   \brief Sorts alive particles
+
+		   Pending kills are compacted first. 
+
+		   \param keys One value per alive particle, after compaction
+		 */
+		Result sort( ParticleData *particles, const crimild::Real32 *keys, Order order );
+
+	private:
+		void computeKeys( const crimild::Real32 *keys, crimild::Size count, Order order );
+		crimild::Bool insertionSort( crimild::Size count );
+		void radixSort( crimild::Size count );
+
+	private:
+		crimild::Bool _incremental = false;
+
+		std::vector< crimild::UInt32 > _keys;
+		std::vector< crimild::UInt32 > _keysTemp;
+		std::vector< ParticleId > _indices;
+		std::vector< ParticleId > _indicesTemp;
+	};
+
+}
+
+#endif
+
@@ -26,11 +26,20 @@
  */
 
 #include "ParticleSystemComponent.hpp"
+#include "ParticleKernels.hpp"
+#include "ParticleBudgetManager.hpp"
+#include "SceneGraph/Node.hpp"
+#include "SceneGraph/Camera.hpp"
 #include "Coding/Encoder.hpp"
 #include "Coding/Decoder.hpp"
 
+#include <chrono>
+#include <cmath>
+
 using namespace crimild;
 
+constexpr crimild::UInt32 ParticleSystemComponent::MAX_LOD_UPDATE_INTERVAL;
+
 ParticleSystemComponent::ParticleSystemComponent( void )
 {
 
@@ -50,7 +59,9 @@ ParticleSystemComponent::ParticleSystemComponent( crimild::Size maxParticles )
 
 ParticleSystemComponent::~ParticleSystemComponent( void )
 {
-
+	if ( ParticleBudgetManager::hasInstance() ) {
+		ParticleBudgetManager::getInstance()->unregisterEmitter( this );
+	}
 }
 
 void ParticleSystemComponent::start( void )
@@ -72,6 +83,21 @@ void ParticleSystemComponent::start( void )
 		updateUpdaters( node, Clock::DEFAULT_TICK_TIME, particles );
 		warmUp -= Clock::DEFAULT_TICK_TIME;
 	}
+
+	updateParticlesBound( particles );
+
+	if ( ParticleBudgetManager::hasInstance() ) {
+		ParticleBudgetManager::getInstance()->registerEmitter( this );
+	}
+}
+
+void ParticleSystemComponent::onDetach( void )
+{
+	if ( ParticleBudgetManager::hasInstance() ) {
+		ParticleBudgetManager::getInstance()->unregisterEmitter( this );
+	}
+
+	NodeComponent::onDetach();
 }
 
 void ParticleSystemComponent::configureGenerators( Node *node, ParticleData *particles )
@@ -104,50 +130,217 @@ void ParticleSystemComponent::update( const Clock &c )
 	auto node = getNode();
 	auto particles = getParticles();
 
-	if ( isAnimationEnabled() ) {
-		updateGenerators( node, dt, particles );
-		updateUpdaters( node, dt, particles );
+	_simulationStats = SimulationStats();
+
+	if ( !isAnimationEnabled() ) {
+		_particleDemand = particles->getAliveCount();
+		updateRenderers( node, dt, particles );
+		return;
+	}
+
+	updateWorldBound( node, particles );
+
+	auto camera = Camera::getMainCamera();
+	_culled = isCullingEnabled() && camera != nullptr && camera->culled( crimild::get_ptr( _worldBound ) );
+	if ( _culled ) {
+		// Particles are frozen (and not rendered) until the emitter is visible again
+		_skippedTime += dt;
+		_simulationStats.skipped = particles->getAliveCount();
+		_particleDemand = particles->getAliveCount();
+		return;
+	}
+
+	if ( _skippedTime > 0.0 ) {
+		catchUp( node, particles );
+	}
+
+	_lodScale = computeLODScale( camera );
+
+	// Far away emitters are simulated less often, but using the
+	// accumulated time so they still look the same
+	_lodAccumTime += dt;
+	if ( ++_lodFrame >= getLODUpdateInterval() ) {
+		simulate( node, _lodAccumTime, particles );
+		_simulationStats.simulated = particles->getAliveCount();
+		_lodAccumTime = 0.0;
+		_lodFrame = 0;
+	}
+	else {
+		_simulationStats.skipped = particles->getAliveCount();
 	}
+
+	const auto expectedEmission = _burst ? _emitRate : dt * _emitRate;
+	_particleDemand = Numeric< crimild::Size >::min( particles->getParticleCount(), particles->getAliveCount() + ( crimild::Size ) std::ceil( _lodScale * expectedEmission ) );
 	
 	updateRenderers( node, dt, particles );
 }
 
+void ParticleSystemComponent::simulate( Node *node, crimild::Real64 dt, ParticleData *particles )
+{
+	updateGenerators( node, dt, particles );
+	updateUpdaters( node, dt, particles );
+	updateParticlesBound( particles );
+}
+
+void ParticleSystemComponent::catchUp( Node *node, ParticleData *particles )
+{
+	auto remaining = Numeric< crimild::Real64 >::min( _skippedTime, _maxCatchUpTime );
+	_skippedTime = 0.0;
+
+	while ( remaining > 0.0 ) {
+		const auto step = Numeric< crimild::Real64 >::min( remaining, Clock::DEFAULT_TICK_TIME );
+		updateGenerators( node, step, particles );
+		updateUpdaters( node, step, particles );
+		remaining -= step;
+	}
+
+	updateParticlesBound( particles );
+	updateWorldBound( node, particles );
+}
+
+void ParticleSystemComponent::updateParticlesBound( ParticleData *particles )
+{
+	const auto count = particles->getAliveCount();
+	const auto positions = particles->getAttrib( ParticleAttrib::POSITION );
+	if ( count == 0 || positions == nullptr ) {
+		_particlesBound->computeFrom( Vector3f::ZERO, Vector3f::ZERO );
+		return;
+	}
+
+	Vector3f min, max;
+	ParticleKernels::computeBounds( positions->getData< Vector3f >(), count, min, max );
+
+	const auto padding = _boundsPadding * Vector3f::ONE;
+	_particlesBound->computeFrom( min - padding, max + padding );
+}
+
+void ParticleSystemComponent::updateWorldBound( Node *node, ParticleData *particles )
+{
+	if ( particles->shouldComputeInWorldSpace() ) {
+		_worldBound->computeFrom( crimild::get_ptr( _particlesBound ), Transformation() );
+	}
+	else {
+		_worldBound->computeFrom( crimild::get_ptr( _particlesBound ), node->getWorld() );
+	}
+
+	// Always include the emitter, since new particles will spawn around it
+	_worldBound->expandToContain( node->getWorld().getTranslate() );
+}
+
+crimild::Real32 ParticleSystemComponent::computeLODScale( Camera *camera ) const
+{
+	if ( camera == nullptr || _lodFarDistance <= _lodNearDistance ) {
+		return 1.0f;
+	}
+
+	const auto d = Numeric< crimild::Real32 >::max( 0.0f, ( _worldBound->getCenter() - camera->getWorld().getTranslate() ).getMagnitude() - _worldBound->getRadius() );
+	const auto t = Numeric< crimild::Real32 >::clamp( ( d - _lodNearDistance ) / ( _lodFarDistance - _lodNearDistance ), 0.0f, 1.0f );
+	return 1.0f + t * ( _minLODScale - 1.0f );
+}
+
+crimild::UInt32 ParticleSystemComponent::getLODUpdateInterval( void ) const
+{
+	if ( _lodScale >= 1.0f ) {
+		return 1;
+	}
+
+	return Numeric< crimild::UInt32 >::clamp( ( crimild::UInt32 ) std::round( 1.0f / _lodScale ), 1, MAX_LOD_UPDATE_INTERVAL );
+}
+
 void ParticleSystemComponent::updateGenerators( Node *node, crimild::Real64 dt, ParticleData *particles )
 {
-	_emitAccum += _burst ? _emitRate : dt * _emitRate;
+	const auto emitRate = _lodScale * _emitRate;
+	_emitAccum += _burst ? emitRate : dt * emitRate;
 	if ( _emitAccum < 1.0 ) {
 		return;
 	}
 	
-    const ParticleId maxNewParticles = ( int ) _emitAccum;//_burst ? _emitRate : Numeric< ParticleId >::max( 1, dt * _emitRate );
+    ParticleId maxNewParticles = ( int ) _emitAccum;//_burst ? _emitRate : Numeric< ParticleId >::max( 1, dt * _emitRate );
 	_emitAccum -= maxNewParticles;
 	
     const ParticleId startId = particles->getAliveCount();            
+
+	// Do not emit past the budget. Throttled particles are discarded
+	const auto available = _particleBudget > startId ? _particleBudget - startId : 0;
+	if ( maxNewParticles > available ) {
+		_simulationStats.throttled += maxNewParticles - available;
+		maxNewParticles = available;
+	}
     const ParticleId endId = Numeric< ParticleId >::min( startId + maxNewParticles, particles->getParticleCount() - 1 );
+	if ( endId <= startId ) {
+		return;
+	}
 
-	_generators.each( [ node, dt, particles, startId, endId ]( SharedPointer< ParticleGenerator > &g ) {
-		g->generate( node, dt, particles, startId, endId );
-	});
+	if ( _hasRandomSeed ) {
+		Random::ScopedGenerator scope( _random );
+		runGenerators( node, dt, particles, startId, endId );
+	}
+	else {
+		runGenerators( node, dt, particles, startId, endId );
+	}
 
     for ( ParticleId i = startId; i < endId; i++ ) {
         particles->wake( i );
     }
 }
 
+void ParticleSystemComponent::runGenerators( Node *node, crimild::Real64 dt, ParticleData *particles, ParticleId startId, ParticleId endId )
+{
+	_generators.each( [ node, dt, particles, startId, endId ]( SharedPointer< ParticleGenerator > &g ) {
+		g->generate( node, dt, particles, startId, endId );
+	});
+}
+
+void ParticleSystemComponent::setRandomSeed( crimild::UInt64 seed )
+{
+	_random.seed( seed );
+	_hasRandomSeed = true;
+}
+
 void ParticleSystemComponent::updateUpdaters( Node *node, crimild::Real64 dt, ParticleData *particles )
 {
 	_updaters.each( [ node, dt, particles ]( SharedPointer< ParticleUpdater > &u ) {
 		u->update( node, dt, particles );
 	});
+
+	// In case any updater killed particles without compacting them
+	particles->compact();
 }
 
 void ParticleSystemComponent::updateRenderers( Node *node, crimild::Real64 dt, ParticleData *particles )
 {
 	_renderers.each( [ node, dt, particles ]( SharedPointer< ParticleRenderer > &r ) {
+		const auto start = std::chrono::steady_clock::now();
 		r->update( node, dt, particles );
+		r->_stats.cpuTime = std::chrono::duration< crimild::Real64 >( std::chrono::steady_clock::now() - start ).count();
 	});
 }
 
+const Vector3f *ParticleSystemComponent::ParticleRenderer::toLocalSpace( Node *node, ParticleData *particles, const Vector3f *positions )
+{
+	if ( !particles->shouldComputeInWorldSpace() ) {
+		return positions;
+	}
+
+	const auto count = particles->getAliveCount();
+	if ( _localPositions.size() < count ) {
+		_localPositions.resize( particles->getParticleCount() );
+	}
+
+	ParticleKernels::transformPoints( &_localPositions[ 0 ], positions, node->getWorld().getInverse(), count );
+	return &_localPositions[ 0 ];
+}
+
+ParticleSystemComponent::ParticleRenderer::Stats ParticleSystemComponent::getRendererStats( void )
+{
+	ParticleRenderer::Stats stats;
+	_renderers.each( [ &stats ]( SharedPointer< ParticleRenderer > &r ) {
+		stats.cpuTime += r->getStats().cpuTime;
+		stats.uploadedBytes += r->getStats().uploadedBytes;
+	});
+	return stats;
+}
+
 void ParticleSystemComponent::encode( coding::Encoder &encoder ) 
 {
 	NodeComponent::encode( encoder );
@@ -156,6 +349,13 @@ void ParticleSystemComponent::encode( coding::Encoder &encoder )
 	encoder.encode( "emitRate", _emitRate );
 	encoder.encode( "preWarmTime", _preWarmTime );
 	encoder.encode( "burst", _burst );
+	encoder.encode( "cullingEnabled", _cullingEnabled );
+	encoder.encode( "boundsPadding", _boundsPadding );
+	encoder.encode( "maxCatchUpTime", _maxCatchUpTime );
+	encoder.encode( "lodNearDistance", _lodNearDistance );
+	encoder.encode( "lodFarDistance", _lodFarDistance );
+	encoder.encode( "minLODScale", _minLODScale );
+	encoder.encode( "priority", _priority );
 	encoder.encode( "generators", _generators );
 	encoder.encode( "updaters", _updaters );
 	encoder.encode( "renderers", _renderers );
@@ -176,6 +376,14 @@ void ParticleSystemComponent::decode( coding::Decoder &decoder )
 	_burst = false;
 	decoder.decode( "burst", _burst );
 
+	decoder.decode( "cullingEnabled", _cullingEnabled );
+	decoder.decode( "boundsPadding", _boundsPadding );
+	decoder.decode( "maxCatchUpTime", _maxCatchUpTime );
+	decoder.decode( "lodNearDistance", _lodNearDistance );
+	decoder.decode( "lodFarDistance", _lodFarDistance );
+	decoder.decode( "minLODScale", _minLODScale );
+	decoder.decode( "priority", _priority );
+
 	decoder.decode( "generators", _generators );
 	decoder.decode( "updaters", _updaters );
 	decoder.decode( "renderers", _renderers );
@@ -31,9 +31,17 @@
 #include "ParticleData.hpp"
 
 #include "Components/NodeComponent.hpp"
+#include "Boundings/AABBBoundingVolume.hpp"
+#include "Boundings/SphereBoundingVolume.hpp"
+#include "Mathematics/Random.hpp"
+
+#include <limits>
+#include <vector>
 
 namespace crimild {
 
+	class Camera;
+
     /**
         \remarks Since it's a component, the particle sytem
         can affect the parent node any wait it likes
@@ -61,6 +69,7 @@ namespace crimild {
 
 		virtual void start( void ) override;
 		virtual void update( const Clock & ) override;
+		virtual void onDetach( void ) override;
 
     private:
         SharedPointer< ParticleData > _particles;
@@ -126,15 +135,28 @@ namespace crimild {
 		inline void setBurst( bool value ) { _burst = value; }
 		inline crimild::Bool isBurst( void ) const { return _burst; }
 
+		/**
+			\brief Sets the seed used by generators
+
+			\remarks By default, generators use the random generator of the 
+			calling thread. Once a seed is set, the emitter uses its own 
+			generator instead, spawning the same particles on every run.
+		*/
+		void setRandomSeed( crimild::UInt64 seed );
+		inline crimild::Bool hasRandomSeed( void ) const { return _hasRandomSeed; }
+
 	private:
 		void configureGenerators( Node *node, ParticleData *particles );
 		void updateGenerators( Node *node, crimild::Real64 dt, ParticleData *particles );
+		void runGenerators( Node *node, crimild::Real64 dt, ParticleData *particles, ParticleId startId, ParticleId endId );
 
     private:
         crimild::Real32 _emitRate;
 		crimild::Real32 _emitAccum = 1.0f;
         containers::Array< ParticleGeneratorPtr > _generators;
 		crimild::Bool _burst = false;
+		crimild::Bool _hasRandomSeed = false;
+		Random::Generator _random;
 		
 		//@}
 
@@ -184,6 +206,39 @@ namespace crimild {
 
 			virtual void configure( Node *node, ParticleData *particles ) = 0;
             virtual void update( Node *node, crimild::Real64 dt, ParticleData *particles ) = 0;
+
+			/**
+				\brief Per-frame rendering costs
+			*/
+			struct Stats {
+				crimild::Real64 cpuTime = 0.0;		//< Seconds spent in the last update
+				crimild::Size uploadedBytes = 0;	//< Bytes marked for upload in the last update
+			};
+
+			inline const Stats &getStats( void ) const { return _stats; }
+
+		protected:
+			/**
+				\brief Renderers must set stats.uploadedBytes on every update.
+				The CPU time is measured by the component
+			*/
+			Stats _stats;
+
+			/**
+				\brief Brings positions into the node's local space
+
+				If particles are computed in world space, positions are
+				transformed by the inverse of the node's world transform,
+				which is computed only once. Results are written into a
+				scratch buffer that is reused between frames. Otherwise, 
+				the input array is returned as is.
+			*/
+			const Vector3f *toLocalSpace( Node *node, ParticleData *particles, const Vector3f *positions );
+
+		private:
+			std::vector< Vector3f > _localPositions;
+
+			friend class ParticleSystemComponent;
         };
 
         using ParticleRendererPtr =  SharedPointer< ParticleRenderer >;
@@ -193,6 +248,11 @@ namespace crimild {
 			_renderers.add( renderer );
 		}
 
+		/**
+			\brief Accumulated stats for all renderers in the last frame
+		*/
+		ParticleRenderer::Stats getRendererStats( void );
+
 	private:
 		void configureRenderers( Node *node, ParticleData *particles );
 		void updateRenderers( Node *node, crimild::Real64 dt, ParticleData *particles );
@@ -202,6 +262,130 @@ namespace crimild {
 
 		//@}
 
+		/**
+		   \name Culling and level of detail
+		*/
+		//@{
+
+	public:
+		/**
+		   \brief Enables skipping simulation when the emitter is not visible
+
+		   Visibility is tested against the main camera using a bounding sphere
+		   that contains all alive particles and the emitter itself.
+		 */
+		inline void setCullingEnabled( crimild::Bool enabled ) { _cullingEnabled = enabled; }
+		inline crimild::Bool isCullingEnabled( void ) const { return _cullingEnabled; }
+
+		inline crimild::Bool isCulled( void ) const { return _culled; }
+
+		/**
+		   \brief Extra radius added to the bounds, accounting for particle sizes
+		 */
+		inline void setBoundsPadding( crimild::Real32 padding ) { _boundsPadding = padding; }
+		inline crimild::Real32 getBoundsPadding( void ) const { return _boundsPadding; }
+
+		inline const BoundingVolume *getParticlesWorldBound( void ) const { return crimild::get_ptr( _worldBound ); }
+
+		/**
+		   \brief Maximum time simulated when the emitter becomes visible again
+
+		   If zero (the default), particles resume from where they were
+		   when culled. Otherwise, the time skipped while culled is 
+		   simulated in fixed steps, up to this value.
+		 */
+		inline void setMaxCatchUpTime( crimild::Real64 time ) { _maxCatchUpTime = time; }
+		inline crimild::Real64 getMaxCatchUpTime( void ) const { return _maxCatchUpTime; }
+
+		/**
+		   \brief Distances to the main camera where the LOD scale starts/stops decreasing
+
+		   Emitters closer than 'nearDistance' use the full emit and update 
+		   rates. Both decrease linearly down to the minimum LOD scale at 
+		   'farDistance'. LOD is disabled if 'farDistance' is not greater 
+		   than 'nearDistance' (the default).
+		 */
+		inline void setLODDistances( crimild::Real32 nearDistance, crimild::Real32 farDistance ) { _lodNearDistance = nearDistance; _lodFarDistance = farDistance; }
+		inline crimild::Real32 getLODNearDistance( void ) const { return _lodNearDistance; }
+		inline crimild::Real32 getLODFarDistance( void ) const { return _lodFarDistance; }
+
+		inline void setMinLODScale( crimild::Real32 scale ) { _minLODScale = scale; }
+		inline crimild::Real32 getMinLODScale( void ) const { return _minLODScale; }
+
+		/**
+		   \brief Scale applied to emit and update rates in the last frame
+		 */
+		inline crimild::Real32 getLODScale( void ) const { return _lodScale; }
+
+		/**
+		   \brief Number of frames between simulation steps for the current LOD scale
+		 */
+		crimild::UInt32 getLODUpdateInterval( void ) const;
+
+		static constexpr crimild::UInt32 MAX_LOD_UPDATE_INTERVAL = 8;
+
+		/**
+		   \brief Higher priority emitters get their share of the particle budget first
+		 */
+		inline void setPriority( crimild::Int32 priority ) { _priority = priority; }
+		inline crimild::Int32 getPriority( void ) const { return _priority; }
+
+		/**
+		   \brief Maximum number of alive particles after emission
+
+		   Assigned by the ParticleBudgetManager, if any. Existing particles
+		   are never killed, but no new ones are emitted past this value.
+		 */
+		inline void setParticleBudget( crimild::Size budget ) { _particleBudget = budget; }
+		inline crimild::Size getParticleBudget( void ) const { return _particleBudget; }
+
+		/**
+		   \brief Particles this emitter expects to have alive in the next frame
+		 */
+		inline crimild::Size getParticleDemand( void ) const { return _particleDemand; }
+
+		/**
+		   \brief Per-frame simulation counts
+		 */
+		struct SimulationStats {
+			crimild::Size simulated = 0;	//< Alive particles updated in the last frame
+			crimild::Size skipped = 0;		//< Alive particles not updated because of culling or LOD
+			crimild::Size throttled = 0;	//< Particles not emitted because of the budget
+		};
+
+		inline const SimulationStats &getSimulationStats( void ) const { return _simulationStats; }
+
+	private:
+		void simulate( Node *node, crimild::Real64 dt, ParticleData *particles );
+		void catchUp( Node *node, ParticleData *particles );
+		void updateParticlesBound( ParticleData *particles );
+		void updateWorldBound( Node *node, ParticleData *particles );
+		crimild::Real32 computeLODScale( Camera *camera ) const;
+
+	private:
+		crimild::Bool _cullingEnabled = true;
+		crimild::Bool _culled = false;
+		crimild::Real32 _boundsPadding = 1.0f;
+		SharedPointer< AABBBoundingVolume > _particlesBound = crimild::alloc< AABBBoundingVolume >();
+		SharedPointer< SphereBoundingVolume > _worldBound = crimild::alloc< SphereBoundingVolume >();
+		crimild::Real64 _maxCatchUpTime = 0.0;
+		crimild::Real64 _skippedTime = 0.0;
+
+		crimild::Real32 _lodNearDistance = 0.0f;
+		crimild::Real32 _lodFarDistance = 0.0f;
+		crimild::Real32 _minLODScale = 0.25f;
+		crimild::Real32 _lodScale = 1.0f;
+		crimild::UInt32 _lodFrame = 0;
+		crimild::Real64 _lodAccumTime = 0.0;
+
+		crimild::Int32 _priority = 0;
+		crimild::Size _particleBudget = std::numeric_limits< crimild::Size >::max();
+		crimild::Size _particleDemand = 0;
+
+		SimulationStats _simulationStats;
+
+		//@}
+
 	public:
 		inline void setAnimationEnabled( crimild::Bool enabled ) { _animationEnabled = enabled; }
 		inline crimild::Bool isAnimationEnabled( void ) const { return _animationEnabled; }
@@ -35,8 +35,6 @@
 
 #include "SceneGraph/Camera.hpp"
 
-#include "Concurrency/Async.hpp"
-
 using namespace crimild;
 
 AnimatedSpriteParticleRenderer::AnimatedSpriteParticleRenderer( void )
@@ -70,18 +68,53 @@ void AnimatedSpriteParticleRenderer::configure( Node *node, ParticleData *partic
 
     _primitive = crimild::alloc< Primitive >( Primitive::Type::TRIANGLES );
 
+	// Buffers are allocated only once for the maximum number of particles
+	// and then updated in place every frame
+	const auto maxCount = particles->getParticleCount();
+
+	_vbo = crimild::alloc< VertexBufferObject >( VertexFormat::VF_P3_UV2, 4 * maxCount );
+	_vbo->setUsage( VertexBufferObject::Usage::STREAM );
+
+	_ibo = crimild::alloc< IndexBufferObject >( 6 * maxCount, IndexBufferObject::getIndexTypeForVertexCount( 4 * maxCount ) );
+	for ( crimild::Size i = 0; i < maxCount; i++ ) {
+		const auto idx = i * 6;
+		const auto vdx = i * 4;
+		_ibo->setIndexAt( idx + 0, vdx + 0 );
+		_ibo->setIndexAt( idx + 1, vdx + 1 );
+		_ibo->setIndexAt( idx + 2, vdx + 2 );
+		_ibo->setIndexAt( idx + 3, vdx + 0 );
+		_ibo->setIndexAt( idx + 4, vdx + 2 );
+		_ibo->setIndexAt( idx + 5, vdx + 3 );
+	}
+
+	_vbo->setVertexCount( 0 );
+	_ibo->setIndexCount( 0 );
+
+	_primitive->setVertexBuffer( _vbo );
+	_primitive->setIndexBuffer( _ibo );
+
 	_geometry->attachPrimitive( _primitive );
 }
 
 void AnimatedSpriteParticleRenderer::update( Node *node, crimild::Real64 dt, ParticleData *particles )
 {
+	_stats.uploadedBytes = 0;
+
     const auto pCount = particles->getAliveCount();
     if ( pCount == 0 ) {
+		if ( _ibo->getIndexCount() > 0 ) {
+			// nothing to render, but avoid drawing stale particles
+			_vbo->setVertexCount( 0 );
+			_ibo->setIndexCount( 0 );
+			_vbo->invalidate();
+		}
         return;
     }
-    
-    auto vbo = crimild::alloc< VertexBufferObject >( VertexFormat::VF_P3_UV2, 4 * pCount );
-	auto ibo = crimild::alloc< IndexBufferObject >( 6 * pCount );
+
+	// Counts are never larger than the ones used in configure(), 
+	// so no memory is allocated here
+	_vbo->setVertexCount( 4 * pCount );
+	_ibo->setIndexCount( 6 * pCount );
 
 	auto up = Vector3f::UNIT_Y;
 	auto right = Vector3f::UNIT_X;
@@ -95,36 +128,35 @@ void AnimatedSpriteParticleRenderer::update( Node *node, crimild::Real64 dt, Par
 		node->getWorld().applyInverseToVector( right, right );
 	}
 
-	const auto offset0 = up - right;
-	const auto offset1 = -up - right;
-	const auto offset2 = -up + right;
-	const auto offset3 = up + right;
+	const Vector3f offsets[] = {
+		up - right,
+		-up - right,
+		-up + right,
+		up + right,
+	};
 
 	const crimild::UInt8 frameCount = _spriteSheetSize.x() * _spriteSheetSize.y();
 	const auto spriteSize = Vector2f( 1.0f / _spriteSheetSize.x(), 1.0f / _spriteSheetSize.y() );
 
-	const auto uv0 = Vector2f( 0.0f, 0.0f );
-	const auto uv1 = Vector2f( 0.0f, spriteSize.y() );
-	const auto uv2 = Vector2f( spriteSize.x(), spriteSize.y() );
-	const auto uv3 = Vector2f( spriteSize.x(), 0.0f );
+	const Vector2f uvs[] = {
+		Vector2f( 0.0f, 0.0f ),
+		Vector2f( 0.0f, spriteSize.y() ),
+		Vector2f( spriteSize.x(), spriteSize.y() ),
+		Vector2f( spriteSize.x(), 0.0f ),
+	};
 
-	const auto ps = _positions->getData< Vector3f >();
+	const auto ps = toLocalSpace( node, particles, _positions->getData< Vector3f >() );
 	const auto ss = _sizes->getData< crimild::Real32 >();
 	const auto timeData = _times->getData< crimild::Real32 >();
 	const auto lifetimeData = _lifetimes->getData< crimild::Real32 >();
 
-	// Vertex data is interleaved, so it should be more efficient
-	// to set each vertex attribute per loop (as below) instead of
-	// using separated loops (as in the case of other updaters/renderers)
-	// TODO: I need to confirm this somehow
-	for ( auto i = 0; i < pCount; i++ ) {
-		auto idx = i * 4;
-		auto pos = ps[ i ];
-		if ( particles->shouldComputeInWorldSpace() ) {
-			// TODO: cache inverse transform?
-			node->getWorld().applyInverseToPoint( pos, pos );
-		}
-		auto s = ss[ i ];
+	const auto &format = _vbo->getVertexFormat();
+	const auto stride = format.getVertexSize();
+	const auto uvsOffset = format.getTextureCoordsOffset();
+	auto vs = _vbo->data();
+	for ( crimild::Size i = 0; i < pCount; i++ ) {
+		const auto &p = ps[ i ];
+		const auto s = ss[ i ];
 		
 		const auto t = 1.0f - ( timeData[ i ] / lifetimeData[ i ] );
 		const auto frame = ( crimild::UInt8 )( frameCount * t );
@@ -132,34 +164,23 @@ void AnimatedSpriteParticleRenderer::update( Node *node, crimild::Real64 dt, Par
 		const auto fy = frame / ( ( crimild::UInt8 ) _spriteSheetSize.y() );
 		const auto frameOffset = Vector2f( fx * spriteSize.x(), fy * spriteSize.y() );
 
-		vbo->setPositionAt( idx + 0, pos + s * offset0 );
-		vbo->setTextureCoordAt( idx + 0, frameOffset + uv0 );
-		
-		vbo->setPositionAt( idx + 1, pos + s * offset1 );
-		vbo->setTextureCoordAt( idx + 1, frameOffset + uv1 );
-		
-		vbo->setPositionAt( idx + 2, pos + s * offset2 );
-		vbo->setTextureCoordAt( idx + 2, frameOffset + uv2 );
+		for ( crimild::Size corner = 0; corner < 4; corner++ ) {
+			const auto &offset = offsets[ corner ];
+			vs[ 0 ] = p[ 0 ] + s * offset[ 0 ];
+			vs[ 1 ] = p[ 1 ] + s * offset[ 1 ];
+			vs[ 2 ] = p[ 2 ] + s * offset[ 2 ];
 
-		vbo->setPositionAt( idx + 3, pos + s * offset3 );
-		vbo->setTextureCoordAt( idx + 3, frameOffset + uv3 );
-	}
+			auto uv = vs + uvsOffset;
+			uv[ 0 ] = frameOffset[ 0 ] + uvs[ corner ][ 0 ];
+			uv[ 1 ] = frameOffset[ 1 ] + uvs[ corner ][ 1 ];
 
-	for ( auto i = 0; i < pCount; i++ ) {
-		const auto idx = i * 6;
-		const auto vdx = i * 4;
-		ibo->setIndexAt( idx + 0, vdx + 0 );
-		ibo->setIndexAt( idx + 1, vdx + 1 );
-		ibo->setIndexAt( idx + 2, vdx + 2 );
-		ibo->setIndexAt( idx + 3, vdx + 0 );
-		ibo->setIndexAt( idx + 4, vdx + 2 );
-		ibo->setIndexAt( idx + 5, vdx + 3 );
+			vs += stride;
+		}
 	}
 
-    crimild::concurrency::sync_frame( [this, vbo, ibo] {
-        _primitive->setVertexBuffer( vbo );
-        _primitive->setIndexBuffer( ibo );
-    });
+	_vbo->invalidate();
+
+	_stats.uploadedBytes = _vbo->getSizeInBytes();
 }
 
 void AnimatedSpriteParticleRenderer::encode( coding::Encoder &encoder ) 
@@ -59,6 +59,8 @@ namespace crimild {
 		MaterialPtr _material;
 		PrimitivePtr _primitive;
 		GeometryPtr _geometry;
+		VertexBufferObjectPtr _vbo;
+		IndexBufferObjectPtr _ibo;
 		Vector2f _spriteSheetSize;
 
 		crimild::Bool _useOrientedQuads = true;
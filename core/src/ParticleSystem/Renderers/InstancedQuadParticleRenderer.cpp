@@ -0,0 +1,204 @@
+/*
+ * Copyright (c) 2013, Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "InstancedQuadParticleRenderer.hpp"
+
+#include "Rendering/Renderer.hpp"
+
+#include "Components/MaterialComponent.hpp"
+
+#include "Simulation/AssetManager.hpp"
+
+using namespace crimild;
+
+InstancedQuadParticleRenderer::InstancedQuadParticleRenderer( void )
+{
+	// create the material here so it can be modified later
+	_material = crimild::alloc< Material >();
+
+    auto program = crimild::retain( AssetManager::getInstance()->get< ShaderProgram >( Renderer::SHADER_PROGRAM_PARTICLE_INSTANCED ) );
+    _material->setProgram( program );
+}
+
+InstancedQuadParticleRenderer::~InstancedQuadParticleRenderer( void )
+{
+
+}
+
+void InstancedQuadParticleRenderer::configure( Node *node, ParticleData *particles ) 
+{
+	_geometry = crimild::alloc< Geometry >();
+	if ( _material != nullptr ) {
+		_geometry->getComponent< MaterialComponent >()->attachMaterial( _material );
+	}
+
+	static_cast< Group * >( node )->attachNode( _geometry );
+
+	_positions = particles->getAttrib( ParticleAttrib::POSITION );
+	assert( _positions != nullptr );
+
+	// colors and sizes are optional
+	_colors = particles->getAttrib( ParticleAttrib::COLOR );
+	_sizes = particles->getAttrib( ParticleAttrib::UNIFORM_SCALE );
+
+    _primitive = crimild::alloc< Primitive >( Primitive::Type::TRIANGLES );
+
+	// A single quad shared by all particles. Positions are the corner
+	// directions, which are scaled by each particle's size and aligned
+	// with the camera in the vertex shader
+	crimild::Real32 vertices[] = {
+		-1.0f, 1.0f, 0.0f, 0.0f, 0.0f,
+		-1.0f, -1.0f, 0.0f, 0.0f, 1.0f,
+		1.0f, -1.0f, 0.0f, 1.0f, 1.0f,
+		1.0f, 1.0f, 0.0f, 1.0f, 0.0f,
+	};
+	_primitive->setVertexBuffer( crimild::alloc< VertexBufferObject >( VertexFormat::VF_P3_UV2, 4, vertices ) );
+
+	auto ibo = crimild::alloc< IndexBufferObject >( 6, IndexBufferObject::IndexType::UINT16 );
+	ibo->setIndexAt( 0, 0 );
+	ibo->setIndexAt( 1, 1 );
+	ibo->setIndexAt( 2, 2 );
+	ibo->setIndexAt( 3, 0 );
+	ibo->setIndexAt( 4, 2 );
+	ibo->setIndexAt( 5, 3 );
+	_primitive->setIndexBuffer( ibo );
+
+	// Per-instance data is allocated only once for the maximum number of
+	// particles. Size is stored in the first texture coordinate
+	_instances = crimild::alloc< VertexBufferObject >( VertexFormat::VF_P3_C4_UV2, particles->getParticleCount() );
+	_instances->setUsage( VertexBufferObject::Usage::STREAM );
+	_instances->setVertexCount( 0 );
+	_primitive->setInstanceBuffer( _instances );
+
+	_geometry->attachPrimitive( _primitive );
+}
+
+void InstancedQuadParticleRenderer::update( Node *node, crimild::Real64 dt, ParticleData *particles )
+{
+	_stats.uploadedBytes = 0;
+
+    const auto pCount = particles->getAliveCount();
+    if ( pCount == 0 ) {
+		if ( _instances->getVertexCount() > 0 ) {
+			// nothing to render, but avoid drawing stale particles
+			_instances->setVertexCount( 0 );
+			_instances->invalidate();
+		}
+        return;
+    }
+
+	_instances->setVertexCount( pCount );
+
+	const auto ps = toLocalSpace( node, particles, _positions->getData< Vector3f >() );
+	const auto ss = _sizes != nullptr ? _sizes->getData< crimild::Real32 >() : nullptr;
+	const auto cs = _colors != nullptr ? _colors->getData< RGBAColorf >() : nullptr;
+	const auto defaultColor = RGBAColorf::ONE;
+
+	const auto &format = _instances->getVertexFormat();
+	const auto stride = format.getVertexSize();
+	const auto colorsOffset = format.getColorsOffset();
+	const auto uvsOffset = format.getTextureCoordsOffset();
+	auto vs = _instances->data();
+	for ( crimild::Size i = 0; i < pCount; i++ ) {
+		const auto &p = ps[ i ];
+		vs[ 0 ] = p[ 0 ];
+		vs[ 1 ] = p[ 1 ];
+		vs[ 2 ] = p[ 2 ];
+
+		const auto &c = cs != nullptr ? cs[ i ] : defaultColor;
+		auto color = vs + colorsOffset;
+		color[ 0 ] = c[ 0 ];
+		color[ 1 ] = c[ 1 ];
+		color[ 2 ] = c[ 2 ];
+		color[ 3 ] = c[ 3 ];
+
+		auto uv = vs + uvsOffset;
+		uv[ 0 ] = ss != nullptr ? ss[ i ] : 1.0f;
+		uv[ 1 ] = 0.0f;
+
+		vs += stride;
+	}
+
+	_instances->invalidate();
+
+	_stats.uploadedBytes = _instances->getSizeInBytes();
+}
+
+void InstancedQuadParticleRenderer::encode( coding::Encoder &encoder ) 
+{
+	ParticleSystemComponent::ParticleRenderer::encode( encoder );
+
+	encoder.encode( "material", _material );
+}
+
+void InstancedQuadParticleRenderer::decode( coding::Decoder &decoder )
+{
+	ParticleSystemComponent::ParticleRenderer::decode( decoder );
+
+	decoder.decode( "material", _material );
+
+	if ( _material == nullptr ) {
+		_material = crimild::alloc< Material >();
+	}
+	
+	auto program = crimild::retain( AssetManager::getInstance()->get< ShaderProgram >( Renderer::SHADER_PROGRAM_PARTICLE_INSTANCED ) );
+    _material->setProgram( program );
+
+    std::string blendMode;
+    decoder.decode( "blendMode", blendMode );
+    if ( blendMode == "additive" ) {
+        _material->setAlphaState( crimild::alloc< AlphaState >( true, AlphaState::SrcBlendFunc::SRC_ALPHA, AlphaState::DstBlendFunc::ONE ) );
+    }
+    else if ( blendMode == "color" ) {
+        _material->setAlphaState( crimild::alloc< AlphaState >( true, AlphaState::SrcBlendFunc::SRC_COLOR, AlphaState::DstBlendFunc::ONE_MINUS_SRC_COLOR ) );
+    }
+    else if ( blendMode == "transparent" ) {
+        _material->setAlphaState( crimild::alloc< AlphaState >( true, AlphaState::SrcBlendFunc::SRC_ALPHA, AlphaState::DstBlendFunc::ONE_MINUS_SRC_ALPHA ) );
+    }
+    else if ( blendMode == "additive_no_alpha" ) {
+        _material->setAlphaState( crimild::alloc< AlphaState >( true, AlphaState::SrcBlendFunc::ONE, AlphaState::DstBlendFunc::ONE ) );
+    }
+    else if ( blendMode == "multiply" ) {
+        _material->setAlphaState( crimild::alloc< AlphaState >( true, AlphaState::SrcBlendFunc::ONE, AlphaState::DstBlendFunc::ONE_MINUS_SRC_ALPHA ) );
+    }
+    else if ( blendMode == "default" ) {
+        _material->setAlphaState( AlphaState::ENABLED );
+    }
+    else {
+        _material->setAlphaState( AlphaState::DISABLED );
+    }
+    
+    crimild::Bool cullFaceEnabled = true;
+    decoder.decode( "cullFaceEnabled", cullFaceEnabled );
+    _material->getCullFaceState()->setEnabled( cullFaceEnabled );
+    
+    crimild::Bool depthStateEnabled = true;
+    decoder.decode( "depthStateEnabled", depthStateEnabled );
+    _material->setDepthState( depthStateEnabled ? DepthState::ENABLED : DepthState::DISABLED );
+}
+
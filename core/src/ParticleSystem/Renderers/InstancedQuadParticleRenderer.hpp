@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) 2013, Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef CRIMILD_PARTICLE_RENDERER_INSTANCED_QUAD_
+#define CRIMILD_PARTICLE_RENDERER_INSTANCED_QUAD_
+
+#include "../ParticleSystemComponent.hpp"
+
+#include "Rendering/Material.hpp"
+
+#include "SceneGraph/Geometry.hpp"
+#include "Primitives/Primitive.hpp"
+
+namespace crimild {
+
+	/**
+		\brief Renders particles as camera-facing quads using instancing
+
+		Instead of expanding each particle into four vertices on the CPU,
+		only the per-particle data (position, color and size) is streamed 
+		into a persistent instance buffer every frame. A single static quad
+		is drawn once per particle and its corners are expanded in the 
+		vertex shader, reducing both CPU time and the amount of data
+		uploaded per frame.
+
+		Colors and sizes are optional. Particles are rendered white and 
+		with unit size if the corresponding attributes are missing.
+
+		\remarks Requires SHADER_PROGRAM_PARTICLE_INSTANCED, which is only
+		available on platforms supporting instanced draws. Use
+		OrientedQuadParticleRenderer as a fallback otherwise.
+	*/
+    class InstancedQuadParticleRenderer : public ParticleSystemComponent::ParticleRenderer {
+		CRIMILD_IMPLEMENT_RTTI( crimild::InstancedQuadParticleRenderer )
+		
+    public:
+        InstancedQuadParticleRenderer( void );
+        virtual ~InstancedQuadParticleRenderer( void );
+
+        inline Material *getMaterial( void ) { return crimild::get_ptr( _material ); }
+        
+		virtual void configure( Node *node, ParticleData *particles ) override;
+		virtual void update( Node *node, crimild::Real64 dt, ParticleData *particles ) override;
+        
+	private:
+		MaterialPtr _material;
+		PrimitivePtr _primitive;
+		GeometryPtr _geometry;
+		VertexBufferObjectPtr _instances;
+		
+		ParticleAttribArray *_positions = nullptr;
+		ParticleAttribArray *_colors = nullptr;
+		ParticleAttribArray *_sizes = nullptr;
+
+		/** 
+		 	\name Coding support
+		*/
+		//@{
+
+	public:
+		virtual void encode( coding::Encoder &encoder ) override;
+		virtual void decode( coding::Decoder &decoder ) override;
+
+		//@}
+        
+    };
+
+}
+
+#endif
+
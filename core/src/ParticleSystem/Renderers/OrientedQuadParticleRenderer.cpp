@@ -35,8 +35,6 @@
 
 #include "SceneGraph/Camera.hpp"
 
-#include "Concurrency/Async.hpp"
-
 using namespace crimild;
 
 OrientedQuadParticleRenderer::OrientedQuadParticleRenderer( void )
@@ -67,18 +65,68 @@ void OrientedQuadParticleRenderer::configure( Node *node, ParticleData *particle
 
     _primitive = crimild::alloc< Primitive >( Primitive::Type::TRIANGLES );
 
+	// Buffers are allocated only once for the maximum number of particles
+	// and then updated in place every frame
+	const auto maxCount = particles->getParticleCount();
+
+	_vbo = crimild::alloc< VertexBufferObject >( VertexFormat::VF_P3_UV2, 4 * maxCount );
+	_vbo->setUsage( VertexBufferObject::Usage::STREAM );
+
+	// Texture coordinates never change
+	const auto uv0 = Vector2f( 0.0f, 0.0f );
+	const auto uv1 = Vector2f( 0.0f, 1.0f );
+	const auto uv2 = Vector2f( 1.0f, 1.0f );
+	const auto uv3 = Vector2f( 1.0f, 0.0f );
+	for ( crimild::Size i = 0; i < maxCount; i++ ) {
+		const auto idx = i * 4;
+		_vbo->setTextureCoordAt( idx + 0, uv0 );
+		_vbo->setTextureCoordAt( idx + 1, uv1 );
+		_vbo->setTextureCoordAt( idx + 2, uv2 );
+		_vbo->setTextureCoordAt( idx + 3, uv3 );
+	}
+
+	// Neither does the quad pattern. Only the number of used indices is
+	// modified when updating particles
+	_ibo = crimild::alloc< IndexBufferObject >( 6 * maxCount, IndexBufferObject::getIndexTypeForVertexCount( 4 * maxCount ) );
+	for ( crimild::Size i = 0; i < maxCount; i++ ) {
+		const auto idx = i * 6;
+		const auto vdx = i * 4;
+		_ibo->setIndexAt( idx + 0, vdx + 0 );
+		_ibo->setIndexAt( idx + 1, vdx + 1 );
+		_ibo->setIndexAt( idx + 2, vdx + 2 );
+		_ibo->setIndexAt( idx + 3, vdx + 0 );
+		_ibo->setIndexAt( idx + 4, vdx + 2 );
+		_ibo->setIndexAt( idx + 5, vdx + 3 );
+	}
+
+	_vbo->setVertexCount( 0 );
+	_ibo->setIndexCount( 0 );
+
+	_primitive->setVertexBuffer( _vbo );
+	_primitive->setIndexBuffer( _ibo );
+
 	_geometry->attachPrimitive( _primitive );
 }
 
 void OrientedQuadParticleRenderer::update( Node *node, crimild::Real64 dt, ParticleData *particles )
 {
+	_stats.uploadedBytes = 0;
+
     const auto pCount = particles->getAliveCount();
     if ( pCount == 0 ) {
+		if ( _ibo->getIndexCount() > 0 ) {
+			// nothing to render, but avoid drawing stale particles
+			_vbo->setVertexCount( 0 );
+			_ibo->setIndexCount( 0 );
+			_vbo->invalidate();
+		}
         return;
     }
-    
-    auto vbo = crimild::alloc< VertexBufferObject >( VertexFormat::VF_P3_UV2, 4 * pCount );
-	auto ibo = crimild::alloc< IndexBufferObject >( 6 * pCount );
+
+	// Counts are never larger than the ones used in configure(), 
+	// so no memory is allocated here
+	_vbo->setVertexCount( 4 * pCount );
+	_ibo->setIndexCount( 6 * pCount );
 
 	const auto camera = Camera::getMainCamera();
 	auto cameraUp = camera->getWorld().computeUp();
@@ -87,60 +135,35 @@ void OrientedQuadParticleRenderer::update( Node *node, crimild::Real64 dt, Parti
 	node->getWorld().applyInverseToVector( cameraUp, cameraUp );
 	node->getWorld().applyInverseToVector( cameraRight, cameraRight );
 
-	const auto offset0 = cameraUp - cameraRight;
-	const auto offset1 = -cameraUp - cameraRight;
-	const auto offset2 = -cameraUp + cameraRight;
-	const auto offset3 = cameraUp + cameraRight;
+	const Vector3f offsets[] = {
+		cameraUp - cameraRight,
+		-cameraUp - cameraRight,
+		-cameraUp + cameraRight,
+		cameraUp + cameraRight,
+	};
 
-	const auto uv0 = Vector2f( 0.0f, 0.0f );
-	const auto uv1 = Vector2f( 0.0f, 1.0f );
-	const auto uv2 = Vector2f( 1.0f, 1.0f );
-	const auto uv3 = Vector2f( 1.0f, 0.0f );
-
-	const auto ps = _positions->getData< Vector3f >();
+	const auto ps = toLocalSpace( node, particles, _positions->getData< Vector3f >() );
 	const auto ss = _sizes->getData< crimild::Real32 >();
 
-	// Vertex data is interleaved, so it should be more efficient
-	// to set each vertex attribute per loop (as below) instead of
-	// using separated loops (as in the case of other updaters/renderers)
-	// TODO: I need to confirm this somehow
-	for ( auto i = 0; i < pCount; i++ ) {
-		auto idx = i * 4;
-		auto pos = ps[ i ];
-		if ( particles->shouldComputeInWorldSpace() ) {
-			// TODO: cache inverse transform?
-			node->getWorld().applyInverseToPoint( pos, pos );
+	// Only positions are written, straight into the interleaved storage. 
+	// Texture coordinates were set in configure() and are left untouched
+	const auto &format = _vbo->getVertexFormat();
+	const auto stride = format.getVertexSize();
+	auto vs = _vbo->data() + format.getPositionsOffset();
+	for ( crimild::Size i = 0; i < pCount; i++ ) {
+		const auto &p = ps[ i ];
+		const auto s = ss[ i ];
+		for ( const auto &offset : offsets ) {
+			vs[ 0 ] = p[ 0 ] + s * offset[ 0 ];
+			vs[ 1 ] = p[ 1 ] + s * offset[ 1 ];
+			vs[ 2 ] = p[ 2 ] + s * offset[ 2 ];
+			vs += stride;
 		}
-		auto s = ss[ i ];
-		
-		vbo->setPositionAt( idx + 0, pos + s * offset0 );
-		vbo->setTextureCoordAt( idx + 0, uv0 );
-		
-		vbo->setPositionAt( idx + 1, pos + s * offset1 );
-		vbo->setTextureCoordAt( idx + 1, uv1 );
-		
-		vbo->setPositionAt( idx + 2, pos + s * offset2 );
-		vbo->setTextureCoordAt( idx + 2, uv2 );
-
-		vbo->setPositionAt( idx + 3, pos + s * offset3 );
-		vbo->setTextureCoordAt( idx + 3, uv3 );
 	}
 
-	for ( auto i = 0; i < pCount; i++ ) {
-		const auto idx = i * 6;
-		const auto vdx = i * 4;
-		ibo->setIndexAt( idx + 0, vdx + 0 );
-		ibo->setIndexAt( idx + 1, vdx + 1 );
-		ibo->setIndexAt( idx + 2, vdx + 2 );
-		ibo->setIndexAt( idx + 3, vdx + 0 );
-		ibo->setIndexAt( idx + 4, vdx + 2 );
-		ibo->setIndexAt( idx + 5, vdx + 3 );
-	}
+	_vbo->invalidate();
 
-    crimild::concurrency::sync_frame( [this, vbo, ibo] {
-        _primitive->setVertexBuffer( vbo );
-        _primitive->setIndexBuffer( ibo );
-    });
+	_stats.uploadedBytes = _vbo->getSizeInBytes();
 }
 
 void OrientedQuadParticleRenderer::encode( coding::Encoder &encoder ) 
@@ -53,6 +53,8 @@ namespace crimild {
 		MaterialPtr _material;
 		PrimitivePtr _primitive;
 		GeometryPtr _geometry;
+		VertexBufferObjectPtr _vbo;
+		IndexBufferObjectPtr _ibo;
 		
 		ParticleAttribArray *_positions = nullptr;
 		ParticleAttribArray *_sizes = nullptr;
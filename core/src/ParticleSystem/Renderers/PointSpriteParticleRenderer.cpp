@@ -30,7 +30,6 @@
 #include "Simulation/AssetManager.hpp"
 #include "Rendering/Renderer.hpp"
 #include "Components/MaterialComponent.hpp"
-#include "Concurrency/Async.hpp"
 
 using namespace crimild;
 
@@ -63,53 +62,75 @@ void PointSpriteParticleRenderer::configure( Node *node, ParticleData *particles
 
     _primitive = crimild::alloc< Primitive >( Primitive::Type::POINTS );
 
+	// Buffers are allocated only once for the maximum number of particles
+	// and then updated in place every frame
+	const auto maxCount = particles->getParticleCount();
+
+	_vbo = crimild::alloc< VertexBufferObject >( VertexFormat::VF_P3_C4_UV2, maxCount );
+	_vbo->setUsage( VertexBufferObject::Usage::STREAM );
+	_vbo->setVertexCount( 0 );
+
+	_ibo = crimild::alloc< IndexBufferObject >( maxCount, IndexBufferObject::getIndexTypeForVertexCount( maxCount ) );
+	_ibo->generateIncrementalIndices();
+	_ibo->setIndexCount( 0 );
+
+	_primitive->setVertexBuffer( _vbo );
+	_primitive->setIndexBuffer( _ibo );
+
 	_geometry->attachPrimitive( _primitive );
 }
 
 void PointSpriteParticleRenderer::update( Node *node, crimild::Real64 dt, ParticleData *particles )
 {
+	_stats.uploadedBytes = 0;
+
     const auto pCount = particles->getAliveCount();
     if ( pCount == 0 ) {
+		if ( _ibo->getIndexCount() > 0 ) {
+			// nothing to render, but avoid drawing stale particles
+			_vbo->setVertexCount( 0 );
+			_ibo->setIndexCount( 0 );
+			_vbo->invalidate();
+		}
         return;
     }
-    
-    auto vbo = crimild::alloc< VertexBufferObject >( VertexFormat::VF_P3_C4_UV2, pCount );
 
-	const auto ps = _positions->getData< Vector3f >();
+	_vbo->setVertexCount( pCount );
+	_ibo->setIndexCount( pCount );
+
+	const auto ps = toLocalSpace( node, particles, _positions->getData< Vector3f >() );
 	const auto ss = _sizes->getData< crimild::Real32 >();
 	const auto cs = _colors->getData< RGBAColorf >();
-    
-    // TODO: should I traverse the arrays by grouping data in 4/8 byte touples?
-
-	if ( particles->shouldComputeInWorldSpace() ) {
-		for ( auto i = 0; i < pCount; i++ ) {
-			auto p = ps[ i ];
-			// TODO: cache inverse transform?
-			node->getWorld().applyInverseToPoint( p, p );
-			vbo->setPositionAt( i, p );
-		}
-	}
-	else {
-		for ( auto i = 0; i < pCount; i++ ) {
-			vbo->setPositionAt( i, ps[ i ] );
-		}
-	}
 
-	for ( auto i = 0; i < pCount; i++ ) {
-		vbo->setTextureCoordAt( i, Vector2f( ss[ i ], 0.0f ) );
+	// Write each vertex in a single pass, following the interleaved layout
+	const auto &format = _vbo->getVertexFormat();
+	const auto stride = format.getVertexSize();
+	const auto colorsOffset = format.getColorsOffset();
+	const auto uvsOffset = format.getTextureCoordsOffset();
+	auto vs = _vbo->data();
+	for ( crimild::Size i = 0; i < pCount; i++ ) {
+		const auto &p = ps[ i ];
+		vs[ 0 ] = p[ 0 ];
+		vs[ 1 ] = p[ 1 ];
+		vs[ 2 ] = p[ 2 ];
+
+		const auto &c = cs[ i ];
+		auto color = vs + colorsOffset;
+		color[ 0 ] = c[ 0 ];
+		color[ 1 ] = c[ 1 ];
+		color[ 2 ] = c[ 2 ];
+		color[ 3 ] = c[ 3 ];
+
+		auto uv = vs + uvsOffset;
+		uv[ 0 ] = ss[ i ];
+		uv[ 1 ] = 0.0f;
+
+		vs += stride;
 	}
 
-	for ( auto i = 0; i < pCount; i++ ) {
-		vbo->setRGBAColorAt( i, cs[ i ] );
-	}
+	_vbo->invalidate();
 
-    auto ibo = crimild::alloc< IndexBufferObject >( pCount );
-    ibo->generateIncrementalIndices();
-    
-    crimild::concurrency::sync_frame( [this, vbo, ibo] {
-        _primitive->setVertexBuffer( vbo );
-        _primitive->setIndexBuffer( ibo );
-    });
+	_stats.uploadedBytes = _vbo->getSizeInBytes();
 }
 
 void PointSpriteParticleRenderer::encode( coding::Encoder &encoder ) 
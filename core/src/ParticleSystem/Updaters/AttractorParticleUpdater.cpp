@@ -26,6 +26,7 @@
  */
 
 #include "AttractorParticleUpdater.hpp"
+#include "ParticleSystem/ParticleKernels.hpp"
 #include "Coding/Encoder.hpp"
 #include "Coding/Decoder.hpp"
 
@@ -53,23 +54,14 @@ void AttractorParticleUpdater::update( Node *node, crimild::Real64 dt, ParticleD
 {
 	const auto center = _attractor.getCenter();
 	const auto radius = _attractor.getRadius();
-	const auto count = particles->getAliveCount();
+	const auto strength = static_cast< crimild::Real32 >( dt ) * _strength;
 
 	const auto ps = _positions->getData< Vector3f >();
 	auto as = _accelerations->getData< Vector3f >();
-	
-	for ( crimild::Size i = 0; i < count; i++ ) {
-		const auto p = ps[ i ];
-
-		auto direction = center - p;
-		auto d = direction.getMagnitude();
-		if ( d > 0.0 && d <= radius ) {
-			direction /= d;
-			const auto pct = 1.0 - ( d / radius );
-			
-			as[ i ] += dt * pct * _strength * direction;
-		}
-	}
+
+	particles->eachAliveBlock( [ = ]( crimild::Size begin, crimild::Size end ) {
+		ParticleKernels::attract( as + begin, ps + begin, center, radius, strength, end - begin );
+	});
 }
 
 void AttractorParticleUpdater::encode( coding::Encoder &encoder ) 
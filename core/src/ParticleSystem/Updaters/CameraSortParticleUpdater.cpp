@@ -28,6 +28,8 @@
 #include "CameraSortParticleUpdater.hpp"
 
 #include "SceneGraph/Camera.hpp"
+#include "Coding/Encoder.hpp"
+#include "Coding/Decoder.hpp"
 
 using namespace crimild;
 
@@ -59,36 +61,31 @@ void CameraSortParticleUpdater::update( Node *node, double dt, ParticleData *par
 	}
 
 	const auto pCount = particles->getAliveCount();
-
 	const auto ps = _positions->getData< Vector3f >();
 
-	const auto cameraPlane = Plane3f( cameraDirection, cameraPos );
-
-	// precompute distances to camera plane for each particle
-	containers::Array< double > ds( pCount );
+	_depths.resize( pCount );
 	for ( crimild::Size i = 0; i < pCount; i++ ) {
-		ds[ i ] = Distance::compute( cameraPlane, ps[ i ] );
+		_depths[ i ] = cameraDirection * ( ps[ i ] - cameraPos );
 	}
 
-	// sort partices
-	// TODO: I know, bubble sort is slow...
-	for ( int i = 1; i < pCount; i++ ) {
-		for ( int j = 0; j < pCount - i; j++ ) {
-			if ( ds[ j ] < ds[ j + 1 ] ) {
-				particles->swap( j, j + 1 );
-				Numericd::swap( ds[ j ], ds[ j + 1 ] );
-			}
-		}
+	if ( pCount > 0 ) {
+		_sorter.sort( particles, &_depths[ 0 ], ParticleSorter::Order::DESCENDING );
 	}
 }
 
 void CameraSortParticleUpdater::encode( coding::Encoder &encoder ) 
 {
 	ParticleSystemComponent::ParticleUpdater::encode( encoder );
+
+	encoder.encode( "incremental", _sorter.isIncremental() );
 }
 
 void CameraSortParticleUpdater::decode( coding::Decoder &decoder )
 {
 	ParticleSystemComponent::ParticleUpdater::decode( decoder );
+
+	crimild::Bool incremental = false;
+	decoder.decode( "incremental", incremental );
+	setIncremental( incremental );
 }
 
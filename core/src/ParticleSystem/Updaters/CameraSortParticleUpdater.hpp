@@ -29,14 +29,18 @@
 #define CRIMILD_PARTICLE_UPDATER_CAMERA_SORT_
 
 #include "../ParticleSystemComponent.hpp"
+#include "../ParticleSorter.hpp"
 
 namespace crimild {
 
 	/**
-	   \brief Sort particles by their position from the camera
+	   \brief Sort particles by their view depth, back to front
 
-	   Sorting particles is not always required (i.e. particles with depth
-	   buffer disabled).
+	   Depth is measured along the camera direction. Sorting particles is
+	   not always required (i.e. particles with depth buffer disabled).
+
+	   Enable incremental sorting for systems whose particles do not move
+	   much relative to each other between frames.
 
 	   \remarks Use it after a position updater
 	 */
@@ -47,11 +51,16 @@ namespace crimild {
         CameraSortParticleUpdater( void );
         virtual ~CameraSortParticleUpdater( void );
 
+		inline void setIncremental( crimild::Bool value ) { _sorter.setIncremental( value ); }
+		inline crimild::Bool isIncremental( void ) const { return _sorter.isIncremental(); }
+
         virtual void configure( Node *node, ParticleData *particles ) override;
         virtual void update( Node *node, crimild::Real64 dt, ParticleData *particles ) override;
         
     private:
         ParticleAttribArray *_positions = nullptr;
+		ParticleSorter _sorter;
+		std::vector< crimild::Real32 > _depths;
 
 		/** 
 		 	\name Coding support
@@ -27,7 +27,7 @@
 
 #include "ColorParticleUpdater.hpp"
 
-#include "Mathematics/Interpolation.hpp"
+#include "ParticleSystem/ParticleKernels.hpp"
 
 using namespace crimild;
 
@@ -53,24 +53,15 @@ void ColorParticleUpdater::configure( Node *node, ParticleData *particles )
 
 void ColorParticleUpdater::update( Node *node, double dt, ParticleData *particles )
 {
-	const auto count = particles->getAliveCount();
-
 	auto startData = _startColors->getData< RGBAColorf >();
 	auto endData = _endColors->getData< RGBAColorf >();
 	auto colorData = _colors->getData< RGBAColorf >();
 	auto timeData = _times->getData< crimild::Real32 >();
 	auto lifetimeData = _lifetimes->getData< crimild::Real32 >();
 
-	for ( crimild::Size i = 0; i < count; i++ ) {
-		const auto s0 = startData[ i ];
-		const auto s1 = endData[ i ];
-
-		const auto t = 1.0f - ( timeData[ i ] / lifetimeData[ i ] );
-
-		RGBAColorf c;
-		Interpolation::linear( s0, s1, t, c );
-		colorData[ i ] = c;
-	}
+	particles->eachAliveBlock( [ = ]( crimild::Size begin, crimild::Size end ) {
+		ParticleKernels::lerpByAge( colorData + begin, startData + begin, endData + begin, timeData + begin, lifetimeData + begin, end - begin );
+	});
 }
 
 void ColorParticleUpdater::encode( coding::Encoder &encoder ) 
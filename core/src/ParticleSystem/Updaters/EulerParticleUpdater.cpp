@@ -26,6 +26,7 @@
  */
 
 #include "EulerParticleUpdater.hpp"
+#include "ParticleSystem/ParticleKernels.hpp"
 #include "Coding/Encoder.hpp"
 #include "Coding/Decoder.hpp"
 
@@ -51,33 +52,29 @@ void EulerParticleUpdater::configure( Node *node, ParticleData *particles )
 
 void EulerParticleUpdater::update( Node *node, crimild::Real64 dt, ParticleData *particles )
 {
-	const auto count = particles->getAliveCount();
-
-	const auto g = dt * _globalAcceleration;
+	const auto step = static_cast< crimild::Real32 >( dt );
+	const auto g = step * _globalAcceleration;
 
 	auto as = _accelerations->getData< Vector3f >();
 	auto vs = _velocities->getData< Vector3f >();
 	auto ps = _positions->getData< Vector3f >();
 
-	// TODO: all the accelerations are the same value
-	// I think this could be optimized, but other
-	// updaters may need separated values
-	// Also, accelerations are handled in the same way
-	// regardless of the computation space (world or local)
-	for ( int i = 0; i < count; i++ ) {
-		as[ i ] += g;
-	}
-
-	// Velocities are handled in the same way
-	// regardless of the computation space (world or local)
-	for ( int i = 0; i < count; i++ ) {
-		vs[ i ] += dt * as[ i ];
-	}
-	
-	for ( int i = 0; i < count; i++ ) {
-		auto v = dt * vs[ i ];
-		ps[ i ] += v;
-	}
+	particles->eachAliveBlock( [ as, vs, ps, g, step ]( crimild::Size begin, crimild::Size end ) {
+		const auto count = end - begin;
+
+		// TODO: all the accelerations are the same value
+		// I think this could be optimized, but other
+		// updaters may need separated values
+		// Also, accelerations are handled in the same way
+		// regardless of the computation space (world or local)
+		ParticleKernels::add( as + begin, g, count );
+
+		// Velocities are handled in the same way
+		// regardless of the computation space (world or local)
+		ParticleKernels::addScaled( vs + begin, as + begin, step, count );
+
+		ParticleKernels::addScaled( ps + begin, vs + begin, step, count );
+	});
 }
 
 void EulerParticleUpdater::encode( coding::Encoder &encoder ) 
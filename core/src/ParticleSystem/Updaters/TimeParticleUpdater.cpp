@@ -26,6 +26,7 @@
  */
 
 #include "TimeParticleUpdater.hpp"
+#include "ParticleSystem/ParticleKernels.hpp"
 
 using namespace crimild;
 
@@ -47,17 +48,24 @@ void TimeParticleUpdater::configure( Node *node, ParticleData *particles )
 
 void TimeParticleUpdater::update( Node *node, double dt, ParticleData *particles )
 {
-	const auto count = particles->getAliveCount();
-
 	auto ts = _times->getData< crimild::Real32 >();
 	assert( ts != nullptr );
 
-	for ( int i = 0; i < count; i++ ) {
-		ts[ i ] -= dt;
+	const auto step = static_cast< crimild::Real32 >( dt );
+	particles->eachAliveBlock( [ ts, step ]( crimild::Size begin, crimild::Size end ) {
+		ParticleKernels::subtract( ts + begin, step, end - begin );
+	});
+
+	// Killed particles stay in place until compaction, so every 
+	// particle is checked exactly once
+	const auto count = particles->getAliveCount();
+	for ( crimild::Size i = 0; i < count; i++ ) {
 		if ( ts[ i ] <= 0.0f ) {
 			particles->kill( i );
 		}
 	}
+
+	particles->compact();
 }
 
 void TimeParticleUpdater::encode( coding::Encoder &encoder ) 
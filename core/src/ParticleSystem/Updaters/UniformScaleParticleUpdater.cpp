@@ -27,7 +27,7 @@
 
 #include "UniformScaleParticleUpdater.hpp"
 
-#include "Mathematics/Interpolation.hpp"
+#include "ParticleSystem/ParticleKernels.hpp"
 
 using namespace crimild;
 
@@ -52,24 +52,15 @@ void UniformScaleParticleUpdater::configure( Node *node, ParticleData *particles
 
 void UniformScaleParticleUpdater::update( Node *node, crimild::Real64 dt, ParticleData *particles )
 {
-	const auto count = particles->getAliveCount();
-
 	auto startData = _startScales->getData< crimild::Real32 >();
 	auto endData = _endScales->getData< crimild::Real32 >();
 	auto scaleData = _scales->getData< crimild::Real32 >();
 	auto timeData = _times->getData< crimild::Real32 >();
 	auto lifetimeData = _lifetimes->getData< crimild::Real32 >();
 
-	for ( crimild::Size i = 0; i < count; i++ ) {
-		const auto s0 = startData[ i ];
-		const auto s1 = endData[ i ];
-
-		const auto t = 1.0f - ( timeData[ i ] / lifetimeData[ i ] );
-
-		crimild::Real32 s;
-		Interpolation::linear( s0, s1, t, s );
-		scaleData[ i ] = s;
-	}
+	particles->eachAliveBlock( [ = ]( crimild::Size begin, crimild::Size end ) {
+		ParticleKernels::lerpByAge( scaleData + begin, startData + begin, endData + begin, timeData + begin, lifetimeData + begin, end - begin );
+	});
 }
 
 void UniformScaleParticleUpdater::encode( coding::Encoder &encoder ) 
@@ -52,13 +52,13 @@ void ZSortParticleUpdater::update( Node *node, double dt, ParticleData *particle
 
 	const auto ps = _positions->getData< Vector3f >();
 
-	// TODO: I know, bubble sort is slow...
-	for ( int i = 1; i < pCount; i++ ) {
-		for ( int j = 0; j < pCount - i; j++ ) {
-			if ( ps[ j ].z() > ps[ j + 1 ].z() ) {
-				particles->swap( j, j + 1 );
-			}
-		}
+	_depths.resize( pCount );
+	for ( crimild::Size i = 0; i < pCount; i++ ) {
+		_depths[ i ] = ps[ i ].z();
+	}
+
+	if ( pCount > 0 ) {
+		_sorter.sort( particles, &_depths[ 0 ], ParticleSorter::Order::ASCENDING );
 	}
 }
 
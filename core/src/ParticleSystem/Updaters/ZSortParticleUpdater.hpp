@@ -29,6 +29,7 @@
 #define CRIMILD_PARTICLE_UPDATER_Z_SORT_
 
 #include "../ParticleSystemComponent.hpp"
+#include "../ParticleSorter.hpp"
 
 namespace crimild {
 
@@ -52,6 +53,8 @@ namespace crimild {
         
     private:
         ParticleAttribArray *_positions = nullptr;
+		ParticleSorter _sorter;
+		std::vector< crimild::Real32 > _depths;
 
 		/** 
 		 	\name Coding support
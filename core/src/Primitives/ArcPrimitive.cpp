@@ -67,22 +67,22 @@ ArcPrimitive::ArcPrimitive( float radius, float angle, float thickness, int segm
     auto vbo = crimild::alloc< crimild::VertexBufferObject >( crimild::VertexFormat::VF_P3, positions.size() / 3, &positions[ 0 ] );
     setVertexBuffer( vbo );
     
-    std::vector< IndexPrecision > indices;
+    auto ibo = crimild::alloc< crimild::IndexBufferObject >( 6 * segments, crimild::IndexBufferObject::getIndexTypeForVertexCount( vbo->getVertexCount() ) );
+    unsigned int index = 0;
     for ( int i = 0; i < segments; i++ ) {
         auto i0 = i * 2;
         auto i1 = i * 2 + 1;
         auto i2 = ( i + 1 ) * 2 + 1;
         auto i3 = ( i + 1 ) * 2 + 0;
 
-        indices.push_back( i0 );
-        indices.push_back( i1 );
-        indices.push_back( i2 );
+        ibo->setIndexAt( index++, i0 );
+        ibo->setIndexAt( index++, i1 );
+        ibo->setIndexAt( index++, i2 );
 
-        indices.push_back( i0 );
-        indices.push_back( i2 );
-        indices.push_back( i3 );
+        ibo->setIndexAt( index++, i0 );
+        ibo->setIndexAt( index++, i2 );
+        ibo->setIndexAt( index++, i3 );
     }
-    auto ibo = crimild::alloc< crimild::IndexBufferObject >( indices.size(), &indices[ 0 ] );
     setIndexBuffer( ibo );
 }
 
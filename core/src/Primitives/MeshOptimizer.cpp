@@ -0,0 +1,395 @@
+/*
+ * Copyright (c) 2013, Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "MeshOptimizer.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+using namespace crimild;
+
+constexpr crimild::Size MeshOptimizer::DEFAULT_CACHE_SIZE;
+
+namespace crimild {
+
+	namespace mesh_optimizer {
+
+		static const crimild::UInt32 INVALID_INDEX = std::numeric_limits< crimild::UInt32 >::max();
+
+		// Forsyth's scoring function. See "Linear-Speed Vertex Cache Optimisation"
+		static const crimild::Real32 CACHE_DECAY_POWER = 1.5f;
+		static const crimild::Real32 LAST_TRIANGLE_SCORE = 0.75f;
+		static const crimild::Real32 VALENCE_BOOST_SCALE = 2.0f;
+		static const crimild::Real32 VALENCE_BOOST_POWER = 0.5f;
+
+		static crimild::Real32 computeVertexScore( crimild::Int32 cachePosition, crimild::UInt32 activeTriangles, crimild::Size cacheSize )
+		{
+			if ( activeTriangles == 0 ) {
+				// no triangles left to render for this vertex
+				return -1.0f;
+			}
+
+			crimild::Real32 score = 0.0f;
+			if ( cachePosition >= 0 ) {
+				if ( cachePosition < 3 ) {
+					// vertex was used by the last triangle. Give it a fixed
+					// score to avoid favoring any of them
+					score = LAST_TRIANGLE_SCORE;
+				}
+				else {
+					const crimild::Real32 scaler = 1.0f / ( cacheSize - 3 );
+					score = std::pow( 1.0f - ( cachePosition - 3 ) * scaler, CACHE_DECAY_POWER );
+				}
+			}
+
+			// bonus points for having few triangles left, so lone vertices
+			// are rendered early instead of lingering around
+			score += VALENCE_BOOST_SCALE * std::pow( ( crimild::Real32 ) activeTriangles, -VALENCE_BOOST_POWER );
+
+			return score;
+		}
+
+		static crimild::UInt32 hashVertex( const crimild::Byte *data, crimild::Size size )
+		{
+			// FNV-1a
+			crimild::UInt32 h = 2166136261u;
+			for ( crimild::Size i = 0; i < size; i++ ) {
+				h ^= data[ i ];
+				h *= 16777619u;
+			}
+			return h;
+		}
+
+	}
+
+}
+
+using namespace crimild::mesh_optimizer;
+
+crimild::Real32 MeshOptimizer::computeACMR( IndexBufferObject *ibo, crimild::Size cacheSize )
+{
+	if ( ibo == nullptr || ibo->getIndexCount() < 3 || cacheSize == 0 ) {
+		return 0.0f;
+	}
+
+	const auto indexCount = ibo->getIndexCount();
+
+	crimild::UInt32 maxIndex = 0;
+	for ( crimild::Size i = 0; i < indexCount; i++ ) {
+		maxIndex = Numeric< crimild::UInt32 >::max( maxIndex, ibo->getIndexAt( i ) );
+	}
+
+	// A vertex is still in a FIFO cache if less than 'cacheSize'
+	// misses happened since it was last loaded
+	std::vector< crimild::Size > timestamps( maxIndex + 1, 0 );
+	crimild::Size misses = 0;
+	for ( crimild::Size i = 0; i < indexCount; i++ ) {
+		const auto v = ibo->getIndexAt( i );
+		if ( timestamps[ v ] == 0 || misses - timestamps[ v ] >= cacheSize ) {
+			misses++;
+			timestamps[ v ] = misses;
+		}
+	}
+
+	return ( crimild::Real32 ) misses / ( crimild::Real32 )( indexCount / 3 );
+}
+
+void MeshOptimizer::optimize( Primitive *primitive )
+{
+	weldVertices( primitive );
+	if ( primitive->getType() == Primitive::Type::TRIANGLES ) {
+		optimizeVertexCache( primitive );
+	}
+	optimizeVertexFetch( primitive );
+}
+
+void MeshOptimizer::weldVertices( Primitive *primitive )
+{
+	auto vbo = primitive->getVertexBuffer();
+	auto ibo = primitive->getIndexBuffer();
+	if ( vbo == nullptr || ibo == nullptr || vbo->getVertexCount() == 0 ) {
+		return;
+	}
+
+	const auto vertexCount = vbo->getVertexCount();
+	const auto vertexSize = vbo->getVertexFormat().getVertexSizeInBytes();
+	const auto data = reinterpret_cast< const crimild::Byte * >( vbo->getData() );
+
+	for ( crimild::Size i = 0; i < ibo->getIndexCount(); i++ ) {
+		if ( ibo->getIndexAt( i ) >= vertexCount ) {
+			// invalid index data. Leave it alone
+			return;
+		}
+	}
+
+	// open addressing table storing the first occurrence of each vertex
+	crimild::Size tableSize = 1;
+	while ( tableSize < 2 * vertexCount ) {
+		tableSize <<= 1;
+	}
+	std::vector< crimild::UInt32 > table( tableSize, INVALID_INDEX );
+
+	std::vector< crimild::UInt32 > remap( vertexCount );
+	crimild::Size uniqueCount = 0;
+	for ( crimild::UInt32 v = 0; v < vertexCount; v++ ) {
+		const auto vertex = data + v * vertexSize;
+		auto slot = hashVertex( vertex, vertexSize ) & ( tableSize - 1 );
+		while ( table[ slot ] != INVALID_INDEX && memcmp( data + table[ slot ] * vertexSize, vertex, vertexSize ) != 0 ) {
+			slot = ( slot + 1 ) & ( tableSize - 1 );
+		}
+
+		if ( table[ slot ] == INVALID_INDEX ) {
+			table[ slot ] = v;
+			remap[ v ] = uniqueCount++;
+		}
+		else {
+			remap[ v ] = remap[ table[ slot ] ];
+		}
+	}
+
+	if ( uniqueCount == vertexCount ) {
+		// nothing to weld
+		return;
+	}
+
+	remapVertices( primitive, remap, uniqueCount );
+}
+
+void MeshOptimizer::optimizeVertexCache( Primitive *primitive, crimild::Size cacheSize )
+{
+	auto vbo = primitive->getVertexBuffer();
+	auto ibo = primitive->getIndexBuffer();
+	if ( vbo == nullptr || ibo == nullptr || cacheSize <= 3 ) {
+		return;
+	}
+
+	const auto vertexCount = vbo->getVertexCount();
+	const auto triangleCount = ibo->getIndexCount() / 3;
+	if ( triangleCount == 0 ) {
+		return;
+	}
+
+	std::vector< crimild::UInt32 > indices( 3 * triangleCount );
+	for ( crimild::Size i = 0; i < indices.size(); i++ ) {
+		indices[ i ] = ibo->getIndexAt( i );
+		if ( indices[ i ] >= vertexCount ) {
+			// invalid index data. Leave it alone
+			return;
+		}
+	}
+
+	// build vertex to triangle adjacency
+	std::vector< crimild::UInt32 > activeTriangles( vertexCount, 0 );
+	for ( auto v : indices ) {
+		activeTriangles[ v ]++;
+	}
+
+	std::vector< crimild::UInt32 > offsets( vertexCount + 1, 0 );
+	for ( crimild::Size v = 0; v < vertexCount; v++ ) {
+		offsets[ v + 1 ] = offsets[ v ] + activeTriangles[ v ];
+	}
+
+	std::vector< crimild::UInt32 > adjacency( indices.size() );
+	{
+		std::vector< crimild::UInt32 > fill( offsets.begin(), offsets.end() - 1 );
+		for ( crimild::UInt32 t = 0; t < triangleCount; t++ ) {
+			for ( crimild::Size k = 0; k < 3; k++ ) {
+				const auto v = indices[ 3 * t + k ];
+				adjacency[ fill[ v ]++ ] = t;
+			}
+		}
+	}
+
+	std::vector< crimild::Int32 > cachePositions( vertexCount, -1 );
+	std::vector< crimild::Real32 > vertexScores( vertexCount );
+	for ( crimild::Size v = 0; v < vertexCount; v++ ) {
+		vertexScores[ v ] = computeVertexScore( -1, activeTriangles[ v ], cacheSize );
+	}
+
+	std::vector< bool > emitted( triangleCount, false );
+
+	std::vector< crimild::UInt32 > cache;
+	std::vector< crimild::UInt32 > nextCache;
+	cache.reserve( cacheSize + 3 );
+	nextCache.reserve( cacheSize + 3 );
+
+	std::vector< crimild::UInt32 > output;
+	output.reserve( indices.size() );
+
+	crimild::UInt32 bestTriangle = INVALID_INDEX;
+	crimild::Size scanCursor = 0;
+
+	for ( crimild::Size emittedCount = 0; emittedCount < triangleCount; emittedCount++ ) {
+		if ( bestTriangle == INVALID_INDEX ) {
+			// no candidates in cache. Continue with the first remaining
+			// triangle instead of looking for the best one, which keeps
+			// the whole pass linear for meshes with many disjoint pieces
+			bestTriangle = scanCursor;
+		}
+
+		emitted[ bestTriangle ] = true;
+		while ( scanCursor < triangleCount && emitted[ scanCursor ] ) {
+			scanCursor++;
+		}
+
+		// emit triangle and push its vertices to the front of the cache
+		nextCache.clear();
+		for ( crimild::Size k = 0; k < 3; k++ ) {
+			const auto v = indices[ 3 * bestTriangle + k ];
+			output.push_back( v );
+			nextCache.push_back( v );
+
+			// remove triangle from the vertex's active list
+			auto begin = adjacency.begin() + offsets[ v ];
+			auto end = begin + activeTriangles[ v ];
+			auto it = std::find( begin, end, bestTriangle );
+			if ( it != end ) {
+				std::swap( *it, *( end - 1 ) );
+				activeTriangles[ v ]--;
+			}
+		}
+
+		for ( auto v : cache ) {
+			if ( v != nextCache[ 0 ] && v != nextCache[ 1 ] && v != nextCache[ 2 ] ) {
+				nextCache.push_back( v );
+			}
+		}
+
+		// vertices pushed out of the cache need new scores too
+		for ( crimild::Size i = cacheSize; i < nextCache.size(); i++ ) {
+			cachePositions[ nextCache[ i ] ] = -1;
+			vertexScores[ nextCache[ i ] ] = computeVertexScore( -1, activeTriangles[ nextCache[ i ] ], cacheSize );
+		}
+
+		if ( nextCache.size() > cacheSize ) {
+			nextCache.resize( cacheSize );
+		}
+		std::swap( cache, nextCache );
+
+		for ( crimild::Size i = 0; i < cache.size(); i++ ) {
+			const auto v = cache[ i ];
+			cachePositions[ v ] = i;
+			vertexScores[ v ] = computeVertexScore( i, activeTriangles[ v ], cacheSize );
+		}
+
+		// update scores for triangles around cached vertices and
+		// find the next best candidate among them
+		bestTriangle = INVALID_INDEX;
+		crimild::Real32 bestScore = -1.0f;
+		for ( auto v : cache ) {
+			for ( crimild::Size i = 0; i < activeTriangles[ v ]; i++ ) {
+				const auto t = adjacency[ offsets[ v ] + i ];
+				const auto score = vertexScores[ indices[ 3 * t + 0 ] ] + vertexScores[ indices[ 3 * t + 1 ] ] + vertexScores[ indices[ 3 * t + 2 ] ];
+				if ( score > bestScore ) {
+					bestScore = score;
+					bestTriangle = t;
+				}
+			}
+		}
+	}
+
+	auto optimized = crimild::alloc< IndexBufferObject >( output.size(), ibo->getIndexType() );
+	for ( crimild::Size i = 0; i < output.size(); i++ ) {
+		optimized->setIndexAt( i, output[ i ] );
+	}
+	primitive->setIndexBuffer( optimized );
+}
+
+void MeshOptimizer::optimizeVertexFetch( Primitive *primitive )
+{
+	auto vbo = primitive->getVertexBuffer();
+	auto ibo = primitive->getIndexBuffer();
+	if ( vbo == nullptr || ibo == nullptr || vbo->getVertexCount() == 0 ) {
+		return;
+	}
+
+	const auto vertexCount = vbo->getVertexCount();
+	const auto indexCount = ibo->getIndexCount();
+
+	std::vector< crimild::UInt32 > remap( vertexCount, INVALID_INDEX );
+	crimild::Size usedCount = 0;
+	bool sorted = true;
+	for ( crimild::Size i = 0; i < indexCount; i++ ) {
+		const auto v = ibo->getIndexAt( i );
+		if ( v >= vertexCount ) {
+			// invalid index data. Leave it alone
+			return;
+		}
+
+		if ( remap[ v ] == INVALID_INDEX ) {
+			sorted = sorted && v == usedCount;
+			remap[ v ] = usedCount++;
+		}
+	}
+
+	if ( sorted && usedCount == vertexCount ) {
+		// vertices are already in order of first use
+		return;
+	}
+
+	remapVertices( primitive, remap, usedCount );
+}
+
+void MeshOptimizer::remapVertices( Primitive *primitive, const std::vector< crimild::UInt32 > &remap, crimild::Size vertexCount )
+{
+	auto vbo = primitive->getVertexBuffer();
+	auto ibo = primitive->getIndexBuffer();
+
+	const auto indexCount = ibo->getIndexCount();
+	for ( crimild::Size i = 0; i < indexCount; i++ ) {
+		const auto v = ibo->getIndexAt( i );
+		if ( v >= remap.size() || remap[ v ] == INVALID_INDEX ) {
+			// invalid index data. Leave it alone
+			return;
+		}
+	}
+
+	const auto &format = vbo->getVertexFormat();
+	const auto vertexSize = format.getVertexSize();
+
+	auto newVBO = crimild::alloc< VertexBufferObject >( format, vertexCount );
+	newVBO->setUsage( vbo->getUsage() );
+	const auto src = vbo->getData();
+	auto dst = newVBO->data();
+	for ( crimild::Size v = 0; v < remap.size(); v++ ) {
+		if ( remap[ v ] != INVALID_INDEX ) {
+			memcpy( dst + remap[ v ] * vertexSize, src + v * vertexSize, format.getVertexSizeInBytes() );
+		}
+	}
+
+	auto newIBO = crimild::alloc< IndexBufferObject >( indexCount, IndexBufferObject::getIndexTypeForVertexCount( vertexCount ) );
+	newIBO->setUsage( ibo->getUsage() );
+	for ( crimild::Size i = 0; i < indexCount; i++ ) {
+		newIBO->setIndexAt( i, remap[ ibo->getIndexAt( i ) ] );
+	}
+
+	primitive->setVertexBuffer( newVBO );
+	primitive->setIndexBuffer( newIBO );
+}
+
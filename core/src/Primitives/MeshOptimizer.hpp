@@ -0,0 +1,95 @@
+/*
+ * Copyright (c) 2013, Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef CRIMILD_PRIMITIVES_MESH_OPTIMIZER_
+#define CRIMILD_PRIMITIVES_MESH_OPTIMIZER_
+
+#include "Primitive.hpp"
+
+#include <vector>
+
+namespace crimild {
+
+	/**
+	   \brief Reorganizes indexed geometry for faster rendering
+
+	   Loaders emit geometry in whatever order the source data is
+	   provided, usually with no vertex reuse at all. These passes
+	   rebuild a primitive's buffers so the GPU transforms as few
+	   vertices as possible:
+
+	   - weldVertices() merges vertices that are bitwise identical
+	   - optimizeVertexCache() reorders triangles for the post-transform
+	     vertex cache (based on Tom Forsyth's linear-speed algorithm)
+	   - optimizeVertexFetch() sorts vertices in order of first use, so
+	     memory is fetched sequentially
+
+	   All passes replace the primitive's buffers with new ones and keep
+	   the rendered result unchanged.
+	 */
+	class MeshOptimizer {
+	public:
+		/**
+		   \brief Cache size assumed by optimizeVertexCache()
+		 */
+		static constexpr crimild::Size DEFAULT_CACHE_SIZE = 32;
+
+		/**
+		   \brief Average cache miss ratio
+
+		   Simulates a FIFO post-transform cache of the given size and
+		   returns the number of vertices transformed per triangle. Values
+		   go from 0.5 (ideal) to 3.0 (no reuse at all).
+		 */
+		static crimild::Real32 computeACMR( IndexBufferObject *ibo, crimild::Size cacheSize = 16 );
+
+		/**
+		   \brief Runs all passes in order
+
+		   Cache optimization is skipped for anything but indexed triangles.
+		 */
+		static void optimize( Primitive *primitive );
+
+		static void weldVertices( Primitive *primitive );
+
+		static void optimizeVertexCache( Primitive *primitive, crimild::Size cacheSize = DEFAULT_CACHE_SIZE );
+
+		static void optimizeVertexFetch( Primitive *primitive );
+
+	private:
+		/**
+		   \brief Rebuilds vertex and index buffers given a vertex remap table
+
+		   remap[ i ] holds the new position for the old vertex i
+		 */
+		static void remapVertices( Primitive *primitive, const std::vector< crimild::UInt32 > &remap, crimild::Size vertexCount );
+	};
+
+}
+
+#endif
+
@@ -26,6 +26,7 @@
  */
 
 #include "NewellTeapotPrimitive.hpp"
+#include "MeshOptimizer.hpp"
 
 using namespace crimild;
 
@@ -1892,6 +1893,8 @@ NewellTeapotPrimitive::NewellTeapotPrimitive( void )
 	
     setVertexBuffer( crimild::alloc< VertexBufferObject >( VertexFormat::VF_P3_N3_UV2, vertexCount, vertices ) );
     setIndexBuffer( crimild::alloc< IndexBufferObject >( indexCount, indices ) );
+
+    MeshOptimizer::optimize( this );
 }
 
 NewellTeapotPrimitive::~NewellTeapotPrimitive( void )
@@ -26,6 +26,7 @@
  */
 
 #include "ParametricPrimitive.hpp"
+#include "MeshOptimizer.hpp"
 
 using namespace crimild;
 
@@ -76,6 +77,7 @@ void ParametricPrimitive::generate( void )
     }
     else {
         generateTriangleIndexBuffer();
+        MeshOptimizer::optimize( this );
     }
 }
 
@@ -132,15 +134,15 @@ void ParametricPrimitive::generateVertexBuffer( void )
 
 void ParametricPrimitive::generateLineIndexBuffer( void )
 {
-    auto ibo = crimild::alloc< IndexBufferObject >( getLineIndexCount(), nullptr );
-    IndexPrecision *index = ibo->data();
+    auto ibo = crimild::alloc< IndexBufferObject >( getLineIndexCount(), IndexBufferObject::getIndexTypeForVertexCount( getVertexCount() ) );
+    unsigned int index = 0;
     for ( int i = 0, vertex = 0; i < _slices[ 1 ]; i++ ) {
         for ( int j = 0; j < _slices[ 0 ]; j++ ) {
             int next = ( j + 1 ) % _divisions[ 0 ];
-            *index++ = vertex + j;
-            *index++ = vertex + next;
-            *index++ = vertex + j;
-            *index++ = vertex + j + _divisions[ 0 ];
+            ibo->setIndexAt( index++, vertex + j );
+            ibo->setIndexAt( index++, vertex + next );
+            ibo->setIndexAt( index++, vertex + j );
+            ibo->setIndexAt( index++, vertex + j + _divisions[ 0 ] );
         }
         vertex += _divisions[ 0 ];
     }
@@ -149,17 +151,17 @@ void ParametricPrimitive::generateLineIndexBuffer( void )
 
 void ParametricPrimitive::generateTriangleIndexBuffer( void )
 {
-    auto ibo = crimild::alloc< IndexBufferObject >( getTriangleIndexCount(), nullptr );
-    IndexPrecision *index = ibo->data();
+    auto ibo = crimild::alloc< IndexBufferObject >( getTriangleIndexCount(), IndexBufferObject::getIndexTypeForVertexCount( getVertexCount() ) );
+    unsigned int index = 0;
     for ( int i = 0, vertex = 0; i < _slices[ 1 ]; i++ ) {
         for ( int j = 0; j < _slices[ 0 ]; j++ ) {
             int next = ( j + 1 ) % _divisions[ 0 ];
-            *index++ = vertex + j;
-            *index++ = vertex + next;
-            *index++ = vertex + j + _divisions[ 0 ];
-            *index++ = vertex + next;
-            *index++ = vertex + next + _divisions[ 0 ];
-            *index++ = vertex + j + _divisions[ 0 ];
+            ibo->setIndexAt( index++, vertex + j );
+            ibo->setIndexAt( index++, vertex + next );
+            ibo->setIndexAt( index++, vertex + j + _divisions[ 0 ] );
+            ibo->setIndexAt( index++, vertex + next );
+            ibo->setIndexAt( index++, vertex + next + _divisions[ 0 ] );
+            ibo->setIndexAt( index++, vertex + j + _divisions[ 0 ] );
         }
         vertex += _divisions[ 0 ];
     }
@@ -40,6 +40,7 @@ Primitive::Primitive( Primitive::Type type )
 
 Primitive::~Primitive( void )
 {
+    _instanceBuffer = nullptr;
     _indexBuffer = nullptr;
     _vertexBuffer = nullptr;
 }
@@ -68,10 +68,26 @@ namespace crimild {
         void setIndexBuffer( SharedPointer< IndexBufferObject > const &ibo ) { _indexBuffer = ibo; }
         IndexBufferObject *getIndexBuffer( void ) { return crimild::get_ptr( _indexBuffer ); }
 
+		/**
+			\brief Set a buffer with per-instance attributes
+
+			When present, the primitive is drawn once for each vertex in
+			the instance buffer, which are bound at locations shifted
+			by VertexFormat::LayoutLocation::INSTANCE_OFFSET.
+
+			\remarks Instance buffers are not serialized
+		*/
+        void setInstanceBuffer( SharedPointer< VertexBufferObject > const &vbo ) { _instanceBuffer = vbo; }
+        VertexBufferObject *getInstanceBuffer( void ) { return crimild::get_ptr( _instanceBuffer ); }
+
+		inline crimild::Bool isInstanced( void ) const { return _instanceBuffer != nullptr; }
+		inline crimild::Size getInstanceCount( void ) const { return _instanceBuffer != nullptr ? _instanceBuffer->getVertexCount() : 1; }
+
 	private:
 		Primitive::Type _type;
 		SharedPointer< VertexBufferObject > _vertexBuffer;
 		SharedPointer< IndexBufferObject > _indexBuffer;
+		SharedPointer< VertexBufferObject > _instanceBuffer;
         
         /**
          */
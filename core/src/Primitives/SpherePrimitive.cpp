@@ -26,6 +26,7 @@
  */
 
 #include "SpherePrimitive.hpp"
+#include "MeshOptimizer.hpp"
 
 #include <vector>
 
@@ -71,23 +72,27 @@ SpherePrimitive::SpherePrimitive( float radius, const VertexFormat &format, Vect
 
     setVertexBuffer( crimild::alloc< VertexBufferObject >( format, vertices.size() / format.getVertexSize(), &vertices[ 0 ] ) );
 
-    std::vector< IndexPrecision > indices;
-    for ( IndexPrecision latitude = 0; latitude < divisions[ 1 ]; latitude++ ) {
-        for ( IndexPrecision longitude = 0; longitude < divisions[ 0 ]; longitude++ ) {
-            IndexPrecision first = ( latitude * ( divisions[ 1 ] + 1 ) ) + longitude;
-            IndexPrecision second = first + divisions[ 0 ] + 1;
-
-            indices.push_back( first );
-            indices.push_back( first + 1 );
-            indices.push_back( second );
-
-            indices.push_back( second );
-            indices.push_back( first + 1 );
-            indices.push_back( second + 1 );
+    const auto vertexCount = vertices.size() / format.getVertexSize();
+    auto ibo = crimild::alloc< IndexBufferObject >( 6 * divisions[ 0 ] * divisions[ 1 ], IndexBufferObject::getIndexTypeForVertexCount( vertexCount ) );
+    unsigned int index = 0;
+    for ( crimild::UInt32 latitude = 0; latitude < divisions[ 1 ]; latitude++ ) {
+        for ( crimild::UInt32 longitude = 0; longitude < divisions[ 0 ]; longitude++ ) {
+            crimild::UInt32 first = ( latitude * ( divisions[ 1 ] + 1 ) ) + longitude;
+            crimild::UInt32 second = first + divisions[ 0 ] + 1;
+
+            ibo->setIndexAt( index++, first );
+            ibo->setIndexAt( index++, first + 1 );
+            ibo->setIndexAt( index++, second );
+
+            ibo->setIndexAt( index++, second );
+            ibo->setIndexAt( index++, first + 1 );
+            ibo->setIndexAt( index++, second + 1 );
         }
     }
 
-    setIndexBuffer( crimild::alloc< IndexBufferObject >( indices.size(), &indices[ 0 ] ) );
+    setIndexBuffer( ibo );
+
+    MeshOptimizer::optimize( this );
 }
 
 SpherePrimitive::~SpherePrimitive( void )
@@ -31,6 +31,7 @@
 #include "Foundation/Macros.hpp"
 #include "Foundation/Types.hpp"
 #include "Foundation/Containers/Array.hpp"
+#include "Mathematics/Numeric.hpp"
 #include "Streaming/Stream.hpp"
 #include "Coding/Codable.hpp"
 #include "Coding/Encoder.hpp"
@@ -45,6 +46,7 @@ namespace crimild {
     class BufferObject : public coding::Codable, public StreamObject {
 	protected:
 		BufferObject( unsigned int size, const T *data )
+			: _usedCount( size )
 		{
 			if ( size > 0 ) {
                 _data.resize( size * sizeof( T ) );
@@ -60,20 +62,86 @@ namespace crimild {
 
 		}
 
-		inline unsigned int getSize( void ) const { return _data.size() / sizeof( T ); }
+		inline unsigned int getSize( void ) const { return _usedCount; }
         
-        inline unsigned int getSizeInBytes( void ) const { return _data.size(); }
+        inline unsigned int getSizeInBytes( void ) const { return _usedCount * sizeof( T ); }
 
 		inline T *data( void ) { return ( T * ) &_data[ 0 ]; }
 
 		inline const T *getData( void ) const { return ( const T * ) &_data[ 0 ]; }
 
-		inline crimild::Size getUsedCount( void ) const { return getSize(); }
+		inline crimild::Size getUsedCount( void ) const { return _usedCount; }
 
-		inline void setUsedCount( crimild::Size count ) { _data.resize( count * sizeof( T ) ); }
+		/**
+		   \brief Changes the number of elements in use
+
+		   Storage is only reallocated when the new count exceeds the current
+		   capacity. In that case, capacity grows geometrically and existing
+		   elements are preserved. Shrinking never releases memory, so buffers
+		   that are refilled every frame settle on a fixed allocation.
+		 */
+		void setUsedCount( crimild::Size count )
+		{
+			if ( count > getCapacity() ) {
+				reserve( Numeric< crimild::Size >::max( count, 2 * getCapacity() ) );
+			}
+			_usedCount = count;
+		}
+
+		inline crimild::Size getCapacity( void ) const { return _data.size() / sizeof( T ); }
+
+		inline crimild::Size getCapacityInBytes( void ) const { return _data.size(); }
+
+		/**
+		   \brief Makes sure there is room for at least 'count' elements
+		 */
+		void reserve( crimild::Size count )
+		{
+			if ( count <= getCapacity() ) {
+				return;
+			}
+
+			containers::ByteArray data( count * sizeof( T ) );
+			if ( _usedCount > 0 ) {
+				memcpy( &data[ 0 ], &_data[ 0 ], _usedCount * sizeof( T ) );
+			}
+			_data = std::move( data );
+		}
 
 	private:
         containers::ByteArray _data;
+		crimild::Size _usedCount = 0;
+
+		/**
+		   \name Usage
+		*/
+		//@{
+
+	public:
+		enum class Usage : uint8_t {
+			STATIC,		//< Default. Data is uploaded once
+			STREAM		//< Data is rewritten in place, usually once per frame
+		};
+
+		inline Usage getUsage( void ) const { return _usage; }
+		inline void setUsage( Usage usage ) { _usage = usage; }
+
+		/**
+		   \brief Indicates that the buffer contents have changed
+
+		   Producers writing into a STREAM buffer in place must call this
+		   method once they're done so the renderer uploads the new data
+		   without creating new buffers.
+		 */
+		inline void invalidate( void ) { ++_version; }
+
+		inline crimild::UInt32 getVersion( void ) const { return _version; }
+
+	private:
+		Usage _usage = Usage::STATIC;
+		crimild::UInt32 _version = 0;
+
+		//@}
         
         /**
             name Coding
@@ -85,7 +153,17 @@ namespace crimild {
         {
             Codable::encode( encoder );
             
-            encoder.encode( "data", _data );
+            if ( getSizeInBytes() == getCapacityInBytes() ) {
+                encoder.encode( "data", _data );
+            }
+            else {
+                // only elements in use are encoded
+                containers::ByteArray used( getSizeInBytes() );
+                if ( _usedCount > 0 ) {
+                    memcpy( &used[ 0 ], &_data[ 0 ], getSizeInBytes() );
+                }
+                encoder.encode( "data", used );
+            }
         }
         
         virtual void decode( coding::Decoder &decoder ) override
@@ -93,6 +171,7 @@ namespace crimild {
             Codable::decode( decoder );
             
             decoder.decode( "data", _data );
+            _usedCount = _data.size() / sizeof( T );
         }
         
         //@}
@@ -115,7 +194,7 @@ namespace crimild {
 		{
 			StreamObject::save( s );
 
-			unsigned int size = _data.size();
+			unsigned int size = getSizeInBytes();
 			s.write( size );
             
 			s.write( size ); // used count
@@ -140,6 +219,7 @@ namespace crimild {
 				_data.resize( size );
 				s.readRawBytes( &_data[ 0 ], size );
 			}
+			_usedCount = size / sizeof( T );
 		}
         
         //@}
@@ -160,6 +160,18 @@ namespace crimild {
 			_resources.push_back( resource );
 		}
 
+		/**
+			\brief Uploads new contents for an already loaded resource
+
+			Backends should override this method to refresh resources that
+			are modified in place (i.e. streaming buffers) without having
+			to unload and load them again.
+		*/
+		virtual void update( RESOURCE_TYPE *resource )
+		{
+
+		}
+
         virtual void unload( RESOURCE_TYPE *resource )
 		{
 			resource->setCatalogInfo( nullptr, getDefaultIdValue() );
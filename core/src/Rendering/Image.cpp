@@ -69,6 +69,7 @@ void Image::setData( int width, int height, int bpp, const unsigned char *data,
 	_bpp = bpp;
     _pixelFormat = format;
 	_pixelType = pixelType;
+	_mipmaps.clear();
 
 	int size = _width * _height * _bpp;
 	if ( size > 0 ) {
@@ -86,6 +87,60 @@ void Image::setData( int width, int height, int bpp, const unsigned char *data,
     }
 }
 
+crimild::Bool Image::isCompressedFormat( PixelFormat format )
+{
+	return getBlockSize( format ) > 0;
+}
+
+crimild::Size Image::getBlockSize( PixelFormat format )
+{
+	switch ( format ) {
+		case PixelFormat::BC1:
+		case PixelFormat::ETC2_RGB:
+			return 8;
+
+		case PixelFormat::BC3:
+		case PixelFormat::BC7:
+		case PixelFormat::ETC2_RGBA:
+			return 16;
+
+		default:
+			return 0;
+	}
+}
+
+crimild::Size Image::computeDataSize( PixelFormat format, crimild::Size width, crimild::Size height, crimild::Size bpp )
+{
+	auto blockSize = getBlockSize( format );
+	if ( blockSize == 0 ) {
+		return width * height * bpp;
+	}
+
+	// partial blocks are padded
+	return ( ( width + 3 ) / 4 ) * ( ( height + 3 ) / 4 ) * blockSize;
+}
+
+void Image::setCompressedData( int width, int height, PixelFormat format, const unsigned char *data )
+{
+	_width = width;
+	_height = height;
+	_bpp = 0;
+	_pixelFormat = format;
+	_pixelType = PixelType::UNSIGNED_BYTE;
+	_mipmaps.clear();
+
+	auto size = computeDataSize( format, width, height );
+	_data.resize( size );
+	if ( size > 0 ) {
+		if ( data ) {
+			memcpy( &_data[ 0 ], data, size );
+		}
+		else {
+			memset( &_data[ 0 ], 0, size );
+		}
+	}
+}
+
 void Image::load( void )
 {
 
@@ -97,6 +152,7 @@ void Image::unload( void )
 	_height = 0;
 	_bpp = 0;
     _data.resize( 0 );
+	_mipmaps.clear();
 }
 
 void Image::encode( coding::Encoder &encoder )
@@ -135,7 +191,25 @@ void Image::save( Stream &s )
 	s.write( _width );
 	s.write( _height );
 	s.write( _bpp );
-	s.writeRawBytes( &_data[ 0 ], _width * _height * _bpp * sizeof( unsigned char ) );
+	s.write( static_cast< crimild::UInt32 >( _pixelFormat ) );
+	s.write( static_cast< crimild::UInt32 >( _pixelType ) );
+
+	// compressed images have no bpp, so the data size is saved too
+	s.write( static_cast< unsigned long long >( _data.size() ) );
+	if ( _data.size() > 0 ) {
+		s.writeRawBytes( &_data[ 0 ], _data.size() );
+	}
+
+	s.write( static_cast< crimild::UInt32 >( _mipmaps.size() ) );
+	for ( auto &mip : _mipmaps ) {
+		s.write( mip->_width );
+		s.write( mip->_height );
+		s.write( mip->_bpp );
+		s.write( static_cast< unsigned long long >( mip->_data.size() ) );
+		if ( mip->_data.size() > 0 ) {
+			s.writeRawBytes( &mip->_data[ 0 ], mip->_data.size() );
+		}
+	}
 }
 
 void Image::load( Stream &s )
@@ -145,7 +219,43 @@ void Image::load( Stream &s )
 	s.read( _width );
 	s.read( _height );
 	s.read( _bpp );
-	_data.resize( _width * _height * _bpp );
-	s.readRawBytes( &_data[ 0 ], _data.size() * sizeof( unsigned char ) );
-}
+	_mipmaps.clear();
+
+	if ( s.getVersion() < Version( 4, 10, 2 ) ) {
+		_data.resize( _width * _height * _bpp );
+		s.readRawBytes( &_data[ 0 ], _data.size() * sizeof( unsigned char ) );
+		return;
+	}
+
+	crimild::UInt32 pixelFormat;
+	s.read( pixelFormat );
+	_pixelFormat = static_cast< PixelFormat >( pixelFormat );
+
+	crimild::UInt32 pixelType;
+	s.read( pixelType );
+	_pixelType = static_cast< PixelType >( pixelType );
 
+	unsigned long long dataSize;
+	s.read( dataSize );
+	_data.resize( dataSize );
+	if ( dataSize > 0 ) {
+		s.readRawBytes( &_data[ 0 ], dataSize );
+	}
+
+	crimild::UInt32 mipmapCount;
+	s.read( mipmapCount );
+	for ( crimild::UInt32 i = 0; i < mipmapCount; i++ ) {
+		auto mip = crimild::alloc< Image >();
+		s.read( mip->_width );
+		s.read( mip->_height );
+		s.read( mip->_bpp );
+		mip->_pixelFormat = _pixelFormat;
+		mip->_pixelType = _pixelType;
+		s.read( dataSize );
+		mip->_data.resize( dataSize );
+		if ( dataSize > 0 ) {
+			s.readRawBytes( &mip->_data[ 0 ], dataSize );
+		}
+		_mipmaps.push_back( mip );
+	}
+}
@@ -49,6 +49,11 @@ namespace crimild {
 			DEPTH_16,
 			DEPTH_24,
 			DEPTH_32,
+			BC1,		//< RGB, 8 bytes per 4x4 block (also known as DXT1)
+			BC3,		//< RGBA, 16 bytes per 4x4 block (also known as DXT5)
+			BC7,		//< RGBA, 16 bytes per 4x4 block
+			ETC2_RGB,	//< RGB, 8 bytes per 4x4 block
+			ETC2_RGBA,	//< RGBA, 16 bytes per 4x4 block (ETC2 color + EAC alpha)
         };
 
 		enum class PixelType {
@@ -71,6 +76,11 @@ namespace crimild {
 		unsigned char *getData( void ) { return &_data[ 0 ]; }
 		const unsigned char *getData( void ) const { return &_data[ 0 ]; }
 
+		/**
+			\brief Size of the pixel data in bytes, not including mipmaps
+		*/
+		crimild::Size getDataSize( void ) const { return _data.size(); }
+
 		void setData( int width, int height, int bpp, const unsigned char *data, PixelFormat format = PixelFormat::RGBA, PixelType pixelType = PixelType::UNSIGNED_BYTE );
 
 		bool isLoaded( void ) const { return _data.size() > 0; }
@@ -85,6 +95,72 @@ namespace crimild {
 		PixelType _pixelType;
         containers::ByteArray _data;
 
+		/**
+			\name Compressed formats
+
+			Compressed images store their pixels in 4x4 blocks, so the data
+			size depends on the format instead of the bytes per pixel. Use
+			ImageCompressor to convert images to and from these formats.
+		*/
+		//@{
+
+	public:
+		static crimild::Bool isCompressedFormat( PixelFormat format );
+
+		/**
+			\brief Size in bytes of each 4x4 block, or 0 for uncompressed formats
+		*/
+		static crimild::Size getBlockSize( PixelFormat format );
+
+		/**
+			\brief Computes the size in bytes of the pixel data for the given format
+		*/
+		static crimild::Size computeDataSize( PixelFormat format, crimild::Size width, crimild::Size height, crimild::Size bpp = 0 );
+
+		crimild::Bool isCompressed( void ) const { return isCompressedFormat( _pixelFormat ); }
+
+		/**
+			\brief Sets block-compressed pixel data
+
+			The size of the data is computed from the format and dimensions.
+			Compressed images have no bytes per pixel (bpp is zero).
+		*/
+		void setCompressedData( int width, int height, PixelFormat format, const unsigned char *data );
+
+		//@}
+
+		/**
+			\name Mipmaps
+		*/
+		//@{
+
+	public:
+		/**
+			\brief Number of mipmap levels, not including the image itself
+
+			Mipmaps are usually generated using ImageUtils::generateMipmaps().
+			Backends should upload all levels when available instead of 
+			generating them in the GPU.
+		*/
+		crimild::Size getMipmapCount( void ) const { return _mipmaps.size(); }
+		crimild::Bool hasMipmaps( void ) const { return !_mipmaps.empty(); }
+
+		/**
+			\brief Gets a mipmap level
+
+			Level 0 is the image itself. Level 1 is the first mipmap.
+		*/
+		Image *getMipmap( crimild::Size level ) { return level == 0 ? this : crimild::get_ptr( _mipmaps[ level - 1 ] ); }
+		const Image *getMipmap( crimild::Size level ) const { return level == 0 ? this : crimild::get_ptr( _mipmaps[ level - 1 ] ); }
+
+		void setMipmaps( std::vector< SharedPointer< Image >> const &mipmaps ) { _mipmaps = mipmaps; }
+		void clearMipmaps( void ) { _mipmaps.clear(); }
+
+	private:
+		std::vector< SharedPointer< Image >> _mipmaps;
+
+		//@}
+
 		/**
             \name Coding support
          */
@@ -0,0 +1,1152 @@
+/*
+ * Copyright (c) 2013, Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "ImageCompressor.hpp"
+#include "ImageUtils.hpp"
+
+#include "Concurrency/Async.hpp"
+#include "Foundation/Log.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+using namespace crimild;
+
+/**
+	\brief Pixels of a 4x4 block, in RGBA and row-major order
+*/
+struct ColorBlock {
+	crimild::Byte rgba[ 64 ];
+
+	inline const crimild::Byte *pixel( crimild::Size x, crimild::Size y ) const { return rgba + ( y * 4 + x ) * 4; }
+};
+
+static inline crimild::Int32 clampByte( crimild::Int32 value )
+{
+	return value < 0 ? 0 : ( value > 255 ? 255 : value );
+}
+
+static inline crimild::Int32 roundToInt( crimild::Real32 value )
+{
+	return static_cast< crimild::Int32 >( std::floor( value + 0.5f ) );
+}
+
+static void fetchBlock( const crimild::Byte *rgba, crimild::Size width, crimild::Size height, crimild::Size bx, crimild::Size by, ColorBlock &block )
+{
+	// pixels outside the image replicate the borders
+	for ( crimild::Size y = 0; y < 4; y++ ) {
+		auto sy = by * 4 + y < height ? by * 4 + y : height - 1;
+		for ( crimild::Size x = 0; x < 4; x++ ) {
+			auto sx = bx * 4 + x < width ? bx * 4 + x : width - 1;
+			std::memcpy( block.rgba + ( y * 4 + x ) * 4, rgba + ( sy * width + sx ) * 4, 4 );
+		}
+	}
+}
+
+static void storeBlock( const ColorBlock &block, crimild::Byte *rgba, crimild::Size width, crimild::Size height, crimild::Size bx, crimild::Size by )
+{
+	for ( crimild::Size y = 0; y < 4 && by * 4 + y < height; y++ ) {
+		for ( crimild::Size x = 0; x < 4 && bx * 4 + x < width; x++ ) {
+			std::memcpy( rgba + ( ( by * 4 + y ) * width + bx * 4 + x ) * 4, block.rgba + ( y * 4 + x ) * 4, 4 );
+		}
+	}
+}
+
+/**
+	\brief Computes the endpoints of the line that best fits the block colors
+
+	Uses the principal axis of the colors, which is computed with power 
+	iterations on the covariance matrix. Only the first 'channels' are used.
+*/
+static void computePrincipalEndpoints( const ColorBlock &block, crimild::Size channels, crimild::Real32 *e0, crimild::Real32 *e1 )
+{
+	crimild::Real32 mean[ 4 ] = { 0.0f };
+	for ( crimild::Size i = 0; i < 16; i++ ) {
+		for ( crimild::Size c = 0; c < channels; c++ ) {
+			mean[ c ] += block.rgba[ i * 4 + c ];
+		}
+	}
+	for ( crimild::Size c = 0; c < channels; c++ ) {
+		mean[ c ] /= 16.0f;
+	}
+
+	crimild::Real32 cov[ 4 ][ 4 ] = { { 0.0f } };
+	crimild::Real32 minValue[ 4 ] = { 255.0f, 255.0f, 255.0f, 255.0f };
+	crimild::Real32 maxValue[ 4 ] = { 0.0f };
+	for ( crimild::Size i = 0; i < 16; i++ ) {
+		crimild::Real32 d[ 4 ];
+		for ( crimild::Size c = 0; c < channels; c++ ) {
+			crimild::Real32 v = block.rgba[ i * 4 + c ];
+			d[ c ] = v - mean[ c ];
+			minValue[ c ] = v < minValue[ c ] ? v : minValue[ c ];
+			maxValue[ c ] = v > maxValue[ c ] ? v : maxValue[ c ];
+		}
+		for ( crimild::Size r = 0; r < channels; r++ ) {
+			for ( crimild::Size c = 0; c < channels; c++ ) {
+				cov[ r ][ c ] += d[ r ] * d[ c ];
+			}
+		}
+	}
+
+	// the bounding box diagonal is a good initial guess
+	crimild::Real32 axis[ 4 ];
+	for ( crimild::Size c = 0; c < channels; c++ ) {
+		axis[ c ] = maxValue[ c ] - minValue[ c ];
+	}
+
+	for ( int iteration = 0; iteration < 8; iteration++ ) {
+		crimild::Real32 next[ 4 ] = { 0.0f };
+		crimild::Real32 length = 0.0f;
+		for ( crimild::Size r = 0; r < channels; r++ ) {
+			for ( crimild::Size c = 0; c < channels; c++ ) {
+				next[ r ] += cov[ r ][ c ] * axis[ c ];
+			}
+			length = std::max( length, std::fabs( next[ r ] ) );
+		}
+		if ( length < 1e-6f ) {
+			break;
+		}
+		for ( crimild::Size c = 0; c < channels; c++ ) {
+			axis[ c ] = next[ c ] / length;
+		}
+	}
+
+	crimild::Real32 axisLength = 0.0f;
+	for ( crimild::Size c = 0; c < channels; c++ ) {
+		axisLength += axis[ c ] * axis[ c ];
+	}
+
+	if ( axisLength < 1e-6f ) {
+		// all colors are the same
+		for ( crimild::Size c = 0; c < channels; c++ ) {
+			e0[ c ] = e1[ c ] = mean[ c ];
+		}
+		return;
+	}
+
+	crimild::Real32 minT = std::numeric_limits< crimild::Real32 >::max();
+	crimild::Real32 maxT = -minT;
+	for ( crimild::Size i = 0; i < 16; i++ ) {
+		crimild::Real32 t = 0.0f;
+		for ( crimild::Size c = 0; c < channels; c++ ) {
+			t += ( block.rgba[ i * 4 + c ] - mean[ c ] ) * axis[ c ];
+		}
+		minT = std::min( minT, t );
+		maxT = std::max( maxT, t );
+	}
+
+	minT /= axisLength;
+	maxT /= axisLength;
+	for ( crimild::Size c = 0; c < channels; c++ ) {
+		e0[ c ] = std::min( 255.0f, std::max( 0.0f, mean[ c ] + axis[ c ] * maxT ) );
+		e1[ c ] = std::min( 255.0f, std::max( 0.0f, mean[ c ] + axis[ c ] * minT ) );
+	}
+}
+
+/**
+	\brief Finds the endpoints that minimize the error for the given weights
+
+	Each pixel is approximated as w * e0 + ( 1 - w ) * e1, which is a least
+	squares problem with a closed-form solution.
+
+	\returns false if the system is singular (i.e. all pixels use the same weight)
+*/
+static crimild::Bool solveEndpoints( const ColorBlock &block, crimild::Size channels, const crimild::Real32 *weights, crimild::Real32 *e0, crimild::Real32 *e1 )
+{
+	crimild::Real32 aa = 0.0f;
+	crimild::Real32 ab = 0.0f;
+	crimild::Real32 bb = 0.0f;
+	crimild::Real32 ax[ 4 ] = { 0.0f };
+	crimild::Real32 bx[ 4 ] = { 0.0f };
+	for ( crimild::Size i = 0; i < 16; i++ ) {
+		auto a = weights[ i ];
+		auto b = 1.0f - a;
+		aa += a * a;
+		ab += a * b;
+		bb += b * b;
+		for ( crimild::Size c = 0; c < channels; c++ ) {
+			ax[ c ] += a * block.rgba[ i * 4 + c ];
+			bx[ c ] += b * block.rgba[ i * 4 + c ];
+		}
+	}
+
+	auto det = aa * bb - ab * ab;
+	if ( std::fabs( det ) < 1e-6f ) {
+		return false;
+	}
+
+	for ( crimild::Size c = 0; c < channels; c++ ) {
+		e0[ c ] = std::min( 255.0f, std::max( 0.0f, ( bb * ax[ c ] - ab * bx[ c ] ) / det ) );
+		e1[ c ] = std::min( 255.0f, std::max( 0.0f, ( aa * bx[ c ] - ab * ax[ c ] ) / det ) );
+	}
+
+	return true;
+}
+
+static inline crimild::UInt32 colorDistance( const crimild::Byte *a, const crimild::Int32 *b, crimild::Size channels )
+{
+	crimild::UInt32 d = 0;
+	for ( crimild::Size c = 0; c < channels; c++ ) {
+		crimild::Int32 diff = crimild::Int32( a[ c ] ) - b[ c ];
+		d += diff * diff;
+	}
+	return d;
+}
+
+/**
+	\name BC1 (DXT1)
+*/
+//@{
+
+static inline crimild::UInt16 pack565( const crimild::Real32 *color )
+{
+	auto r = ( roundToInt( color[ 0 ] ) * 31 + 127 ) / 255;
+	auto g = ( roundToInt( color[ 1 ] ) * 63 + 127 ) / 255;
+	auto b = ( roundToInt( color[ 2 ] ) * 31 + 127 ) / 255;
+	return static_cast< crimild::UInt16 >( ( r << 11 ) | ( g << 5 ) | b );
+}
+
+static inline void unpack565( crimild::UInt16 color, crimild::Int32 *out )
+{
+	auto r = ( color >> 11 ) & 0x1F;
+	auto g = ( color >> 5 ) & 0x3F;
+	auto b = color & 0x1F;
+	out[ 0 ] = ( r << 3 ) | ( r >> 2 );
+	out[ 1 ] = ( g << 2 ) | ( g >> 4 );
+	out[ 2 ] = ( b << 3 ) | ( b >> 2 );
+	out[ 3 ] = 255;
+}
+
+static void computeBC1Palette( crimild::UInt16 c0, crimild::UInt16 c1, crimild::Bool forceFourColors, crimild::Int32 palette[ 4 ][ 4 ] )
+{
+	unpack565( c0, palette[ 0 ] );
+	unpack565( c1, palette[ 1 ] );
+	if ( c0 > c1 || forceFourColors ) {
+		for ( int c = 0; c < 3; c++ ) {
+			palette[ 2 ][ c ] = ( 2 * palette[ 0 ][ c ] + palette[ 1 ][ c ] ) / 3;
+			palette[ 3 ][ c ] = ( palette[ 0 ][ c ] + 2 * palette[ 1 ][ c ] ) / 3;
+		}
+		palette[ 2 ][ 3 ] = palette[ 3 ][ 3 ] = 255;
+	}
+	else {
+		for ( int c = 0; c < 3; c++ ) {
+			palette[ 2 ][ c ] = ( palette[ 0 ][ c ] + palette[ 1 ][ c ] ) / 2;
+			palette[ 3 ][ c ] = 0;
+		}
+		palette[ 2 ][ 3 ] = 255;
+		palette[ 3 ][ 3 ] = 0;
+	}
+}
+
+static crimild::UInt32 selectBC1Indices( const ColorBlock &block, crimild::UInt16 c0, crimild::UInt16 c1, crimild::UInt32 &indices )
+{
+	crimild::Int32 palette[ 4 ][ 4 ];
+	computeBC1Palette( c0, c1, true, palette );
+
+	crimild::UInt32 error = 0;
+	indices = 0;
+	for ( crimild::Size i = 0; i < 16; i++ ) {
+		crimild::UInt32 best = 0;
+		crimild::UInt32 bestDistance = std::numeric_limits< crimild::UInt32 >::max();
+		for ( crimild::UInt32 k = 0; k < 4; k++ ) {
+			auto d = colorDistance( block.rgba + i * 4, palette[ k ], 3 );
+			if ( d < bestDistance ) {
+				bestDistance = d;
+				best = k;
+			}
+		}
+		indices |= best << ( 2 * i );
+		error += bestDistance;
+	}
+
+	return error;
+}
+
+static void encodeBC1( const ColorBlock &block, crimild::Byte *out )
+{
+	static const crimild::Real32 WEIGHTS[] = { 1.0f, 0.0f, 2.0f / 3.0f, 1.0f / 3.0f };
+
+	crimild::Real32 e0[ 4 ];
+	crimild::Real32 e1[ 4 ];
+	computePrincipalEndpoints( block, 3, e0, e1 );
+
+	auto c0 = pack565( e0 );
+	auto c1 = pack565( e1 );
+	crimild::UInt32 indices = 0;
+	auto error = selectBC1Indices( block, c0, c1, indices );
+
+	// refine endpoints using the selected indices
+	for ( int iteration = 0; iteration < 2 && error > 0; iteration++ ) {
+		crimild::Real32 weights[ 16 ];
+		for ( crimild::Size i = 0; i < 16; i++ ) {
+			weights[ i ] = WEIGHTS[ ( indices >> ( 2 * i ) ) & 0x03 ];
+		}
+		if ( !solveEndpoints( block, 3, weights, e0, e1 ) ) {
+			break;
+		}
+
+		auto r0 = pack565( e0 );
+		auto r1 = pack565( e1 );
+		crimild::UInt32 refinedIndices = 0;
+		auto refinedError = selectBC1Indices( block, r0, r1, refinedIndices );
+		if ( refinedError >= error ) {
+			break;
+		}
+		c0 = r0;
+		c1 = r1;
+		indices = refinedIndices;
+		error = refinedError;
+	}
+
+	if ( c0 < c1 ) {
+		// the four-color mode requires c0 > c1
+		std::swap( c0, c1 );
+		indices ^= 0x55555555;
+	}
+	else if ( c0 == c1 ) {
+		indices = 0;
+	}
+
+	out[ 0 ] = c0 & 0xFF;
+	out[ 1 ] = c0 >> 8;
+	out[ 2 ] = c1 & 0xFF;
+	out[ 3 ] = c1 >> 8;
+	for ( int i = 0; i < 4; i++ ) {
+		out[ 4 + i ] = ( indices >> ( 8 * i ) ) & 0xFF;
+	}
+}
+
+static void decodeBC1( const crimild::Byte *in, crimild::Bool forceFourColors, ColorBlock &block )
+{
+	crimild::UInt16 c0 = in[ 0 ] | ( in[ 1 ] << 8 );
+	crimild::UInt16 c1 = in[ 2 ] | ( in[ 3 ] << 8 );
+	crimild::UInt32 indices = in[ 4 ] | ( in[ 5 ] << 8 ) | ( in[ 6 ] << 16 ) | ( crimild::UInt32( in[ 7 ] ) << 24 );
+
+	crimild::Int32 palette[ 4 ][ 4 ];
+	computeBC1Palette( c0, c1, forceFourColors, palette );
+
+	for ( crimild::Size i = 0; i < 16; i++ ) {
+		auto p = palette[ ( indices >> ( 2 * i ) ) & 0x03 ];
+		for ( int c = 0; c < 4; c++ ) {
+			block.rgba[ i * 4 + c ] = static_cast< crimild::Byte >( p[ c ] );
+		}
+	}
+}
+
+//@}
+
+/**
+	\name BC3 (DXT5) alpha
+*/
+//@{
+
+static void computeBC3AlphaPalette( crimild::Int32 a0, crimild::Int32 a1, crimild::Int32 palette[ 8 ] )
+{
+	palette[ 0 ] = a0;
+	palette[ 1 ] = a1;
+	if ( a0 > a1 ) {
+		for ( int i = 2; i < 8; i++ ) {
+			palette[ i ] = ( ( 8 - i ) * a0 + ( i - 1 ) * a1 ) / 7;
+		}
+	}
+	else {
+		for ( int i = 2; i < 6; i++ ) {
+			palette[ i ] = ( ( 6 - i ) * a0 + ( i - 1 ) * a1 ) / 5;
+		}
+		palette[ 6 ] = 0;
+		palette[ 7 ] = 255;
+	}
+}
+
+static void encodeBC3Alpha( const ColorBlock &block, crimild::Byte *out )
+{
+	crimild::Int32 minAlpha = 255;
+	crimild::Int32 maxAlpha = 0;
+	for ( crimild::Size i = 0; i < 16; i++ ) {
+		minAlpha = std::min< crimild::Int32 >( minAlpha, block.rgba[ i * 4 + 3 ] );
+		maxAlpha = std::max< crimild::Int32 >( maxAlpha, block.rgba[ i * 4 + 3 ] );
+	}
+
+	crimild::UInt64 indices = 0;
+	if ( minAlpha != maxAlpha ) {
+		crimild::Int32 palette[ 8 ];
+		computeBC3AlphaPalette( maxAlpha, minAlpha, palette );
+
+		for ( crimild::Size i = 0; i < 16; i++ ) {
+			crimild::Int32 alpha = block.rgba[ i * 4 + 3 ];
+			crimild::UInt64 best = 0;
+			crimild::Int32 bestDistance = 256;
+			for ( crimild::UInt32 k = 0; k < 8; k++ ) {
+				auto d = std::abs( palette[ k ] - alpha );
+				if ( d < bestDistance ) {
+					bestDistance = d;
+					best = k;
+				}
+			}
+			indices |= best << ( 3 * i );
+		}
+	}
+
+	out[ 0 ] = static_cast< crimild::Byte >( maxAlpha );
+	out[ 1 ] = static_cast< crimild::Byte >( minAlpha );
+	for ( int i = 0; i < 6; i++ ) {
+		out[ 2 + i ] = ( indices >> ( 8 * i ) ) & 0xFF;
+	}
+}
+
+static void decodeBC3Alpha( const crimild::Byte *in, ColorBlock &block )
+{
+	crimild::Int32 palette[ 8 ];
+	computeBC3AlphaPalette( in[ 0 ], in[ 1 ], palette );
+
+	crimild::UInt64 indices = 0;
+	for ( int i = 0; i < 6; i++ ) {
+		indices |= crimild::UInt64( in[ 2 + i ] ) << ( 8 * i );
+	}
+
+	for ( crimild::Size i = 0; i < 16; i++ ) {
+		block.rgba[ i * 4 + 3 ] = static_cast< crimild::Byte >( palette[ ( indices >> ( 3 * i ) ) & 0x07 ] );
+	}
+}
+
+//@}
+
+/**
+	\name BC7 (mode 6)
+
+	Mode 6 uses a single subset with 7-bit RGBA endpoints, a shared
+	p-bit per endpoint and 4-bit indices. It works well for most
+	textures, except those with very different colors in the same block.
+*/
+//@{
+
+static const crimild::Int32 BC7_WEIGHTS[] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+struct BC7Endpoint {
+	crimild::Int32 value[ 4 ];	// 7 bits each
+	crimild::Int32 pbit;
+
+	inline crimild::Int32 expand( crimild::Size c ) const { return ( value[ c ] << 1 ) | pbit; }
+};
+
+static BC7Endpoint quantizeBC7Endpoint( const crimild::Real32 *color )
+{
+	BC7Endpoint best;
+	crimild::Real32 bestError = std::numeric_limits< crimild::Real32 >::max();
+	for ( crimild::Int32 p = 0; p < 2; p++ ) {
+		BC7Endpoint candidate;
+		candidate.pbit = p;
+		crimild::Real32 error = 0.0f;
+		for ( crimild::Size c = 0; c < 4; c++ ) {
+			candidate.value[ c ] = std::min( 127, std::max( 0, roundToInt( ( color[ c ] - p ) * 0.5f ) ) );
+			auto d = candidate.expand( c ) - color[ c ];
+			error += d * d;
+		}
+		if ( error < bestError ) {
+			bestError = error;
+			best = candidate;
+		}
+	}
+	return best;
+}
+
+static crimild::UInt32 selectBC7Indices( const ColorBlock &block, BC7Endpoint const &e0, BC7Endpoint const &e1, crimild::Byte *indices )
+{
+	crimild::Int32 palette[ 16 ][ 4 ];
+	for ( crimild::Size k = 0; k < 16; k++ ) {
+		for ( crimild::Size c = 0; c < 4; c++ ) {
+			palette[ k ][ c ] = ( ( 64 - BC7_WEIGHTS[ k ] ) * e0.expand( c ) + BC7_WEIGHTS[ k ] * e1.expand( c ) + 32 ) >> 6;
+		}
+	}
+
+	crimild::UInt32 error = 0;
+	for ( crimild::Size i = 0; i < 16; i++ ) {
+		crimild::Byte best = 0;
+		crimild::UInt32 bestDistance = std::numeric_limits< crimild::UInt32 >::max();
+		for ( crimild::Byte k = 0; k < 16; k++ ) {
+			auto d = colorDistance( block.rgba + i * 4, palette[ k ], 4 );
+			if ( d < bestDistance ) {
+				bestDistance = d;
+				best = k;
+			}
+		}
+		indices[ i ] = best;
+		error += bestDistance;
+	}
+
+	return error;
+}
+
+/**
+	\brief Writes bits in LSB-first order, as required by BC7
+*/
+class BC7BitWriter {
+public:
+	explicit BC7BitWriter( crimild::Byte *out ) : _out( out ) { std::memset( _out, 0, 16 ); }
+
+	void write( crimild::UInt32 value, crimild::UInt32 count )
+	{
+		for ( crimild::UInt32 i = 0; i < count; i++, _pos++ ) {
+			if ( ( value >> i ) & 1 ) {
+				_out[ _pos >> 3 ] |= 1 << ( _pos & 7 );
+			}
+		}
+	}
+
+private:
+	crimild::Byte *_out;
+	crimild::UInt32 _pos = 0;
+};
+
+class BC7BitReader {
+public:
+	explicit BC7BitReader( const crimild::Byte *in ) : _in( in ) { }
+
+	crimild::UInt32 read( crimild::UInt32 count )
+	{
+		crimild::UInt32 value = 0;
+		for ( crimild::UInt32 i = 0; i < count; i++, _pos++ ) {
+			value |= ( ( _in[ _pos >> 3 ] >> ( _pos & 7 ) ) & 1 ) << i;
+		}
+		return value;
+	}
+
+private:
+	const crimild::Byte *_in;
+	crimild::UInt32 _pos = 0;
+};
+
+static void encodeBC7( const ColorBlock &block, crimild::Byte *out )
+{
+	crimild::Real32 c0[ 4 ];
+	crimild::Real32 c1[ 4 ];
+	computePrincipalEndpoints( block, 4, c0, c1 );
+
+	auto e0 = quantizeBC7Endpoint( c1 );
+	auto e1 = quantizeBC7Endpoint( c0 );
+	crimild::Byte indices[ 16 ];
+	auto error = selectBC7Indices( block, e0, e1, indices );
+
+	for ( int iteration = 0; iteration < 2 && error > 0; iteration++ ) {
+		// weights are relative to e0
+		crimild::Real32 weights[ 16 ];
+		for ( crimild::Size i = 0; i < 16; i++ ) {
+			weights[ i ] = 1.0f - BC7_WEIGHTS[ indices[ i ] ] / 64.0f;
+		}
+		if ( !solveEndpoints( block, 4, weights, c0, c1 ) ) {
+			break;
+		}
+
+		auto r0 = quantizeBC7Endpoint( c0 );
+		auto r1 = quantizeBC7Endpoint( c1 );
+		crimild::Byte refinedIndices[ 16 ];
+		auto refinedError = selectBC7Indices( block, r0, r1, refinedIndices );
+		if ( refinedError >= error ) {
+			break;
+		}
+		e0 = r0;
+		e1 = r1;
+		std::memcpy( indices, refinedIndices, 16 );
+		error = refinedError;
+	}
+
+	if ( indices[ 0 ] >= 8 ) {
+		// the anchor index is stored without its most significant bit
+		std::swap( e0, e1 );
+		for ( crimild::Size i = 0; i < 16; i++ ) {
+			indices[ i ] = 15 - indices[ i ];
+		}
+	}
+
+	BC7BitWriter bits( out );
+	bits.write( 1 << 6, 7 );
+	for ( crimild::Size c = 0; c < 4; c++ ) {
+		bits.write( e0.value[ c ], 7 );
+		bits.write( e1.value[ c ], 7 );
+	}
+	bits.write( e0.pbit, 1 );
+	bits.write( e1.pbit, 1 );
+	bits.write( indices[ 0 ], 3 );
+	for ( crimild::Size i = 1; i < 16; i++ ) {
+		bits.write( indices[ i ], 4 );
+	}
+}
+
+static crimild::Bool decodeBC7( const crimild::Byte *in, ColorBlock &block )
+{
+	if ( ( in[ 0 ] & 0x7F ) != ( 1 << 6 ) ) {
+		// only mode 6 is supported
+		std::memset( block.rgba, 0, sizeof( block.rgba ) );
+		return false;
+	}
+
+	BC7BitReader bits( in );
+	bits.read( 7 );
+
+	BC7Endpoint e0;
+	BC7Endpoint e1;
+	for ( crimild::Size c = 0; c < 4; c++ ) {
+		e0.value[ c ] = bits.read( 7 );
+		e1.value[ c ] = bits.read( 7 );
+	}
+	e0.pbit = bits.read( 1 );
+	e1.pbit = bits.read( 1 );
+
+	for ( crimild::Size i = 0; i < 16; i++ ) {
+		auto index = bits.read( i == 0 ? 3 : 4 );
+		auto w = BC7_WEIGHTS[ index ];
+		for ( crimild::Size c = 0; c < 4; c++ ) {
+			block.rgba[ i * 4 + c ] = static_cast< crimild::Byte >( ( ( 64 - w ) * e0.expand( c ) + w * e1.expand( c ) + 32 ) >> 6 );
+		}
+	}
+
+	return true;
+}
+
+//@}
+
+/**
+	\name ETC2 color
+
+	Only the individual and differential modes are used, which makes
+	blocks compatible with ETC1 decoders as well.
+*/
+//@{
+
+static const crimild::Int32 ETC_MODIFIERS[ 8 ][ 4 ] = {
+	{ 2, 8, -2, -8 },
+	{ 5, 17, -5, -17 },
+	{ 9, 29, -9, -29 },
+	{ 13, 42, -13, -42 },
+	{ 18, 60, -18, -60 },
+	{ 24, 80, -24, -80 },
+	{ 33, 106, -33, -106 },
+	{ 47, 183, -47, -183 },
+};
+
+static inline crimild::Bool isInETCSubblock( crimild::Size x, crimild::Size y, crimild::Bool flip, crimild::Size subblock )
+{
+	auto first = flip ? y < 2 : x < 2;
+	return first == ( subblock == 0 );
+}
+
+/**
+	\brief Finds the best modifier table and indices for a subblock
+
+	Indices are stored in the 2-bit form used by ETC, one per pixel
+	in row-major order.
+*/
+static crimild::UInt32 fitETCSubblock( const ColorBlock &block, crimild::Bool flip, crimild::Size subblock, const crimild::Int32 *base, crimild::UInt32 &table, crimild::Byte *indices )
+{
+	crimild::UInt32 bestError = std::numeric_limits< crimild::UInt32 >::max();
+	for ( crimild::UInt32 t = 0; t < 8; t++ ) {
+		crimild::UInt32 error = 0;
+		crimild::Byte candidate[ 16 ] = { 0 };
+		for ( crimild::Size y = 0; y < 4; y++ ) {
+			for ( crimild::Size x = 0; x < 4; x++ ) {
+				if ( !isInETCSubblock( x, y, flip, subblock ) ) {
+					continue;
+				}
+				auto p = block.pixel( x, y );
+				crimild::UInt32 bestDistance = std::numeric_limits< crimild::UInt32 >::max();
+				for ( crimild::Byte k = 0; k < 4; k++ ) {
+					crimild::Int32 color[ 3 ];
+					for ( int c = 0; c < 3; c++ ) {
+						color[ c ] = clampByte( base[ c ] + ETC_MODIFIERS[ t ][ k ] );
+					}
+					auto d = colorDistance( p, color, 3 );
+					if ( d < bestDistance ) {
+						bestDistance = d;
+						candidate[ y * 4 + x ] = k;
+					}
+				}
+				error += bestDistance;
+			}
+		}
+
+		if ( error < bestError ) {
+			bestError = error;
+			table = t;
+			for ( crimild::Size y = 0; y < 4; y++ ) {
+				for ( crimild::Size x = 0; x < 4; x++ ) {
+					if ( isInETCSubblock( x, y, flip, subblock ) ) {
+						indices[ y * 4 + x ] = candidate[ y * 4 + x ];
+					}
+				}
+			}
+		}
+	}
+
+	return bestError;
+}
+
+static inline void writeBigEndian64( crimild::UInt64 value, crimild::Byte *out )
+{
+	for ( int i = 0; i < 8; i++ ) {
+		out[ i ] = ( value >> ( 56 - 8 * i ) ) & 0xFF;
+	}
+}
+
+static inline crimild::UInt64 readBigEndian64( const crimild::Byte *in )
+{
+	crimild::UInt64 value = 0;
+	for ( int i = 0; i < 8; i++ ) {
+		value = ( value << 8 ) | in[ i ];
+	}
+	return value;
+}
+
+static void encodeETC2( const ColorBlock &block, crimild::Byte *out )
+{
+	crimild::UInt64 bestBits = 0;
+	crimild::UInt32 bestError = std::numeric_limits< crimild::UInt32 >::max();
+
+	for ( crimild::Size flip = 0; flip < 2; flip++ ) {
+		crimild::Real32 average[ 2 ][ 3 ] = { { 0.0f } };
+		for ( crimild::Size y = 0; y < 4; y++ ) {
+			for ( crimild::Size x = 0; x < 4; x++ ) {
+				auto s = isInETCSubblock( x, y, flip != 0, 0 ) ? 0 : 1;
+				for ( int c = 0; c < 3; c++ ) {
+					average[ s ][ c ] += block.pixel( x, y )[ c ] / 8.0f;
+				}
+			}
+		}
+
+		for ( crimild::Size differential = 0; differential < 2; differential++ ) {
+			crimild::Int32 quantized[ 2 ][ 3 ];
+			crimild::Int32 base[ 2 ][ 3 ];
+			for ( int s = 0; s < 2; s++ ) {
+				for ( int c = 0; c < 3; c++ ) {
+					if ( differential ) {
+						auto q = std::min( 31, std::max( 0, roundToInt( average[ s ][ c ] * 31.0f / 255.0f ) ) );
+						quantized[ s ][ c ] = q;
+						base[ s ][ c ] = ( q << 3 ) | ( q >> 2 );
+					}
+					else {
+						auto q = std::min( 15, std::max( 0, roundToInt( average[ s ][ c ] * 15.0f / 255.0f ) ) );
+						quantized[ s ][ c ] = q;
+						base[ s ][ c ] = ( q << 4 ) | q;
+					}
+				}
+			}
+
+			if ( differential ) {
+				auto valid = true;
+				for ( int c = 0; c < 3; c++ ) {
+					auto d = quantized[ 1 ][ c ] - quantized[ 0 ][ c ];
+					valid = valid && d >= -4 && d <= 3;
+				}
+				if ( !valid ) {
+					continue;
+				}
+			}
+
+			crimild::UInt32 tables[ 2 ];
+			crimild::Byte indices[ 16 ];
+			auto error = fitETCSubblock( block, flip != 0, 0, base[ 0 ], tables[ 0 ], indices )
+				+ fitETCSubblock( block, flip != 0, 1, base[ 1 ], tables[ 1 ], indices );
+			if ( error >= bestError ) {
+				continue;
+			}
+
+			crimild::UInt64 bits = 0;
+			for ( int c = 0; c < 3; c++ ) {
+				auto shift = 59 - 8 * c;
+				if ( differential ) {
+					auto d = ( quantized[ 1 ][ c ] - quantized[ 0 ][ c ] ) & 0x07;
+					bits |= crimild::UInt64( quantized[ 0 ][ c ] ) << shift;
+					bits |= crimild::UInt64( d ) << ( shift - 3 );
+				}
+				else {
+					bits |= crimild::UInt64( quantized[ 0 ][ c ] ) << ( shift + 1 );
+					bits |= crimild::UInt64( quantized[ 1 ][ c ] ) << ( shift - 3 );
+				}
+			}
+			bits |= crimild::UInt64( tables[ 0 ] ) << 37;
+			bits |= crimild::UInt64( tables[ 1 ] ) << 34;
+			bits |= crimild::UInt64( differential ) << 33;
+			bits |= crimild::UInt64( flip ) << 32;
+
+			// pixel indices are stored in column-major order
+			for ( crimild::Size y = 0; y < 4; y++ ) {
+				for ( crimild::Size x = 0; x < 4; x++ ) {
+					auto k = x * 4 + y;
+					auto index = indices[ y * 4 + x ];
+					bits |= crimild::UInt64( index >> 1 ) << ( 16 + k );
+					bits |= crimild::UInt64( index & 1 ) << k;
+				}
+			}
+
+			bestError = error;
+			bestBits = bits;
+		}
+	}
+
+	writeBigEndian64( bestBits, out );
+}
+
+static crimild::Bool decodeETC2( const crimild::Byte *in, ColorBlock &block )
+{
+	auto bits = readBigEndian64( in );
+	auto differential = ( bits >> 33 ) & 1;
+	auto flip = ( bits >> 32 ) & 1;
+	crimild::UInt32 tables[ 2 ] = { crimild::UInt32( ( bits >> 37 ) & 0x07 ), crimild::UInt32( ( bits >> 34 ) & 0x07 ) };
+
+	crimild::Int32 base[ 2 ][ 3 ];
+	for ( int c = 0; c < 3; c++ ) {
+		auto shift = 59 - 8 * c;
+		if ( differential ) {
+			crimild::Int32 q0 = ( bits >> shift ) & 0x1F;
+			crimild::Int32 d = ( bits >> ( shift - 3 ) ) & 0x07;
+			if ( d >= 4 ) {
+				d -= 8;
+			}
+			crimild::Int32 q1 = q0 + d;
+			if ( q1 < 0 || q1 > 31 ) {
+				// T, H and planar modes are not supported
+				std::memset( block.rgba, 0, sizeof( block.rgba ) );
+				return false;
+			}
+			base[ 0 ][ c ] = ( q0 << 3 ) | ( q0 >> 2 );
+			base[ 1 ][ c ] = ( q1 << 3 ) | ( q1 >> 2 );
+		}
+		else {
+			crimild::Int32 q0 = ( bits >> ( shift + 1 ) ) & 0x0F;
+			crimild::Int32 q1 = ( bits >> ( shift - 3 ) ) & 0x0F;
+			base[ 0 ][ c ] = ( q0 << 4 ) | q0;
+			base[ 1 ][ c ] = ( q1 << 4 ) | q1;
+		}
+	}
+
+	for ( crimild::Size y = 0; y < 4; y++ ) {
+		for ( crimild::Size x = 0; x < 4; x++ ) {
+			auto k = x * 4 + y;
+			auto index = ( ( ( bits >> ( 16 + k ) ) & 1 ) << 1 ) | ( ( bits >> k ) & 1 );
+			auto s = isInETCSubblock( x, y, flip != 0, 0 ) ? 0 : 1;
+			auto p = block.rgba + ( y * 4 + x ) * 4;
+			for ( int c = 0; c < 3; c++ ) {
+				p[ c ] = static_cast< crimild::Byte >( clampByte( base[ s ][ c ] + ETC_MODIFIERS[ tables[ s ] ][ index ] ) );
+			}
+			p[ 3 ] = 255;
+		}
+	}
+
+	return true;
+}
+
+//@}
+
+/**
+	\name EAC alpha
+*/
+//@{
+
+static const crimild::Int32 EAC_MODIFIERS[ 16 ][ 8 ] = {
+	{ -3, -6, -9, -15, 2, 5, 8, 14 },
+	{ -3, -7, -10, -13, 2, 6, 9, 12 },
+	{ -2, -5, -8, -13, 1, 4, 7, 12 },
+	{ -2, -4, -6, -13, 1, 3, 5, 12 },
+	{ -3, -6, -8, -12, 2, 5, 7, 11 },
+	{ -3, -7, -9, -11, 2, 6, 8, 10 },
+	{ -4, -7, -8, -11, 3, 6, 7, 10 },
+	{ -3, -5, -8, -11, 2, 4, 7, 10 },
+	{ -2, -6, -8, -10, 1, 5, 7, 9 },
+	{ -2, -5, -8, -10, 1, 4, 7, 9 },
+	{ -2, -4, -8, -10, 1, 3, 7, 9 },
+	{ -2, -5, -7, -10, 1, 4, 6, 9 },
+	{ -3, -4, -7, -10, 2, 3, 6, 9 },
+	{ -1, -2, -3, -10, 0, 1, 2, 9 },
+	{ -4, -6, -8, -9, 3, 5, 7, 8 },
+	{ -3, -5, -7, -9, 2, 4, 6, 8 },
+};
+
+static void encodeEACAlpha( const ColorBlock &block, crimild::Byte *out )
+{
+	crimild::Int32 minAlpha = 255;
+	crimild::Int32 maxAlpha = 0;
+	for ( crimild::Size i = 0; i < 16; i++ ) {
+		minAlpha = std::min< crimild::Int32 >( minAlpha, block.rgba[ i * 4 + 3 ] );
+		maxAlpha = std::max< crimild::Int32 >( maxAlpha, block.rgba[ i * 4 + 3 ] );
+	}
+
+	// constant alpha is encoded exactly using a zero modifier
+	crimild::Int32 bestBase = maxAlpha;
+	crimild::Int32 bestMultiplier = 1;
+	crimild::Int32 bestTable = 13;
+	crimild::Byte bestIndices[ 16 ] = { 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4 };
+
+	if ( minAlpha != maxAlpha ) {
+		crimild::UInt32 bestError = std::numeric_limits< crimild::UInt32 >::max();
+		for ( crimild::Int32 t = 0; t < 16 && bestError > 0; t++ ) {
+			auto tableMin = EAC_MODIFIERS[ t ][ 3 ];
+			auto tableMax = EAC_MODIFIERS[ t ][ 7 ];
+			auto estimate = roundToInt( crimild::Real32( maxAlpha - minAlpha ) / ( tableMax - tableMin ) );
+
+			for ( auto m = estimate - 1; m <= estimate + 1; m++ ) {
+				if ( m < 1 || m > 15 ) {
+					continue;
+				}
+
+				auto base = clampByte( roundToInt( 0.5f * ( maxAlpha + minAlpha ) - 0.5f * m * ( tableMax + tableMin ) ) );
+
+				crimild::UInt32 error = 0;
+				crimild::Byte indices[ 16 ];
+				for ( crimild::Size i = 0; i < 16; i++ ) {
+					crimild::Int32 alpha = block.rgba[ i * 4 + 3 ];
+					crimild::UInt32 bestDistance = std::numeric_limits< crimild::UInt32 >::max();
+					for ( crimild::Byte k = 0; k < 8; k++ ) {
+						auto d = alpha - clampByte( base + EAC_MODIFIERS[ t ][ k ] * m );
+						crimild::UInt32 distance = d * d;
+						if ( distance < bestDistance ) {
+							bestDistance = distance;
+							indices[ i ] = k;
+						}
+					}
+					error += bestDistance;
+				}
+
+				if ( error < bestError ) {
+					bestError = error;
+					bestBase = base;
+					bestMultiplier = m;
+					bestTable = t;
+					std::memcpy( bestIndices, indices, 16 );
+				}
+			}
+		}
+	}
+
+	crimild::UInt64 bits = 0;
+	bits |= crimild::UInt64( bestBase ) << 56;
+	bits |= crimild::UInt64( bestMultiplier ) << 52;
+	bits |= crimild::UInt64( bestTable ) << 48;
+	for ( crimild::Size y = 0; y < 4; y++ ) {
+		for ( crimild::Size x = 0; x < 4; x++ ) {
+			auto k = x * 4 + y;
+			bits |= crimild::UInt64( bestIndices[ y * 4 + x ] ) << ( 45 - 3 * k );
+		}
+	}
+
+	writeBigEndian64( bits, out );
+}
+
+static void decodeEACAlpha( const crimild::Byte *in, ColorBlock &block )
+{
+	auto bits = readBigEndian64( in );
+	crimild::Int32 base = ( bits >> 56 ) & 0xFF;
+	crimild::Int32 multiplier = ( bits >> 52 ) & 0x0F;
+	crimild::Int32 table = ( bits >> 48 ) & 0x0F;
+
+	for ( crimild::Size y = 0; y < 4; y++ ) {
+		for ( crimild::Size x = 0; x < 4; x++ ) {
+			auto k = x * 4 + y;
+			auto index = ( bits >> ( 45 - 3 * k ) ) & 0x07;
+			block.rgba[ ( y * 4 + x ) * 4 + 3 ] = static_cast< crimild::Byte >( clampByte( base + EAC_MODIFIERS[ table ][ index ] * multiplier ) );
+		}
+	}
+}
+
+//@}
+
+static void encodeBlock( Image::PixelFormat format, const ColorBlock &block, crimild::Byte *out )
+{
+	switch ( format ) {
+		case Image::PixelFormat::BC1:
+			encodeBC1( block, out );
+			break;
+
+		case Image::PixelFormat::BC3:
+			encodeBC3Alpha( block, out );
+			encodeBC1( block, out + 8 );
+			break;
+
+		case Image::PixelFormat::BC7:
+			encodeBC7( block, out );
+			break;
+
+		case Image::PixelFormat::ETC2_RGB:
+			encodeETC2( block, out );
+			break;
+
+		case Image::PixelFormat::ETC2_RGBA:
+			encodeEACAlpha( block, out );
+			encodeETC2( block, out + 8 );
+			break;
+
+		default:
+			break;
+	}
+}
+
+static crimild::Bool decodeBlock( Image::PixelFormat format, const crimild::Byte *in, ColorBlock &block )
+{
+	switch ( format ) {
+		case Image::PixelFormat::BC1:
+			decodeBC1( in, false, block );
+			return true;
+
+		case Image::PixelFormat::BC3:
+			decodeBC1( in + 8, true, block );
+			decodeBC3Alpha( in, block );
+			return true;
+
+		case Image::PixelFormat::BC7:
+			return decodeBC7( in, block );
+
+		case Image::PixelFormat::ETC2_RGB:
+			return decodeETC2( in, block );
+
+		case Image::PixelFormat::ETC2_RGBA: {
+			auto ret = decodeETC2( in + 8, block );
+			decodeEACAlpha( in, block );
+			return ret;
+		}
+
+		default:
+			return false;
+	}
+}
+
+static SharedPointer< Image > compressLevel( const Image *image, Image::PixelFormat format )
+{
+	std::vector< crimild::Byte > rgba;
+	if ( !ImageUtils::convertToRGBA( image, rgba ) ) {
+		return nullptr;
+	}
+
+	const crimild::Size width = image->getWidth();
+	const crimild::Size height = image->getHeight();
+	const crimild::Size blocksX = ( width + 3 ) / 4;
+	const crimild::Size blocksY = ( height + 3 ) / 4;
+	const crimild::Size blockSize = Image::getBlockSize( format );
+
+	auto result = crimild::alloc< Image >();
+	result->setCompressedData( width, height, format, nullptr );
+	auto out = result->getData();
+	auto in = &rgba[ 0 ];
+
+	// each row of blocks is written by a single job
+	concurrency::parallel_for( blocksY, [ in, out, width, height, blocksX, blockSize, format ]( crimild::Size by ) {
+		ColorBlock block;
+		for ( crimild::Size bx = 0; bx < blocksX; bx++ ) {
+			fetchBlock( in, width, height, bx, by, block );
+			encodeBlock( format, block, out + ( by * blocksX + bx ) * blockSize );
+		}
+	});
+
+	return result;
+}
+
+static SharedPointer< Image > decompressLevel( const Image *image )
+{
+	const crimild::Size width = image->getWidth();
+	const crimild::Size height = image->getHeight();
+	const crimild::Size blocksX = ( width + 3 ) / 4;
+	const crimild::Size blocksY = ( height + 3 ) / 4;
+	const auto format = image->getPixelFormat();
+	const crimild::Size blockSize = Image::getBlockSize( format );
+
+	if ( image->getDataSize() < blocksX * blocksY * blockSize ) {
+		return nullptr;
+	}
+
+	auto result = crimild::alloc< Image >( width, height, 4, nullptr, Image::PixelFormat::RGBA );
+	auto out = result->getData();
+	auto in = image->getData();
+
+	crimild::Size failed = 0;
+	for ( crimild::Size by = 0; by < blocksY; by++ ) {
+		for ( crimild::Size bx = 0; bx < blocksX; bx++ ) {
+			ColorBlock block;
+			if ( !decodeBlock( format, in + ( by * blocksX + bx ) * blockSize, block ) ) {
+				++failed;
+			}
+			storeBlock( block, out, width, height, bx, by );
+		}
+	}
+
+	if ( failed > 0 ) {
+		Log::warning( "crimild::ImageCompressor", failed, " blocks use unsupported modes and were decoded as black" );
+	}
+
+	return result;
+}
+
+SharedPointer< Image > ImageCompressor::compress( const Image *image, Image::PixelFormat format )
+{
+	if ( !Image::isCompressedFormat( format ) ) {
+		Log::error( CRIMILD_CURRENT_CLASS_NAME, "Target format is not a compressed format" );
+		return nullptr;
+	}
+
+	auto result = compressLevel( image, format );
+	if ( result == nullptr ) {
+		Log::error( CRIMILD_CURRENT_CLASS_NAME, "Unsupported image format" );
+		return nullptr;
+	}
+
+	std::vector< SharedPointer< Image >> mipmaps;
+	for ( crimild::Size level = 1; level <= image->getMipmapCount(); level++ ) {
+		auto mipmap = compressLevel( image->getMipmap( level ), format );
+		if ( mipmap == nullptr ) {
+			break;
+		}
+		mipmaps.push_back( mipmap );
+	}
+	result->setMipmaps( mipmaps );
+
+	return result;
+}
+
+SharedPointer< Image > ImageCompressor::decompress( const Image *image )
+{
+	if ( image == nullptr || !image->isCompressed() ) {
+		return nullptr;
+	}
+
+	auto result = decompressLevel( image );
+	if ( result == nullptr ) {
+		Log::error( CRIMILD_CURRENT_CLASS_NAME, "Invalid compressed data" );
+		return nullptr;
+	}
+
+	std::vector< SharedPointer< Image >> mipmaps;
+	for ( crimild::Size level = 1; level <= image->getMipmapCount(); level++ ) {
+		auto mipmap = decompressLevel( image->getMipmap( level ) );
+		if ( mipmap == nullptr ) {
+			break;
+		}
+		mipmaps.push_back( mipmap );
+	}
+	result->setMipmaps( mipmaps );
+
+	return result;
+}
+
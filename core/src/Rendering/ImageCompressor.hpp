@@ -0,0 +1,71 @@
+/*
+ * Copyright (c) 2013, Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef CRIMILD_RENDERING_IMAGE_COMPRESSOR_
+#define CRIMILD_RENDERING_IMAGE_COMPRESSOR_
+
+#include "Image.hpp"
+
+namespace crimild {
+
+	/**
+		\brief Converts images to and from block-compressed formats
+
+		Compressed textures use 4x (BC3, BC7, ETC2_RGBA) or 8x (BC1, ETC2_RGB) 
+		less memory than RGBA images, both in RAM and VRAM. 
+
+		Encoding is expensive and it's meant to be done offline (see the 
+		texconv tool) or at import time. Blocks are processed in parallel
+		if the job scheduler is running.
+
+		BC7 blocks are encoded using mode 6 only and ETC2 blocks only use
+		the ETC1-compatible individual and differential modes. Decoding 
+		supports the same subset, which is enough to validate the encoder
+		and to use compressed assets when the GPU cannot decode them.
+	*/
+	class ImageCompressor {
+	public:
+		/**
+			\brief Compresses an 8-bit image, including all of its mipmaps
+
+			\returns nullptr if either the image or the target format are
+			not supported
+		*/
+		static SharedPointer< Image > compress( const Image *image, Image::PixelFormat format );
+
+		/**
+			\brief Decompresses an image to RGBA, including all of its mipmaps
+
+			\returns nullptr if the image is not compressed
+		*/
+		static SharedPointer< Image > decompress( const Image *image );
+	};
+
+}
+
+#endif
+
@@ -0,0 +1,343 @@
+/*
+ * Copyright (c) 2013, Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "ImageDDS.hpp"
+#include "Coding/Encoder.hpp"
+#include "Coding/Decoder.hpp"
+#include "Foundation/Log.hpp"
+#include "Simulation/FileSystem.hpp"
+#include "Exceptions/FileNotFoundException.hpp"
+#include "Exceptions/InvalidFileFormatException.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+using namespace crimild;
+
+#define DDS_FOURCC( a, b, c, d ) ( crimild::UInt32( a ) | ( crimild::UInt32( b ) << 8 ) | ( crimild::UInt32( c ) << 16 ) | ( crimild::UInt32( d ) << 24 ) )
+
+static const crimild::UInt32 DDS_MAGIC = DDS_FOURCC( 'D', 'D', 'S', ' ' );
+static const crimild::UInt32 DDS_FOURCC_DXT1 = DDS_FOURCC( 'D', 'X', 'T', '1' );
+static const crimild::UInt32 DDS_FOURCC_DXT5 = DDS_FOURCC( 'D', 'X', 'T', '5' );
+static const crimild::UInt32 DDS_FOURCC_DX10 = DDS_FOURCC( 'D', 'X', '1', '0' );
+
+static const crimild::Size DDS_HEADER_SIZE = 124;
+static const crimild::Size DDS_HEADER_DX10_SIZE = 20;
+
+static const crimild::UInt32 DDSD_CAPS = 0x1;
+static const crimild::UInt32 DDSD_HEIGHT = 0x2;
+static const crimild::UInt32 DDSD_WIDTH = 0x4;
+static const crimild::UInt32 DDSD_PITCH = 0x8;
+static const crimild::UInt32 DDSD_PIXELFORMAT = 0x1000;
+static const crimild::UInt32 DDSD_MIPMAPCOUNT = 0x20000;
+static const crimild::UInt32 DDSD_LINEARSIZE = 0x80000;
+
+static const crimild::UInt32 DDPF_ALPHAPIXELS = 0x1;
+static const crimild::UInt32 DDPF_FOURCC = 0x4;
+static const crimild::UInt32 DDPF_RGB = 0x40;
+
+static const crimild::UInt32 DDSCAPS_COMPLEX = 0x8;
+static const crimild::UInt32 DDSCAPS_TEXTURE = 0x1000;
+static const crimild::UInt32 DDSCAPS_MIPMAP = 0x400000;
+
+static const crimild::UInt32 DXGI_FORMAT_R8G8B8A8_UNORM = 28;
+static const crimild::UInt32 DXGI_FORMAT_BC1_UNORM = 71;
+static const crimild::UInt32 DXGI_FORMAT_BC1_UNORM_SRGB = 72;
+static const crimild::UInt32 DXGI_FORMAT_BC3_UNORM = 77;
+static const crimild::UInt32 DXGI_FORMAT_BC3_UNORM_SRGB = 78;
+static const crimild::UInt32 DXGI_FORMAT_BC7_UNORM = 98;
+static const crimild::UInt32 DXGI_FORMAT_BC7_UNORM_SRGB = 99;
+static const crimild::UInt32 D3D10_RESOURCE_DIMENSION_TEXTURE2D = 3;
+
+static inline crimild::UInt32 readUInt32( const crimild::Byte *p )
+{
+	return p[ 0 ] | ( p[ 1 ] << 8 ) | ( p[ 2 ] << 16 ) | ( crimild::UInt32( p[ 3 ] ) << 24 );
+}
+
+static inline void writeUInt32( crimild::Byte *p, crimild::UInt32 value )
+{
+	p[ 0 ] = value & 0xFF;
+	p[ 1 ] = ( value >> 8 ) & 0xFF;
+	p[ 2 ] = ( value >> 16 ) & 0xFF;
+	p[ 3 ] = ( value >> 24 ) & 0xFF;
+}
+
+ImageDDS::ImageDDS( void )
+{
+
+}
+
+ImageDDS::ImageDDS( std::string filePath )
+	: _filePath( filePath )
+{
+	load();
+}
+
+ImageDDS::~ImageDDS( void )
+{
+
+}
+
+void ImageDDS::load( void )
+{
+	containers::ByteArray data;
+	if ( !FileSystem::getInstance().readFile( _filePath, data ) ) {
+		throw FileNotFoundException( _filePath );
+	}
+
+	if ( !loadFromMemory( data.getData(), data.size() ) ) {
+		throw InvalidFileFormatException( _filePath );
+	}
+}
+
+crimild::Bool ImageDDS::loadFromMemory( const crimild::Byte *data, crimild::Size size )
+{
+	if ( size < 4 + DDS_HEADER_SIZE || readUInt32( data ) != DDS_MAGIC || readUInt32( data + 4 ) != DDS_HEADER_SIZE ) {
+		return false;
+	}
+
+	auto header = data + 4;
+	crimild::Size height = readUInt32( header + 8 );
+	crimild::Size width = readUInt32( header + 12 );
+	crimild::Size levels = ( readUInt32( header + 4 ) & DDSD_MIPMAPCOUNT ) ? readUInt32( header + 24 ) : 1;
+	auto pixelFormatFlags = readUInt32( header + 76 );
+	auto fourCC = readUInt32( header + 80 );
+	auto bitCount = readUInt32( header + 84 );
+	auto redMask = readUInt32( header + 88 );
+
+	if ( width == 0 || height == 0 ) {
+		return false;
+	}
+	levels = std::max< crimild::Size >( 1, levels );
+
+	crimild::Size offset = 4 + DDS_HEADER_SIZE;
+
+	PixelFormat format = PixelFormat::RGBA;
+	crimild::Size bpp = 0;
+	if ( pixelFormatFlags & DDPF_FOURCC ) {
+		if ( fourCC == DDS_FOURCC_DXT1 ) {
+			format = PixelFormat::BC1;
+		}
+		else if ( fourCC == DDS_FOURCC_DXT5 ) {
+			format = PixelFormat::BC3;
+		}
+		else if ( fourCC == DDS_FOURCC_DX10 ) {
+			if ( size < offset + DDS_HEADER_DX10_SIZE ) {
+				return false;
+			}
+
+			auto dxgiFormat = readUInt32( data + offset );
+			auto dimension = readUInt32( data + offset + 4 );
+			auto arraySize = readUInt32( data + offset + 12 );
+			offset += DDS_HEADER_DX10_SIZE;
+
+			if ( dimension != D3D10_RESOURCE_DIMENSION_TEXTURE2D || arraySize > 1 ) {
+				Log::error( CRIMILD_CURRENT_CLASS_NAME, "Only 2D textures are supported" );
+				return false;
+			}
+
+			switch ( dxgiFormat ) {
+				case DXGI_FORMAT_BC1_UNORM:
+				case DXGI_FORMAT_BC1_UNORM_SRGB:
+					format = PixelFormat::BC1;
+					break;
+
+				case DXGI_FORMAT_BC3_UNORM:
+				case DXGI_FORMAT_BC3_UNORM_SRGB:
+					format = PixelFormat::BC3;
+					break;
+
+				case DXGI_FORMAT_BC7_UNORM:
+				case DXGI_FORMAT_BC7_UNORM_SRGB:
+					format = PixelFormat::BC7;
+					break;
+
+				case DXGI_FORMAT_R8G8B8A8_UNORM:
+					format = PixelFormat::RGBA;
+					bpp = 4;
+					break;
+
+				default:
+					Log::error( CRIMILD_CURRENT_CLASS_NAME, "Unsupported DXGI format ", dxgiFormat );
+					return false;
+			}
+		}
+		else {
+			Log::error( CRIMILD_CURRENT_CLASS_NAME, "Unsupported texture format" );
+			return false;
+		}
+	}
+	else if ( ( pixelFormatFlags & DDPF_RGB ) && ( bitCount == 24 || bitCount == 32 ) ) {
+		bpp = bitCount / 8;
+		auto isRGB = redMask == 0x000000FF;
+		if ( bpp == 4 ) {
+			format = isRGB ? PixelFormat::RGBA : PixelFormat::BGRA;
+		}
+		else {
+			format = isRGB ? PixelFormat::RGB : PixelFormat::BGR;
+		}
+	}
+	else {
+		Log::error( CRIMILD_CURRENT_CLASS_NAME, "Unsupported texture format" );
+		return false;
+	}
+
+	std::vector< SharedPointer< Image >> mipmaps;
+	for ( crimild::Size level = 0; level < levels; level++ ) {
+		auto w = std::max< crimild::Size >( 1, width >> level );
+		auto h = std::max< crimild::Size >( 1, height >> level );
+		auto levelSize = computeDataSize( format, w, h, bpp );
+		if ( levelSize > size - offset ) {
+			return false;
+		}
+
+		Image *target = this;
+		SharedPointer< Image > mipmap;
+		if ( level > 0 ) {
+			mipmap = crimild::alloc< Image >();
+			target = crimild::get_ptr( mipmap );
+			mipmaps.push_back( mipmap );
+		}
+
+		if ( bpp == 0 ) {
+			target->setCompressedData( w, h, format, data + offset );
+		}
+		else {
+			target->setData( w, h, bpp, data + offset, format );
+		}
+
+		offset += levelSize;
+	}
+
+	setMipmaps( mipmaps );
+
+	return true;
+}
+
+crimild::Bool ImageDDS::save( const Image *image, const std::string &path )
+{
+	if ( image == nullptr || !image->hasData() ) {
+		return false;
+	}
+
+	crimild::Byte header[ 4 + DDS_HEADER_SIZE ] = { 0 };
+	crimild::Byte header10[ DDS_HEADER_DX10_SIZE ] = { 0 };
+	crimild::Bool useHeader10 = false;
+
+	auto ddsHeader = header + 4;
+	auto pixelFormatFlags = DDPF_FOURCC;
+	crimild::UInt32 flags = DDSD_CAPS | DDSD_HEIGHT | DDSD_WIDTH | DDSD_PIXELFORMAT | DDSD_MIPMAPCOUNT;
+
+	switch ( image->getPixelFormat() ) {
+		case PixelFormat::BC1:
+			writeUInt32( ddsHeader + 80, DDS_FOURCC_DXT1 );
+			break;
+
+		case PixelFormat::BC3:
+			writeUInt32( ddsHeader + 80, DDS_FOURCC_DXT5 );
+			break;
+
+		case PixelFormat::BC7:
+			writeUInt32( ddsHeader + 80, DDS_FOURCC_DX10 );
+			writeUInt32( header10, DXGI_FORMAT_BC7_UNORM );
+			writeUInt32( header10 + 4, D3D10_RESOURCE_DIMENSION_TEXTURE2D );
+			writeUInt32( header10 + 12, 1 );
+			useHeader10 = true;
+			break;
+
+		case PixelFormat::RGB:
+		case PixelFormat::RGBA:
+			if ( image->getBpp() != ( image->getPixelFormat() == PixelFormat::RGB ? 3 : 4 ) ) {
+				Log::error( CRIMILD_CURRENT_CLASS_NAME, "Unsupported image format" );
+				return false;
+			}
+			pixelFormatFlags = DDPF_RGB | ( image->getBpp() == 4 ? DDPF_ALPHAPIXELS : 0 );
+			writeUInt32( ddsHeader + 84, image->getBpp() * 8 );
+			writeUInt32( ddsHeader + 88, 0x000000FF );
+			writeUInt32( ddsHeader + 92, 0x0000FF00 );
+			writeUInt32( ddsHeader + 96, 0x00FF0000 );
+			writeUInt32( ddsHeader + 100, image->getBpp() == 4 ? 0xFF000000 : 0 );
+			break;
+
+		default:
+			Log::error( CRIMILD_CURRENT_CLASS_NAME, "Unsupported image format" );
+			return false;
+	}
+
+	const crimild::Size levels = image->getMipmapCount() + 1;
+
+	flags |= image->isCompressed() ? DDSD_LINEARSIZE : DDSD_PITCH;
+
+	writeUInt32( header, DDS_MAGIC );
+	writeUInt32( ddsHeader, DDS_HEADER_SIZE );
+	writeUInt32( ddsHeader + 4, flags );
+	writeUInt32( ddsHeader + 8, image->getHeight() );
+	writeUInt32( ddsHeader + 12, image->getWidth() );
+	writeUInt32( ddsHeader + 16, image->isCompressed() ? image->getDataSize() : image->getWidth() * image->getBpp() );
+	writeUInt32( ddsHeader + 24, levels );
+	writeUInt32( ddsHeader + 72, 32 );
+	writeUInt32( ddsHeader + 76, pixelFormatFlags );
+	writeUInt32( ddsHeader + 104, DDSCAPS_TEXTURE | ( levels > 1 ? DDSCAPS_COMPLEX | DDSCAPS_MIPMAP : 0 ) );
+
+	auto out = std::fopen( path.c_str(), "wb" );
+	if ( out == nullptr ) {
+		Log::error( CRIMILD_CURRENT_CLASS_NAME, "Cannot open file ", path );
+		return false;
+	}
+
+	auto ok = std::fwrite( header, sizeof( header ), 1, out ) == 1;
+	if ( useHeader10 ) {
+		ok = ok && std::fwrite( header10, sizeof( header10 ), 1, out ) == 1;
+	}
+	for ( crimild::Size level = 0; ok && level < levels; level++ ) {
+		auto mipmap = image->getMipmap( level );
+		ok = std::fwrite( mipmap->getData(), mipmap->getDataSize(), 1, out ) == 1;
+	}
+
+	std::fclose( out );
+
+	return ok;
+}
+
+void ImageDDS::encode( coding::Encoder &encoder )
+{
+    Image::encode( encoder );
+}
+
+void ImageDDS::decode( coding::Decoder &decoder )
+{
+    Image::decode( decoder );
+
+    decoder.decode( "imageFileName", _filePath );
+    if ( _filePath.length() > 0 ) {
+        _filePath = FileSystem::getInstance().pathForResource( _filePath );
+        load();
+    }
+}
+
@@ -0,0 +1,373 @@
+/*
+ * Copyright (c) 2013, Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "ImageKTX.hpp"
+#include "Coding/Encoder.hpp"
+#include "Coding/Decoder.hpp"
+#include "Foundation/Log.hpp"
+#include "Simulation/FileSystem.hpp"
+#include "Exceptions/FileNotFoundException.hpp"
+#include "Exceptions/InvalidFileFormatException.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+using namespace crimild;
+
+static const crimild::Byte KTX_IDENTIFIER[] = { 0xAB, 0x4B, 0x54, 0x58, 0x20, 0x31, 0x31, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A };
+static const crimild::UInt32 KTX_ENDIANNESS = 0x04030201;
+static const crimild::Size KTX_HEADER_SIZE = 64;
+
+static const crimild::UInt32 KTX_GL_UNSIGNED_BYTE = 0x1401;
+static const crimild::UInt32 KTX_GL_RGB = 0x1907;
+static const crimild::UInt32 KTX_GL_RGBA = 0x1908;
+static const crimild::UInt32 KTX_GL_RGB8 = 0x8051;
+static const crimild::UInt32 KTX_GL_RGBA8 = 0x8058;
+static const crimild::UInt32 KTX_GL_COMPRESSED_RGB_S3TC_DXT1 = 0x83F0;
+static const crimild::UInt32 KTX_GL_COMPRESSED_RGBA_S3TC_DXT1 = 0x83F1;
+static const crimild::UInt32 KTX_GL_COMPRESSED_RGBA_S3TC_DXT5 = 0x83F3;
+static const crimild::UInt32 KTX_GL_COMPRESSED_RGBA_BPTC_UNORM = 0x8E8C;
+static const crimild::UInt32 KTX_GL_COMPRESSED_RGB8_ETC2 = 0x9274;
+static const crimild::UInt32 KTX_GL_COMPRESSED_RGBA8_ETC2_EAC = 0x9278;
+
+static crimild::Bool fromGLInternalFormat( crimild::UInt32 internalFormat, Image::PixelFormat &format, crimild::Size &bpp )
+{
+	bpp = 0;
+	switch ( internalFormat ) {
+		case KTX_GL_COMPRESSED_RGB_S3TC_DXT1:
+		case KTX_GL_COMPRESSED_RGBA_S3TC_DXT1:
+			format = Image::PixelFormat::BC1;
+			return true;
+
+		case KTX_GL_COMPRESSED_RGBA_S3TC_DXT5:
+			format = Image::PixelFormat::BC3;
+			return true;
+
+		case KTX_GL_COMPRESSED_RGBA_BPTC_UNORM:
+			format = Image::PixelFormat::BC7;
+			return true;
+
+		case KTX_GL_COMPRESSED_RGB8_ETC2:
+			format = Image::PixelFormat::ETC2_RGB;
+			return true;
+
+		case KTX_GL_COMPRESSED_RGBA8_ETC2_EAC:
+			format = Image::PixelFormat::ETC2_RGBA;
+			return true;
+
+		case KTX_GL_RGB:
+		case KTX_GL_RGB8:
+			format = Image::PixelFormat::RGB;
+			bpp = 3;
+			return true;
+
+		case KTX_GL_RGBA:
+		case KTX_GL_RGBA8:
+			format = Image::PixelFormat::RGBA;
+			bpp = 4;
+			return true;
+
+		default:
+			return false;
+	}
+}
+
+static crimild::Bool toGLInternalFormat( const Image *image, crimild::UInt32 &internalFormat, crimild::UInt32 &baseFormat )
+{
+	switch ( image->getPixelFormat() ) {
+		case Image::PixelFormat::BC1:
+			internalFormat = KTX_GL_COMPRESSED_RGB_S3TC_DXT1;
+			baseFormat = KTX_GL_RGB;
+			return true;
+
+		case Image::PixelFormat::BC3:
+			internalFormat = KTX_GL_COMPRESSED_RGBA_S3TC_DXT5;
+			baseFormat = KTX_GL_RGBA;
+			return true;
+
+		case Image::PixelFormat::BC7:
+			internalFormat = KTX_GL_COMPRESSED_RGBA_BPTC_UNORM;
+			baseFormat = KTX_GL_RGBA;
+			return true;
+
+		case Image::PixelFormat::ETC2_RGB:
+			internalFormat = KTX_GL_COMPRESSED_RGB8_ETC2;
+			baseFormat = KTX_GL_RGB;
+			return true;
+
+		case Image::PixelFormat::ETC2_RGBA:
+			internalFormat = KTX_GL_COMPRESSED_RGBA8_ETC2_EAC;
+			baseFormat = KTX_GL_RGBA;
+			return true;
+
+		case Image::PixelFormat::RGB:
+			if ( image->getBpp() != 3 ) {
+				return false;
+			}
+			internalFormat = KTX_GL_RGB8;
+			baseFormat = KTX_GL_RGB;
+			return true;
+
+		case Image::PixelFormat::RGBA:
+			if ( image->getBpp() != 4 ) {
+				return false;
+			}
+			internalFormat = KTX_GL_RGBA8;
+			baseFormat = KTX_GL_RGBA;
+			return true;
+
+		default:
+			return false;
+	}
+}
+
+static inline crimild::UInt32 readUInt32( const crimild::Byte *p, crimild::Bool swap )
+{
+	crimild::UInt32 value = p[ 0 ] | ( p[ 1 ] << 8 ) | ( p[ 2 ] << 16 ) | ( crimild::UInt32( p[ 3 ] ) << 24 );
+	if ( swap ) {
+		value = ( value >> 24 ) | ( ( value >> 8 ) & 0xFF00 ) | ( ( value << 8 ) & 0xFF0000 ) | ( value << 24 );
+	}
+	return value;
+}
+
+static inline void writeUInt32( std::vector< crimild::Byte > &out, crimild::UInt32 value )
+{
+	out.push_back( value & 0xFF );
+	out.push_back( ( value >> 8 ) & 0xFF );
+	out.push_back( ( value >> 16 ) & 0xFF );
+	out.push_back( ( value >> 24 ) & 0xFF );
+}
+
+/**
+	\brief Size of a row in bytes for uncompressed images
+
+	Rows are aligned to 4 bytes in KTX files
+*/
+static inline crimild::Size computeRowPitch( crimild::Size width, crimild::Size bpp )
+{
+	return ( width * bpp + 3 ) & ~crimild::Size( 3 );
+}
+
+ImageKTX::ImageKTX( void )
+{
+
+}
+
+ImageKTX::ImageKTX( std::string filePath )
+	: _filePath( filePath )
+{
+	load();
+}
+
+ImageKTX::~ImageKTX( void )
+{
+
+}
+
+void ImageKTX::load( void )
+{
+	containers::ByteArray data;
+	if ( !FileSystem::getInstance().readFile( _filePath, data ) ) {
+		throw FileNotFoundException( _filePath );
+	}
+
+	if ( !loadFromMemory( data.getData(), data.size() ) ) {
+		throw InvalidFileFormatException( _filePath );
+	}
+}
+
+crimild::Bool ImageKTX::loadFromMemory( const crimild::Byte *data, crimild::Size size )
+{
+	if ( size < KTX_HEADER_SIZE || std::memcmp( data, KTX_IDENTIFIER, sizeof( KTX_IDENTIFIER ) ) != 0 ) {
+		return false;
+	}
+
+	auto header = data + sizeof( KTX_IDENTIFIER );
+	auto swap = readUInt32( header, false ) != KTX_ENDIANNESS;
+	if ( swap && readUInt32( header, true ) != KTX_ENDIANNESS ) {
+		return false;
+	}
+
+	auto glType = readUInt32( header + 4, swap );
+	auto glInternalFormat = readUInt32( header + 16, swap );
+	crimild::Size width = readUInt32( header + 24, swap );
+	crimild::Size height = readUInt32( header + 28, swap );
+	auto depth = readUInt32( header + 32, swap );
+	auto arrayElements = readUInt32( header + 36, swap );
+	auto faces = readUInt32( header + 40, swap );
+	auto levels = readUInt32( header + 44, swap );
+	auto keyValueBytes = readUInt32( header + 48, swap );
+
+	if ( width == 0 || height == 0 || depth > 1 || arrayElements > 0 || faces != 1 ) {
+		Log::error( CRIMILD_CURRENT_CLASS_NAME, "Only 2D textures are supported" );
+		return false;
+	}
+
+	PixelFormat format = PixelFormat::RGBA;
+	crimild::Size bpp = 0;
+	if ( !fromGLInternalFormat( glInternalFormat, format, bpp ) || ( bpp > 0 && glType != KTX_GL_UNSIGNED_BYTE ) ) {
+		Log::error( CRIMILD_CURRENT_CLASS_NAME, "Unsupported texture format ", glInternalFormat );
+		return false;
+	}
+
+	if ( levels == 0 ) {
+		// mipmaps should be generated at runtime
+		levels = 1;
+	}
+
+	crimild::Size offset = KTX_HEADER_SIZE + keyValueBytes;
+	std::vector< SharedPointer< Image >> mipmaps;
+	for ( crimild::UInt32 level = 0; level < levels; level++ ) {
+		if ( offset + 4 > size ) {
+			return false;
+		}
+
+		crimild::Size imageSize = readUInt32( data + offset, swap );
+		offset += 4;
+		if ( imageSize > size - offset ) {
+			return false;
+		}
+
+		auto w = std::max< crimild::Size >( 1, width >> level );
+		auto h = std::max< crimild::Size >( 1, height >> level );
+		auto pixels = data + offset;
+
+		Image *target = this;
+		SharedPointer< Image > mipmap;
+		if ( level > 0 ) {
+			mipmap = crimild::alloc< Image >();
+			target = crimild::get_ptr( mipmap );
+			mipmaps.push_back( mipmap );
+		}
+
+		if ( bpp == 0 ) {
+			if ( imageSize < computeDataSize( format, w, h ) ) {
+				return false;
+			}
+			target->setCompressedData( w, h, format, pixels );
+		}
+		else {
+			auto pitch = computeRowPitch( w, bpp );
+			if ( imageSize < pitch * h ) {
+				return false;
+			}
+			target->setData( w, h, bpp, nullptr, format );
+			for ( crimild::Size y = 0; y < h; y++ ) {
+				std::memcpy( target->getData() + y * w * bpp, pixels + y * pitch, w * bpp );
+			}
+		}
+
+		offset += ( imageSize + 3 ) & ~crimild::Size( 3 );
+	}
+
+	setMipmaps( mipmaps );
+
+	return true;
+}
+
+crimild::Bool ImageKTX::save( const Image *image, const std::string &path )
+{
+	crimild::UInt32 internalFormat = 0;
+	crimild::UInt32 baseFormat = 0;
+	if ( image == nullptr || !image->hasData() || !toGLInternalFormat( image, internalFormat, baseFormat ) ) {
+		Log::error( CRIMILD_CURRENT_CLASS_NAME, "Unsupported image format" );
+		return false;
+	}
+
+	const auto compressed = image->isCompressed();
+	const crimild::Size levels = image->getMipmapCount() + 1;
+
+	std::vector< crimild::Byte > file( KTX_IDENTIFIER, KTX_IDENTIFIER + sizeof( KTX_IDENTIFIER ) );
+	writeUInt32( file, KTX_ENDIANNESS );
+	writeUInt32( file, compressed ? 0 : KTX_GL_UNSIGNED_BYTE );
+	writeUInt32( file, 1 );
+	writeUInt32( file, compressed ? 0 : baseFormat );
+	writeUInt32( file, internalFormat );
+	writeUInt32( file, baseFormat );
+	writeUInt32( file, image->getWidth() );
+	writeUInt32( file, image->getHeight() );
+	writeUInt32( file, 0 );
+	writeUInt32( file, 0 );
+	writeUInt32( file, 1 );
+	writeUInt32( file, levels );
+	writeUInt32( file, 0 );
+
+	for ( crimild::Size level = 0; level < levels; level++ ) {
+		auto mipmap = image->getMipmap( level );
+		if ( compressed ) {
+			writeUInt32( file, mipmap->getDataSize() );
+			file.insert( file.end(), mipmap->getData(), mipmap->getData() + mipmap->getDataSize() );
+		}
+		else {
+			const crimild::Size w = mipmap->getWidth();
+			const crimild::Size h = mipmap->getHeight();
+			const crimild::Size bpp = mipmap->getBpp();
+			const auto pitch = computeRowPitch( w, bpp );
+			writeUInt32( file, pitch * h );
+			for ( crimild::Size y = 0; y < h; y++ ) {
+				auto row = mipmap->getData() + y * w * bpp;
+				file.insert( file.end(), row, row + w * bpp );
+				file.resize( file.size() + pitch - w * bpp, 0 );
+			}
+		}
+
+		// mip padding
+		while ( file.size() % 4 != 0 ) {
+			file.push_back( 0 );
+		}
+	}
+
+	auto out = std::fopen( path.c_str(), "wb" );
+	if ( out == nullptr ) {
+		Log::error( CRIMILD_CURRENT_CLASS_NAME, "Cannot open file ", path );
+		return false;
+	}
+
+	auto written = std::fwrite( &file[ 0 ], 1, file.size(), out );
+	std::fclose( out );
+
+	return written == file.size();
+}
+
+void ImageKTX::encode( coding::Encoder &encoder )
+{
+    Image::encode( encoder );
+}
+
+void ImageKTX::decode( coding::Decoder &decoder )
+{
+    Image::decode( decoder );
+
+    decoder.decode( "imageFileName", _filePath );
+    if ( _filePath.length() > 0 ) {
+        _filePath = FileSystem::getInstance().pathForResource( _filePath );
+        load();
+    }
+}
+
@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) 2013, Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef CRIMILD_RENDERING_IMAGE_KTX_
+#define CRIMILD_RENDERING_IMAGE_KTX_
+
+#include "Image.hpp"
+
+#include <string>
+
+namespace crimild {
+
+	/**
+		\brief Loads KTX (version 1) textures
+
+		Supports 2D textures with mipmaps, both in block-compressed formats
+		(BC1, BC3, BC7, ETC2) and uncompressed 8-bit RGB(A). Textures
+		are usually created offline using the texconv tool.
+	*/
+	class ImageKTX : public Image {
+		CRIMILD_IMPLEMENT_RTTI( crimild::ImageKTX )
+
+	public:
+		ImageKTX( void );
+		explicit ImageKTX( std::string filePath );
+		virtual ~ImageKTX( void );
+
+		virtual void load( void ) override;
+
+		/**
+			\brief Decodes a KTX file that is already in memory
+
+			\returns false if the data is not a valid or supported KTX file
+		*/
+		crimild::Bool loadFromMemory( const crimild::Byte *data, crimild::Size size );
+
+		/**
+			\brief Saves an image, including its mipmaps, as a KTX file
+
+			All compressed formats and 8-bit RGB(A) images are supported.
+		*/
+		static crimild::Bool save( const Image *image, const std::string &fileName );
+
+	private:
+		std::string _filePath;
+
+		/**
+            \name Coding support
+         */
+        //@{
+        
+    public:
+        virtual void encode( coding::Encoder &encoder ) override;
+        virtual void decode( coding::Decoder &decoder ) override;
+        
+        //@}        
+	};
+    
+    using ImageKTXPtr = SharedPointer< ImageKTX >;
+
+}
+
+#endif
+
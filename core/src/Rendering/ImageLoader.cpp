@@ -0,0 +1,132 @@
+/*
+ * Copyright (c) 2013, Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "ImageLoader.hpp"
+#include "ImageDDS.hpp"
+#include "ImageKTX.hpp"
+#include "ImagePNG.hpp"
+#include "ImageTGA.hpp"
+#include "Texture.hpp"
+
+#include "Concurrency/Async.hpp"
+#include "Foundation/Log.hpp"
+#include "Foundation/StringUtils.hpp"
+#include "Simulation/AssetManager.hpp"
+#include "Simulation/FileSystem.hpp"
+
+using namespace crimild;
+
+SharedPointer< Image > ImageLoader::decode( std::string const &fileName, const crimild::Byte *data, crimild::Size size, crimild::Bool generateMipmaps, ImageUtils::MipmapFilter filter )
+{
+	auto extension = StringUtils::toLower( StringUtils::getFileExtension( fileName ) );
+
+	SharedPointer< Image > image;
+	if ( extension == "png" ) {
+		auto png = crimild::alloc< ImagePNG >();
+		if ( png->loadFromMemory( data, size ) ) {
+			image = png;
+		}
+	}
+	else if ( extension == "tga" ) {
+		auto tga = crimild::alloc< ImageTGA >();
+		if ( tga->loadFromMemory( data, size ) ) {
+			image = tga;
+		}
+	}
+	else if ( extension == "ktx" ) {
+		auto ktx = crimild::alloc< ImageKTX >();
+		if ( ktx->loadFromMemory( data, size ) ) {
+			image = ktx;
+		}
+	}
+	else if ( extension == "dds" ) {
+		auto dds = crimild::alloc< ImageDDS >();
+		if ( dds->loadFromMemory( data, size ) ) {
+			image = dds;
+		}
+	}
+	else {
+		Log::error( CRIMILD_CURRENT_CLASS_NAME, "Unsupported image format for file ", fileName );
+		return nullptr;
+	}
+
+	if ( image == nullptr ) {
+		Log::error( CRIMILD_CURRENT_CLASS_NAME, "Cannot decode image ", fileName );
+		return nullptr;
+	}
+
+	if ( generateMipmaps && !image->hasMipmaps() && !image->isCompressed() ) {
+		ImageUtils::generateMipmaps( crimild::get_ptr( image ), filter );
+	}
+
+	return image;
+}
+
+SharedPointer< Image > ImageLoader::load( std::string const &path, crimild::Bool generateMipmaps, ImageUtils::MipmapFilter filter )
+{
+	containers::ByteArray data;
+	if ( !FileSystem::getInstance().readFile( path, data ) ) {
+		Log::error( CRIMILD_CURRENT_CLASS_NAME, "Cannot read file ", path );
+		return nullptr;
+	}
+
+	return decode( path, data.getData(), data.size(), generateMipmaps, filter );
+}
+
+std::vector< SharedPointer< Image >> ImageLoader::loadAll( std::vector< std::string > const &paths, crimild::Bool generateMipmaps, ImageUtils::MipmapFilter filter )
+{
+	std::vector< SharedPointer< Image >> images( paths.size() );
+
+	// each job writes to its own slot, so no synchronization is required
+	concurrency::parallel_for( paths.size(), [ &paths, &images, generateMipmaps, filter ]( crimild::Size i ) {
+		images[ i ] = load( paths[ i ], generateMipmaps, filter );
+	});
+
+	return images;
+}
+
+void ImageLoader::registerAssetLoaders( AssetManager *assetManager )
+{
+	auto loader = []( std::string const &name, containers::ByteArray const &data ) -> SharedPointer< SharedObject > {
+		auto image = decode( name, data.getData(), data.size(), true );
+		if ( image == nullptr ) {
+			return nullptr;
+		}
+
+		auto texture = crimild::alloc< Texture >( image );
+		if ( image->hasMipmaps() ) {
+			texture->setMinFilter( Texture::Filter::LINEAR_MIPMAP_LINEAR );
+		}
+		return texture;
+	};
+
+	assetManager->registerLoader( "tga", loader );
+	assetManager->registerLoader( "png", loader );
+	assetManager->registerLoader( "ktx", loader );
+	assetManager->registerLoader( "dds", loader );
+}
+
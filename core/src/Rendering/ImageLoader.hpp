@@ -0,0 +1,89 @@
+/*
+ * Copyright (c) 2013, Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef CRIMILD_RENDERING_IMAGE_LOADER_
+#define CRIMILD_RENDERING_IMAGE_LOADER_
+
+#include "ImageUtils.hpp"
+
+#include "Foundation/SharedObject.hpp"
+#include "Foundation/Containers/Array.hpp"
+
+#include <string>
+#include <vector>
+
+namespace crimild {
+
+	class Image;
+	class AssetManager;
+
+	/**
+		\brief Decodes image files and prepares them for rendering
+
+		The file format is selected based on the file extension. TGA, PNG,
+		KTX and DDS files are supported. Decoding is thread-safe, so these
+		functions can be safely called from worker threads.
+
+		Mipmaps are only generated for uncompressed images that don't
+		have them already.
+	*/
+	class ImageLoader {
+	public:
+		/**
+			\brief Decodes an image already in memory
+
+			\returns nullptr if the format is not supported or the data is invalid
+		*/
+		static SharedPointer< Image > decode( std::string const &fileName, const crimild::Byte *data, crimild::Size size, crimild::Bool generateMipmaps = true, ImageUtils::MipmapFilter filter = ImageUtils::MipmapFilter::KAISER );
+
+		/**
+			\brief Reads and decodes an image file
+
+			The path is used as is. Use FileSystem::pathForResource() for
+			resource names.
+		*/
+		static SharedPointer< Image > load( std::string const &path, crimild::Bool generateMipmaps = true, ImageUtils::MipmapFilter filter = ImageUtils::MipmapFilter::KAISER );
+
+		/**
+			\brief Reads and decodes several images in parallel
+
+			The result has the same order as the input. Failed images are nullptr
+		*/
+		static std::vector< SharedPointer< Image >> loadAll( std::vector< std::string > const &paths, crimild::Bool generateMipmaps = true, ImageUtils::MipmapFilter filter = ImageUtils::MipmapFilter::KAISER );
+
+		/**
+			\brief Registers texture loaders for all supported image formats
+
+			Textures created by these loaders include the full mipmap chain
+		*/
+		static void registerAssetLoaders( AssetManager *assetManager );
+	};
+
+}
+
+#endif
+
@@ -0,0 +1,947 @@
+/*
+ * Copyright (c) 2013, Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "ImagePNG.hpp"
+#include "Coding/Encoder.hpp"
+#include "Coding/Decoder.hpp"
+#include "Foundation/Log.hpp"
+#include "Simulation/FileSystem.hpp"
+#include "Exceptions/FileNotFoundException.hpp"
+#include "Exceptions/InvalidFileFormatException.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+using namespace crimild;
+
+
+static const Byte PNG_SIGNATURE[] = { 137, 80, 78, 71, 13, 10, 26, 10 };
+
+// PNG allows up to 2^31 - 1 pixels per side, but anything bigger than
+// this is most likely a malformed file and cannot be used as a texture
+static const UInt32 PNG_MAX_DIMENSION = 16384;
+
+enum PNGColorType {
+	PNG_COLOR_GRAYSCALE = 0,
+	PNG_COLOR_RGB = 2,
+	PNG_COLOR_PALETTE = 3,
+	PNG_COLOR_GRAYSCALE_ALPHA = 4,
+	PNG_COLOR_RGBA = 6,
+};
+
+static const UInt16 LENGTH_BASE[] = { 3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+static const UInt8 LENGTH_EXTRA[] = { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+static const UInt16 DIST_BASE[] = { 1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577 };
+static const UInt8 DIST_EXTRA[] = { 0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+static const UInt8 CODE_LENGTH_ORDER[] = { 16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15 };
+
+static UInt32 readUInt32( const Byte *p )
+{
+	return ( UInt32( p[ 0 ] ) << 24 ) | ( UInt32( p[ 1 ] ) << 16 ) | ( UInt32( p[ 2 ] ) << 8 ) | UInt32( p[ 3 ] );
+}
+
+static void writeUInt32( std::vector< Byte > &out, UInt32 value )
+{
+	out.push_back( ( value >> 24 ) & 0xFF );
+	out.push_back( ( value >> 16 ) & 0xFF );
+	out.push_back( ( value >> 8 ) & 0xFF );
+	out.push_back( value & 0xFF );
+}
+
+static UInt32 crc32( const Byte *data, Size size, UInt32 crc = 0 )
+{
+	static UInt32 table[ 256 ];
+	static bool initialized = [] {
+		for ( UInt32 n = 0; n < 256; n++ ) {
+			auto c = n;
+			for ( int k = 0; k < 8; k++ ) {
+				c = ( c & 1 ) ? 0xEDB88320u ^ ( c >> 1 ) : c >> 1;
+			}
+			table[ n ] = c;
+		}
+		return true;
+	}();
+	( void ) initialized;
+
+	crc = ~crc;
+	for ( Size i = 0; i < size; i++ ) {
+		crc = table[ ( crc ^ data[ i ] ) & 0xFF ] ^ ( crc >> 8 );
+	}
+	return ~crc;
+}
+
+static UInt32 adler32( const Byte *data, Size size )
+{
+	UInt32 a = 1;
+	UInt32 b = 0;
+	while ( size > 0 ) {
+		// largest block that cannot overflow before the modulo
+		auto n = size < 5552 ? size : 5552;
+		size -= n;
+		while ( n-- > 0 ) {
+			a += *data++;
+			b += a;
+		}
+		a %= 65521;
+		b %= 65521;
+	}
+	return ( b << 16 ) | a;
+}
+
+/**
+	\brief Reads bits in the order used by deflate (LSB first)
+
+	Reading past the end of the input yields zeros. Callers must check
+	for overruns once they are done
+*/
+class BitReader {
+public:
+	BitReader( const Byte *data, Size size )
+		: _data( data ),
+		  _size( size )
+	{
+
+	}
+
+	inline UInt32 peek( UInt32 count )
+	{
+		if ( _count < count ) {
+			refill();
+		}
+		return static_cast< UInt32 >( _buffer & ( ( UInt64( 1 ) << count ) - 1 ) );
+	}
+
+	inline void consume( UInt32 count )
+	{
+		_buffer >>= count;
+		_count -= count;
+	}
+
+	inline UInt32 read( UInt32 count )
+	{
+		auto value = peek( count );
+		consume( count );
+		return value;
+	}
+
+	void alignToByte( void )
+	{
+		consume( _count % 8 );
+	}
+
+	Bool overrun( void ) const
+	{
+		return ( _pos * 8 - _count ) > ( _size * 8 );
+	}
+
+private:
+	void refill( void )
+	{
+		while ( _count <= 56 ) {
+			UInt64 b = _pos < _size ? _data[ _pos ] : 0;
+			_buffer |= b << _count;
+			_count += 8;
+			++_pos;
+		}
+	}
+
+private:
+	const Byte *_data;
+	Size _size;
+	Size _pos = 0;
+	UInt64 _buffer = 0;
+	UInt32 _count = 0;
+};
+
+/**
+	\brief Canonical Huffman decoder
+
+	Codes up to FAST_BITS long are decoded with a single table lookup.
+	Longer codes are decoded one bit at a time.
+*/
+class Huffman {
+public:
+	static constexpr UInt32 FAST_BITS = 10;
+	static constexpr UInt32 MAX_BITS = 15;
+
+	Bool build( const UInt8 *lengths, Size count )
+	{
+		std::memset( _counts, 0, sizeof( _counts ) );
+		for ( Size i = 0; i < count; i++ ) {
+			_counts[ lengths[ i ] ]++;
+		}
+		_counts[ 0 ] = 0;
+
+		// reject over-subscribed sets. Incomplete ones are valid
+		Int32 left = 1;
+		for ( UInt32 len = 1; len <= MAX_BITS; len++ ) {
+			left <<= 1;
+			left -= _counts[ len ];
+			if ( left < 0 ) {
+				return false;
+			}
+		}
+
+		UInt16 offsets[ MAX_BITS + 1 ];
+		offsets[ 1 ] = 0;
+		for ( UInt32 len = 1; len < MAX_BITS; len++ ) {
+			offsets[ len + 1 ] = offsets[ len ] + _counts[ len ];
+		}
+
+		_symbols.resize( count );
+		for ( Size i = 0; i < count; i++ ) {
+			if ( lengths[ i ] != 0 ) {
+				_symbols[ offsets[ lengths[ i ] ]++ ] = static_cast< UInt16 >( i );
+			}
+		}
+
+		// fill the lookup table using bit-reversed codes, since
+		// codes are packed starting from their most significant bit
+		std::memset( _fast, 0, sizeof( _fast ) );
+		UInt32 code = 0;
+		Size index = 0;
+		for ( UInt32 len = 1; len <= FAST_BITS; len++ ) {
+			for ( UInt32 i = 0; i < _counts[ len ]; i++ ) {
+				UInt32 reversed = 0;
+				for ( UInt32 b = 0; b < len; b++ ) {
+					reversed |= ( ( code >> b ) & 1 ) << ( len - 1 - b );
+				}
+				auto entry = static_cast< UInt16 >( ( len << 12 ) | _symbols[ index ] );
+				for ( auto fill = reversed; fill < ( 1u << FAST_BITS ); fill += ( 1u << len ) ) {
+					_fast[ fill ] = entry;
+				}
+				++code;
+				++index;
+			}
+			code <<= 1;
+		}
+
+		return true;
+	}
+
+	inline Int32 decode( BitReader &bits ) const
+	{
+		auto entry = _fast[ bits.peek( FAST_BITS ) ];
+		if ( entry != 0 ) {
+			bits.consume( entry >> 12 );
+			return entry & 0x0FFF;
+		}
+
+		Int32 code = 0;
+		Int32 first = 0;
+		Int32 index = 0;
+		for ( UInt32 len = 1; len <= MAX_BITS; len++ ) {
+			code |= bits.read( 1 );
+			Int32 count = _counts[ len ];
+			if ( code - count < first ) {
+				return _symbols[ index + ( code - first ) ];
+			}
+			index += count;
+			first += count;
+			first <<= 1;
+			code <<= 1;
+		}
+
+		return -1;
+	}
+
+private:
+	UInt16 _counts[ MAX_BITS + 1 ];
+	std::vector< UInt16 > _symbols;
+	UInt16 _fast[ 1 << FAST_BITS ];
+};
+
+static Bool inflateBlock( BitReader &bits, Huffman const &lengths, Huffman const &distances, Byte *out, Size outSize, Size &pos )
+{
+	while ( true ) {
+		auto symbol = lengths.decode( bits );
+		if ( symbol < 0 ) {
+			return false;
+		}
+
+		if ( symbol < 256 ) {
+			if ( pos >= outSize ) {
+				return false;
+			}
+			out[ pos++ ] = static_cast< Byte >( symbol );
+		}
+		else if ( symbol == 256 ) {
+			return true;
+		}
+		else {
+			symbol -= 257;
+			if ( symbol >= 29 ) {
+				return false;
+			}
+			Size length = LENGTH_BASE[ symbol ] + bits.read( LENGTH_EXTRA[ symbol ] );
+
+			auto d = distances.decode( bits );
+			if ( d < 0 || d >= 30 ) {
+				return false;
+			}
+			Size distance = DIST_BASE[ d ] + bits.read( DIST_EXTRA[ d ] );
+
+			if ( distance > pos || length > outSize - pos ) {
+				return false;
+			}
+
+			auto dst = out + pos;
+			auto src = dst - distance;
+			if ( distance >= length ) {
+				std::memcpy( dst, src, length );
+			}
+			else {
+				// overlapping copy repeats the last bytes
+				for ( Size i = 0; i < length; i++ ) {
+					dst[ i ] = src[ i ];
+				}
+			}
+			pos += length;
+		}
+	}
+}
+
+/**
+	\brief Decompresses a zlib stream into a buffer of known size
+*/
+static Bool inflate( const Byte *data, Size size, Byte *out, Size outSize )
+{
+	if ( size < 2 || ( data[ 0 ] & 0x0F ) != 8 || ( ( data[ 0 ] << 8 ) | data[ 1 ] ) % 31 != 0 || ( data[ 1 ] & 0x20 ) != 0 ) {
+		// not deflate or requires a preset dictionary
+		return false;
+	}
+
+	BitReader bits( data + 2, size - 2 );
+	Size pos = 0;
+
+	Huffman fixedLengths;
+	Huffman fixedDistances;
+	Bool fixedReady = false;
+
+	UInt32 last = 0;
+	while ( !last ) {
+		last = bits.read( 1 );
+		auto type = bits.read( 2 );
+
+		if ( type == 0 ) {
+			bits.alignToByte();
+			auto len = bits.read( 16 );
+			auto nlen = bits.read( 16 );
+			if ( ( len ^ 0xFFFF ) != nlen || len > outSize - pos ) {
+				return false;
+			}
+			for ( UInt32 i = 0; i < len; i++ ) {
+				out[ pos++ ] = static_cast< Byte >( bits.read( 8 ) );
+			}
+		}
+		else if ( type == 1 ) {
+			if ( !fixedReady ) {
+				UInt8 lengths[ 288 ];
+				for ( int i = 0; i < 144; i++ ) lengths[ i ] = 8;
+				for ( int i = 144; i < 256; i++ ) lengths[ i ] = 9;
+				for ( int i = 256; i < 280; i++ ) lengths[ i ] = 7;
+				for ( int i = 280; i < 288; i++ ) lengths[ i ] = 8;
+				fixedLengths.build( lengths, 288 );
+
+				UInt8 dists[ 30 ];
+				for ( int i = 0; i < 30; i++ ) dists[ i ] = 5;
+				fixedDistances.build( dists, 30 );
+
+				fixedReady = true;
+			}
+
+			if ( !inflateBlock( bits, fixedLengths, fixedDistances, out, outSize, pos ) ) {
+				return false;
+			}
+		}
+		else if ( type == 2 ) {
+			auto hlit = bits.read( 5 ) + 257;
+			auto hdist = bits.read( 5 ) + 1;
+			auto hclen = bits.read( 4 ) + 4;
+			if ( hlit > 286 || hdist > 30 ) {
+				return false;
+			}
+
+			UInt8 codeLengths[ 19 ] = { 0 };
+			for ( UInt32 i = 0; i < hclen; i++ ) {
+				codeLengths[ CODE_LENGTH_ORDER[ i ] ] = static_cast< UInt8 >( bits.read( 3 ) );
+			}
+
+			Huffman codeLengthsHuffman;
+			if ( !codeLengthsHuffman.build( codeLengths, 19 ) ) {
+				return false;
+			}
+
+			UInt8 lengths[ 286 + 30 ] = { 0 };
+			UInt32 n = 0;
+			while ( n < hlit + hdist ) {
+				auto symbol = codeLengthsHuffman.decode( bits );
+				if ( symbol < 0 ) {
+					return false;
+				}
+
+				if ( symbol < 16 ) {
+					lengths[ n++ ] = static_cast< UInt8 >( symbol );
+					continue;
+				}
+
+				UInt8 value = 0;
+				UInt32 repeat = 0;
+				if ( symbol == 16 ) {
+					if ( n == 0 ) {
+						return false;
+					}
+					value = lengths[ n - 1 ];
+					repeat = 3 + bits.read( 2 );
+				}
+				else if ( symbol == 17 ) {
+					repeat = 3 + bits.read( 3 );
+				}
+				else {
+					repeat = 11 + bits.read( 7 );
+				}
+
+				if ( n + repeat > hlit + hdist ) {
+					return false;
+				}
+				while ( repeat-- > 0 ) {
+					lengths[ n++ ] = value;
+				}
+			}
+
+			Huffman dynamicLengths;
+			Huffman dynamicDistances;
+			if ( !dynamicLengths.build( lengths, hlit ) || !dynamicDistances.build( lengths + hlit, hdist ) ) {
+				return false;
+			}
+
+			if ( !inflateBlock( bits, dynamicLengths, dynamicDistances, out, outSize, pos ) ) {
+				return false;
+			}
+		}
+		else {
+			return false;
+		}
+
+		if ( bits.overrun() ) {
+			return false;
+		}
+	}
+
+	return pos == outSize;
+}
+
+/**
+	\brief Writes bits in the order used by deflate (LSB first)
+*/
+class BitWriter {
+public:
+	explicit BitWriter( std::vector< Byte > &out ) : _out( out ) { }
+
+	inline void write( UInt32 value, UInt32 count )
+	{
+		_buffer |= UInt64( value ) << _count;
+		_count += count;
+		while ( _count >= 8 ) {
+			_out.push_back( static_cast< Byte >( _buffer & 0xFF ) );
+			_buffer >>= 8;
+			_count -= 8;
+		}
+	}
+
+	/**
+		\brief Writes a Huffman code, starting from its most significant bit
+	*/
+	inline void writeCode( UInt32 code, UInt32 length )
+	{
+		UInt32 reversed = 0;
+		for ( UInt32 b = 0; b < length; b++ ) {
+			reversed |= ( ( code >> b ) & 1 ) << ( length - 1 - b );
+		}
+		write( reversed, length );
+	}
+
+	void flush( void )
+	{
+		if ( _count > 0 ) {
+			write( 0, 8 - _count );
+		}
+	}
+
+private:
+	std::vector< Byte > &_out;
+	UInt64 _buffer = 0;
+	UInt32 _count = 0;
+};
+
+static void writeFixedLiteral( BitWriter &bits, UInt32 symbol )
+{
+	if ( symbol < 144 ) {
+		bits.writeCode( 0x30 + symbol, 8 );
+	}
+	else if ( symbol < 256 ) {
+		bits.writeCode( 0x190 + symbol - 144, 9 );
+	}
+	else if ( symbol < 280 ) {
+		bits.writeCode( symbol - 256, 7 );
+	}
+	else {
+		bits.writeCode( 0xC0 + symbol - 280, 8 );
+	}
+}
+
+/**
+	\brief Compresses data into a zlib stream
+
+	Uses a single block with fixed Huffman codes and greedy LZ77 matching.
+	It does not compress as well as zlib, but it's simple and fast.
+*/
+static void deflate( const Byte *data, Size size, std::vector< Byte > &out )
+{
+	static constexpr UInt32 HASH_BITS = 15;
+	static constexpr Size WINDOW_SIZE = 32768;
+	static constexpr Size MAX_MATCH = 258;
+
+	out.push_back( 0x78 );
+	out.push_back( 0x01 );
+
+	BitWriter bits( out );
+	bits.write( 1, 1 );	// final block
+	bits.write( 1, 2 );	// fixed codes
+
+	std::vector< Int64 > head( 1 << HASH_BITS, -1 );
+
+	Size i = 0;
+	while ( i < size ) {
+		Size bestLength = 0;
+		Size bestDistance = 0;
+
+		if ( i + 3 <= size ) {
+			auto hash = ( ( data[ i ] << 10 ) ^ ( data[ i + 1 ] << 5 ) ^ data[ i + 2 ] ) & ( ( 1 << HASH_BITS ) - 1 );
+			auto candidate = head[ hash ];
+			head[ hash ] = i;
+
+			if ( candidate >= 0 && i - candidate <= WINDOW_SIZE ) {
+				auto maxLength = size - i < MAX_MATCH ? size - i : MAX_MATCH;
+				Size length = 0;
+				while ( length < maxLength && data[ candidate + length ] == data[ i + length ] ) {
+					++length;
+				}
+				if ( length >= 3 ) {
+					bestLength = length;
+					bestDistance = i - candidate;
+				}
+			}
+		}
+
+		if ( bestLength == 0 ) {
+			writeFixedLiteral( bits, data[ i ] );
+			++i;
+			continue;
+		}
+
+		UInt32 l = 28;
+		while ( LENGTH_BASE[ l ] > bestLength ) {
+			--l;
+		}
+		writeFixedLiteral( bits, 257 + l );
+		bits.write( bestLength - LENGTH_BASE[ l ], LENGTH_EXTRA[ l ] );
+
+		UInt32 d = 29;
+		while ( DIST_BASE[ d ] > bestDistance ) {
+			--d;
+		}
+		bits.writeCode( d, 5 );
+		bits.write( bestDistance - DIST_BASE[ d ], DIST_EXTRA[ d ] );
+
+		i += bestLength;
+	}
+
+	writeFixedLiteral( bits, 256 );
+	bits.flush();
+
+	auto adler = adler32( data, size );
+	writeUInt32( out, adler );
+}
+
+static inline Byte paeth( Int32 a, Int32 b, Int32 c )
+{
+	auto p = a + b - c;
+	auto pa = p > a ? p - a : a - p;
+	auto pb = p > b ? p - b : b - p;
+	auto pc = p > c ? p - c : c - p;
+	if ( pa <= pb && pa <= pc ) {
+		return static_cast< Byte >( a );
+	}
+	return static_cast< Byte >( pb <= pc ? b : c );
+}
+
+/**
+	\brief Reverts scanline filters in place
+
+	Each scanline starts with the filter type, followed by 'stride' bytes
+*/
+static Bool unfilter( Byte *data, Size stride, Size height, Size bpp )
+{
+	Byte *prev = nullptr;
+	for ( Size y = 0; y < height; y++ ) {
+		auto filter = data[ y * ( stride + 1 ) ];
+		auto line = data + y * ( stride + 1 ) + 1;
+
+		switch ( filter ) {
+			case 0:
+				break;
+
+			case 1:
+				for ( Size i = bpp; i < stride; i++ ) {
+					line[ i ] += line[ i - bpp ];
+				}
+				break;
+
+			case 2:
+				if ( prev != nullptr ) {
+					for ( Size i = 0; i < stride; i++ ) {
+						line[ i ] += prev[ i ];
+					}
+				}
+				break;
+
+			case 3:
+				for ( Size i = 0; i < stride; i++ ) {
+					UInt32 left = i >= bpp ? line[ i - bpp ] : 0;
+					UInt32 up = prev != nullptr ? prev[ i ] : 0;
+					line[ i ] += static_cast< Byte >( ( left + up ) >> 1 );
+				}
+				break;
+
+			case 4:
+				for ( Size i = 0; i < stride; i++ ) {
+					Int32 left = i >= bpp ? line[ i - bpp ] : 0;
+					Int32 up = prev != nullptr ? prev[ i ] : 0;
+					Int32 upLeft = ( prev != nullptr && i >= bpp ) ? prev[ i - bpp ] : 0;
+					line[ i ] += paeth( left, up, upLeft );
+				}
+				break;
+
+			default:
+				return false;
+		}
+
+		prev = line;
+	}
+
+	return true;
+}
+
+
+
+ImagePNG::ImagePNG( void )
+{
+
+}
+
+ImagePNG::ImagePNG( std::string filePath )
+	: _filePath( filePath )
+{
+	load();
+}
+
+ImagePNG::~ImagePNG( void )
+{
+
+}
+
+void ImagePNG::load( void )
+{
+	containers::ByteArray data;
+	if ( !FileSystem::getInstance().readFile( _filePath, data ) ) {
+		throw FileNotFoundException( _filePath );
+	}
+
+	if ( !loadFromMemory( data.getData(), data.size() ) ) {
+		throw InvalidFileFormatException( _filePath );
+	}
+}
+
+crimild::Bool ImagePNG::loadFromMemory( const crimild::Byte *data, crimild::Size size )
+{
+	if ( size < 8 || std::memcmp( data, PNG_SIGNATURE, 8 ) != 0 ) {
+		return false;
+	}
+
+	crimild::UInt32 width = 0;
+	crimild::UInt32 height = 0;
+	crimild::UInt32 bitDepth = 0;
+	crimild::UInt32 colorType = 0;
+	crimild::UInt32 interlace = 0;
+	std::vector< crimild::Byte > palette;
+	std::vector< crimild::Byte > transparency;
+	std::vector< crimild::Byte > compressed;
+
+	crimild::Size offset = 8;
+	crimild::Bool done = false;
+	while ( !done && offset + 12 <= size ) {
+		auto length = readUInt32( data + offset );
+		auto type = data + offset + 4;
+		auto chunk = data + offset + 8;
+		if ( length > size - offset - 12 ) {
+			return false;
+		}
+
+		if ( std::memcmp( type, "IHDR", 4 ) == 0 ) {
+			if ( length < 13 ) {
+				return false;
+			}
+			width = readUInt32( chunk );
+			height = readUInt32( chunk + 4 );
+			bitDepth = chunk[ 8 ];
+			colorType = chunk[ 9 ];
+			interlace = chunk[ 12 ];
+		}
+		else if ( std::memcmp( type, "PLTE", 4 ) == 0 ) {
+			palette.assign( chunk, chunk + length );
+		}
+		else if ( std::memcmp( type, "tRNS", 4 ) == 0 ) {
+			transparency.assign( chunk, chunk + length );
+		}
+		else if ( std::memcmp( type, "IDAT", 4 ) == 0 ) {
+			compressed.insert( compressed.end(), chunk, chunk + length );
+		}
+		else if ( std::memcmp( type, "IEND", 4 ) == 0 ) {
+			done = true;
+		}
+
+		offset += length + 12;
+	}
+
+	if ( width == 0 || height == 0 || compressed.empty() ) {
+		return false;
+	}
+
+	if ( width > PNG_MAX_DIMENSION || height > PNG_MAX_DIMENSION ) {
+		Log::error( CRIMILD_CURRENT_CLASS_NAME, "Invalid PNG image size ", width, "x", height );
+		return false;
+	}
+
+	if ( interlace != 0 ) {
+		Log::error( CRIMILD_CURRENT_CLASS_NAME, "Interlaced PNG images are not supported" );
+		return false;
+	}
+
+	crimild::Size channels = 0;
+	switch ( colorType ) {
+		case PNG_COLOR_GRAYSCALE: channels = 1; break;
+		case PNG_COLOR_RGB: channels = 3; break;
+		case PNG_COLOR_PALETTE: channels = 1; break;
+		case PNG_COLOR_GRAYSCALE_ALPHA: channels = 2; break;
+		case PNG_COLOR_RGBA: channels = 4; break;
+		default: return false;
+	}
+
+	if ( bitDepth != 1 && bitDepth != 2 && bitDepth != 4 && bitDepth != 8 && bitDepth != 16 ) {
+		return false;
+	}
+	if ( bitDepth < 8 && colorType != PNG_COLOR_GRAYSCALE && colorType != PNG_COLOR_PALETTE ) {
+		return false;
+	}
+	if ( colorType == PNG_COLOR_PALETTE && ( palette.empty() || bitDepth == 16 ) ) {
+		return false;
+	}
+
+	// sizes are computed using 64-bit values, so they cannot overflow 
+	// for valid dimensions
+	const crimild::UInt64 bitsPerPixel = channels * bitDepth;
+	const crimild::UInt64 stride = ( crimild::UInt64( width ) * bitsPerPixel + 7 ) / 8;
+	const crimild::UInt64 filterBpp = bitsPerPixel >= 8 ? bitsPerPixel / 8 : 1;
+
+	std::vector< crimild::Byte > raw( ( stride + 1 ) * crimild::UInt64( height ) );
+	if ( !inflate( &compressed[ 0 ], compressed.size(), &raw[ 0 ], raw.size() ) ) {
+		return false;
+	}
+
+	if ( !unfilter( &raw[ 0 ], stride, height, filterBpp ) ) {
+		return false;
+	}
+
+	// Convert to 8-bit RGB(A)
+	auto hasAlpha = colorType == PNG_COLOR_RGBA || colorType == PNG_COLOR_GRAYSCALE_ALPHA || ( colorType == PNG_COLOR_PALETTE && !transparency.empty() );
+	crimild::Size bpp = hasAlpha ? 4 : 3;
+
+	Image::setData( width, height, bpp, nullptr, hasAlpha ? PixelFormat::RGBA : PixelFormat::RGB );
+	auto pixels = getData();
+
+	for ( crimild::Size y = 0; y < height; y++ ) {
+		auto line = &raw[ y * ( stride + 1 ) + 1 ];
+		auto out = pixels + y * width * bpp;
+
+		if ( bitDepth == 8 && ( colorType == PNG_COLOR_RGB || colorType == PNG_COLOR_RGBA ) ) {
+			std::memcpy( out, line, width * bpp );
+			continue;
+		}
+
+		for ( crimild::Size x = 0; x < width; x++ ) {
+			crimild::Byte c[ 4 ] = { 0, 0, 0, 255 };
+			if ( bitDepth < 8 ) {
+				auto bit = x * bitDepth;
+				auto value = ( line[ bit / 8 ] >> ( 8 - bitDepth - ( bit % 8 ) ) ) & ( ( 1 << bitDepth ) - 1 );
+				if ( colorType == PNG_COLOR_PALETTE ) {
+					c[ 0 ] = static_cast< crimild::Byte >( value );
+				}
+				else {
+					c[ 0 ] = static_cast< crimild::Byte >( value * 255 / ( ( 1 << bitDepth ) - 1 ) );
+				}
+			}
+			else {
+				// keep the most significant byte for 16-bit channels
+				auto step = bitDepth / 8;
+				for ( crimild::Size i = 0; i < channels; i++ ) {
+					c[ i ] = line[ ( x * channels + i ) * step ];
+				}
+			}
+
+			switch ( colorType ) {
+				case PNG_COLOR_GRAYSCALE:
+					out[ 0 ] = out[ 1 ] = out[ 2 ] = c[ 0 ];
+					break;
+
+				case PNG_COLOR_GRAYSCALE_ALPHA:
+					out[ 0 ] = out[ 1 ] = out[ 2 ] = c[ 0 ];
+					out[ 3 ] = c[ 1 ];
+					break;
+
+				case PNG_COLOR_PALETTE: {
+					crimild::Size index = c[ 0 ];
+					if ( 3 * index + 2 < palette.size() ) {
+						out[ 0 ] = palette[ 3 * index + 0 ];
+						out[ 1 ] = palette[ 3 * index + 1 ];
+						out[ 2 ] = palette[ 3 * index + 2 ];
+					}
+					if ( hasAlpha ) {
+						out[ 3 ] = index < transparency.size() ? transparency[ index ] : 255;
+					}
+					break;
+				}
+
+				default:
+					for ( crimild::Size i = 0; i < bpp; i++ ) {
+						out[ i ] = c[ i ];
+					}
+					break;
+			}
+
+			out += bpp;
+		}
+	}
+
+	return true;
+}
+
+crimild::Bool ImagePNG::saveToFile( const std::string &path ) const
+{
+	crimild::UInt32 colorType = 0;
+	switch ( getBpp() ) {
+		case 1: colorType = PNG_COLOR_GRAYSCALE; break;
+		case 3: colorType = PNG_COLOR_RGB; break;
+		case 4: colorType = PNG_COLOR_RGBA; break;
+		default:
+			Log::error( CRIMILD_CURRENT_CLASS_NAME, "Unsupported image format" );
+			return false;
+	}
+
+	const crimild::Size width = getWidth();
+	const crimild::Size height = getHeight();
+	const crimild::Size bpp = getBpp();
+	const crimild::Size stride = width * bpp;
+
+	// Use the Sub filter for all lines, which works well enough for
+	// natural images and gradients
+	std::vector< crimild::Byte > filtered( ( stride + 1 ) * height );
+	auto pixels = getData();
+	for ( crimild::Size y = 0; y < height; y++ ) {
+		auto line = pixels + y * stride;
+		auto out = &filtered[ y * ( stride + 1 ) ];
+		out[ 0 ] = 1;
+		for ( crimild::Size i = 0; i < stride; i++ ) {
+			out[ i + 1 ] = static_cast< crimild::Byte >( line[ i ] - ( i >= bpp ? line[ i - bpp ] : 0 ) );
+		}
+	}
+
+	std::vector< crimild::Byte > file( PNG_SIGNATURE, PNG_SIGNATURE + 8 );
+
+	auto writeChunk = [ &file ]( const char *type, std::vector< crimild::Byte > const &chunk ) {
+		writeUInt32( file, chunk.size() );
+		auto start = file.size();
+		file.insert( file.end(), type, type + 4 );
+		file.insert( file.end(), chunk.begin(), chunk.end() );
+		writeUInt32( file, crc32( &file[ start ], file.size() - start ) );
+	};
+
+	std::vector< crimild::Byte > header;
+	writeUInt32( header, width );
+	writeUInt32( header, height );
+	header.push_back( 8 );
+	header.push_back( static_cast< crimild::Byte >( colorType ) );
+	header.push_back( 0 );
+	header.push_back( 0 );
+	header.push_back( 0 );
+	writeChunk( "IHDR", header );
+
+	std::vector< crimild::Byte > compressed;
+	deflate( &filtered[ 0 ], filtered.size(), compressed );
+	writeChunk( "IDAT", compressed );
+
+	writeChunk( "IEND", std::vector< crimild::Byte >() );
+
+	auto out = std::fopen( path.c_str(), "wb" );
+	if ( out == nullptr ) {
+		Log::error( CRIMILD_CURRENT_CLASS_NAME, "Cannot open file ", path );
+		return false;
+	}
+
+	auto written = std::fwrite( &file[ 0 ], 1, file.size(), out );
+	std::fclose( out );
+
+	return written == file.size();
+}
+
+void ImagePNG::encode( coding::Encoder &encoder )
+{
+    Image::encode( encoder );
+}
+
+void ImagePNG::decode( coding::Decoder &decoder )
+{
+    Image::decode( decoder );
+
+    decoder.decode( "imageFileName", _filePath );
+    if ( _filePath.length() > 0 ) {
+        _filePath = FileSystem::getInstance().pathForResource( _filePath );
+        load();
+    }
+}
+
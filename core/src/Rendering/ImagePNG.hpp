@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) 2013, Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef CRIMILD_RENDERING_IMAGE_PNG_
+#define CRIMILD_RENDERING_IMAGE_PNG_
+
+#include "Image.hpp"
+
+#include <string>
+
+namespace crimild {
+
+	/**
+		\brief Loads PNG images
+
+		Supports all non-interlaced color types. Grayscale images are 
+		expanded to RGB(A) and 16-bit channels are reduced to 8 bits.
+	*/
+	class ImagePNG : public Image {
+		CRIMILD_IMPLEMENT_RTTI( crimild::ImagePNG )
+
+	public:
+		ImagePNG( void );
+		explicit ImagePNG( std::string filePath );
+		virtual ~ImagePNG( void );
+
+		virtual void load( void ) override;
+
+		/**
+			\brief Decodes a PNG file that is already in memory
+
+			\returns false if the data is not a valid or supported PNG file
+		*/
+		crimild::Bool loadFromMemory( const crimild::Byte *data, crimild::Size size );
+
+		/**
+			\brief Saves the image as a PNG file
+
+			Only 8-bit grayscale, RGB and RGBA images are supported.
+		*/
+		crimild::Bool saveToFile( const std::string &fileName ) const;
+
+	private:
+		std::string _filePath;
+
+		/**
+            \name Coding support
+         */
+        //@{
+        
+    public:
+        virtual void encode( coding::Encoder &encoder ) override;
+        virtual void decode( coding::Decoder &decoder ) override;
+        
+        //@}        
+	};
+    
+    using ImagePNGPtr = SharedPointer< ImagePNG >;
+
+}
+
+#endif
+
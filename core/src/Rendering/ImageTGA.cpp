@@ -26,12 +26,14 @@
  */
 
 #include "ImageTGA.hpp"
+#include "ImageUtils.hpp"
 #include "Coding/Encoder.hpp"
 #include "Coding/Decoder.hpp"
 #include "Simulation/FileSystem.hpp"
 #include "Exceptions/FileNotFoundException.hpp"
 #include "Exceptions/InvalidFileFormatException.hpp"
 
+#include <cstring>
 #include <vector>
 
 #define TGA_RGB 2
@@ -58,122 +60,98 @@ ImageTGA::~ImageTGA( void )
 
 void ImageTGA::load( void )
 {
-	int width = 0;
-	int height = 0;
-	int bpp = 0;
-	unsigned char length = 0;
-    unsigned char imageType = 0;
-    unsigned char bits = 0;
-    FILE *file = NULL;
-    int stride = 0;
-    std::vector< unsigned char > data;
-
-    if ( ( file = fopen( _filePath.c_str(), "rb" ) ) == NULL ) {
-    	throw FileNotFoundException( _filePath );
+    containers::ByteArray data;
+    if ( !FileSystem::getInstance().readFile( _filePath, data ) ) {
+        throw FileNotFoundException( _filePath );
     }
 
-    fread( &length, sizeof( unsigned char ), 1, file );
-
-    fseek( file, 1, SEEK_CUR );
-
-    fread( &imageType, sizeof( unsigned char ), 1, file );
-
-    fseek( file, 9, SEEK_CUR );
+    if ( !loadFromMemory( data.getData(), data.size() ) ) {
+        throw InvalidFileFormatException( _filePath );
+    }
+}
 
-    fread( &width, sizeof( unsigned short ), 1, file );
-    fread( &height, sizeof( unsigned short ), 1, file );
-    fread( &bits, sizeof( unsigned char ), 1, file );
+crimild::Bool ImageTGA::loadFromMemory( const crimild::Byte *in, crimild::Size size )
+{
+    if ( size < 18 ) {
+        return false;
+    }
 
-    fseek( file, length + 1, SEEK_CUR );
+    const crimild::Size length = in[ 0 ];
+    const unsigned char imageType = in[ 2 ];
+    const crimild::Size width = in[ 12 ] | ( in[ 13 ] << 8 );
+    const crimild::Size height = in[ 14 ] | ( in[ 15 ] << 8 );
+    const unsigned char bits = in[ 16 ];
 
-    if( imageType != TGA_RLE ) {
-        if( bits == 24 || bits == 32 ) {
-            bpp = bits / 8;
-            stride = bpp * width;
-			data.resize( stride * height );
+    crimild::Size offset = 18 + length;
+    if ( offset > size ) {
+        return false;
+    }
 
-            for( unsigned int y = 0; y < height; y++ ) {
-                unsigned char *line = &data[ stride * y ];
+    const auto pixels = in + offset;
+    const auto available = size - offset;
 
-                fread( line, stride, 1, file );
+    crimild::Size bpp = bits / 8;
+    std::vector< unsigned char > data;
 
-                // Swap the B and R values since TGA
-                // files are stored as BGR instead of RGB
-                for( int i = 0; i < stride; i += bpp ) {
-                    int temp = line[ i ];
-                    line[ i ] = line[ i + 2 ];
-                    line[ i + 2 ] = temp;
-                }
+    if ( imageType != TGA_RLE ) {
+        if ( bits == 24 || bits == 32 ) {
+            data.resize( width * height * bpp );
+            if ( available < data.size() ) {
+                return false;
             }
+
+            // Swap the B and R values since TGA
+            // files are stored as BGR instead of RGB
+            std::memcpy( &data[ 0 ], pixels, data.size() );
+            ImageUtils::swapRedBlue( &data[ 0 ], width * height, bpp );
         }
         else if ( bits == 8 ) {
-        	bpp = 1;
-			data.resize( width * height );
-        	fread( &data[ 0 ], width * height, 1, file );
+            data.resize( width * height );
+            if ( available < data.size() ) {
+                return false;
+            }
+            std::memcpy( &data[ 0 ], pixels, data.size() );
         }
         else {
-        	// invalid format
-            throw InvalidFileFormatException( _filePath );
+            // invalid format
+            return false;
         }
     }
-    else
-    {
-        unsigned char rleID = 0;
-        int colorsRead = 0;
-        bpp = bits / 8;
-        stride = bpp * width;
-
-		data.resize( stride * height );
-		std::vector< unsigned char > colors( bpp );
-
-        int i = 0;
-        while ( i < static_cast< int >( width * height ) ) {
-            fread( &rleID, sizeof( unsigned char ), 1, file );
-
-            if ( rleID < 128 ) {
-                rleID++;
-
-                while ( rleID ) {
-                    fread( &colors[ 0 ], sizeof( unsigned char ) * bpp, 1, file );
-
-                    data[ colorsRead + 0 ] = colors[ 2 ];
-                    data[ colorsRead + 1 ] = colors[ 1 ];
-                    data[ colorsRead + 2 ] = colors[ 0 ];
-
-                    if ( bits == 32 ) {
-                        data[ colorsRead + 3 ] = colors[ 3 ];
-                    }
-
-                    i++;
-                    rleID--;
-                    colorsRead += bpp;
-                }
-            }
-            else {
-                rleID -= 127;
+    else {
+        if ( bits != 24 && bits != 32 ) {
+            return false;
+        }
 
-                fread( &colors[ 0 ], sizeof( unsigned char ) * bpp, 1, file );
+        data.resize( width * height * bpp );
 
-                while ( rleID ) {
-                    data[ colorsRead + 0 ] = colors[ 2 ];
-                    data[ colorsRead + 1 ] = colors[ 1 ];
-                    data[ colorsRead + 2 ] = colors[ 0 ];
+        crimild::Size src = 0;
+        crimild::Size dst = 0;
+        while ( dst < data.size() ) {
+            if ( src >= available ) {
+                return false;
+            }
 
-                    if ( bits == 32 ) {
-                        data[ colorsRead + 3 ] = colors[ 3 ];
-                    }
+            crimild::Size rleID = pixels[ src++ ];
+            const auto isRun = rleID >= 128;
+            const auto count = isRun ? rleID - 127 : rleID + 1;
+            const auto readBytes = isRun ? bpp : count * bpp;
+            if ( src + readBytes > available || dst + count * bpp > data.size() ) {
+                return false;
+            }
 
-                    i++;
-                    rleID--;
-                    colorsRead += bpp;
-                }
+            for ( crimild::Size i = 0; i < count; i++ ) {
+                std::memcpy( &data[ dst ], pixels + src + ( isRun ? 0 : i * bpp ), bpp );
+                dst += bpp;
             }
+            src += readBytes;
         }
-    }
 
-    fclose( file );
+        ImageUtils::swapRedBlue( &data[ 0 ], width * height, bpp );
+    }
 
     setData( width, height, bpp, &data[ 0 ], bpp == 3 ? PixelFormat::RGB : PixelFormat::RGBA );
+
+    return true;
 }
 
 void ImageTGA::saveToFile( const std::string &path ) const
@@ -42,6 +42,13 @@ namespace crimild {
 
 		virtual void load( void ) override;
 
+		/**
+			\brief Decodes a TGA file that is already in memory
+
+			\returns false if the data is not a valid or supported TGA file
+		*/
+		crimild::Bool loadFromMemory( const crimild::Byte *data, crimild::Size size );
+
 		void saveToFile( const std::string &fileName ) const;
 
 	private:
@@ -0,0 +1,393 @@
+/*
+ * Copyright (c) 2013, Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "ImageUtils.hpp"
+#include "Image.hpp"
+
+#include "Concurrency/Async.hpp"
+#include "Concurrency/JobScheduler.hpp"
+#include "Mathematics/Numeric.hpp"
+
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+#if defined( __SSE2__ ) || defined( _M_X64 )
+#include <emmintrin.h>
+#define CRIMILD_IMAGE_UTILS_SSE2 1
+#endif
+
+using namespace crimild;
+
+/**
+	\brief Splits rows in blocks and process them in parallel
+*/
+static void forEachRowBlock( crimild::Size rows, std::function< void( crimild::Size, crimild::Size ) > const &fn )
+{
+	crimild::Size blockCount = 1;
+	if ( concurrency::JobScheduler::hasInstance() && concurrency::JobScheduler::getInstance()->isRunning() ) {
+		blockCount = 4 * ( concurrency::JobScheduler::getInstance()->getNumWorkers() + 1 );
+	}
+	blockCount = Numeric< crimild::Size >::max( 1, Numeric< crimild::Size >::min( blockCount, rows / 8 ) );
+
+	auto blockSize = ( rows + blockCount - 1 ) / blockCount;
+	concurrency::parallel_for( blockCount, [ &fn, blockSize, rows ]( crimild::Size block ) {
+		auto begin = block * blockSize;
+		auto end = Numeric< crimild::Size >::min( rows, begin + blockSize );
+		if ( begin < end ) {
+			fn( begin, end );
+		}
+	});
+}
+
+/**
+	\brief Zero-order modified Bessel function of the first kind
+*/
+static crimild::Real64 bessel0( crimild::Real64 x )
+{
+	crimild::Real64 sum = 1.0;
+	crimild::Real64 term = 1.0;
+	for ( int k = 1; k < 32; k++ ) {
+		term *= ( x / ( 2.0 * k ) ) * ( x / ( 2.0 * k ) );
+		sum += term;
+		if ( term < 1e-12 * sum ) {
+			break;
+		}
+	}
+	return sum;
+}
+
+/**
+	\brief Precomputed weights for resampling one axis
+
+	Each destination pixel uses a contiguous range of source pixels
+	starting at 'first'. Indices are already clamped to the edges.
+*/
+struct ResampleKernel {
+	crimild::Size taps = 0;
+	std::vector< crimild::Size > indices;
+	std::vector< crimild::Real32 > weights;
+};
+
+static ResampleKernel computeKaiserKernel( crimild::Size srcSize, crimild::Size dstSize )
+{
+	// Radius and alpha values are measured in destination pixels. With
+	// a radius of 2, each output samples 8 pixels when halving the size
+	const crimild::Real64 radius = 2.0;
+	const crimild::Real64 alpha = 4.0;
+	const auto scale = static_cast< crimild::Real64 >( srcSize ) / static_cast< crimild::Real64 >( dstSize );
+	const auto norm = 1.0 / bessel0( alpha );
+
+	ResampleKernel kernel;
+	kernel.taps = static_cast< crimild::Size >( std::ceil( 2.0 * radius * scale ) );
+	kernel.indices.resize( dstSize * kernel.taps );
+	kernel.weights.resize( dstSize * kernel.taps );
+
+	for ( crimild::Size i = 0; i < dstSize; i++ ) {
+		auto center = ( i + 0.5 ) * scale;
+		auto first = static_cast< crimild::Int64 >( std::floor( center - radius * scale + 0.5 ) );
+
+		crimild::Real64 total = 0.0;
+		for ( crimild::Size t = 0; t < kernel.taps; t++ ) {
+			auto j = first + static_cast< crimild::Int64 >( t );
+			auto x = ( ( j + 0.5 ) - center ) / scale;
+
+			crimild::Real64 w = 0.0;
+			if ( std::abs( x ) < radius ) {
+				auto sinc = x == 0.0 ? 1.0 : std::sin( Numericd::PI * x ) / ( Numericd::PI * x );
+				auto r = x / radius;
+				w = sinc * bessel0( alpha * std::sqrt( 1.0 - r * r ) ) * norm;
+			}
+
+			auto clamped = Numeric< crimild::Int64 >::clamp( j, 0, static_cast< crimild::Int64 >( srcSize ) - 1 );
+			kernel.indices[ i * kernel.taps + t ] = static_cast< crimild::Size >( clamped );
+			kernel.weights[ i * kernel.taps + t ] = static_cast< crimild::Real32 >( w );
+			total += w;
+		}
+
+		for ( crimild::Size t = 0; t < kernel.taps; t++ ) {
+			kernel.weights[ i * kernel.taps + t ] = static_cast< crimild::Real32 >( kernel.weights[ i * kernel.taps + t ] / total );
+		}
+	}
+
+	return kernel;
+}
+
+static inline crimild::Byte toByte( crimild::Real32 value )
+{
+	return static_cast< crimild::Byte >( Numericf::clamp( value + 0.5f, 0.0f, 255.0f ) );
+}
+
+static void downsampleBox( const crimild::Byte *src, crimild::Size srcWidth, crimild::Size srcHeight, crimild::Byte *dst, crimild::Size dstWidth, crimild::Size dstHeight, crimild::Size bpp )
+{
+	forEachRowBlock( dstHeight, [ = ]( crimild::Size begin, crimild::Size end ) {
+		for ( crimild::Size y = begin; y < end; y++ ) {
+			auto y0 = Numeric< crimild::Size >::min( 2 * y, srcHeight - 1 );
+			auto y1 = Numeric< crimild::Size >::min( 2 * y + 1, srcHeight - 1 );
+			auto row0 = src + y0 * srcWidth * bpp;
+			auto row1 = src + y1 * srcWidth * bpp;
+			auto out = dst + y * dstWidth * bpp;
+			for ( crimild::Size x = 0; x < dstWidth; x++ ) {
+				auto x0 = Numeric< crimild::Size >::min( 2 * x, srcWidth - 1 ) * bpp;
+				auto x1 = Numeric< crimild::Size >::min( 2 * x + 1, srcWidth - 1 ) * bpp;
+				for ( crimild::Size c = 0; c < bpp; c++ ) {
+					auto sum = row0[ x0 + c ] + row0[ x1 + c ] + row1[ x0 + c ] + row1[ x1 + c ];
+					out[ x * bpp + c ] = static_cast< crimild::Byte >( ( sum + 2 ) >> 2 );
+				}
+			}
+		}
+	});
+}
+
+static void downsampleKaiser( const crimild::Byte *src, crimild::Size srcWidth, crimild::Size srcHeight, crimild::Byte *dst, crimild::Size dstWidth, crimild::Size dstHeight, crimild::Size bpp )
+{
+	const auto hk = computeKaiserKernel( srcWidth, dstWidth );
+	const auto vk = computeKaiserKernel( srcHeight, dstHeight );
+
+	// Horizontal pass for all source rows. Keeping intermediate
+	// results as floats avoids rounding twice
+	std::vector< crimild::Real32 > tmp( dstWidth * srcHeight * bpp );
+	auto tmpData = &tmp[ 0 ];
+	forEachRowBlock( srcHeight, [ =, &hk ]( crimild::Size begin, crimild::Size end ) {
+		crimild::Real32 acc[ 4 ];
+		for ( crimild::Size y = begin; y < end; y++ ) {
+			auto row = src + y * srcWidth * bpp;
+			auto out = tmpData + y * dstWidth * bpp;
+			for ( crimild::Size x = 0; x < dstWidth; x++ ) {
+				acc[ 0 ] = acc[ 1 ] = acc[ 2 ] = acc[ 3 ] = 0.0f;
+				auto indices = &hk.indices[ x * hk.taps ];
+				auto weights = &hk.weights[ x * hk.taps ];
+				for ( crimild::Size t = 0; t < hk.taps; t++ ) {
+					auto p = row + indices[ t ] * bpp;
+					auto w = weights[ t ];
+					for ( crimild::Size c = 0; c < bpp; c++ ) {
+						acc[ c ] += w * p[ c ];
+					}
+				}
+				for ( crimild::Size c = 0; c < bpp; c++ ) {
+					out[ x * bpp + c ] = acc[ c ];
+				}
+			}
+		}
+	});
+
+	// Vertical pass. Rows are accumulated as a whole, which is
+	// friendlier to the cache than walking columns
+	const auto stride = dstWidth * bpp;
+	forEachRowBlock( dstHeight, [ =, &vk ]( crimild::Size begin, crimild::Size end ) {
+		std::vector< crimild::Real32 > acc( stride );
+		for ( crimild::Size y = begin; y < end; y++ ) {
+			std::fill( acc.begin(), acc.end(), 0.0f );
+			auto indices = &vk.indices[ y * vk.taps ];
+			auto weights = &vk.weights[ y * vk.taps ];
+			for ( crimild::Size t = 0; t < vk.taps; t++ ) {
+				auto row = tmpData + indices[ t ] * stride;
+				auto w = weights[ t ];
+				for ( crimild::Size i = 0; i < stride; i++ ) {
+					acc[ i ] += w * row[ i ];
+				}
+			}
+			auto out = dst + y * stride;
+			for ( crimild::Size i = 0; i < stride; i++ ) {
+				out[ i ] = toByte( acc[ i ] );
+			}
+		}
+	});
+}
+
+void ImageUtils::swapRedBlue( crimild::Byte *data, crimild::Size pixelCount, crimild::Size bpp )
+{
+	if ( bpp == 4 ) {
+		crimild::Size i = 0;
+
+#ifdef CRIMILD_IMAGE_UTILS_SSE2
+		// Pixels are loaded as 32-bit little endian words (0xAARRGGBB), so
+		// swapping channels is just a matter of masking and shifting. 
+		const auto maskGA = _mm_set1_epi32( 0xFF00FF00 );
+		const auto maskB = _mm_set1_epi32( 0x000000FF );
+		for ( ; i + 4 <= pixelCount; i += 4 ) {
+			auto p = reinterpret_cast< __m128i * >( data + 4 * i );
+			auto v = _mm_loadu_si128( p );
+			auto ga = _mm_and_si128( v, maskGA );
+			auto r = _mm_and_si128( _mm_srli_epi32( v, 16 ), maskB );
+			auto b = _mm_slli_epi32( _mm_and_si128( v, maskB ), 16 );
+			_mm_storeu_si128( p, _mm_or_si128( ga, _mm_or_si128( r, b ) ) );
+		}
+#endif
+
+		for ( ; i < pixelCount; i++ ) {
+			auto p = data + 4 * i;
+			auto t = p[ 0 ];
+			p[ 0 ] = p[ 2 ];
+			p[ 2 ] = t;
+		}
+	}
+	else if ( bpp == 3 ) {
+		auto end = data + 3 * pixelCount;
+		for ( auto p = data; p < end; p += 3 ) {
+			auto t = p[ 0 ];
+			p[ 0 ] = p[ 2 ];
+			p[ 2 ] = t;
+		}
+	}
+}
+
+crimild::Bool ImageUtils::generateMipmaps( Image *image, MipmapFilter filter )
+{
+	if ( image == nullptr || !image->hasData() || image->getPixelType() != Image::PixelType::UNSIGNED_BYTE ) {
+		return false;
+	}
+
+	switch ( image->getPixelFormat() ) {
+		case Image::PixelFormat::RGB:
+		case Image::PixelFormat::RGBA:
+		case Image::PixelFormat::BGR:
+		case Image::PixelFormat::BGRA:
+		case Image::PixelFormat::RED:
+			break;
+
+		default:
+			return false;
+	}
+
+	const crimild::Size bpp = image->getBpp();
+	if ( bpp < 1 || bpp > 4 ) {
+		return false;
+	}
+
+	std::vector< SharedPointer< Image >> mipmaps;
+
+	const Image *src = image;
+	crimild::Size width = image->getWidth();
+	crimild::Size height = image->getHeight();
+	while ( width > 1 || height > 1 ) {
+		auto w = Numeric< crimild::Size >::max( 1, width / 2 );
+		auto h = Numeric< crimild::Size >::max( 1, height / 2 );
+
+		auto level = crimild::alloc< Image >( w, h, bpp, nullptr, image->getPixelFormat() );
+		if ( filter == MipmapFilter::BOX ) {
+			downsampleBox( src->getData(), width, height, level->getData(), w, h, bpp );
+		}
+		else {
+			downsampleKaiser( src->getData(), width, height, level->getData(), w, h, bpp );
+		}
+
+		mipmaps.push_back( level );
+		src = crimild::get_ptr( level );
+		width = w;
+		height = h;
+	}
+
+	image->setMipmaps( mipmaps );
+
+	return true;
+}
+
+crimild::Bool ImageUtils::convertToRGBA( const Image *image, std::vector< crimild::Byte > &output )
+{
+	if ( image == nullptr || !image->hasData() || image->getPixelType() != Image::PixelType::UNSIGNED_BYTE ) {
+		return false;
+	}
+
+	const crimild::Size bpp = image->getBpp();
+	const crimild::Size count = image->getWidth() * image->getHeight();
+	auto src = image->getData();
+
+	crimild::Bool swap = false;
+	switch ( image->getPixelFormat() ) {
+		case Image::PixelFormat::BGR:
+		case Image::PixelFormat::BGRA:
+			swap = true;
+			break;
+
+		case Image::PixelFormat::RGB:
+		case Image::PixelFormat::RGBA:
+		case Image::PixelFormat::RED:
+			break;
+
+		default:
+			return false;
+	}
+
+	if ( bpp < 1 || bpp > 4 ) {
+		return false;
+	}
+
+	output.resize( count * 4 );
+	auto dst = &output[ 0 ];
+	for ( crimild::Size i = 0; i < count; i++ ) {
+		auto p = src + i * bpp;
+		auto q = dst + i * 4;
+		if ( bpp >= 3 ) {
+			q[ 0 ] = p[ swap ? 2 : 0 ];
+			q[ 1 ] = p[ 1 ];
+			q[ 2 ] = p[ swap ? 0 : 2 ];
+			q[ 3 ] = bpp == 4 ? p[ 3 ] : 255;
+		}
+		else {
+			q[ 0 ] = q[ 1 ] = q[ 2 ] = p[ 0 ];
+			q[ 3 ] = bpp == 2 ? p[ 1 ] : 255;
+		}
+	}
+
+	return true;
+}
+
+crimild::Real64 ImageUtils::computePSNR( const Image *expected, const Image *actual )
+{
+	if ( expected == nullptr || actual == nullptr || expected->getWidth() != actual->getWidth() || expected->getHeight() != actual->getHeight() ) {
+		return 0.0;
+	}
+
+	std::vector< crimild::Byte > a;
+	std::vector< crimild::Byte > b;
+	if ( !convertToRGBA( expected, a ) || !convertToRGBA( actual, b ) ) {
+		return 0.0;
+	}
+
+	auto hasAlpha = []( const Image *image ) {
+		return image->getBpp() == 4 || image->getBpp() == 2;
+	};
+	const crimild::Size channels = hasAlpha( expected ) && hasAlpha( actual ) ? 4 : 3;
+
+	crimild::Real64 error = 0.0;
+	for ( crimild::Size i = 0; i < a.size(); i += 4 ) {
+		for ( crimild::Size c = 0; c < channels; c++ ) {
+			crimild::Real64 d = crimild::Real64( a[ i + c ] ) - crimild::Real64( b[ i + c ] );
+			error += d * d;
+		}
+	}
+
+	if ( error == 0.0 ) {
+		return std::numeric_limits< crimild::Real64 >::infinity();
+	}
+
+	auto mse = error / ( ( a.size() / 4 ) * channels );
+	return 10.0 * std::log10( 255.0 * 255.0 / mse );
+}
+
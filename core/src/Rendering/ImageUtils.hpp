@@ -0,0 +1,93 @@
+/*
+ * Copyright (c) 2013, Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef CRIMILD_RENDERING_IMAGE_UTILS_
+#define CRIMILD_RENDERING_IMAGE_UTILS_
+
+#include "Foundation/Types.hpp"
+
+#include <vector>
+
+namespace crimild {
+
+	class Image;
+
+	/**
+		\brief CPU-side image processing used when preparing textures
+	*/
+	class ImageUtils {
+	public:
+		enum class MipmapFilter {
+			BOX,	//< Averages 2x2 blocks. Fast, but tends to blur and alias
+			KAISER,	//< Kaiser-windowed sinc. Sharper results for minification
+		};
+
+		/**
+			\brief Swaps red and blue channels in place
+
+			Converts BGR(A) pixels to RGB(A) and vice versa. Only 3 and 4 bytes
+			per pixel are supported. Uses SSE2 for 4-channel images when available.
+		*/
+		static void swapRedBlue( crimild::Byte *data, crimild::Size pixelCount, crimild::Size bpp );
+
+		/**
+			\brief Generates the full mipmap chain for an 8-bit image
+
+			Levels are stored in the image itself, down to 1x1. Rows are
+			processed in parallel if the job scheduler is running.
+
+			\returns false if the image format is not supported
+		*/
+		static crimild::Bool generateMipmaps( Image *image, MipmapFilter filter = MipmapFilter::KAISER );
+
+		/**
+			\brief Expands an 8-bit image to RGBA
+
+			Missing channels are filled in as if the image was grayscale
+			(for single-channel images) and opaque.
+
+			\returns false if the image format is not supported
+		*/
+		static crimild::Bool convertToRGBA( const Image *image, std::vector< crimild::Byte > &output );
+
+		/**
+			\brief Computes the peak signal-to-noise ratio between two images
+
+			Images must have the same size. Alpha is only compared if both
+			images have an alpha channel. Used to measure the quality of
+			lossy conversions, like texture compression.
+
+			\returns PSNR in decibels, infinity if both images are identical
+			or zero if images cannot be compared
+		*/
+		static crimild::Real64 computePSNR( const Image *expected, const Image *actual );
+	};
+
+}
+
+#endif
+
@@ -31,19 +31,34 @@ CRIMILD_REGISTER_STREAM_OBJECT_BUILDER( crimild::IndexBufferObject )
 
 using namespace crimild;
 
+IndexBufferObject::IndexType IndexBufferObject::getIndexTypeForVertexCount( crimild::Size vertexCount )
+{
+	// the largest index must fit in 16 bits
+	return vertexCount > 65536 ? IndexType::UINT32 : IndexType::UINT16;
+}
+
 IndexBufferObject::IndexBufferObject( void )
 {
 	
 }
 
-IndexBufferObject::IndexBufferObject( unsigned int indexCount )
-	: IndexBufferObject( indexCount, nullptr )
+IndexBufferObject::IndexBufferObject( unsigned int indexCount, IndexBufferObject::IndexType indexType )
+	: BufferObject( indexCount * ( indexType == IndexType::UINT32 ? sizeof( crimild::UInt32 ) : sizeof( crimild::UInt16 ) ), nullptr ),
+	  _indexType( indexType )
 { 
 
 }
 
-IndexBufferObject::IndexBufferObject( unsigned int indexCount, const IndexPrecision *indexData )
-	: BufferObject( indexCount, indexData )
+IndexBufferObject::IndexBufferObject( unsigned int indexCount, const crimild::UInt16 *indexData )
+	: BufferObject( indexCount * sizeof( crimild::UInt16 ), reinterpret_cast< const crimild::Byte * >( indexData ) ),
+	  _indexType( IndexType::UINT16 )
+{
+
+}
+
+IndexBufferObject::IndexBufferObject( unsigned int indexCount, const crimild::UInt32 *indexData )
+	: BufferObject( indexCount * sizeof( crimild::UInt32 ), reinterpret_cast< const crimild::Byte * >( indexData ) ),
+	  _indexType( IndexType::UINT32 )
 {
 
 }
@@ -55,23 +70,49 @@ IndexBufferObject::~IndexBufferObject( void )
 
 void IndexBufferObject::generateIncrementalIndices( void )
 {
-    for ( unsigned int i = 0; i < getIndexCount(); i++ ) {
-        data()[ i ] = static_cast< IndexPrecision >( i );
+	const auto count = getIndexCount();
+    for ( unsigned int i = 0; i < count; i++ ) {
+        setIndexAt( i, i );
     }
 }
 
+void IndexBufferObject::encode( coding::Encoder &encoder )
+{
+	BufferObject< crimild::Byte >::encode( encoder );
+
+	encoder.encode( "indexType", static_cast< crimild::UInt8 >( _indexType ) );
+}
+
+void IndexBufferObject::decode( coding::Decoder &decoder )
+{
+	BufferObject< crimild::Byte >::decode( decoder );
+
+	// older files do not include the index type
+	crimild::UInt8 indexType = static_cast< crimild::UInt8 >( IndexType::UINT16 );
+	decoder.decode( "indexType", indexType );
+	_indexType = static_cast< IndexType >( indexType );
+}
+
 bool IndexBufferObject::registerInStream( Stream &s )
 {
-	return BufferObject< IndexPrecision >::registerInStream( s );
+	return BufferObject< crimild::Byte >::registerInStream( s );
 }
 
 void IndexBufferObject::save( Stream &s )
 {
-	BufferObject< IndexPrecision >::save( s );
+	BufferObject< crimild::Byte >::save( s );
+
+	s.write( static_cast< crimild::UInt8 >( _indexType ) );
 }
 
 void IndexBufferObject::load( Stream &s )
 {
-	BufferObject< IndexPrecision >::load( s );
-}
+	BufferObject< crimild::Byte >::load( s );
 
+	_indexType = IndexType::UINT16;
+	if ( s.getVersion() >= Version( 4, 10, 1 ) ) {
+		crimild::UInt8 indexType;
+		s.read( indexType );
+		_indexType = static_cast< IndexType >( indexType );
+	}
+}
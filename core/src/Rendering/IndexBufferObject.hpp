@@ -33,27 +33,93 @@
 
 namespace crimild {
 
-	using IndexPrecision = unsigned short;
+	/**
+	   \brief Default precision for index data
+
+	   \remarks Index buffers might use 32-bit indices instead. See
+	   IndexBufferObject::IndexType
+	 */
+	using IndexPrecision = crimild::UInt16;
 
 	class IndexBufferObject : 
-		public BufferObject< IndexPrecision >, 
+		public BufferObject< crimild::Byte >, 
 		public Catalog< IndexBufferObject >::Resource {
 		CRIMILD_IMPLEMENT_RTTI( crimild::IndexBufferObject )
 
 	public:
-		explicit IndexBufferObject( unsigned int indexCount );
+		/**
+		   \brief Width of each index in the buffer
+		 */
+		enum class IndexType : uint8_t {
+			UINT16,		//< Default
+			UINT32
+		};
+
+		/**
+		   \brief Computes the smallest index type able to address the given number of vertices
+		 */
+		static IndexType getIndexTypeForVertexCount( crimild::Size vertexCount );
+
+	public:
+		explicit IndexBufferObject( unsigned int indexCount, IndexType indexType = IndexType::UINT16 );
 
-		IndexBufferObject( unsigned int indexCount, const IndexPrecision *indexData );
+		IndexBufferObject( unsigned int indexCount, const crimild::UInt16 *indexData );
+
+		IndexBufferObject( unsigned int indexCount, const crimild::UInt32 *indexData );
 		
 		virtual ~IndexBufferObject( void );
 
-		unsigned int getIndexCount( void ) const { return getUsedCount(); }
+		inline IndexType getIndexType( void ) const { return _indexType; }
+
+		/**
+		   \brief Size of each index in bytes
+		 */
+		inline crimild::Size getIndexSize( void ) const { return _indexType == IndexType::UINT32 ? sizeof( crimild::UInt32 ) : sizeof( crimild::UInt16 ); }
+
+		unsigned int getIndexCount( void ) const { return getUsedCount() / getIndexSize(); }
+
+		/**
+		   \brief Changes the number of indices in use
+
+		   Indices beyond the new count are kept around, so buffers with
+		   a fixed pattern (i.e. quads) can be generated once for the
+		   maximum size and then just trimmed each frame.
+		 */
+		void setIndexCount( unsigned int indexCount ) { setUsedCount( indexCount * getIndexSize() ); }
+
+        void setIndexAt( unsigned int position, crimild::UInt32 value )
+        {
+            if ( _indexType == IndexType::UINT32 ) {
+                reinterpret_cast< crimild::UInt32 * >( data() )[ position ] = value;
+            }
+            else {
+                reinterpret_cast< crimild::UInt16 * >( data() )[ position ] = static_cast< crimild::UInt16 >( value );
+            }
+        }
+
+        crimild::UInt32 getIndexAt( unsigned int position ) const
+        {
+            if ( _indexType == IndexType::UINT32 ) {
+                return reinterpret_cast< const crimild::UInt32 * >( getData() )[ position ];
+            }
+            return reinterpret_cast< const crimild::UInt16 * >( getData() )[ position ];
+        }
 
-        void setIndexAt( unsigned int position, IndexPrecision value ) { data()[ position ] = value; }
+        void generateIncrementalIndices( void );
 
-        IndexPrecision getIndexAt( unsigned int position ) const { return getData()[ position ]; }
+	private:
+		IndexType _indexType = IndexType::UINT16;
 
-        void generateIncrementalIndices( void );
+        /**
+            \name Coding
+         */
+        //@{
+            
+    public:
+        virtual void encode( coding::Encoder &encoder ) override;
+        virtual void decode( coding::Decoder &decoder ) override;
+            
+        //@}
 
         /**
         	\name Streaming
@@ -56,7 +56,7 @@ void BlendPass::setup( RenderGraph *graph )
 
 void BlendPass::execute( RenderGraph *graph, Renderer *renderer, RenderQueue *renderQueue )
 {
-	CRIMILD_PROFILE( getName() )
+	CRIMILD_PROFILE_DYNAMIC( getName() )
 
 	if ( _inputs.size() == 0 ) {
 		return;
@@ -112,7 +112,7 @@ void DepthPass::setup( RenderGraph *graph )
 
 void DepthPass::execute( RenderGraph *graph, Renderer *renderer, RenderQueue *renderQueue )
 {
-	CRIMILD_PROFILE( getName() )
+	CRIMILD_PROFILE_DYNAMIC( getName() )
 	
 	auto fbo = graph->createFBO( { _depthOutput, _normalOutput } );
 	
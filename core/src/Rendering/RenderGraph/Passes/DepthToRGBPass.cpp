@@ -129,7 +129,7 @@ void DepthToRGBPass::setup( RenderGraph *graph )
 
 void DepthToRGBPass::execute( RenderGraph *graph, Renderer *renderer, RenderQueue *renderQueue )
 {
-	CRIMILD_PROFILE( getName() );
+	CRIMILD_PROFILE_DYNAMIC( getName() );
 
 	if ( _input == nullptr || _input->getTexture() == nullptr ) {
 		return;
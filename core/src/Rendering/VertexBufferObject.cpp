@@ -57,6 +57,12 @@ VertexBufferObject::~VertexBufferObject( void )
 
 }
 
+void VertexBufferObject::setVertexCount( unsigned int vertexCount )
+{
+	setUsedCount( vertexCount * getVertexFormat().getVertexSize() );
+	_vertexCount = vertexCount;
+}
+
 const VertexBufferObject::Vector3Impl &VertexBufferObject::getPositionAt( unsigned int vIdx ) const
 {
 	return *( ( VertexBufferObject::Vector3Impl * ) &( getData()[ vIdx * getVertexFormat().getVertexSize() + getVertexFormat().getPositionsOffset() ] ) );
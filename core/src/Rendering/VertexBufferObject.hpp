@@ -58,6 +58,15 @@ namespace crimild {
 		const VertexFormat &getVertexFormat( void ) const { return _vertexFormat; }
 		unsigned int getVertexCount( void ) const { return _vertexCount; }
 
+		/**
+		   \brief Changes the number of vertices in use
+
+		   Memory is only reallocated if the buffer needs to grow. 
+		   Use it together with Usage::STREAM for geometry that is 
+		   rebuilt every frame.
+		 */
+		void setVertexCount( unsigned int vertexCount );
+
 		const Vector3Impl &getPositionAt( unsigned int vIdx ) const;
 		void setPositionAt( unsigned int vIdx, const Vector3Impl &value );
 
@@ -54,6 +54,15 @@ namespace crimild {
 				TEXTURE_COORD = 4,
 				BONE_ID = 5,
 				BONE_WEIGHT = 6,
+
+				/**
+					\brief Base location for per-instance attributes
+
+					Attributes from an instance buffer use the same layout
+					as regular ones, but shifted by this offset (i.e. an
+					instance position is bound at INSTANCE_OFFSET + POSITION)
+				*/
+				INSTANCE_OFFSET = 8,
 			};
 		};
 
@@ -176,12 +176,50 @@ void Text::setHorizontalAlignment( Text::HorizontalAlignment alignment )
 
 void Text::updatePrimitive( void )
 {
-	std::vector< VertexPrecision > vertices;
-	std::vector< IndexPrecision > indices;
+    auto format = VertexFormat::VF_P3_N3_UV2;
+
+    if ( _vbo == nullptr ) {
+        // Buffers are reused every time the text changes and they
+        // only grow if the new text is longer than any previous one
+        _vbo = crimild::alloc< VertexBufferObject >( format, 0 );
+        _vbo->setUsage( VertexBufferObject::Usage::STREAM );
+    }
+
+    const auto textLength = _text.length();
+
+    // Each character requires 6 vertices at most
+    const auto maxVertexCount = 6 * textLength;
+    const auto indexType = IndexBufferObject::getIndexTypeForVertexCount( maxVertexCount );
+    if ( _ibo == nullptr || ( indexType == IndexBufferObject::IndexType::UINT32 && _ibo->getIndexType() != indexType ) ) {
+        _ibo = crimild::alloc< IndexBufferObject >( 0, indexType );
+        _ibo->setUsage( IndexBufferObject::Usage::STREAM );
+    }
+
+    const auto previousVertexCount = _vbo->getVertexCount();
+    const auto previousIndexCount = _ibo->getIndexCount();
+    _vbo->setVertexCount( maxVertexCount );
+    _ibo->setIndexCount( maxVertexCount );
+
+    auto vertices = _vbo->data();
+    auto ibo = crimild::get_ptr( _ibo );
+    unsigned int vertexCount = 0;
+
+    auto addVertex = [ &vertices, ibo, &vertexCount, format ]( float x, float y, float u, float v ) {
+        auto vertex = vertices + vertexCount * format.getVertexSize();
+        vertex[ 0 ] = x;
+        vertex[ 1 ] = y;
+        vertex[ 2 ] = 0.0f;
+        vertex[ 3 ] = 0.0f;
+        vertex[ 4 ] = 0.0f;
+        vertex[ 5 ] = 1.0f;
+        vertex[ 6 ] = u;
+        vertex[ 7 ] = v;
+        ibo->setIndexAt( vertexCount, vertexCount );
+        vertexCount++;
+    };
 
 	float horiAdvance = 0.0f;
 	float vertAdvance = 0.0f;
-	const auto textLength = _text.length();
 	for ( int i = 0; i < textLength; i++ ) {
 		auto c = ( unsigned char ) _text[ i ];
 		if ( c > 127 ) {
@@ -214,79 +252,32 @@ void Text::updatePrimitive( void )
 		float t0 = glyph.vOffset;
 		float t1 = t0 + glyph.v;
 
-		vertices.push_back( minX ); 
-		vertices.push_back( maxY );
-		vertices.push_back( 0.0f );
-		vertices.push_back( 0.0f );
-		vertices.push_back( 0.0f );
-		vertices.push_back( 1.0f );
-		vertices.push_back( s0 );
-		vertices.push_back( 1.0f - t0 );
-		indices.push_back( indices.size() );
-
-		vertices.push_back( minX ); 
-		vertices.push_back( minY );
-		vertices.push_back( 0.0f );
-		vertices.push_back( 0.0f );
-		vertices.push_back( 0.0f );
-		vertices.push_back( 1.0f );
-		vertices.push_back( s0 );
-		vertices.push_back( 1.0f - t1 );
-		indices.push_back( indices.size() );
-
-		vertices.push_back( maxX ); 
-		vertices.push_back( minY );
-		vertices.push_back( 0.0f );
-		vertices.push_back( 0.0f );
-		vertices.push_back( 0.0f );
-		vertices.push_back( 1.0f );
-		vertices.push_back( s1 );
-		vertices.push_back( 1.0f - t1 );
-		indices.push_back( indices.size() );
-
-		vertices.push_back( minX ); 
-		vertices.push_back( maxY );
-		vertices.push_back( 0.0f );
-		vertices.push_back( 0.0f );
-		vertices.push_back( 0.0f );
-		vertices.push_back( 1.0f );
-		vertices.push_back( s0 );
-		vertices.push_back( 1.0f - t0 );
-		indices.push_back( indices.size() );
-
-		vertices.push_back( maxX ); 
-		vertices.push_back( minY );
-		vertices.push_back( 0.0f );
-		vertices.push_back( 0.0f );
-		vertices.push_back( 0.0f );
-		vertices.push_back( 1.0f );
-		vertices.push_back( s1 );
-		vertices.push_back( 1.0f - t1 );
-		indices.push_back( indices.size() );
-
-		vertices.push_back( maxX ); 
-		vertices.push_back( maxY );
-		vertices.push_back( 0.0f );
-		vertices.push_back( 0.0f );
-		vertices.push_back( 0.0f );
-		vertices.push_back( 1.0f );
-		vertices.push_back( s1 );
-		vertices.push_back( 1.0f - t0 );
-		indices.push_back( indices.size() );
+		addVertex( minX, maxY, s0, 1.0f - t0 );
+		addVertex( minX, minY, s0, 1.0f - t1 );
+		addVertex( maxX, minY, s1, 1.0f - t1 );
+		addVertex( minX, maxY, s0, 1.0f - t0 );
+		addVertex( maxX, minY, s1, 1.0f - t1 );
+		addVertex( maxX, maxY, s1, 1.0f - t0 );
 
 		horiAdvance += glyph.advance;
 	}
 
-	if ( vertices.size() == 0 ) {
+	if ( vertexCount == 0 ) {
+        // keep previous contents
+        _vbo->setVertexCount( previousVertexCount );
+        _ibo->setIndexCount( previousIndexCount );
 		return;
 	}
 
-    auto format = VertexFormat::VF_P3_N3_UV2;
-    auto vbo = crimild::alloc< VertexBufferObject >( format, vertices.size() / format.getVertexSize(), &vertices[ 0 ] );
-    _primitive->setVertexBuffer( vbo );
-    
-    auto ibo = crimild::alloc< IndexBufferObject >( indices.size(), &indices[ 0 ] );
-	_primitive->setIndexBuffer( ibo );
+    _vbo->setVertexCount( vertexCount );
+    _ibo->setIndexCount( vertexCount );
+    _vbo->invalidate();
+    _ibo->invalidate();
+
+    if ( _primitive->getIndexBuffer() != crimild::get_ptr( _ibo ) ) {
+        _primitive->setVertexBuffer( _vbo );
+        _primitive->setIndexBuffer( _ibo );
+    }
 	
 	_geometry->updateModelBounds();
     
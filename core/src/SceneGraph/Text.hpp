@@ -32,6 +32,8 @@
 #include "Geometry.hpp"
 #include "Rendering/Image.hpp"
 #include "Rendering/Material.hpp"
+#include "Rendering/VertexBufferObject.hpp"
+#include "Rendering/IndexBufferObject.hpp"
 
 namespace crimild {
 
@@ -115,6 +117,8 @@ namespace crimild {
 		SharedPointer< Font > _font;
         SharedPointer< Geometry > _geometry;
 		SharedPointer< Primitive > _primitive;
+		SharedPointer< VertexBufferObject > _vbo;
+		SharedPointer< IndexBufferObject > _ibo;
 		SharedPointer< Material > _material;
         HorizontalAlignment _horizontalAlignment = HorizontalAlignment::LEFT;
 
@@ -28,19 +28,33 @@
 #include "AssetManager.hpp"
 #include "FileSystem.hpp"
 
+#include "Concurrency/Async.hpp"
+#include "Foundation/Log.hpp"
 #include "Foundation/StringUtils.hpp"
 #include "Rendering/Texture.hpp"
 #include "Rendering/ImageTGA.hpp"
+#include "Rendering/ImagePNG.hpp"
+#include "Rendering/ImageKTX.hpp"
+#include "Rendering/ImageDDS.hpp"
+#include "Rendering/ImageLoader.hpp"
+#include "Primitives/Primitive.hpp"
+#include "Mathematics/Numeric.hpp"
+
+#include <algorithm>
 
 using namespace crimild;
 
 AssetManager::AssetManager( void )
 {
-
+	// textures can be loaded asynchronously by default. Loaders
+	// registered later for the same extensions replace these ones
+	ImageLoader::registerAssetLoaders( this );
 }
 
 AssetManager::~AssetManager( void )
 {
+	stopIOThreads();
+
 	clear();
 }
 
@@ -49,15 +63,24 @@ namespace crimild {
 	template<>
 	Texture *AssetManager::get< Texture >( std::string name )
 	{
-	    Texture *texture = nullptr;
+	    auto texture = static_cast< Texture * >( lookup( name ) );
 	    
-	    {
-	        ScopedLock lock( _mutex );
-	        texture = static_cast< Texture * >( crimild::get_ptr( _assets[ name ] ) );
-	    }
-	    
-		if ( texture == nullptr && ( StringUtils::getFileExtension( name ) == "tga" ) ) {
-			auto image = crimild::alloc< ImageTGA >( FileSystem::getInstance().pathForResource( name ) );
+		if ( texture == nullptr ) {
+			SharedPointer< Image > image;
+			auto extension = StringUtils::getFileExtension( name );
+			if ( extension == "tga" ) {
+				image = crimild::alloc< ImageTGA >( FileSystem::getInstance().pathForResource( name ) );
+			}
+			else if ( extension == "png" ) {
+				image = crimild::alloc< ImagePNG >( FileSystem::getInstance().pathForResource( name ) );
+			}
+			else if ( extension == "ktx" ) {
+				image = crimild::alloc< ImageKTX >( FileSystem::getInstance().pathForResource( name ) );
+			}
+			else if ( extension == "dds" ) {
+				image = crimild::alloc< ImageDDS >( FileSystem::getInstance().pathForResource( name ) );
+			}
+
 			if ( image != nullptr ) {
 	            auto tmp = crimild::alloc< Texture >( image ) ;
 				set( name, tmp );
@@ -70,6 +93,103 @@ namespace crimild {
 
 }
 
+static crimild::Size estimateAssetSize( SharedObject *asset )
+{
+	if ( auto texture = dynamic_cast< Texture * >( asset ) ) {
+		auto image = texture->getImage();
+		if ( image != nullptr ) {
+			// use the actual data size, which accounts for compressed formats
+			crimild::Size size = 0;
+			for ( crimild::Size level = 0; level <= image->getMipmapCount(); level++ ) {
+				size += image->getMipmap( level )->getDataSize();
+			}
+			return size;
+		}
+	}
+	else if ( auto primitive = dynamic_cast< Primitive * >( asset ) ) {
+		crimild::Size size = 0;
+		if ( auto vbo = primitive->getVertexBuffer() ) {
+			size += vbo->getSizeInBytes();
+		}
+		if ( auto ibo = primitive->getIndexBuffer() ) {
+			size += ibo->getSizeInBytes();
+		}
+		return size;
+	}
+
+	return 0;
+}
+
+void AssetManager::set( std::string name, SharedPointer< SharedObject > const &asset, bool isPersistent, crimild::Size sizeInBytes )
+{
+	if ( !isPersistent && sizeInBytes == 0 ) {
+		sizeInBytes = estimateAssetSize( crimild::get_ptr( asset ) );
+	}
+
+	ScopedLock lock( _mutex );
+
+	if ( isPersistent ) {
+		_persistentAssets[ name ] = asset;
+		return;
+	}
+
+	auto &entry = _assets[ name ];
+	_usedBytes -= entry.sizeInBytes;
+	entry.asset = asset;
+	entry.sizeInBytes = sizeInBytes;
+	entry.lastUsedFrame = _frame;
+	_usedBytes += sizeInBytes;
+
+	if ( _memoryBudget > 0 && _usedBytes > _memoryBudget ) {
+		evict( _memoryBudget );
+	}
+}
+
+void AssetManager::clear( bool clearAll )
+{
+	ScopedLock lock( _mutex );
+
+	_assets.clear();
+	_usedBytes = 0;
+
+	if ( clearAll ) {
+		_persistentAssets.clear();
+	}
+}
+
+SharedObject *AssetManager::lookup( std::string const &name )
+{
+	ScopedLock lock( _mutex );
+
+	return crimild::get_ptr( find_unsafe( name ) );
+}
+
+SharedPointer< SharedObject > AssetManager::acquire( std::string const &name )
+{
+	ScopedLock lock( _mutex );
+
+	return find_unsafe( name );
+}
+
+SharedPointer< SharedObject > AssetManager::find_unsafe( std::string const &name )
+{
+	auto it = _assets.find( name );
+	if ( it != _assets.end() && it->second.asset != nullptr ) {
+		it->second.lastUsedFrame = _frame;
+		++_stats.hits;
+		return it->second.asset;
+	}
+
+	auto pit = _persistentAssets.find( name );
+	if ( pit != _persistentAssets.end() && pit->second != nullptr ) {
+		++_stats.hits;
+		return pit->second;
+	}
+
+	++_stats.misses;
+	return nullptr;
+}
+
 void AssetManager::loadFont( std::string name, std::string fileName )
 {
     std::string fontDefFileName = FileSystem::getInstance().pathForResource( fileName );
@@ -77,3 +197,278 @@ void AssetManager::loadFont( std::string name, std::string fileName )
 	set( name, font, true );    
 }
 
+void AssetManager::registerLoader( std::string extension, AssetLoader const &loader )
+{
+	ScopedLock lock( _mutex );
+
+	_loaders[ extension ] = loader;
+}
+
+AssetRequestPtr AssetManager::loadAsync( std::string name, crimild::Int32 priority, AssetRequest::Callback const &callback )
+{
+	auto request = crimild::alloc< AssetRequest >( name, callback );
+
+	SharedPointer< SharedObject > cached;
+
+	{
+		ScopedLock lock( _mutex );
+
+		cached = find_unsafe( name );
+		if ( cached == nullptr ) {
+			auto &load = _pendingLoads[ name ];
+			if ( load == nullptr ) {
+				load = crimild::alloc< PendingLoad >();
+				load->name = name;
+				load->priority = priority;
+				load->sequence = _nextSequence++;
+				_loadQueue.insert( crimild::get_ptr( load ) );
+			}
+			else if ( !load->started && priority > load->priority ) {
+				// re-insert, since the order changed
+				_loadQueue.erase( crimild::get_ptr( load ) );
+				load->priority = priority;
+				_loadQueue.insert( crimild::get_ptr( load ) );
+			}
+			load->requests.push_back( request );
+		}
+	}
+
+	if ( cached != nullptr ) {
+		request->resolve( cached );
+		if ( callback != nullptr ) {
+			concurrency::sync_frame( [ request ] {
+				request->notify();
+			});
+		}
+		return request;
+	}
+
+	startIOThreads();
+	_ioCondition.notify_one();
+
+	return request;
+}
+
+crimild::Size AssetManager::getPendingLoadCount( void )
+{
+	ScopedLock lock( _mutex );
+
+	return _pendingLoads.size();
+}
+
+void AssetManager::cancel( AssetRequest *request )
+{
+	ScopedLock lock( _mutex );
+
+	auto it = _pendingLoads.find( request->getName() );
+	if ( it == _pendingLoads.end() ) {
+		return;
+	}
+
+	auto load = it->second;
+	auto &requests = load->requests;
+	for ( auto r = requests.begin(); r != requests.end(); ++r ) {
+		if ( crimild::get_ptr( *r ) == request ) {
+			requests.erase( r );
+			break;
+		}
+	}
+
+	if ( requests.empty() && !load->started ) {
+		// nobody is waiting for this asset anymore. Loads that already 
+		// started are discarded by the I/O thread once they're done
+		_loadQueue.erase( crimild::get_ptr( load ) );
+		_pendingLoads.erase( it );
+	}
+}
+
+void AssetManager::startIOThreads( void )
+{
+	ScopedLock lock( _mutex );
+
+	if ( _ioStopping ) {
+		return;
+	}
+
+	while ( _ioThreads.size() < _maxIOThreads ) {
+		_ioThreads.push_back( std::thread( [ this ] { runIOThread(); } ) );
+	}
+}
+
+void AssetManager::stopIOThreads( void )
+{
+	{
+		ScopedLock lock( _mutex );
+		_ioStopping = true;
+	}
+
+	_ioCondition.notify_all();
+
+	for ( auto &t : _ioThreads ) {
+		t.join();
+	}
+	_ioThreads.clear();
+}
+
+void AssetManager::runIOThread( void )
+{
+	while ( true ) {
+		PendingLoadPtr load;
+		AssetLoader loader;
+
+		{
+			std::unique_lock< Mutex > lock( _mutex );
+			_ioCondition.wait( lock, [ this ] { return _ioStopping || !_loadQueue.empty(); } );
+			if ( _ioStopping ) {
+				return;
+			}
+
+			auto next = *_loadQueue.begin();
+			_loadQueue.erase( _loadQueue.begin() );
+			next->started = true;
+			load = _pendingLoads[ next->name ];
+
+			auto it = _loaders.find( StringUtils::getFileExtension( load->name ) );
+			if ( it != _loaders.end() ) {
+				loader = it->second;
+			}
+		}
+
+		SharedPointer< SharedObject > asset;
+		if ( loader == nullptr ) {
+			Log::error( CRIMILD_CURRENT_CLASS_NAME, "No loader registered for ", load->name );
+		}
+		else {
+			auto &fs = FileSystem::getInstance();
+			containers::ByteArray data;
+			if ( !fs.readFile( fs.pathForResource( load->name ), data ) ) {
+				Log::error( CRIMILD_CURRENT_CLASS_NAME, "Cannot read file for ", load->name );
+			}
+			else {
+				load->sizeInBytes = data.size();
+				asset = loader( load->name, data );
+				if ( asset == nullptr ) {
+					Log::error( CRIMILD_CURRENT_CLASS_NAME, "Cannot load asset ", load->name );
+				}
+			}
+		}
+
+		{
+			ScopedLock lock( _mutex );
+			if ( load->requests.empty() ) {
+				// all requests were cancelled while loading
+				_pendingLoads.erase( load->name );
+				continue;
+			}
+		}
+
+		concurrency::sync_frame( [ load, asset ] {
+			if ( AssetManager::hasInstance() ) {
+				AssetManager::getInstance()->completeLoad( load, asset );
+			}
+		});
+	}
+}
+
+void AssetManager::completeLoad( PendingLoadPtr const &load, SharedPointer< SharedObject > const &asset )
+{
+	std::vector< AssetRequestPtr > requests;
+
+	{
+		ScopedLock lock( _mutex );
+
+		auto it = _pendingLoads.find( load->name );
+		if ( it != _pendingLoads.end() && it->second == load ) {
+			_pendingLoads.erase( it );
+		}
+
+		requests.swap( load->requests );
+	}
+
+	if ( asset != nullptr && !requests.empty() ) {
+		// use the file size if there's no better estimation
+		set( load->name, asset, false, Numeric< crimild::Size >::max( load->sizeInBytes, estimateAssetSize( crimild::get_ptr( asset ) ) ) );
+	}
+
+	for ( auto &request : requests ) {
+		request->resolve( asset );
+	}
+
+	for ( auto &request : requests ) {
+		request->notify();
+	}
+}
+
+void AssetManager::setMemoryBudget( crimild::Size bytes )
+{
+	ScopedLock lock( _mutex );
+
+	_memoryBudget = bytes;
+	if ( _memoryBudget > 0 && _usedBytes > _memoryBudget ) {
+		evict( _memoryBudget );
+	}
+}
+
+void AssetManager::step( void )
+{
+	ScopedLock lock( _mutex );
+
+	++_frame;
+
+	if ( _memoryBudget > 0 && _usedBytes > _memoryBudget ) {
+		evict( _memoryBudget );
+	}
+}
+
+void AssetManager::trim( void )
+{
+	ScopedLock lock( _mutex );
+
+	evict( _memoryBudget );
+}
+
+AssetManager::Stats AssetManager::getStats( void )
+{
+	ScopedLock lock( _mutex );
+
+	auto stats = _stats;
+	stats.assetCount = _assets.size();
+	stats.usedBytes = _usedBytes;
+	stats.memoryBudget = _memoryBudget;
+	return stats;
+}
+
+void AssetManager::resetStats( void )
+{
+	ScopedLock lock( _mutex );
+
+	_stats = Stats();
+}
+
+void AssetManager::evict( crimild::Size targetBytes )
+{
+	// Candidates are assets that are only referenced by the cache and that
+	// were not used during the current frame. Sorting is fine since this
+	// only happens when the budget is exceeded
+	std::vector< std::pair< crimild::UInt64, std::string > > candidates;
+	for ( auto &it : _assets ) {
+		auto &entry = it.second;
+		if ( entry.lastUsedFrame < _frame && entry.asset.use_count() <= 1 ) {
+			candidates.push_back( std::make_pair( entry.lastUsedFrame, it.first ) );
+		}
+	}
+
+	std::sort( candidates.begin(), candidates.end() );
+
+	for ( auto &candidate : candidates ) {
+		if ( targetBytes > 0 && _usedBytes <= targetBytes ) {
+			break;
+		}
+
+		auto it = _assets.find( candidate.second );
+		_usedBytes -= it->second.sizeInBytes;
+		_assets.erase( it );
+		++_stats.evictions;
+	}
+}
+
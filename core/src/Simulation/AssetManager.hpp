@@ -32,12 +32,20 @@
 #include "Foundation/Macros.hpp"
 #include "Foundation/Singleton.hpp"
 
+#include "Foundation/Containers/Array.hpp"
+#include "Simulation/AssetRequest.hpp"
+
 #include "Visitors/ShallowCopy.hpp"
 
+#include <condition_variable>
+#include <functional>
 #include <memory>
 #include <map>
+#include <set>
 #include <string>
 #include <mutex>
+#include <thread>
+#include <vector>
 
 namespace crimild {
 
@@ -51,34 +59,64 @@ namespace crimild {
     public:
         static constexpr const char *FONT_DEFAULT = "fonts/default";
         static constexpr const char *FONT_SYSTEM = "fonts/system";
+
+        /**
+            \brief Creates an asset from the contents of a file
+
+            Loaders are invoked from I/O threads, so they must not access
+            the scene or any other main-thread state. Returning nullptr 
+            indicates the asset could not be created.
+
+            I/O threads are not JobScheduler workers, so parallel_for() runs 
+            serially inside loaders. Use setMaxIOThreads() to load more 
+            assets concurrently instead.
+         */
+        using AssetLoader = std::function< SharedPointer< SharedObject >( std::string const &name, containers::ByteArray const &data ) >;
         
     public:
         AssetManager( void );
         virtual ~AssetManager( void );
 
-        void set( std::string name, SharedPointer< SharedObject > const &asset, bool isPersistent = false )
-        {
-            ScopedLock lock( _mutex );
-            
-            if ( isPersistent ) {
-                _persistentAssets[ name ] = asset;
-            }
-            else {
-                _assets[ name ] = asset;
-            }
-        }
+        /**
+            \brief Adds an asset to the cache
+
+            The size is used to enforce the memory budget. If zero, the size
+            is estimated for well known types (like textures).
+
+            Persistent assets are never evicted and they don't count 
+            for the memory budget.
+         */
+        void set( std::string name, SharedPointer< SharedObject > const &asset, bool isPersistent = false, crimild::Size sizeInBytes = 0 );
         
+        /**
+            \brief Finds an asset in the cache
+
+            \remarks The returned pointer is only guaranteed to be valid until
+            the next call to step(), since assets are marked as used during 
+            the current frame and those are never evicted. Use retain() in 
+            order to keep the asset alive for longer.
+         */
         template< class T >
         T *get( std::string name )
         {
-            ScopedLock lock( _mutex );
-            
-            auto &asset = _assets[ name ];
+            return static_cast< T * >( lookup( name ) );
+        }
+
+        /**
+            \brief Finds an asset in the cache and returns a strong reference to it
+
+            Assets referenced this way are never evicted while the 
+            returned pointer is alive.
+         */
+        template< class T >
+        SharedPointer< T > retain( std::string name )
+        {
+            auto asset = std::static_pointer_cast< T >( acquire( name ) );
             if ( asset == nullptr ) {
-                asset = _persistentAssets[ name ];
+                // not cached yet, but specializations of get() might load it
+                asset = crimild::retain( get< T >( name ) );
             }
-            
-            return static_cast< T * >( crimild::get_ptr( asset ) );
+            return asset;
         }
 
         template< class T >
@@ -93,25 +131,184 @@ namespace crimild {
             return shallowCopy.getResult< T >();
         }
 
-        void clear( bool clearAll = false )
-        {
-            ScopedLock lock( _mutex );
-            
-            _assets.clear();
-            
-            if ( clearAll ) {
-                _persistentAssets.clear();
-            }
-        }
+        void clear( bool clearAll = false );
+
+    private:
+        /**
+            \brief Finds an asset and marks it as used in the current frame
+         */
+        SharedObject *lookup( std::string const &name );
+
+        /**
+            \brief Same as lookup(), but the reference is taken while holding the lock
+         */
+        SharedPointer< SharedObject > acquire( std::string const &name );
+        SharedPointer< SharedObject > find_unsafe( std::string const &name );
 
     private:
-        std::map< std::string, SharedPointer< SharedObject > > _assets;
+        struct CachedAsset {
+            SharedPointer< SharedObject > asset;
+            crimild::Size sizeInBytes = 0;
+            crimild::UInt64 lastUsedFrame = 0;
+        };
+
+        std::map< std::string, CachedAsset > _assets;
         std::map< std::string, SharedPointer< SharedObject > > _persistentAssets;
         
         Mutex _mutex;
 
     public:
         void loadFont( std::string name, std::string fileName );
+
+        /**
+            \name Asynchronous loading
+         */
+        //@{
+
+    public:
+        /**
+            \brief Registers a loader for files with the given extension
+
+            Extensions are specified without the dot (i.e. "obj"). Loaders
+            for TGA, PNG, KTX and DDS textures are registered by default 
+            (see ImageLoader::registerAssetLoaders())
+         */
+        void registerLoader( std::string extension, AssetLoader const &loader );
+
+        /**
+            \brief Sets the maximum number of I/O threads
+
+            Threads are created on demand the first time an asset is
+            requested. Must be set before requesting any asset.
+         */
+        void setMaxIOThreads( crimild::Size count ) { _maxIOThreads = count > 0 ? count : 1; }
+        crimild::Size getMaxIOThreads( void ) const { return _maxIOThreads; }
+
+        /**
+            \brief Requests an asset to be loaded in the background
+
+            Returns immediately with a handle for the request. The file is read
+            using the FileSystem and converted by the loader registered for its
+            extension in one of the I/O threads. Completion, including setting 
+            the asset in the cache, is delivered in the main thread via 
+            sync_frame(), so a JobScheduler instance is required.
+
+            Pending requests are served in order of priority (higher values
+            first) and then in the order they were made. Requesting an asset
+            that is already being loaded does not load it again, but the 
+            pending load is promoted if the new priority is higher.
+
+            If the asset is already in the cache the handle is returned
+            already loaded, but the callback is still delayed until the next
+            simulation step.
+         */
+        AssetRequestPtr loadAsync( std::string name, crimild::Int32 priority = 0, AssetRequest::Callback const &callback = nullptr );
+
+        /**
+            \brief Number of assets being loaded, including queued ones
+         */
+        crimild::Size getPendingLoadCount( void );
+
+    private:
+        friend class AssetRequest;
+
+        struct PendingLoad : public SharedObject {
+            std::string name;
+            crimild::Int32 priority = 0;
+            crimild::UInt64 sequence = 0;
+            crimild::Bool started = false;
+            crimild::Size sizeInBytes = 0;
+            std::vector< AssetRequestPtr > requests;
+        };
+
+        using PendingLoadPtr = SharedPointer< PendingLoad >;
+
+        struct PendingLoadOrder {
+            bool operator()( const PendingLoad *a, const PendingLoad *b ) const
+            {
+                if ( a->priority != b->priority ) {
+                    return a->priority > b->priority;
+                }
+                return a->sequence < b->sequence;
+            }
+        };
+
+        void cancel( AssetRequest *request );
+
+        void startIOThreads( void );
+        void stopIOThreads( void );
+        void runIOThread( void );
+
+        void completeLoad( PendingLoadPtr const &load, SharedPointer< SharedObject > const &asset );
+
+    private:
+        std::map< std::string, AssetLoader > _loaders;
+        std::map< std::string, PendingLoadPtr > _pendingLoads;
+        std::set< PendingLoad *, PendingLoadOrder > _loadQueue;
+        crimild::UInt64 _nextSequence = 0;
+
+        crimild::Size _maxIOThreads = 2;
+        std::vector< std::thread > _ioThreads;
+        std::condition_variable _ioCondition;
+        crimild::Bool _ioStopping = false;
+
+        //@}
+
+        /**
+            \name Memory budget
+         */
+        //@{
+
+    public:
+        struct Stats {
+            crimild::Size hits = 0;
+            crimild::Size misses = 0;
+            crimild::Size evictions = 0;
+            crimild::Size assetCount = 0;
+            crimild::Size usedBytes = 0;
+            crimild::Size memoryBudget = 0;
+        };
+
+        /**
+            \brief Sets the maximum size for non-persistent assets
+
+            When the budget is exceeded, the least recently used assets
+            that are not referenced anywhere else are evicted. Assets used
+            during the current frame are never evicted, since they might be
+            still in use through raw pointers. A value of zero (the default) 
+            means no budget.
+         */
+        void setMemoryBudget( crimild::Size bytes );
+        crimild::Size getMemoryBudget( void ) const { return _memoryBudget; }
+
+        /**
+            \brief Advances the frame counter used to track asset usage
+
+            Invoked by the simulation once per frame. Enforces the memory budget.
+         */
+        void step( void );
+
+        /**
+            \brief Evicts unreferenced assets
+
+            If there is a memory budget, assets are evicted only until the cache
+            fits in it. Otherwise, all unreferenced assets are evicted.
+         */
+        void trim( void );
+
+        Stats getStats( void );
+        void resetStats( void );
+
+    private:
+        void evict( crimild::Size targetBytes );
+
+    private:
+        crimild::UInt64 _frame = 0;
+        crimild::Size _memoryBudget = 0;
+        crimild::Size _usedBytes = 0;
+        Stats _stats;
+
+        //@}
     };
 
     template<>
@@ -0,0 +1,105 @@
+/*
+ * Copyright (c) 2013, Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef CRIMILD_CORE_SIMULATION_ASSET_REQUEST_
+#define CRIMILD_CORE_SIMULATION_ASSET_REQUEST_
+
+#include "Foundation/SharedObject.hpp"
+#include "Foundation/Types.hpp"
+
+#include <functional>
+#include <string>
+
+namespace crimild {
+
+	class AssetManager;
+
+	/**
+		\brief A handle for an asset that is being loaded in the background
+
+		Requests are created by AssetManager::loadAsync() and are completed
+		in the main thread, at the beginning of a simulation step. Handles
+		are not thread-safe and should only be used from the main thread.
+
+		The asset is retained by the request, so it remains valid for as
+		long as the handle is alive.
+	*/
+	class AssetRequest : public SharedObject {
+	public:
+		enum class State {
+			PENDING,
+			LOADED,
+			FAILED,
+			CANCELLED,
+		};
+
+		using Callback = std::function< void( AssetRequest * ) >;
+
+	public:
+		AssetRequest( std::string name, Callback const &callback );
+		virtual ~AssetRequest( void );
+
+		const std::string &getName( void ) const { return _name; }
+
+		State getState( void ) const { return _state; }
+
+		crimild::Bool isDone( void ) const { return _state != State::PENDING; }
+
+		template< class T >
+		T *getAsset( void )
+		{
+			return static_cast< T * >( crimild::get_ptr( _asset ) );
+		}
+
+		/**
+			\brief Cancels the request
+
+			The callback will not be invoked after cancelling. The actual
+			load is aborted only if no other requests are waiting for the 
+			same asset. Does nothing if the request is already done.
+		*/
+		void cancel( void );
+
+	private:
+		friend class AssetManager;
+
+		void resolve( SharedPointer< SharedObject > const &asset );
+		void notify( void );
+
+	private:
+		std::string _name;
+		Callback _callback;
+		State _state = State::PENDING;
+		SharedPointer< SharedObject > _asset;
+	};
+
+	using AssetRequestPtr = SharedPointer< AssetRequest >;
+
+}
+
+#endif
+
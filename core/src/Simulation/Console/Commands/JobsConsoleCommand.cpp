@@ -0,0 +1,124 @@
+/*
+ * Copyright (c) 2013, Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "JobsConsoleCommand.hpp"
+
+#include "../Console.hpp"
+
+#include "Concurrency/JobScheduler.hpp"
+#include "Foundation/StringUtils.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <iomanip>
+#include <sstream>
+
+using namespace crimild;
+using namespace crimild::concurrency;
+
+JobsConsoleCommand::JobsConsoleCommand( void )
+	: ConsoleCommand( "jobs" )
+{
+
+}
+
+JobsConsoleCommand::~JobsConsoleCommand( void )
+{
+
+}
+
+void JobsConsoleCommand::execute( Console *console, ConsoleCommand::ConsoleCommandArgs const &args )
+{
+	auto scheduler = JobScheduler::getInstance();
+	if ( scheduler == nullptr ) {
+		console->pushLine( "Job scheduler not available" );
+		return;
+	}
+
+	std::string action = args.size() > 0 ? args[ 0 ] : "";
+	if ( action == "trace" ) {
+		auto enabled = args.size() > 1 && args[ 1 ] == "on";
+		scheduler->setTracingEnabled( enabled );
+		console->pushLine( enabled ? "Job tracing enabled" : "Job tracing disabled" );
+		return;
+	}
+
+	if ( !scheduler->isTracingEnabled() ) {
+		console->pushLine( "Job tracing is disabled. Use 'jobs trace on' first" );
+		return;
+	}
+
+	const auto &frame = scheduler->getLastFrameTrace();
+
+	if ( action == "list" ) {
+		crimild::Size count = args.size() > 1 ? std::max( 1, std::atoi( args[ 1 ].c_str() ) ) : 10;
+
+		auto jobs = frame.jobs;
+		std::sort( jobs.begin(), jobs.end(), []( JobScheduler::JobRecord const &a, JobScheduler::JobRecord const &b ) {
+			return ( a.endTime - a.startTime ) > ( b.endTime - b.startTime );
+		});
+
+		for ( crimild::Size i = 0; i < std::min( count, jobs.size() ); i++ ) {
+			const auto &job = jobs[ i ];
+			std::stringstream ss;
+			ss << std::setiosflags( std::ios::fixed ) << std::setprecision( 3 )
+			   << "   #" << job.jobId
+			   << " " << ( job.name.empty() ? "<unnamed>" : job.name )
+			   << " parent: " << job.parentId
+			   << " worker: " << job.workerIndex
+			   << " wait: " << 1.0e-6 * ( job.startTime - job.scheduledTime ) << "ms"
+			   << " run: " << 1.0e-6 * ( job.endTime - job.startTime ) << "ms"
+			   << ( job.stolen ? " (stolen)" : "" );
+			console->pushLine( ss.str() );
+		}
+		return;
+	}
+
+	std::stringstream ss;
+	ss << std::setiosflags( std::ios::fixed ) << std::setprecision( 3 )
+	   << "Frame: " << 1000.0 * frame.frameTime << "ms"
+	   << " Jobs: " << frame.jobCount
+	   << " Work: " << 1000.0 * frame.totalWork << "ms"
+	   << " Critical path: " << 1000.0 * frame.criticalPath << "ms";
+	if ( frame.droppedCount > 0 ) {
+		ss << " Dropped: " << frame.droppedCount;
+	}
+	console->pushLine( ss.str() );
+
+	for ( const auto &worker : frame.workers ) {
+		std::stringstream line;
+		line << std::setiosflags( std::ios::fixed ) << std::setprecision( 1 )
+			 << "   " << worker.name
+			 << ": busy " << 100.0 * worker.utilization << "%"
+			 << " idle " << 100.0 * worker.getIdle() << "%"
+			 << " jobs " << worker.jobCount
+			 << " (" << worker.stolenCount << " stolen)";
+		console->pushLine( line.str() );
+	}
+}
+
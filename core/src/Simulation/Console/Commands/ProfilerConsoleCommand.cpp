@@ -0,0 +1,82 @@
+/*
+ * Copyright (c) 2013, Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "ProfilerConsoleCommand.hpp"
+
+#include "../Console.hpp"
+
+#include "Foundation/Profiler.hpp"
+#include "Foundation/StringUtils.hpp"
+
+using namespace crimild;
+
+ProfilerConsoleCommand::ProfilerConsoleCommand( void )
+	: ConsoleCommand( "profiler" )
+{
+
+}
+
+ProfilerConsoleCommand::~ProfilerConsoleCommand( void )
+{
+
+}
+
+void ProfilerConsoleCommand::execute( Console *console, ConsoleCommand::ConsoleCommandArgs const &args )
+{
+	auto profiler = Profiler::getInstance();
+	if ( profiler == nullptr ) {
+		console->pushLine( "Profiler not available" );
+		return;
+	}
+
+	std::string action = args.size() > 0 ? args[ 0 ] : "";
+	if ( action == "start" ) {
+		profiler->beginCapture();
+		console->pushLine( "Profiler capture started" );
+	}
+	else if ( action == "stop" ) {
+		if ( !profiler->isCapturing() ) {
+			console->pushLine( "Profiler is not capturing" );
+			return;
+		}
+
+		profiler->endCapture();
+
+		std::string fileName = args.size() > 1 ? args[ 1 ] : "profile.json";
+		if ( profiler->exportChromeTrace( fileName ) ) {
+			console->pushLine( StringUtils::toString( "Profiler capture saved to ", fileName, " (", profiler->getCapturedSampleCount(), " samples)" ) );
+		}
+		else {
+			console->pushLine( "Cannot save profiler capture to " + fileName );
+		}
+	}
+	else {
+		console->pushLine( "Usage: profiler start|stop [fileName]" );
+	}
+}
+
@@ -28,6 +28,8 @@
 #include "Console.hpp"
 
 #include "Commands/EchoConsoleCommand.hpp"
+#include "Commands/JobsConsoleCommand.hpp"
+#include "Commands/ProfilerConsoleCommand.hpp"
 #include "Commands/SetConsoleCommand.hpp"
 
 #include "Mathematics/Numeric.hpp"
@@ -54,6 +56,8 @@ Console::Console( void )
 
 	registerCommand( crimild::alloc< EchoConsoleCommand >() );
 	registerCommand( crimild::alloc< SetConsoleCommand >() );
+	registerCommand( crimild::alloc< ProfilerConsoleCommand >() );
+	registerCommand( crimild::alloc< JobsConsoleCommand >() );
 
 	pushLine( Simulation::getInstance()->getName() );
 
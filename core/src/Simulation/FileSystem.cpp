@@ -31,6 +31,8 @@
 
 #include "Mathematics/Numeric.hpp"
 
+#include <cstdio>
+
 using namespace crimild;
 
 FileSystem &FileSystem::getInstance( void )
@@ -146,3 +148,29 @@ std::string FileSystem::getFileName( std::string path, bool includeExtension )
 	return path;
 }
 
+crimild::Bool FileSystem::readFile( std::string const &path, containers::ByteArray &data )
+{
+	if ( _fileReader != nullptr ) {
+		return _fileReader( path, data );
+	}
+
+	auto file = std::fopen( path.c_str(), "rb" );
+	if ( file == nullptr ) {
+		return false;
+	}
+
+	std::fseek( file, 0, SEEK_END );
+	auto length = std::ftell( file );
+	std::fseek( file, 0, SEEK_SET );
+	if ( length < 0 ) {
+		std::fclose( file );
+		return false;
+	}
+
+	data.resize( length );
+	auto read = length > 0 ? std::fread( data.getData(), 1, length, file ) : 0;
+	std::fclose( file );
+
+	return read == static_cast< crimild::Size >( length );
+}
+
@@ -28,6 +28,9 @@
 #ifndef CRIMILD_SIMULATION_FILE_SYSTEM_
 #define CRIMILD_SIMULATION_FILE_SYSTEM_
 
+#include "Foundation/Containers/Array.hpp"
+
+#include <functional>
 #include <string>
 
 namespace crimild {
@@ -36,6 +39,8 @@ namespace crimild {
 	public:
 		static FileSystem &getInstance( void );
 
+		using FileReader = std::function< crimild::Bool( std::string const &path, containers::ByteArray &data ) >;
+
 	private:
 		FileSystem( void );
 		~FileSystem( void );
@@ -76,9 +81,29 @@ namespace crimild {
 
         std::string getFileName( std::string path, bool includeExtension = true );
 
+		/**
+			\brief Reads the entire contents of a file
+
+			Files are read using the current file reader, which defaults
+			to reading from disk. This method can be invoked from any thread.
+
+			\returns true if the file was read successfully
+		*/
+		crimild::Bool readFile( std::string const &path, containers::ByteArray &data );
+
+		/**
+			\brief Overrides how files are read
+
+			Useful for reading from archives or for faking file contents
+			in tests. Passing nullptr restores the default reader. The 
+			reader must be set before any reads are in flight.
+		*/
+		void setFileReader( FileReader const &reader ) { _fileReader = reader; }
+
 	private:
 		std::string _baseDirectory;
         std::string _documentsDirectory;
+		FileReader _fileReader;
 
 	};
 
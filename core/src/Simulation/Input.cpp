@@ -33,6 +33,9 @@
 using namespace crimild;
 using namespace crimild::messaging;
 
+constexpr StringId Input::AXIS_HORIZONTAL;
+constexpr StringId Input::AXIS_VERTICAL;
+
 Input::Input( void )
 {
 	reset( CRIMILD_INPUT_KEY_LAST, CRIMILD_INPUT_MOUSE_BUTTON_LAST );
@@ -31,10 +31,11 @@
 #include "Mathematics/Vector.hpp"
 
 #include "Foundation/Singleton.hpp"
+#include "Foundation/StringId.hpp"
 #include "Messaging/MessageQueue.hpp"
 
 #include <vector>
-#include <map>
+#include <unordered_map>
 
 // This codes are ment to match those of GLFW to avoid translation tables
 #define CRIMILD_INPUT_KEY_UNKNOWN            -1
@@ -271,14 +272,28 @@ namespace crimild {
 		MouseCursorMode _mouseCursorMode;
 
 	public:
-		static constexpr const char *AXIS_HORIZONTAL = "Horizontal";
-		static constexpr const char *AXIS_VERTICAL = "Vertical";
-
-		void setAxis( std::string key, float value ) { _axes[ key ] = value; }
-		float getAxis( std::string key ) { return _axes[ key ]; }
+		static constexpr StringId AXIS_HORIZONTAL = StringId( "Horizontal" );
+		static constexpr StringId AXIS_VERTICAL = StringId( "Vertical" );
+
+		/**
+			\brief Axes are indexed by hashed ids
+
+			Strings are still supported as keys, but using compile-time ids 
+			(like the ones above) avoids hashing them on every call.
+		*/
+		void setAxis( StringId key, float value ) { _axes[ key.getHash() ] = value; }
+
+		/**
+			\returns 0 if the axis has not been set
+		*/
+		float getAxis( StringId key ) const
+		{
+			auto it = _axes.find( key.getHash() );
+			return it != _axes.end() ? it->second : 0.0f;
+		}
 
 	private:
-		std::map< std::string, float > _axes;
+		std::unordered_map< StringId::Hash, float > _axes;
 
 	public:
 		bool joystickIsPresent( void ) const { return _joystickAxes.size(); }
@@ -28,6 +28,9 @@
 #include "Settings.hpp"
 #include "FileSystem.hpp"
 
+#include <algorithm>
+#include <vector>
+
 using namespace crimild;
 
 const char *Settings::SETTINGS_RENDERING_SHADOWS_ENABLED = "crimild.rendering.shadows.enabled";
@@ -56,7 +59,7 @@ void Settings::parseCommandLine(int argc, char **argv)
 	}
 
 	if (argc > 0) {
-		_settings["__base_directory"] = FileSystem::getInstance().getBaseDirectory();
+		set( "__base_directory", FileSystem::getInstance().getBaseDirectory() );
 	}
 
 	for (int i = 1; i < argc; i++) {
@@ -69,15 +72,39 @@ void Settings::parseCommandLine(int argc, char **argv)
 		}
 	}
 
-	for (auto it : _settings) {
-		Log::debug(CRIMILD_CURRENT_CLASS_NAME, it.first, " -> ", it.second);
-	}
+	each( []( std::string key, Settings *settings ) {
+		Log::debug( CRIMILD_CURRENT_CLASS_NAME, key, " -> ", settings->get( key, "" ) );
+	});
 }
 
 void Settings::each(std::function< void(std::string, Settings *) > callback)
 {
-	for (auto it : _settings) {
-		callback(it.first, this);
+	// Keys are sorted so they are always listed in the same order. Also, callbacks
+	// are allowed to modify values while iterating
+	std::vector< std::string > keys;
+	keys.reserve( _settings.size() );
+	for ( const auto &it : _settings ) {
+		keys.push_back( it.second.key );
+	}
+	std::sort( keys.begin(), keys.end() );
+
+	for ( const auto &key : keys ) {
+		callback( key, this );
 	}
 }
 
+Variant &Settings::getOrCreateValue( StringId key )
+{
+	auto &setting = _settings[ key.getHash() ];
+	if ( setting.key.empty() ) {
+		setting.key = key.getName();
+	}
+	return setting.value;
+}
+
+const Variant *Settings::findValue( StringId key ) const
+{
+	auto it = _settings.find( key.getHash() );
+	return it != _settings.end() ? &it->second.value : nullptr;
+}
+
@@ -30,10 +30,12 @@
 
 #include "Foundation/Log.hpp"
 #include "Foundation/Memory.hpp"
+#include "Foundation/StringId.hpp"
+#include "Foundation/Variant.hpp"
 
+#include <functional>
 #include <string>
-#include <sstream>
-#include <map>
+#include <unordered_map>
 
 namespace crimild {
 
@@ -54,70 +56,71 @@ namespace crimild {
         
         virtual void save( std::string filename ) { }
 
-		void set(std::string key, std::string value)
-		{
-			_settings[key] = value;
-		}
+		/**
+			\name Values
 
-		void set(std::string key, const char *value)
-		{
-			set(key, std::string(value));
-		}
+			Values are stored using hashed keys and typed slots, so reading
+			them every frame does not require string comparisons or parsing.
+			Prefer compile-time ids for keys used in hot paths:
+
+			\code
+			static constexpr StringId VIDEO_WIDTH( "video.width" );
+			auto width = settings->get( VIDEO_WIDTH, 1024 );
+			\endcode
+
+			Plain strings are still supported, since they are implicitly 
+			converted to ids.
+		*/
+		//@{
 
 		template< typename T >
-		void set( std::string key, T value )
+		void set( StringId key, T value )
 		{
-			std::stringstream str;
-			str << value;
-			_settings[ key ] = str.str();
+			getOrCreateValue( key ).set( value );
 		}
-		
-        bool hasKey( std::string key )
-        {
-            return ( _settings.find( key ) != _settings.end() );
-        }
 
-		std::string get(std::string key, const char *defaultValue)
+		bool hasKey( StringId key ) const
 		{
-			if (_settings.find(key) == _settings.end()) {
-				// key not found
-				return defaultValue;
-			}
-
-			return _settings[key];
+			return findValue( key ) != nullptr;
 		}
 
-		std::string get(std::string key, std::string defaultValue)
+		std::string get( StringId key, const char *defaultValue ) const
 		{
-			if (_settings.find(key) == _settings.end()) {
-				// key not found
-				return defaultValue;
-			}
+			auto value = findValue( key );
+			return value != nullptr ? value->getString() : defaultValue;
+		}
 
-			return _settings[key];
+		std::string get( StringId key, std::string defaultValue ) const
+		{
+			auto value = findValue( key );
+			return value != nullptr ? value->getString() : defaultValue;
 		}
 
 		template< typename T >
-		T get( std::string key, T defaultValue )
+		T get( StringId key, T defaultValue ) const
 		{
-			if ( !hasKey( key ) ) {
-				// key not found
-				return defaultValue;
-			}
-			
-			std::stringstream str;
-			str << _settings[ key ];
-			T value;
-			str >> value;
-			return value;
+			auto value = findValue( key );
+			return value != nullptr ? value->get< T >() : defaultValue;
 		}
 
+	private:
+		Variant &getOrCreateValue( StringId key );
+		const Variant *findValue( StringId key ) const;
+
+		//@}
+
+	public:
 		void parseCommandLine( int argc, char **argv );
         
         void each( std::function< void( std::string, Settings * ) > callback );
 
 	private:
-		std::map< std::string, std::string > _settings;
+		struct Setting {
+			std::string key;
+			Variant value;
+		};
+
+		std::unordered_map< StringId::Hash, Setting > _settings;
 	};
 
     using SettingsPtr = SharedPointer< Settings >;
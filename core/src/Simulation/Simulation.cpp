@@ -132,6 +132,9 @@ void Simulation::start( void )
 
 bool Simulation::update( void )
 {
+    // frame boundary for job tracing
+    _jobScheduler.step();
+
     auto scene = getScene();
 
 	if ( scene != nullptr && Camera::getMainCamera() == nullptr ) {
@@ -148,6 +151,8 @@ bool Simulation::update( void )
     broadcastMessage( messaging::SimulationWillUpdate { scene } );
     
     _jobScheduler.executeDelayedJobs();
+
+    _assetManager.step();
     
     broadcastMessage( messaging::SimulationDidUpdate { scene } );
     
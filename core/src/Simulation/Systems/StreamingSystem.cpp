@@ -32,9 +32,20 @@
  
 #include "Concurrency/Async.hpp"
 
+#include "SceneGraph/Group.hpp"
+#include "SceneGraph/Camera.hpp"
+#include "Visitors/Apply.hpp"
+#include "Visitors/StartComponents.hpp"
+#include "Visitors/UpdateWorldState.hpp"
+#include "Visitors/UpdateRenderState.hpp"
+
+#include <algorithm>
+#include <cmath>
+
 using namespace crimild;
 
 StreamingSystem::StreamingSystem( void )
+	: _streamingRoot( crimild::alloc< Group >( "Streaming Root" ) )
 {
 	CRIMILD_BIND_MEMBER_MESSAGE_HANDLER( messaging::LoadScene, StreamingSystem, onLoadScene );
 	CRIMILD_BIND_MEMBER_MESSAGE_HANDLER( messaging::AppendScene, StreamingSystem, onAppendScene );
@@ -43,17 +54,23 @@ StreamingSystem::StreamingSystem( void )
 
 StreamingSystem::~StreamingSystem( void )
 {
-
+    discardPendingCells();
 }
 
 bool StreamingSystem::start( void )
 {
-    return System::start();
+    if ( !System::start() ) {
+        return false;
+    }
+
+    crimild::concurrency::sync_frame( std::bind( &StreamingSystem::update, this ) );
+
+    return true;
 }
 
 void StreamingSystem::stop( void )
 {
-
+    discardPendingCells();
 }
 
 void StreamingSystem::onLoadScene( messaging::LoadScene const &message )
@@ -62,7 +79,7 @@ void StreamingSystem::onLoadScene( messaging::LoadScene const &message )
     auto fileType = StringUtils::getFileExtension( fileName );
 
     if ( !_builders.contains( fileType ) ) {
-        std::string message = "Cannot find builder for file" + fileName;
+        std::string message = "Cannot find builder for file " + fileName;
         crimild::Log::error( CRIMILD_CURRENT_CLASS_NAME, message );
         broadcastMessage( messaging::SceneLoadFailed { fileName, message } );
         return;
@@ -72,8 +89,6 @@ void StreamingSystem::onLoadScene( messaging::LoadScene const &message )
     auto builder = _builders[ fileType ];
 
     crimild::concurrency::async_frame( [ builder, fileName ] {
-        AssetManager::getInstance()->clear();
-
         auto scene = builder( fileName );
         if ( scene == nullptr ) {
             std::string message = "Cannot load scene from file: " + fileName;
@@ -84,13 +99,32 @@ void StreamingSystem::onLoadScene( messaging::LoadScene const &message )
         
         crimild::concurrency::sync_frame( [ scene ] {
             Simulation::getInstance()->setScene( scene );
+
+            // Keep assets shared with the new scene
+            AssetManager::getInstance()->trim();
         });
     });
 }
 
 void StreamingSystem::onAppendScene( messaging::AppendScene const &message )
 {
-    // TODO
+    auto fileName = message.fileName;
+    auto fileType = StringUtils::getFileExtension( fileName );
+
+    if ( !_builders.contains( fileType ) ) {
+        std::string message = "Cannot find builder for file " + fileName;
+        crimild::Log::error( CRIMILD_CURRENT_CLASS_NAME, message );
+        broadcastMessage( messaging::SceneLoadFailed { fileName, message } );
+        return;
+    }
+
+    // appended scenes are attached using the same budget as cells
+    auto cell = crimild::alloc< StreamingCell >();
+    cell->fileName = fileName;
+    if ( message.parentNode != nullptr ) {
+        cell->parent = crimild::retain( message.parentNode );
+    }
+    loadCell( cell, _builders[ fileType ] );
 }
 
 void StreamingSystem::onReloadScene( messaging::ReloadScene const &message )
@@ -99,7 +133,7 @@ void StreamingSystem::onReloadScene( messaging::ReloadScene const &message )
     auto fileType = StringUtils::getFileExtension( fileName );
 
     if ( !_builders.contains( fileType ) ) {
-        std::string message = "Cannot find builder for file" + fileName;
+        std::string message = "Cannot find builder for file " + fileName;
         crimild::Log::error( CRIMILD_CURRENT_CLASS_NAME, message );
         broadcastMessage( messaging::SceneLoadFailed { fileName, message } );
         return;
@@ -111,8 +145,6 @@ void StreamingSystem::onReloadScene( messaging::ReloadScene const &message )
         Simulation::getInstance()->setScene( nullptr );
 
         crimild::concurrency::async_frame( [ builder, fileName ] {
-            AssetManager::getInstance()->clear();
-
             auto scene = builder( fileName );
             if ( scene == nullptr ) {
                 std::string message = "Cannot load scene from file: " + fileName;
@@ -123,8 +155,236 @@ void StreamingSystem::onReloadScene( messaging::ReloadScene const &message )
             
             crimild::concurrency::sync_frame( [ scene ] {
                 Simulation::getInstance()->setScene( scene );
+                AssetManager::getInstance()->trim();
             });
         });        
     });
 }
 
+void StreamingSystem::setWorldGrid( crimild::Real32 cellSize, CellResolver const &resolver )
+{
+    for ( auto &it : _cells ) {
+        unloadCell( it.second );
+    }
+    _cells.clear();
+
+    _cellSize = cellSize;
+    _cellResolver = resolver;
+}
+
+void StreamingSystem::update( void )
+{
+    CRIMILD_PROFILE( "Streaming System" )
+
+    auto scene = dynamic_cast< Group * >( Simulation::getInstance()->getScene() );
+    if ( scene != nullptr ) {
+        auto camera = Camera::getMainCamera();
+        if ( camera != nullptr ) {
+            updateCells( scene, camera->getWorld().getTranslate() );
+        }
+        attachReadyNodes( scene );
+    }
+
+    // schedule next update
+    crimild::concurrency::sync_frame( std::bind( &StreamingSystem::update, this ) );
+}
+
+void StreamingSystem::updateStreaming( Group *scene, const Vector3f &viewerPosition )
+{
+    updateCells( scene, viewerPosition );
+    attachReadyNodes( scene );
+}
+
+void StreamingSystem::updateCells( Group *scene, const Vector3f &viewerPosition )
+{
+    if ( _cellResolver == nullptr || _cellSize <= 0 ) {
+        return;
+    }
+
+    if ( _streamingRoot->getParent() != scene ) {
+        // the scene changed, but cells are still valid
+        if ( auto parent = dynamic_cast< Group * >( _streamingRoot->getParent() ) ) {
+            parent->detachNode( _streamingRoot );
+        }
+        scene->attachNode( _streamingRoot );
+    }
+
+    // unload cells first, including the ones that are still loading
+    auto unloadRadius = Numericf::max( _unloadRadius, _loadRadius );
+    for ( auto it = _cells.begin(); it != _cells.end(); ) {
+        if ( computeCellDistance( it->first, viewerPosition ) > unloadRadius ) {
+            unloadCell( it->second );
+            it = _cells.erase( it );
+        }
+        else {
+            ++it;
+        }
+    }
+
+    // request missing cells, closest ones first
+    std::vector< std::pair< crimild::Real32, CellCoords > > requests;
+    auto x0 = static_cast< crimild::Int32 >( std::floor( ( viewerPosition[ 0 ] - _loadRadius ) / _cellSize ) );
+    auto x1 = static_cast< crimild::Int32 >( std::floor( ( viewerPosition[ 0 ] + _loadRadius ) / _cellSize ) );
+    auto z0 = static_cast< crimild::Int32 >( std::floor( ( viewerPosition[ 2 ] - _loadRadius ) / _cellSize ) );
+    auto z1 = static_cast< crimild::Int32 >( std::floor( ( viewerPosition[ 2 ] + _loadRadius ) / _cellSize ) );
+    for ( auto z = z0; z <= z1; z++ ) {
+        for ( auto x = x0; x <= x1; x++ ) {
+            auto coords = std::make_pair( x, z );
+            if ( _cells.find( coords ) != _cells.end() ) {
+                continue;
+            }
+
+            auto distance = computeCellDistance( coords, viewerPosition );
+            if ( distance <= _loadRadius ) {
+                requests.push_back( std::make_pair( distance, coords ) );
+            }
+        }
+    }
+
+    std::sort( requests.begin(), requests.end() );
+
+    for ( auto &request : requests ) {
+        auto cell = crimild::alloc< StreamingCell >();
+        cell->parent = _streamingRoot;
+        _cells[ request.second ] = cell;
+
+        cell->fileName = _cellResolver( request.second.first, request.second.second );
+        if ( cell->fileName == "" ) {
+            // empty cell. Keep it so it's not requested again
+            cell->state = StreamingCell::State::FAILED;
+            continue;
+        }
+
+        auto fileType = StringUtils::getFileExtension( cell->fileName );
+        if ( !_builders.contains( fileType ) ) {
+            crimild::Log::error( CRIMILD_CURRENT_CLASS_NAME, "Cannot find builder for file ", cell->fileName );
+            cell->state = StreamingCell::State::FAILED;
+            continue;
+        }
+
+        loadCell( cell, _builders[ fileType ] );
+    }
+}
+
+void StreamingSystem::attachReadyNodes( Group *scene )
+{
+    crimild::Size attachedCount = 0;
+    while ( !_ready.empty() ) {
+        auto cell = _ready.front();
+        if ( cell->discarded ) {
+            _ready.pop_front();
+            continue;
+        }
+
+        if ( _maxNodesAttachedPerFrame > 0 && attachedCount > 0 && attachedCount + cell->nodeCount > _maxNodesAttachedPerFrame ) {
+            // continue next frame
+            break;
+        }
+
+        _ready.pop_front();
+
+        auto parent = cell->parent != nullptr ? dynamic_cast< Group * >( crimild::get_ptr( cell->parent ) ) : scene;
+        if ( parent == nullptr ) {
+            crimild::Log::error( CRIMILD_CURRENT_CLASS_NAME, "Cannot attach ", cell->fileName, " since parent is not a group" );
+            cell->state = StreamingCell::State::FAILED;
+            continue;
+        }
+
+        parent->attachNode( cell->node );
+        cell->state = StreamingCell::State::ATTACHED;
+        attachedCount += cell->nodeCount;
+
+        auto node = crimild::get_ptr( cell->node );
+        node->perform( UpdateWorldState() );
+        node->perform( UpdateRenderState() );
+        node->perform( StartComponents() );
+        node->perform( UpdateWorldState() );
+    }
+}
+
+crimild::Real32 StreamingSystem::computeCellDistance( CellCoords const &coords, const Vector3f &viewerPosition ) const
+{
+    // distance to the closest point in the cell
+    auto minX = coords.first * _cellSize;
+    auto minZ = coords.second * _cellSize;
+    auto dx = Numericf::max( 0.0f, Numericf::max( minX - viewerPosition[ 0 ], viewerPosition[ 0 ] - ( minX + _cellSize ) ) );
+    auto dz = Numericf::max( 0.0f, Numericf::max( minZ - viewerPosition[ 2 ], viewerPosition[ 2 ] - ( minZ + _cellSize ) ) );
+    return std::sqrt( dx * dx + dz * dz );
+}
+
+void StreamingSystem::loadCell( StreamingCellPtr const &cell, Builder const &builder )
+{
+    _loading.insert( cell );
+
+    crimild::concurrency::async( [ this, cell, builder ] {
+        auto node = builder( cell->fileName );
+
+        crimild::Size nodeCount = 0;
+        if ( node != nullptr ) {
+            node->perform( Apply( [ &nodeCount ]( Node * ) { ++nodeCount; } ) );
+        }
+
+        crimild::concurrency::sync_frame( [ this, cell, node, nodeCount ] {
+            // cells are discarded when the system is stopped or destroyed,
+            // so 'this' must not be used unless the cell is still valid
+            if ( !cell->discarded ) {
+                onCellLoaded( cell, node, nodeCount );
+            }
+        });
+    });
+}
+
+void StreamingSystem::onCellLoaded( StreamingCellPtr const &cell, SharedPointer< Node > const &node, crimild::Size nodeCount )
+{
+    _loading.erase( cell );
+
+    if ( node == nullptr ) {
+        std::string message = "Cannot load scene from file: " + cell->fileName;
+        crimild::Log::error( CRIMILD_CURRENT_CLASS_NAME, message );
+        broadcastMessage( messaging::SceneLoadFailed { cell->fileName, message } );
+        cell->state = StreamingCell::State::FAILED;
+        return;
+    }
+
+    cell->node = node;
+    cell->nodeCount = nodeCount;
+    cell->state = StreamingCell::State::READY;
+    _ready.push_back( cell );
+}
+
+void StreamingSystem::unloadCell( StreamingCellPtr const &cell )
+{
+    cell->discarded = true;
+    _loading.erase( cell );
+
+    if ( cell->state == StreamingCell::State::ATTACHED ) {
+        if ( auto parent = dynamic_cast< Group * >( cell->node->getParent() ) ) {
+            parent->detachNode( cell->node );
+        }
+    }
+
+    cell->node = nullptr;
+}
+
+void StreamingSystem::discardPendingCells( void )
+{
+    for ( auto &cell : _loading ) {
+        cell->discarded = true;
+    }
+    _loading.clear();
+
+    for ( auto &cell : _ready ) {
+        cell->discarded = true;
+    }
+    _ready.clear();
+
+    // discarded cells are requested again if streaming is restarted
+    for ( auto it = _cells.begin(); it != _cells.end(); ) {
+        if ( it->second->discarded ) {
+            it = _cells.erase( it );
+        }
+        else {
+            ++it;
+        }
+    }
+}
@@ -31,10 +31,17 @@
 #include "System.hpp"
 
 #include "Foundation/Containers/Map.hpp"
+#include "Mathematics/Vector.hpp"
+
+#include <deque>
+#include <map>
+#include <set>
+#include <utility>
 
 namespace crimild {
 
 	class Node;
+	class Group;
 
 	namespace messaging {
 
@@ -97,6 +104,129 @@ namespace crimild {
 	private:
 		containers::Map< std::string, Builder > _builders;
 		std::string _lastSceneFileName;
+
+		/**
+			\name World streaming
+		*/
+		//@{
+
+	public:
+		/**
+			\brief Resolves the file for a given cell
+
+			Returns an empty string if there is no cell at that position
+		*/
+		using CellResolver = std::function< std::string( crimild::Int32 x, crimild::Int32 z ) >;
+
+		/**
+			\brief Enables streaming of a world partitioned in a grid
+
+			Cells are squares on the XZ plane. Cell (0, 0) starts at the origin.
+			Files are built in background threads using the registered builders 
+			and their contents are attached to the streaming root.
+		*/
+		void setWorldGrid( crimild::Real32 cellSize, CellResolver const &resolver );
+
+		/**
+			\brief Cells closer than this distance to the camera are loaded
+		*/
+		void setLoadRadius( crimild::Real32 radius ) { _loadRadius = radius; }
+		crimild::Real32 getLoadRadius( void ) const { return _loadRadius; }
+
+		/**
+			\brief Cells farther than this distance to the camera are unloaded
+
+			Should be larger than the load radius to avoid reloading cells
+			when the camera is moving around a cell boundary.
+		*/
+		void setUnloadRadius( crimild::Real32 radius ) { _unloadRadius = radius; }
+		crimild::Real32 getUnloadRadius( void ) const { return _unloadRadius; }
+
+		/**
+			\brief Limits how many nodes are attached (and started) per frame
+
+			At least one loaded cell is attached each frame, no matter its
+			size. A value of zero means no limit.
+		*/
+		void setMaxNodesAttachedPerFrame( crimild::Size count ) { _maxNodesAttachedPerFrame = count; }
+		crimild::Size getMaxNodesAttachedPerFrame( void ) const { return _maxNodesAttachedPerFrame; }
+
+		/**
+			\brief The group where cells are attached to
+
+			The streaming root is attached to the current scene.
+		*/
+		Group *getStreamingRoot( void ) { return crimild::get_ptr( _streamingRoot ); }
+
+		/**
+			\brief Loads and unloads cells around a position
+
+			Also attaches loaded content, including appended scenes. Invoked every 
+			frame using the main camera position.
+		*/
+		void updateStreaming( Group *scene, const Vector3f &viewerPosition );
+
+		/**
+			\brief Number of cells that are loaded, loading or waiting to be attached
+		*/
+		crimild::Size getCellCount( void ) const { return _cells.size(); }
+
+		/**
+			\brief Number of cells and scenes that are loaded and waiting to be attached
+		*/
+		crimild::Size getReadyCount( void ) const { return _ready.size(); }
+
+	private:
+		struct StreamingCell : public SharedObject {
+			enum class State {
+				LOADING,
+				READY,
+				ATTACHED,
+				FAILED,
+			};
+
+			std::string fileName;
+			State state = State::LOADING;
+			crimild::Bool discarded = false;
+			SharedPointer< Node > parent;
+			SharedPointer< Node > node;
+			crimild::Size nodeCount = 0;
+		};
+
+		using StreamingCellPtr = SharedPointer< StreamingCell >;
+		using CellCoords = std::pair< crimild::Int32, crimild::Int32 >;
+
+		void update( void );
+		void updateCells( Group *scene, const Vector3f &viewerPosition );
+		void attachReadyNodes( Group *scene );
+
+		crimild::Real32 computeCellDistance( CellCoords const &coords, const Vector3f &viewerPosition ) const;
+
+		void loadCell( StreamingCellPtr const &cell, Builder const &builder );
+		void onCellLoaded( StreamingCellPtr const &cell, SharedPointer< Node > const &node, crimild::Size nodeCount );
+		void unloadCell( StreamingCellPtr const &cell );
+
+		/**
+			\brief Discards cells that are still loading or waiting to be attached
+
+			Background loads may finish after the system is stopped or destroyed,
+			so their results are ignored instead.
+		*/
+		void discardPendingCells( void );
+
+	private:
+		crimild::Real32 _cellSize = 0;
+		CellResolver _cellResolver;
+		crimild::Real32 _loadRadius = 0;
+		crimild::Real32 _unloadRadius = 0;
+		crimild::Size _maxNodesAttachedPerFrame = 0;
+
+		SharedPointer< Group > _streamingRoot;
+		std::map< CellCoords, StreamingCellPtr > _cells;
+		std::deque< StreamingCellPtr > _ready;
+		std::set< StreamingCellPtr > _loading;
+
+		//@}
 	};
 
 }
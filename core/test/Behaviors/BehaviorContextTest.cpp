@@ -52,3 +52,46 @@ TEST( BehaviorContextTest, coding )
     EXPECT_EQ( 20, decodedContext->getValue< crimild::Int32 >( "input.y" ) );
 }
 
+TEST( BehaviorContextTest, typedValues )
+{
+	auto context = crimild::alloc< BehaviorContext >();
+
+	constexpr StringId MASS( "motion.mass" );
+	context->setValue( MASS, 2.5f );
+	context->setValue( "name", "agent" );
+
+	EXPECT_TRUE( context->hasValue( "motion.mass" ) );
+	EXPECT_EQ( 2.5f, context->getValue< crimild::Real32 >( MASS ) );
+	EXPECT_EQ( "2.5", context->getValue< std::string >( "motion.mass" ) );
+	EXPECT_EQ( "agent", context->getValue< std::string >( "name" ) );
+
+	// missing values
+	EXPECT_FALSE( context->hasValue( "motion.speed" ) );
+	EXPECT_EQ( 0.0f, context->getValue< crimild::Real32 >( "motion.speed" ) );
+}
+
+TEST( BehaviorContextTest, vectorValues )
+{
+	auto context = crimild::alloc< BehaviorContext >();
+
+	context->setValue( "motion.velocity", Vector3f( 1.0f, 2.0f, 3.0f ) );
+	EXPECT_EQ( Vector3f( 1.0f, 2.0f, 3.0f ), context->getValue< Vector3f >( "motion.velocity" ) );
+
+	// components can be accessed individually
+	EXPECT_EQ( 2.0f, context->getValue< crimild::Real32 >( "motion.velocity.y" ) );
+	context->setValue( "motion.velocity.z", 5.0f );
+	EXPECT_EQ( Vector3f( 1.0f, 2.0f, 5.0f ), context->getValue< Vector3f >( "motion.velocity" ) );
+
+	context->setValue( "color", Vector4f( 0.1f, 0.2f, 0.3f, 1.0f ) );
+	EXPECT_EQ( Vector4f( 0.1f, 0.2f, 0.3f, 1.0f ), context->getValue< Vector4f >( "color" ) );
+
+	// component names are preserved when coding
+	auto encoder = crimild::alloc< coding::MemoryEncoder >();
+	encoder->encode( context );
+	auto decoder = crimild::alloc< coding::MemoryDecoder >();
+	decoder->fromBytes( encoder->getBytes() );
+	auto decodedContext = decoder->getObjectAt< BehaviorContext >( 0 );
+	ASSERT_TRUE( decodedContext != nullptr );
+	EXPECT_EQ( Vector3f( 1.0f, 2.0f, 5.0f ), decodedContext->getValue< Vector3f >( "motion.velocity" ) );
+}
+
@@ -0,0 +1,358 @@
+/*
+ * Copyright (c) 2013, Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "Coding/BinaryEncoder.hpp"
+#include "Coding/BinaryDecoder.hpp"
+#include "Coding/BinaryFileEncoder.hpp"
+#include "Coding/BinaryFileDecoder.hpp"
+#include "Coding/MemoryEncoder.hpp"
+#include "SceneGraph/Node.hpp"
+#include "SceneGraph/Group.hpp"
+#include "SceneGraph/Geometry.hpp"
+#include "Primitives/SpherePrimitive.hpp"
+#include "Components/MaterialComponent.hpp"
+#include "Rendering/Material.hpp"
+#include "Foundation/ObjectFactory.hpp"
+
+#include "gtest/gtest.h"
+
+#include <cstdio>
+
+namespace crimild {
+    
+    class BinaryCodableNode : public Node {
+        CRIMILD_IMPLEMENT_RTTI( crimild::BinaryCodableNode )
+        
+    public:
+		explicit BinaryCodableNode( std::string name = "" ) : Node( name ) { }
+        virtual ~BinaryCodableNode( void ) { }
+
+		containers::Array< int > &getValues( void ) { return _values; }
+		containers::Array< std::string > &getTags( void ) { return _tags; }
+		containers::Array< Vector3f > &getPoints( void ) { return _points; }
+		containers::Array< SharedPointer< BinaryCodableNode > > &getChildren( void ) { return _children; }
+
+		SharedPointer< BinaryCodableNode > &getLink( void ) { return _link; }
+
+		crimild::Real64 getWeight( void ) const { return _weight; }
+		void setWeight( crimild::Real64 value ) { _weight = value; }
+        
+    private:
+		containers::Array< int > _values;
+		containers::Array< std::string > _tags;
+		containers::Array< Vector3f > _points;
+        containers::Array< SharedPointer< BinaryCodableNode >> _children;
+		SharedPointer< BinaryCodableNode > _link;
+		crimild::Real64 _weight = 0.0;
+        
+    public:
+        virtual void encode( coding::Encoder &encoder ) override
+        {
+            Node::encode( encoder );
+            
+            encoder.encode( "values", _values );
+            encoder.encode( "tags", _tags );
+            encoder.encode( "points", _points );
+            encoder.encode( "children", _children );
+            encoder.encode( "link", _link );
+            encoder.encode( "weight", _weight );
+        }
+        
+        virtual void decode( coding::Decoder &decoder ) override
+        {
+            Node::decode( decoder );
+            
+			// decoded in a different order on purpose
+            decoder.decode( "weight", _weight );
+            decoder.decode( "link", _link );
+            decoder.decode( "children", _children );
+            decoder.decode( "points", _points );
+            decoder.decode( "tags", _tags );
+            decoder.decode( "values", _values );
+        }
+        
+    };
+    
+}
+
+using namespace crimild;
+using namespace crimild::coding;
+
+TEST( BinaryCodingTest, encodeDecodeValues )
+{
+    CRIMILD_REGISTER_OBJECT_BUILDER( crimild::BinaryCodableNode )
+
+    auto n = crimild::alloc< BinaryCodableNode >( "a scene" );
+	n->getValues() = { 1, 2, 3, 4, 5 };
+	n->getTags() = { "first", "", "third" };
+	n->getPoints() = { Vector3f( 1.0f, 2.0f, 3.0f ), Vector3f( 4.0f, 5.0f, 6.0f ) };
+	n->setWeight( 0.125 );
+    n->local().setTranslate( 10, 20, 30 );
+    n->world().setTranslate( 50, 70, 90 );
+    n->setWorldIsCurrent( true );
+    
+	auto encoder = crimild::alloc< BinaryEncoder >();
+	EXPECT_TRUE( encoder->encode( n ) );
+	auto bytes = encoder->getBytes();
+    
+	auto decoder = crimild::alloc< BinaryDecoder >();
+	EXPECT_TRUE( decoder->fromBytes( bytes ) );
+	ASSERT_EQ( 1, decoder->getObjectCount() );
+
+	auto n2 = decoder->getObjectAt< BinaryCodableNode >( 0 );
+	ASSERT_TRUE( n2 != nullptr );
+
+	EXPECT_EQ( n->getName(), n2->getName() );
+	EXPECT_EQ( n->getValues(), n2->getValues() );
+	EXPECT_EQ( n->getTags(), n2->getTags() );
+	EXPECT_EQ( n->getPoints(), n2->getPoints() );
+	EXPECT_EQ( n->getWeight(), n2->getWeight() );
+	EXPECT_EQ( n->getLocal().getTranslate(), n2->getLocal().getTranslate() );
+	EXPECT_EQ( n->getWorld().getTranslate(), n2->getWorld().getTranslate() );
+	EXPECT_EQ( n->worldIsCurrent(), n2->worldIsCurrent() );
+	EXPECT_EQ( nullptr, n2->getLink() );
+}
+
+TEST( BinaryCodingTest, encodeDecodeObjects )
+{
+    CRIMILD_REGISTER_OBJECT_BUILDER( crimild::BinaryCodableNode )
+
+    auto n = crimild::alloc< BinaryCodableNode >( "a scene" );
+	auto shared = crimild::alloc< BinaryCodableNode >( "shared" );
+	shared->getValues() = { 42 };
+    n->getChildren().add( crimild::alloc< BinaryCodableNode >( "child 1" ) );
+    n->getChildren().add( nullptr );
+    n->getChildren().add( shared );
+	n->getChildren()[ 0 ]->getChildren().add( shared );
+	n->getLink() = shared;
+
+	// circular reference
+	shared->getLink() = n;
+    
+	auto encoder = crimild::alloc< BinaryEncoder >();
+	encoder->encode( n );
+	auto bytes = encoder->getBytes();
+
+	// break the cycle so the original scene is released
+	shared->getLink() = nullptr;
+    
+	auto decoder = crimild::alloc< BinaryDecoder >();
+	EXPECT_TRUE( decoder->fromBytes( bytes ) );
+	auto n2 = decoder->getObjectAt< BinaryCodableNode >( 0 );
+	ASSERT_TRUE( n2 != nullptr );
+
+	ASSERT_EQ( 3, n2->getChildren().size() );
+	EXPECT_EQ( "child 1", n2->getChildren()[ 0 ]->getName() );
+	EXPECT_EQ( nullptr, n2->getChildren()[ 1 ] );
+	EXPECT_EQ( "shared", n2->getChildren()[ 2 ]->getName() );
+	EXPECT_EQ( containers::Array< int >( { 42 } ), n2->getChildren()[ 2 ]->getValues() );
+
+	// shared objects are decoded only once
+	EXPECT_EQ( n2->getChildren()[ 2 ], n2->getLink() );
+	EXPECT_EQ( n2->getChildren()[ 2 ], n2->getChildren()[ 0 ]->getChildren()[ 0 ] );
+	EXPECT_EQ( n2, n2->getLink()->getLink() );
+
+	n2->getLink()->getLink() = nullptr;
+}
+
+TEST( BinaryCodingTest, encodeDecodeGeometry )
+{
+	auto scene = crimild::alloc< Group >( "scene" );
+	auto material = crimild::alloc< Material >();
+	material->setDiffuse( RGBAColorf( 1.0f, 0.0f, 0.0f, 1.0f ) );
+
+	for ( int i = 0; i < 3; i++ ) {
+		auto geometry = crimild::alloc< Geometry >();
+		geometry->attachPrimitive( crimild::alloc< SpherePrimitive >( 1.0f ) );
+		geometry->getComponent< MaterialComponent >()->attachMaterial( material );
+		geometry->local().setTranslate( i, 0, 0 );
+		scene->attachNode( geometry );
+	}
+
+	auto encoder = crimild::alloc< BinaryEncoder >();
+	encoder->encode( scene );
+	auto bytes = encoder->getBytes();
+
+	auto decoder = crimild::alloc< BinaryDecoder >();
+	EXPECT_TRUE( decoder->fromBytes( bytes ) );
+	auto scene2 = decoder->getObjectAt< Group >( 0 );
+	ASSERT_TRUE( scene2 != nullptr );
+	ASSERT_EQ( 3, scene2->getNodeCount() );
+
+	for ( int i = 0; i < 3; i++ ) {
+		auto g1 = static_cast< Geometry * >( scene->getNodeAt( i ) );
+		auto g2 = static_cast< Geometry * >( scene2->getNodeAt( i ) );
+		ASSERT_TRUE( g2 != nullptr );
+		EXPECT_EQ( g1->getLocal().getTranslate(), g2->getLocal().getTranslate() );
+
+		Primitive *p1 = nullptr;
+		g1->forEachPrimitive( [ &p1 ]( Primitive *p ) { p1 = p; } );
+		Primitive *p2 = nullptr;
+		g2->forEachPrimitive( [ &p2 ]( Primitive *p ) { p2 = p; } );
+		ASSERT_TRUE( p2 != nullptr );
+
+		auto vbo1 = p1->getVertexBuffer();
+		auto vbo2 = p2->getVertexBuffer();
+		ASSERT_EQ( vbo1->getSizeInBytes(), vbo2->getSizeInBytes() );
+		EXPECT_EQ( 0, memcmp( vbo1->getData(), vbo2->getData(), vbo1->getSizeInBytes() ) );
+
+		auto ibo1 = p1->getIndexBuffer();
+		auto ibo2 = p2->getIndexBuffer();
+		ASSERT_EQ( ibo1->getIndexCount(), ibo2->getIndexCount() );
+		for ( crimild::Size j = 0; j < ibo1->getIndexCount(); j++ ) {
+			EXPECT_EQ( ibo1->getIndexAt( j ), ibo2->getIndexAt( j ) );
+		}
+
+		auto m2 = g2->getComponent< MaterialComponent >()->first();
+		ASSERT_TRUE( m2 != nullptr );
+		EXPECT_EQ( material->getDiffuse(), m2->getDiffuse() );
+		EXPECT_EQ( m2, static_cast< Geometry * >( scene2->getNodeAt( 0 ) )->getComponent< MaterialComponent >()->first() );
+	}
+}
+
+TEST( BinaryCodingTest, smallerThanMemoryEncoder )
+{
+	auto scene = crimild::alloc< Group >( "scene" );
+	for ( int i = 0; i < 100; i++ ) {
+		auto group = crimild::alloc< Group >( "group" );
+		group->attachNode( crimild::alloc< Group >( "child" ) );
+		scene->attachNode( group );
+	}
+
+	auto memoryEncoder = crimild::alloc< MemoryEncoder >();
+	memoryEncoder->encode( scene );
+
+	auto binaryEncoder = crimild::alloc< BinaryEncoder >();
+	binaryEncoder->encode( scene );
+
+	EXPECT_LT( 2 * binaryEncoder->getBytes().size(), memoryEncoder->getBytes().size() );
+}
+
+TEST( BinaryCodingTest, invalidData )
+{
+	auto scene = crimild::alloc< Group >( "scene" );
+	scene->attachNode( crimild::alloc< Group >( "child" ) );
+
+	auto encoder = crimild::alloc< BinaryEncoder >();
+	encoder->encode( scene );
+	auto bytes = encoder->getBytes();
+
+	auto empty = crimild::alloc< BinaryDecoder >();
+	EXPECT_FALSE( empty->fromBytes( containers::ByteArray() ) );
+	EXPECT_EQ( 0, empty->getObjectCount() );
+
+	auto corrupted = bytes;
+	corrupted[ 0 ] = 0;
+	auto badMagic = crimild::alloc< BinaryDecoder >();
+	EXPECT_FALSE( badMagic->fromBytes( corrupted ) );
+
+	// truncated data must never be read out of bounds
+	for ( crimild::Size size = 0; size < bytes.size(); size++ ) {
+		auto truncated = crimild::alloc< BinaryDecoder >();
+		truncated->fromBytes( bytes.getData(), size );
+	}
+}
+
+TEST( BinaryCodingTest, decodeRootsOnDemand )
+{
+    CRIMILD_REGISTER_OBJECT_BUILDER( crimild::BinaryCodableNode )
+
+	auto shared = crimild::alloc< BinaryCodableNode >( "shared" );
+
+	auto encoder = crimild::alloc< BinaryEncoder >();
+	for ( int i = 0; i < 3; i++ ) {
+		auto root = crimild::alloc< BinaryCodableNode >( "root " + StringUtils::toString( i ) );
+		root->getChildren().add( crimild::alloc< BinaryCodableNode >( "child" ) );
+		root->getLink() = shared;
+		encoder->encode( root );
+	}
+	auto bytes = encoder->getBytes();
+
+	auto decoder = crimild::alloc< BinaryDecoder >();
+	EXPECT_TRUE( decoder->parse( bytes.getData(), bytes.size() ) );
+	EXPECT_EQ( 3, decoder->getRootCount() );
+
+	// nothing is decoded yet
+	EXPECT_EQ( 0, decoder->getObjectCount() );
+
+	auto root2 = decoder->decodeRootAt< BinaryCodableNode >( 2 );
+	ASSERT_TRUE( root2 != nullptr );
+	EXPECT_EQ( "root 2", root2->getName() );
+	ASSERT_EQ( 1, root2->getChildren().size() );
+	EXPECT_EQ( "child", root2->getChildren()[ 0 ]->getName() );
+
+	auto root0 = decoder->decodeRootAt< BinaryCodableNode >( 0 );
+	ASSERT_TRUE( root0 != nullptr );
+	EXPECT_EQ( "root 0", root0->getName() );
+
+	EXPECT_EQ( root2, decoder->decodeRootAt< BinaryCodableNode >( 2 ) );
+	EXPECT_EQ( nullptr, decoder->decodeRootAt( 3 ) );
+
+	ASSERT_TRUE( root0->getLink() != nullptr );
+	EXPECT_EQ( "shared", root0->getLink()->getName() );
+	EXPECT_EQ( root0->getLink(), root2->getLink() );
+}
+
+TEST( BinaryCodingTest, fileEncodeDecode )
+{
+	auto scene = crimild::alloc< Group >( "scene" );
+	auto geometry = crimild::alloc< Geometry >( "sphere" );
+	geometry->attachPrimitive( crimild::alloc< SpherePrimitive >( 1.0f ) );
+	scene->attachNode( geometry );
+	scene->attachNode( crimild::alloc< Group >( "empty" ) );
+
+	auto encoder = crimild::alloc< BinaryFileEncoder >();
+	EXPECT_FALSE( encoder->write( "./binary_coding_test.crimild" ) );
+	encoder->encode( scene );
+	EXPECT_TRUE( encoder->write( "./binary_coding_test.crimild" ) );
+
+	auto decoder = crimild::alloc< BinaryFileDecoder >();
+	EXPECT_TRUE( decoder->read( "./binary_coding_test.crimild" ) );
+	ASSERT_EQ( 1, decoder->getObjectCount() );
+
+	auto scene2 = decoder->getObjectAt< Group >( 0 );
+	ASSERT_TRUE( scene2 != nullptr );
+	ASSERT_EQ( 2, scene2->getNodeCount() );
+	EXPECT_EQ( "sphere", scene2->getNodeAt( 0 )->getName() );
+	EXPECT_EQ( "empty", scene2->getNodeAt( 1 )->getName() );
+
+	Primitive *p = nullptr;
+	scene2->getNodeAt< Geometry >( 0 )->forEachPrimitive( [ &p ]( Primitive *primitive ) { p = primitive; } );
+	ASSERT_TRUE( p != nullptr );
+	EXPECT_LT( 0, p->getVertexBuffer()->getVertexCount() );
+
+	// data is copied into each object, so the file can be closed
+	decoder = nullptr;
+	EXPECT_EQ( "sphere", scene2->getNodeAt( 0 )->getName() );
+
+	auto missing = crimild::alloc< BinaryFileDecoder >();
+	EXPECT_FALSE( missing->open( "./binary_coding_test_missing.crimild" ) );
+
+	std::remove( "./binary_coding_test.crimild" );
+}
+
@@ -30,8 +30,14 @@
 #include "Coding/Decoder.hpp"
 #include "Coding/MemoryEncoder.hpp"
 #include "Coding/MemoryDecoder.hpp"
+#include "Coding/BinaryEncoder.hpp"
+#include "Concurrency/JobScheduler.hpp"
+#include "Components/MaterialComponent.hpp"
+#include "Primitives/SpherePrimitive.hpp"
+#include "Rendering/Material.hpp"
 #include "SceneGraph/Node.hpp"
 #include "SceneGraph/Group.hpp"
+#include "SceneGraph/Geometry.hpp"
 #include "Foundation/ObjectFactory.hpp"
 
 #include "gtest/gtest.h"
@@ -132,3 +138,60 @@ TEST( CodableTest, codingArray )
 	EXPECT_EQ( n->getChildren()[ 2 ]->getName(), n2->getChildren()[ 2 ]->getName() );	
 }
 
+TEST( CodableTest, parallelDecoding )
+{
+	auto material = crimild::alloc< Material >();
+	material->setDiffuse( RGBAColorf( 0.0f, 1.0f, 0.0f, 1.0f ) );
+
+	auto scene = crimild::alloc< Group >( "scene" );
+	for ( int i = 0; i < 8; i++ ) {
+		auto group = crimild::alloc< Group >( "group" );
+		group->local().setTranslate( i, 0, 0 );
+		for ( int j = 0; j < 4; j++ ) {
+			auto geometry = crimild::alloc< Geometry >( "geometry" );
+			geometry->attachPrimitive( crimild::alloc< SpherePrimitive >( 1.0f + j ) );
+			if ( j % 2 == 0 ) {
+				geometry->getComponent< MaterialComponent >()->attachMaterial( material );
+			}
+			group->attachNode( geometry );
+		}
+		scene->attachNode( group );
+	}
+
+	auto encoder = crimild::alloc< coding::MemoryEncoder >();
+	encoder->encode( scene );
+	auto bytes = encoder->getBytes();
+
+	auto serialDecoder = crimild::alloc< coding::MemoryDecoder >();
+	serialDecoder->fromBytes( bytes );
+	auto expected = serialDecoder->getObjectAt< Group >( 0 );
+	ASSERT_TRUE( expected != nullptr );
+
+	concurrency::JobScheduler scheduler;
+	scheduler.configure( 3 );
+	scheduler.start();
+
+	auto parallelDecoder = crimild::alloc< coding::MemoryDecoder >();
+	parallelDecoder->setParallelDecodingEnabled( true );
+	parallelDecoder->fromBytes( bytes );
+	auto result = parallelDecoder->getObjectAt< Group >( 0 );
+
+	scheduler.stop();
+
+	ASSERT_TRUE( result != nullptr );
+	ASSERT_EQ( 8, result->getNodeCount() );
+
+	// Both object graphs must produce the exact same data when encoded again
+	auto expectedEncoder = crimild::alloc< coding::BinaryEncoder >();
+	expectedEncoder->encode( expected );
+	auto resultEncoder = crimild::alloc< coding::BinaryEncoder >();
+	resultEncoder->encode( result );
+	EXPECT_TRUE( expectedEncoder->getBytes() == resultEncoder->getBytes() );
+
+	// shared objects are still shared
+	auto g0 = result->getNodeAt< Group >( 0 )->getNodeAt< Geometry >( 0 );
+	auto g1 = result->getNodeAt< Group >( 1 )->getNodeAt< Geometry >( 2 );
+	EXPECT_EQ( g0->getComponent< MaterialComponent >()->first(), g1->getComponent< MaterialComponent >()->first() );
+	EXPECT_EQ( material->getDiffuse(), g0->getComponent< MaterialComponent >()->first()->getDiffuse() );
+}
+
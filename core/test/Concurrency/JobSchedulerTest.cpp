@@ -0,0 +1,163 @@
+/*
+ * Copyright (c) 2013, Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "Concurrency/Async.hpp"
+#include "Concurrency/JobScheduler.hpp"
+
+#include "gtest/gtest.h"
+
+#include <chrono>
+#include <thread>
+#include <vector>
+
+using namespace crimild;
+using namespace crimild::concurrency;
+
+static void busyWait( crimild::Int64 microseconds )
+{
+	auto end = std::chrono::steady_clock::now() + std::chrono::microseconds( microseconds );
+	while ( std::chrono::steady_clock::now() < end ) {
+		// do nothing
+	}
+}
+
+TEST( JobSchedulerTest, tracingDisabledByDefault )
+{
+	JobScheduler scheduler;
+	scheduler.configure( 0 );
+	scheduler.start();
+
+	auto job = async( [] { } );
+	wait( job );
+	scheduler.step();
+
+	EXPECT_FALSE( scheduler.isTracingEnabled() );
+	EXPECT_EQ( 0, scheduler.getLastFrameTrace().jobCount );
+
+	scheduler.stop();
+}
+
+TEST( JobSchedulerTest, jobRecords )
+{
+	JobScheduler scheduler;
+	scheduler.configure( 0 );
+	scheduler.start();
+	scheduler.setTracingEnabled( true );
+
+	auto parent = async();
+	for ( int i = 0; i < 3; i++ ) {
+		auto child = async( parent, [] { busyWait( 100 ); } );
+		child->setName( "child" );
+	}
+	wait( parent );
+
+	scheduler.step();
+
+	const auto &frame = scheduler.getLastFrameTrace();
+	EXPECT_EQ( 3, frame.jobCount );
+	ASSERT_EQ( 1, frame.workers.size() );
+	EXPECT_EQ( "Main", frame.workers[ 0 ].name );
+	EXPECT_EQ( 3, frame.workers[ 0 ].jobCount );
+	EXPECT_LT( 0.0, frame.workers[ 0 ].utilization );
+	EXPECT_GE( 1.0, frame.workers[ 0 ].utilization );
+
+	for ( const auto &job : frame.jobs ) {
+		EXPECT_EQ( "child", job.name );
+		EXPECT_EQ( parent->getId(), job.parentId );
+		EXPECT_EQ( 0, job.workerIndex );
+		EXPECT_FALSE( job.stolen );
+		EXPECT_LE( job.scheduledTime, job.startTime );
+		EXPECT_LE( job.startTime, job.endTime );
+	}
+
+	// Records are only reported once
+	scheduler.step();
+	EXPECT_EQ( 0, scheduler.getLastFrameTrace().jobCount );
+
+	scheduler.stop();
+}
+
+TEST( JobSchedulerTest, criticalPath )
+{
+	JobScheduler scheduler;
+	scheduler.configure( 0 );
+	scheduler.start();
+	scheduler.setTracingEnabled( true );
+
+	// The tree contains two independent jobs and a chain of two jobs, 
+	// so the critical path is given by the chain
+	auto root = async();
+	async( root, [] { busyWait( 1000 ); } );
+	async( root, [] { busyWait( 1000 ); } );
+
+	JobPtr first;
+	first = async( root, [ &first ] {
+		busyWait( 1000 );
+		async( first, [] { busyWait( 1000 ); } );
+	});
+	wait( root );
+
+	scheduler.step();
+
+	const auto &frame = scheduler.getLastFrameTrace();
+	EXPECT_EQ( 4, frame.jobCount );
+	EXPECT_LE( 0.002, frame.criticalPath );
+	EXPECT_GT( frame.totalWork, frame.criticalPath );
+
+	scheduler.stop();
+}
+
+
+TEST( JobSchedulerTest, parallelForFromOtherThreads )
+{
+	JobScheduler scheduler;
+	scheduler.configure( 2 );
+	scheduler.start();
+
+	EXPECT_TRUE( scheduler.isWorkerThread() );
+
+	// Threads that are not workers (i.e. asset loaders) cannot schedule 
+	// jobs, so all calls must be executed in that same thread
+	crimild::Bool isWorker = true;
+	std::vector< std::thread::id > threadIds( 16 );
+	std::thread loader( [ &scheduler, &isWorker, &threadIds ] {
+		isWorker = scheduler.isWorkerThread();
+		parallel_for( threadIds.size(), [ &threadIds ]( crimild::Size i ) {
+			threadIds[ i ] = std::this_thread::get_id();
+		});
+	});
+	const auto loaderId = loader.get_id();
+	loader.join();
+
+	scheduler.stop();
+
+	EXPECT_FALSE( isWorker );
+	for ( const auto &id : threadIds ) {
+		EXPECT_EQ( loaderId, id );
+	}
+}
@@ -0,0 +1,132 @@
+/*
+ * Copyright (c) 2013, Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "Foundation/Log.hpp"
+#include "Foundation/Types.hpp"
+
+#include "gtest/gtest.h"
+
+#include <thread>
+#include <vector>
+
+using namespace crimild;
+
+/**
+	\brief Keeps all lines in memory
+*/
+class LogTestOutputHandler : public Log::OutputHandler {
+public:
+	static std::vector< std::string > lines;
+
+	virtual void printLine( std::string const &line ) override
+	{
+		std::lock_guard< std::mutex > lock( _mutex );
+		lines.push_back( line );
+	}
+
+private:
+	std::mutex _mutex;
+};
+
+std::vector< std::string > LogTestOutputHandler::lines;
+
+static crimild::Int32 countEvaluations( crimild::Int32 &count )
+{
+	return ++count;
+}
+
+TEST( LogTest, disabledMacrosDoNotEvaluateArguments )
+{
+	auto level = Log::getLevel();
+	Log::setOutputHandler< Log::NullOutputHandler >();
+	Log::setLevel( Log::LOG_LEVEL_INFO );
+
+	crimild::Int32 count = 0;
+	CRIMILD_LOG_DEBUG( "value: ", countEvaluations( count ) );
+	CRIMILD_LOG_TRACE( "value: ", countEvaluations( count ) );
+	EXPECT_EQ( 0, count );
+
+	CRIMILD_LOG_INFO( "value: ", countEvaluations( count ) );
+	EXPECT_EQ( 1, count );
+
+	Log::setLevel( level );
+	Log::setOutputHandler< Log::ConsoleOutputHandler >();
+}
+
+TEST( LogTest, async )
+{
+	const crimild::Size THREAD_COUNT = 4;
+	const crimild::Size LINE_COUNT = 5000;
+
+	LogTestOutputHandler::lines.clear();
+	Log::setOutputHandler< LogTestOutputHandler >();
+	Log::setAsyncEnabled( true );
+	EXPECT_TRUE( Log::isAsyncEnabled() );
+
+	// more lines than the ring buffers can hold
+	std::vector< std::thread > threads;
+	for ( crimild::Size t = 0; t < THREAD_COUNT; t++ ) {
+		threads.push_back( std::thread( [ t, LINE_COUNT ] {
+			for ( crimild::Size i = 0; i < LINE_COUNT; i++ ) {
+				Log::info( "LogTest", t, ":", i );
+			}
+		}));
+	}
+	for ( auto &t : threads ) {
+		t.join();
+	}
+
+	Log::flush();
+	EXPECT_EQ( THREAD_COUNT * LINE_COUNT, LogTestOutputHandler::lines.size() );
+
+	// lines are ordered for each thread
+	std::vector< crimild::Size > next( THREAD_COUNT, 0 );
+	for ( const auto &line : LogTestOutputHandler::lines ) {
+		auto pos = line.find( "I/LogTest - " );
+		ASSERT_NE( std::string::npos, pos );
+		auto payload = line.substr( pos + 12 );
+		auto separator = payload.find( ":" );
+		auto t = std::stoul( payload.substr( 0, separator ) );
+		auto i = std::stoul( payload.substr( separator + 1 ) );
+		ASSERT_LT( t, THREAD_COUNT );
+		EXPECT_EQ( next[ t ], i );
+		next[ t ] = i + 1;
+	}
+
+	// errors are written before returning
+	Log::error( "LogTest", "error" );
+	EXPECT_EQ( THREAD_COUNT * LINE_COUNT + 1, LogTestOutputHandler::lines.size() );
+
+	Log::setAsyncEnabled( false );
+	EXPECT_FALSE( Log::isAsyncEnabled() );
+
+	Log::info( "LogTest", "sync" );
+	EXPECT_EQ( THREAD_COUNT * LINE_COUNT + 2, LogTestOutputHandler::lines.size() );
+
+	Log::setOutputHandler< Log::ConsoleOutputHandler >();
+}
+
@@ -0,0 +1,99 @@
+/*
+ * Copyright (c) 2013, Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "Foundation/Profiler.hpp"
+
+#include "gtest/gtest.h"
+
+#include <sstream>
+#include <thread>
+
+using namespace crimild;
+
+TEST( ProfilerTest, registerZone )
+{
+	auto zone = Profiler::registerZone( "ProfilerTest.registerZone" );
+
+	EXPECT_EQ( "ProfilerTest.registerZone", zone->name );
+	EXPECT_EQ( zone, Profiler::registerZone( "ProfilerTest.registerZone" ) );
+	EXPECT_NE( zone, Profiler::registerZone( "ProfilerTest.anotherZone" ) );
+}
+
+TEST( ProfilerTest, chromeTrace )
+{
+	Profiler profiler;
+
+	profiler.beginCapture();
+
+	{
+		CRIMILD_PROFILE( "ProfilerTest.outer" )
+		{
+			CRIMILD_PROFILE( "ProfilerTest.inner" )
+		}
+
+		// Samples from other threads are collected by the main one
+		std::thread worker( [] {
+			Profiler::setThreadName( "ProfilerTest.worker" );
+			for ( int i = 0; i < 3; i++ ) {
+				CRIMILD_PROFILE_DYNAMIC( "ProfilerTest.worker" )
+			}
+		});
+		worker.join();
+	}
+
+	profiler.step();
+	profiler.endCapture();
+
+	EXPECT_EQ( 5, profiler.getCapturedSampleCount() );
+
+	std::stringstream ss;
+	profiler.exportChromeTrace( ss );
+	auto trace = ss.str();
+
+	EXPECT_EQ( 0, trace.find( "{\"traceEvents\":[" ) );
+	EXPECT_NE( std::string::npos, trace.find( "\"name\":\"ProfilerTest.outer\",\"ph\":\"X\"" ) );
+	EXPECT_NE( std::string::npos, trace.find( "\"name\":\"ProfilerTest.inner\",\"ph\":\"X\"" ) );
+	EXPECT_NE( std::string::npos, trace.find( "\"name\":\"ProfilerTest.worker\",\"ph\":\"X\"" ) );
+	EXPECT_NE( std::string::npos, trace.find( "\"name\":\"Frame\",\"ph\":\"i\"" ) );
+}
+
+TEST( ProfilerTest, captureOnlyWhenRequested )
+{
+	Profiler profiler;
+
+	{
+		CRIMILD_PROFILE( "ProfilerTest.notCaptured" )
+	}
+
+	profiler.beginCapture();
+	profiler.step();
+	profiler.endCapture();
+
+	EXPECT_EQ( 0, profiler.getCapturedSampleCount() );
+}
+
@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) 2013, Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "Foundation/StringId.hpp"
+
+#include "gtest/gtest.h"
+
+using namespace crimild;
+
+TEST( StringIdTest, compileTimeHash )
+{
+	constexpr StringId id( "motion.velocity" );
+	static_assert( id.getHash() == StringId::computeHash( "motion.velocity" ), "Ids must be computed at compile time" );
+
+	// FNV-1a reference values
+	static_assert( StringId::computeHash( "" ) == 0xcbf29ce484222325ull, "Invalid offset basis" );
+	static_assert( StringId::computeHash( "a" ) == 0xaf63dc4c8601ec8cull, "Invalid hash" );
+
+	EXPECT_STREQ( "motion.velocity", id.getName() );
+	EXPECT_TRUE( id.hasName() );
+}
+
+TEST( StringIdTest, runtimeHash )
+{
+	std::string name = "motion.";
+	name += "velocity";
+
+	EXPECT_EQ( StringId( "motion.velocity" ), StringId( name ) );
+	EXPECT_EQ( StringId::computeHash( "motion.velocity" ), StringId::computeHash( name ) );
+	EXPECT_NE( StringId( "motion.position" ), StringId( name ) );
+}
+
+TEST( StringIdTest, append )
+{
+	constexpr StringId id( "motion.velocity" );
+	constexpr auto x = id.append( ".x" );
+
+	EXPECT_EQ( StringId( "motion.velocity.x" ), x );
+	EXPECT_NE( StringId( "motion.velocity.y" ), x );
+	EXPECT_FALSE( x.hasName() );
+	EXPECT_STREQ( "", x.getName() );
+}
+
@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) 2013, Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "Foundation/Variant.hpp"
+#include "Mathematics/Vector.hpp"
+
+#include "gtest/gtest.h"
+
+using namespace crimild;
+
+TEST( VariantTest, empty )
+{
+	Variant v;
+
+	EXPECT_TRUE( v.isEmpty() );
+	EXPECT_EQ( 0, v.get< crimild::Int32 >() );
+	EXPECT_EQ( "", v.get< std::string >() );
+}
+
+TEST( VariantTest, numbers )
+{
+	Variant v( 10 );
+	EXPECT_EQ( Variant::Type::INTEGER, v.getType() );
+	EXPECT_EQ( 10, v.get< crimild::Int32 >() );
+	EXPECT_EQ( 10, v.get< crimild::UInt8 >() );
+	EXPECT_EQ( 10.0f, v.get< crimild::Real32 >() );
+	EXPECT_TRUE( v.get< crimild::Bool >() );
+	EXPECT_EQ( "10", v.get< std::string >() );
+
+	v.set( 2.5f );
+	EXPECT_EQ( Variant::Type::REAL, v.getType() );
+	EXPECT_EQ( 2.5f, v.get< crimild::Real32 >() );
+	EXPECT_EQ( 2, v.get< crimild::Int32 >() );
+	EXPECT_EQ( "2.5", v.get< std::string >() );
+
+	v.set( false );
+	EXPECT_EQ( Variant::Type::BOOL, v.getType() );
+	EXPECT_FALSE( v.get< crimild::Bool >() );
+	EXPECT_EQ( 0, v.get< crimild::Int32 >() );
+	EXPECT_EQ( "0", v.get< std::string >() );
+}
+
+TEST( VariantTest, strings )
+{
+	Variant v( "1.5" );
+	EXPECT_EQ( Variant::Type::STRING, v.getType() );
+	EXPECT_EQ( "1.5", v.get< std::string >() );
+	EXPECT_EQ( 1.5f, v.get< crimild::Real32 >() );
+	EXPECT_EQ( 1, v.get< crimild::Int32 >() );
+	EXPECT_TRUE( v.get< crimild::Bool >() );
+
+	v.set( std::string( "true" ) );
+	EXPECT_TRUE( v.get< crimild::Bool >() );
+
+	v.set( "0" );
+	EXPECT_FALSE( v.get< crimild::Bool >() );
+
+	v.set( "some text" );
+	EXPECT_EQ( "some text", v.get< std::string >() );
+	EXPECT_EQ( 0, v.get< crimild::Int32 >() );
+}
+
+TEST( VariantTest, otherTypes )
+{
+	// types without native storage are kept as strings
+	Variant v( 'x' );
+	EXPECT_EQ( Variant::Type::STRING, v.getType() );
+	EXPECT_EQ( 'x', v.get< char >() );
+
+	v.set( Vector3f( 1.0f, 2.0f, 3.0f ) );
+	EXPECT_EQ( Variant::Type::STRING, v.getType() );
+	EXPECT_FALSE( v.get< std::string >().empty() );
+}
+
@@ -0,0 +1,259 @@
+/*
+ * Copyright (c) 2013, Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "Loaders/OBJLoader.hpp"
+#include "Components/MaterialComponent.hpp"
+#include "Primitives/Primitive.hpp"
+#include "Concurrency/JobScheduler.hpp"
+#include "Rendering/ImageTGA.hpp"
+
+#include "Utils/TemporaryFile.hpp"
+
+#include "gtest/gtest.h"
+
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+using namespace crimild;
+
+namespace {
+
+	void writeFile( std::string fileName, std::string contents )
+	{
+		std::ofstream output( fileName.c_str() );
+		output << contents;
+	}
+
+	void writeImage( std::string fileName )
+	{
+		const unsigned char pixel[] = { 255, 128, 0 };
+		ImageTGA image;
+		image.setData( 1, 1, 3, pixel, Image::PixelFormat::RGB );
+		image.saveToFile( fileName );
+	}
+
+	/**
+		\brief Several objects made of grids, using both absolute
+		and relative indices
+	 */
+	std::string createGridOBJ( crimild::UInt32 objectCount, crimild::UInt32 size )
+	{
+		std::stringstream ss;
+		crimild::UInt32 base = 0;
+		for ( crimild::UInt32 o = 0; o < objectCount; o++ ) {
+			ss << "o grid" << o << "\n";
+			for ( crimild::UInt32 y = 0; y <= size; y++ ) {
+				for ( crimild::UInt32 x = 0; x <= size; x++ ) {
+					ss << "v " << ( 0.125f * x ) << " " << ( -0.3f * y ) << " " << ( o + 0.001f * x * y ) << "\n";
+					ss << "vt " << ( ( float ) x / size ) << " " << ( ( float ) y / size ) << "\n";
+				}
+			}
+			ss << "vn 0.0 0.0 1.0\n";
+			for ( crimild::UInt32 y = 0; y < size; y++ ) {
+				for ( crimild::UInt32 x = 0; x < size; x++ ) {
+					auto v = base + y * ( size + 1 ) + x + 1;
+					if ( ( x + y ) % 2 == 0 ) {
+						ss << "f " << v << "/" << v << "/-1 " << ( v + 1 ) << "/" << ( v + 1 ) << "/-1 " << ( v + size + 1 ) << "/" << ( v + size + 1 ) << "/-1\n";
+					}
+					else {
+						// relative indices
+						crimild::Int32 r = ( crimild::Int32 ) v - ( crimild::Int32 )( base + ( size + 1 ) * ( size + 1 ) ) - 1;
+						ss << "f " << r << "/" << r << "/-1 " << ( r + 1 ) << "/" << ( r + 1 ) << "/-1 " << ( r + size + 1 ) << "/" << ( r + size + 1 ) << "/-1\n";
+					}
+					ss << "f " << ( v + 1 ) << "/" << ( v + 1 ) << "/-1 " << ( v + size + 2 ) << "/" << ( v + size + 2 ) << "/-1 " << ( v + size + 1 ) << "/" << ( v + size + 1 ) << "/-1\n";
+				}
+			}
+			base += ( size + 1 ) * ( size + 1 );
+		}
+		return ss.str();
+	}
+
+}
+
+TEST( OBJLoaderTest, load )
+{
+	TemporaryFile mtl( "./obj_loader_test.mtl" );
+	TemporaryFile obj( "./obj_loader_test.obj" );
+
+	writeFile( "./obj_loader_test.mtl",
+		"newmtl red\n"
+		"Kd 1.0 0.0 0.0\n"
+		"Ka 0.1 0.2 0.3\n" );
+
+	writeFile( "./obj_loader_test.obj",
+		"# comment\n"
+		"mtllib obj_loader_test.mtl\n"
+		"o first\n"
+		"v 0 0 0\n"
+		"v 1 0 0\n"
+		"v 1 1 0\n"
+		"v 0 1 0\n"
+		"vt 0 0\n"
+		"vt 1 0\n"
+		"vt 1 1\n"
+		"vt 0 1\n"
+		"vn 0 0 1\n"
+		"usemtl red\n"
+		"f 1/1/1 2/2/1 3/3/1\n"
+		"f 1/1/1 3/3/1 4/4/1\n"
+		"\n"
+		"o second\r\n"
+		"v 0.1 -3.25e-2 1.5E0\r\n"
+		"v\t2.5 0 1\r\n"
+		"v 0 -2.25 0.333333333333333333\r\n"
+		"f -3/1/1 -2/2/1 -1/3/1\r\n" );
+
+	OBJLoader loader( "./obj_loader_test.obj" );
+	loader.setCacheEnabled( false );
+	auto scene = loader.load();
+	ASSERT_TRUE( scene != nullptr );
+	ASSERT_EQ( 2, scene->getNodeCount() );
+
+	auto first = scene->getNodeAt< Group >( 0 );
+	EXPECT_EQ( "first", first->getName() );
+	ASSERT_EQ( 1, first->getNodeCount() );
+
+	auto geometry = first->getNodeAt< Geometry >( 0 );
+	geometry->forEachPrimitive( []( Primitive *primitive ) {
+		// corners are welded
+		EXPECT_EQ( 4, primitive->getVertexBuffer()->getVertexCount() );
+		EXPECT_EQ( 6, primitive->getIndexBuffer()->getIndexCount() );
+		EXPECT_TRUE( primitive->getVertexBuffer()->getVertexFormat().hasNormals() );
+		EXPECT_TRUE( primitive->getVertexBuffer()->getVertexFormat().hasTextureCoords() );
+	});
+
+	auto materials = geometry->getComponent< MaterialComponent >();
+	ASSERT_TRUE( materials->hasMaterials() );
+	EXPECT_EQ( RGBAColorf( 1.0f, 0.0f, 0.0f, 1.0f ), materials->first()->getDiffuse() );
+	EXPECT_EQ( RGBAColorf( 0.1f, 0.2f, 0.3f, 1.0f ), materials->first()->getAmbient() );
+
+	auto second = scene->getNodeAt< Group >( 1 );
+	EXPECT_EQ( "second", second->getName() );
+	ASSERT_EQ( 1, second->getNodeCount() );
+	second->getNodeAt< Geometry >( 0 )->forEachPrimitive( []( Primitive *primitive ) {
+		auto vbo = primitive->getVertexBuffer();
+		auto ibo = primitive->getIndexBuffer();
+		ASSERT_EQ( 3, vbo->getVertexCount() );
+		ASSERT_EQ( 3, ibo->getIndexCount() );
+		EXPECT_EQ( Vector3f( 0.1f, -3.25e-2f, 1.5f ), vbo->getPositionAt( ibo->getIndexAt( 0 ) ) );
+		EXPECT_EQ( Vector3f( 2.5f, 0.0f, 1.0f ), vbo->getPositionAt( ibo->getIndexAt( 1 ) ) );
+		EXPECT_EQ( Vector3f( 0.0f, -2.25f, std::strtof( "0.333333333333333333", nullptr ) ), vbo->getPositionAt( ibo->getIndexAt( 2 ) ) );
+	});
+}
+
+TEST( OBJLoaderTest, textureMaps )
+{
+	TemporaryFile mtl( "./obj_loader_maps_test.mtl" );
+	TemporaryFile colorMap( "./obj_loader_maps_color.tga" );
+	TemporaryFile normalMap( "./obj_loader_maps_normal.tga" );
+	TemporaryFile obj( "./obj_loader_maps_test.obj" );
+
+	writeFile( "./obj_loader_maps_test.mtl",
+		"newmtl textured\n"
+		"Kd 1.0 1.0 1.0\n"
+		"map_Kd obj_loader_maps_color.tga\n"
+		"map_bump obj_loader_maps_normal.tga\n" );
+	writeImage( "./obj_loader_maps_color.tga" );
+	writeImage( "./obj_loader_maps_normal.tga" );
+
+	writeFile( "./obj_loader_maps_test.obj",
+		"mtllib obj_loader_maps_test.mtl\n"
+		"o quad\n"
+		"v 0 0 0\n"
+		"v 1 0 0\n"
+		"v 1 1 0\n"
+		"vt 0 0\n"
+		"vt 1 0\n"
+		"vt 1 1\n"
+		"vn 0 0 1\n"
+		"usemtl textured\n"
+		"f 1/1/1 2/2/1 3/3/1\n" );
+
+	OBJLoader loader( "./obj_loader_maps_test.obj" );
+	loader.setCacheEnabled( false );
+	auto scene = loader.load();
+	ASSERT_TRUE( scene != nullptr );
+	ASSERT_EQ( 1, scene->getNodeCount() );
+
+	auto geometry = scene->getNodeAt< Group >( 0 )->getNodeAt< Geometry >( 0 );
+	auto materials = geometry->getComponent< MaterialComponent >();
+	ASSERT_TRUE( materials->hasMaterials() );
+	EXPECT_TRUE( materials->first()->getColorMap() != nullptr );
+	EXPECT_TRUE( materials->first()->getNormalMap() != nullptr );
+
+	// Normal maps require tangents
+	geometry->forEachPrimitive( []( Primitive *primitive ) {
+		EXPECT_TRUE( primitive->getVertexBuffer()->getVertexFormat().hasTangents() );
+	});
+}
+
+TEST( OBJLoaderTest, parallelLoadMatchesSequential )
+{
+	TemporaryFile obj( "./obj_loader_grid_test.obj" );
+
+	writeFile( "./obj_loader_grid_test.obj", createGridOBJ( 4, 32 ) );
+
+	OBJLoader sequentialLoader( "./obj_loader_grid_test.obj" );
+	sequentialLoader.setCacheEnabled( false );
+	auto expected = sequentialLoader.load();
+
+	concurrency::JobScheduler scheduler;
+	scheduler.configure( 3 );
+	scheduler.start();
+
+	OBJLoader parallelLoader( "./obj_loader_grid_test.obj" );
+	parallelLoader.setMinChunkSize( 1024 );
+	parallelLoader.setCacheEnabled( false );
+	auto result = parallelLoader.load();
+
+	scheduler.stop();
+
+	ASSERT_EQ( 4, expected->getNodeCount() );
+	ASSERT_EQ( expected->getNodeCount(), result->getNodeCount() );
+	for ( crimild::UInt32 i = 0; i < expected->getNodeCount(); i++ ) {
+		auto g0 = expected->getNodeAt< Group >( i );
+		auto g1 = result->getNodeAt< Group >( i );
+		EXPECT_EQ( g0->getName(), g1->getName() );
+		ASSERT_EQ( 1, g0->getNodeCount() );
+		ASSERT_EQ( 1, g1->getNodeCount() );
+
+		Primitive *p0 = nullptr;
+		Primitive *p1 = nullptr;
+		g0->getNodeAt< Geometry >( 0 )->forEachPrimitive( [ &p0 ]( Primitive *p ) { p0 = p; } );
+		g1->getNodeAt< Geometry >( 0 )->forEachPrimitive( [ &p1 ]( Primitive *p ) { p1 = p; } );
+		ASSERT_TRUE( p0 != nullptr && p1 != nullptr );
+
+		// 33x33 unique vertices per grid
+		EXPECT_EQ( 33 * 33, p0->getVertexBuffer()->getVertexCount() );
+		ASSERT_EQ( p0->getVertexBuffer()->getSizeInBytes(), p1->getVertexBuffer()->getSizeInBytes() );
+		EXPECT_EQ( 0, memcmp( p0->getVertexBuffer()->getData(), p1->getVertexBuffer()->getData(), p0->getVertexBuffer()->getSizeInBytes() ) );
+		ASSERT_EQ( p0->getIndexBuffer()->getSizeInBytes(), p1->getIndexBuffer()->getSizeInBytes() );
+		EXPECT_EQ( 0, memcmp( p0->getIndexBuffer()->getData(), p1->getIndexBuffer()->getData(), p0->getIndexBuffer()->getSizeInBytes() ) );
+	}
+}
+
@@ -0,0 +1,294 @@
+/*
+ * Copyright (c) 2013, Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "Loaders/SceneCache.hpp"
+#include "Loaders/OBJLoader.hpp"
+#include "SceneGraph/Geometry.hpp"
+#include "SceneGraph/Light.hpp"
+#include "Components/MaterialComponent.hpp"
+#include "Primitives/Primitive.hpp"
+#include "Primitives/QuadPrimitive.hpp"
+#include "Rendering/Material.hpp"
+#include "Rendering/Texture.hpp"
+#include "Rendering/Image.hpp"
+#include "Animation/Skeleton.hpp"
+
+#include "gtest/gtest.h"
+
+#include <cstdio>
+#include <fstream>
+
+using namespace crimild;
+
+namespace crimild {
+
+	namespace test {
+
+		static void writeCacheSource( std::string fileName, std::string contents )
+		{
+			std::ofstream output( fileName.c_str() );
+			output << contents;
+		}
+
+		static Primitive *getFirstPrimitive( Node *node )
+		{
+			Primitive *result = nullptr;
+			static_cast< Geometry * >( node )->forEachPrimitive( [ &result ]( Primitive *p ) {
+				if ( result == nullptr ) {
+					result = p;
+				}
+			});
+			return result;
+		}
+
+		static void expectSamePrimitive( Primitive *expected, Primitive *actual )
+		{
+			ASSERT_TRUE( expected != nullptr );
+			ASSERT_TRUE( actual != nullptr );
+			EXPECT_EQ( expected->getType(), actual->getType() );
+
+			auto vbo0 = expected->getVertexBuffer();
+			auto vbo1 = actual->getVertexBuffer();
+			EXPECT_EQ( vbo0->getVertexFormat(), vbo1->getVertexFormat() );
+			ASSERT_EQ( vbo0->getSizeInBytes(), vbo1->getSizeInBytes() );
+			EXPECT_EQ( 0, memcmp( vbo0->getData(), vbo1->getData(), vbo0->getSizeInBytes() ) );
+
+			auto ibo0 = expected->getIndexBuffer();
+			auto ibo1 = actual->getIndexBuffer();
+			EXPECT_EQ( ibo0->getIndexType(), ibo1->getIndexType() );
+			ASSERT_EQ( ibo0->getSizeInBytes(), ibo1->getSizeInBytes() );
+			EXPECT_EQ( 0, memcmp( ibo0->getData(), ibo1->getData(), ibo0->getSizeInBytes() ) );
+		}
+
+	}
+
+}
+
+TEST( SceneCacheTest, writeAndRead )
+{
+	test::writeCacheSource( "./scene_cache_test.src", "source" );
+
+	auto scene = crimild::alloc< Group >( "root" );
+	scene->local().setTranslate( 1.0f, 2.0f, 3.0f );
+
+	auto child = crimild::alloc< Group >( "child" );
+	child->local().setScale( 0.5f );
+	child->local().setRotate( Quaternion4f::createFromAxisAngle( Vector3f( 0.0f, 1.0f, 0.0f ), 0.25f ) );
+	child->setEnabled( false );
+	auto joint = crimild::alloc< animation::Joint >( "child", 7 );
+	Transformation offset;
+	offset.setTranslate( -1.0f, 0.0f, 4.0f );
+	joint->setOffset( offset );
+	child->attachComponent( joint );
+	scene->attachNode( child );
+
+	auto skeleton = crimild::alloc< animation::Skeleton >();
+	Transformation globalInverse;
+	globalInverse.setScale( 2.0f );
+	skeleton->setGlobalInverseTransform( globalInverse );
+	scene->attachComponent( skeleton );
+
+	unsigned char pixels[] = { 255, 0, 0, 255, 0, 255, 0, 255, 0, 0, 255, 255, 255, 255, 255, 255 };
+	auto texture = crimild::alloc< Texture >( crimild::alloc< Image >( 2, 2, 4, pixels ), "ColorMap" );
+	texture->setWrapMode( Texture::WrapMode::CLAMP_TO_EDGE );
+
+	auto material = crimild::alloc< Material >();
+	material->setDiffuse( RGBAColorf( 0.5f, 0.25f, 0.125f, 0.75f ) );
+	material->setShininess( 12.0f );
+	material->setCastShadows( false );
+	material->getAlphaState()->setEnabled( true );
+	material->setColorMap( texture );
+
+	// both geometries share the same material
+	for ( int i = 0; i < 2; i++ ) {
+		auto geometry = crimild::alloc< Geometry >( "geometry" );
+		geometry->attachPrimitive( crimild::alloc< QuadPrimitive >( 1.0f + i, 1.0f, VertexFormat::VF_P3_N3_UV2 ) );
+		geometry->getComponent< MaterialComponent >()->attachMaterial( material );
+		child->attachNode( geometry );
+	}
+
+	ASSERT_TRUE( SceneCache::write( "./scene_cache_test.cache", crimild::get_ptr( scene ), { "./scene_cache_test.src" } ) );
+
+	auto result = SceneCache::read( "./scene_cache_test.cache" );
+	ASSERT_TRUE( result != nullptr );
+	EXPECT_EQ( "root", result->getName() );
+	EXPECT_EQ( scene->getLocal().getTranslate(), result->getLocal().getTranslate() );
+	ASSERT_EQ( 1, result->getNodeCount() );
+
+	auto resultSkeleton = result->getComponent< animation::Skeleton >();
+	ASSERT_TRUE( resultSkeleton != nullptr );
+	EXPECT_EQ( 2.0f, resultSkeleton->getGlobalInverseTransform().getScale() );
+
+	auto resultChild = result->getNodeAt< Group >( 0 );
+	EXPECT_EQ( "child", resultChild->getName() );
+	EXPECT_FALSE( resultChild->isEnabled() );
+	EXPECT_EQ( 0.5f, resultChild->getLocal().getScale() );
+	EXPECT_EQ( child->getLocal().getRotate(), resultChild->getLocal().getRotate() );
+
+	auto resultJoint = resultChild->getComponent< animation::Joint >();
+	ASSERT_TRUE( resultJoint != nullptr );
+	EXPECT_EQ( "child", resultJoint->getName() );
+	EXPECT_EQ( 7, resultJoint->getId() );
+	EXPECT_EQ( offset.getTranslate(), resultJoint->getOffset().getTranslate() );
+
+	ASSERT_EQ( 2, resultChild->getNodeCount() );
+	Material *materials[ 2 ];
+	for ( int i = 0; i < 2; i++ ) {
+		auto expected = child->getNodeAt( i );
+		auto actual = resultChild->getNodeAt( i );
+		EXPECT_EQ( std::string( Geometry::__CLASS_NAME ), actual->getClassName() );
+		test::expectSamePrimitive( test::getFirstPrimitive( expected ), test::getFirstPrimitive( actual ) );
+		materials[ i ] = actual->getComponent< MaterialComponent >()->first();
+	}
+
+	ASSERT_TRUE( materials[ 0 ] != nullptr );
+	EXPECT_EQ( materials[ 0 ], materials[ 1 ] );
+	EXPECT_EQ( material->getDiffuse(), materials[ 0 ]->getDiffuse() );
+	EXPECT_EQ( 12.0f, materials[ 0 ]->getShininess() );
+	EXPECT_FALSE( materials[ 0 ]->castShadows() );
+	EXPECT_TRUE( materials[ 0 ]->receiveShadows() );
+	EXPECT_TRUE( materials[ 0 ]->getAlphaState()->isEnabled() );
+
+	auto resultTexture = materials[ 0 ]->getColorMap();
+	ASSERT_TRUE( resultTexture != nullptr );
+	EXPECT_EQ( Texture::WrapMode::CLAMP_TO_EDGE, resultTexture->getWrapMode() );
+	ASSERT_TRUE( resultTexture->getImage() != nullptr );
+	EXPECT_EQ( 2, resultTexture->getImage()->getWidth() );
+	EXPECT_EQ( 2, resultTexture->getImage()->getHeight() );
+	EXPECT_EQ( 0, memcmp( pixels, resultTexture->getImage()->getData(), sizeof( pixels ) ) );
+
+	std::remove( "./scene_cache_test.src" );
+	std::remove( "./scene_cache_test.cache" );
+}
+
+TEST( SceneCacheTest, staleSources )
+{
+	test::writeCacheSource( "./scene_cache_stale_test.src", "source" );
+
+	auto scene = crimild::alloc< Group >( "root" );
+	ASSERT_TRUE( SceneCache::write( "./scene_cache_stale_test.cache", crimild::get_ptr( scene ), { "./scene_cache_stale_test.src", "./scene_cache_missing_test.src" } ) );
+	EXPECT_TRUE( SceneCache::read( "./scene_cache_stale_test.cache" ) != nullptr );
+
+	// same size, different contents
+	test::writeCacheSource( "./scene_cache_stale_test.src", "SOURCE" );
+	EXPECT_TRUE( SceneCache::read( "./scene_cache_stale_test.cache" ) == nullptr );
+
+	test::writeCacheSource( "./scene_cache_stale_test.src", "source" );
+	ASSERT_TRUE( SceneCache::write( "./scene_cache_stale_test.cache", crimild::get_ptr( scene ), { "./scene_cache_stale_test.src", "./scene_cache_missing_test.src" } ) );
+	EXPECT_TRUE( SceneCache::read( "./scene_cache_stale_test.cache" ) != nullptr );
+
+	// a source that was missing shows up
+	test::writeCacheSource( "./scene_cache_missing_test.src", "new" );
+	EXPECT_TRUE( SceneCache::read( "./scene_cache_stale_test.cache" ) == nullptr );
+
+	std::remove( "./scene_cache_stale_test.src" );
+	std::remove( "./scene_cache_missing_test.src" );
+	std::remove( "./scene_cache_stale_test.cache" );
+
+	EXPECT_TRUE( SceneCache::read( "./scene_cache_stale_test.cache" ) == nullptr );
+}
+
+TEST( SceneCacheTest, invalidFile )
+{
+	test::writeCacheSource( "./scene_cache_invalid_test.cache", "not a cache file, but long enough to hold a header. not a cache file, but long enough to hold a header. not a cache file, but long enough to hold a header. not a cache file, but long enough to hold a header." );
+	EXPECT_TRUE( SceneCache::read( "./scene_cache_invalid_test.cache" ) == nullptr );
+	std::remove( "./scene_cache_invalid_test.cache" );
+}
+
+TEST( SceneCacheTest, unsupportedNodes )
+{
+	auto scene = crimild::alloc< Group >();
+	scene->attachNode( crimild::alloc< Light >() );
+	EXPECT_FALSE( SceneCache::write( "./scene_cache_unsupported_test.cache", crimild::get_ptr( scene ), {} ) );
+	EXPECT_TRUE( SceneCache::read( "./scene_cache_unsupported_test.cache" ) == nullptr );
+}
+
+TEST( SceneCacheTest, objLoader )
+{
+	test::writeCacheSource( "./scene_cache_obj_test.mtl",
+		"newmtl blue\n"
+		"Kd 0.0 0.0 1.0\n" );
+
+	test::writeCacheSource( "./scene_cache_obj_test.obj",
+		"mtllib scene_cache_obj_test.mtl\n"
+		"o quad\n"
+		"v 0 0 0\n"
+		"v 1 0 0\n"
+		"v 1 1 0\n"
+		"v 0 1 0\n"
+		"vn 0 0 1\n"
+		"usemtl blue\n"
+		"f 1//1 2//1 3//1\n"
+		"f 1//1 3//1 4//1\n" );
+
+	std::remove( "./scene_cache_obj_test.obj.cache" );
+
+	OBJLoader loader( "./scene_cache_obj_test.obj" );
+	loader.setCacheEnabled( true );
+	auto expected = loader.load();
+	ASSERT_TRUE( expected != nullptr );
+
+	// first load writes the cache
+	auto cached = SceneCache::read( "./scene_cache_obj_test.obj.cache" );
+	ASSERT_TRUE( cached != nullptr );
+
+	// the cache is not used unless enabled
+	std::remove( "./scene_cache_obj_test.obj.cache" );
+	ASSERT_TRUE( OBJLoader( "./scene_cache_obj_test.obj" ).load() != nullptr );
+	EXPECT_TRUE( SceneCache::read( "./scene_cache_obj_test.obj.cache" ) == nullptr );
+
+	// write it again, so the next load reads from the cache
+	ASSERT_TRUE( loader.load() != nullptr );
+
+	OBJLoader cachedLoader( "./scene_cache_obj_test.obj" );
+	cachedLoader.setCacheEnabled( true );
+	auto result = cachedLoader.load();
+	ASSERT_TRUE( result != nullptr );
+	ASSERT_EQ( 1, result->getNodeCount() );
+	EXPECT_EQ( "quad", result->getNodeAt< Group >( 0 )->getName() );
+
+	auto expectedGeometry = expected->getNodeAt< Group >( 0 )->getNodeAt( 0 );
+	auto geometry = result->getNodeAt< Group >( 0 )->getNodeAt( 0 );
+	test::expectSamePrimitive( test::getFirstPrimitive( expectedGeometry ), test::getFirstPrimitive( geometry ) );
+	EXPECT_EQ( RGBAColorf( 0.0f, 0.0f, 1.0f, 1.0f ), geometry->getComponent< MaterialComponent >()->first()->getDiffuse() );
+
+	// changing the material library invalidates the cache
+	test::writeCacheSource( "./scene_cache_obj_test.mtl",
+		"newmtl blue\n"
+		"Kd 0.0 1.0 1.0\n" );
+	EXPECT_TRUE( SceneCache::read( "./scene_cache_obj_test.obj.cache" ) == nullptr );
+
+	result = cachedLoader.load();
+	geometry = result->getNodeAt< Group >( 0 )->getNodeAt( 0 );
+	EXPECT_EQ( RGBAColorf( 0.0f, 1.0f, 1.0f, 1.0f ), geometry->getComponent< MaterialComponent >()->first()->getDiffuse() );
+
+	std::remove( "./scene_cache_obj_test.obj" );
+	std::remove( "./scene_cache_obj_test.mtl" );
+	std::remove( "./scene_cache_obj_test.obj.cache" );
+}
+
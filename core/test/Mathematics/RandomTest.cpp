@@ -0,0 +1,182 @@
+/*
+ * Copyright (c) 2013, Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "Mathematics/Random.hpp"
+
+#include "gtest/gtest.h"
+
+#include <thread>
+#include <vector>
+
+using namespace crimild;
+
+TEST( RandomTest, sameSeedSameSequence )
+{
+	Random::Generator a( 42 );
+	Random::Generator b( 42 );
+
+	for ( int i = 0; i < 100; i++ ) {
+		EXPECT_EQ( a.next(), b.next() );
+	}
+}
+
+TEST( RandomTest, streams )
+{
+	Random::Generator a( 42, 0 );
+	Random::Generator b( 42, 1 );
+	Random::Generator c( 43, 0 );
+
+	crimild::Size sameAB = 0;
+	crimild::Size sameAC = 0;
+	for ( int i = 0; i < 100; i++ ) {
+		const auto x = a.next();
+		sameAB += x == b.next() ? 1 : 0;
+		sameAC += x == c.next() ? 1 : 0;
+	}
+
+	EXPECT_EQ( 0, sameAB );
+	EXPECT_EQ( 0, sameAC );
+}
+
+TEST( RandomTest, reseed )
+{
+	Random::Generator a( 1, 2 );
+	const auto expected = a.next();
+
+	a.next();
+	a.seed( 1, 2 );
+	EXPECT_EQ( expected, a.next() );
+}
+
+TEST( RandomTest, generateRange )
+{
+	Random::Generator generator( 7 );
+
+	const int COUNT = 10000;
+	crimild::Real64 sum = 0.0;
+	for ( int i = 0; i < COUNT; i++ ) {
+		const auto r = generator.generate( -2.0, 3.0 );
+		EXPECT_GE( r, -2.0 );
+		EXPECT_LT( r, 3.0 );
+		sum += r;
+	}
+
+	EXPECT_NEAR( 0.5, sum / COUNT, 0.1 );
+}
+
+TEST( RandomTest, fill )
+{
+	// Odd count, so both vectorized loops and remainders are exercised
+	const crimild::Size COUNT = 1027;
+
+	std::vector< crimild::Real32 > a( COUNT );
+	Random::Generator( 11 ).fill( &a[ 0 ], COUNT, 5.0f, 10.0f );
+
+	crimild::Real64 sum = 0.0;
+	for ( auto v : a ) {
+		EXPECT_GE( v, 5.0f );
+		EXPECT_LT( v, 10.0f );
+		sum += v;
+	}
+	EXPECT_NEAR( 7.5, sum / COUNT, 0.25 );
+
+	std::vector< crimild::Real32 > b( COUNT );
+	Random::Generator( 11 ).fill( &b[ 0 ], COUNT, 5.0f, 10.0f );
+	EXPECT_EQ( a, b );
+}
+
+TEST( RandomTest, threadGenerator )
+{
+	Random::setSeed( 5 );
+	Random::Generator expected( 5 );
+
+	for ( int i = 0; i < 10; i++ ) {
+		EXPECT_EQ( expected.generate(), Random::generate< crimild::Real64 >() );
+	}
+
+	// Other threads are not affected by the seed
+	crimild::Real64 other = 0.0;
+	std::thread t( [ &other ] {
+		other = Random::generate< crimild::Real64 >();
+	});
+	t.join();
+	EXPECT_NE( Random::Generator( 5 ).generate(), other );
+}
+
+TEST( RandomTest, scopedGenerator )
+{
+	Random::Generator generator( 3 );
+	Random::Generator expected( 3 );
+
+	auto &previous = Random::getGenerator();
+	{
+		Random::ScopedGenerator scope( generator );
+		EXPECT_EQ( &generator, &Random::getGenerator() );
+		EXPECT_EQ( expected.generate( 1.0, 2.0 ), Random::generate< crimild::Real64 >( 1.0, 2.0 ) );
+	}
+	EXPECT_EQ( &previous, &Random::getGenerator() );
+}
+
+TEST( RandomTest, streamsPerJobAreReproducible )
+{
+	const crimild::Size JOBS = 64;
+	const crimild::Size VALUES = 100;
+
+	auto run = [ JOBS, VALUES ]( crimild::Size threadCount ) {
+		std::vector< crimild::Real32 > result( JOBS * VALUES );
+		std::vector< std::thread > threads;
+		for ( crimild::Size t = 0; t < threadCount; t++ ) {
+			threads.push_back( std::thread( [ &result, t, threadCount, JOBS, VALUES ] {
+				for ( crimild::Size job = t; job < JOBS; job += threadCount ) {
+					Random::Generator generator( 1234, job );
+					generator.fill( &result[ job * VALUES ], VALUES, 0.0f, 1.0f );
+				}
+			}));
+		}
+		for ( auto &t : threads ) {
+			t.join();
+		}
+		return result;
+	};
+
+	const auto serial = run( 1 );
+	EXPECT_EQ( serial, run( 3 ) );
+	EXPECT_EQ( serial, run( 8 ) );
+}
+
+TEST( RandomTest, shuffle )
+{
+	std::vector< int > a { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9 };
+	auto b = a;
+
+	Random::setSeed( 99 );
+	Random::shuffle( a );
+	Random::setSeed( 99 );
+	Random::shuffle( b );
+
+	EXPECT_EQ( a, b );
+}
@@ -30,6 +30,10 @@
 
 #include "gtest/gtest.h"
 
+#include <memory>
+#include <thread>
+#include <vector>
+
 using namespace crimild;
 
 TEST( MessageQueueTest, broadcastMessage )
@@ -128,3 +132,151 @@ TEST( MessageQueueTest, pushMessageWithoutHandlers )
 	MessageQueue::getInstance()->pushMessage( MockMessage { } );
 }
 
+TEST( MessageQueueTest, manyHandlers )
+{
+	std::vector< std::unique_ptr< MockMessenger >> ms;
+	for ( int i = 0; i < 100; i++ ) {
+		ms.push_back( std::unique_ptr< MockMessenger >( new MockMessenger() ) );
+	}
+
+	MessageQueue::getInstance()->broadcastMessage( MockMessage { } );
+
+	// remove every other messenger
+	for ( int i = 0; i < 100; i += 2 ) {
+		ms[ i ] = nullptr;
+	}
+
+	MessageQueue::getInstance()->broadcastMessage( MockMessage { } );
+
+	for ( int i = 1; i < 100; i += 2 ) {
+		EXPECT_EQ( 2, ms[ i ]->getCallCount() );
+	}
+}
+
+TEST( MessageQueueTest, registerHandlerDuringBroadcast )
+{
+	int count = 0;
+
+	Messenger m1;
+	Messenger m2;
+	m1.registerMessageHandler< MockMessage >( [&]( MockMessage const & ) {
+		m2.registerMessageHandler< MockMessage >( [&]( MockMessage const & ) {
+			count += 10;
+		});
+		count++;
+	});
+
+	// New handlers are used starting with the next broadcast
+	m1.broadcastMessage( MockMessage {} );
+	EXPECT_EQ( 1, count );
+
+	m1.broadcastMessage( MockMessage {} );
+	EXPECT_EQ( 12, count );
+}
+
+namespace crimild {
+
+	struct MessageQueueTestValue {
+		crimild::Int32 value;
+		crimild::Int32 producer;
+	};
+
+	struct MessageQueueTestDropped {
+		crimild::Int32 value;
+	};
+
+}
+
+TEST( MessageQueueTest, pushMessageFromThreads )
+{
+	const crimild::Int32 PRODUCERS = 4;
+	const crimild::Int32 COUNT = 500;
+
+	std::vector< std::vector< crimild::Int32 >> received( PRODUCERS );
+	Messenger m;
+	m.registerMessageHandler< MessageQueueTestValue >( [ &received ]( MessageQueueTestValue const &message ) {
+		received[ message.producer ].push_back( message.value );
+	});
+
+	MessageQueue::getInstance()->resetDeferredMessageStats();
+
+	std::vector< std::thread > threads;
+	for ( crimild::Int32 p = 0; p < PRODUCERS; p++ ) {
+		threads.push_back( std::thread( [ p, COUNT ] {
+			for ( crimild::Int32 i = 0; i < COUNT; i++ ) {
+				MessageQueue::getInstance()->pushMessage( MessageQueueTestValue { i, p } );
+			}
+		}));
+	}
+	for ( auto &t : threads ) {
+		t.join();
+	}
+
+	// more messages than the queue capacity, so some of them were spilled
+	MessageQueue::getInstance()->dispatchDeferredMessages();
+
+	for ( crimild::Int32 p = 0; p < PRODUCERS; p++ ) {
+		ASSERT_EQ( COUNT, received[ p ].size() );
+		for ( crimild::Int32 i = 0; i < COUNT; i++ ) {
+			EXPECT_EQ( i, received[ p ][ i ] );
+		}
+	}
+
+	auto stats = MessageQueue::getInstance()->getDeferredMessageStats< MessageQueueTestValue >();
+	EXPECT_EQ( PRODUCERS * COUNT, stats.pushed );
+	EXPECT_EQ( PRODUCERS * COUNT, stats.dispatched );
+	EXPECT_EQ( PRODUCERS * COUNT - 1024, stats.spilled );
+	EXPECT_EQ( 0, stats.dropped );
+	EXPECT_EQ( 1, stats.batchCount );
+	EXPECT_LE( 0.0, stats.getAverageLatency() );
+	EXPECT_LE( stats.getAverageLatency(), stats.maxLatency );
+}
+
+TEST( MessageQueueTest, dropDeferredMessages )
+{
+	auto queue = MessageQueue::getInstance();
+	queue->setDeferredMessageCapacity< MessageQueueTestDropped >( 4 );
+	queue->setDeferredMessagePolicy< MessageQueueTestDropped >( DeferredMessagePolicy::DROP );
+
+	std::vector< crimild::Int32 > received;
+	Messenger m;
+	m.registerMessageHandler< MessageQueueTestDropped >( [ &received ]( MessageQueueTestDropped const &message ) {
+		received.push_back( message.value );
+	});
+
+	for ( crimild::Int32 i = 0; i < 10; i++ ) {
+		queue->pushMessage( MessageQueueTestDropped { i } );
+	}
+	queue->dispatchDeferredMessages();
+
+	ASSERT_EQ( 4, received.size() );
+	EXPECT_EQ( 0, received[ 0 ] );
+	EXPECT_EQ( 3, received[ 3 ] );
+
+	auto stats = queue->getDeferredMessageStats< MessageQueueTestDropped >();
+	EXPECT_EQ( 10, stats.pushed );
+	EXPECT_EQ( 4, stats.dispatched );
+	EXPECT_EQ( 6, stats.dropped );
+}
+
+TEST( MessageQueueTest, pushMessageDuringDispatch )
+{
+	auto queue = MessageQueue::getInstance();
+
+	int count = 0;
+	Messenger m;
+	m.registerMessageHandler< MockMessage >( [ &count, queue ]( MockMessage const & ) {
+		if ( count++ == 0 ) {
+			queue->pushMessage( MockMessage { } );
+		}
+	});
+
+	queue->pushMessage( MockMessage { } );
+	queue->dispatchDeferredMessages();
+	EXPECT_EQ( 1, count );
+
+	// new messages are dispatched in the next frame
+	queue->dispatchDeferredMessages();
+	EXPECT_EQ( 2, count );
+}
+
@@ -0,0 +1,146 @@
+/*
+ * Copyright (c) 2013, Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "ParticleSystem/ParticleData.hpp"
+#include "ParticleSystem/Updaters/TimeParticleUpdater.hpp"
+
+#include "gtest/gtest.h"
+
+using namespace crimild;
+
+/**
+	\brief Wakes count particles, storing their index as the time attribute
+*/
+static crimild::Real32 *wakeParticles( ParticleData &particles, crimild::Size count )
+{
+	particles.createAttribArray< crimild::Real32 >( ParticleAttrib::TIME );
+	particles.createAttribArray< Vector3f >( ParticleAttrib::POSITION );
+	particles.generate();
+
+	auto ts = particles.getAttrib( ParticleAttrib::TIME )->getData< crimild::Real32 >();
+	auto ps = particles.getAttrib( ParticleAttrib::POSITION )->getData< Vector3f >();
+	for ( crimild::Size i = 0; i < count; i++ ) {
+		particles.wake( i );
+		ts[ i ] = i;
+		ps[ i ] = Vector3f( i, 0.0f, 0.0f );
+	}
+	return ts;
+}
+
+TEST( ParticleDataTest, killIsDeferred )
+{
+	ParticleData particles( 10 );
+	wakeParticles( particles, 10 );
+
+	particles.kill( 2 );
+	particles.kill( 2 );
+
+	EXPECT_FALSE( particles.isAlive( 2 ) );
+	EXPECT_EQ( 10, particles.getAliveCount() );
+	EXPECT_EQ( 1, particles.getPendingKillCount() );
+
+	particles.compact();
+
+	EXPECT_EQ( 9, particles.getAliveCount() );
+	EXPECT_EQ( 0, particles.getPendingKillCount() );
+}
+
+TEST( ParticleDataTest, compactFillsHoles )
+{
+	ParticleData particles( 10 );
+	auto ts = wakeParticles( particles, 8 );
+
+	particles.kill( 0 );
+	particles.kill( 3 );
+	particles.kill( 4 );
+	particles.kill( 7 );
+	particles.compact();
+
+	ASSERT_EQ( 4, particles.getAliveCount() );
+
+	auto ps = particles.getAttrib( ParticleAttrib::POSITION )->getData< Vector3f >();
+	// Holes are filled by the alive particles past the new end, in order
+	const crimild::Real32 expected[] = { 5, 1, 2, 6 };
+	for ( crimild::Size i = 0; i < 4; i++ ) {
+		EXPECT_EQ( expected[ i ], ts[ i ] );
+		EXPECT_EQ( expected[ i ], ps[ i ][ 0 ] );
+		EXPECT_TRUE( particles.isAlive( i ) );
+	}
+	for ( crimild::Size i = 4; i < 10; i++ ) {
+		EXPECT_FALSE( particles.isAlive( i ) );
+	}
+
+	// New particles are appended after the compacted range
+	particles.wake( 4 );
+	EXPECT_EQ( 5, particles.getAliveCount() );
+}
+
+TEST( ParticleDataTest, compactAll )
+{
+	ParticleData particles( 10 );
+	wakeParticles( particles, 10 );
+
+	for ( crimild::Size i = 0; i < 10; i++ ) {
+		particles.kill( 9 - i );
+	}
+	particles.compact();
+
+	EXPECT_EQ( 0, particles.getAliveCount() );
+
+	// nothing to do
+	particles.compact();
+	EXPECT_EQ( 0, particles.getAliveCount() );
+}
+
+TEST( ParticleDataTest, timeUpdaterKillsAllExpired )
+{
+	ParticleData particles( 10 );
+
+	TimeParticleUpdater updater;
+	updater.configure( nullptr, &particles );
+
+	auto ts = wakeParticles( particles, 6 );
+
+	// Swapping on kill used to move the last (expired) particle into
+	// the slot of the second one, where it was skipped for the frame
+	const crimild::Real32 times[] = { 0.5f, 0.5f, 2.0f, 0.5f, 3.0f, 0.5f };
+	for ( crimild::Size i = 0; i < 6; i++ ) {
+		ts[ i ] = times[ i ];
+	}
+
+	updater.update( nullptr, 1.0, &particles );
+
+	ASSERT_EQ( 2, particles.getAliveCount() );
+	EXPECT_FLOAT_EQ( 1.0f, ts[ 0 ] );
+	EXPECT_FLOAT_EQ( 2.0f, ts[ 1 ] );
+
+	auto ps = particles.getAttrib( ParticleAttrib::POSITION )->getData< Vector3f >();
+	EXPECT_EQ( 2.0f, ps[ 0 ][ 0 ] );
+	EXPECT_EQ( 4.0f, ps[ 1 ][ 0 ] );
+}
+
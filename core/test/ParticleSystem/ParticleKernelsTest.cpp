@@ -0,0 +1,248 @@
+/*
+ * Copyright (c) 2013, Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "ParticleSystem/ParticleData.hpp"
+#include "ParticleSystem/ParticleKernels.hpp"
+#include "ParticleSystem/Updaters/EulerParticleUpdater.hpp"
+#include "ParticleSystem/Updaters/AttractorParticleUpdater.hpp"
+#include "Concurrency/JobScheduler.hpp"
+
+#include "gtest/gtest.h"
+
+#include <cmath>
+#include <mutex>
+#include <vector>
+
+using namespace crimild;
+
+static crimild::Real32 noise( crimild::Size i )
+{
+	return static_cast< crimild::Real32 >( ( i * 7919 ) % 1000 ) / 100.0f - 5.0f;
+}
+
+// Odd count, so both vectorized loops and remainders are exercised
+static const crimild::Size KERNEL_TEST_COUNT = 1027;
+
+TEST( ParticleKernelsTest, addScaled )
+{
+	std::vector< Vector3f > dst( KERNEL_TEST_COUNT );
+	std::vector< Vector3f > src( KERNEL_TEST_COUNT );
+	for ( crimild::Size i = 0; i < KERNEL_TEST_COUNT; i++ ) {
+		dst[ i ] = Vector3f( noise( i ), noise( i + 1 ), noise( i + 2 ) );
+		src[ i ] = Vector3f( noise( i + 3 ), noise( i + 4 ), noise( i + 5 ) );
+	}
+	auto expected = dst;
+
+	ParticleKernels::add( &dst[ 0 ], Vector3f( 1.0f, 2.0f, 3.0f ), KERNEL_TEST_COUNT );
+	ParticleKernels::addScaled( &dst[ 0 ], &src[ 0 ], 0.5f, KERNEL_TEST_COUNT );
+
+	for ( crimild::Size i = 0; i < KERNEL_TEST_COUNT; i++ ) {
+		expected[ i ] += Vector3f( 1.0f, 2.0f, 3.0f );
+		expected[ i ] += 0.5f * src[ i ];
+		for ( int j = 0; j < 3; j++ ) {
+			EXPECT_FLOAT_EQ( expected[ i ][ j ], dst[ i ][ j ] );
+		}
+	}
+}
+
+TEST( ParticleKernelsTest, lerpByAge )
+{
+	std::vector< crimild::Real32 > times( KERNEL_TEST_COUNT );
+	std::vector< crimild::Real32 > lifetimes( KERNEL_TEST_COUNT, 2.0f );
+	std::vector< crimild::Real32 > start( KERNEL_TEST_COUNT, 1.0f );
+	std::vector< crimild::Real32 > end( KERNEL_TEST_COUNT, 3.0f );
+	std::vector< crimild::Real32 > scales( KERNEL_TEST_COUNT );
+	std::vector< RGBAColorf > startColors( KERNEL_TEST_COUNT, RGBAColorf( 1.0f, 0.0f, 0.0f, 1.0f ) );
+	std::vector< RGBAColorf > endColors( KERNEL_TEST_COUNT, RGBAColorf( 0.0f, 0.0f, 1.0f, 0.0f ) );
+	std::vector< RGBAColorf > colors( KERNEL_TEST_COUNT );
+	for ( crimild::Size i = 0; i < KERNEL_TEST_COUNT; i++ ) {
+		times[ i ] = 2.0f * static_cast< crimild::Real32 >( i ) / KERNEL_TEST_COUNT;
+	}
+
+	ParticleKernels::subtract( &times[ 0 ], 0.5f, KERNEL_TEST_COUNT );
+	ParticleKernels::lerpByAge( &scales[ 0 ], &start[ 0 ], &end[ 0 ], &times[ 0 ], &lifetimes[ 0 ], KERNEL_TEST_COUNT );
+	ParticleKernels::lerpByAge( &colors[ 0 ], &startColors[ 0 ], &endColors[ 0 ], &times[ 0 ], &lifetimes[ 0 ], KERNEL_TEST_COUNT );
+
+	for ( crimild::Size i = 0; i < KERNEL_TEST_COUNT; i++ ) {
+		const auto time = 2.0f * static_cast< crimild::Real32 >( i ) / KERNEL_TEST_COUNT - 0.5f;
+		EXPECT_FLOAT_EQ( time, times[ i ] );
+
+		const auto t = 1.0f - time / 2.0f;
+		EXPECT_NEAR( 1.0f + 2.0f * t, scales[ i ], 1e-5f );
+		EXPECT_NEAR( 1.0f - t, colors[ i ][ 0 ], 1e-5f );
+		EXPECT_NEAR( 0.0f, colors[ i ][ 1 ], 1e-5f );
+		EXPECT_NEAR( t, colors[ i ][ 2 ], 1e-5f );
+		EXPECT_NEAR( 1.0f - t, colors[ i ][ 3 ], 1e-5f );
+	}
+}
+
+TEST( ParticleKernelsTest, attract )
+{
+	std::vector< Vector3f > positions( KERNEL_TEST_COUNT );
+	std::vector< Vector3f > accelerations( KERNEL_TEST_COUNT, Vector3f::ZERO );
+	for ( crimild::Size i = 0; i < KERNEL_TEST_COUNT; i++ ) {
+		positions[ i ] = Vector3f( noise( i ), noise( i + 1 ), noise( i + 2 ) );
+	}
+	// A particle at the very center must not be affected
+	positions[ 5 ] = Vector3f::ZERO;
+
+	const crimild::Real32 radius = 4.0f;
+	const crimild::Real32 strength = 2.0f;
+	ParticleKernels::attract( &accelerations[ 0 ], &positions[ 0 ], Vector3f::ZERO, radius, strength, KERNEL_TEST_COUNT );
+
+	crimild::Size affected = 0;
+	for ( crimild::Size i = 0; i < KERNEL_TEST_COUNT; i++ ) {
+		auto direction = -positions[ i ];
+		auto d = direction.getMagnitude();
+		auto expected = Vector3f::ZERO;
+		if ( d > 0.0f && d <= radius ) {
+			expected = ( strength * ( 1.0f - d / radius ) / d ) * direction;
+			affected++;
+		}
+		for ( int j = 0; j < 3; j++ ) {
+			EXPECT_NEAR( expected[ j ], accelerations[ i ][ j ], 1e-4f );
+		}
+	}
+
+	EXPECT_GT( affected, 0 );
+	EXPECT_LT( affected, KERNEL_TEST_COUNT );
+}
+
+TEST( ParticleKernelsTest, transformPoints )
+{
+	std::vector< Vector3f > src( KERNEL_TEST_COUNT );
+	std::vector< Vector3f > dst( KERNEL_TEST_COUNT );
+	for ( crimild::Size i = 0; i < KERNEL_TEST_COUNT; i++ ) {
+		src[ i ] = Vector3f( noise( i ), noise( i + 1 ), noise( i + 2 ) );
+	}
+
+	Transformation t;
+	t.setTranslate( 1.0f, -2.0f, 3.0f );
+	t.rotate().fromAxisAngle( Vector3f( 1.0f, 1.0f, 0.0f ).getNormalized(), 0.7f );
+	t.setScale( 2.5f );
+
+	ParticleKernels::transformPoints( &dst[ 0 ], &src[ 0 ], t.getInverse(), KERNEL_TEST_COUNT );
+
+	for ( crimild::Size i = 0; i < KERNEL_TEST_COUNT; i++ ) {
+		Vector3f expected;
+		t.applyInverseToPoint( src[ i ], expected );
+		for ( int j = 0; j < 3; j++ ) {
+			EXPECT_NEAR( expected[ j ], dst[ i ][ j ], 1e-4f );
+		}
+	}
+}
+
+TEST( ParticleKernelsTest, computeBounds )
+{
+	std::vector< Vector3f > ps( KERNEL_TEST_COUNT );
+	for ( crimild::Size i = 0; i < KERNEL_TEST_COUNT; i++ ) {
+		ps[ i ] = Vector3f( noise( i ), noise( i + 1 ), noise( i + 2 ) );
+	}
+
+	// Extremes in the remainder, so they are not hidden by the vectorized loop
+	ps[ KERNEL_TEST_COUNT - 1 ] = Vector3f( -20.0f, 30.0f, 0.0f );
+	ps[ KERNEL_TEST_COUNT - 2 ] = Vector3f( 0.0f, -40.0f, 50.0f );
+
+	Vector3f min, max;
+	ParticleKernels::computeBounds( &ps[ 0 ], KERNEL_TEST_COUNT, min, max );
+
+	EXPECT_EQ( Vector3f( -20.0f, -40.0f, -5.0f ), min );
+	EXPECT_EQ( Vector3f( 999.0f / 100.0f - 5.0f, 30.0f, 50.0f ), max );
+
+	// A single particle only goes through the scalar path
+	ParticleKernels::computeBounds( &ps[ 0 ], 1, min, max );
+	EXPECT_EQ( ps[ 0 ], min );
+	EXPECT_EQ( ps[ 0 ], max );
+}
+
+static void runEuler( ParticleData &particles, crimild::Size count )
+{
+	EulerParticleUpdater updater;
+	updater.setGlobalAcceleration( Vector3f( 0.0f, -9.8f, 0.0f ) );
+	updater.configure( nullptr, &particles );
+
+	AttractorParticleUpdater attractor;
+	attractor.setAttractor( Sphere3f( Vector3f::ZERO, 10.0f ) );
+	attractor.configure( nullptr, &particles );
+
+	particles.generate();
+	auto ps = particles.getAttrib( ParticleAttrib::POSITION )->getData< Vector3f >();
+	for ( crimild::Size i = 0; i < count; i++ ) {
+		particles.wake( i );
+		ps[ i ] = Vector3f( noise( i ), noise( i + 1 ), noise( i + 2 ) );
+	}
+
+	for ( int step = 0; step < 10; step++ ) {
+		attractor.update( nullptr, 0.016, &particles );
+		updater.update( nullptr, 0.016, &particles );
+	}
+}
+
+TEST( ParticleKernelsTest, parallelUpdateMatchesSerial )
+{
+	const crimild::Size COUNT = 10003;
+
+	ParticleData serial( COUNT );
+	runEuler( serial, COUNT );
+
+	concurrency::JobScheduler scheduler;
+	scheduler.configure( 2 );
+	scheduler.start();
+
+	ParticleData parallel( COUNT );
+	parallel.setParallelThreshold( 1 );
+
+	crimild::Size processed = 0;
+	crimild::Size blocks = 0;
+	std::mutex mutex;
+	parallel.generate();
+	for ( crimild::Size i = 0; i < 100; i++ ) {
+		parallel.wake( i );
+	}
+	parallel.eachAliveBlock( [ &]( crimild::Size begin, crimild::Size end ) {
+		std::lock_guard< std::mutex > lock( mutex );
+		EXPECT_EQ( 0, begin % 8 );
+		processed += end - begin;
+		blocks++;
+	});
+	EXPECT_EQ( 100, processed );
+	EXPECT_GT( blocks, 1 );
+
+	runEuler( parallel, COUNT );
+
+	scheduler.stop();
+
+	auto expected = serial.getAttrib( ParticleAttrib::POSITION )->getData< Vector3f >();
+	auto actual = parallel.getAttrib( ParticleAttrib::POSITION )->getData< Vector3f >();
+	for ( crimild::Size i = 0; i < COUNT; i++ ) {
+		for ( int j = 0; j < 3; j++ ) {
+			ASSERT_FLOAT_EQ( expected[ i ][ j ], actual[ i ][ j ] );
+		}
+	}
+}
+
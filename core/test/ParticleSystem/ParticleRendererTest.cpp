@@ -0,0 +1,185 @@
+/*
+ * Copyright (c) 2013, Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "ParticleSystem/ParticleData.hpp"
+#include "ParticleSystem/Renderers/InstancedQuadParticleRenderer.hpp"
+#include "ParticleSystem/Renderers/PointSpriteParticleRenderer.hpp"
+#include "SceneGraph/Group.hpp"
+#include "Simulation/AssetManager.hpp"
+
+#include "gtest/gtest.h"
+
+using namespace crimild;
+
+static const crimild::Size RENDERER_TEST_COUNT = 100;
+static const crimild::Size RENDERER_TEST_ALIVE = 10;
+
+static void wakeParticles( ParticleData &particles )
+{
+	particles.createAttribArray< Vector3f >( ParticleAttrib::POSITION );
+	particles.createAttribArray< RGBAColorf >( ParticleAttrib::COLOR );
+	particles.createAttribArray< crimild::Real32 >( ParticleAttrib::UNIFORM_SCALE );
+	particles.generate();
+
+	auto ps = particles.getAttrib( ParticleAttrib::POSITION )->getData< Vector3f >();
+	auto cs = particles.getAttrib( ParticleAttrib::COLOR )->getData< RGBAColorf >();
+	auto ss = particles.getAttrib( ParticleAttrib::UNIFORM_SCALE )->getData< crimild::Real32 >();
+	for ( crimild::Size i = 0; i < RENDERER_TEST_ALIVE; i++ ) {
+		particles.wake( i );
+		ps[ i ] = Vector3f( i, 2.0f * i, 3.0f * i );
+		cs[ i ] = RGBAColorf( 1.0f, 0.5f, 0.25f, 0.1f * i );
+		ss[ i ] = 0.5f + i;
+	}
+}
+
+static Primitive *getPrimitive( Group *node )
+{
+	Primitive *result = nullptr;
+	node->getNodeAt< Geometry >( 0 )->forEachPrimitive( [ &result ]( Primitive *primitive ) {
+		result = primitive;
+	});
+	return result;
+}
+
+TEST( ParticleRendererTest, instancedQuad )
+{
+	AssetManager assets;
+
+	ParticleData particles( RENDERER_TEST_COUNT );
+	particles.setComputeInWorldSpace( true );
+	wakeParticles( particles );
+
+	auto node = crimild::alloc< Group >();
+	node->world().setTranslate( 1.0f, 2.0f, 3.0f );
+	node->world().setScale( 2.0f );
+
+	auto renderer = crimild::alloc< InstancedQuadParticleRenderer >();
+	renderer->configure( crimild::get_ptr( node ), &particles );
+	renderer->update( crimild::get_ptr( node ), 0.016, &particles );
+
+	auto primitive = getPrimitive( crimild::get_ptr( node ) );
+	ASSERT_NE( nullptr, primitive );
+	EXPECT_TRUE( primitive->isInstanced() );
+	EXPECT_EQ( 4, primitive->getVertexBuffer()->getVertexCount() );
+	EXPECT_EQ( 6, primitive->getIndexBuffer()->getIndexCount() );
+	EXPECT_EQ( RENDERER_TEST_ALIVE, primitive->getInstanceCount() );
+
+	auto instances = primitive->getInstanceBuffer();
+	EXPECT_EQ( RENDERER_TEST_COUNT, instances->getCapacity() / instances->getVertexFormat().getVertexSize() );
+
+	auto ps = particles.getAttrib( ParticleAttrib::POSITION )->getData< Vector3f >();
+	auto cs = particles.getAttrib( ParticleAttrib::COLOR )->getData< RGBAColorf >();
+	auto ss = particles.getAttrib( ParticleAttrib::UNIFORM_SCALE )->getData< crimild::Real32 >();
+	for ( crimild::Size i = 0; i < RENDERER_TEST_ALIVE; i++ ) {
+		Vector3f expected;
+		node->getWorld().applyInverseToPoint( ps[ i ], expected );
+		EXPECT_EQ( expected, instances->getPositionAt( i ) );
+		EXPECT_EQ( cs[ i ], instances->getRGBAColorAt( i ) );
+		EXPECT_EQ( ss[ i ], instances->getTextureCoordAt( i )[ 0 ] );
+	}
+
+	// only per-instance data is uploaded
+	EXPECT_EQ( RENDERER_TEST_ALIVE * instances->getVertexFormat().getVertexSizeInBytes(), renderer->getStats().uploadedBytes );
+
+	// no particles, no instances
+	particles.generate();
+	renderer->update( crimild::get_ptr( node ), 0.016, &particles );
+	EXPECT_EQ( 0, primitive->getInstanceCount() );
+	EXPECT_EQ( 0, renderer->getStats().uploadedBytes );
+}
+
+TEST( ParticleRendererTest, instancedQuadWithoutOptionalAttribs )
+{
+	AssetManager assets;
+
+	ParticleData particles( RENDERER_TEST_COUNT );
+	particles.setComputeInWorldSpace( false );
+	particles.createAttribArray< Vector3f >( ParticleAttrib::POSITION );
+	particles.generate();
+
+	auto ps = particles.getAttrib( ParticleAttrib::POSITION )->getData< Vector3f >();
+	for ( crimild::Size i = 0; i < RENDERER_TEST_ALIVE; i++ ) {
+		particles.wake( i );
+		ps[ i ] = Vector3f( i, 2.0f * i, 3.0f * i );
+	}
+
+	auto node = crimild::alloc< Group >();
+
+	auto renderer = crimild::alloc< InstancedQuadParticleRenderer >();
+	renderer->configure( crimild::get_ptr( node ), &particles );
+	renderer->update( crimild::get_ptr( node ), 0.016, &particles );
+
+	auto primitive = getPrimitive( crimild::get_ptr( node ) );
+	ASSERT_NE( nullptr, primitive );
+	EXPECT_EQ( RENDERER_TEST_ALIVE, primitive->getInstanceCount() );
+
+	auto instances = primitive->getInstanceBuffer();
+	for ( crimild::Size i = 0; i < RENDERER_TEST_ALIVE; i++ ) {
+		EXPECT_EQ( ps[ i ], instances->getPositionAt( i ) );
+		EXPECT_EQ( RGBAColorf::ONE, instances->getRGBAColorAt( i ) );
+		EXPECT_EQ( 1.0f, instances->getTextureCoordAt( i )[ 0 ] );
+	}
+}
+
+TEST( ParticleRendererTest, pointSpriteReusesBuffers )
+{
+	AssetManager assets;
+
+	ParticleData particles( RENDERER_TEST_COUNT );
+	wakeParticles( particles );
+
+	auto node = crimild::alloc< Group >();
+
+	auto renderer = crimild::alloc< PointSpriteParticleRenderer >();
+	renderer->configure( crimild::get_ptr( node ), &particles );
+	renderer->update( crimild::get_ptr( node ), 0.016, &particles );
+
+	auto primitive = getPrimitive( crimild::get_ptr( node ) );
+	ASSERT_NE( nullptr, primitive );
+	EXPECT_FALSE( primitive->isInstanced() );
+
+	auto vbo = primitive->getVertexBuffer();
+	const auto data = vbo->getData();
+	EXPECT_EQ( RENDERER_TEST_ALIVE, vbo->getVertexCount() );
+
+	auto ps = particles.getAttrib( ParticleAttrib::POSITION )->getData< Vector3f >();
+	auto cs = particles.getAttrib( ParticleAttrib::COLOR )->getData< RGBAColorf >();
+	auto ss = particles.getAttrib( ParticleAttrib::UNIFORM_SCALE )->getData< crimild::Real32 >();
+	for ( crimild::Size i = 0; i < RENDERER_TEST_ALIVE; i++ ) {
+		EXPECT_EQ( ps[ i ], vbo->getPositionAt( i ) );
+		EXPECT_EQ( cs[ i ], vbo->getRGBAColorAt( i ) );
+		EXPECT_EQ( ss[ i ], vbo->getTextureCoordAt( i )[ 0 ] );
+	}
+
+	const auto version = vbo->getVersion();
+	renderer->update( crimild::get_ptr( node ), 0.016, &particles );
+	EXPECT_EQ( data, vbo->getData() );
+	EXPECT_EQ( version + 1, vbo->getVersion() );
+	EXPECT_EQ( vbo->getSizeInBytes(), renderer->getStats().uploadedBytes );
+}
+
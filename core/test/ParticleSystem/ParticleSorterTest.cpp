@@ -0,0 +1,148 @@
+/*
+ * Copyright (c) 2013, Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "ParticleSystem/ParticleSorter.hpp"
+
+#include "gtest/gtest.h"
+
+#include <vector>
+
+using namespace crimild;
+
+/**
+	\brief Wakes particles storing their keys as both time and position
+*/
+static void wakeWithKeys( ParticleData &particles, std::vector< crimild::Real32 > const &keys )
+{
+	particles.createAttribArray< crimild::Real32 >( ParticleAttrib::TIME );
+	particles.createAttribArray< Vector3f >( ParticleAttrib::POSITION );
+	particles.generate();
+
+	auto ts = particles.getAttrib( ParticleAttrib::TIME )->getData< crimild::Real32 >();
+	auto ps = particles.getAttrib( ParticleAttrib::POSITION )->getData< Vector3f >();
+	for ( crimild::Size i = 0; i < keys.size(); i++ ) {
+		particles.wake( i );
+		ts[ i ] = keys[ i ];
+		ps[ i ] = Vector3f( 0.0f, 0.0f, keys[ i ] );
+	}
+}
+
+static std::vector< crimild::Real32 > generateKeys( crimild::Size count )
+{
+	std::vector< crimild::Real32 > keys( count );
+	crimild::UInt32 seed = 1;
+	for ( crimild::Size i = 0; i < count; i++ ) {
+		seed = seed * 1664525u + 1013904223u;
+		keys[ i ] = static_cast< crimild::Real32 >( static_cast< crimild::Int32 >( seed >> 8 ) - ( 1 << 23 ) ) / 1000.0f;
+	}
+	return keys;
+}
+
+static void expectSorted( ParticleData &particles, ParticleSorter::Order order )
+{
+	const auto count = particles.getAliveCount();
+	auto ts = particles.getAttrib( ParticleAttrib::TIME )->getData< crimild::Real32 >();
+	auto ps = particles.getAttrib( ParticleAttrib::POSITION )->getData< Vector3f >();
+	for ( crimild::Size i = 0; i < count; i++ ) {
+		// all attributes must be permuted in the same way
+		ASSERT_EQ( ts[ i ], ps[ i ].z() );
+		if ( i > 0 ) {
+			if ( order == ParticleSorter::Order::ASCENDING ) {
+				ASSERT_LE( ts[ i - 1 ], ts[ i ] );
+			}
+			else {
+				ASSERT_GE( ts[ i - 1 ], ts[ i ] );
+			}
+		}
+	}
+}
+
+TEST( ParticleSorterTest, radixSort )
+{
+	auto keys = generateKeys( 1000 );
+	keys[ 10 ] = 0.0f;
+	keys[ 20 ] = -0.0f;
+	keys[ 30 ] = keys[ 40 ];
+
+	ParticleData particles( 1000 );
+	ParticleSorter sorter;
+
+	wakeWithKeys( particles, keys );
+	EXPECT_EQ( ParticleSorter::Result::RADIX, sorter.sort( &particles, &keys[ 0 ], ParticleSorter::Order::ASCENDING ) );
+	expectSorted( particles, ParticleSorter::Order::ASCENDING );
+
+	wakeWithKeys( particles, keys );
+	EXPECT_EQ( ParticleSorter::Result::RADIX, sorter.sort( &particles, &keys[ 0 ], ParticleSorter::Order::DESCENDING ) );
+	expectSorted( particles, ParticleSorter::Order::DESCENDING );
+}
+
+TEST( ParticleSorterTest, incremental )
+{
+	const crimild::Size COUNT = 1000;
+
+	ParticleData particles( COUNT );
+	ParticleSorter sorter;
+	sorter.setIncremental( true );
+
+	// random keys have too many inversions for insertion sort
+	auto keys = generateKeys( COUNT );
+	wakeWithKeys( particles, keys );
+	EXPECT_EQ( ParticleSorter::Result::RADIX, sorter.sort( &particles, &keys[ 0 ], ParticleSorter::Order::ASCENDING ) );
+	expectSorted( particles, ParticleSorter::Order::ASCENDING );
+
+	auto ts = particles.getAttrib( ParticleAttrib::TIME )->getData< crimild::Real32 >();
+	keys.assign( ts, ts + COUNT );
+	EXPECT_EQ( ParticleSorter::Result::UNCHANGED, sorter.sort( &particles, &keys[ 0 ], ParticleSorter::Order::ASCENDING ) );
+
+	// Swapping a few neighbours is fixed with insertion sort
+	for ( crimild::Size i = 0; i + 1 < COUNT; i += 50 ) {
+		std::swap( keys[ i ], keys[ i + 1 ] );
+	}
+	wakeWithKeys( particles, keys );
+	EXPECT_EQ( ParticleSorter::Result::INCREMENTAL, sorter.sort( &particles, &keys[ 0 ], ParticleSorter::Order::ASCENDING ) );
+	expectSorted( particles, ParticleSorter::Order::ASCENDING );
+}
+
+TEST( ParticleSorterTest, compactsBeforeSorting )
+{
+	std::vector< crimild::Real32 > keys = { 5.0f, 4.0f, 3.0f, 2.0f, 1.0f };
+
+	ParticleData particles( 5 );
+	wakeWithKeys( particles, keys );
+	particles.kill( 1 );
+
+	// keys are expected for alive particles after compaction: 5, 1, 3, 2
+	std::vector< crimild::Real32 > compactedKeys = { 5.0f, 1.0f, 3.0f, 2.0f };
+
+	ParticleSorter sorter;
+	sorter.sort( &particles, &compactedKeys[ 0 ], ParticleSorter::Order::ASCENDING );
+
+	ASSERT_EQ( 4, particles.getAliveCount() );
+	expectSorted( particles, ParticleSorter::Order::ASCENDING );
+}
+
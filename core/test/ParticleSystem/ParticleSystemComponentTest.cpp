@@ -0,0 +1,227 @@
+/*
+ * Copyright (c) 2013, Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "ParticleSystem/ParticleSystemComponent.hpp"
+#include "ParticleSystem/ParticleBudgetManager.hpp"
+#include "ParticleSystem/Generators/UniformScaleParticleGenerator.hpp"
+#include "SceneGraph/Group.hpp"
+#include "SceneGraph/Camera.hpp"
+#include "Mathematics/Clock.hpp"
+
+#include "gtest/gtest.h"
+
+#include <vector>
+
+using namespace crimild;
+
+static const crimild::Size COMPONENT_TEST_COUNT = 100;
+
+static SharedPointer< Group > createEmitter( crimild::Real32 emitRate, bool burst, const Vector3f &position )
+{
+	auto particles = crimild::alloc< ParticleData >( COMPONENT_TEST_COUNT );
+	particles->createAttribArray< Vector3f >( ParticleAttrib::POSITION );
+
+	auto ps = crimild::alloc< ParticleSystemComponent >( particles );
+	ps->setEmitRate( emitRate );
+	ps->setBurst( burst );
+
+	auto node = crimild::alloc< Group >();
+	node->attachComponent( ps );
+	node->world().setTranslate( position );
+	node->setWorldIsCurrent( true );
+	return node;
+}
+
+static ParticleSystemComponent *getParticleSystem( Group *node )
+{
+	return node->getComponent< ParticleSystemComponent >();
+}
+
+TEST( ParticleSystemComponentTest, culledEmittersAreNotSimulated )
+{
+	auto camera = crimild::alloc< Camera >();
+	camera->computeCullingPlanes();
+	Camera::setMainCamera( camera );
+
+	auto node = createEmitter( 100.0f, false, Vector3f( 0.0f, 0.0f, -10.0f ) );
+	auto ps = getParticleSystem( crimild::get_ptr( node ) );
+	ps->setMaxCatchUpTime( 0.25 );
+	node->startComponents();
+
+	const Clock clock( 0.1 );
+
+	// One extra particle is always emitted in the first frame
+	node->updateComponents( clock );
+	EXPECT_FALSE( ps->isCulled() );
+	EXPECT_EQ( 11, ps->getParticles()->getAliveCount() );
+	EXPECT_EQ( 11, ps->getSimulationStats().simulated );
+	EXPECT_EQ( 0, ps->getSimulationStats().skipped );
+
+	// Behind the camera
+	node->world().setTranslate( 0.0f, 0.0f, 10.0f );
+	for ( int i = 0; i < 5; i++ ) {
+		node->updateComponents( clock );
+		EXPECT_TRUE( ps->isCulled() );
+		EXPECT_EQ( 11, ps->getParticles()->getAliveCount() );
+		EXPECT_EQ( 0, ps->getSimulationStats().simulated );
+		EXPECT_EQ( 11, ps->getSimulationStats().skipped );
+	}
+
+	// Back in view. Skipped time is simulated first, up to the limit
+	node->world().setTranslate( 0.0f, 0.0f, -10.0f );
+	node->updateComponents( clock );
+	EXPECT_FALSE( ps->isCulled() );
+	EXPECT_GT( ps->getParticles()->getAliveCount(), 40 );
+	EXPECT_LT( ps->getParticles()->getAliveCount(), 50 );
+	EXPECT_EQ( ps->getParticles()->getAliveCount(), ps->getSimulationStats().simulated );
+
+	Camera::setMainCamera( nullptr );
+}
+
+TEST( ParticleSystemComponentTest, cullingDisabled )
+{
+	auto camera = crimild::alloc< Camera >();
+	camera->computeCullingPlanes();
+	Camera::setMainCamera( camera );
+
+	auto node = createEmitter( 10.0f, true, Vector3f( 0.0f, 0.0f, 10.0f ) );
+	auto ps = getParticleSystem( crimild::get_ptr( node ) );
+	ps->setCullingEnabled( false );
+	node->startComponents();
+
+	node->updateComponents( Clock( 0.1 ) );
+	EXPECT_FALSE( ps->isCulled() );
+	EXPECT_EQ( 11, ps->getSimulationStats().simulated );
+
+	Camera::setMainCamera( nullptr );
+}
+
+TEST( ParticleSystemComponentTest, distantEmittersUpdateLessOften )
+{
+	auto camera = crimild::alloc< Camera >();
+	camera->computeCullingPlanes();
+	Camera::setMainCamera( camera );
+
+	auto node = createEmitter( 8.0f, true, Vector3f( 0.0f, 0.0f, -500.0f ) );
+	auto ps = getParticleSystem( crimild::get_ptr( node ) );
+	ps->setLODDistances( 10.0f, 110.0f );
+	ps->setMinLODScale( 0.25f );
+	node->startComponents();
+
+	const Clock clock( 0.1 );
+
+	for ( int i = 0; i < 3; i++ ) {
+		node->updateComponents( clock );
+		EXPECT_EQ( 0.25f, ps->getLODScale() );
+		EXPECT_EQ( 4, ps->getLODUpdateInterval() );
+		EXPECT_EQ( 0, ps->getParticles()->getAliveCount() );
+	}
+
+	// Emission is scaled down as well
+	node->updateComponents( clock );
+	EXPECT_EQ( 3, ps->getParticles()->getAliveCount() );
+	EXPECT_EQ( 3, ps->getSimulationStats().simulated );
+
+	node->updateComponents( clock );
+	EXPECT_EQ( 0, ps->getSimulationStats().simulated );
+	EXPECT_EQ( 3, ps->getSimulationStats().skipped );
+
+	// Close emitters are updated every frame at full rate
+	node->world().setTranslate( 0.0f, 0.0f, -5.0f );
+	node->updateComponents( clock );
+	EXPECT_EQ( 1.0f, ps->getLODScale() );
+	EXPECT_EQ( 1, ps->getLODUpdateInterval() );
+	EXPECT_EQ( 11, ps->getParticles()->getAliveCount() );
+
+	Camera::setMainCamera( nullptr );
+}
+
+TEST( ParticleSystemComponentTest, budgetByPriority )
+{
+	ParticleBudgetManager manager( 20 );
+
+	auto low = createEmitter( 8.0f, true, Vector3f::ZERO );
+	auto high = createEmitter( 8.0f, true, Vector3f::ZERO );
+	auto mid = createEmitter( 8.0f, true, Vector3f::ZERO );
+
+	getParticleSystem( crimild::get_ptr( low ) )->setPriority( -1 );
+	getParticleSystem( crimild::get_ptr( high ) )->setPriority( 10 );
+	getParticleSystem( crimild::get_ptr( mid ) )->setPriority( 5 );
+
+	const Clock clock( 0.1 );
+	auto update = [ & ]( void ) {
+		low->updateComponents( clock );
+		high->updateComponents( clock );
+		mid->updateComponents( clock );
+		manager.update();
+	};
+
+	low->startComponents();
+	high->startComponents();
+	mid->startComponents();
+	EXPECT_EQ( 3, manager.getEmitterCount() );
+
+	// Budgets are not assigned until emitters report their demand
+	update();
+	EXPECT_EQ( 17, getParticleSystem( crimild::get_ptr( high ) )->getParticleBudget() );
+	EXPECT_EQ( 3, getParticleSystem( crimild::get_ptr( mid ) )->getParticleBudget() );
+	EXPECT_EQ( 0, getParticleSystem( crimild::get_ptr( low ) )->getParticleBudget() );
+	EXPECT_EQ( 27, manager.getSimulatedCount() );
+	EXPECT_EQ( 0, manager.getThrottledCount() );
+
+	update();
+	EXPECT_EQ( 17, getParticleSystem( crimild::get_ptr( high ) )->getParticles()->getAliveCount() );
+	EXPECT_EQ( 9, getParticleSystem( crimild::get_ptr( mid ) )->getParticles()->getAliveCount() );
+	EXPECT_EQ( 9, getParticleSystem( crimild::get_ptr( low ) )->getParticles()->getAliveCount() );
+	EXPECT_EQ( 35, manager.getSimulatedCount() );
+	EXPECT_EQ( 16, manager.getThrottledCount() );
+
+	low->detachAllComponents();
+	EXPECT_EQ( 2, manager.getEmitterCount() );
+}
+
+TEST( ParticleSystemComponentTest, randomSeed )
+{
+	auto emit = []( void ) {
+		auto node = createEmitter( 50.0f, true, Vector3f::ZERO );
+		auto ps = getParticleSystem( crimild::get_ptr( node ) );
+		auto scales = crimild::alloc< UniformScaleParticleGenerator >();
+		scales->setMinScale( 1.0f );
+		scales->setMaxScale( 2.0f );
+		ps->addGenerator( scales );
+		ps->setRandomSeed( 2019 );
+		node->startComponents();
+		node->updateComponents( Clock( 0.1 ) );
+
+		auto ss = ps->getParticles()->getAttrib( ParticleAttrib::UNIFORM_SCALE )->getData< crimild::Real32 >();
+		return std::vector< crimild::Real32 >( ss, ss + ps->getParticles()->getAliveCount() );
+	};
+
+	const auto a = emit();
+	EXPECT_EQ( 51, a.size() );
+	EXPECT_EQ( a, emit() );
+}
@@ -0,0 +1,238 @@
+/*
+ * Copyright (c) 2013, Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "Primitives/MeshOptimizer.hpp"
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+using namespace crimild;
+
+namespace {
+
+	/**
+	   Builds a grid of quads with triangles in random order, emitting
+	   a separate vertex for each triangle corner if 'unwelded' is true
+	   (like OBJLoader used to do)
+	 */
+	SharedPointer< Primitive > createShuffledGrid( crimild::UInt32 size, bool unwelded )
+	{
+		std::vector< crimild::UInt32 > triangles;
+		for ( crimild::UInt32 y = 0; y < size; y++ ) {
+			for ( crimild::UInt32 x = 0; x < size; x++ ) {
+				const auto v = y * ( size + 1 ) + x;
+				triangles.push_back( v );
+				triangles.push_back( v + 1 );
+				triangles.push_back( v + size + 1 );
+				triangles.push_back( v + 1 );
+				triangles.push_back( v + size + 2 );
+				triangles.push_back( v + size + 1 );
+			}
+		}
+
+		// deterministic shuffle of whole triangles
+		const auto triangleCount = triangles.size() / 3;
+		crimild::UInt32 seed = 12345;
+		for ( crimild::Size t = triangleCount - 1; t > 0; t-- ) {
+			seed = seed * 1664525u + 1013904223u;
+			const auto other = seed % ( t + 1 );
+			for ( crimild::Size k = 0; k < 3; k++ ) {
+				std::swap( triangles[ 3 * t + k ], triangles[ 3 * other + k ] );
+			}
+		}
+
+		auto position = [ size ]( crimild::UInt32 v ) {
+			return Vector3f( v % ( size + 1 ), v / ( size + 1 ), 0.0f );
+		};
+
+		auto primitive = crimild::alloc< Primitive >( Primitive::Type::TRIANGLES );
+		if ( unwelded ) {
+			auto vbo = crimild::alloc< VertexBufferObject >( VertexFormat::VF_P3, triangles.size() );
+			for ( crimild::Size i = 0; i < triangles.size(); i++ ) {
+				vbo->setPositionAt( i, position( triangles[ i ] ) );
+			}
+			auto ibo = crimild::alloc< IndexBufferObject >( triangles.size(), IndexBufferObject::getIndexTypeForVertexCount( triangles.size() ) );
+			ibo->generateIncrementalIndices();
+			primitive->setVertexBuffer( vbo );
+			primitive->setIndexBuffer( ibo );
+		}
+		else {
+			const auto vertexCount = ( size + 1 ) * ( size + 1 );
+			auto vbo = crimild::alloc< VertexBufferObject >( VertexFormat::VF_P3, vertexCount );
+			for ( crimild::UInt32 v = 0; v < vertexCount; v++ ) {
+				vbo->setPositionAt( v, position( v ) );
+			}
+			auto ibo = crimild::alloc< IndexBufferObject >( triangles.size(), &triangles[ 0 ] );
+			primitive->setVertexBuffer( vbo );
+			primitive->setIndexBuffer( ibo );
+		}
+
+		return primitive;
+	}
+
+	/**
+	   Triangles as sorted lists of positions, so two primitives can be
+	   compared regardless of vertex or triangle order. Winding is
+	   kept by rotating each triangle to start with its smallest corner
+	 */
+	std::vector< std::vector< crimild::Real32 > > collectTriangles( Primitive *primitive )
+	{
+		auto vbo = primitive->getVertexBuffer();
+		auto ibo = primitive->getIndexBuffer();
+
+		std::vector< std::vector< crimild::Real32 > > result;
+		for ( crimild::Size t = 0; t < ibo->getIndexCount() / 3; t++ ) {
+			std::vector< std::vector< crimild::Real32 > > corners;
+			for ( crimild::Size k = 0; k < 3; k++ ) {
+				const auto &p = vbo->getPositionAt( ibo->getIndexAt( 3 * t + k ) );
+				corners.push_back( { p[ 0 ], p[ 1 ], p[ 2 ] } );
+			}
+			auto first = std::min_element( corners.begin(), corners.end() );
+			std::rotate( corners.begin(), first, corners.end() );
+
+			std::vector< crimild::Real32 > triangle;
+			for ( auto &c : corners ) {
+				triangle.insert( triangle.end(), c.begin(), c.end() );
+			}
+			result.push_back( triangle );
+		}
+		std::sort( result.begin(), result.end() );
+		return result;
+	}
+
+}
+
+TEST( MeshOptimizerTest, computeACMR )
+{
+	// no vertex reuse at all
+	auto ibo = crimild::alloc< IndexBufferObject >( 6 );
+	ibo->generateIncrementalIndices();
+	EXPECT_EQ( 3.0f, MeshOptimizer::computeACMR( crimild::get_ptr( ibo ) ) );
+
+	// a quad shares two vertices
+	crimild::UInt16 quad[] = { 0, 1, 2, 1, 3, 2 };
+	ibo = crimild::alloc< IndexBufferObject >( 6, quad );
+	EXPECT_EQ( 2.0f, MeshOptimizer::computeACMR( crimild::get_ptr( ibo ) ) );
+
+	// vertex 0 is evicted from a cache of size 3 before being reused
+	crimild::UInt16 evicted[] = { 0, 1, 2, 3, 4, 0 };
+	ibo = crimild::alloc< IndexBufferObject >( 6, evicted );
+	EXPECT_EQ( 3.0f, MeshOptimizer::computeACMR( crimild::get_ptr( ibo ), 3 ) );
+	EXPECT_EQ( 2.5f, MeshOptimizer::computeACMR( crimild::get_ptr( ibo ), 16 ) );
+}
+
+TEST( MeshOptimizerTest, weldVertices )
+{
+	auto primitive = createShuffledGrid( 4, true );
+	auto expected = collectTriangles( crimild::get_ptr( primitive ) );
+
+	EXPECT_EQ( 96, primitive->getVertexBuffer()->getVertexCount() );
+
+	MeshOptimizer::weldVertices( crimild::get_ptr( primitive ) );
+
+	EXPECT_EQ( 25, primitive->getVertexBuffer()->getVertexCount() );
+	EXPECT_EQ( 96, primitive->getIndexBuffer()->getIndexCount() );
+	EXPECT_EQ( expected, collectTriangles( crimild::get_ptr( primitive ) ) );
+}
+
+TEST( MeshOptimizerTest, optimizeVertexCache )
+{
+	auto primitive = createShuffledGrid( 64, false );
+	auto expected = collectTriangles( crimild::get_ptr( primitive ) );
+
+	auto before = MeshOptimizer::computeACMR( primitive->getIndexBuffer() );
+	MeshOptimizer::optimizeVertexCache( crimild::get_ptr( primitive ) );
+	auto after = MeshOptimizer::computeACMR( primitive->getIndexBuffer() );
+
+	RecordProperty( "ACMRBefore", std::to_string( before ).c_str() );
+	RecordProperty( "ACMRAfter", std::to_string( after ).c_str() );
+
+	// a random order transforms close to 3 vertices per triangle, while
+	// an optimized grid should get below 1 for a cache of 16 entries
+	EXPECT_GT( before, 2.0f );
+	EXPECT_LT( after, 1.0f );
+	EXPECT_EQ( expected, collectTriangles( crimild::get_ptr( primitive ) ) );
+}
+
+TEST( MeshOptimizerTest, optimizeVertexFetch )
+{
+	auto primitive = createShuffledGrid( 8, false );
+	auto expected = collectTriangles( crimild::get_ptr( primitive ) );
+
+	MeshOptimizer::optimizeVertexFetch( crimild::get_ptr( primitive ) );
+
+	// each new vertex referenced is the next one in the buffer
+	auto ibo = primitive->getIndexBuffer();
+	crimild::UInt32 next = 0;
+	for ( crimild::Size i = 0; i < ibo->getIndexCount(); i++ ) {
+		const auto v = ibo->getIndexAt( i );
+		EXPECT_LE( v, next );
+		if ( v == next ) {
+			next++;
+		}
+	}
+	EXPECT_EQ( primitive->getVertexBuffer()->getVertexCount(), next );
+	EXPECT_EQ( expected, collectTriangles( crimild::get_ptr( primitive ) ) );
+}
+
+TEST( MeshOptimizerTest, optimize )
+{
+	auto primitive = createShuffledGrid( 64, true );
+	auto expected = collectTriangles( crimild::get_ptr( primitive ) );
+
+	auto before = MeshOptimizer::computeACMR( primitive->getIndexBuffer() );
+	MeshOptimizer::optimize( crimild::get_ptr( primitive ) );
+	auto after = MeshOptimizer::computeACMR( primitive->getIndexBuffer() );
+
+	RecordProperty( "ACMRBefore", std::to_string( before ).c_str() );
+	RecordProperty( "ACMRAfter", std::to_string( after ).c_str() );
+
+	EXPECT_EQ( 3.0f, before );
+	EXPECT_LT( after, 1.0f );
+	EXPECT_EQ( 65 * 65, primitive->getVertexBuffer()->getVertexCount() );
+	EXPECT_EQ( IndexBufferObject::IndexType::UINT16, primitive->getIndexBuffer()->getIndexType() );
+	EXPECT_EQ( expected, collectTriangles( crimild::get_ptr( primitive ) ) );
+}
+
+
+TEST( MeshOptimizerTest, invalidIndices )
+{
+	auto primitive = createShuffledGrid( 2, true );
+	primitive->getIndexBuffer()->setIndexAt( 5, primitive->getVertexBuffer()->getVertexCount() );
+
+	auto vbo = primitive->getVertexBuffer();
+	auto ibo = primitive->getIndexBuffer();
+
+	// buffers with out of range indices are left alone
+	MeshOptimizer::optimize( crimild::get_ptr( primitive ) );
+
+	EXPECT_EQ( vbo, primitive->getVertexBuffer() );
+	EXPECT_EQ( ibo, primitive->getIndexBuffer() );
+}
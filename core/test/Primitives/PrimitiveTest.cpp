@@ -66,7 +66,7 @@ TEST( PrimitiveTest, setIndexBuffer )
 
 	EXPECT_EQ( p->getIndexBuffer(), nullptr );
 
-	auto ibo = crimild::alloc< IndexBufferObject >( 0, nullptr );
+	auto ibo = crimild::alloc< IndexBufferObject >( 0 );
 	p->setIndexBuffer( ibo );
 
     EXPECT_EQ( p->getIndexBuffer(), crimild::get_ptr( ibo ) );
@@ -0,0 +1,313 @@
+/*
+ * Copyright (c) 2013, Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "Rendering/ImageCompressor.hpp"
+#include "Rendering/ImageDDS.hpp"
+#include "Rendering/ImageKTX.hpp"
+#include "Rendering/ImageLoader.hpp"
+#include "Rendering/ImageUtils.hpp"
+#include "Simulation/FileSystem.hpp"
+#include "Streaming/FileStream.hpp"
+#include "Utils/TemporaryFile.hpp"
+
+#include "gtest/gtest.h"
+
+#include <vector>
+
+using namespace crimild;
+
+// Smooth gradients with some noise, which is a good approximation
+// of a regular texture
+static SharedPointer< Image > createTestImage( crimild::Size width, crimild::Size height, crimild::Size bpp )
+{
+	std::vector< crimild::Byte > data( width * height * bpp );
+	crimild::UInt32 seed = 1234;
+	for ( crimild::Size y = 0; y < height; y++ ) {
+		for ( crimild::Size x = 0; x < width; x++ ) {
+			auto p = &data[ ( y * width + x ) * bpp ];
+			for ( crimild::Size c = 0; c < bpp; c++ ) {
+				seed = seed * 1103515245 + 12345;
+				auto noise = ( crimild::Int32 )( ( seed >> 16 ) % 9 ) - 4;
+				auto value = ( crimild::Int32 )( c == 3 ? 255 - y * 255 / height : x * ( c + 1 ) * 60 / width + y * 128 / height + c * 30 );
+				p[ c ] = ( crimild::Byte ) Numeric< crimild::Int32 >::clamp( value + noise, 0, 255 );
+			}
+		}
+	}
+
+	return crimild::alloc< Image >( width, height, bpp, &data[ 0 ], bpp == 4 ? Image::PixelFormat::RGBA : Image::PixelFormat::RGB );
+}
+
+static std::vector< crimild::Byte > readBytes( std::string const &path )
+{
+	containers::ByteArray data;
+	FileSystem::getInstance().readFile( path, data );
+	return std::vector< crimild::Byte >( data.getData(), data.getData() + data.size() );
+}
+
+TEST( ImageCompressorTest, dataSize )
+{
+	EXPECT_EQ( 8, Image::getBlockSize( Image::PixelFormat::BC1 ) );
+	EXPECT_EQ( 16, Image::getBlockSize( Image::PixelFormat::BC3 ) );
+	EXPECT_EQ( 16, Image::getBlockSize( Image::PixelFormat::BC7 ) );
+	EXPECT_EQ( 8, Image::getBlockSize( Image::PixelFormat::ETC2_RGB ) );
+	EXPECT_EQ( 16, Image::getBlockSize( Image::PixelFormat::ETC2_RGBA ) );
+	EXPECT_EQ( 0, Image::getBlockSize( Image::PixelFormat::RGBA ) );
+
+	// partial blocks are rounded up
+	EXPECT_EQ( 8, Image::computeDataSize( Image::PixelFormat::BC1, 1, 1 ) );
+	EXPECT_EQ( 2 * 3 * 16, Image::computeDataSize( Image::PixelFormat::BC3, 5, 9 ) );
+	EXPECT_EQ( 5 * 9 * 4, Image::computeDataSize( Image::PixelFormat::RGBA, 5, 9, 4 ) );
+
+	// 8x less memory than RGBA for BC1/ETC2_RGB and 4x for the rest
+	auto rgbaSize = Image::computeDataSize( Image::PixelFormat::RGBA, 256, 256, 4 );
+	EXPECT_EQ( rgbaSize / 8, Image::computeDataSize( Image::PixelFormat::BC1, 256, 256 ) );
+	EXPECT_EQ( rgbaSize / 8, Image::computeDataSize( Image::PixelFormat::ETC2_RGB, 256, 256 ) );
+	EXPECT_EQ( rgbaSize / 4, Image::computeDataSize( Image::PixelFormat::BC3, 256, 256 ) );
+	EXPECT_EQ( rgbaSize / 4, Image::computeDataSize( Image::PixelFormat::BC7, 256, 256 ) );
+	EXPECT_EQ( rgbaSize / 4, Image::computeDataSize( Image::PixelFormat::ETC2_RGBA, 256, 256 ) );
+}
+
+TEST( ImageCompressorTest, quality )
+{
+	auto rgb = createTestImage( 64, 64, 3 );
+	auto rgba = createTestImage( 64, 64, 4 );
+
+	struct {
+		Image::PixelFormat format;
+		Image *source;
+		crimild::Real64 minPSNR;
+	} cases[] = {
+		{ Image::PixelFormat::BC1, crimild::get_ptr( rgb ), 38.0 },
+		{ Image::PixelFormat::BC3, crimild::get_ptr( rgba ), 38.0 },
+		{ Image::PixelFormat::BC7, crimild::get_ptr( rgba ), 38.0 },
+		{ Image::PixelFormat::ETC2_RGB, crimild::get_ptr( rgb ), 37.0 },
+		{ Image::PixelFormat::ETC2_RGBA, crimild::get_ptr( rgba ), 38.0 },
+	};
+
+	for ( auto &c : cases ) {
+		auto compressed = ImageCompressor::compress( c.source, c.format );
+		ASSERT_NE( nullptr, compressed );
+		EXPECT_TRUE( compressed->isCompressed() );
+		EXPECT_EQ( c.format, compressed->getPixelFormat() );
+		EXPECT_EQ( Image::computeDataSize( c.format, 64, 64 ), compressed->getDataSize() );
+
+		auto decompressed = ImageCompressor::decompress( crimild::get_ptr( compressed ) );
+		ASSERT_NE( nullptr, decompressed );
+		EXPECT_EQ( 64, decompressed->getWidth() );
+		EXPECT_EQ( 64, decompressed->getHeight() );
+		EXPECT_EQ( 4, decompressed->getBpp() );
+
+		auto psnr = ImageUtils::computePSNR( c.source, crimild::get_ptr( decompressed ) );
+		EXPECT_GT( psnr, c.minPSNR ) << "format " << ( int ) c.format;
+	}
+}
+
+TEST( ImageCompressorTest, solidColors )
+{
+	const crimild::Byte color[] = { 200, 100, 50, 128 };
+	std::vector< crimild::Byte > data( 8 * 8 * 4 );
+	for ( crimild::Size i = 0; i < data.size(); i++ ) {
+		data[ i ] = color[ i % 4 ];
+	}
+	auto image = crimild::alloc< Image >( 8, 8, 4, &data[ 0 ], Image::PixelFormat::RGBA );
+
+	for ( auto format : { Image::PixelFormat::BC3, Image::PixelFormat::BC7, Image::PixelFormat::ETC2_RGBA } ) {
+		auto decompressed = ImageCompressor::decompress( crimild::get_ptr( ImageCompressor::compress( crimild::get_ptr( image ), format ) ) );
+		ASSERT_NE( nullptr, decompressed );
+
+		auto pixels = decompressed->getData();
+		for ( crimild::Size i = 0; i < 8 * 8; i++ ) {
+			// alpha is always exact for a constant block
+			EXPECT_EQ( color[ 3 ], pixels[ i * 4 + 3 ] );
+			for ( crimild::Size c = 0; c < 3; c++ ) {
+				EXPECT_NEAR( color[ c ], pixels[ i * 4 + c ], 8 );
+			}
+		}
+	}
+}
+
+TEST( ImageCompressorTest, compressMipmaps )
+{
+	auto image = createTestImage( 37, 19, 3 );
+	ImageUtils::generateMipmaps( crimild::get_ptr( image ), ImageUtils::MipmapFilter::BOX );
+	ASSERT_TRUE( image->hasMipmaps() );
+
+	auto compressed = ImageCompressor::compress( crimild::get_ptr( image ), Image::PixelFormat::BC1 );
+	ASSERT_NE( nullptr, compressed );
+	ASSERT_EQ( image->getMipmapCount(), compressed->getMipmapCount() );
+
+	for ( crimild::Size level = 0; level <= compressed->getMipmapCount(); level++ ) {
+		auto mip = compressed->getMipmap( level );
+		EXPECT_EQ( image->getMipmap( level )->getWidth(), mip->getWidth() );
+		EXPECT_EQ( image->getMipmap( level )->getHeight(), mip->getHeight() );
+		EXPECT_EQ( Image::computeDataSize( Image::PixelFormat::BC1, mip->getWidth(), mip->getHeight() ), mip->getDataSize() );
+	}
+
+	auto decompressed = ImageCompressor::decompress( crimild::get_ptr( compressed ) );
+	ASSERT_NE( nullptr, decompressed );
+	EXPECT_EQ( compressed->getMipmapCount(), decompressed->getMipmapCount() );
+
+	// uncompressed images cannot be decompressed
+	EXPECT_EQ( nullptr, ImageCompressor::decompress( crimild::get_ptr( image ) ) );
+}
+
+TEST( ImageCompressorTest, ktxSaveAndLoad )
+{
+	TemporaryFile file( "ImageCompressorTest_ktxSaveAndLoad.ktx" );
+	const auto &path = file.getPath();
+
+	auto image = createTestImage( 32, 16, 4 );
+	ImageUtils::generateMipmaps( crimild::get_ptr( image ), ImageUtils::MipmapFilter::BOX );
+
+	for ( auto format : { Image::PixelFormat::BC1, Image::PixelFormat::BC3, Image::PixelFormat::BC7, Image::PixelFormat::ETC2_RGB, Image::PixelFormat::ETC2_RGBA } ) {
+		auto compressed = ImageCompressor::compress( crimild::get_ptr( image ), format );
+		ASSERT_TRUE( ImageKTX::save( crimild::get_ptr( compressed ), path ) );
+
+		auto bytes = readBytes( path );
+		auto loaded = crimild::alloc< ImageKTX >();
+		ASSERT_TRUE( loaded->loadFromMemory( &bytes[ 0 ], bytes.size() ) );
+		EXPECT_EQ( format, loaded->getPixelFormat() );
+		ASSERT_EQ( compressed->getMipmapCount(), loaded->getMipmapCount() );
+		for ( crimild::Size level = 0; level <= loaded->getMipmapCount(); level++ ) {
+			auto expected = compressed->getMipmap( level );
+			auto actual = loaded->getMipmap( level );
+			EXPECT_EQ( expected->getWidth(), actual->getWidth() );
+			EXPECT_EQ( expected->getHeight(), actual->getHeight() );
+			ASSERT_EQ( expected->getDataSize(), actual->getDataSize() );
+			EXPECT_EQ( 0, memcmp( expected->getData(), actual->getData(), expected->getDataSize() ) );
+		}
+	}
+
+	// uncompressed images with rows that need padding
+	auto rgb = createTestImage( 5, 3, 3 );
+	ASSERT_TRUE( ImageKTX::save( crimild::get_ptr( rgb ), path ) );
+	auto bytes = readBytes( path );
+	auto loaded = crimild::alloc< ImageKTX >();
+	ASSERT_TRUE( loaded->loadFromMemory( &bytes[ 0 ], bytes.size() ) );
+	EXPECT_FALSE( loaded->isCompressed() );
+	ASSERT_EQ( rgb->getDataSize(), loaded->getDataSize() );
+	EXPECT_EQ( 0, memcmp( rgb->getData(), loaded->getData(), rgb->getDataSize() ) );
+
+	// invalid data
+	EXPECT_FALSE( loaded->loadFromMemory( &bytes[ 0 ], 40 ) );
+
+}
+
+TEST( ImageCompressorTest, ddsSaveAndLoad )
+{
+	TemporaryFile file( "ImageCompressorTest_ddsSaveAndLoad.dds" );
+	const auto &path = file.getPath();
+
+	auto image = createTestImage( 20, 12, 4 );
+	ImageUtils::generateMipmaps( crimild::get_ptr( image ), ImageUtils::MipmapFilter::BOX );
+
+	for ( auto format : { Image::PixelFormat::BC1, Image::PixelFormat::BC3, Image::PixelFormat::BC7 } ) {
+		auto compressed = ImageCompressor::compress( crimild::get_ptr( image ), format );
+		ASSERT_TRUE( ImageDDS::save( crimild::get_ptr( compressed ), path ) );
+
+		auto bytes = readBytes( path );
+		auto loaded = crimild::alloc< ImageDDS >();
+		ASSERT_TRUE( loaded->loadFromMemory( &bytes[ 0 ], bytes.size() ) );
+		EXPECT_EQ( format, loaded->getPixelFormat() );
+		ASSERT_EQ( compressed->getMipmapCount(), loaded->getMipmapCount() );
+		for ( crimild::Size level = 0; level <= loaded->getMipmapCount(); level++ ) {
+			auto expected = compressed->getMipmap( level );
+			auto actual = loaded->getMipmap( level );
+			ASSERT_EQ( expected->getDataSize(), actual->getDataSize() );
+			EXPECT_EQ( 0, memcmp( expected->getData(), actual->getData(), expected->getDataSize() ) );
+		}
+	}
+
+	// DDS files cannot store ETC2 textures
+	auto etc2 = ImageCompressor::compress( crimild::get_ptr( image ), Image::PixelFormat::ETC2_RGB );
+	EXPECT_FALSE( ImageDDS::save( crimild::get_ptr( etc2 ), path ) );
+
+	// uncompressed
+	ASSERT_TRUE( ImageDDS::save( crimild::get_ptr( image ), path ) );
+	auto bytes = readBytes( path );
+	auto loaded = crimild::alloc< ImageDDS >();
+	ASSERT_TRUE( loaded->loadFromMemory( &bytes[ 0 ], bytes.size() ) );
+	EXPECT_EQ( Image::PixelFormat::RGBA, loaded->getPixelFormat() );
+	ASSERT_EQ( image->getDataSize(), loaded->getDataSize() );
+	EXPECT_EQ( 0, memcmp( image->getData(), loaded->getData(), image->getDataSize() ) );
+
+}
+
+TEST( ImageCompressorTest, imageLoaderKeepsCompressedMipmaps )
+{
+	TemporaryFile file( "ImageCompressorTest_imageLoader.ktx" );
+	const auto &path = file.getPath();
+
+	auto image = createTestImage( 16, 16, 3 );
+	auto compressed = ImageCompressor::compress( crimild::get_ptr( image ), Image::PixelFormat::BC1 );
+	ASSERT_TRUE( ImageKTX::save( crimild::get_ptr( compressed ), path ) );
+
+	auto bytes = readBytes( path );
+	auto loaded = ImageLoader::decode( path, &bytes[ 0 ], bytes.size() );
+	ASSERT_NE( nullptr, loaded );
+	EXPECT_TRUE( loaded->isCompressed() );
+
+	// mipmaps cannot be generated on the CPU for compressed images
+	EXPECT_FALSE( loaded->hasMipmaps() );
+
+}
+
+TEST( ImageCompressorTest, streamCompressedImage )
+{
+	TemporaryFile file( "ImageCompressorTest_stream.crimild" );
+
+	auto image = createTestImage( 20, 12, 4 );
+	ImageUtils::generateMipmaps( crimild::get_ptr( image ), ImageUtils::MipmapFilter::BOX );
+	auto compressed = ImageCompressor::compress( crimild::get_ptr( image ), Image::PixelFormat::BC3 );
+	ASSERT_TRUE( compressed->hasMipmaps() );
+
+	{
+		FileStream os( file.getPath(), FileStream::OpenMode::WRITE );
+		os.addObject( compressed );
+		EXPECT_TRUE( os.flush() );
+	}
+
+	{
+		FileStream is( file.getPath(), FileStream::OpenMode::READ );
+		EXPECT_TRUE( is.load() );
+		ASSERT_EQ( 1, is.getObjectCount() );
+		auto loaded = is.getObjectAt< Image >( 0 );
+		ASSERT_NE( nullptr, loaded );
+		EXPECT_TRUE( loaded->isCompressed() );
+		EXPECT_EQ( Image::PixelFormat::BC3, loaded->getPixelFormat() );
+		ASSERT_EQ( compressed->getMipmapCount(), loaded->getMipmapCount() );
+		for ( crimild::Size level = 0; level <= loaded->getMipmapCount(); level++ ) {
+			auto expected = compressed->getMipmap( level );
+			auto actual = loaded->getMipmap( level );
+			EXPECT_EQ( expected->getWidth(), actual->getWidth() );
+			EXPECT_EQ( expected->getHeight(), actual->getHeight() );
+			EXPECT_EQ( Image::PixelFormat::BC3, actual->getPixelFormat() );
+			ASSERT_EQ( expected->getDataSize(), actual->getDataSize() );
+			EXPECT_EQ( 0, memcmp( expected->getData(), actual->getData(), expected->getDataSize() ) );
+		}
+	}
+}
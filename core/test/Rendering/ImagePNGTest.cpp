@@ -0,0 +1,242 @@
+/*
+ * Copyright (c) 2013, Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "Rendering/ImagePNG.hpp"
+#include "Rendering/ImageTGA.hpp"
+#include "Rendering/ImageLoader.hpp"
+#include "Simulation/FileSystem.hpp"
+
+#include "gtest/gtest.h"
+
+#include <cstdio>
+#include <vector>
+
+using namespace crimild;
+
+// 8x4 RGB image compressed with fixed Huffman codes. Rows use
+// the None, Sub, Up and Paeth filters
+static const crimild::Byte RGB_FIXED_PNG[] = {
+	0x89, 0x50, 0x4e, 0x47, 0x0d, 0x0a, 0x1a, 0x0a, 0x00, 0x00, 0x00, 0x0d, 0x49, 0x48, 0x44, 0x52,
+	0x00, 0x00, 0x00, 0x08, 0x00, 0x00, 0x00, 0x04, 0x08, 0x02, 0x00, 0x00, 0x00, 0x3c, 0xaf, 0xe9,
+	0xa7, 0x00, 0x00, 0x00, 0x33, 0x49, 0x44, 0x41, 0x54, 0x78, 0xda, 0x63, 0x60, 0x60, 0x60, 0x90,
+	0x63, 0xe0, 0xb2, 0x61, 0x10, 0x89, 0x62, 0x90, 0xab, 0x60, 0xd0, 0x98, 0xc6, 0x60, 0xb4, 0x85,
+	0xc1, 0xe6, 0x12, 0x83, 0x1b, 0x23, 0x83, 0x0d, 0x17, 0x50, 0x02, 0x13, 0x31, 0x01, 0x25, 0xb0,
+	0x22, 0x16, 0x10, 0xc5, 0x80, 0x05, 0x01, 0x00, 0x20, 0xc9, 0x08, 0x82, 0xc4, 0x22, 0x0f, 0xb0,
+	0x00, 0x00, 0x00, 0x00, 0x49, 0x45, 0x4e, 0x44, 0xae, 0x42, 0x60, 0x82,
+};
+
+// 16x16 grayscale image compressed with dynamic Huffman codes
+static const crimild::Byte GRAY_DYNAMIC_PNG[] = {
+	0x89, 0x50, 0x4e, 0x47, 0x0d, 0x0a, 0x1a, 0x0a, 0x00, 0x00, 0x00, 0x0d, 0x49, 0x48, 0x44, 0x52,
+	0x00, 0x00, 0x00, 0x10, 0x00, 0x00, 0x00, 0x10, 0x08, 0x00, 0x00, 0x00, 0x00, 0x3a, 0x98, 0xa0,
+	0xbd, 0x00, 0x00, 0x00, 0x3c, 0x49, 0x44, 0x41, 0x54, 0x78, 0xda, 0xcd, 0xcd, 0x31, 0x01, 0xc0,
+	0x40, 0x0c, 0xc3, 0x40, 0xc1, 0x31, 0x9c, 0xc0, 0x31, 0x9c, 0xc0, 0x31, 0x1c, 0x43, 0xf8, 0x2d,
+	0x4b, 0x09, 0x54, 0xcb, 0x8d, 0x82, 0x4f, 0x1a, 0x6f, 0x7a, 0xc0, 0x6c, 0xe5, 0x1c, 0xe0, 0x4e,
+	0xb4, 0x07, 0xac, 0x32, 0xf5, 0x01, 0xb1, 0xba, 0x73, 0x40, 0xb3, 0x1e, 0x1d, 0xfc, 0x75, 0xfb,
+	0x00, 0xfa, 0x69, 0x5c, 0x09, 0x75, 0xcc, 0xe8, 0xf8, 0x00, 0x00, 0x00, 0x00, 0x49, 0x45, 0x4e,
+	0x44, 0xae, 0x42, 0x60, 0x82,
+};
+
+static std::vector< crimild::Byte > readBytes( std::string const &path )
+{
+	containers::ByteArray data;
+	FileSystem::getInstance().readFile( path, data );
+	return std::vector< crimild::Byte >( data.getData(), data.getData() + data.size() );
+}
+
+TEST( ImagePNGTest, decodeFixedHuffman )
+{
+	auto image = crimild::alloc< ImagePNG >();
+	ASSERT_TRUE( image->loadFromMemory( RGB_FIXED_PNG, sizeof( RGB_FIXED_PNG ) ) );
+
+	EXPECT_EQ( 8, image->getWidth() );
+	EXPECT_EQ( 4, image->getHeight() );
+	EXPECT_EQ( 3, image->getBpp() );
+	EXPECT_EQ( Image::PixelFormat::RGB, image->getPixelFormat() );
+
+	auto pixels = image->getData();
+	for ( crimild::Size y = 0; y < 4; y++ ) {
+		for ( crimild::Size x = 0; x < 8; x++ ) {
+			auto p = pixels + ( y * 8 + x ) * 3;
+			EXPECT_EQ( x * 30, p[ 0 ] );
+			EXPECT_EQ( y * 60, p[ 1 ] );
+			EXPECT_EQ( ( x + y ) * 10, p[ 2 ] );
+		}
+	}
+}
+
+TEST( ImagePNGTest, decodeDynamicHuffman )
+{
+	auto image = crimild::alloc< ImagePNG >();
+	ASSERT_TRUE( image->loadFromMemory( GRAY_DYNAMIC_PNG, sizeof( GRAY_DYNAMIC_PNG ) ) );
+
+	EXPECT_EQ( 16, image->getWidth() );
+	EXPECT_EQ( 16, image->getHeight() );
+
+	// grayscale is expanded to RGB
+	EXPECT_EQ( 3, image->getBpp() );
+
+	auto pixels = image->getData();
+	for ( crimild::Size y = 0; y < 16; y++ ) {
+		for ( crimild::Size x = 0; x < 16; x++ ) {
+			auto p = pixels + ( y * 16 + x ) * 3;
+			auto expected = ( ( x * y ) % 7 ) * 40;
+			EXPECT_EQ( expected, p[ 0 ] );
+			EXPECT_EQ( expected, p[ 1 ] );
+			EXPECT_EQ( expected, p[ 2 ] );
+		}
+	}
+}
+
+TEST( ImagePNGTest, rejectInvalidData )
+{
+	auto image = crimild::alloc< ImagePNG >();
+
+	crimild::Byte garbage[] = { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12 };
+	EXPECT_FALSE( image->loadFromMemory( garbage, sizeof( garbage ) ) );
+
+	// truncated stream
+	EXPECT_FALSE( image->loadFromMemory( RGB_FIXED_PNG, 60 ) );
+
+	// corrupted compressed data
+	std::vector< crimild::Byte > corrupted( RGB_FIXED_PNG, RGB_FIXED_PNG + sizeof( RGB_FIXED_PNG ) );
+	for ( crimild::Size i = 43; i < 60; i++ ) {
+		corrupted[ i ] = 0xFF;
+	}
+	EXPECT_FALSE( image->loadFromMemory( &corrupted[ 0 ], corrupted.size() ) );
+
+	// invalid dimensions are rejected before allocating any memory
+	auto withSize = []( crimild::UInt32 width, crimild::UInt32 height ) {
+		std::vector< crimild::Byte > data( RGB_FIXED_PNG, RGB_FIXED_PNG + sizeof( RGB_FIXED_PNG ) );
+		for ( crimild::Size i = 0; i < 4; i++ ) {
+			data[ 16 + i ] = ( width >> ( 24 - 8 * i ) ) & 0xFF;
+			data[ 20 + i ] = ( height >> ( 24 - 8 * i ) ) & 0xFF;
+		}
+		return data;
+	};
+
+	for ( auto data : { withSize( 0, 4 ), withSize( 8, 0 ), withSize( 0x7FFFFFFF, 4 ), withSize( 8, 0xFFFFFFFF ), withSize( 65536, 65536 ) } ) {
+		EXPECT_FALSE( image->loadFromMemory( &data[ 0 ], data.size() ) );
+	}
+
+	// the original size is still valid
+	auto data = withSize( 8, 4 );
+	EXPECT_TRUE( image->loadFromMemory( &data[ 0 ], data.size() ) );
+}
+
+TEST( ImagePNGTest, saveAndLoad )
+{
+	const std::string path = "ImagePNGTest_saveAndLoad.png";
+
+	for ( crimild::Size bpp : { 1, 3, 4 } ) {
+		const crimild::Size width = 37;
+		const crimild::Size height = 19;
+		std::vector< crimild::Byte > data( width * height * bpp );
+		for ( crimild::Size i = 0; i < data.size(); i++ ) {
+			// mix repeated runs and noise
+			data[ i ] = ( i / 7 ) % 3 == 0 ? 42 : ( i * 131 ) % 251;
+		}
+
+		auto format = bpp == 4 ? Image::PixelFormat::RGBA : ( bpp == 3 ? Image::PixelFormat::RGB : Image::PixelFormat::RED );
+		auto image = crimild::alloc< ImagePNG >();
+		image->setData( width, height, bpp, &data[ 0 ], format );
+		ASSERT_TRUE( image->saveToFile( path ) );
+
+		auto bytes = readBytes( path );
+		auto loaded = crimild::alloc< ImagePNG >();
+		ASSERT_TRUE( loaded->loadFromMemory( &bytes[ 0 ], bytes.size() ) );
+
+		EXPECT_EQ( width, loaded->getWidth() );
+		EXPECT_EQ( height, loaded->getHeight() );
+
+		auto pixels = loaded->getData();
+		if ( bpp == 1 ) {
+			ASSERT_EQ( 3, loaded->getBpp() );
+			for ( crimild::Size i = 0; i < width * height; i++ ) {
+				EXPECT_EQ( data[ i ], pixels[ i * 3 ] );
+			}
+		}
+		else {
+			ASSERT_EQ( bpp, loaded->getBpp() );
+			EXPECT_EQ( 0, memcmp( &data[ 0 ], pixels, data.size() ) );
+		}
+	}
+
+	std::remove( path.c_str() );
+}
+
+TEST( ImagePNGTest, loadTGAFromMemory )
+{
+	// 2x2, 24 bits, bottom-left origin, stored as BGR
+	std::vector< crimild::Byte > tga = {
+		0, 0, 2, 0, 0, 0, 0, 0, 0, 0, 0, 0, 2, 0, 2, 0, 24, 0,
+		1, 2, 3, 4, 5, 6,
+		7, 8, 9, 10, 11, 12,
+	};
+
+	auto image = crimild::alloc< ImageTGA >();
+	ASSERT_TRUE( image->loadFromMemory( &tga[ 0 ], tga.size() ) );
+	EXPECT_EQ( 2, image->getWidth() );
+	EXPECT_EQ( 2, image->getHeight() );
+	EXPECT_EQ( 3, image->getBpp() );
+
+	crimild::Byte expected[] = { 3, 2, 1, 6, 5, 4, 9, 8, 7, 12, 11, 10 };
+	EXPECT_EQ( 0, memcmp( expected, image->getData(), sizeof( expected ) ) );
+
+	// truncated
+	EXPECT_FALSE( image->loadFromMemory( &tga[ 0 ], tga.size() - 1 ) );
+}
+
+TEST( ImagePNGTest, loadRLETGAFromMemory )
+{
+	// 3x1, 32 bits. One run of two pixels followed by a raw pixel
+	std::vector< crimild::Byte > tga = {
+		0, 0, 10, 0, 0, 0, 0, 0, 0, 0, 0, 0, 3, 0, 1, 0, 32, 0,
+		129, 1, 2, 3, 4,
+		0, 5, 6, 7, 8,
+	};
+
+	auto image = crimild::alloc< ImageTGA >();
+	ASSERT_TRUE( image->loadFromMemory( &tga[ 0 ], tga.size() ) );
+	EXPECT_EQ( 4, image->getBpp() );
+
+	crimild::Byte expected[] = { 3, 2, 1, 4, 3, 2, 1, 4, 7, 6, 5, 8 };
+	EXPECT_EQ( 0, memcmp( expected, image->getData(), sizeof( expected ) ) );
+}
+
+TEST( ImagePNGTest, imageLoaderDecode )
+{
+	auto image = ImageLoader::decode( "test.png", RGB_FIXED_PNG, sizeof( RGB_FIXED_PNG ) );
+	ASSERT_NE( nullptr, image );
+
+	// 8x4 -> 4x2 -> 2x1 -> 1x1
+	EXPECT_EQ( 3, image->getMipmapCount() );
+
+	EXPECT_EQ( nullptr, ImageLoader::decode( "test.jpg", RGB_FIXED_PNG, sizeof( RGB_FIXED_PNG ) ) );
+	EXPECT_EQ( nullptr, ImageLoader::decode( "test.tga", RGB_FIXED_PNG, sizeof( RGB_FIXED_PNG ) ) );
+}
+
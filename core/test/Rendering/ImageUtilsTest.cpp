@@ -0,0 +1,202 @@
+/*
+ * Copyright (c) 2013, Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "Rendering/Image.hpp"
+#include "Rendering/ImageUtils.hpp"
+#include "Concurrency/JobScheduler.hpp"
+
+#include "gtest/gtest.h"
+
+#include <thread>
+#include <vector>
+
+using namespace crimild;
+
+TEST( ImageUtilsTest, swapRedBlueRGBA )
+{
+	// odd count, so both the vectorized and the scalar paths are used
+	const crimild::Size count = 11;
+	std::vector< crimild::Byte > data( count * 4 );
+	for ( crimild::Size i = 0; i < count; i++ ) {
+		data[ i * 4 + 0 ] = i;
+		data[ i * 4 + 1 ] = 100 + i;
+		data[ i * 4 + 2 ] = 200 + i;
+		data[ i * 4 + 3 ] = 50 + i;
+	}
+
+	ImageUtils::swapRedBlue( &data[ 0 ], count, 4 );
+
+	for ( crimild::Size i = 0; i < count; i++ ) {
+		EXPECT_EQ( 200 + i, data[ i * 4 + 0 ] );
+		EXPECT_EQ( 100 + i, data[ i * 4 + 1 ] );
+		EXPECT_EQ( i, data[ i * 4 + 2 ] );
+		EXPECT_EQ( 50 + i, data[ i * 4 + 3 ] );
+	}
+}
+
+TEST( ImageUtilsTest, swapRedBlueRGB )
+{
+	const crimild::Size count = 5;
+	std::vector< crimild::Byte > data( count * 3 );
+	for ( crimild::Size i = 0; i < count; i++ ) {
+		data[ i * 3 + 0 ] = i;
+		data[ i * 3 + 1 ] = 100 + i;
+		data[ i * 3 + 2 ] = 200 + i;
+	}
+
+	ImageUtils::swapRedBlue( &data[ 0 ], count, 3 );
+
+	for ( crimild::Size i = 0; i < count; i++ ) {
+		EXPECT_EQ( 200 + i, data[ i * 3 + 0 ] );
+		EXPECT_EQ( 100 + i, data[ i * 3 + 1 ] );
+		EXPECT_EQ( i, data[ i * 3 + 2 ] );
+	}
+}
+
+TEST( ImageUtilsTest, mipmapChain )
+{
+	auto image = crimild::alloc< Image >( 13, 4, 4, nullptr, Image::PixelFormat::RGBA );
+
+	EXPECT_TRUE( ImageUtils::generateMipmaps( crimild::get_ptr( image ) ) );
+
+	// 13x4 -> 6x2 -> 3x1 -> 1x1
+	ASSERT_EQ( 3, image->getMipmapCount() );
+	EXPECT_EQ( image.get(), image->getMipmap( 0 ) );
+
+	EXPECT_EQ( 6, image->getMipmap( 1 )->getWidth() );
+	EXPECT_EQ( 2, image->getMipmap( 1 )->getHeight() );
+	EXPECT_EQ( 3, image->getMipmap( 2 )->getWidth() );
+	EXPECT_EQ( 1, image->getMipmap( 2 )->getHeight() );
+	EXPECT_EQ( 1, image->getMipmap( 3 )->getWidth() );
+	EXPECT_EQ( 1, image->getMipmap( 3 )->getHeight() );
+
+	for ( crimild::Size i = 1; i <= image->getMipmapCount(); i++ ) {
+		EXPECT_EQ( 4, image->getMipmap( i )->getBpp() );
+		EXPECT_EQ( Image::PixelFormat::RGBA, image->getMipmap( i )->getPixelFormat() );
+	}
+}
+
+TEST( ImageUtilsTest, mipmapBoxFilter )
+{
+	crimild::Byte data[] = {
+		0, 10, 20, 30,
+		40, 50, 60, 70,
+		80, 90, 100, 110,
+		120, 130, 140, 150,
+	};
+	auto image = crimild::alloc< Image >( 4, 4, 1, data, Image::PixelFormat::RED );
+
+	EXPECT_TRUE( ImageUtils::generateMipmaps( crimild::get_ptr( image ), ImageUtils::MipmapFilter::BOX ) );
+
+	ASSERT_EQ( 2, image->getMipmapCount() );
+
+	auto mip = image->getMipmap( 1 )->getData();
+	EXPECT_EQ( 25, mip[ 0 ] );
+	EXPECT_EQ( 45, mip[ 1 ] );
+	EXPECT_EQ( 105, mip[ 2 ] );
+	EXPECT_EQ( 125, mip[ 3 ] );
+
+	EXPECT_EQ( 75, image->getMipmap( 2 )->getData()[ 0 ] );
+}
+
+TEST( ImageUtilsTest, mipmapKaiserPreservesConstantColor )
+{
+	const crimild::Size width = 64;
+	const crimild::Size height = 32;
+	std::vector< crimild::Byte > data( width * height * 3 );
+	for ( crimild::Size i = 0; i < width * height; i++ ) {
+		data[ i * 3 + 0 ] = 10;
+		data[ i * 3 + 1 ] = 128;
+		data[ i * 3 + 2 ] = 255;
+	}
+	auto image = crimild::alloc< Image >( width, height, 3, &data[ 0 ], Image::PixelFormat::RGB );
+
+	// Use the scheduler so rows are processed in parallel
+	concurrency::JobScheduler scheduler;
+	scheduler.configure( 2 );
+	scheduler.start();
+
+	EXPECT_TRUE( ImageUtils::generateMipmaps( crimild::get_ptr( image ), ImageUtils::MipmapFilter::KAISER ) );
+
+	scheduler.stop();
+
+	ASSERT_EQ( 6, image->getMipmapCount() );
+	for ( crimild::Size level = 1; level <= image->getMipmapCount(); level++ ) {
+		auto mip = image->getMipmap( level );
+		auto pixels = mip->getData();
+		for ( crimild::Size i = 0; i < mip->getWidth() * mip->getHeight(); i++ ) {
+			EXPECT_EQ( 10, pixels[ i * 3 + 0 ] );
+			EXPECT_EQ( 128, pixels[ i * 3 + 1 ] );
+			EXPECT_EQ( 255, pixels[ i * 3 + 2 ] );
+		}
+	}
+}
+
+TEST( ImageUtilsTest, mipmapsFromOtherThreads )
+{
+	const crimild::Size width = 64;
+	const crimild::Size height = 64;
+	std::vector< crimild::Byte > data( width * height, 42 );
+	auto image = crimild::alloc< Image >( width, height, 1, &data[ 0 ], Image::PixelFormat::RED );
+
+	concurrency::JobScheduler scheduler;
+	scheduler.configure( 2 );
+	scheduler.start();
+
+	// Asset loaders generate mipmaps in their own threads, which are
+	// not workers. Rows are processed serially in that case
+	crimild::Bool result = false;
+	std::thread loader( [ &image, &result ] {
+		result = ImageUtils::generateMipmaps( crimild::get_ptr( image ), ImageUtils::MipmapFilter::BOX );
+	});
+	loader.join();
+
+	scheduler.stop();
+
+	EXPECT_TRUE( result );
+	ASSERT_EQ( 6, image->getMipmapCount() );
+	EXPECT_EQ( 42, image->getMipmap( 6 )->getData()[ 0 ] );
+}
+
+TEST( ImageUtilsTest, mipmapUnsupportedFormat )
+{
+	auto image = crimild::alloc< Image >( 4, 4, 2, nullptr, Image::PixelFormat::DEPTH_16 );
+
+	EXPECT_FALSE( ImageUtils::generateMipmaps( crimild::get_ptr( image ) ) );
+	EXPECT_FALSE( image->hasMipmaps() );
+}
+
+TEST( ImageUtilsTest, setDataClearsMipmaps )
+{
+	auto image = crimild::alloc< Image >( 4, 4, 4, nullptr, Image::PixelFormat::RGBA );
+	ImageUtils::generateMipmaps( crimild::get_ptr( image ) );
+	EXPECT_TRUE( image->hasMipmaps() );
+
+	image->setData( 8, 8, 4, nullptr, Image::PixelFormat::RGBA );
+	EXPECT_FALSE( image->hasMipmaps() );
+}
+
@@ -41,7 +41,29 @@ TEST( IndexBufferObjectTest, construction )
 	auto ibo = crimild::alloc< IndexBufferObject >( 3, indices );
 
 	EXPECT_EQ( 3, ibo->getIndexCount() );
-	EXPECT_EQ( 0, memcmp( indices, ibo->getData(), sizeof( IndexPrecision ) * ibo->getSize() ) );
+	EXPECT_EQ( 0, memcmp( indices, ibo->getData(), ibo->getSizeInBytes() ) );
+	EXPECT_EQ( IndexBufferObject::IndexType::UINT16, ibo->getIndexType() );
+}
+
+TEST( IndexBufferObjectTest, constructionUInt32 )
+{
+	crimild::UInt32 indices[] = { 0, 70000, 2 };
+
+	auto ibo = crimild::alloc< IndexBufferObject >( 3, indices );
+
+	EXPECT_EQ( IndexBufferObject::IndexType::UINT32, ibo->getIndexType() );
+	EXPECT_EQ( 4, ibo->getIndexSize() );
+	EXPECT_EQ( 3, ibo->getIndexCount() );
+	EXPECT_EQ( 12, ibo->getSizeInBytes() );
+	EXPECT_EQ( 70000, ibo->getIndexAt( 1 ) );
+	EXPECT_EQ( 0, memcmp( indices, ibo->getData(), ibo->getSizeInBytes() ) );
+}
+
+TEST( IndexBufferObjectTest, getIndexTypeForVertexCount )
+{
+	EXPECT_EQ( IndexBufferObject::IndexType::UINT16, IndexBufferObject::getIndexTypeForVertexCount( 0 ) );
+	EXPECT_EQ( IndexBufferObject::IndexType::UINT16, IndexBufferObject::getIndexTypeForVertexCount( 65536 ) );
+	EXPECT_EQ( IndexBufferObject::IndexType::UINT32, IndexBufferObject::getIndexTypeForVertexCount( 65537 ) );
 }
 
 TEST( IndexBufferObjectTest, setIndexAt )
@@ -75,6 +97,38 @@ TEST( IndexBufferObjectTest, testGenerateIncrementalIndices )
 	EXPECT_EQ( 5, ibo->getIndexAt( 5 ) );
 }
 
+TEST( IndexBufferObjectTest, setIndexCount )
+{
+	auto ibo = crimild::alloc< IndexBufferObject >( 6 );
+	ibo->generateIncrementalIndices();
+
+	ibo->setIndexCount( 3 );
+	EXPECT_EQ( 3, ibo->getIndexCount() );
+	EXPECT_EQ( 6 * sizeof( IndexPrecision ), ibo->getCapacityInBytes() );
+
+	// indices are kept when growing again
+	ibo->setIndexCount( 6 );
+	EXPECT_EQ( 5, ibo->getIndexAt( 5 ) );
+}
+
+TEST( IndexBufferObjectTest, codingUsedIndicesOnly )
+{
+    auto ibo = crimild::alloc< IndexBufferObject >( 6 );
+    ibo->generateIncrementalIndices();
+    ibo->setIndexCount( 3 );
+    
+    auto encoder = crimild::alloc< coding::MemoryEncoder >();
+    encoder->encode( ibo );
+    auto bytes = encoder->getBytes();
+    auto decoder = crimild::alloc< coding::MemoryDecoder >();
+    decoder->fromBytes( bytes );
+    
+    auto ibo1 = decoder->getObjectAt< IndexBufferObject >( 0 );
+    EXPECT_TRUE( ibo1 != nullptr );
+    EXPECT_EQ( 3, ibo1->getIndexCount() );
+    EXPECT_EQ( 2, ibo1->getIndexAt( 2 ) );
+}
+
 TEST( IndexBufferObjectTest, coding )
 {
     auto ibo = crimild::alloc< IndexBufferObject >( 6 );
@@ -89,7 +143,7 @@ TEST( IndexBufferObjectTest, coding )
     auto ibo1 = decoder->getObjectAt< IndexBufferObject >( 0 );
     EXPECT_TRUE( ibo1 != nullptr );
     EXPECT_EQ( ibo->getIndexCount(), ibo1->getIndexCount() );
-    EXPECT_EQ( 0, memcmp( ibo->getData(), ibo1->getData(), sizeof( IndexPrecision ) * ibo1->getIndexCount() ) );
+    EXPECT_EQ( 0, memcmp( ibo->getData(), ibo1->getData(), ibo1->getSizeInBytes() ) );
 }
 
 TEST( IndexBufferObjectTest, iboStream )
@@ -110,7 +164,54 @@ TEST( IndexBufferObjectTest, iboStream )
 		auto ibo1 = is.getObjectAt< IndexBufferObject >( 0 );
 		EXPECT_TRUE( ibo1 != nullptr );
 		EXPECT_EQ( ibo->getIndexCount(), ibo1->getIndexCount() );
-		EXPECT_EQ( 0, memcmp( ibo->getData(), ibo1->getData(), sizeof( IndexPrecision ) * ibo1->getIndexCount() ) );
+		EXPECT_EQ( 0, memcmp( ibo->getData(), ibo1->getData(), ibo1->getSizeInBytes() ) );
+	}
+}
+
+
+TEST( IndexBufferObjectTest, codingUInt32 )
+{
+    auto ibo = crimild::alloc< IndexBufferObject >( 3, IndexBufferObject::IndexType::UINT32 );
+    ibo->setIndexAt( 0, 0 );
+    ibo->setIndexAt( 1, 100000 );
+    ibo->setIndexAt( 2, 200000 );
+
+    auto encoder = crimild::alloc< coding::MemoryEncoder >();
+    encoder->encode( ibo );
+    auto bytes = encoder->getBytes();
+    auto decoder = crimild::alloc< coding::MemoryDecoder >();
+    decoder->fromBytes( bytes );
+
+    auto ibo1 = decoder->getObjectAt< IndexBufferObject >( 0 );
+    EXPECT_TRUE( ibo1 != nullptr );
+    EXPECT_EQ( IndexBufferObject::IndexType::UINT32, ibo1->getIndexType() );
+    EXPECT_EQ( 3, ibo1->getIndexCount() );
+    EXPECT_EQ( 100000, ibo1->getIndexAt( 1 ) );
+    EXPECT_EQ( 200000, ibo1->getIndexAt( 2 ) );
+}
+
+TEST( IndexBufferObjectTest, iboStreamUInt32 )
+{
+	auto ibo = crimild::alloc< IndexBufferObject >( 3, IndexBufferObject::IndexType::UINT32 );
+	ibo->setIndexAt( 0, 0 );
+	ibo->setIndexAt( 1, 100000 );
+	ibo->setIndexAt( 2, 200000 );
+
+	{
+		FileStream os( "ibo32.crimild", FileStream::OpenMode::WRITE );
+		os.addObject( ibo );
+		EXPECT_TRUE( os.flush() );
+	}
+
+	{
+		FileStream is( "ibo32.crimild", FileStream::OpenMode::READ );
+		EXPECT_TRUE( is.load() );
+		EXPECT_EQ( 1, is.getObjectCount() );
+		auto ibo1 = is.getObjectAt< IndexBufferObject >( 0 );
+		EXPECT_TRUE( ibo1 != nullptr );
+		EXPECT_EQ( IndexBufferObject::IndexType::UINT32, ibo1->getIndexType() );
+		EXPECT_EQ( 3, ibo1->getIndexCount() );
+		EXPECT_EQ( 200000, ibo1->getIndexAt( 2 ) );
 	}
 }
 
@@ -66,6 +66,36 @@ TEST( VertexBufferObjectTest, complexConstruction )
 	EXPECT_EQ( 0, memcmp( vertices, vbo->getData(), sizeof( VertexPrecision ) * vbo->getSize() ) );
 }
 
+TEST( VertexBufferObjectTest, setVertexCount )
+{
+	auto vbo = crimild::alloc< VertexBufferObject >( VertexFormat::VF_P3, 10 );
+	vbo->setUsage( VertexBufferObject::Usage::STREAM );
+	vbo->setPositionAt( 2, Vector3f( 1.0f, 2.0f, 3.0f ) );
+
+	const auto data = vbo->getData();
+	const auto version = vbo->getVersion();
+
+	vbo->setVertexCount( 3 );
+	EXPECT_EQ( 3, vbo->getVertexCount() );
+	EXPECT_EQ( 3 * vbo->getVertexFormat().getVertexSize(), vbo->getSize() );
+	EXPECT_EQ( 10 * vbo->getVertexFormat().getVertexSize(), vbo->getCapacity() );
+	EXPECT_EQ( data, vbo->getData() );
+
+	// growing within capacity does not reallocate memory
+	vbo->setVertexCount( 10 );
+	EXPECT_EQ( data, vbo->getData() );
+	EXPECT_EQ( Vector3f( 1.0f, 2.0f, 3.0f ), vbo->getPositionAt( 2 ) );
+
+	// growing beyond capacity preserves contents
+	vbo->setVertexCount( 11 );
+	EXPECT_EQ( 11, vbo->getVertexCount() );
+	EXPECT_LE( 11 * vbo->getVertexFormat().getVertexSize(), vbo->getCapacity() );
+	EXPECT_EQ( Vector3f( 1.0f, 2.0f, 3.0f ), vbo->getPositionAt( 2 ) );
+
+	vbo->invalidate();
+	EXPECT_NE( version, vbo->getVersion() );
+}
+
 TEST( VertexBufferObjectTest, positions )
 {
 	auto vbo = crimild::alloc< VertexBufferObject >( VertexFormat::VF_P3, 3 );
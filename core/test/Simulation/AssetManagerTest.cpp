@@ -0,0 +1,538 @@
+/*
+ * Copyright (c) 2013, Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "Simulation/AssetManager.hpp"
+#include "Simulation/FileSystem.hpp"
+#include "Concurrency/JobScheduler.hpp"
+#include "Rendering/ImageTGA.hpp"
+#include "Rendering/Texture.hpp"
+
+#include "Utils/PumpJobs.hpp"
+#include "Utils/TemporaryFile.hpp"
+
+#include "gtest/gtest.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace crimild;
+
+namespace crimild {
+
+	class TextAsset : public SharedObject {
+	public:
+		explicit TextAsset( std::string text ) : _text( text ) { }
+		virtual ~TextAsset( void ) { }
+
+		const std::string &getText( void ) const { return _text; }
+
+	private:
+		std::string _text;
+	};
+
+	/**
+		\brief Serves files from memory instead of disk
+
+		Reads can be blocked in order to control the order in 
+		which assets are loaded
+	*/
+	class FakeFileSystem {
+	public:
+		FakeFileSystem( void )
+		{
+			FileSystem::getInstance().setFileReader( [ this ]( std::string const &path, containers::ByteArray &data ) {
+				return read( path, data );
+			});
+		}
+
+		~FakeFileSystem( void )
+		{
+			FileSystem::getInstance().setFileReader( nullptr );
+		}
+
+		void add( std::string name, std::string contents )
+		{
+			_files[ FileSystem::getInstance().pathForResource( name ) ] = contents;
+		}
+
+		void block( void )
+		{
+			std::lock_guard< std::mutex > lock( _mutex );
+			_blocked = true;
+		}
+
+		void unblock( void )
+		{
+			{
+				std::lock_guard< std::mutex > lock( _mutex );
+				_blocked = false;
+			}
+			_condition.notify_all();
+		}
+
+		bool waitForReads( crimild::Size count )
+		{
+			std::unique_lock< std::mutex > lock( _mutex );
+			return _condition.wait_for( lock, std::chrono::seconds( 5 ), [ this, count ] { return _reads.size() >= count; } );
+		}
+
+		std::vector< std::string > getReads( void )
+		{
+			std::lock_guard< std::mutex > lock( _mutex );
+			return _reads;
+		}
+
+	private:
+		crimild::Bool read( std::string const &path, containers::ByteArray &data )
+		{
+			std::unique_lock< std::mutex > lock( _mutex );
+			_reads.push_back( FileSystem::getInstance().getRelativePath( path ) );
+			_condition.notify_all();
+			_condition.wait( lock, [ this ] { return !_blocked; } );
+
+			auto it = _files.find( path );
+			if ( it == _files.end() ) {
+				return false;
+			}
+
+			data.resize( it->second.size() );
+			for ( crimild::Size i = 0; i < it->second.size(); i++ ) {
+				data[ i ] = it->second[ i ];
+			}
+			return true;
+		}
+
+	private:
+		std::map< std::string, std::string > _files;
+		std::vector< std::string > _reads;
+		crimild::Bool _blocked = false;
+		std::mutex _mutex;
+		std::condition_variable _condition;
+	};
+
+}
+
+namespace {
+
+	void registerTextLoader( AssetManager &assets )
+	{
+		assets.registerLoader( "txt", []( std::string const &name, containers::ByteArray const &data ) {
+			return crimild::alloc< TextAsset >( std::string( data.getData(), data.getData() + data.size() ) );
+		});
+	}
+
+}
+
+TEST( AssetManagerTest, loadAsync )
+{
+	concurrency::JobScheduler scheduler;
+	FakeFileSystem fs;
+	fs.add( "hello.txt", "Hello World" );
+
+	AssetManager assets;
+	registerTextLoader( assets );
+
+	crimild::Size callbackCount = 0;
+	auto request = assets.loadAsync( "hello.txt", 0, [ &callbackCount ]( AssetRequest *r ) {
+		EXPECT_EQ( AssetRequest::State::LOADED, r->getState() );
+		++callbackCount;
+	});
+
+	ASSERT_NE( nullptr, request );
+	EXPECT_EQ( "hello.txt", request->getName() );
+
+	ASSERT_TRUE( pumpUntil( scheduler, [ request ] { return request->isDone(); } ) );
+
+	EXPECT_EQ( AssetRequest::State::LOADED, request->getState() );
+	ASSERT_NE( nullptr, request->getAsset< TextAsset >() );
+	EXPECT_EQ( "Hello World", request->getAsset< TextAsset >()->getText() );
+	EXPECT_EQ( 1, callbackCount );
+	EXPECT_EQ( request->getAsset< TextAsset >(), assets.get< TextAsset >( "hello.txt" ) );
+	EXPECT_EQ( 0, assets.getPendingLoadCount() );
+}
+
+TEST( AssetManagerTest, loadAsyncTexture )
+{
+	std::string tga;
+	{
+		TemporaryFile file( "AssetManagerTest_loadAsyncTexture.tga" );
+		const unsigned char pixels[ 4 * 4 * 3 ] = { 0 };
+		ImageTGA image;
+		image.setData( 4, 4, 3, pixels, Image::PixelFormat::RGB );
+		image.saveToFile( file.getPath() );
+
+		std::ifstream input( file.getPath(), std::ios::binary );
+		tga.assign( std::istreambuf_iterator< char >( input ), std::istreambuf_iterator< char >() );
+	}
+	ASSERT_FALSE( tga.empty() );
+
+	concurrency::JobScheduler scheduler;
+	FakeFileSystem fs;
+	fs.add( "texture.tga", tga );
+
+	// image loaders are registered by default
+	AssetManager assets;
+	auto request = assets.loadAsync( "texture.tga" );
+	ASSERT_TRUE( pumpUntil( scheduler, [ request ] { return request->isDone(); } ) );
+
+	EXPECT_EQ( AssetRequest::State::LOADED, request->getState() );
+	auto texture = request->getAsset< Texture >();
+	ASSERT_NE( nullptr, texture );
+	ASSERT_NE( nullptr, texture->getImage() );
+	EXPECT_EQ( 4, texture->getImage()->getWidth() );
+	EXPECT_EQ( 2, texture->getImage()->getMipmapCount() );
+	EXPECT_EQ( Texture::Filter::LINEAR_MIPMAP_LINEAR, texture->getMinFilter() );
+}
+
+TEST( AssetManagerTest, loadAsyncCached )
+{
+	concurrency::JobScheduler scheduler;
+	FakeFileSystem fs;
+
+	AssetManager assets;
+	registerTextLoader( assets );
+
+	auto text = crimild::alloc< TextAsset >( "cached" );
+	assets.set( "cached.txt", text );
+
+	crimild::Size callbackCount = 0;
+	auto request = assets.loadAsync( "cached.txt", 0, [ &callbackCount ]( AssetRequest * ) {
+		++callbackCount;
+	});
+
+	// available right away, but callbacks are delivered in the next frame
+	EXPECT_EQ( AssetRequest::State::LOADED, request->getState() );
+	EXPECT_EQ( crimild::get_ptr( text ), request->getAsset< TextAsset >() );
+	EXPECT_EQ( 0, callbackCount );
+
+	scheduler.executeDelayedJobs();
+
+	EXPECT_EQ( 1, callbackCount );
+	EXPECT_TRUE( fs.getReads().empty() );
+}
+
+TEST( AssetManagerTest, loadAsyncDeduplicates )
+{
+	concurrency::JobScheduler scheduler;
+	FakeFileSystem fs;
+	fs.add( "shared.txt", "shared" );
+	fs.block();
+
+	AssetManager assets;
+	registerTextLoader( assets );
+
+	crimild::Size callbackCount = 0;
+	auto callback = [ &callbackCount ]( AssetRequest * ) { ++callbackCount; };
+	auto r0 = assets.loadAsync( "shared.txt", 0, callback );
+	auto r1 = assets.loadAsync( "shared.txt", 10, callback );
+
+	EXPECT_NE( r0, r1 );
+	EXPECT_EQ( 1, assets.getPendingLoadCount() );
+
+	fs.unblock();
+
+	ASSERT_TRUE( pumpUntil( scheduler, [ r0, r1 ] { return r0->isDone() && r1->isDone(); } ) );
+
+	EXPECT_EQ( 1, fs.getReads().size() );
+	EXPECT_EQ( 2, callbackCount );
+	ASSERT_NE( nullptr, r0->getAsset< TextAsset >() );
+	EXPECT_EQ( r0->getAsset< TextAsset >(), r1->getAsset< TextAsset >() );
+}
+
+TEST( AssetManagerTest, loadAsyncPriorities )
+{
+	concurrency::JobScheduler scheduler;
+	FakeFileSystem fs;
+	fs.add( "first.txt", "first" );
+	fs.add( "low.txt", "low" );
+	fs.add( "medium.txt", "medium" );
+	fs.add( "high.txt", "high" );
+	fs.add( "promoted.txt", "promoted" );
+	fs.block();
+
+	AssetManager assets;
+	assets.setMaxIOThreads( 1 );
+	registerTextLoader( assets );
+
+	// keep the only I/O thread busy while queueing the rest
+	auto first = assets.loadAsync( "first.txt" );
+	ASSERT_TRUE( fs.waitForReads( 1 ) );
+
+	auto low = assets.loadAsync( "low.txt", 0 );
+	auto promoted = assets.loadAsync( "promoted.txt", 0 );
+	auto medium = assets.loadAsync( "medium.txt", 5 );
+	auto high = assets.loadAsync( "high.txt", 10 );
+	auto promotedAgain = assets.loadAsync( "promoted.txt", 7 );
+
+	fs.unblock();
+
+	std::vector< AssetRequestPtr > requests = { first, low, promoted, medium, high, promotedAgain };
+	ASSERT_TRUE( pumpUntil( scheduler, [ &requests ] {
+		for ( auto &r : requests ) {
+			if ( !r->isDone() ) {
+				return false;
+			}
+		}
+		return true;
+	}));
+
+	auto reads = fs.getReads();
+	ASSERT_EQ( 5, reads.size() );
+	EXPECT_EQ( "first.txt", reads[ 0 ] );
+	EXPECT_EQ( "high.txt", reads[ 1 ] );
+	EXPECT_EQ( "promoted.txt", reads[ 2 ] );
+	EXPECT_EQ( "medium.txt", reads[ 3 ] );
+	EXPECT_EQ( "low.txt", reads[ 4 ] );
+}
+
+TEST( AssetManagerTest, cancelQueuedLoad )
+{
+	concurrency::JobScheduler scheduler;
+	FakeFileSystem fs;
+	fs.add( "first.txt", "first" );
+	fs.add( "cancelled.txt", "cancelled" );
+	fs.block();
+
+	AssetManager assets;
+	assets.setMaxIOThreads( 1 );
+	registerTextLoader( assets );
+
+	auto first = assets.loadAsync( "first.txt" );
+	ASSERT_TRUE( fs.waitForReads( 1 ) );
+
+	crimild::Bool invoked = false;
+	auto cancelled = assets.loadAsync( "cancelled.txt", 0, [ &invoked ]( AssetRequest * ) { invoked = true; } );
+	EXPECT_EQ( 2, assets.getPendingLoadCount() );
+
+	cancelled->cancel();
+
+	EXPECT_EQ( AssetRequest::State::CANCELLED, cancelled->getState() );
+	EXPECT_EQ( 1, assets.getPendingLoadCount() );
+
+	fs.unblock();
+
+	ASSERT_TRUE( pumpUntil( scheduler, [ first ] { return first->isDone(); } ) );
+
+	EXPECT_EQ( 1, fs.getReads().size() );
+	EXPECT_FALSE( invoked );
+	EXPECT_EQ( AssetRequest::State::CANCELLED, cancelled->getState() );
+	EXPECT_EQ( nullptr, assets.get< TextAsset >( "cancelled.txt" ) );
+}
+
+TEST( AssetManagerTest, cancelInFlightLoad )
+{
+	concurrency::JobScheduler scheduler;
+	FakeFileSystem fs;
+	fs.add( "inflight.txt", "in flight" );
+	fs.block();
+
+	AssetManager assets;
+	registerTextLoader( assets );
+
+	auto r0 = assets.loadAsync( "inflight.txt" );
+	auto r1 = assets.loadAsync( "inflight.txt" );
+	ASSERT_TRUE( fs.waitForReads( 1 ) );
+
+	// the load continues while there are other requests
+	r0->cancel();
+	EXPECT_EQ( 1, assets.getPendingLoadCount() );
+
+	r1->cancel();
+
+	fs.unblock();
+
+	ASSERT_TRUE( pumpUntil( scheduler, [ &assets ] { return assets.getPendingLoadCount() == 0; } ) );
+
+	EXPECT_EQ( AssetRequest::State::CANCELLED, r0->getState() );
+	EXPECT_EQ( AssetRequest::State::CANCELLED, r1->getState() );
+	EXPECT_EQ( nullptr, assets.get< TextAsset >( "inflight.txt" ) );
+}
+
+TEST( AssetManagerTest, loadAsyncFailures )
+{
+	concurrency::JobScheduler scheduler;
+	FakeFileSystem fs;
+	fs.add( "unknown.xyz", "no loader" );
+
+	AssetManager assets;
+	registerTextLoader( assets );
+
+	crimild::Size failures = 0;
+	auto callback = [ &failures ]( AssetRequest *r ) {
+		if ( r->getState() == AssetRequest::State::FAILED ) {
+			++failures;
+		}
+	};
+	auto missing = assets.loadAsync( "missing.txt", 0, callback );
+	auto unknown = assets.loadAsync( "unknown.xyz", 0, callback );
+
+	ASSERT_TRUE( pumpUntil( scheduler, [ missing, unknown ] { return missing->isDone() && unknown->isDone(); } ) );
+
+	EXPECT_EQ( AssetRequest::State::FAILED, missing->getState() );
+	EXPECT_EQ( nullptr, missing->getAsset< TextAsset >() );
+	EXPECT_EQ( AssetRequest::State::FAILED, unknown->getState() );
+	EXPECT_EQ( 2, failures );
+	EXPECT_EQ( 0, assets.getPendingLoadCount() );
+}
+
+TEST( AssetManagerTest, memoryBudgetEvictsLeastRecentlyUsed )
+{
+	AssetManager assets;
+	assets.setMemoryBudget( 300 );
+
+	assets.set( "a.txt", crimild::alloc< TextAsset >( "a" ), false, 100 );
+	assets.step();
+	assets.set( "b.txt", crimild::alloc< TextAsset >( "b" ), false, 100 );
+	assets.step();
+	assets.set( "c.txt", crimild::alloc< TextAsset >( "c" ), false, 100 );
+	assets.step();
+
+	// "a" is now the most recently used asset
+	EXPECT_NE( nullptr, assets.get< TextAsset >( "a.txt" ) );
+	assets.step();
+
+	assets.set( "d.txt", crimild::alloc< TextAsset >( "d" ), false, 100 );
+
+	EXPECT_NE( nullptr, assets.get< TextAsset >( "a.txt" ) );
+	EXPECT_EQ( nullptr, assets.get< TextAsset >( "b.txt" ) );
+	EXPECT_NE( nullptr, assets.get< TextAsset >( "c.txt" ) );
+	EXPECT_NE( nullptr, assets.get< TextAsset >( "d.txt" ) );
+
+	auto stats = assets.getStats();
+	EXPECT_EQ( 1, stats.evictions );
+	EXPECT_EQ( 3, stats.assetCount );
+	EXPECT_EQ( 300, stats.usedBytes );
+	EXPECT_EQ( 300, stats.memoryBudget );
+}
+
+TEST( AssetManagerTest, memoryBudgetKeepsReferencedAssets )
+{
+	AssetManager assets;
+	assets.setMemoryBudget( 100 );
+
+	auto shared = crimild::alloc< TextAsset >( "shared" );
+	assets.set( "shared.txt", shared, false, 100 );
+	assets.set( "persistent.txt", crimild::alloc< TextAsset >( "persistent" ), true, 1000 );
+	assets.step();
+
+	assets.set( "other.txt", crimild::alloc< TextAsset >( "other" ), false, 100 );
+
+	// over budget, but nothing can be evicted yet
+	EXPECT_NE( nullptr, assets.get< TextAsset >( "shared.txt" ) );
+	EXPECT_NE( nullptr, assets.get< TextAsset >( "other.txt" ) );
+	EXPECT_EQ( 200, assets.getStats().usedBytes );
+
+	assets.step();
+	assets.step();
+
+	// "other" is only referenced by the cache
+	EXPECT_NE( nullptr, assets.get< TextAsset >( "shared.txt" ) );
+	EXPECT_EQ( nullptr, assets.get< TextAsset >( "other.txt" ) );
+	EXPECT_NE( nullptr, assets.get< TextAsset >( "persistent.txt" ) );
+	EXPECT_EQ( 100, assets.getStats().usedBytes );
+}
+
+TEST( AssetManagerTest, trimWithoutBudget )
+{
+	AssetManager assets;
+
+	auto shared = crimild::alloc< TextAsset >( "shared" );
+	assets.set( "shared.txt", shared, false, 100 );
+	assets.set( "unused.txt", crimild::alloc< TextAsset >( "unused" ), false, 100 );
+	assets.step();
+
+	assets.trim();
+
+	EXPECT_NE( nullptr, assets.get< TextAsset >( "shared.txt" ) );
+	EXPECT_EQ( nullptr, assets.get< TextAsset >( "unused.txt" ) );
+	EXPECT_EQ( 1, assets.getStats().evictions );
+}
+
+TEST( AssetManagerTest, retainedAssetsOutliveEviction )
+{
+	AssetManager assets;
+
+	assets.set( "a.txt", crimild::alloc< TextAsset >( "a" ), false, 100 );
+	assets.set( "b.txt", crimild::alloc< TextAsset >( "b" ), false, 100 );
+	assets.step();
+
+	auto a = assets.get< TextAsset >( "a.txt" );
+	auto b = assets.retain< TextAsset >( "b.txt" );
+	ASSERT_NE( nullptr, a );
+	ASSERT_NE( nullptr, b );
+
+	// raw pointers are valid during the frame they were obtained
+	assets.trim();
+	EXPECT_EQ( a, assets.get< TextAsset >( "a.txt" ) );
+	EXPECT_EQ( 0, assets.getStats().evictions );
+
+	assets.step();
+	assets.trim();
+
+	EXPECT_EQ( nullptr, assets.get< TextAsset >( "a.txt" ) );
+	EXPECT_EQ( b, assets.retain< TextAsset >( "b.txt" ) );
+	EXPECT_EQ( "b", b->getText() );
+	EXPECT_EQ( nullptr, assets.retain< TextAsset >( "c.txt" ) );
+}
+
+TEST( AssetManagerTest, cacheStats )
+{
+	concurrency::JobScheduler scheduler;
+	FakeFileSystem fs;
+	fs.add( "hello.txt", "Hello World" );
+
+	AssetManager assets;
+	registerTextLoader( assets );
+
+	EXPECT_EQ( nullptr, assets.get< TextAsset >( "hello.txt" ) );
+
+	auto request = assets.loadAsync( "hello.txt" );
+	ASSERT_TRUE( pumpUntil( scheduler, [ request ] { return request->isDone(); } ) );
+
+	EXPECT_NE( nullptr, assets.get< TextAsset >( "hello.txt" ) );
+	assets.loadAsync( "hello.txt" );
+
+	auto stats = assets.getStats();
+	EXPECT_EQ( 2, stats.hits );
+	EXPECT_EQ( 2, stats.misses );
+	EXPECT_EQ( 0, stats.evictions );
+	EXPECT_EQ( 1, stats.assetCount );
+	EXPECT_EQ( 11, stats.usedBytes );
+
+	assets.resetStats();
+
+	EXPECT_EQ( 0, assets.getStats().hits );
+	EXPECT_EQ( 0, assets.getStats().misses );
+	EXPECT_EQ( 1, assets.getStats().assetCount );
+}
+
@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) 2013, Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "Simulation/Settings.hpp"
+
+#include "gtest/gtest.h"
+
+using namespace crimild;
+
+TEST( SettingsTest, setAndGet )
+{
+	Settings settings;
+
+	EXPECT_FALSE( settings.hasKey( "video.width" ) );
+	EXPECT_EQ( 1024, settings.get( "video.width", 1024 ) );
+	EXPECT_EQ( "none", settings.get( "video.title", "none" ) );
+
+	settings.set( "video.width", 800 );
+	settings.set( "video.fullscreen", true );
+	settings.set( "video.title", "Crimild" );
+	settings.set( "video.scale", 1.5f );
+
+	EXPECT_TRUE( settings.hasKey( "video.width" ) );
+	EXPECT_EQ( 800, settings.get( "video.width", 1024 ) );
+	EXPECT_EQ( "800", settings.get( "video.width", "" ) );
+	EXPECT_TRUE( settings.get< crimild::Bool >( "video.fullscreen", false ) );
+	EXPECT_EQ( "Crimild", settings.get( "video.title", "none" ) );
+	EXPECT_EQ( 1.5f, settings.get( "video.scale", 1.0f ) );
+
+	// string and compile-time keys are interchangeable
+	constexpr StringId VIDEO_WIDTH( "video.width" );
+	EXPECT_EQ( 800, settings.get( VIDEO_WIDTH, 1024 ) );
+	std::string key = "video.width";
+	EXPECT_EQ( 800, settings.get( key, 1024 ) );
+}
+
+TEST( SettingsTest, parseCommandLine )
+{
+	const char *argv[] = { "app", "video.width=640", "video.fullscreen=1", "invalid" };
+	Settings settings( 4, const_cast< char ** >( argv ) );
+
+	EXPECT_EQ( 640, settings.get( "video.width", 1024 ) );
+	EXPECT_EQ( 640.0f, settings.get( "video.width", 0.0f ) );
+	EXPECT_TRUE( settings.get< crimild::Bool >( "video.fullscreen", false ) );
+	EXPECT_FALSE( settings.hasKey( "invalid" ) );
+}
+
+TEST( SettingsTest, each )
+{
+	Settings settings;
+	settings.set( "b", 2 );
+	settings.set( "a", 1 );
+	settings.set( "c", 3 );
+
+	std::string keys;
+	settings.each( [ &keys ]( std::string key, Settings *s ) {
+		keys += key;
+		// values can be modified while iterating
+		s->set( key, s->get( key, 0 ) * 10 );
+	});
+
+	EXPECT_EQ( "abc", keys );
+	EXPECT_EQ( 10, settings.get( "a", 0 ) );
+	EXPECT_EQ( 30, settings.get( "c", 0 ) );
+}
+
@@ -0,0 +1,240 @@
+/*
+ * Copyright (c) 2013, Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "Simulation/Systems/StreamingSystem.hpp"
+#include "Concurrency/JobScheduler.hpp"
+#include "SceneGraph/Group.hpp"
+
+#include "Utils/PumpJobs.hpp"
+
+#include "gtest/gtest.h"
+
+#include <atomic>
+#include <chrono>
+#include <sstream>
+#include <thread>
+
+using namespace crimild;
+
+namespace {
+
+	SharedPointer< Node > buildCell( std::string fileName )
+	{
+		auto cell = crimild::alloc< Group >( fileName );
+		cell->attachNode( crimild::alloc< Node >() );
+		cell->attachNode( crimild::alloc< Node >() );
+		return cell;
+	}
+
+	std::string cellFileName( crimild::Int32 x, crimild::Int32 z )
+	{
+		std::stringstream ss;
+		ss << x << "_" << z << ".cell";
+		return ss.str();
+	}
+
+}
+
+TEST( StreamingSystemTest, streamCellsAroundViewer )
+{
+	concurrency::JobScheduler scheduler;
+	scheduler.configure( 2 );
+	scheduler.start();
+
+	auto scene = crimild::alloc< Group >();
+
+	auto streaming = crimild::alloc< StreamingSystem >();
+	streaming->registerBuilder( "cell", buildCell );
+	streaming->setWorldGrid( 10.0f, cellFileName );
+	streaming->setLoadRadius( 12.0f );
+	streaming->setUnloadRadius( 20.0f );
+
+	// 3x3 cells around the viewer
+	streaming->updateStreaming( crimild::get_ptr( scene ), Vector3f( 5.0f, 0.0f, 5.0f ) );
+
+	auto root = streaming->getStreamingRoot();
+	EXPECT_EQ( scene.get(), root->getParent() );
+	EXPECT_EQ( 9, streaming->getCellCount() );
+
+	ASSERT_TRUE( pumpUntil( scheduler, [ streaming ] { return streaming->getReadyCount() == 9; } ) );
+
+	streaming->updateStreaming( crimild::get_ptr( scene ), Vector3f( 5.0f, 0.0f, 5.0f ) );
+	EXPECT_EQ( 9, root->getNodeCount() );
+	EXPECT_EQ( 0, streaming->getReadyCount() );
+
+	auto found = false;
+	root->forEachNode( [ &found ]( Node *node ) {
+		found |= node->getName() == "-1_1.cell";
+	});
+	EXPECT_TRUE( found );
+
+	// move away. Old cells are unloaded
+	streaming->updateStreaming( crimild::get_ptr( scene ), Vector3f( 105.0f, 0.0f, 5.0f ) );
+	EXPECT_EQ( 0, root->getNodeCount() );
+	EXPECT_EQ( 9, streaming->getCellCount() );
+
+	ASSERT_TRUE( pumpUntil( scheduler, [ streaming ] { return streaming->getReadyCount() == 9; } ) );
+
+	streaming->updateStreaming( crimild::get_ptr( scene ), Vector3f( 105.0f, 0.0f, 5.0f ) );
+	EXPECT_EQ( 9, root->getNodeCount() );
+	root->forEachNode( []( Node *node ) {
+		EXPECT_NE( "0_0.cell", node->getName() );
+	});
+
+	scheduler.stop();
+}
+
+TEST( StreamingSystemTest, unloadRadius )
+{
+	concurrency::JobScheduler scheduler;
+	scheduler.configure( 2 );
+	scheduler.start();
+
+	auto scene = crimild::alloc< Group >();
+
+	auto streaming = crimild::alloc< StreamingSystem >();
+	streaming->registerBuilder( "cell", buildCell );
+	streaming->setWorldGrid( 10.0f, []( crimild::Int32 x, crimild::Int32 z ) {
+		return z == 0 ? cellFileName( x, z ) : std::string( "" );
+	});
+	streaming->setLoadRadius( 4.0f );
+	streaming->setUnloadRadius( 8.0f );
+
+	streaming->updateStreaming( crimild::get_ptr( scene ), Vector3f( 5.0f, 0.0f, 5.0f ) );
+	ASSERT_TRUE( pumpUntil( scheduler, [ streaming ] { return streaming->getReadyCount() == 1; } ) );
+	streaming->updateStreaming( crimild::get_ptr( scene ), Vector3f( 5.0f, 0.0f, 5.0f ) );
+	EXPECT_EQ( 1, streaming->getStreamingRoot()->getNodeCount() );
+
+	// the next cell is loaded, but the previous one is kept
+	streaming->updateStreaming( crimild::get_ptr( scene ), Vector3f( 13.0f, 0.0f, 5.0f ) );
+	ASSERT_TRUE( pumpUntil( scheduler, [ streaming ] { return streaming->getReadyCount() == 1; } ) );
+	streaming->updateStreaming( crimild::get_ptr( scene ), Vector3f( 13.0f, 0.0f, 5.0f ) );
+	EXPECT_EQ( 2, streaming->getStreamingRoot()->getNodeCount() );
+
+	streaming->updateStreaming( crimild::get_ptr( scene ), Vector3f( 19.0f, 0.0f, 5.0f ) );
+	EXPECT_EQ( 1, streaming->getStreamingRoot()->getNodeCount() );
+	EXPECT_EQ( "1_0.cell", streaming->getStreamingRoot()->getNodeAt( 0 )->getName() );
+
+	scheduler.stop();
+}
+
+TEST( StreamingSystemTest, attachBudget )
+{
+	concurrency::JobScheduler scheduler;
+	scheduler.configure( 2 );
+	scheduler.start();
+
+	auto scene = crimild::alloc< Group >();
+
+	auto streaming = crimild::alloc< StreamingSystem >();
+	streaming->registerBuilder( "cell", buildCell );
+	streaming->setWorldGrid( 10.0f, cellFileName );
+	streaming->setLoadRadius( 12.0f );
+	streaming->setUnloadRadius( 20.0f );
+
+	// each cell has three nodes
+	streaming->setMaxNodesAttachedPerFrame( 6 );
+
+	streaming->updateStreaming( crimild::get_ptr( scene ), Vector3f( 5.0f, 0.0f, 5.0f ) );
+	ASSERT_TRUE( pumpUntil( scheduler, [ streaming ] { return streaming->getReadyCount() == 9; } ) );
+
+	auto root = streaming->getStreamingRoot();
+	crimild::Size expected[] = { 2, 4, 6, 8, 9, 9 };
+	for ( auto count : expected ) {
+		streaming->updateStreaming( crimild::get_ptr( scene ), Vector3f( 5.0f, 0.0f, 5.0f ) );
+		EXPECT_EQ( count, root->getNodeCount() );
+	}
+
+	scheduler.stop();
+}
+
+TEST( StreamingSystemTest, appendScene )
+{
+	concurrency::JobScheduler scheduler;
+	scheduler.configure( 2 );
+	scheduler.start();
+
+	auto scene = crimild::alloc< Group >();
+	auto parent = crimild::alloc< Group >();
+	scene->attachNode( parent );
+
+	auto streaming = crimild::alloc< StreamingSystem >();
+	streaming->registerBuilder( "cell", buildCell );
+
+	MessageQueue::getInstance()->broadcastMessage( messaging::AppendScene { "appended.cell", crimild::get_ptr( parent ) } );
+	MessageQueue::getInstance()->broadcastMessage( messaging::AppendScene { "root.cell", nullptr } );
+
+	ASSERT_TRUE( pumpUntil( scheduler, [ streaming ] { return streaming->getReadyCount() == 2; } ) );
+
+	streaming->updateStreaming( crimild::get_ptr( scene ), Vector3f::ZERO );
+
+	ASSERT_EQ( 1, parent->getNodeCount() );
+	EXPECT_EQ( "appended.cell", parent->getNodeAt( 0 )->getName() );
+	ASSERT_EQ( 2, scene->getNodeCount() );
+	EXPECT_EQ( "root.cell", scene->getNodeAt( 1 )->getName() );
+
+	// no world grid, so there's no streaming root
+	EXPECT_EQ( nullptr, streaming->getStreamingRoot()->getParent() );
+
+	scheduler.stop();
+}
+
+TEST( StreamingSystemTest, destroyWhileLoading )
+{
+	concurrency::JobScheduler scheduler;
+	scheduler.configure( 2 );
+	scheduler.start();
+
+	auto scene = crimild::alloc< Group >();
+
+	std::atomic< crimild::Size > buildCount( 0 );
+
+	auto streaming = crimild::alloc< StreamingSystem >();
+	streaming->registerBuilder( "cell", [ &buildCount ]( std::string fileName ) {
+		std::this_thread::sleep_for( std::chrono::milliseconds( 10 ) );
+		auto cell = buildCell( fileName );
+		++buildCount;
+		return cell;
+	});
+	streaming->setWorldGrid( 10.0f, cellFileName );
+	streaming->setLoadRadius( 12.0f );
+	streaming->updateStreaming( crimild::get_ptr( scene ), Vector3f( 5.0f, 0.0f, 5.0f ) );
+	EXPECT_EQ( 9, streaming->getCellCount() );
+
+	streaming->stop();
+	EXPECT_EQ( 0, streaming->getCellCount() );
+	streaming = nullptr;
+
+	// loads finishing after the system is gone must be ignored
+	ASSERT_TRUE( pumpUntil( scheduler, [ &buildCount ] { return buildCount == 9; } ) );
+	std::this_thread::sleep_for( std::chrono::milliseconds( 10 ) );
+	scheduler.executeDelayedJobs();
+
+	EXPECT_EQ( 0, scene->getNodeAt< Group >( 0 )->getNodeCount() );
+
+	scheduler.stop();
+}
@@ -0,0 +1,64 @@
+/*
+ * Copyright (c) 2013, Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef CRIMILD_TESTS_UTILS_PUMP_JOBS_
+#define CRIMILD_TESTS_UTILS_PUMP_JOBS_
+
+#include "Concurrency/JobScheduler.hpp"
+
+#include <chrono>
+#include <functional>
+#include <thread>
+
+namespace crimild {
+
+	/**
+		\brief Executes delayed jobs (like the ones created with sync_frame) 
+		until a condition is met
+
+		Simulates the main loop for tests that don't create a Simulation.
+		Returns false if the condition is not met after five seconds.
+	*/
+	inline bool pumpUntil( concurrency::JobScheduler &scheduler, std::function< bool( void ) > const &done )
+	{
+		auto start = std::chrono::steady_clock::now();
+		while ( true ) {
+			scheduler.executeDelayedJobs();
+			if ( done() ) {
+				return true;
+			}
+			if ( std::chrono::steady_clock::now() - start > std::chrono::seconds( 5 ) ) {
+				return false;
+			}
+			std::this_thread::sleep_for( std::chrono::milliseconds( 1 ) );
+		}
+	}
+
+}
+
+#endif
+
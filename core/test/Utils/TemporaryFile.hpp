@@ -0,0 +1,59 @@
+/*
+ * Copyright (c) 2013, Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef CRIMILD_TESTS_UTILS_TEMPORARY_FILE_
+#define CRIMILD_TESTS_UTILS_TEMPORARY_FILE_
+
+#include <cstdio>
+#include <string>
+
+namespace crimild {
+
+	/**
+		\brief Removes a file written by a test when going out of scope
+
+		Files are removed even if an assertion fails, so tests don't leave
+		artifacts in the working directory.
+	*/
+	class TemporaryFile {
+	public:
+		explicit TemporaryFile( std::string const &path ) : _path( path ) { }
+		~TemporaryFile( void ) { std::remove( _path.c_str() ); }
+
+		TemporaryFile( TemporaryFile const & ) = delete;
+		TemporaryFile &operator=( TemporaryFile const & ) = delete;
+
+		std::string const &getPath( void ) const { return _path; }
+
+	private:
+		std::string _path;
+	};
+
+}
+
+#endif
+
@@ -30,9 +30,11 @@
 #include "Components/SkinnedMeshComponent.hpp"
 #include "Components/MaterialComponent.hpp"
 #include "Exceptions/FileNotFoundException.hpp"
+#include "Loaders/SceneCache.hpp"
 #include "Rendering/SkinnedMesh.hpp"
 #include "Rendering/Material.hpp"
 #include "Primitives/Primitive.hpp"
+#include "Primitives/MeshOptimizer.hpp"
 #include "SceneGraph/Group.hpp"
 #include "SceneGraph/Geometry.hpp"
 #include "Simulation/FileSystem.hpp"
@@ -75,6 +77,14 @@ SharedPointer< Group > SceneImporter::import( std::string filename )
 		throw FileNotFoundException( filename );
 	}
 
+	const auto cacheFileName = SceneCache::getCacheFileName( filename );
+	if ( auto cached = SceneCache::read( cacheFileName ) ) {
+		return cached;
+	}
+
+	_sourceFileNames.clear();
+	_sourceFileNames.push_back( filename );
+
 	Assimp::Importer importer;
 	importer.SetPropertyInteger( AI_CONFIG_PP_SLM_VERTEX_LIMIT, 15000 );
 	const aiScene* importedScene = importer.ReadFile( filename, aiProcessPreset_TargetRealtime_MaxQuality );
@@ -97,6 +107,8 @@ SharedPointer< Group > SceneImporter::import( std::string filename )
 		root->attachComponent( _skeleton );
 	}
 
+	SceneCache::write( cacheFileName, crimild::get_ptr( root ), _sourceFileNames );
+
 	return root;
 }
 
@@ -132,6 +144,7 @@ void SceneImporter::loadMaterialTexture( SharedPointer< Material > material, con
 		auto fileName = FileSystem::getInstance().getFileName( texPath.data, false );
 		fileName += ".tga";
 		auto texturePath = basePath + fileName;
+		_sourceFileNames.push_back( texturePath );
 		auto texture = AssetManager::getInstance()->get< Texture >( texturePath );
 		if ( texture != nullptr ) {
 			switch ( texType ) {
@@ -289,7 +302,7 @@ void SceneImporter::recursiveSceneBuilder( SharedPointer< Group > parent, const
 
 		// load indices
 		const unsigned int INDEX_COUNT = mesh->mNumFaces * face->mNumIndices;
-		auto ibo = crimild::alloc< IndexBufferObject >( INDEX_COUNT );
+		auto ibo = crimild::alloc< IndexBufferObject >( INDEX_COUNT, IndexBufferObject::getIndexTypeForVertexCount( mesh->mNumVertices ) );
 
 		for ( int f = 0; f < mesh->mNumFaces; f++ ) {
 			const struct aiFace *face = &mesh->mFaces[ f ];
@@ -326,6 +339,10 @@ void SceneImporter::recursiveSceneBuilder( SharedPointer< Group > parent, const
 		primitive->setVertexBuffer( vbo );
 		primitive->setIndexBuffer( ibo );
 
+		// done after bone weights are set, since welding and reordering
+		// change vertex indices
+		MeshOptimizer::optimize( crimild::get_ptr( primitive ) );
+
 		auto geometry = crimild::alloc< Geometry >();
 		geometry->attachPrimitive( primitive );
 		group->attachNode( geometry );
@@ -35,6 +35,8 @@
 #include "assimp/Importer.hpp"
 #include "assimp/scene.h"
 
+#include <vector>
+
 namespace crimild {
     
     class Group;
@@ -67,6 +69,11 @@ namespace crimild {
 			containers::Map< std::string, SharedPointer< animation::Joint >> _joints;
 			SharedPointer< animation::Skeleton > _skeleton;
 
+			/**
+			   \brief Files read during import, used to validate the scene cache
+			 */
+			std::vector< std::string > _sourceFileNames;
+
 		private:
 			void computeTransform( const aiMatrix4x4 &m, Transformation &t );
 			void loadMaterialTexture( SharedPointer< Material > material, const aiMaterial *input, std::string basePath, aiTextureType texType, unsigned int texIndex = 0 );
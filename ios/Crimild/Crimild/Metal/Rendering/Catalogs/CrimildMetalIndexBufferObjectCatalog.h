@@ -49,6 +49,7 @@ namespace crimild {
             virtual void unbind( ShaderProgram *program, IndexBufferObject *ibo ) override;
             
             virtual void load( IndexBufferObject *ibo ) override;
+            virtual void update( IndexBufferObject *ibo ) override;
             virtual void unload( IndexBufferObject *ibo ) override;
             
             virtual void cleanup( void ) override;
@@ -62,6 +63,7 @@ namespace crimild {
         private:
             MetalRenderer *_renderer;
             std::map< int, id< MTLBuffer > > _ibos;
+            std::map< int, crimild::UInt32 > _versions;
             int _nextBufferId;
         };
         
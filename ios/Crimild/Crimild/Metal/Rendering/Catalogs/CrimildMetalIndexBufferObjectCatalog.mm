@@ -55,6 +55,8 @@ int IndexBufferObjectCatalog::getNextResourceId( void )
 void IndexBufferObjectCatalog::bind( ShaderProgram *program, IndexBufferObject *ibo )
 {
     Catalog< IndexBufferObject >::bind( ibo );
+    
+    update( ibo );
 }
 
 void IndexBufferObjectCatalog::unbind( ShaderProgram *program, IndexBufferObject *vbo )
@@ -67,16 +69,29 @@ void IndexBufferObjectCatalog::load( IndexBufferObject *ibo )
     Catalog< IndexBufferObject >::load( ibo );
     
     id< MTLBuffer > indexArray = [getRenderer()->getDevice() newBufferWithBytes: ibo->getData()
-                                                                         length: ibo->getSizeInBytes()
+                                                                         length: ibo->getCapacityInBytes()
                                                                         options: MTLResourceOptionCPUCacheModeDefault];
     
     _ibos[ ibo->getCatalogId() ] = indexArray;
+    _versions[ ibo->getCatalogId() ] = ibo->getVersion();
+}
+
+void IndexBufferObjectCatalog::update( IndexBufferObject *ibo )
+{
+    if ( ibo->getCatalogId() < 0 || _versions[ ibo->getCatalogId() ] == ibo->getVersion() ) {
+        return;
+    }
     
+    _ibos[ ibo->getCatalogId() ] = [getRenderer()->getDevice() newBufferWithBytes: ibo->getData()
+                                                                           length: ibo->getCapacityInBytes()
+                                                                          options: MTLResourceOptionCPUCacheModeDefault];
+    _versions[ ibo->getCatalogId() ] = ibo->getVersion();
 }
 
 void IndexBufferObjectCatalog::unload( IndexBufferObject *ibo )
 {
     _ibos[ ibo->getCatalogId() ] = nullptr;
+    _versions.erase( ibo->getCatalogId() );
     
     Catalog< IndexBufferObject >::unload( ibo );
 }
@@ -49,6 +49,7 @@ namespace crimild {
             virtual void unbind( ShaderProgram *program, VertexBufferObject *vbo ) override;
             
             virtual void load( VertexBufferObject *vbo ) override;
+            virtual void update( VertexBufferObject *vbo ) override;
             virtual void unload( VertexBufferObject *vbo ) override;
             
             virtual void cleanup( void ) override;
@@ -59,6 +60,7 @@ namespace crimild {
         private:
             MetalRenderer *_renderer;
             std::map< int, id< MTLBuffer > > _vbos;
+            std::map< int, crimild::UInt32 > _versions;
             int _nextBufferId;
         };
         
@@ -60,6 +60,8 @@ void VertexBufferObjectCatalog::bind( ShaderProgram *program, VertexBufferObject
         return;
     }
     
+    update( vbo );
+    
     [getRenderer()->getRenderEncoder() setVertexBuffer: _vbos[ vbo->getCatalogId() ]
                                                 offset: 0
                                                atIndex: 0];
@@ -76,15 +78,30 @@ void VertexBufferObjectCatalog::load( VertexBufferObject *vbo )
     
     if ( vbo->getData() != nullptr ) {
         id< MTLBuffer > vertexArray = [getRenderer()->getDevice() newBufferWithBytes: vbo->getData()
-                                                                              length: vbo->getSizeInBytes()
+                                                                              length: vbo->getCapacityInBytes()
                                                                              options: MTLResourceOptionCPUCacheModeDefault];
         _vbos[ vbo->getCatalogId() ] = vertexArray;
+        _versions[ vbo->getCatalogId() ] = vbo->getVersion();
     }
 }
 
+void VertexBufferObjectCatalog::update( VertexBufferObject *vbo )
+{
+    if ( vbo->getCatalogId() < 0 || _versions[ vbo->getCatalogId() ] == vbo->getVersion() ) {
+        return;
+    }
+    
+    // buffers might still be in use by the GPU, so we need new ones
+    _vbos[ vbo->getCatalogId() ] = [getRenderer()->getDevice() newBufferWithBytes: vbo->getData()
+                                                                           length: vbo->getCapacityInBytes()
+                                                                          options: MTLResourceOptionCPUCacheModeDefault];
+    _versions[ vbo->getCatalogId() ] = vbo->getVersion();
+}
+
 void VertexBufferObjectCatalog::unload( VertexBufferObject *vbo )
 {
     _vbos[ vbo->getCatalogId() ] = nullptr;
+    _versions.erase( vbo->getCatalogId() );
     
     Catalog< VertexBufferObject >::unload( vbo );
 }
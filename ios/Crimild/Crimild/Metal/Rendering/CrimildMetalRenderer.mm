@@ -338,11 +338,12 @@ void MetalRenderer::drawPrimitive( ShaderProgram *program, Primitive *primitive
     [getRenderEncoder() setFragmentBuffer: uniforms offset: 0 atIndex: location->getLocation()];
 
     auto indexCount = primitive->getIndexBuffer()->getIndexCount();
+    auto indexType = primitive->getIndexBuffer()->getIndexType() == IndexBufferObject::IndexType::UINT32 ? MTLIndexTypeUInt32 : MTLIndexTypeUInt16;
     auto indexBuffer = static_cast< IndexBufferObjectCatalog * >( getIndexBufferObjectCatalog() )->getMetalIndexBuffer( primitive->getIndexBuffer() );
     
     [getRenderEncoder() drawIndexedPrimitives: MTLPrimitiveTypeTriangle
                                    indexCount: indexCount
-                                    indexType: MTLIndexTypeUInt16
+                                    indexType: indexType
                                   indexBuffer: indexBuffer
                             indexBufferOffset: 0];
 }
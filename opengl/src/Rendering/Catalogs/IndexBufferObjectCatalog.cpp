@@ -92,9 +92,36 @@ void IndexBufferObjectCatalog::load( IndexBufferObject *ibo )
 	int id = ibo->getCatalogId();
 	glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, id );
 	glBufferData( GL_ELEMENT_ARRAY_BUFFER, 
-		sizeof( IndexPrecision ) * ibo->getIndexCount(), 
+		ibo->getCapacityInBytes(), 
 		ibo->getData(), 
-		GL_STATIC_DRAW );
+		ibo->getUsage() == IndexBufferObject::Usage::STREAM ? GL_STREAM_DRAW : GL_STATIC_DRAW );
+
+    _versions[ id ] = ibo->getVersion();
+    
+    CRIMILD_CHECK_GL_ERRORS_AFTER_CURRENT_FUNCTION;
+}
+
+void IndexBufferObjectCatalog::update( IndexBufferObject *ibo )
+{
+	if ( ibo == nullptr || ibo->getCatalog() == nullptr ) return;
+
+	int id = ibo->getCatalogId();
+
+	auto &version = _versions[ id ];
+	if ( version == ibo->getVersion() ) {
+		return;
+	}
+
+    CRIMILD_CHECK_GL_ERRORS_BEFORE_CURRENT_FUNCTION;
+
+	// See VertexBufferObjectCatalog::update()
+	glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, id );
+	glBufferData( GL_ELEMENT_ARRAY_BUFFER, ibo->getCapacityInBytes(), nullptr, GL_STREAM_DRAW );
+	if ( ibo->getSizeInBytes() > 0 ) {
+		glBufferSubData( GL_ELEMENT_ARRAY_BUFFER, 0, ibo->getSizeInBytes(), ibo->getData() );
+	}
+
+	version = ibo->getVersion();
     
     CRIMILD_CHECK_GL_ERRORS_AFTER_CURRENT_FUNCTION;
 }
@@ -106,6 +133,7 @@ void IndexBufferObjectCatalog::unload( IndexBufferObject *ibo )
     CRIMILD_CHECK_GL_ERRORS_BEFORE_CURRENT_FUNCTION;
     
     _unusedIBOIds.push_back( ibo->getCatalogId() );
+    _versions.erase( ibo->getCatalogId() );
 	Catalog< IndexBufferObject >::unload( ibo );
     
     CRIMILD_CHECK_GL_ERRORS_AFTER_CURRENT_FUNCTION;
@@ -30,6 +30,8 @@
 
 #include <Rendering/Catalog.hpp>
 
+#include <map>
+
 namespace crimild {
     
     class IndexBufferObject;
@@ -47,12 +49,18 @@ namespace crimild {
 			virtual void unbind( IndexBufferObject *ibo ) override;
 
 			virtual void load( IndexBufferObject *ibo ) override;
+            virtual void update( IndexBufferObject *ibo ) override;
             virtual void unload( IndexBufferObject *ibo ) override;
             
             virtual void cleanup( void ) override;
             
         private:
             std::list< int > _unusedIBOIds;
+
+            /**
+                \brief Last uploaded version for each buffer
+             */
+            std::map< int, crimild::UInt32 > _versions;
 		};
 
 	}
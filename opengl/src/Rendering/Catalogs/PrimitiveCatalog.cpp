@@ -26,6 +26,7 @@
  */
 
 #include "PrimitiveCatalog.hpp"
+#include "VertexBufferObjectCatalog.hpp"
 
 #include "Rendering/OpenGLUtils.hpp"
 
@@ -37,6 +38,12 @@
 using namespace crimild;
 using namespace crimild::opengl;
 
+static VertexBufferObjectCatalog *getInstanceBufferCatalog( void )
+{
+	// Instance buffers are regular VBOs, but bound with different locations
+	return static_cast< VertexBufferObjectCatalog * >( Renderer::getInstance()->getVertexBufferObjectCatalog() );
+}
+
 PrimitiveCatalog::PrimitiveCatalog( void )
 {
 
@@ -72,10 +79,21 @@ void PrimitiveCatalog::bind( Primitive *primitive )
 
 	auto vbo = primitive->getVertexBuffer();
 	auto ibo = primitive->getIndexBuffer();
-	if ( vbo->getCatalog() == nullptr || ibo->getCatalog() == nullptr ) {
-		// Either vbo or ibo changed, so we need to reload the primitive
+	auto instances = primitive->getInstanceBuffer();
+	if ( vbo->getCatalog() == nullptr || ibo->getCatalog() == nullptr || ( instances != nullptr && instances->getCatalog() == nullptr ) ) {
+		// Either vbo, ibo or instances changed, so we need to reload the primitive
 		unload( primitive );
 	}
+	else {
+		// Upload new contents for streaming buffers, if any. Must be
+		// done before binding the VAO to avoid modifying its state
+		auto renderer = Renderer::getInstance();
+		renderer->getVertexBufferObjectCatalog()->update( vbo );
+		renderer->getIndexBufferObjectCatalog()->update( ibo );
+		if ( instances != nullptr ) {
+			renderer->getVertexBufferObjectCatalog()->update( instances );
+		}
+	}
 
 	Catalog< Primitive >::bind( primitive );
 
@@ -91,6 +109,7 @@ void PrimitiveCatalog::bind( Primitive *primitive )
 	auto renderer = Renderer::getInstance();
 	renderer->getVertexBufferObjectCatalog()->bind( primitive->getVertexBuffer() );
 	renderer->getIndexBufferObjectCatalog()->bind( primitive->getIndexBuffer() );
+	getInstanceBufferCatalog()->bindInstances( primitive->getInstanceBuffer() );
 #endif
 
 	CRIMILD_CHECK_GL_ERRORS_AFTER_CURRENT_FUNCTION;
@@ -109,6 +128,7 @@ void PrimitiveCatalog::unbind( Primitive *primitive )
 #else
 	// Unbind buffers here in compat mode
 	auto renderer = Renderer::getInstance();
+	getInstanceBufferCatalog()->unbindInstances( primitive->getInstanceBuffer() );
 	renderer->getVertexBufferObjectCatalog()->unbind( primitive->getVertexBuffer() );
 	renderer->getIndexBufferObjectCatalog()->unbind( primitive->getIndexBuffer() );
 #endif
@@ -131,6 +151,7 @@ void PrimitiveCatalog::load( Primitive *primitive )
 	auto renderer = Renderer::getInstance();
 	renderer->getVertexBufferObjectCatalog()->bind( primitive->getVertexBuffer() );
 	renderer->getIndexBufferObjectCatalog()->bind( primitive->getIndexBuffer() );
+	getInstanceBufferCatalog()->bindInstances( primitive->getInstanceBuffer() );
 
 #ifndef CRIMILD_FORCE_OPENGL_COMPATIBILITY_MODE
 	glBindVertexArray( 0 );
@@ -146,6 +167,7 @@ void PrimitiveCatalog::unload( Primitive *primitive )
 	auto renderer = Renderer::getInstance();
 	renderer->getVertexBufferObjectCatalog()->unload( primitive->getVertexBuffer() );
 	renderer->getIndexBufferObjectCatalog()->unload( primitive->getIndexBuffer() );
+	renderer->getVertexBufferObjectCatalog()->unload( primitive->getInstanceBuffer() );
 
     if ( primitive->getCatalogId() > 0 ) {
         _primitiveIdsToDelete.push_back( primitive->getCatalogId() );
@@ -33,6 +33,23 @@
 #include <Rendering/Texture.hpp>
 #include <Rendering/ShaderLocation.hpp>
 
+// Not every platform header declares all compressed formats
+#ifndef GL_COMPRESSED_RGB_S3TC_DXT1_EXT
+#define GL_COMPRESSED_RGB_S3TC_DXT1_EXT 0x83F0
+#endif
+#ifndef GL_COMPRESSED_RGBA_S3TC_DXT5_EXT
+#define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT 0x83F3
+#endif
+#ifndef GL_COMPRESSED_RGBA_BPTC_UNORM
+#define GL_COMPRESSED_RGBA_BPTC_UNORM 0x8E8C
+#endif
+#ifndef GL_COMPRESSED_RGB8_ETC2
+#define GL_COMPRESSED_RGB8_ETC2 0x9274
+#endif
+#ifndef GL_COMPRESSED_RGBA8_ETC2_EAC
+#define GL_COMPRESSED_RGBA8_ETC2_EAC 0x9278
+#endif
+
 // TODO: this will cause visual artifacts in some platforms. use with care
 #ifndef GL_BGR
     #define GL_BGR GL_RGB
@@ -175,8 +192,6 @@ void TextureCatalog::load( Texture *texture )
     glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, OpenGLUtils::TEXTURE_WRAP_MODE_CLAMP[ ( uint8_t ) texture->getWrapMode() ] );
 
 	auto image = texture->getImage();
-	auto width = image->getWidth();
-	auto height = image->getHeight();
 
 	GLenum internalFormat = GL_INVALID_ENUM;
 	GLenum textureFormat = GL_INVALID_ENUM;
@@ -226,24 +241,80 @@ void TextureCatalog::load( Texture *texture )
 		case Image::PixelFormat::RED:
 			internalFormat = GL_RED;
 			textureFormat = GL_RED;
+			break;
+
+		case Image::PixelFormat::BC1:
+			internalFormat = GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+			break;
+
+		case Image::PixelFormat::BC3:
+			internalFormat = GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+			break;
+
+		case Image::PixelFormat::BC7:
+			internalFormat = GL_COMPRESSED_RGBA_BPTC_UNORM;
+			break;
+
+		case Image::PixelFormat::ETC2_RGB:
+			internalFormat = GL_COMPRESSED_RGB8_ETC2;
+			break;
+
+		case Image::PixelFormat::ETC2_RGBA:
+			internalFormat = GL_COMPRESSED_RGBA8_ETC2_EAC;
+			break;
 			
 		default:
 			Log::error( CRIMILD_CURRENT_CLASS_NAME, "Invalid target type: ", ( int ) image->getPixelFormat() );
 			break;
 	}
     
-	GLvoid *data = image->hasData() ? image->getData() : nullptr;
-
-    glTexImage2D(
-		GL_TEXTURE_2D,
-		0,
-		internalFormat, 
-    	width,
-		height,
-		0, 
-    	textureFormat, 
-    	textureType,
-        data );
+	// Mipmaps are generated on the CPU when loading the image (or are
+	// already stored in compressed files), so upload all levels instead 
+	// of calling glGenerateMipmap
+	auto levels = image->getMipmapCount();
+
+	// Rows are tightly packed, so the default 4-byte alignment would make GL
+	// read past the end of RGB or RED levels (i.e. the 2x2 and 1x1 mips)
+	GLint unpackAlignment = 4;
+	glGetIntegerv( GL_UNPACK_ALIGNMENT, &unpackAlignment );
+	glPixelStorei( GL_UNPACK_ALIGNMENT, 1 );
+
+	for ( crimild::Size level = 0; level <= levels; level++ ) {
+		auto mip = image->getMipmap( level );
+		GLvoid *data = mip->hasData() ? mip->getData() : nullptr;
+
+		if ( image->isCompressed() ) {
+			glCompressedTexImage2D(
+				GL_TEXTURE_2D,
+				level,
+				internalFormat,
+				mip->getWidth(),
+				mip->getHeight(),
+				0,
+				mip->getDataSize(),
+				data );
+		}
+		else {
+			glTexImage2D(
+				GL_TEXTURE_2D,
+				level,
+				internalFormat,
+				mip->getWidth(),
+				mip->getHeight(),
+				0,
+				textureFormat,
+				textureType,
+				data );
+		}
+	}
+
+	glPixelStorei( GL_UNPACK_ALIGNMENT, unpackAlignment );
+
+#ifdef CRIMILD_PLATFORM_DESKTOP
+	if ( levels > 0 ) {
+		glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, levels );
+	}
+#endif
     
     CRIMILD_CHECK_GL_ERRORS_AFTER_CURRENT_FUNCTION;
 }
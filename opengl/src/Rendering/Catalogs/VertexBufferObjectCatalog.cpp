@@ -57,99 +57,85 @@ int VertexBufferObjectCatalog::getNextResourceId( void )
     return vboId;
 }
 
-void VertexBufferObjectCatalog::bind( VertexBufferObject *vbo )
+static void enableVertexAttribute( GLuint location, crimild::Size components, crimild::Size offset, const VertexFormat &format, GLuint divisor )
 {
-	if ( vbo == nullptr ) return;
-
-	CRIMILD_CHECK_GL_ERRORS_BEFORE_CURRENT_FUNCTION;
-
-	if ( vbo->getCatalog() == nullptr ) {
-		Catalog< VertexBufferObject >::bind( vbo );
-    }
-
-    GLuint vboId = vbo->getCatalogId();
-
-    glBindBuffer( GL_ARRAY_BUFFER, vboId );
     float *baseOffset = 0;
 
-    const VertexFormat &format = vbo->getVertexFormat();
+	glEnableVertexAttribArray( location );
+	glVertexAttribPointer(
+		location,
+		components,
+		GL_FLOAT,
+		GL_FALSE,
+		format.getVertexSizeInBytes(),
+		( const GLvoid * )( baseOffset + offset ) );
+
+#ifndef CRIMILD_FORCE_OPENGL_COMPATIBILITY_MODE
+	glVertexAttribDivisor( location, divisor );
+#endif
+}
 
+/**
+	\brief Set up pointers for all attributes in the buffer
+
+	Locations are offset by baseLocation. A non-zero divisor makes 
+	attributes advance once per instance instead of once per vertex.
+*/
+static void enableVertexAttributes( const VertexFormat &format, GLuint baseLocation, GLuint divisor )
+{
 	if ( format.hasPositions() ) {
-		glEnableVertexAttribArray( VertexFormat::LayoutLocation::POSITION );
-		glVertexAttribPointer(
-			VertexFormat::LayoutLocation::POSITION,
-			format.getPositionComponents(),
-			GL_FLOAT,
-			GL_FALSE,
-			format.getVertexSizeInBytes(),
-			( const GLvoid * )( baseOffset + format.getPositionsOffset() ) );
+		enableVertexAttribute( baseLocation + VertexFormat::LayoutLocation::POSITION, format.getPositionComponents(), format.getPositionsOffset(), format, divisor );
 	}
 
 	if ( format.hasNormals() ) {
-		glEnableVertexAttribArray( VertexFormat::LayoutLocation::NORMAL );
-		glVertexAttribPointer(
-			VertexFormat::LayoutLocation::NORMAL,
-			format.getNormalComponents(),
-			GL_FLOAT,
-			GL_FALSE,
-			format.getVertexSizeInBytes(),
-			( const GLvoid * )( baseOffset + format.getNormalsOffset() ) );
+		enableVertexAttribute( baseLocation + VertexFormat::LayoutLocation::NORMAL, format.getNormalComponents(), format.getNormalsOffset(), format, divisor );
 	}
 
 	if ( format.hasTangents() ) {
-		glEnableVertexAttribArray( VertexFormat::LayoutLocation::TANGENT );
-		glVertexAttribPointer(
-			VertexFormat::LayoutLocation::TANGENT,
-			format.getTangentComponents(),
-			GL_FLOAT,
-			GL_FALSE,
-			format.getVertexSizeInBytes(),
-			( const GLvoid * )( baseOffset + format.getTangentsOffset() ) );
+		enableVertexAttribute( baseLocation + VertexFormat::LayoutLocation::TANGENT, format.getTangentComponents(), format.getTangentsOffset(), format, divisor );
     }
 
 	if ( format.hasColors() ) {
-		glEnableVertexAttribArray( VertexFormat::LayoutLocation::COLOR );
-		glVertexAttribPointer(
-			VertexFormat::LayoutLocation::COLOR,
-			format.getColorComponents(),
-			GL_FLOAT,
-			GL_FALSE,
-			format.getVertexSizeInBytes(),
-			( const GLvoid * )( baseOffset + format.getColorsOffset() ) );
+		enableVertexAttribute( baseLocation + VertexFormat::LayoutLocation::COLOR, format.getColorComponents(), format.getColorsOffset(), format, divisor );
     }
 
 	if ( format.hasTextureCoords() ) {
-		glEnableVertexAttribArray( VertexFormat::LayoutLocation::TEXTURE_COORD );
-		glVertexAttribPointer(
-			VertexFormat::LayoutLocation::TEXTURE_COORD,
-			format.getTextureCoordComponents(),
-			GL_FLOAT,
-			GL_FALSE,
-			format.getVertexSizeInBytes(),
-			( const GLvoid * )( baseOffset + format.getTextureCoordsOffset() ) );
+		enableVertexAttribute( baseLocation + VertexFormat::LayoutLocation::TEXTURE_COORD, format.getTextureCoordComponents(), format.getTextureCoordsOffset(), format, divisor );
 	}
 
 	if ( format.hasBoneIds() ) {
-		glEnableVertexAttribArray( VertexFormat::LayoutLocation::BONE_ID );
-		glVertexAttribPointer(
-			VertexFormat::LayoutLocation::BONE_ID,
-			format.getBoneIdComponents(),
-			GL_FLOAT,
-			GL_FALSE,
-			format.getVertexSizeInBytes(),
-			( const GLvoid * )( baseOffset + format.getBoneIdsOffset() ) );
+		enableVertexAttribute( baseLocation + VertexFormat::LayoutLocation::BONE_ID, format.getBoneIdComponents(), format.getBoneIdsOffset(), format, divisor );
     }
 
 	if ( format.hasBoneWeights() ) {
-		glEnableVertexAttribArray( VertexFormat::LayoutLocation::BONE_WEIGHT );
-		glVertexAttribPointer(
-			VertexFormat::LayoutLocation::BONE_WEIGHT,
-			format.getBoneWeightComponents(),
-			GL_FLOAT,
-			GL_FALSE,
-			format.getVertexSizeInBytes(),
-			( const GLvoid * )( baseOffset + format.getBoneWeightsOffset() ) );
+		enableVertexAttribute( baseLocation + VertexFormat::LayoutLocation::BONE_WEIGHT, format.getBoneWeightComponents(), format.getBoneWeightsOffset(), format, divisor );
 	}
+}
+
+static void disableVertexAttributes( const VertexFormat &format, GLuint baseLocation )
+{
+	if ( format.hasPositions() ) glDisableVertexAttribArray( baseLocation + VertexFormat::LayoutLocation::POSITION );
+	if ( format.hasNormals() ) glDisableVertexAttribArray( baseLocation + VertexFormat::LayoutLocation::NORMAL );
+	if ( format.hasTangents() ) glDisableVertexAttribArray( baseLocation + VertexFormat::LayoutLocation::TANGENT );
+	if ( format.hasColors() ) glDisableVertexAttribArray( baseLocation + VertexFormat::LayoutLocation::COLOR );
+	if ( format.hasTextureCoords() ) glDisableVertexAttribArray( baseLocation + VertexFormat::LayoutLocation::TEXTURE_COORD );
+	if ( format.hasBoneIds() ) glDisableVertexAttribArray( baseLocation + VertexFormat::LayoutLocation::BONE_ID );
+	if ( format.hasBoneWeights() ) glDisableVertexAttribArray( baseLocation + VertexFormat::LayoutLocation::BONE_WEIGHT );
+}
+
+void VertexBufferObjectCatalog::bind( VertexBufferObject *vbo )
+{
+	if ( vbo == nullptr ) return;
+
+	CRIMILD_CHECK_GL_ERRORS_BEFORE_CURRENT_FUNCTION;
+
+	if ( vbo->getCatalog() == nullptr ) {
+		Catalog< VertexBufferObject >::bind( vbo );
+    }
+
+    glBindBuffer( GL_ARRAY_BUFFER, vbo->getCatalogId() );
+
+	enableVertexAttributes( vbo->getVertexFormat(), 0, 0 );
 
     CRIMILD_CHECK_GL_ERRORS_AFTER_CURRENT_FUNCTION;
 }
@@ -160,15 +146,39 @@ void VertexBufferObjectCatalog::unbind( VertexBufferObject *vbo )
 	
 	CRIMILD_CHECK_GL_ERRORS_BEFORE_CURRENT_FUNCTION;
 
-    const VertexFormat &format = vbo->getVertexFormat();
+	disableVertexAttributes( vbo->getVertexFormat(), 0 );
+
+    glBindBuffer( GL_ARRAY_BUFFER, 0 );
+    
+	Catalog< VertexBufferObject >::unbind( vbo );
+
+    CRIMILD_CHECK_GL_ERRORS_AFTER_CURRENT_FUNCTION;
+}
+
+void VertexBufferObjectCatalog::bindInstances( VertexBufferObject *vbo )
+{
+	if ( vbo == nullptr ) return;
+
+	CRIMILD_CHECK_GL_ERRORS_BEFORE_CURRENT_FUNCTION;
+
+	if ( vbo->getCatalog() == nullptr ) {
+		Catalog< VertexBufferObject >::bind( vbo );
+    }
+
+    glBindBuffer( GL_ARRAY_BUFFER, vbo->getCatalogId() );
 
-	if ( format.hasPositions() ) glDisableVertexAttribArray( VertexFormat::LayoutLocation::POSITION );
-	if ( format.hasNormals() ) glDisableVertexAttribArray( VertexFormat::LayoutLocation::NORMAL );
-	if ( format.hasTangents() ) glDisableVertexAttribArray( VertexFormat::LayoutLocation::TANGENT );
-	if ( format.hasColors() ) glDisableVertexAttribArray( VertexFormat::LayoutLocation::COLOR );
-	if ( format.hasTextureCoords() ) glDisableVertexAttribArray( VertexFormat::LayoutLocation::TEXTURE_COORD );
-	if ( format.hasBoneIds() ) glDisableVertexAttribArray( VertexFormat::LayoutLocation::BONE_ID );
-	if ( format.hasBoneWeights() ) glDisableVertexAttribArray( VertexFormat::LayoutLocation::BONE_WEIGHT );
+	enableVertexAttributes( vbo->getVertexFormat(), VertexFormat::LayoutLocation::INSTANCE_OFFSET, 1 );
+
+    CRIMILD_CHECK_GL_ERRORS_AFTER_CURRENT_FUNCTION;
+}
+
+void VertexBufferObjectCatalog::unbindInstances( VertexBufferObject *vbo )
+{
+	if ( vbo == nullptr ) return;
+	
+	CRIMILD_CHECK_GL_ERRORS_BEFORE_CURRENT_FUNCTION;
+
+	disableVertexAttributes( vbo->getVertexFormat(), VertexFormat::LayoutLocation::INSTANCE_OFFSET );
 
     glBindBuffer( GL_ARRAY_BUFFER, 0 );
     
@@ -187,15 +197,49 @@ void VertexBufferObjectCatalog::load( VertexBufferObject *vbo )
 
 	GLuint vboId = vbo->getCatalogId();
 
+    // upload the whole storage, not just the vertices in use, so
+    // streaming buffers can grow their vertex count in place
     glBindBuffer( GL_ARRAY_BUFFER, vboId );
     glBufferData( GL_ARRAY_BUFFER,
-         vbo->getVertexFormat().getVertexSizeInBytes() * vbo->getVertexCount(),
+         vbo->getCapacityInBytes(),
          vbo->getData(),
-         GL_STATIC_DRAW );
+         vbo->getUsage() == VertexBufferObject::Usage::STREAM ? GL_STREAM_DRAW : GL_STATIC_DRAW );
+
+    _versions[ vboId ] = vbo->getVersion();
 
     CRIMILD_CHECK_GL_ERRORS_AFTER_CURRENT_FUNCTION;
 }
 
+void VertexBufferObjectCatalog::update( VertexBufferObject *vbo )
+{
+	if ( vbo == nullptr || vbo->getCatalog() == nullptr ) return;
+
+	GLuint vboId = vbo->getCatalogId();
+
+	auto &version = _versions[ vboId ];
+	if ( version == vbo->getVersion() ) {
+		// nothing changed since last upload
+		return;
+	}
+
+	CRIMILD_CHECK_GL_ERRORS_BEFORE_CURRENT_FUNCTION;
+
+	// Orphan the previous storage before writing new data. The driver
+	// keeps the old block alive until any pending draw calls using it 
+	// are completed and hands us a fresh one, which works like a ring 
+	// of buffers fenced per frame without stalling the pipeline.
+	glBindBuffer( GL_ARRAY_BUFFER, vboId );
+	glBufferData( GL_ARRAY_BUFFER, vbo->getCapacityInBytes(), nullptr, GL_STREAM_DRAW );
+	if ( vbo->getSizeInBytes() > 0 ) {
+		glBufferSubData( GL_ARRAY_BUFFER, 0, vbo->getSizeInBytes(), vbo->getData() );
+	}
+	glBindBuffer( GL_ARRAY_BUFFER, 0 );
+
+	version = vbo->getVersion();
+
+	CRIMILD_CHECK_GL_ERRORS_AFTER_CURRENT_FUNCTION;
+}
+
 void VertexBufferObjectCatalog::unload( VertexBufferObject *vbo )
 {
 	if ( vbo == nullptr ) return;
@@ -204,6 +248,7 @@ void VertexBufferObjectCatalog::unload( VertexBufferObject *vbo )
     
     if ( vbo->getCatalogId() > 0 ) {
       	_unusedVBOIds.push_back( vbo->getCatalogId() );
+        _versions.erase( vbo->getCatalogId() );
     }
 
     Catalog< VertexBufferObject >::unload( vbo );
@@ -30,6 +30,8 @@
 
 #include <Rendering/Catalog.hpp>
 
+#include <map>
+
 namespace crimild {
     
     class VertexBufferObject;    
@@ -46,13 +48,28 @@ namespace crimild {
 			virtual void bind( VertexBufferObject *vbo ) override;
 			virtual void unbind( VertexBufferObject *vbo ) override;
 
+			/**
+				\brief Binds a buffer with per-instance attributes
+
+				Attributes are bound at VertexFormat::LayoutLocation::INSTANCE_OFFSET
+				plus their standard location, and advance once per instance.
+			*/
+			void bindInstances( VertexBufferObject *vbo );
+			void unbindInstances( VertexBufferObject *vbo );
+
 			virtual void load( VertexBufferObject *vbo ) override;
+            virtual void update( VertexBufferObject *vbo ) override;
             virtual void unload( VertexBufferObject *vbo ) override;
             
             virtual void cleanup( void ) override;
 
         private:
             std::list< int > _unusedVBOIds;
+
+            /**
+                \brief Last uploaded version for each buffer
+             */
+            std::map< int, crimild::UInt32 > _versions;
 		};
 
 	}
@@ -46,6 +46,7 @@
 #include "Programs/ColorTintShaderProgram.hpp"
 #include "Programs/UnlitVertexColorShaderProgram.hpp"
 #include "Programs/ParticleSystemShaderProgram.hpp"
+#include "Programs/InstancedParticleShaderProgram.hpp"
 #include "Programs/DebugDepthShaderProgram.hpp"
 #include "Programs/DepthPassShaderProgram.hpp"
 
@@ -101,6 +102,8 @@ OpenGLRenderer::OpenGLRenderer( SharedPointer< FrameBufferObject > const &screen
 	setShaderProgram( Renderer::SHADER_PROGRAM_POINT_SPRITE, crimild::alloc< ParticleSystemShaderProgram >() );
 
 #ifdef CRIMILD_PLATFORM_DESKTOP
+	// instanced draws are not available in compatibility mode
+	setShaderProgram( Renderer::SHADER_PROGRAM_PARTICLE_INSTANCED, crimild::alloc< InstancedParticleShaderProgram >() );
     setShaderProgram( Renderer::SHADER_PROGRAM_TEXT_SDF, crimild::alloc< SignedDistanceFieldShaderProgram >() );
 #endif
     setShaderProgram( Renderer::SHADER_PROGRAM_TEXT_BASIC, crimild::alloc< TextShaderProgram >() );
@@ -274,12 +277,28 @@ void OpenGLRenderer::drawPrimitive( ShaderProgram *program, Primitive *primitive
 
 	GLenum type = OpenGLUtils::PRIMITIVE_TYPE[ ( uint8_t ) primitive->getType() ];
 
+	auto ibo = primitive->getIndexBuffer();
+	GLenum indexType = ibo->getIndexType() == IndexBufferObject::IndexType::UINT32 ? GL_UNSIGNED_INT : GL_UNSIGNED_SHORT;
+
 	unsigned short *base = 0;
-	glDrawElements( type,
-				   primitive->getIndexBuffer()->getIndexCount(),
-				   GL_UNSIGNED_SHORT,
-				   ( const GLvoid * ) base );
-	
+	if ( primitive->isInstanced() ) {
+#ifndef CRIMILD_FORCE_OPENGL_COMPATIBILITY_MODE
+		const auto instanceCount = primitive->getInstanceCount();
+		if ( instanceCount > 0 ) {
+			glDrawElementsInstanced( type,
+						   ibo->getIndexCount(),
+						   indexType,
+						   ( const GLvoid * ) base,
+						   instanceCount );
+		}
+#endif
+	}
+	else {
+		glDrawElements( type,
+					   ibo->getIndexCount(),
+					   indexType,
+					   ( const GLvoid * ) base );
+	}
 
 	CRIMILD_CHECK_GL_ERRORS_AFTER_CURRENT_FUNCTION;
 }
@@ -0,0 +1,31 @@
+R"(
+
+CRIMILD_GLSL_ATTRIBUTE( 0 ) vec3 aPosition;
+CRIMILD_GLSL_ATTRIBUTE( 4 ) vec2 aTextureCoord;
+
+// per-instance attributes (INSTANCE_OFFSET + standard location)
+CRIMILD_GLSL_ATTRIBUTE( 8 ) vec3 aInstancePosition;
+CRIMILD_GLSL_ATTRIBUTE( 11 ) vec4 aInstanceColor;
+CRIMILD_GLSL_ATTRIBUTE( 12 ) vec2 aInstanceSize;
+
+uniform mat4 uPMatrix; 
+uniform mat4 uVMatrix; 
+uniform mat4 uMMatrix;
+
+CRIMILD_GLSL_VARYING_OUT vec4 vColor;
+CRIMILD_GLSL_VARYING_OUT vec2 vTextureCoord;
+
+void main()
+{
+	vColor = aInstanceColor;
+	vTextureCoord = aTextureCoord;
+
+	// Quads are expanded in view space, so they always face the camera
+	vec4 center = uVMatrix * uMMatrix * vec4( aInstancePosition, 1.0 );
+	vec4 position = center + vec4( aInstanceSize.x * aPosition.xy, 0.0, 0.0 );
+
+	CRIMILD_GLSL_VERTEX_OUTPUT = uPMatrix * position;
+}
+
+)"
+
@@ -42,7 +42,7 @@ MeshCollider::~MeshCollider( void )
 
 SharedPointer< btCollisionShape > MeshCollider::generateShape( void ) 
 {
-    Log::debug( CRIMILD_CURRENT_CLASS_NAME, "Generating shape for mesh collider" );
+    CRIMILD_LOG_DEBUG( "Generating shape for mesh collider" );
 
 	auto mesh = new btTriangleMesh(); // is this a leak?
 
@@ -51,11 +51,10 @@ SharedPointer< btCollisionShape > MeshCollider::generateShape( void )
 			auto ibo = primitive->getIndexBuffer();
 			auto vbo = primitive->getVertexBuffer();
 
-			const unsigned short *indices = static_cast< const unsigned short * >( ibo->getData() );
 			Vector3f vertices[ 3 ];
 			for ( int i = 0; i < ibo->getIndexCount() / 3; i++ ) {
 				for ( int j = 0; j < 3; j++ ) {
-					vertices[ j ] = vbo->getPositionAt( indices[ i * 3 + j ] );
+					vertices[ j ] = vbo->getPositionAt( ibo->getIndexAt( i * 3 + j ) );
 				}
 				mesh->addTriangle( BulletUtils::convert( vertices[ 0 ] ), BulletUtils::convert( vertices[ 1 ] ), BulletUtils::convert( vertices[ 2 ] ) );
 			}
@@ -7,6 +7,7 @@
 #include "Mathematics/Random.hpp"
 #include "Mathematics/Interpolation.hpp"
 
+#include <algorithm>
 #include <iostream>
 #include <sstream>
 #include <string>
@@ -47,21 +48,23 @@ SharedPointer< Image > RTRenderer::render( SharedPointer< Node > const &scene, S
     
     std::atomic< long > jobCount( 0 );
     const int JOB_TOTAL = _height * _width;
+    const long PROGRESS_STEP = std::max( 1, JOB_TOTAL / 100 );
     
 	for ( size_t y = 0; y < _height; y += dy ) {
 		for ( size_t x = 0; x < _width; x += dx ) {
-			crimild::concurrency::async( parentJob, [this, &jobCount, JOB_TOTAL, camera, x, y, dx, dy, bpp, scene, &pixels ]( void ) {
+			crimild::concurrency::async( parentJob, [this, &jobCount, JOB_TOTAL, PROGRESS_STEP, camera, x, y, dx, dy, bpp, scene, &pixels ]( void ) {
 				for ( size_t t = y; t < y + dy; t++ ) {
 					for ( size_t s = x; s < x + dx; s++ ) {
+						Random::Generator rng( _seed, t * _width + s );
 						RGBColorf c = RGBColorf::ZERO;
 						Ray3f ray;
 						if ( _samples > 1 ) {
 							for ( int sample = 0; sample < _samples; sample++ ) {
-								float u = ( float ) ( s + getRandom() ) / ( float ) _width;
-								float v = ( float ) ( t + getRandom() ) / ( float ) _height;
+								float u = ( float ) ( s + getRandom( rng ) ) / ( float ) _width;
+								float v = ( float ) ( t + getRandom( rng ) ) / ( float ) _height;
 								
 								camera->getPickRay( u, v, ray );
-								c += computeColor( scene, ray );							
+								c += computeColor( scene, ray, rng );							
 							}
 							c /= ( float ) _samples;
 						}
@@ -69,7 +72,7 @@ SharedPointer< Image > RTRenderer::render( SharedPointer< Node > const &scene, S
 							float u = ( float ) s / ( float ) _width;
 							float v = ( float ) t / ( float ) _height;
 							camera->getPickRay( u, v, ray );
-							c = computeColor( scene, ray );
+							c = computeColor( scene, ray, rng );
 						}
 						
 						// gamma correction
@@ -79,8 +82,11 @@ SharedPointer< Image > RTRenderer::render( SharedPointer< Node > const &scene, S
 							pixels[ ( t * _width + s ) * bpp + i ] = ( unsigned char )( 255.99f * c[ i ] );
 						}
                         
-                        jobCount++;
-                        Log::debug( CRIMILD_CURRENT_CLASS_NAME, "Progress: ", jobCount, "/", JOB_TOTAL );
+                        // report progress every 1% only, since there's a job per pixel
+                        auto count = ++jobCount;
+                        if ( count % PROGRESS_STEP == 0 ) {
+                            CRIMILD_LOG_DEBUG( "Progress: ", count, "/", JOB_TOTAL );
+                        }
 					}
 				}
 			});
@@ -88,13 +94,13 @@ SharedPointer< Image > RTRenderer::render( SharedPointer< Node > const &scene, S
 	}
 	
 	crimild::concurrency::wait( parentJob );
-    Log::debug( CRIMILD_CURRENT_CLASS_NAME, "Done rendering frames" );
+    CRIMILD_LOG_DEBUG( "Done rendering frames" );
     
     auto result = crimild::alloc< Image >( _width, _height, bpp, &pixels[ 0 ], Image::PixelFormat::RGB );
     return result;
 }
 
-RGBColorf RTRenderer::computeColor( SharedPointer< Node > const &scene, const Ray3f &r, int depth ) const
+RGBColorf RTRenderer::computeColor( SharedPointer< Node > const &scene, const Ray3f &r, Random::Generator &rng, int depth ) const
 {
 	RTRayCaster caster( r );
 	scene->perform( caster );
@@ -109,7 +115,7 @@ RGBColorf RTRenderer::computeColor( SharedPointer< Node > const &scene, const Ra
 		switch ( material->getType() ) {
 		case RTMaterial::Type::METALLIC: {
 			auto reflected = reflect( r.getDirection(), hit.normal );
-			reflected += material->getFuzz() * randomInUnitSphere();
+			reflected += material->getFuzz() * randomInUnitSphere( rng );
 			reflected.normalize();
 			scattered = Ray3f( hit.position, reflected );
 			visible = ( scattered.getDirection() * hit.normal > 0 );
@@ -143,7 +149,7 @@ RGBColorf RTRenderer::computeColor( SharedPointer< Node > const &scene, const Ra
 				reflectProb = 1.0f;
 			}
 			
-			if ( getRandom() < reflectProb ) {
+			if ( getRandom( rng ) < reflectProb ) {
 				scattered = Ray3f( hit.position, reflected );
 			}
 			else {
@@ -153,7 +159,7 @@ RGBColorf RTRenderer::computeColor( SharedPointer< Node > const &scene, const Ra
 		}
 		case RTMaterial::Type::LAMBERTIAN: 
 		default: {
-			Vector3f target = hit.normal + randomInUnitSphere();
+			Vector3f target = hit.normal + randomInUnitSphere( rng );
 			scattered = Ray3f( hit.position, target.getNormalized() );
 			break;
 		}
@@ -161,7 +167,7 @@ RGBColorf RTRenderer::computeColor( SharedPointer< Node > const &scene, const Ra
 
 		// TODO: max depth as a setting?
 		if ( depth < 50 && visible ) {
-			auto color = computeColor( scene, scattered, depth + 1 );
+			auto color = computeColor( scene, scattered, rng, depth + 1 );
 			color.times( attenuation );
 			return color;
 		}
@@ -179,21 +185,17 @@ RGBColorf RTRenderer::computeColor( SharedPointer< Node > const &scene, const Ra
 	return output;
 }
 
-float RTRenderer::getRandom() const
+float RTRenderer::getRandom( Random::Generator &rng ) const
 {
-#if 1
-	return Random::generate< float >();
-#else
-	return drand48();
-#endif
+	return ( float ) rng.generate();
 }
 
-Vector3f RTRenderer::randomInUnitSphere( void ) const
+Vector3f RTRenderer::randomInUnitSphere( Random::Generator &rng ) const
 {
 	return Vector3f(
-		2.0f * getRandom() - 1.0f,
-		2.0f * getRandom() - 1.0f,
-		2.0f * getRandom() -1.0f )
+		2.0f * getRandom( rng ) - 1.0f,
+		2.0f * getRandom( rng ) - 1.0f,
+		2.0f * getRandom( rng ) -1.0f )
 	.getNormalized();
 }
 
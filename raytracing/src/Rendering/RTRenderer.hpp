@@ -4,6 +4,7 @@
 #include "Rendering/Image.hpp"
 #include "Mathematics/Vector.hpp"
 #include "Mathematics/Ray.hpp"
+#include "Mathematics/Random.hpp"
 
 namespace crimild {
     
@@ -22,13 +23,22 @@ namespace crimild {
 			virtual ~RTRenderer( void );
 			
 			SharedPointer< Image > render( SharedPointer< Node > const &scene, SharedPointer< Camera > camera ) const;
+
+			/**
+				\brief Seed for all random samples
+
+				Each pixel uses its own random stream, so the same seed always
+				produces the same image regardless of the number of workers
+			*/
+			void setSeed( crimild::UInt64 seed ) { _seed = seed; }
+			crimild::UInt64 getSeed( void ) const { return _seed; }
 			
 		private:
-			RGBColorf computeColor( SharedPointer< Node > const &scene, const Ray3f &r, int depth = 0 ) const;
+			RGBColorf computeColor( SharedPointer< Node > const &scene, const Ray3f &r, Random::Generator &rng, int depth = 0 ) const;
 			
-			float getRandom() const;
+			float getRandom( Random::Generator &rng ) const;
 			
-			Vector3f randomInUnitSphere( void ) const;
+			Vector3f randomInUnitSphere( Random::Generator &rng ) const;
 			
 			Vector3f reflect( const Vector3f &v, const Vector3f &n ) const;
 			
@@ -41,6 +51,7 @@ namespace crimild {
 			int _width;
 			int _height;
 			int _samples;
+			crimild::UInt64 _seed = 0;
             
             Mutex _mutex;
 		};
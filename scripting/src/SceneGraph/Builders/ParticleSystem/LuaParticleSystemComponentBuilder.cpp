@@ -63,6 +63,37 @@ SharedPointer< ParticleSystemComponent > LuaParticleSystemComponentBuilder::buil
 	if ( eval.getPropValue( "burst", burst ) ) {
 		ps->setBurst( burst );
 	}
+
+	crimild::Bool cullingEnabled = true;
+	if ( eval.getPropValue( "cullingEnabled", cullingEnabled ) ) {
+		ps->setCullingEnabled( cullingEnabled );
+	}
+
+	crimild::Real32 boundsPadding = 1.0f;
+	if ( eval.getPropValue( "boundsPadding", boundsPadding ) ) {
+		ps->setBoundsPadding( boundsPadding );
+	}
+
+	crimild::Real32 maxCatchUpTime = 0.0f;
+	if ( eval.getPropValue( "maxCatchUpTime", maxCatchUpTime ) ) {
+		ps->setMaxCatchUpTime( maxCatchUpTime );
+	}
+
+	crimild::Real32 lodNearDistance = 0.0f;
+	crimild::Real32 lodFarDistance = 0.0f;
+	if ( eval.getPropValue( "lodNearDistance", lodNearDistance ) && eval.getPropValue( "lodFarDistance", lodFarDistance ) ) {
+		ps->setLODDistances( lodNearDistance, lodFarDistance );
+	}
+
+	crimild::Real32 minLODScale = 0.25f;
+	if ( eval.getPropValue( "minLODScale", minLODScale ) ) {
+		ps->setMinLODScale( minLODScale );
+	}
+
+	crimild::Int32 priority = 0;
+	if ( eval.getPropValue( "priority", priority ) ) {
+		ps->setPriority( priority );
+	}
 	
 	eval.foreach( "generators", [ ps ]( ScriptEvaluator &gEval, int ) {
 		std::string type;
@@ -36,6 +36,10 @@ SharedPointer< CameraSortParticleUpdater > LuaCameraSortParticleUpdaterBuilder::
 {
 	auto updater = crimild::alloc< CameraSortParticleUpdater >();
 
+	crimild::Bool incremental = false;
+	eval.getPropValue( "incremental", incremental );
+	updater->setIncremental( incremental );
+
 	return updater;
 }
 
@@ -29,6 +29,7 @@
 #include "SceneGraph/Builders/ParticleSystem/Updaters/LuaColorParticleUpdaterBuilder.hpp"
 #include "SceneGraph/Builders/ParticleSystem/Renderers/LuaPointSpriteParticleRendererBuilder.hpp"
 #include "SceneGraph/Builders/ParticleSystem/Renderers/LuaOrientedQuadParticleRendererBuilder.hpp"
+#include "SceneGraph/Builders/ParticleSystem/Renderers/LuaInstancedQuadParticleRendererBuilder.hpp"
 #include "SceneGraph/Builders/ParticleSystem/Renderers/LuaNodeParticleRendererBuilder.hpp"
 #include "SceneGraph/Builders/ParticleSystem/Renderers/LuaAnimatedSpriteParticleRendererBuilder.hpp"
 
@@ -266,6 +267,7 @@ LuaSceneBuilder::LuaSceneBuilder( std::string rootNodeName )
 
 	CRIMILD_SCRIPTING_REGISTER_CUSTOM_BUILDER( crimild::PointSpriteParticleRenderer, LuaPointSpriteParticleRendererBuilder::build );
 	CRIMILD_SCRIPTING_REGISTER_CUSTOM_BUILDER( crimild::OrientedQuadParticleRenderer, LuaOrientedQuadParticleRendererBuilder::build );
+	CRIMILD_SCRIPTING_REGISTER_CUSTOM_BUILDER( crimild::InstancedQuadParticleRenderer, LuaInstancedQuadParticleRendererBuilder::build );
 	CRIMILD_SCRIPTING_REGISTER_CUSTOM_BUILDER( crimild::NodeParticleRenderer, LuaNodeParticleRendererBuilder::build );
 	CRIMILD_SCRIPTING_REGISTER_CUSTOM_BUILDER( crimild::AnimatedSpriteParticleRenderer, LuaAnimatedSpriteParticleRendererBuilder::build );
 
@@ -0,0 +1,129 @@
+/*
+ * Copyright (c) 2013, Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "Benchmark.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+using namespace crimild;
+using namespace crimild::benchmark;
+
+BenchmarkRegistry &BenchmarkRegistry::getInstance( void )
+{
+	static BenchmarkRegistry instance;
+	return instance;
+}
+
+bool BenchmarkRegistry::add( std::string name, BenchmarkCallback const &callback )
+{
+	_benchmarks[ name ] = callback;
+	return true;
+}
+
+bool BenchmarkRegistry::run( std::string name )
+{
+	auto it = _benchmarks.find( name );
+	if ( it == _benchmarks.end() ) {
+		return false;
+	}
+
+	std::cout << "== " << name << std::endl;
+	it->second();
+	std::cout << std::endl;
+	return true;
+}
+
+void BenchmarkRegistry::runAll( void )
+{
+	for ( auto &it : _benchmarks ) {
+		run( it.first );
+	}
+}
+
+void BenchmarkRegistry::each( std::function< void( std::string const & ) > const &callback ) const
+{
+	for ( auto &it : _benchmarks ) {
+		callback( it.first );
+	}
+}
+
+void crimild::benchmark::report( std::string benchmark, std::string test, std::string value )
+{
+	std::cout << std::left << std::setw( 24 ) << benchmark << std::setw( 40 ) << test << value << std::endl;
+}
+
+std::string crimild::benchmark::formatMilliseconds( crimild::Real64 seconds )
+{
+	std::stringstream ss;
+	ss.precision( 3 );
+	ss << std::fixed << seconds * 1000.0 << " ms";
+	return ss.str();
+}
+
+std::string crimild::benchmark::getTempPath( std::string fileName )
+{
+	const char *tmp = std::getenv( "TMPDIR" );
+	std::string dir = tmp != nullptr ? tmp : "/tmp";
+	return dir + "/" + fileName;
+}
+
+crimild::Size crimild::benchmark::generateOBJ( std::string fileName, crimild::UInt32 size )
+{
+	FILE *out = fopen( fileName.c_str(), "w" );
+	if ( out == nullptr ) {
+		return 0;
+	}
+
+	fprintf( out, "o grid\n" );
+	for ( crimild::UInt32 y = 0; y <= size; y++ ) {
+		for ( crimild::UInt32 x = 0; x <= size; x++ ) {
+			fprintf( out, "v %.6f %.6f %.6f\n", ( float ) x / size, 0.01f * ( ( x * 7 + y * 13 ) % 17 ), ( float ) y / size );
+		}
+	}
+	for ( crimild::UInt32 y = 0; y <= size; y++ ) {
+		for ( crimild::UInt32 x = 0; x <= size; x++ ) {
+			fprintf( out, "vt %.6f %.6f\n", ( float ) x / size, ( float ) y / size );
+		}
+	}
+	fprintf( out, "vn 0.000000 1.000000 0.000000\n" );
+	for ( crimild::UInt32 y = 0; y < size; y++ ) {
+		for ( crimild::UInt32 x = 0; x < size; x++ ) {
+			auto v = y * ( size + 1 ) + x + 1;
+			fprintf( out, "f %u/%u/1 %u/%u/1 %u/%u/1\n", v, v, v + 1, v + 1, v + size + 1, v + size + 1 );
+			fprintf( out, "f %u/%u/1 %u/%u/1 %u/%u/1\n", v + 1, v + 1, v + size + 2, v + size + 2, v + size + 1, v + size + 1 );
+		}
+	}
+
+	auto bytes = ftell( out );
+	fclose( out );
+	return bytes;
+}
+
@@ -0,0 +1,123 @@
+/*
+ * Copyright (c) 2013, Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef CRIMILD_TOOLS_BENCHMARK_
+#define CRIMILD_TOOLS_BENCHMARK_
+
+#include <Foundation/Types.hpp>
+
+#include <chrono>
+#include <functional>
+#include <map>
+#include <string>
+
+namespace crimild {
+
+	namespace benchmark {
+
+		using BenchmarkCallback = std::function< void( void ) >;
+
+		/**
+			\brief Keeps track of all available benchmarks
+
+			Benchmarks are registered at startup using CRIMILD_REGISTER_BENCHMARK
+		*/
+		class BenchmarkRegistry {
+		public:
+			static BenchmarkRegistry &getInstance( void );
+
+			bool add( std::string name, BenchmarkCallback const &callback );
+
+			bool run( std::string name );
+
+			void runAll( void );
+
+			void each( std::function< void( std::string const & ) > const &callback ) const;
+
+		private:
+			std::map< std::string, BenchmarkCallback > _benchmarks;
+		};
+
+		/**
+			\brief Executes a function and returns the elapsed time in seconds
+		*/
+		template< typename Fn >
+		crimild::Real64 measure( Fn fn )
+		{
+			auto start = std::chrono::high_resolution_clock::now();
+			fn();
+			auto end = std::chrono::high_resolution_clock::now();
+			return std::chrono::duration< crimild::Real64 >( end - start ).count();
+		}
+
+		/**
+			\brief Best time in seconds over several runs
+		*/
+		template< typename Fn >
+		crimild::Real64 measureBest( crimild::Size runs, Fn fn )
+		{
+			crimild::Real64 best = -1.0;
+			for ( crimild::Size i = 0; i < runs; i++ ) {
+				auto t = measure( fn );
+				if ( best < 0.0 || t < best ) {
+					best = t;
+				}
+			}
+			return best;
+		}
+
+		/**
+			\brief Prints a row of results in a consistent format
+		*/
+		void report( std::string benchmark, std::string test, std::string value );
+
+		/**
+			\brief Formats a time in seconds as milliseconds
+		*/
+		std::string formatMilliseconds( crimild::Real64 seconds );
+
+		/**
+			\brief Temporary directory for generated files
+		*/
+		std::string getTempPath( std::string fileName );
+
+		/**
+			\brief Writes an OBJ grid with positions, texture coordinates, normals and faces
+
+			Returns the size of the file in bytes
+		*/
+		crimild::Size generateOBJ( std::string fileName, crimild::UInt32 size );
+
+	}
+
+}
+
+#define CRIMILD_REGISTER_BENCHMARK( NAME, CALLBACK ) \
+	static bool __crimild_benchmark_##NAME = crimild::benchmark::BenchmarkRegistry::getInstance().add( #NAME, CALLBACK )
+
+#endif
+
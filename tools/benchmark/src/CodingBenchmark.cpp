@@ -0,0 +1,334 @@
+/*
+ * Copyright (c) 2013, Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "Benchmark.hpp"
+
+#include <Crimild.hpp>
+#include <Coding/MemoryEncoder.hpp>
+#include <Coding/MemoryDecoder.hpp>
+#include <Coding/BinaryEncoder.hpp>
+#include <Coding/BinaryDecoder.hpp>
+#include <Coding/BinaryFileEncoder.hpp>
+#include <Coding/BinaryFileDecoder.hpp>
+#include <Concurrency/JobScheduler.hpp>
+#include <Foundation/StringUtils.hpp>
+
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <thread>
+
+using namespace crimild;
+using namespace crimild::benchmark;
+
+namespace crimild {
+
+	namespace benchmark {
+
+		/**
+			\brief A few large meshes sharing a single material
+		*/
+		static SharedPointer< Group > buildMeshScene( crimild::Size count )
+		{
+			auto scene = crimild::alloc< Group >( "meshes" );
+			auto material = crimild::alloc< Material >();
+			for ( crimild::Size i = 0; i < count; i++ ) {
+				auto geometry = crimild::alloc< Geometry >( "sphere" );
+				geometry->attachPrimitive( crimild::alloc< SpherePrimitive >( 1.0f, VertexFormat::VF_P3_N3_UV2, Vector2i( 100, 100 ) ) );
+				geometry->getComponent< MaterialComponent >()->attachMaterial( material );
+				geometry->local().setTranslate( i, 0, 0 );
+				scene->attachNode( geometry );
+			}
+			return scene;
+		}
+
+		/**
+			\brief Lots of small nodes with no geometry at all
+		*/
+		static SharedPointer< Group > buildNodeScene( void )
+		{
+			auto scene = crimild::alloc< Group >( "nodes" );
+			for ( int i = 0; i < 100; i++ ) {
+				auto group = crimild::alloc< Group >( "group_" + StringUtils::toString( i ) );
+				for ( int j = 0; j < 100; j++ ) {
+					auto child = crimild::alloc< Group >( "child_" + StringUtils::toString( j ) );
+					child->local().setTranslate( i, j, 0 );
+					group->attachNode( child );
+				}
+				scene->attachNode( group );
+			}
+			return scene;
+		}
+
+		template< class ENCODER, class DECODER >
+		static void runCodingTest( std::string name, SharedPointer< Group > const &scene, crimild::Size runs )
+		{
+			containers::ByteArray bytes;
+
+			auto encode = measureBest( runs, [ scene, &bytes ] {
+				auto encoder = crimild::alloc< ENCODER >();
+				encoder->encode( scene );
+				bytes = encoder->getBytes();
+			});
+
+			auto decode = measureBest( runs, [ &bytes ] {
+				auto decoder = crimild::alloc< DECODER >();
+				decoder->fromBytes( bytes );
+			});
+
+			report( "coding", "  " + name + " size", StringUtils::toString( bytes.size() / 1024 ) + " KB" );
+			report( "coding", "  " + name + " encode", formatMilliseconds( encode ) );
+			report( "coding", "  " + name + " decode", formatMilliseconds( decode ) );
+		}
+
+		/**
+			\brief Compares MemoryEncoder/MemoryDecoder against the binary format
+		*/
+		static void runCodingBenchmark( void )
+		{
+			const crimild::Size RUNS = 5;
+
+			crimild::init();
+
+			report( "coding", "16 spheres, 10k vertices each", "" );
+			auto meshes = buildMeshScene( 16 );
+			runCodingTest< coding::MemoryEncoder, coding::MemoryDecoder >( "memory", meshes, RUNS );
+			runCodingTest< coding::BinaryEncoder, coding::BinaryDecoder >( "binary", meshes, RUNS );
+
+			report( "coding", "10k nodes", "" );
+			auto nodes = buildNodeScene();
+			runCodingTest< coding::MemoryEncoder, coding::MemoryDecoder >( "memory", nodes, RUNS );
+			runCodingTest< coding::BinaryEncoder, coding::BinaryDecoder >( "binary", nodes, RUNS );
+		}
+
+		/**
+			\brief Runs a function in a separate process
+
+			Peak memory is only meaningful for the process as a whole, so
+			each test runs in a fresh child process.
+
+			\param fn Returns the time to report, in seconds
+			\param peakKB Peak resident set size for the child process
+		*/
+		static bool runIsolated( std::function< crimild::Real64( void ) > const &fn, crimild::Real64 &seconds, crimild::Size &peakKB )
+		{
+			int fds[ 2 ];
+			if ( pipe( fds ) != 0 ) {
+				return false;
+			}
+
+			auto pid = fork();
+			if ( pid < 0 ) {
+				close( fds[ 0 ] );
+				close( fds[ 1 ] );
+				return false;
+			}
+
+			if ( pid == 0 ) {
+				close( fds[ 0 ] );
+				auto t = fn();
+				auto written = write( fds[ 1 ], &t, sizeof( t ) );
+				close( fds[ 1 ] );
+				_exit( written == sizeof( t ) ? 0 : 1 );
+			}
+
+			close( fds[ 1 ] );
+			auto success = read( fds[ 0 ], &seconds, sizeof( seconds ) ) == sizeof( seconds );
+			close( fds[ 0 ] );
+
+			int status = 0;
+			struct rusage usage;
+			if ( wait4( pid, &status, 0, &usage ) != pid ) {
+				return false;
+			}
+
+#ifdef __APPLE__
+			// reported in bytes
+			peakKB = usage.ru_maxrss / 1024;
+#else
+			peakKB = usage.ru_maxrss;
+#endif
+
+			return success && WIFEXITED( status ) && WEXITSTATUS( status ) == 0;
+		}
+
+		static void reportIsolated( std::string name, std::function< crimild::Real64( void ) > const &fn )
+		{
+			crimild::Real64 seconds = 0;
+			crimild::Size peakKB = 0;
+			if ( !runIsolated( fn, seconds, peakKB ) ) {
+				report( "coding_files", name, "failed" );
+				return;
+			}
+
+			report( "coding_files", name, formatMilliseconds( seconds ) + ", peak RSS " + StringUtils::toString( peakKB / 1024 ) + " MB" );
+		}
+
+		/**
+			\brief Compares decoding scene files with FileDecoder and BinaryFileDecoder
+
+			Each file contains several independent roots. For the time
+			to first root, the binary file is opened and only the first
+			root is decoded, while the other decoders have to read the 
+			whole file before any root is usable
+		*/
+		static void runCodingFilesBenchmark( void )
+		{
+			const crimild::Size ROOTS = 32;
+
+			crimild::init();
+
+			auto memoryFileName = getTempPath( "crimild_benchmark_coding.memory" );
+			auto binaryFileName = getTempPath( "crimild_benchmark_coding.binary" );
+
+			// Files are written by a child process as well, so memory used
+			// for building scenes doesn't affect the measurements below
+			crimild::Real64 written = 0;
+			crimild::Size peakKB = 0;
+			auto success = runIsolated( [ memoryFileName, binaryFileName ] {
+				auto memoryEncoder = crimild::alloc< coding::FileEncoder >();
+				auto binaryEncoder = crimild::alloc< coding::BinaryFileEncoder >();
+				for ( crimild::Size i = 0; i < ROOTS; i++ ) {
+					auto scene = buildMeshScene( 4 );
+					memoryEncoder->encode( scene );
+					binaryEncoder->encode( scene );
+				}
+				return memoryEncoder->write( memoryFileName ) && binaryEncoder->write( binaryFileName ) ? 1.0 : 0.0;
+			}, written, peakKB );
+
+			if ( !success || written == 0.0 ) {
+				report( "coding_files", "cannot write files", "" );
+				return;
+			}
+
+			struct stat info;
+			stat( memoryFileName.c_str(), &info );
+			report( "coding_files", StringUtils::toString( ROOTS ) + " roots, memory format", StringUtils::toString( info.st_size / ( 1024 * 1024 ) ) + " MB" );
+			stat( binaryFileName.c_str(), &info );
+			report( "coding_files", StringUtils::toString( ROOTS ) + " roots, binary format", StringUtils::toString( info.st_size / ( 1024 * 1024 ) ) + " MB" );
+
+			reportIsolated( "  baseline", [] {
+				return 0.0;
+			});
+
+			reportIsolated( "  memory, all roots", [ memoryFileName ] {
+				return measure( [ memoryFileName ] {
+					coding::FileDecoder decoder;
+					decoder.read( memoryFileName );
+				});
+			});
+
+			reportIsolated( "  binary, all roots", [ binaryFileName ] {
+				return measure( [ binaryFileName ] {
+					coding::BinaryFileDecoder decoder;
+					decoder.read( binaryFileName );
+				});
+			});
+
+			reportIsolated( "  memory, first root", [ memoryFileName ] {
+				return measure( [ memoryFileName ] {
+					coding::FileDecoder decoder;
+					decoder.read( memoryFileName );
+					decoder.getObjectAt< Group >( 0 );
+				});
+			});
+
+			reportIsolated( "  binary, first root", [ binaryFileName ] {
+				return measure( [ binaryFileName ] {
+					coding::BinaryFileDecoder decoder;
+					decoder.open( binaryFileName );
+					decoder.decodeRootAt< Group >( 0 );
+				});
+			});
+
+			std::remove( memoryFileName.c_str() );
+			std::remove( binaryFileName.c_str() );
+		}
+
+		/**
+			\brief Decoding with MemoryDecoder using an increasing number of workers
+		*/
+		static void runParallelDecodingBenchmark( void )
+		{
+			const crimild::Size RUNS = 5;
+
+			crimild::init();
+
+			containers::ByteArray bytes;
+			{
+				auto scene = crimild::alloc< Group >( "scene" );
+				for ( crimild::Size i = 0; i < 16; i++ ) {
+					scene->attachNode( buildMeshScene( 4 ) );
+				}
+				auto encoder = crimild::alloc< coding::MemoryEncoder >();
+				encoder->encode( scene );
+				bytes = encoder->getBytes();
+			}
+
+			report( "coding_parallel", "64 spheres, " + StringUtils::toString( bytes.size() / ( 1024 * 1024 ) ) + " MB", "" );
+
+			auto serial = measureBest( RUNS, [ &bytes ] {
+				auto decoder = crimild::alloc< coding::MemoryDecoder >();
+				decoder->fromBytes( bytes );
+			});
+			report( "coding_parallel", "  serial", formatMilliseconds( serial ) );
+
+			// the main thread also executes jobs while waiting
+			const crimild::Int32 maxWorkers = Numeric< crimild::Int32 >::max( 2, std::thread::hardware_concurrency() );
+			for ( crimild::Int32 workers = 1; workers <= maxWorkers; workers++ ) {
+				concurrency::JobScheduler scheduler;
+				scheduler.configure( workers - 1 );
+				scheduler.start();
+
+				auto parallel = measureBest( RUNS, [ &bytes ] {
+					auto decoder = crimild::alloc< coding::MemoryDecoder >();
+					decoder->setParallelDecodingEnabled( true );
+					decoder->fromBytes( bytes );
+				});
+
+				scheduler.stop();
+
+				report( 
+					"coding_parallel", 
+					"  parallel, " + StringUtils::toString( workers ) + " thread(s)", 
+					formatMilliseconds( parallel ) + " (" + StringUtils::toString( serial / parallel ) + "x)" 
+				);
+			}
+		}
+
+	}
+
+}
+
+CRIMILD_REGISTER_BENCHMARK( coding, runCodingBenchmark );
+CRIMILD_REGISTER_BENCHMARK( coding_parallel, runParallelDecodingBenchmark );
+CRIMILD_REGISTER_BENCHMARK( coding_files, runCodingFilesBenchmark );
+
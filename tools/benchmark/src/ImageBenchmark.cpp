@@ -0,0 +1,172 @@
+/*
+ * Copyright (c) 2013, Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "Benchmark.hpp"
+
+#include <Rendering/ImageLoader.hpp>
+#include <Rendering/ImagePNG.hpp>
+#include <Rendering/ImageTGA.hpp>
+#include <Rendering/ImageUtils.hpp>
+#include <Concurrency/JobScheduler.hpp>
+#include <Foundation/StringUtils.hpp>
+
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+using namespace crimild;
+using namespace crimild::benchmark;
+
+namespace crimild {
+
+	namespace benchmark {
+
+		/**
+			\brief Creates an RGBA image with gradients and some noise
+
+			Pure gradients compress too well to be representative of real textures
+		*/
+		static SharedPointer< ImagePNG > generateImage( crimild::Size size )
+		{
+			std::vector< crimild::Byte > data( size * size * 4 );
+			crimild::UInt32 seed = 12345;
+			for ( crimild::Size y = 0; y < size; y++ ) {
+				for ( crimild::Size x = 0; x < size; x++ ) {
+					seed = seed * 1664525u + 1013904223u;
+					auto noise = ( seed >> 24 ) & 0x0F;
+					auto p = &data[ ( y * size + x ) * 4 ];
+					p[ 0 ] = static_cast< crimild::Byte >( ( x * 255 / size ) + noise );
+					p[ 1 ] = static_cast< crimild::Byte >( ( y * 255 / size ) + noise );
+					p[ 2 ] = static_cast< crimild::Byte >( ( ( x ^ y ) & 0xFF ) );
+					p[ 3 ] = 255;
+				}
+			}
+
+			auto image = crimild::alloc< ImagePNG >();
+			image->setData( size, size, 4, &data[ 0 ], Image::PixelFormat::RGBA );
+			return image;
+		}
+
+		static void swapRedBlueScalar( crimild::Byte *data, crimild::Size pixelCount, crimild::Size bpp )
+		{
+			for ( crimild::Size i = 0; i < pixelCount * bpp; i += bpp ) {
+				auto temp = data[ i ];
+				data[ i ] = data[ i + 2 ];
+				data[ i + 2 ] = temp;
+			}
+		}
+
+		/**
+			\brief Measures decoding and mipmap generation for 4K textures
+
+			The "pipeline" test decodes several textures and generates their
+			mipmaps in parallel, which is what the asset loaders do.
+		*/
+		static void runImageBenchmark( void )
+		{
+			const crimild::Size SIZE = 4096;
+			const crimild::Size RUNS = 3;
+			const crimild::Size TEXTURE_COUNT = 4;
+
+			auto source = generateImage( SIZE );
+
+			auto tgaFileName = getTempPath( "crimild_benchmark_image.tga" );
+			auto pngFileName = getTempPath( "crimild_benchmark_image.png" );
+
+			auto tga = crimild::alloc< ImageTGA >();
+			tga->setData( SIZE, SIZE, 4, source->getData(), Image::PixelFormat::RGBA );
+			tga->saveToFile( tgaFileName );
+
+			auto encode = measure( [ source, pngFileName ] {
+				source->saveToFile( pngFileName );
+			});
+
+			report( "images", "4096x4096 RGBA", "" );
+			report( "images", "  encode PNG", formatMilliseconds( encode ) );
+
+			auto tgaDecode = measureBest( RUNS, [ tgaFileName ] {
+				ImageTGA image( tgaFileName );
+			});
+			report( "images", "  decode TGA", formatMilliseconds( tgaDecode ) );
+
+			auto pngDecode = measureBest( RUNS, [ pngFileName ] {
+				ImagePNG image( pngFileName );
+			});
+			report( "images", "  decode PNG", formatMilliseconds( pngDecode ) );
+
+			std::vector< crimild::Byte > pixels( source->getData(), source->getData() + SIZE * SIZE * 4 );
+			auto scalarSwizzle = measureBest( RUNS, [ &pixels ] {
+				swapRedBlueScalar( &pixels[ 0 ], SIZE * SIZE, 4 );
+			});
+			report( "images", "  swap red/blue (scalar)", formatMilliseconds( scalarSwizzle ) );
+
+			auto simdSwizzle = measureBest( RUNS, [ &pixels ] {
+				ImageUtils::swapRedBlue( &pixels[ 0 ], SIZE * SIZE, 4 );
+			});
+			report( "images", "  swap red/blue", formatMilliseconds( simdSwizzle ) );
+
+			auto runMipmaps = [ source ]( ImageUtils::MipmapFilter filter ) {
+				return measureBest( RUNS, [ source, filter ] {
+					ImageUtils::generateMipmaps( crimild::get_ptr( source ), filter );
+				});
+			};
+
+			report( "images", "  mipmaps (box)", formatMilliseconds( runMipmaps( ImageUtils::MipmapFilter::BOX ) ) );
+			report( "images", "  mipmaps (kaiser)", formatMilliseconds( runMipmaps( ImageUtils::MipmapFilter::KAISER ) ) );
+
+			std::vector< std::string > paths;
+			for ( crimild::Size i = 0; i < TEXTURE_COUNT; i++ ) {
+				paths.push_back( i % 2 == 0 ? pngFileName : tgaFileName );
+			}
+
+			auto serial = measure( [ paths ] {
+				ImageLoader::loadAll( paths );
+			});
+			report( "images", "  pipeline x" + StringUtils::toString( TEXTURE_COUNT ) + " (serial)", formatMilliseconds( serial ) );
+
+			concurrency::JobScheduler scheduler;
+			scheduler.configure( Numeric< crimild::Int32 >::max( 1, std::thread::hardware_concurrency() - 1 ) );
+			scheduler.start();
+
+			auto parallel = measure( [ paths ] {
+				ImageLoader::loadAll( paths );
+			});
+			report( "images", "  pipeline x" + StringUtils::toString( TEXTURE_COUNT ) + " (parallel)", formatMilliseconds( parallel ) );
+
+			scheduler.stop();
+
+			std::remove( tgaFileName.c_str() );
+			std::remove( pngFileName.c_str() );
+		}
+
+	}
+
+}
+
+CRIMILD_REGISTER_BENCHMARK( images, runImageBenchmark );
+
@@ -0,0 +1,156 @@
+/*
+ * Copyright (c) 2013, Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "Benchmark.hpp"
+
+#include <Foundation/Log.hpp>
+#include <Foundation/StringUtils.hpp>
+
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+using namespace crimild;
+using namespace crimild::benchmark;
+
+namespace crimild {
+
+	namespace benchmark {
+
+		static crimild::Real64 logFromThreads( crimild::Size threadCount, crimild::Size lineCount )
+		{
+			return measure( [ threadCount, lineCount ] {
+				std::vector< std::thread > threads;
+				for ( crimild::Size t = 0; t < threadCount; t++ ) {
+					threads.push_back( std::thread( [ lineCount ] {
+						for ( crimild::Size i = 0; i < lineCount; i++ ) {
+							Log::info( "LogBenchmark", "Progress: ", i, "/", lineCount, " (", 0.5f * i, ")" );
+						}
+					}));
+				}
+				for ( auto &t : threads ) {
+					t.join();
+				}
+			});
+		}
+
+		static std::string formatThroughput( crimild::Size lines, crimild::Real64 seconds )
+		{
+			return StringUtils::toString( ( crimild::Size )( lines / seconds / 1000.0 ), "k lines/s (", formatMilliseconds( seconds ), ")" );
+		}
+
+		static std::string formatNanoseconds( crimild::Real64 seconds, crimild::Size count )
+		{
+			return StringUtils::toString( seconds * 1.0e9 / count, " ns/call" );
+		}
+
+		/**
+			\brief Measures logging throughput to a file and the cost of disabled calls
+
+			Async times only include the time spent by the logging threads. The 
+			time needed to write all pending lines is reported separately.
+		*/
+		static void runLogBenchmark( void )
+		{
+			const crimild::Size LINES = 200000;
+			const crimild::Size THREADS = 4;
+			const crimild::Size CALLS = 10000000;
+
+			auto fileName = getTempPath( "crimild_benchmark_log.txt" );
+			auto level = Log::getLevel();
+			Log::setLevel( Log::LOG_LEVEL_DEBUG );
+			Log::setOutputHandler< Log::FileOutputHandler >( fileName );
+
+			auto sync = logFromThreads( 1, LINES );
+			auto syncThreads = logFromThreads( THREADS, LINES / THREADS );
+
+			Log::setAsyncEnabled( true );
+			auto async = logFromThreads( 1, LINES );
+			auto asyncFlush = measure( [] { Log::flush(); } );
+			auto asyncThreads = logFromThreads( THREADS, LINES / THREADS );
+			Log::flush();
+			Log::setAsyncEnabled( false );
+
+			report( "log", StringUtils::toString( LINES, " lines to file" ), "" );
+			report( "log", "  sync", formatThroughput( LINES, sync ) );
+			report( "log", StringUtils::toString( "  sync x", THREADS, " threads" ), formatThroughput( LINES, syncThreads ) );
+			report( "log", "  async", formatThroughput( LINES, async ) );
+			report( "log", "  async (pending writes)", formatMilliseconds( asyncFlush ) );
+			report( "log", StringUtils::toString( "  async x", THREADS, " threads" ), formatThroughput( LINES, asyncThreads ) );
+
+			// Disabled call sites. Results are accumulated so the loops are not optimized away
+			Log::setLevel( Log::LOG_LEVEL_INFO );
+			volatile crimild::Size sink = 0;
+
+			auto baseline = measure( [ &sink, CALLS ] {
+				for ( crimild::Size i = 0; i < CALLS; i++ ) {
+					sink = sink + i;
+				}
+			});
+
+			auto runtimeFunction = measure( [ &sink, CALLS ] {
+				for ( crimild::Size i = 0; i < CALLS; i++ ) {
+					Log::debug( "LogBenchmark", "Progress: ", i, "/", CALLS );
+					sink = sink + i;
+				}
+			});
+
+			auto runtimeMacro = measure( [ &sink, CALLS ] {
+				for ( crimild::Size i = 0; i < CALLS; i++ ) {
+					CRIMILD_LOG_DEBUG( "Progress: ", i, "/", CALLS );
+					sink = sink + i;
+				}
+			});
+
+			// Strip debug calls at compile time for the rest of this file
+#undef CRIMILD_LOG_LEVEL
+#define CRIMILD_LOG_LEVEL CRIMILD_LOG_LEVEL_INFO
+
+			auto stripped = measure( [ &sink, CALLS ] {
+				for ( crimild::Size i = 0; i < CALLS; i++ ) {
+					CRIMILD_LOG_DEBUG( "Progress: ", i, "/", CALLS );
+					sink = sink + i;
+				}
+			});
+
+			report( "log", StringUtils::toString( CALLS, " disabled calls" ), "" );
+			report( "log", "  baseline loop", formatNanoseconds( baseline, CALLS ) );
+			report( "log", "  Log::debug (runtime level)", formatNanoseconds( runtimeFunction, CALLS ) );
+			report( "log", "  CRIMILD_LOG_DEBUG (runtime level)", formatNanoseconds( runtimeMacro, CALLS ) );
+			report( "log", "  CRIMILD_LOG_DEBUG (stripped)", formatNanoseconds( stripped, CALLS ) );
+
+			Log::setLevel( level );
+			Log::setOutputHandler< Log::ConsoleOutputHandler >();
+			std::remove( fileName.c_str() );
+		}
+
+	}
+
+}
+
+CRIMILD_REGISTER_BENCHMARK( log, runLogBenchmark );
+
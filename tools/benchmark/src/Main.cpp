@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) 2013, Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "Benchmark.hpp"
+
+#include <iostream>
+
+using namespace crimild::benchmark;
+
+/**
+	Usage:
+		benchmark				Runs all benchmarks
+		benchmark --list		Lists available benchmarks
+		benchmark NAME...		Runs only the given benchmarks
+*/
+int main( int argc, char **argv )
+{
+	auto &registry = BenchmarkRegistry::getInstance();
+
+	if ( argc == 1 ) {
+		registry.runAll();
+		return 0;
+	}
+
+	if ( std::string( argv[ 1 ] ) == "--list" ) {
+		registry.each( []( std::string const &name ) {
+			std::cout << name << std::endl;
+		});
+		return 0;
+	}
+
+	int result = 0;
+	for ( int i = 1; i < argc; i++ ) {
+		if ( !registry.run( argv[ i ] ) ) {
+			std::cerr << "Unknown benchmark: " << argv[ i ] << std::endl;
+			result = 1;
+		}
+	}
+
+	return result;
+}
+
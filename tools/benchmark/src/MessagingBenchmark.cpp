@@ -0,0 +1,263 @@
+/*
+ * Copyright (c) 2013, Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "Benchmark.hpp"
+
+#include <Messaging/MessageQueue.hpp>
+#include <Foundation/StringUtils.hpp>
+
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace crimild;
+using namespace crimild::benchmark;
+
+namespace crimild {
+
+	namespace benchmark {
+
+		struct BenchmarkMessage {
+			crimild::Int32 value;
+		};
+
+		class BenchmarkMessenger : public Messenger {
+		public:
+			BenchmarkMessenger( void )
+			{
+				CRIMILD_BIND_MEMBER_MESSAGE_HANDLER( BenchmarkMessage, BenchmarkMessenger, onMessage );
+			}
+
+			crimild::Int64 accum = 0;
+
+		private:
+			void onMessage( BenchmarkMessage const &message )
+			{
+				accum += message.value;
+			}
+		};
+
+		/**
+			\brief Broadcasts by copying the handler map under a lock
+
+			Replicates how MessageQueue used to dispatch messages so the results
+			can be compared
+		*/
+		class BenchmarkMapDispatcher {
+		public:
+			void registerHandler( Messenger *target, MessageHandler< BenchmarkMessage > handler )
+			{
+				std::lock_guard< std::mutex > lock( _mutex );
+				_handlers[ target ] = handler;
+			}
+
+			void broadcastMessage( BenchmarkMessage const &message )
+			{
+				std::map< Messenger *, MessageHandler< BenchmarkMessage >> hs;
+				{
+					std::lock_guard< std::mutex > lock( _mutex );
+					hs = _handlers;
+				}
+
+				for ( auto it : hs ) {
+					if ( it.first != nullptr && it.second != nullptr ) {
+						it.second( message );
+					}
+				}
+			}
+
+		private:
+			std::map< Messenger *, MessageHandler< BenchmarkMessage >> _handlers;
+			std::mutex _mutex;
+		};
+
+		/**
+			\brief Deferred messages as they used to be stored: a vector guarded by a mutex
+		*/
+		class BenchmarkLockedQueue {
+		public:
+			void pushMessage( BenchmarkMessage const &message )
+			{
+				std::lock_guard< std::mutex > lock( _mutex );
+				_messages.push_back( message );
+			}
+
+			void dispatch( void )
+			{
+				std::vector< BenchmarkMessage > ms;
+				{
+					std::lock_guard< std::mutex > lock( _mutex );
+					std::swap( _messages, ms );
+				}
+
+				for ( auto &m : ms ) {
+					MessageQueue::getInstance()->broadcastMessage( m );
+				}
+			}
+
+		private:
+			std::vector< BenchmarkMessage > _messages;
+			std::mutex _mutex;
+		};
+
+		/**
+			\brief Pushes messages from several threads while the main one dispatches them
+		*/
+		template< typename PushFn, typename DispatchFn >
+		crimild::Real64 runProducers( crimild::Size producers, crimild::Size count, PushFn push, DispatchFn dispatch )
+		{
+			return measure( [ producers, count, &push, &dispatch ] {
+				std::atomic< crimild::Size > done( 0 );
+				std::vector< std::thread > threads;
+				for ( crimild::Size p = 0; p < producers; p++ ) {
+					threads.push_back( std::thread( [ count, &push, &done ] {
+						for ( crimild::Size i = 0; i < count; i++ ) {
+							push();
+							if ( i % 1000 == 0 ) {
+								// simulate some work between bursts of messages
+								std::this_thread::yield();
+							}
+						}
+						done++;
+					}));
+				}
+				while ( done < producers ) {
+					dispatch();
+					std::this_thread::yield();
+				}
+				for ( auto &t : threads ) {
+					t.join();
+				}
+				dispatch();
+			});
+		}
+
+		static std::string formatBroadcasts( crimild::Size count, crimild::Real64 seconds, crimild::Size handlers )
+		{
+			return StringUtils::toString( 
+				( crimild::Size )( count / seconds ), " broadcasts/s, ", 
+				1.0e9 * seconds / ( count * handlers ), " ns/handler (", 
+				formatMilliseconds( seconds ), ")" 
+			);
+		}
+
+		static void runMessagingBenchmark( void )
+		{
+			const crimild::Size HANDLERS = 1000;
+			const crimild::Size BROADCASTS = 100000;
+
+			std::vector< std::unique_ptr< BenchmarkMessenger >> messengers;
+			for ( crimild::Size i = 0; i < HANDLERS; i++ ) {
+				messengers.push_back( std::unique_ptr< BenchmarkMessenger >( new BenchmarkMessenger() ) );
+			}
+
+			auto queue = MessageQueue::getInstance();
+
+			auto snapshot = measureBest( 3, [ queue, BROADCASTS ] {
+				for ( crimild::Size i = 0; i < BROADCASTS; i++ ) {
+					queue->broadcastMessage( BenchmarkMessage { 1 } );
+				}
+			});
+
+			// Only a few broadcasts for the old approach, since it's much slower
+			const crimild::Size MAP_BROADCASTS = BROADCASTS / 100;
+			BenchmarkMapDispatcher mapDispatcher;
+			for ( auto &m : messengers ) {
+				auto messenger = m.get();
+				mapDispatcher.registerHandler( messenger, [ messenger ]( BenchmarkMessage const &message ) {
+					messenger->accum += message.value;
+				});
+			}
+			auto mapCopy = measureBest( 3, [ &mapDispatcher, MAP_BROADCASTS ] {
+				for ( crimild::Size i = 0; i < MAP_BROADCASTS; i++ ) {
+					mapDispatcher.broadcastMessage( BenchmarkMessage { 1 } );
+				}
+			});
+
+			// Handlers changing every frame (i.e. objects spawned during a level)
+			const crimild::Size FRAMES = 1000;
+			auto churn = measure( [ queue, &messengers, FRAMES, HANDLERS ] {
+				for ( crimild::Size f = 0; f < FRAMES; f++ ) {
+					messengers[ f % HANDLERS ].reset( new BenchmarkMessenger() );
+					for ( crimild::Size i = 0; i < 100; i++ ) {
+						queue->broadcastMessage( BenchmarkMessage { 1 } );
+					}
+				}
+			});
+
+			report( "messaging", StringUtils::toString( HANDLERS, " handlers" ), "" );
+			report( "messaging", "  snapshot", formatBroadcasts( BROADCASTS, snapshot, HANDLERS ) );
+			report( "messaging", "  map copy (previous)", formatBroadcasts( MAP_BROADCASTS, mapCopy, HANDLERS ) );
+			report( "messaging", "  snapshot, 1 change per 100 broadcasts", formatBroadcasts( FRAMES * 100, churn, HANDLERS ) );
+
+			crimild::Int64 total = 0;
+			for ( auto &m : messengers ) {
+				total += m->accum;
+			}
+			report( "messaging", "  checksum", StringUtils::toString( total ) );
+
+			// Deferred messages pushed from worker threads
+			const crimild::Size PRODUCERS = 4;
+			const crimild::Size PUSHES = 250000;
+			messengers.clear();
+			BenchmarkMessenger receiver;
+
+			queue->setDeferredMessageCapacity< BenchmarkMessage >( 16384 );
+			queue->resetDeferredMessageStats();
+			auto ring = runProducers( PRODUCERS, PUSHES, [ queue ] {
+				queue->pushMessage( BenchmarkMessage { 1 } );
+			}, [ queue ] {
+				queue->dispatchDeferredMessages();
+			});
+			auto stats = queue->getDeferredMessageStats< BenchmarkMessage >();
+
+			BenchmarkLockedQueue lockedQueue;
+			auto locked = runProducers( PRODUCERS, PUSHES, [ &lockedQueue ] {
+				lockedQueue.pushMessage( BenchmarkMessage { 1 } );
+			}, [ &lockedQueue ] {
+				lockedQueue.dispatch();
+			});
+
+			const auto pushCount = PRODUCERS * PUSHES;
+			report( "messaging", StringUtils::toString( "deferred, ", PRODUCERS, " producers x ", PUSHES ), "" );
+			report( "messaging", "  ring buffers", StringUtils::toString( ( crimild::Size )( pushCount / ring ), " msgs/s (", formatMilliseconds( ring ), ")" ) );
+			report( "messaging", "  locked vector (previous)", StringUtils::toString( ( crimild::Size )( pushCount / locked ), " msgs/s (", formatMilliseconds( locked ), ")" ) );
+			report( "messaging", "  dispatched", StringUtils::toString( stats.dispatched, " in ", stats.batchCount, " batches, ", stats.spilled, " spilled" ) );
+			report( "messaging", "  dispatch throughput", StringUtils::toString( ( crimild::Size ) stats.getThroughput(), " msgs/s" ) );
+			report( "messaging", "  latency", StringUtils::toString( "avg ", formatMilliseconds( stats.getAverageLatency() ), ", max ", formatMilliseconds( stats.maxLatency ) ) );
+			report( "messaging", "  received", StringUtils::toString( receiver.accum ) );
+		}
+
+	}
+
+}
+
+CRIMILD_REGISTER_BENCHMARK( messaging, runMessagingBenchmark );
+
@@ -0,0 +1,140 @@
+/*
+ * Copyright (c) 2013, Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "Benchmark.hpp"
+
+#include <Loaders/OBJLoader.hpp>
+#include <Concurrency/JobScheduler.hpp>
+#include <Foundation/StringUtils.hpp>
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+using namespace crimild;
+using namespace crimild::benchmark;
+
+namespace crimild {
+
+	namespace benchmark {
+
+		/**
+			\brief Parses the file the way OBJLoader used to, without building geometry
+
+			Used as a reference only
+		*/
+		static crimild::Size parseWithStreams( std::string fileName )
+		{
+			std::ifstream input( fileName.c_str() );
+			crimild::Size count = 0;
+			char buffer[ 1024 ];
+			while ( input.getline( buffer, 1024 ) ) {
+				std::stringstream line( buffer );
+				std::string what;
+				line >> what;
+				if ( what == "v" || what == "vn" ) {
+					float x, y, z;
+					line >> x >> y >> z;
+					count++;
+				}
+				else if ( what == "vt" ) {
+					float s, t;
+					line >> s >> t;
+					count++;
+				}
+				else if ( what == "f" ) {
+					std::string f0, f1, f2;
+					line >> f0 >> f1 >> f2;
+					count += StringUtils::split< int >( f0, '/' ).size();
+					count += StringUtils::split< int >( f1, '/' ).size();
+					count += StringUtils::split< int >( f2, '/' ).size();
+				}
+			}
+			return count;
+		}
+
+		static std::string formatSeconds( crimild::Real64 seconds, crimild::Size bytes )
+		{
+			std::stringstream ss;
+			ss.precision( 3 );
+			ss << std::fixed << seconds * 1000.0 << " ms (" << ( bytes / ( 1024.0 * 1024.0 ) ) / seconds << " MB/s)";
+			return ss.str();
+		}
+
+		static void runOBJLoaderBenchmark( void )
+		{
+			const crimild::UInt32 gridSizes[] = { 128, 256, 512, 1024 };
+			const crimild::Size RUNS = 3;
+
+			for ( auto gridSize : gridSizes ) {
+				auto fileName = getTempPath( "crimild_benchmark_" + StringUtils::toString( gridSize ) + ".obj" );
+				auto bytes = generateOBJ( fileName, gridSize );
+				if ( bytes == 0 ) {
+					report( "obj_loader", "cannot write " + fileName, "" );
+					continue;
+				}
+
+				std::stringstream name;
+				name << gridSize << "x" << gridSize << " grid, " << ( bytes / ( 1024 * 1024 ) ) << " MB";
+				report( "obj_loader", name.str(), "" );
+
+				auto streams = measureBest( RUNS, [ fileName ] {
+					parseWithStreams( fileName );
+				});
+				report( "obj_loader", "  iostream parse only (reference)", formatSeconds( streams, bytes ) );
+
+				auto sequential = measureBest( RUNS, [ fileName ] {
+					OBJLoader loader( fileName );
+					loader.load();
+				});
+				report( "obj_loader", "  load, single thread", formatSeconds( sequential, bytes ) );
+
+				{
+					concurrency::JobScheduler scheduler;
+					scheduler.configure( Numeric< crimild::Int32 >::max( 1, std::thread::hardware_concurrency() - 1 ) );
+					scheduler.start();
+
+					auto parallel = measureBest( RUNS, [ fileName ] {
+						OBJLoader loader( fileName );
+						loader.load();
+					});
+					report( "obj_loader", "  load, " + StringUtils::toString( scheduler.getNumWorkers() + 1 ) + " threads", formatSeconds( parallel, bytes ) );
+
+					scheduler.stop();
+				}
+
+				std::remove( fileName.c_str() );
+			}
+		}
+
+	}
+
+}
+
+CRIMILD_REGISTER_BENCHMARK( obj_loader, runOBJLoaderBenchmark );
+
@@ -0,0 +1,496 @@
+/*
+ * Copyright (c) 2013, Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "Benchmark.hpp"
+
+#include <ParticleSystem/ParticleData.hpp>
+#include <ParticleSystem/ParticleSorter.hpp>
+#include <ParticleSystem/Renderers/InstancedQuadParticleRenderer.hpp>
+#include <ParticleSystem/Renderers/OrientedQuadParticleRenderer.hpp>
+#include <ParticleSystem/Updaters/AttractorParticleUpdater.hpp>
+#include <ParticleSystem/Updaters/ColorParticleUpdater.hpp>
+#include <ParticleSystem/Updaters/EulerParticleUpdater.hpp>
+#include <ParticleSystem/Updaters/TimeParticleUpdater.hpp>
+#include <ParticleSystem/Updaters/UniformScaleParticleUpdater.hpp>
+#include <Concurrency/JobScheduler.hpp>
+#include <SceneGraph/Camera.hpp>
+#include <SceneGraph/Group.hpp>
+#include <Simulation/AssetManager.hpp>
+#include <Mathematics/Numeric.hpp>
+#include <Foundation/StringUtils.hpp>
+
+#include <thread>
+#include <vector>
+
+using namespace crimild;
+using namespace crimild::benchmark;
+
+namespace crimild {
+
+	namespace benchmark {
+
+		/**
+			\brief The usual updaters for a fountain-like effect
+		*/
+		class ParticleUpdaterStack {
+		public:
+			explicit ParticleUpdaterStack( ParticleData *particles )
+				: _particles( particles )
+			{
+				_attractor.setAttractor( Sphere3f( Vector3f::ZERO, 5.0f ) );
+				_euler.setGlobalAcceleration( Vector3f( 0.0f, -9.8f, 0.0f ) );
+
+				_time.configure( nullptr, particles );
+				_attractor.configure( nullptr, particles );
+				_euler.configure( nullptr, particles );
+				_color.configure( nullptr, particles );
+				_scale.configure( nullptr, particles );
+			}
+
+			void update( crimild::Real64 dt )
+			{
+				_time.update( nullptr, dt, _particles );
+				_attractor.update( nullptr, dt, _particles );
+				_euler.update( nullptr, dt, _particles );
+				_color.update( nullptr, dt, _particles );
+				_scale.update( nullptr, dt, _particles );
+			}
+
+		private:
+			ParticleData *_particles;
+			TimeParticleUpdater _time;
+			AttractorParticleUpdater _attractor;
+			EulerParticleUpdater _euler;
+			ColorParticleUpdater _color;
+			UniformScaleParticleUpdater _scale;
+		};
+
+		/**
+			\brief Wakes all particles with a lifetime long enough to survive the benchmark
+		*/
+		static void spawnParticles( ParticleData *particles )
+		{
+			particles->generate();
+
+			const auto count = particles->getParticleCount();
+			auto ps = particles->getAttrib( ParticleAttrib::POSITION )->getData< Vector3f >();
+			auto ts = particles->getAttrib( ParticleAttrib::TIME )->getData< crimild::Real32 >();
+			auto ls = particles->getAttrib( ParticleAttrib::LIFE_TIME )->getData< crimild::Real32 >();
+			auto cs0 = particles->getAttrib( ParticleAttrib::START_COLOR )->getData< RGBAColorf >();
+			auto cs1 = particles->getAttrib( ParticleAttrib::END_COLOR )->getData< RGBAColorf >();
+			auto ss0 = particles->getAttrib( ParticleAttrib::UNIFORM_SCALE_START )->getData< crimild::Real32 >();
+			auto ss1 = particles->getAttrib( ParticleAttrib::UNIFORM_SCALE_END )->getData< crimild::Real32 >();
+
+			crimild::UInt32 seed = 12345;
+			auto next = [ &seed ]( void ) {
+				seed = seed * 1664525u + 1013904223u;
+				return static_cast< crimild::Real32 >( seed >> 8 ) / static_cast< crimild::Real32 >( 1 << 24 );
+			};
+
+			for ( crimild::Size i = 0; i < count; i++ ) {
+				particles->wake( i );
+				ps[ i ] = Vector3f( 10.0f * next() - 5.0f, 10.0f * next() - 5.0f, 10.0f * next() - 5.0f );
+				ls[ i ] = 1000.0f;
+				ts[ i ] = 1000.0f * next() + 1.0f;
+				cs0[ i ] = RGBAColorf( 1.0f, 1.0f, 0.0f, 1.0f );
+				cs1[ i ] = RGBAColorf( 1.0f, 0.0f, 0.0f, 0.0f );
+				ss0[ i ] = 0.5f;
+				ss1[ i ] = 2.0f;
+			}
+		}
+
+		/**
+			\brief Same work as the updater stack, using the original per-particle loops
+		*/
+		static void updateScalar( ParticleData *particles, crimild::Real64 dt )
+		{
+			const auto count = particles->getAliveCount();
+			auto ps = particles->getAttrib( ParticleAttrib::POSITION )->getData< Vector3f >();
+			auto vs = particles->getAttrib( ParticleAttrib::VELOCITY )->getData< Vector3f >();
+			auto as = particles->getAttrib( ParticleAttrib::ACCELERATION )->getData< Vector3f >();
+			auto ts = particles->getAttrib( ParticleAttrib::TIME )->getData< crimild::Real32 >();
+			auto ls = particles->getAttrib( ParticleAttrib::LIFE_TIME )->getData< crimild::Real32 >();
+			auto cs0 = particles->getAttrib( ParticleAttrib::START_COLOR )->getData< RGBAColorf >();
+			auto cs1 = particles->getAttrib( ParticleAttrib::END_COLOR )->getData< RGBAColorf >();
+			auto cs = particles->getAttrib( ParticleAttrib::COLOR )->getData< RGBAColorf >();
+			auto ss0 = particles->getAttrib( ParticleAttrib::UNIFORM_SCALE_START )->getData< crimild::Real32 >();
+			auto ss1 = particles->getAttrib( ParticleAttrib::UNIFORM_SCALE_END )->getData< crimild::Real32 >();
+			auto ss = particles->getAttrib( ParticleAttrib::UNIFORM_SCALE )->getData< crimild::Real32 >();
+
+			for ( crimild::Size i = 0; i < count; i++ ) {
+				ts[ i ] -= dt;
+			}
+
+			const auto radius = 5.0f;
+			for ( crimild::Size i = 0; i < count; i++ ) {
+				auto direction = -ps[ i ];
+				auto d = direction.getMagnitude();
+				if ( d > 0.0 && d <= radius ) {
+					direction /= d;
+					const auto pct = 1.0 - ( d / radius );
+					as[ i ] += dt * pct * direction;
+				}
+			}
+
+			const auto g = dt * Vector3f( 0.0f, -9.8f, 0.0f );
+			for ( crimild::Size i = 0; i < count; i++ ) {
+				as[ i ] += g;
+			}
+			for ( crimild::Size i = 0; i < count; i++ ) {
+				vs[ i ] += dt * as[ i ];
+			}
+			for ( crimild::Size i = 0; i < count; i++ ) {
+				ps[ i ] += dt * vs[ i ];
+			}
+
+			for ( crimild::Size i = 0; i < count; i++ ) {
+				const auto t = 1.0f - ( ts[ i ] / ls[ i ] );
+				cs[ i ] = cs0[ i ] + t * ( cs1[ i ] - cs0[ i ] );
+			}
+
+			for ( crimild::Size i = 0; i < count; i++ ) {
+				const auto t = 1.0f - ( ts[ i ] / ls[ i ] );
+				ss[ i ] = ss0[ i ] + t * ( ss1[ i ] - ss0[ i ] );
+			}
+		}
+
+		/**
+			\brief Runs one million particles through time, attractor, euler, color and scale updaters
+		*/
+		static void runParticleBenchmark( void )
+		{
+			const crimild::Size COUNT = 1000000;
+			const crimild::Size RUNS = 10;
+			const crimild::Real64 DT = 1.0 / 60.0;
+
+			ParticleData particles( COUNT );
+			ParticleUpdaterStack stack( &particles );
+			spawnParticles( &particles );
+
+			report( "particles", "1M particles, 5 updaters", "" );
+
+			auto scalar = measureBest( RUNS, [ &particles, DT ] {
+				updateScalar( &particles, DT );
+			});
+			report( "particles", "  update (scalar)", formatMilliseconds( scalar ) );
+
+			auto simd = measureBest( RUNS, [ &stack, DT ] {
+				stack.update( DT );
+			});
+			report( "particles", "  update (simd)", formatMilliseconds( simd ) );
+
+			const auto workers = Numeric< crimild::Int32 >::max( 1, std::thread::hardware_concurrency() - 1 );
+			concurrency::JobScheduler scheduler;
+			scheduler.configure( workers );
+			scheduler.start();
+
+			auto parallel = measureBest( RUNS, [ &stack, DT ] {
+				stack.update( DT );
+			});
+			report( "particles", "  update (simd, " + StringUtils::toString( workers + 1 ) + " threads)", formatMilliseconds( parallel ) );
+
+			scheduler.stop();
+
+			report( "particles", "  alive after updates", StringUtils::toString( particles.getAliveCount() ) );
+		}
+
+		/**
+			\brief Resets times so a given percentage of particles expire in the next update
+		*/
+		static void prepareChurn( ParticleData *particles, crimild::Size percentage )
+		{
+			spawnParticles( particles );
+
+			const auto count = particles->getAliveCount();
+			auto ts = particles->getAttrib( ParticleAttrib::TIME )->getData< crimild::Real32 >();
+			crimild::UInt32 seed = 54321;
+			for ( crimild::Size i = 0; i < count; i++ ) {
+				seed = seed * 1664525u + 1013904223u;
+				ts[ i ] = ( ( seed >> 8 ) % 100 ) < percentage ? 0.0f : 1.0f;
+			}
+		}
+
+		/**
+			\brief Kills particles by swapping each one with the last alive particle
+
+			This is what ParticleData::kill() used to do. Unlike the original
+			loop, the particle swapped into the current slot is checked too,
+			so both methods kill the same particles.
+		*/
+		static crimild::Size killBySwapping( ParticleData *particles )
+		{
+			auto count = particles->getAliveCount();
+			auto ts = particles->getAttrib( ParticleAttrib::TIME )->getData< crimild::Real32 >();
+			crimild::Size i = 0;
+			while ( i < count ) {
+				if ( ts[ i ] <= 0.0f ) {
+					particles->swap( i, --count );
+				}
+				else {
+					i++;
+				}
+			}
+			return count;
+		}
+
+		/**
+			\brief Kills a percentage of one million particles in a single update
+		*/
+		static void runParticleChurnBenchmark( void )
+		{
+			const crimild::Size COUNT = 1000000;
+			const crimild::Size RUNS = 5;
+
+			ParticleData particles( COUNT );
+			ParticleUpdaterStack stack( &particles );
+			TimeParticleUpdater time;
+			time.configure( nullptr, &particles );
+
+			report( "particle_churn", "1M particles, 11 attributes", "" );
+
+			const crimild::Size percentages[] = { 1, 10, 50, 90 };
+			for ( auto percentage : percentages ) {
+				auto label = "  " + StringUtils::toString( percentage ) + "% killed";
+
+				crimild::Real64 swapping = -1.0;
+				crimild::Size swappingAlive = 0;
+				for ( crimild::Size run = 0; run < RUNS; run++ ) {
+					prepareChurn( &particles, percentage );
+					auto t = measure( [ &particles, &swappingAlive ] {
+						swappingAlive = killBySwapping( &particles );
+					});
+					swapping = ( swapping < 0.0 || t < swapping ) ? t : swapping;
+				}
+				report( "particle_churn", label + " (swap per kill)", formatMilliseconds( swapping ) );
+
+				crimild::Real64 compaction = -1.0;
+				for ( crimild::Size run = 0; run < RUNS; run++ ) {
+					prepareChurn( &particles, percentage );
+					auto t = measure( [ &particles, &time ] {
+						time.update( nullptr, 0.0, &particles );
+					});
+					compaction = ( compaction < 0.0 || t < compaction ) ? t : compaction;
+				}
+				report( "particle_churn", label + " (compaction)", formatMilliseconds( compaction ) );
+
+				report( "particle_churn", "    alive (swap/compaction)", StringUtils::toString( swappingAlive ) + "/" + StringUtils::toString( particles.getAliveCount() ) );
+			}
+		}
+
+		/**
+			\brief The bubble sort used by ZSortParticleUpdater before
+		*/
+		static void bubbleSort( ParticleData *particles )
+		{
+			const auto pCount = particles->getAliveCount();
+			const auto ps = particles->getAttrib( ParticleAttrib::POSITION )->getData< Vector3f >();
+			for ( crimild::Size i = 1; i < pCount; i++ ) {
+				for ( crimild::Size j = 0; j < pCount - i; j++ ) {
+					if ( ps[ j ].z() > ps[ j + 1 ].z() ) {
+						particles->swap( j, j + 1 );
+					}
+				}
+			}
+		}
+
+		/**
+			\brief Sorts particles by z, as ZSortParticleUpdater does
+		*/
+		static void sortByDepth( ParticleData *particles, ParticleSorter &sorter, std::vector< crimild::Real32 > &depths )
+		{
+			const auto count = particles->getAliveCount();
+			const auto ps = particles->getAttrib( ParticleAttrib::POSITION )->getData< Vector3f >();
+			depths.resize( count );
+			for ( crimild::Size i = 0; i < count; i++ ) {
+				depths[ i ] = ps[ i ].z();
+			}
+			sorter.sort( particles, &depths[ 0 ], ParticleSorter::Order::ASCENDING );
+		}
+
+		/**
+			\brief Moves particles a little, like a single frame of simulation would
+		*/
+		static void jitterParticles( ParticleData *particles, crimild::UInt32 &seed )
+		{
+			const auto count = particles->getAliveCount();
+			auto ps = particles->getAttrib( ParticleAttrib::POSITION )->getData< Vector3f >();
+			for ( crimild::Size i = 0; i < count; i++ ) {
+				seed = seed * 1664525u + 1013904223u;
+				ps[ i ][ 2 ] += 0.001f * ( static_cast< crimild::Real32 >( seed >> 16 ) / 65536.0f - 0.5f );
+			}
+		}
+
+		/**
+			\brief Sorts 10k and 100k particles with 11 attributes by depth
+		*/
+		static void runParticleSortBenchmark( void )
+		{
+			const crimild::Size RUNS = 5;
+			const crimild::Size counts[] = { 10000, 100000 };
+
+			for ( auto count : counts ) {
+				ParticleData particles( count );
+				ParticleUpdaterStack stack( &particles );
+				ParticleSorter sorter;
+				std::vector< crimild::Real32 > depths;
+
+				auto label = "  " + StringUtils::toString( count / 1000 ) + "k";
+				report( "particle_sort", label + " particles", "" );
+
+				if ( count <= 10000 ) {
+					spawnParticles( &particles );
+					auto bubble = measure( [ &particles ] {
+						bubbleSort( &particles );
+					});
+					report( "particle_sort", label + " bubble sort", formatMilliseconds( bubble ) );
+				}
+
+				crimild::Real64 radix = -1.0;
+				for ( crimild::Size run = 0; run < RUNS; run++ ) {
+					spawnParticles( &particles );
+					auto t = measure( [ &particles, &sorter, &depths ] {
+						sortByDepth( &particles, sorter, depths );
+					});
+					radix = ( radix < 0.0 || t < radix ) ? t : radix;
+				}
+				report( "particle_sort", label + " radix sort", formatMilliseconds( radix ) );
+
+				// Particles are already sorted from the last run
+				sorter.setIncremental( true );
+				crimild::UInt32 seed = 777;
+				crimild::Real64 incremental = -1.0;
+				for ( crimild::Size run = 0; run < RUNS; run++ ) {
+					jitterParticles( &particles, seed );
+					auto t = measure( [ &particles, &sorter, &depths ] {
+						sortByDepth( &particles, sorter, depths );
+					});
+					incremental = ( incremental < 0.0 || t < incremental ) ? t : incremental;
+				}
+				report( "particle_sort", label + " incremental (jittered)", formatMilliseconds( incremental ) );
+
+				auto unchanged = measureBest( RUNS, [ &particles, &sorter, &depths ] {
+					sortByDepth( &particles, sorter, depths );
+				});
+				report( "particle_sort", label + " incremental (unchanged)", formatMilliseconds( unchanged ) );
+			}
+		}
+
+
+		/**
+			\brief Oriented quads as they were built before buffers were written in place,
+			transforming each particle with the node's inverse rotation
+		*/
+		static void buildQuadsPerParticle( Node *node, ParticleData *particles, VertexBufferObject *vbo, const Vector3f &up, const Vector3f &right )
+		{
+			const auto count = particles->getAliveCount();
+			vbo->setVertexCount( 4 * count );
+
+			const auto offset0 = up - right;
+			const auto offset1 = -up - right;
+			const auto offset2 = -up + right;
+			const auto offset3 = up + right;
+
+			const auto ps = particles->getAttrib( ParticleAttrib::POSITION )->getData< Vector3f >();
+			const auto ss = particles->getAttrib( ParticleAttrib::UNIFORM_SCALE )->getData< crimild::Real32 >();
+			for ( crimild::Size i = 0; i < count; i++ ) {
+				auto idx = i * 4;
+				auto pos = ps[ i ];
+				node->getWorld().applyInverseToPoint( pos, pos );
+				auto s = ss[ i ];
+				vbo->setPositionAt( idx + 0, pos + s * offset0 );
+				vbo->setPositionAt( idx + 1, pos + s * offset1 );
+				vbo->setPositionAt( idx + 2, pos + s * offset2 );
+				vbo->setPositionAt( idx + 3, pos + s * offset3 );
+			}
+
+			vbo->invalidate();
+		}
+
+		static void runParticleRenderBenchmark( void )
+		{
+			const crimild::Size RUNS = 5;
+			const crimild::Size counts[] = { 10000, 100000 };
+
+			// renderers look for shader programs and the main camera
+			AssetManager assets;
+			auto camera = crimild::alloc< Camera >();
+			Camera::setMainCamera( camera );
+
+			auto formatKB = []( crimild::Size bytes ) {
+				return StringUtils::toString( bytes / 1024 ) + " KB";
+			};
+
+			for ( auto count : counts ) {
+				ParticleData particles( count );
+				particles.setComputeInWorldSpace( true );
+				ParticleUpdaterStack stack( &particles );
+				spawnParticles( &particles );
+				stack.update( 0.016 );
+
+				auto node = crimild::alloc< Group >();
+				node->world().setTranslate( 1.0f, 2.0f, 3.0f );
+				node->world().rotate().fromAxisAngle( Vector3f::UNIT_Y, 0.5f );
+
+				auto label = "  " + StringUtils::toString( count / 1000 ) + "k";
+				report( "particle_render", label + " particles", "" );
+
+				auto vbo = crimild::alloc< VertexBufferObject >( VertexFormat::VF_P3_UV2, 4 * count );
+				auto up = Vector3f::UNIT_Y;
+				auto right = Vector3f::UNIT_X;
+				auto perParticle = measureBest( RUNS, [ &] {
+					buildQuadsPerParticle( crimild::get_ptr( node ), &particles, crimild::get_ptr( vbo ), up, right );
+				});
+				report( "particle_render", label + " quads (per particle inverse)", formatMilliseconds( perParticle ) + ", " + formatKB( vbo->getSizeInBytes() ) + " per frame" );
+
+				auto quads = crimild::alloc< OrientedQuadParticleRenderer >();
+				quads->configure( crimild::get_ptr( node ), &particles );
+				auto cached = measureBest( RUNS, [ &] {
+					quads->update( crimild::get_ptr( node ), 0.016, &particles );
+				});
+				report( "particle_render", label + " quads (cached inverse)", formatMilliseconds( cached ) + ", " + formatKB( quads->getStats().uploadedBytes ) + " per frame" );
+
+				auto instanced = crimild::alloc< InstancedQuadParticleRenderer >();
+				instanced->configure( crimild::get_ptr( node ), &particles );
+				auto streamed = measureBest( RUNS, [ &] {
+					instanced->update( crimild::get_ptr( node ), 0.016, &particles );
+				});
+				report( "particle_render", label + " instanced", formatMilliseconds( streamed ) + ", " + formatKB( instanced->getStats().uploadedBytes ) + " per frame" );
+			}
+
+			Camera::setMainCamera( nullptr );
+		}
+
+	}
+
+}
+
+CRIMILD_REGISTER_BENCHMARK( particles, runParticleBenchmark );
+CRIMILD_REGISTER_BENCHMARK( particle_churn, runParticleChurnBenchmark );
+CRIMILD_REGISTER_BENCHMARK( particle_sort, runParticleSortBenchmark );
+CRIMILD_REGISTER_BENCHMARK( particle_render, runParticleRenderBenchmark );
+
@@ -0,0 +1,138 @@
+/*
+ * Copyright (c) 2013, Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "Benchmark.hpp"
+
+#include <Foundation/Profiler.hpp>
+#include <Foundation/StringUtils.hpp>
+
+#include <cstdio>
+#include <fstream>
+#include <thread>
+#include <vector>
+
+using namespace crimild;
+using namespace crimild::benchmark;
+
+namespace crimild {
+
+	namespace benchmark {
+
+		static std::string formatNanoseconds( crimild::Real64 seconds, crimild::Size count )
+		{
+			return StringUtils::toString( seconds * 1.0e9 / count, " ns" );
+		}
+
+		/**
+			\brief Measures the cost of enabled zones and frame collection
+
+			Zones are recorded in batches that fit in the thread buffers, 
+			collecting samples after each batch like a frame would.
+		*/
+		static void runProfilerBenchmark( void )
+		{
+			const crimild::Size FRAMES = 200;
+			const crimild::Size ZONES_PER_FRAME = 10000;
+			const crimild::Size TOTAL = FRAMES * ZONES_PER_FRAME;
+
+			Profiler profiler;
+			volatile crimild::Size sink = 0;
+
+			auto baseline = measureBest( 3, [ &sink, FRAMES, ZONES_PER_FRAME ] {
+				for ( crimild::Size f = 0; f < FRAMES; f++ ) {
+					for ( crimild::Size i = 0; i < ZONES_PER_FRAME; i++ ) {
+						sink = sink + i;
+					}
+				}
+			});
+
+			crimild::Real64 collectTime = 0.0;
+			auto zones = measureBest( 3, [ &sink, &profiler, &collectTime, FRAMES, ZONES_PER_FRAME ] {
+				collectTime = 0.0;
+				for ( crimild::Size f = 0; f < FRAMES; f++ ) {
+					for ( crimild::Size i = 0; i < ZONES_PER_FRAME; i++ ) {
+						CRIMILD_PROFILE( "Benchmark Zone" )
+						sink = sink + i;
+					}
+					collectTime += measure( [ &profiler ] { profiler.step(); } );
+				}
+			});
+
+			auto nested = measureBest( 3, [ &sink, &profiler, FRAMES, ZONES_PER_FRAME ] {
+				for ( crimild::Size f = 0; f < FRAMES; f++ ) {
+					for ( crimild::Size i = 0; i < ZONES_PER_FRAME / 2; i++ ) {
+						CRIMILD_PROFILE( "Benchmark Outer Zone" )
+						{
+							CRIMILD_PROFILE( "Benchmark Inner Zone" )
+							sink = sink + i;
+						}
+					}
+					profiler.step();
+				}
+			});
+
+			report( "profiler", StringUtils::toString( TOTAL, " zones" ), "" );
+			report( "profiler", "  baseline loop", formatNanoseconds( baseline, TOTAL ) );
+			report( "profiler", "  enabled zone", formatNanoseconds( zones - collectTime - baseline, TOTAL ) );
+			report( "profiler", "  nested zones (per zone)", formatNanoseconds( nested - baseline, TOTAL ) );
+			report( "profiler", "  collect (per zone)", formatNanoseconds( collectTime, TOTAL ) );
+
+			// Capture a few frames from several threads and export them
+			const crimild::Size THREADS = 4;
+			profiler.beginCapture();
+			for ( crimild::Size f = 0; f < 10; f++ ) {
+				CRIMILD_PROFILE( "Benchmark Frame" )
+				std::vector< std::thread > threads;
+				for ( crimild::Size t = 0; t < THREADS; t++ ) {
+					threads.push_back( std::thread( [ &sink ] {
+						for ( crimild::Size i = 0; i < 1000; i++ ) {
+							CRIMILD_PROFILE( "Benchmark Job" )
+							sink = sink + i;
+						}
+					}));
+				}
+				for ( auto &t : threads ) {
+					t.join();
+				}
+				profiler.step();
+			}
+			profiler.endCapture();
+
+			auto fileName = getTempPath( "crimild_benchmark_profiler.json" );
+			auto exportTime = measure( [ &profiler, fileName ] { profiler.exportChromeTrace( fileName ); } );
+			std::ifstream in( fileName, std::ios::binary | std::ios::ate );
+			report( "profiler", StringUtils::toString( "export ", profiler.getCapturedSampleCount(), " samples" ), StringUtils::toString( formatMilliseconds( exportTime ), " (", in.tellg() / 1024, " KB)" ) );
+			report( "profiler", "dropped samples", StringUtils::toString( Profiler::getDroppedSampleCount() ) );
+			std::remove( fileName.c_str() );
+		}
+
+	}
+
+}
+
+CRIMILD_REGISTER_BENCHMARK( profiler, runProfilerBenchmark );
+
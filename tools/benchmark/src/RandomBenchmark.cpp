@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) 2013, Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "Benchmark.hpp"
+
+#include <Mathematics/Random.hpp>
+#include <Foundation/StringUtils.hpp>
+
+#include <random>
+#include <thread>
+#include <vector>
+
+using namespace crimild;
+using namespace crimild::benchmark;
+
+namespace crimild {
+
+	namespace benchmark {
+
+		static std::string formatNanoseconds( crimild::Real64 seconds, crimild::Size count )
+		{
+			return StringUtils::toString( seconds * 1.0e9 / count, " ns/value" );
+		}
+
+		/**
+			\brief Compares random number generation approaches
+
+			The mt19937_64 rows reproduce what Random::generate() used to do
+			before generators were owned by each thread.
+		*/
+		static void runRandomBenchmark( void )
+		{
+			const crimild::Size COUNT = 10000000;
+			const crimild::Size THREADS = 4;
+			const crimild::Size RUNS = 5;
+
+			std::vector< crimild::Real32 > values( COUNT );
+
+			auto mt = measureBest( RUNS, [ &values, COUNT ] {
+				std::mt19937_64 generator( 42 );
+				std::uniform_real_distribution< double > distribution( 0, 1 );
+				for ( crimild::Size i = 0; i < COUNT; i++ ) {
+					values[ i ] = 1.0f + crimild::Real32( distribution( generator ) );
+				}
+			});
+
+			auto generate = measureBest( RUNS, [ &values, COUNT ] {
+				Random::setSeed( 42 );
+				for ( crimild::Size i = 0; i < COUNT; i++ ) {
+					values[ i ] = Random::generate< crimild::Real32 >( 1.0f, 2.0f );
+				}
+			});
+
+			auto fill = measureBest( RUNS, [ &values, COUNT ] {
+				Random::Generator generator( 42 );
+				generator.fill( &values[ 0 ], COUNT, 1.0f, 2.0f );
+			});
+
+			// Each thread fills its own slice, using one stream per thread
+			auto threads = measureBest( RUNS, [ &values, COUNT, THREADS ] {
+				std::vector< std::thread > workers;
+				const auto slice = COUNT / THREADS;
+				for ( crimild::Size t = 0; t < THREADS; t++ ) {
+					workers.push_back( std::thread( [ &values, slice, t ] {
+						Random::Generator generator( 42, t );
+						generator.fill( &values[ t * slice ], slice, 1.0f, 2.0f );
+					}));
+				}
+				for ( auto &w : workers ) {
+					w.join();
+				}
+			});
+
+			report( "random", StringUtils::toString( COUNT, " values" ), "" );
+			report( "random", "  mt19937_64 (previous)", formatNanoseconds( mt, COUNT ) );
+			report( "random", "  Random::generate", formatNanoseconds( generate, COUNT ) );
+			report( "random", "  Generator::fill", formatNanoseconds( fill, COUNT ) );
+			report( "random", StringUtils::toString( "  Generator::fill x", THREADS, " threads" ), formatNanoseconds( threads, COUNT ) );
+		}
+
+	}
+
+}
+
+CRIMILD_REGISTER_BENCHMARK( random, runRandomBenchmark );
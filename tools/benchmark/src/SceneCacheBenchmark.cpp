@@ -0,0 +1,122 @@
+/*
+ * Copyright (c) 2013, Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "Benchmark.hpp"
+
+#include <Loaders/OBJLoader.hpp>
+#include <Loaders/SceneCache.hpp>
+#include <Concurrency/JobScheduler.hpp>
+#include <Foundation/StringUtils.hpp>
+
+#include <sys/stat.h>
+
+#include <cstdio>
+#include <sstream>
+#include <thread>
+
+using namespace crimild;
+using namespace crimild::benchmark;
+
+namespace crimild {
+
+	namespace benchmark {
+
+		static crimild::Size getFileSize( std::string fileName )
+		{
+			struct stat info;
+			return stat( fileName.c_str(), &info ) == 0 ? info.st_size : 0;
+		}
+
+		/**
+			\brief Compares parsing OBJ files against loading them from a scene cache
+
+			Parsing uses all available threads, which is the best case for
+			the OBJ loader. Loading from the cache includes validating all
+			sources, which means hashing the original OBJ file
+		*/
+		static void runSceneCacheBenchmark( void )
+		{
+			const crimild::UInt32 gridSizes[] = { 128, 256, 512, 1024 };
+			const crimild::Size RUNS = 3;
+
+			concurrency::JobScheduler scheduler;
+			scheduler.configure( Numeric< crimild::Int32 >::max( 1, std::thread::hardware_concurrency() - 1 ) );
+			scheduler.start();
+
+			for ( auto gridSize : gridSizes ) {
+				auto fileName = getTempPath( "crimild_benchmark_cache_" + StringUtils::toString( gridSize ) + ".obj" );
+				auto cacheFileName = SceneCache::getCacheFileName( fileName );
+				auto bytes = generateOBJ( fileName, gridSize );
+				if ( bytes == 0 ) {
+					report( "scene_cache", "cannot write " + fileName, "" );
+					continue;
+				}
+				std::remove( cacheFileName.c_str() );
+
+				std::stringstream name;
+				name << gridSize << "x" << gridSize << " grid, " << ( bytes / ( 1024 * 1024 ) ) << " MB";
+				report( "scene_cache", name.str(), "" );
+
+				auto parse = measureBest( RUNS, [ fileName ] {
+					OBJLoader loader( fileName );
+					loader.load();
+				});
+				report( "scene_cache", "  parse OBJ", formatMilliseconds( parse ) );
+
+				auto firstLoad = measure( [ fileName ] {
+					OBJLoader loader( fileName );
+					loader.setCacheEnabled( true );
+					loader.load();
+				});
+				report( "scene_cache", "  parse OBJ and write cache", formatMilliseconds( firstLoad ) );
+
+				auto cacheBytes = getFileSize( cacheFileName );
+				report( "scene_cache", "  cache size", StringUtils::toString( cacheBytes / 1024 ) + " KB" );
+
+				auto cached = measureBest( RUNS, [ fileName ] {
+					OBJLoader loader( fileName );
+					loader.setCacheEnabled( true );
+					loader.load();
+				});
+				report( "scene_cache", "  load from cache", formatMilliseconds( cached ) );
+
+				report( "scene_cache", "  speedup", StringUtils::toString( parse / cached ) + "x" );
+
+				std::remove( fileName.c_str() );
+				std::remove( cacheFileName.c_str() );
+			}
+
+			scheduler.stop();
+		}
+
+	}
+
+}
+
+CRIMILD_REGISTER_BENCHMARK( scene_cache, runSceneCacheBenchmark );
+
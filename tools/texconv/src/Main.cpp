@@ -0,0 +1,146 @@
+/*
+ * Copyright (c) 2013, Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <Rendering/ImageCompressor.hpp>
+#include <Rendering/ImageDDS.hpp>
+#include <Rendering/ImageKTX.hpp>
+#include <Rendering/ImageLoader.hpp>
+#include <Rendering/ImageUtils.hpp>
+#include <Concurrency/JobScheduler.hpp>
+#include <Foundation/StringUtils.hpp>
+#include <Mathematics/Numeric.hpp>
+#include <Simulation/Settings.hpp>
+
+#include <iostream>
+#include <thread>
+
+using namespace crimild;
+
+static crimild::Bool parseFormat( std::string name, crimild::Bool hasAlpha, Image::PixelFormat &format )
+{
+	if ( name == "auto" ) {
+		format = hasAlpha ? Image::PixelFormat::BC3 : Image::PixelFormat::BC1;
+	}
+	else if ( name == "bc1" ) {
+		format = Image::PixelFormat::BC1;
+	}
+	else if ( name == "bc3" ) {
+		format = Image::PixelFormat::BC3;
+	}
+	else if ( name == "bc7" ) {
+		format = Image::PixelFormat::BC7;
+	}
+	else if ( name == "etc2" ) {
+		format = hasAlpha ? Image::PixelFormat::ETC2_RGBA : Image::PixelFormat::ETC2_RGB;
+	}
+	else {
+		return false;
+	}
+
+	return true;
+}
+
+static crimild::Size computeTotalSize( const Image *image )
+{
+	crimild::Size size = 0;
+	for ( crimild::Size level = 0; level <= image->getMipmapCount(); level++ ) {
+		size += image->getMipmap( level )->getDataSize();
+	}
+	return size;
+}
+
+/**
+	Usage:
+		texconv input=path/to/image.png output=path/to/texture.ktx [format=auto|bc1|bc3|bc7|etc2] [mipmaps=true|false] [filter=kaiser|box]
+
+	Output files are written as DDS if the extension is .dds or KTX otherwise.
+	The "auto" format uses BC1 for opaque images and BC3 if there's alpha.
+*/
+int main( int argc, char **argv )
+{
+	Settings settings;
+	settings.parseCommandLine( argc, argv );
+
+	std::string input = settings.get( "input", "" );
+	std::string output = settings.get( "output", "" );
+	if ( input == "" || output == "" ) {
+		std::cout << "usage: " << argv[ 0 ] << " input=path/to/image.png output=path/to/texture.ktx [format=auto|bc1|bc3|bc7|etc2] [mipmaps=true|false] [filter=kaiser|box]" << std::endl;
+		return -1;
+	}
+
+	auto generateMipmaps = settings.get( "mipmaps", "true" ) != "false";
+	auto filter = settings.get( "filter", "kaiser" ) == "box" ? ImageUtils::MipmapFilter::BOX : ImageUtils::MipmapFilter::KAISER;
+
+	concurrency::JobScheduler scheduler;
+	scheduler.configure( Numeric< crimild::Int32 >::max( 1, ( crimild::Int32 ) std::thread::hardware_concurrency() - 1 ) );
+	scheduler.start();
+
+	auto image = ImageLoader::load( input, generateMipmaps, filter );
+	if ( image == nullptr ) {
+		std::cerr << "Cannot load image " << input << std::endl;
+		return -1;
+	}
+
+	Image::PixelFormat format;
+	if ( !parseFormat( settings.get( "format", "auto" ), image->getBpp() == 4, format ) ) {
+		std::cerr << "Unknown format " << settings.get( "format", "auto" ) << std::endl;
+		return -1;
+	}
+
+	auto compressed = ImageCompressor::compress( crimild::get_ptr( image ), format );
+	if ( compressed == nullptr ) {
+		std::cerr << "Cannot compress image " << input << std::endl;
+		return -1;
+	}
+
+	scheduler.stop();
+
+	auto decompressed = ImageCompressor::decompress( crimild::get_ptr( compressed ) );
+	auto psnr = ImageUtils::computePSNR( crimild::get_ptr( image ), crimild::get_ptr( decompressed ) );
+
+	auto saved = StringUtils::toLower( StringUtils::getFileExtension( output ) ) == "dds"
+		? ImageDDS::save( crimild::get_ptr( compressed ), output )
+		: ImageKTX::save( crimild::get_ptr( compressed ), output );
+	if ( !saved ) {
+		std::cerr << "Cannot write " << output << std::endl;
+		return -1;
+	}
+
+	auto originalSize = image->getWidth() * image->getHeight() * 4;
+	auto compressedSize = computeTotalSize( crimild::get_ptr( compressed ) );
+
+	std::cout << output << ": "
+			  << image->getWidth() << "x" << image->getHeight() << ", "
+			  << ( compressed->getMipmapCount() + 1 ) << " levels, "
+			  << ( compressedSize / 1024 ) << " KB "
+			  << "(" << ( originalSize / 1024 ) << " KB as RGBA without mipmaps), "
+			  << "PSNR " << psnr << " dB"
+			  << std::endl;
+
+	return 0;
+}
+